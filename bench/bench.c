@@ -0,0 +1,817 @@
+/**
+   bench.c
+
+   A benchmark suite that runs standardized workloads over the hash tables,
+   the heap, sorting, and graph algorithms, and writes the summaries of
+   the runtimes in CSV or JSON format to the standard output.
+
+   Each workload is run for a number of samples. A sample records the
+   wall-clock runtime of a run and the CPU time of the run, summed across
+   the threads that ran the workload, and the summary of a workload
+   provides the minimum, median, and 99th percentile wall-clock runtimes,
+   the median CPU time, and the number of operations per second at the
+   median runtime. The inputs of a workload are generated before a run
+   and are the same across the samples and across the compared
+   implementations, with random numbers from a fixed seed, so that the
+   summaries of two runs of the suite are comparable.
+
+   If hardware counters are on, a sample also records the available
+   perf_event_open counters around the timed region of a run, and the
+   summary provides the counter values per operation and the instructions
+   per cycle; the counters of the threads created in a run are included
+   after the threads are joined. The counters are not recorded for
+   mergesort_pthread_pool, because the threads of a pool outlive the
+   runs. The unavailable counters, e.g. on systems other than Linux or in
+   virtual machines without a virtualized PMU, are omitted in the output.
+
+   The following workloads are provided:
+   - ht_divchn, ht_muloa: insertion of count distinct size_t keys with
+     size_t elements into a hash table without a preallocated count of
+     slots, followed by searches of the count keys, searches of count keys
+     that are not in the hash table, and deletion of the count keys,
+   - ht_divchn_pthread: the same operations with count keys that are
+     partitioned across 2^0, 2^1, ..., 2^k threads, where each thread
+     inserts and deletes its keys in batches, and the CPU time of a run is
+     the sum of the CPU times measured by the threads,
+   - heap: count pushes of size_t elements with random size_t priorities,
+     followed by count pops, with an index array and with ht_divchn_t and
+     ht_muloa_t hash tables for in-heap operations,
+   - sort: sorting of count random size_t values with qsort, and with
+     mergesort_pthread_corank and mergesort_pthread_pool across 2^0, 2^1,
+     ..., 2^k threads, where the CPU time of a run is the CPU time of the
+     process,
+   - dijkstra, prim: runs from a random start vertex on a G(n, p) graph
+     with an expected degree of C_GRAPH_DEG and random size_t weights, with
+     an index array and with ht_divchn_t and ht_muloa_t hash tables for
+     in-heap operations, and on a CSR adjacency list; the number of
+     operations of a run is the number of edges in the graph.
+
+   The following command line arguments can be used to customize the suite:
+   bench
+      [0, # bits in size_t - 1) : i s.t. count = 2^i
+      [1, # bits in size_t - 1) : j s.t. # vertices = 2^j
+      > 0 : # samples of each workload
+      [0, 6] : k for up to 2^k threads
+      [0, 1] : CSV (0) or JSON (1) output
+      [0, 1] : hash table workloads on/off
+      [0, 1] : heap workloads on/off
+      [0, 1] : sort workloads on/off
+      [0, 1] : graph workloads on/off
+      [0, 1] : hardware counters on/off
+
+   usage examples:
+   ./bench
+   ./bench 20 16 > bench.csv
+   ./bench 16 12 21 3 1 > bench.json
+   ./bench 18 14 11 2 0 1 0 0 0
+
+   bench can be run with any subset of command line arguments in the
+   above-defined order. If the (i + 1)th argument is specified then the
+   ith argument must be specified for i >= 0. Default values are used for
+   the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   with the requirements that the pthreads API and the POSIX clock_gettime
+   function are available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "dijkstra.h"
+#include "graph.h"
+#include "graph-gen-pthread.h"
+#include "heap.h"
+#include "ht-divchn.h"
+#include "ht-divchn-pthread.h"
+#include "ht-muloa.h"
+#include "mergesort-pthread.h"
+#include "pool-pthread.h"
+#include "prim.h"
+#include "utilities-bench.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+#include "utilities-pthread.h"
+
+/**
+   Generate random numbers in a portable way for benchmark inputs only,
+   from a fixed seed; rand() in the Linux C Library uses the same generator
+   as random(), which may not be the case on older rand() implementations,
+   and on current implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(C_SEED);}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+/* input handling */
+const char *C_USAGE =
+  "bench \n"
+  "[0, # bits in size_t - 1) : i s.t. count = 2^i \n"
+  "[1, # bits in size_t - 1) : j s.t. # vertices = 2^j \n"
+  "> 0 : # samples of each workload \n"
+  "[0, 6] : k for up to 2^k threads \n"
+  "[0, 1] : CSV (0) or JSON (1) output \n"
+  "[0, 1] : hash table workloads on/off \n"
+  "[0, 1] : heap workloads on/off \n"
+  "[0, 1] : sort workloads on/off \n"
+  "[0, 1] : graph workloads on/off \n"
+  "[0, 1] : hardware counters on/off \n";
+const int C_ARGC_MAX = 11;
+const size_t C_ARGS_DEF[10] = {18, 14, 11, 2, 0, 1, 1, 1, 1, 1};
+const size_t C_THREADS_LOG_MAX = 6;
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const unsigned int C_SEED = 17;
+
+/* hash tables */
+const size_t C_KEY_MUL = 2654435769u; /* odd, distinct keys mod 2^W */
+const size_t C_ALPHA_N_DIVCHN = 1;
+const size_t C_LOG_ALPHA_D_DIVCHN = 0;
+const size_t C_ALPHA_N_MULOA = 13107;
+const size_t C_LOG_ALPHA_D_MULOA = 15;
+const size_t C_LOG_NUM_LOCKS = 10;
+const size_t C_BATCH_COUNT = 64;
+
+/* sort */
+const size_t C_SORT_SBASE_COUNT = 4096;
+const size_t C_SORT_MBASE_COUNT = 4096;
+
+/* graphs */
+const double C_GRAPH_DEG = 16.0;
+const size_t C_GRAPH_WT_MAX = 1048576;
+const size_t C_GRAPH_SEED = 17;
+
+typedef enum{OP_INSERT, OP_SEARCH_HIT, OP_SEARCH_MISS, OP_DELETE,
+	     OP_COUNT} ht_op_t;
+
+/* names of benchmarks, valid during a run of the suite */
+const char *C_DIVCHN_NAMES[4] = {"ht_divchn/insert",
+				 "ht_divchn/search_hit",
+				 "ht_divchn/search_miss",
+				 "ht_divchn/delete"};
+const char *C_MULOA_NAMES[4] = {"ht_muloa/insert",
+				"ht_muloa/search_hit",
+				"ht_muloa/search_miss",
+				"ht_muloa/delete"};
+const char *C_DIVCHN_PTHREAD_NAMES[4] = {"ht_divchn_pthread/insert",
+					 "ht_divchn_pthread/search_hit",
+					 "ht_divchn_pthread/search_miss",
+					 "ht_divchn_pthread/delete"};
+const char *C_HEAP_NAMES[3][2] = {{"heap_default/push",
+				   "heap_default/pop"},
+				  {"heap_ht_divchn/push",
+				   "heap_ht_divchn/pop"},
+				  {"heap_ht_muloa/push",
+				   "heap_ht_muloa/pop"}};
+const char *C_DIJKSTRA_NAMES[4] = {"dijkstra/default",
+				   "dijkstra/ht_divchn",
+				   "dijkstra/ht_muloa",
+				   "dijkstra_csr/default"};
+const char *C_PRIM_NAMES[4] = {"prim/default",
+			       "prim/ht_divchn",
+			       "prim/ht_muloa",
+			       "prim_csr/default"};
+
+typedef struct{
+  void *ht;
+  size_t alpha_n;
+  size_t log_alpha_d;
+  const char **names;
+  void (*init)(void *,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       int (*)(const void *, const void *),
+	       size_t (*)(const void *, size_t),
+	       void (*)(void *));
+  void (*insert)(void *, const void *, const void *);
+  void *(*search)(const void *, const void *);
+  void (*delete)(void *, const void *);
+  void (*free)(void *);
+} ht_ops_t;
+
+typedef struct{
+  size_t count;
+  size_t num_misses;
+  const size_t *keys;
+  ht_divchn_pthread_t *ht;
+  double cpu;
+} ht_pthread_arg_t;
+
+/* timed region of a run; counters start last and stop first */
+typedef struct{
+  int is_ctrs;
+  double wall;
+  double cpu;
+  double (*cpu_time)(void);
+} run_t;
+
+volatile size_t sink = 0; /* keeps results of timed runs observable */
+bench_ctrs_t ctrs; /* opened in main before any thread is created */
+int is_ctrs_on = 0;
+
+void check(int res, const char *msg);
+int cmp_sz(const void *a, const void *b);
+void add_sz(void *sum, const void *a, const void *b);
+void hht_divchn_init(heap_ht_t *hht, ht_divchn_t *ht_divchn);
+void hht_muloa_init(heap_ht_t *hht, ht_muloa_t *ht_muloa);
+void run_start(run_t *r, double (*cpu_time)(void), int is_ctrs);
+void run_stop(run_t *r, bench_t *b);
+void run_stop_cpu(run_t *r, bench_t *b, double cpu);
+
+/**
+   Division and multiplication-based hash tables. The keys at indices
+   [0, count) are inserted, and the keys at indices [count, 2 count) are
+   searched as keys that are not in a hash table.
+*/
+
+void bench_ht(bench_out_t *out,
+	      const ht_ops_t *ops,
+	      const size_t *keys,
+	      size_t count,
+	      size_t num_samples){
+  size_t i, j, num_found;
+  run_t r;
+  bench_t b[OP_COUNT];
+  for (j = 0; j < OP_COUNT; j++){
+    bench_init(&b[j], ops->names[j], count, 1, count, num_samples);
+  }
+  for (i = 0; i < num_samples; i++){
+    ops->init(ops->ht, sizeof(size_t), sizeof(size_t), 0,
+	      ops->alpha_n, ops->log_alpha_d, NULL, NULL, NULL);
+    run_start(&r, bench_thread_time, 1);
+    for (j = 0; j < count; j++){
+      ops->insert(ops->ht, &keys[j], &keys[j]);
+    }
+    run_stop(&r, &b[OP_INSERT]);
+    num_found = 0;
+    run_start(&r, bench_thread_time, 1);
+    for (j = 0; j < count; j++){
+      num_found += (ops->search(ops->ht, &keys[j]) != NULL);
+    }
+    run_stop(&r, &b[OP_SEARCH_HIT]);
+    check(num_found == count, "ht search_hit failed");
+    run_start(&r, bench_thread_time, 1);
+    for (j = count; j < 2 * count; j++){
+      num_found += (ops->search(ops->ht, &keys[j]) != NULL);
+    }
+    run_stop(&r, &b[OP_SEARCH_MISS]);
+    check(num_found == count, "ht search_miss failed");
+    run_start(&r, bench_thread_time, 1);
+    for (j = 0; j < count; j++){
+      ops->delete(ops->ht, &keys[j]);
+    }
+    run_stop(&r, &b[OP_DELETE]);
+    check(ops->search(ops->ht, &keys[0]) == NULL, "ht delete failed");
+    ops->free(ops->ht);
+  }
+  for (j = 0; j < OP_COUNT; j++){
+    bench_out_write(out, &b[j]);
+    bench_free(&b[j]);
+  }
+}
+
+/**
+   Operations of threads on a concurrent hash table. A thread inserts and
+   deletes its keys in batches of at most C_BATCH_COUNT keys, and measures
+   its CPU time.
+*/
+
+void *insert_thread(void *arg){
+  size_t i, n;
+  ht_pthread_arg_t *a = arg;
+  a->cpu = bench_thread_time();
+  for (i = 0; i < a->count; i += n){
+    n = (a->count - i < C_BATCH_COUNT) ? a->count - i : C_BATCH_COUNT;
+    ht_divchn_pthread_insert(a->ht, &a->keys[i], &a->keys[i], n);
+  }
+  a->cpu = bench_thread_time() - a->cpu;
+  return NULL;
+}
+
+void *search_thread(void *arg){
+  size_t i;
+  ht_pthread_arg_t *a = arg;
+  a->cpu = bench_thread_time();
+  a->num_misses = 0;
+  for (i = 0; i < a->count; i++){
+    a->num_misses += (ht_divchn_pthread_search(a->ht, &a->keys[i]) == NULL);
+  }
+  a->cpu = bench_thread_time() - a->cpu;
+  return NULL;
+}
+
+void *delete_thread(void *arg){
+  size_t i, n;
+  ht_pthread_arg_t *a = arg;
+  a->cpu = bench_thread_time();
+  for (i = 0; i < a->count; i += n){
+    n = (a->count - i < C_BATCH_COUNT) ? a->count - i : C_BATCH_COUNT;
+    ht_divchn_pthread_delete(a->ht, &a->keys[i], n);
+  }
+  a->cpu = bench_thread_time() - a->cpu;
+  return NULL;
+}
+
+/**
+   Runs a phase with num_threads threads, where the thread at index i
+   operates on the keys at indices [i count / num_threads,
+   (i + 1) count / num_threads) from keys, and adds a sample to b.
+   Returns the number of searched keys that were not found.
+*/
+size_t run_ht_pthread_phase(ht_divchn_pthread_t *ht,
+			    const size_t *keys,
+			    size_t count,
+			    size_t num_threads,
+			    void *(*thread)(void *),
+			    ht_pthread_arg_t *args,
+			    pthread_t *ids,
+			    bench_t *b){
+  size_t i, beg, end;
+  size_t num_misses = 0;
+  double cpu = 0.0;
+  run_t r;
+  for (i = 0; i < num_threads; i++){
+    beg = count / num_threads * i + count % num_threads * i / num_threads;
+    end = count / num_threads * (i + 1) +
+      count % num_threads * (i + 1) / num_threads;
+    args[i].count = end - beg;
+    args[i].num_misses = 0;
+    args[i].keys = &keys[beg];
+    args[i].ht = ht;
+  }
+  run_start(&r, NULL, 1);
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&ids[i], thread, &args[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  for (i = 0; i < num_threads; i++){
+    cpu += args[i].cpu;
+    num_misses += args[i].num_misses;
+  }
+  run_stop_cpu(&r, b, cpu);
+  return num_misses;
+}
+
+void bench_ht_pthread(bench_out_t *out,
+		      const size_t *keys,
+		      size_t count,
+		      size_t num_threads,
+		      size_t num_samples){
+  size_t i, j;
+  bench_t b[OP_COUNT];
+  ht_divchn_pthread_t ht;
+  ht_pthread_arg_t *args = NULL;
+  pthread_t *ids = NULL;
+  args = malloc_perror(num_threads, sizeof(ht_pthread_arg_t));
+  ids = malloc_perror(num_threads, sizeof(pthread_t));
+  for (j = 0; j < OP_COUNT; j++){
+    bench_init(&b[j], C_DIVCHN_PTHREAD_NAMES[j], count, num_threads, count,
+	       num_samples);
+  }
+  for (i = 0; i < num_samples; i++){
+    ht_divchn_pthread_init(&ht, sizeof(size_t), sizeof(size_t), 0,
+			   C_ALPHA_N_DIVCHN, C_LOG_ALPHA_D_DIVCHN,
+			   C_LOG_NUM_LOCKS, num_threads,
+			   NULL, NULL, NULL, NULL);
+    run_ht_pthread_phase(&ht, keys, count, num_threads, insert_thread,
+			 args, ids, &b[OP_INSERT]);
+    check(run_ht_pthread_phase(&ht, keys, count, num_threads,
+			       search_thread, args, ids,
+			       &b[OP_SEARCH_HIT]) == 0,
+	  "ht_divchn_pthread search_hit failed");
+    check(run_ht_pthread_phase(&ht, &keys[count], count, num_threads,
+			       search_thread, args, ids,
+			       &b[OP_SEARCH_MISS]) == count,
+	  "ht_divchn_pthread search_miss failed");
+    run_ht_pthread_phase(&ht, keys, count, num_threads, delete_thread,
+			 args, ids, &b[OP_DELETE]);
+    check(ht_divchn_pthread_search(&ht, &keys[0]) == NULL,
+	  "ht_divchn_pthread delete failed");
+    ht_divchn_pthread_free(&ht);
+  }
+  for (j = 0; j < OP_COUNT; j++){
+    bench_out_write(out, &b[j]);
+    bench_free(&b[j]);
+  }
+  free(args);
+  free(ids);
+  args = NULL;
+  ids = NULL;
+}
+
+void run_ht_benchs(bench_out_t *out,
+		   size_t log_count,
+		   size_t log_threads,
+		   size_t num_samples){
+  size_t i, count = pow_two(log_count);
+  size_t *keys = NULL;
+  ht_divchn_t ht_divchn;
+  ht_muloa_t ht_muloa;
+  ht_ops_t ops;
+  keys = malloc_perror(mul_sz_perror(2, count), sizeof(size_t));
+  for (i = 0; i < 2 * count; i++){
+    keys[i] = i * C_KEY_MUL + 1;
+  }
+  ops.ht = &ht_divchn;
+  ops.alpha_n = C_ALPHA_N_DIVCHN;
+  ops.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  ops.names = C_DIVCHN_NAMES;
+  ops.init = ht_divchn_init_helper;
+  ops.insert = ht_divchn_insert_helper;
+  ops.search = ht_divchn_search_helper;
+  ops.delete = ht_divchn_delete_helper;
+  ops.free = ht_divchn_free_helper;
+  bench_ht(out, &ops, keys, count, num_samples);
+  ops.ht = &ht_muloa;
+  ops.alpha_n = C_ALPHA_N_MULOA;
+  ops.log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  ops.names = C_MULOA_NAMES;
+  ops.init = ht_muloa_init_helper;
+  ops.insert = ht_muloa_insert_helper;
+  ops.search = ht_muloa_search_helper;
+  ops.delete = ht_muloa_delete_helper;
+  ops.free = ht_muloa_free_helper;
+  bench_ht(out, &ops, keys, count, num_samples);
+  for (i = 0; i <= log_threads; i++){
+    bench_ht_pthread(out, keys, count, pow_two(i), num_samples);
+  }
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Heap with an index array and with hash tables for in-heap operations.
+*/
+
+void bench_heap(bench_out_t *out,
+		const char **names,
+		const heap_ht_t *hht,
+		const size_t *ptys,
+		size_t count,
+		size_t num_samples){
+  size_t i, j;
+  size_t pty, elt, prev_pty;
+  int res = 1;
+  run_t r;
+  bench_t push, pop;
+  heap_t h;
+  bench_init(&push, names[0], count, 1, count, num_samples);
+  bench_init(&pop, names[1], count, 1, count, num_samples);
+  for (i = 0; i < num_samples; i++){
+    heap_init(&h, sizeof(size_t), sizeof(size_t), count,
+	      (hht == NULL) ? 0 : hht->alpha_n,
+	      (hht == NULL) ? 0 : hht->log_alpha_d,
+	      hht, cmp_sz, NULL, NULL, NULL);
+    run_start(&r, bench_thread_time, 1);
+    for (j = 0; j < count; j++){
+      heap_push(&h, &ptys[j], &j);
+    }
+    run_stop(&r, &push);
+    prev_pty = 0;
+    run_start(&r, bench_thread_time, 1);
+    for (j = 0; j < count; j++){
+      heap_pop(&h, &pty, &elt);
+      res *= (prev_pty <= pty);
+      prev_pty = pty;
+    }
+    run_stop(&r, &pop);
+    check(res && h.num_elts == 0, "heap pop failed");
+    heap_free(&h);
+  }
+  bench_out_write(out, &push);
+  bench_out_write(out, &pop);
+  bench_free(&push);
+  bench_free(&pop);
+}
+
+void run_heap_benchs(bench_out_t *out,
+		     size_t log_count,
+		     size_t num_samples){
+  size_t i, count = pow_two(log_count);
+  size_t *ptys = NULL;
+  ht_divchn_t ht_divchn;
+  ht_muloa_t ht_muloa;
+  heap_ht_t hht_divchn, hht_muloa;
+  ptys = malloc_perror(count, sizeof(size_t));
+  for (i = 0; i < count; i++){
+    ptys[i] = RANDOM();
+  }
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  hht_muloa_init(&hht_muloa, &ht_muloa);
+  bench_heap(out, C_HEAP_NAMES[0], NULL, ptys, count, num_samples);
+  bench_heap(out, C_HEAP_NAMES[1], &hht_divchn, ptys, count, num_samples);
+  bench_heap(out, C_HEAP_NAMES[2], &hht_muloa, ptys, count, num_samples);
+  free(ptys);
+  ptys = NULL;
+}
+
+/**
+   Serial and parallel sorting. The CPU time of a parallel sort is the CPU
+   time of the process, because the threads are created within the sort.
+*/
+
+int is_sorted(const size_t *a, size_t count){
+  size_t i;
+  for (i = 1; i < count; i++){
+    if (a[i - 1] > a[i]) return 0;
+  }
+  return 1;
+}
+
+void run_sort_benchs(bench_out_t *out,
+		     size_t log_count,
+		     size_t log_threads,
+		     size_t num_samples){
+  size_t i, j, num_threads, count = pow_two(log_count);
+  size_t *elts = NULL, *buf = NULL;
+  run_t r;
+  bench_t b;
+  pool_t pool;
+  elts = malloc_perror(count, sizeof(size_t));
+  buf = malloc_perror(count, sizeof(size_t));
+  for (i = 0; i < count; i++){
+    elts[i] = RANDOM();
+  }
+  bench_init(&b, "qsort", count, 1, count, num_samples);
+  for (i = 0; i < num_samples; i++){
+    memcpy(buf, elts, count * sizeof(size_t));
+    run_start(&r, bench_thread_time, 1);
+    qsort(buf, count, sizeof(size_t), cmp_sz);
+    run_stop(&r, &b);
+    check(is_sorted(buf, count), "qsort failed");
+  }
+  bench_out_write(out, &b);
+  bench_free(&b);
+  for (j = 0; j <= log_threads; j++){
+    num_threads = pow_two(j);
+    bench_init(&b, "mergesort_pthread_corank", count, num_threads, count,
+	       num_samples);
+    for (i = 0; i < num_samples; i++){
+      memcpy(buf, elts, count * sizeof(size_t));
+      run_start(&r, bench_process_time, 1);
+      mergesort_pthread_corank(buf, count, sizeof(size_t), num_threads,
+			       cmp_sz);
+      run_stop(&r, &b);
+      check(is_sorted(buf, count), "mergesort_pthread_corank failed");
+    }
+    bench_out_write(out, &b);
+    bench_free(&b);
+  }
+  for (j = 0; j <= log_threads; j++){
+    num_threads = pow_two(j);
+    pool_init(&pool, num_threads);
+    bench_init(&b, "mergesort_pthread_pool", count, num_threads, count,
+	       num_samples);
+    for (i = 0; i < num_samples; i++){
+      memcpy(buf, elts, count * sizeof(size_t));
+      run_start(&r, bench_process_time, 0);
+      mergesort_pthread_pool(&pool, buf, count, sizeof(size_t),
+			     C_SORT_SBASE_COUNT, C_SORT_MBASE_COUNT, cmp_sz);
+      run_stop(&r, &b);
+      check(is_sorted(buf, count), "mergesort_pthread_pool failed");
+    }
+    bench_out_write(out, &b);
+    bench_free(&b);
+    pool_free(&pool);
+  }
+  free(elts);
+  free(buf);
+  elts = NULL;
+  buf = NULL;
+}
+
+/**
+   Dijkstra's and Prim's algorithms on G(n, p) graphs with random weights.
+*/
+
+void write_rand_wts(graph_t *g){
+  size_t i;
+  size_t *wts = NULL;
+  g->wt_size = sizeof(size_t);
+  if (g->num_es == 0) return;
+  wts = malloc_perror(g->num_es, sizeof(size_t));
+  for (i = 0; i < g->num_es; i++){
+    wts[i] = 1 + RANDOM() % C_GRAPH_WT_MAX;
+  }
+  g->wts = wts;
+}
+
+void bench_graph(bench_out_t *out,
+		 const char **names,
+		 const adj_lst_t *a,
+		 const adj_csr_t *c,
+		 const heap_ht_t *hhts[3],
+		 const size_t *starts,
+		 size_t num_samples,
+		 int is_dijkstra){
+  size_t i, j;
+  size_t *dist = NULL, *prev = NULL;
+  run_t r;
+  bench_t b;
+  dist = malloc_perror(a->num_vts, sizeof(size_t));
+  prev = malloc_perror(a->num_vts, sizeof(size_t));
+  for (j = 0; j < 4; j++){
+    bench_init(&b, names[j], a->num_vts, 1, a->num_es, num_samples);
+    for (i = 0; i < num_samples; i++){
+      run_start(&r, bench_thread_time, 1);
+      if (is_dijkstra && j < 3){
+	dijkstra(a, starts[i], dist, prev, hhts[j], add_sz, cmp_sz);
+      }else if (is_dijkstra){
+	dijkstra_csr(c, starts[i], dist, prev, NULL, add_sz, cmp_sz);
+      }else if (j < 3){
+	prim(a, starts[i], dist, prev, hhts[j], cmp_sz);
+      }else{
+	prim_csr(c, starts[i], dist, prev, NULL, cmp_sz);
+      }
+      run_stop(&r, &b);
+      check(prev[starts[i]] == starts[i], "graph run failed");
+      sink += dist[a->num_vts - 1];
+    }
+    bench_out_write(out, &b);
+    bench_free(&b);
+  }
+  free(dist);
+  free(prev);
+  dist = NULL;
+  prev = NULL;
+}
+
+void run_graph_benchs(bench_out_t *out,
+		      size_t log_num_vts,
+		      size_t log_threads,
+		      size_t num_samples){
+  size_t i, num_vts = pow_two(log_num_vts);
+  size_t *starts = NULL;
+  double p = C_GRAPH_DEG / (num_vts - 1);
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  ht_divchn_t ht_divchn;
+  ht_muloa_t ht_muloa;
+  heap_ht_t hht_divchn, hht_muloa;
+  const heap_ht_t *hhts[3];
+  if (p > 1.0) p = 1.0;
+  starts = malloc_perror(num_samples, sizeof(size_t));
+  for (i = 0; i < num_samples; i++){
+    starts[i] = RANDOM() % num_vts;
+  }
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  hht_muloa_init(&hht_muloa, &ht_muloa);
+  hhts[0] = NULL;
+  hhts[1] = &hht_divchn;
+  hhts[2] = &hht_muloa;
+  graph_rand_gnp_dir_pthread(&g, num_vts, sizeof(size_t),
+			     graph_read_sz, graph_write_sz,
+			     p, C_GRAPH_SEED, pow_two(log_threads));
+  write_rand_wts(&g);
+  adj_lst_base_init(&a, &g);
+  adj_lst_dir_build(&a, &g);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
+  bench_graph(out, C_DIJKSTRA_NAMES, &a, &c, hhts, starts, num_samples, 1);
+  adj_lst_free(&a);
+  adj_csr_free(&c);
+  graph_free(&g);
+  graph_rand_gnp_undir_pthread(&g, num_vts, sizeof(size_t),
+			       graph_read_sz, graph_write_sz,
+			       p / 2.0, C_GRAPH_SEED, pow_two(log_threads));
+  write_rand_wts(&g);
+  adj_lst_base_init(&a, &g);
+  adj_lst_undir_build(&a, &g);
+  adj_csr_base_init(&c, &g);
+  adj_csr_undir_build(&c, &g);
+  bench_graph(out, C_PRIM_NAMES, &a, &c, hhts, starts, num_samples, 0);
+  adj_lst_free(&a);
+  adj_csr_free(&c);
+  graph_free(&g);
+  free(starts);
+  starts = NULL;
+}
+
+/**
+   Auxiliary functions.
+*/
+
+void check(int res, const char *msg){
+  if (!res){
+    fprintf(stderr, "%s\n", msg);
+    exit(EXIT_FAILURE);
+  }
+}
+
+int cmp_sz(const void *a, const void *b){
+  if (*(const size_t *)a > *(const size_t *)b) return 1;
+  if (*(const size_t *)a < *(const size_t *)b) return -1;
+  return 0;
+}
+
+void add_sz(void *sum, const void *a, const void *b){
+  *(size_t *)sum = *(const size_t *)a + *(const size_t *)b;
+}
+
+void hht_divchn_init(heap_ht_t *hht, ht_divchn_t *ht_divchn){
+  hht->ht = ht_divchn;
+  hht->alpha_n = C_ALPHA_N_DIVCHN;
+  hht->log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  hht->init = ht_divchn_init_helper;
+  hht->align = ht_divchn_align_helper;
+  hht->insert = ht_divchn_insert_helper;
+  hht->search = ht_divchn_search_helper;
+  hht->remove = ht_divchn_remove_helper;
+  hht->free = ht_divchn_free_helper;
+}
+
+void hht_muloa_init(heap_ht_t *hht, ht_muloa_t *ht_muloa){
+  hht->ht = ht_muloa;
+  hht->alpha_n = C_ALPHA_N_MULOA;
+  hht->log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  hht->init = ht_muloa_init_helper;
+  hht->align = ht_muloa_align_helper;
+  hht->insert = ht_muloa_insert_helper;
+  hht->search = ht_muloa_search_helper;
+  hht->remove = ht_muloa_remove_helper;
+  hht->free = ht_muloa_free_helper;
+}
+
+/**
+   Starts the timed region of a run. cpu_time is bench_thread_time,
+   bench_process_time, or NULL if the CPU time is provided to run_stop_cpu.
+   If is_ctrs is nonzero and hardware counters are on, the counters of
+   the run are recorded.
+*/
+void run_start(run_t *r, double (*cpu_time)(void), int is_ctrs){
+  r->is_ctrs = is_ctrs && is_ctrs_on;
+  r->cpu_time = cpu_time;
+  r->wall = bench_wall_time();
+  r->cpu = (cpu_time != NULL) ? cpu_time() : 0.0;
+  if (r->is_ctrs) bench_ctrs_start(&ctrs);
+}
+
+/**
+   Stops the timed region of a run and adds a sample to a benchmark.
+*/
+void run_stop(run_t *r, bench_t *b){
+  double vals[BENCH_CTR_COUNT];
+  double wall, cpu;
+  if (r->is_ctrs) bench_ctrs_stop(&ctrs, vals);
+  wall = bench_wall_time() - r->wall;
+  cpu = r->cpu_time() - r->cpu;
+  bench_add_ctrs(b, wall, cpu, (r->is_ctrs) ? vals : NULL);
+}
+
+/**
+   Stops the timed region of a run and adds a sample with a CPU time
+   measured by the threads of the run to a benchmark.
+*/
+void run_stop_cpu(run_t *r, bench_t *b, double cpu){
+  double vals[BENCH_CTR_COUNT];
+  double wall;
+  if (r->is_ctrs) bench_ctrs_stop(&ctrs, vals);
+  wall = bench_wall_time() - r->wall;
+  bench_add_ctrs(b, wall, cpu, (r->is_ctrs) ? vals : NULL);
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  bench_out_t out;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] < 1 ||
+      args[1] > C_FULL_BIT - 2 ||
+      args[2] < 1 ||
+      args[3] > C_THREADS_LOG_MAX ||
+      args[4] > 1 ||
+      args[5] > 1 ||
+      args[6] > 1 ||
+      args[7] > 1 ||
+      args[8] > 1 ||
+      args[9] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[9]) is_ctrs_on = (bench_ctrs_init(&ctrs) > 0);
+  bench_out_init(&out, stdout, (args[4]) ? BENCH_JSON : BENCH_CSV);
+  if (args[5]) run_ht_benchs(&out, args[0], args[3], args[2]);
+  if (args[6]) run_heap_benchs(&out, args[0], args[2]);
+  if (args[7]) run_sort_benchs(&out, args[0], args[3], args[2]);
+  if (args[8]) run_graph_benchs(&out, args[1], args[3], args[2]);
+  bench_out_free(&out);
+  if (args[9]) bench_ctrs_free(&ctrs);
+  free(args);
+  args = NULL;
+  return 0;
+}
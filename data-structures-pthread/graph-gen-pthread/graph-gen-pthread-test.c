@@ -0,0 +1,401 @@
+/**
+   graph-gen-pthread-test.c
+
+   Tests of the parallel generation of random graphs with generic integer
+   vertices.
+
+   The following command line arguments can be used to customize tests:
+   graph-gen-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, bit width of size_t / 2] : m for 2**m average degree
+      [1, 2**8] : number of threads in parallel generation
+      [0, 1] : G(n, p) test on/off
+      [0, 1] : R-MAT test on/off
+      [0, 1] : random geometric test on/off
+
+   usage examples:
+   ./graph-gen-pthread-test
+   ./graph-gen-pthread-test 10 20
+   ./graph-gen-pthread-test 20 20 4 8 0 1 0
+
+   graph-gen-pthread-test can be run with any subset of command line
+   arguments in the above-defined order. If the (i + 1)th argument is
+   specified then the ith argument must be specified for i >= 0. Default
+   values are used for the unspecified arguments according to the
+   C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include "graph-gen-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "graph-gen-pthread-test \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph \n"
+  "[0, bit width of size_t / 2] : m for 2**m average degree \n"
+  "[1, 2**8] : number of threads in parallel generation \n"
+  "[0, 1] : G(n, p) test on/off \n"
+  "[0, 1] : R-MAT test on/off \n"
+  "[0, 1] : random geometric test on/off \n";
+const int C_ARGC_MAX = 8;
+const size_t C_ARGS_DEF[7] = {10, 18, 4, 4, 1, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_THREADS_MAX = 256;
+
+/* G(n, p) test */
+const size_t C_GNP_BASE_POW_MAX = 12; /* adj_lst_rand_undir comparison */
+const size_t C_GNP_COMPLETE_VTS = 50;
+const double C_GNP_SIGMAS = 6.0;
+
+/* R-MAT test */
+const double C_RMAT_A = 0.57;
+const double C_RMAT_B = 0.19;
+const double C_RMAT_C = 0.19;
+
+/* random geometric test */
+const size_t C_GEOM_BRUTE_POW_MAX = 12;
+const double C_PI = 3.14159265358979323846;
+
+int same_graph(const graph_t *a, const graph_t *b);
+int sorted_graph(const graph_t *g, int undir);
+double timer();
+void print_test_result(int res);
+
+/**
+   Returns nonzero with probability according to a double pointed to by
+   arg, for the comparison with adj_lst_rand_undir.
+*/
+int bern(void *arg){
+  double p = *(double *)arg;
+  if (p >= 1.0) return 1;
+  if (p <= 0.0) return 0;
+  return DRAND() < p;
+}
+
+/**
+   Runs a test of the generation of directed and undirected G(n, p) graphs
+   with one and num_threads threads, with 2^log_deg expected edges per
+   vertex.
+*/
+void run_gnp_test(int pow_start,
+		  int pow_end,
+		  size_t log_deg,
+		  size_t num_threads){
+  int res = 1;
+  int i, undir;
+  size_t n, num_pairs;
+  size_t seed = RANDOM();
+  double p, mean, sigma;
+  double t, t_pthread, t_base;
+  graph_t g, g_pthread;
+  adj_lst_t a;
+  printf("Run a G(n, p) generation test with %lu threads\n",
+	 TOLU(num_threads));
+  for (i = pow_start; i <= pow_end; i++){
+    n = pow_two(i);
+    for (undir = 0; undir <= 1; undir++){
+      p = (n > 1) ? (double)pow_two(log_deg) / (n - 1) : 0.0;
+      if (p > 1.0) p = 1.0;
+      num_pairs = (n > 0) ? (undir ? n * (n - 1) / 2 : n * (n - 1)) : 0;
+      t = timer();
+      if (undir){
+	graph_rand_gnp_undir_pthread(&g, n, sizeof(size_t),
+				     graph_read_sz, graph_write_sz,
+				     p, seed, 1);
+      }else{
+	graph_rand_gnp_dir_pthread(&g, n, sizeof(size_t),
+				   graph_read_sz, graph_write_sz,
+				   p, seed, 1);
+      }
+      t = timer() - t;
+      t_pthread = timer();
+      if (undir){
+	graph_rand_gnp_undir_pthread(&g_pthread, n, sizeof(size_t),
+				     graph_read_sz, graph_write_sz,
+				     p, seed, num_threads);
+      }else{
+	graph_rand_gnp_dir_pthread(&g_pthread, n, sizeof(size_t),
+				   graph_read_sz, graph_write_sz,
+				   p, seed, num_threads);
+      }
+      t_pthread = timer() - t_pthread;
+      mean = num_pairs * p;
+      sigma = sqrt(mean * (1.0 - p));
+      res *= same_graph(&g, &g_pthread);
+      res *= sorted_graph(&g, undir);
+      res *= (fabs(g.num_es - mean) <= C_GNP_SIGMAS * sigma + 1.0);
+      printf("\t%s, # vertices: %lu, p: %.2e, # edges: %lu\n",
+	     undir ? "undirected" : "directed", TOLU(n), p, TOLU(g.num_es));
+      printf("\t\t1 thread:                 %.6f seconds\n"
+	     "\t\t%3lu threads:              %.6f seconds\n",
+	     t, TOLU(num_threads), t_pthread);
+      if (undir && (size_t)i <= C_GNP_BASE_POW_MAX){
+	t_base = timer();
+	adj_lst_rand_undir(&a, n, sizeof(size_t),
+			   graph_read_sz, graph_write_sz, bern, &p);
+	t_base = timer() - t_base;
+	printf("\t\tadj_lst_rand_undir:       %.6f seconds\n", t_base);
+	adj_lst_free(&a);
+      }
+      graph_free(&g);
+      graph_free(&g_pthread);
+    }
+  }
+  graph_rand_gnp_undir_pthread(&g, C_GNP_COMPLETE_VTS, sizeof(size_t),
+			       graph_read_sz, graph_write_sz,
+			       1.0, seed, num_threads);
+  res *= (g.num_es == C_GNP_COMPLETE_VTS * (C_GNP_COMPLETE_VTS - 1) / 2);
+  res *= sorted_graph(&g, 1);
+  graph_free(&g);
+  graph_rand_gnp_dir_pthread(&g, C_GNP_COMPLETE_VTS, sizeof(size_t),
+			     graph_read_sz, graph_write_sz,
+			     1.0, seed, num_threads);
+  res *= (g.num_es == C_GNP_COMPLETE_VTS * (C_GNP_COMPLETE_VTS - 1));
+  res *= sorted_graph(&g, 0);
+  graph_free(&g);
+  graph_rand_gnp_dir_pthread(&g, C_GNP_COMPLETE_VTS, sizeof(size_t),
+			     graph_read_sz, graph_write_sz,
+			     0.0, seed, num_threads);
+  res *= (g.num_es == 0 && g.u == NULL && g.v == NULL);
+  graph_free(&g);
+  printf("\tcorrectness:                      ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of the generation of R-MAT graphs with one and num_threads
+   threads, with 2^log_deg edges per vertex.
+*/
+void run_rmat_test(int pow_start,
+		   int pow_end,
+		   size_t log_deg,
+		   size_t num_threads){
+  int res = 1;
+  int i;
+  size_t j, n, num_es;
+  size_t seed = RANDOM();
+  double t, t_pthread;
+  graph_t g, g_pthread;
+  printf("Run an R-MAT generation test with %lu threads, "
+	 "a = %.2f, b = %.2f, c = %.2f\n",
+	 TOLU(num_threads), C_RMAT_A, C_RMAT_B, C_RMAT_C);
+  for (i = pow_start; i <= pow_end; i++){
+    n = pow_two(i);
+    num_es = n * pow_two(log_deg);
+    t = timer();
+    graph_rand_rmat_pthread(&g, i, num_es, sizeof(size_t),
+			    graph_read_sz, graph_write_sz,
+			    C_RMAT_A, C_RMAT_B, C_RMAT_C, seed, 1);
+    t = timer() - t;
+    t_pthread = timer();
+    graph_rand_rmat_pthread(&g_pthread, i, num_es, sizeof(size_t),
+			    graph_read_sz, graph_write_sz,
+			    C_RMAT_A, C_RMAT_B, C_RMAT_C, seed, num_threads);
+    t_pthread = timer() - t_pthread;
+    res *= same_graph(&g, &g_pthread);
+    res *= (g.num_vts == n && g.num_es == num_es);
+    for (j = 0; j < g.num_es; j++){
+      res *= (*((size_t *)g.u + j) < n && *((size_t *)g.v + j) < n);
+    }
+    printf("\t# vertices: %lu, # edges: %lu\n", TOLU(n), TOLU(num_es));
+    printf("\t\t1 thread:                 %.6f seconds\n"
+	   "\t\t%3lu threads:              %.6f seconds\n",
+	   t, TOLU(num_threads), t_pthread);
+    graph_free(&g);
+    graph_free(&g_pthread);
+  }
+  graph_rand_rmat_pthread(&g, pow_end, pow_two(pow_end), sizeof(size_t),
+			  graph_read_sz, graph_write_sz,
+			  1.0, 0.0, 0.0, seed, num_threads);
+  for (j = 0; j < g.num_es; j++){
+    res *= (*((size_t *)g.u + j) == 0 && *((size_t *)g.v + j) == 0);
+  }
+  graph_free(&g);
+  printf("\tcorrectness:                      ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of the generation of random geometric graphs with one and
+   num_threads threads, with a radius providing 2^log_deg expected edges
+   per vertex. The edges of smaller graphs are compared to the pairs of
+   vertices within the radius.
+*/
+void run_geom_test(int pow_start,
+		   int pow_end,
+		   size_t log_deg,
+		   size_t num_threads){
+  int res = 1;
+  int i;
+  size_t j, k, n, u, v, num_es;
+  size_t seed = RANDOM();
+  double r, dx, dy;
+  double t, t_pthread;
+  double *xy = NULL, *xy_pthread = NULL;
+  graph_t g, g_pthread;
+  printf("Run a random geometric generation test with %lu threads\n",
+	 TOLU(num_threads));
+  for (i = pow_start; i <= pow_end; i++){
+    n = pow_two(i);
+    r = sqrt(pow_two(log_deg) / (C_PI * n));
+    xy = malloc_perror(2 * n, sizeof(double));
+    xy_pthread = malloc_perror(2 * n, sizeof(double));
+    t = timer();
+    graph_rand_geom_pthread(&g, n, sizeof(size_t),
+			    graph_read_sz, graph_write_sz,
+			    r, xy, seed, 1);
+    t = timer() - t;
+    t_pthread = timer();
+    graph_rand_geom_pthread(&g_pthread, n, sizeof(size_t),
+			    graph_read_sz, graph_write_sz,
+			    r, xy_pthread, seed, num_threads);
+    t_pthread = timer() - t_pthread;
+    res *= same_graph(&g, &g_pthread);
+    res *= (memcmp(xy, xy_pthread, 2 * n * sizeof(double)) == 0);
+    for (j = 0; j < g.num_es; j++){
+      u = *((size_t *)g.u + j);
+      v = *((size_t *)g.v + j);
+      dx = xy[2 * u] - xy[2 * v];
+      dy = xy[2 * u + 1] - xy[2 * v + 1];
+      res *= (u < v && v < n && dx * dx + dy * dy <= r * r);
+    }
+    if ((size_t)i <= C_GEOM_BRUTE_POW_MAX){
+      num_es = 0;
+      for (j = 0; j < n; j++){
+	for (k = j + 1; k < n; k++){
+	  dx = xy[2 * j] - xy[2 * k];
+	  dy = xy[2 * j + 1] - xy[2 * k + 1];
+	  num_es += (dx * dx + dy * dy <= r * r);
+	}
+      }
+      res *= (num_es == g.num_es);
+    }
+    printf("\t# vertices: %lu, radius: %.2e, # edges: %lu\n",
+	   TOLU(n), r, TOLU(g.num_es));
+    printf("\t\t1 thread:                 %.6f seconds\n"
+	   "\t\t%3lu threads:              %.6f seconds\n",
+	   t, TOLU(num_threads), t_pthread);
+    graph_free(&g);
+    graph_free(&g_pthread);
+    free(xy);
+    free(xy_pthread);
+    xy = NULL;
+    xy_pthread = NULL;
+  }
+  graph_rand_geom_pthread(&g, C_GNP_COMPLETE_VTS, sizeof(size_t),
+			  graph_read_sz, graph_write_sz,
+			  2.0, NULL, seed, num_threads);
+  res *= (g.num_es == C_GNP_COMPLETE_VTS * (C_GNP_COMPLETE_VTS - 1) / 2);
+  graph_free(&g);
+  printf("\tcorrectness:                      ");
+  print_test_result(res);
+}
+
+/**
+   Returns 1 if two graphs have the same edges in the same order, otherwise
+   returns 0.
+*/
+int same_graph(const graph_t *a, const graph_t *b){
+  if (a->num_vts != b->num_vts || a->num_es != b->num_es) return 0;
+  if (a->num_es == 0) return 1;
+  return (memcmp(a->u, b->u, a->num_es * a->vt_size) == 0 &&
+	  memcmp(a->v, b->v, a->num_es * a->vt_size) == 0);
+}
+
+/**
+   Returns 1 if the edges of a graph are in strictly increasing order of
+   (u, v) pairs with u != v, and u < v if undir is nonzero, otherwise
+   returns 0.
+*/
+int sorted_graph(const graph_t *g, int undir){
+  size_t i, u, v, pu = 0, pv = 0;
+  for (i = 0; i < g->num_es; i++){
+    u = *((size_t *)g->u + i);
+    v = *((size_t *)g->v + i);
+    if (u == v || u >= g->num_vts || v >= g->num_vts) return 0;
+    if (undir && u > v) return 0;
+    if (i > 0 && (u < pu || (u == pu && v <= pv))) return 0;
+    pu = u;
+    pv = v;
+  }
+  return 1;
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / (double)1000000;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_FULL_BIT / 2 ||
+      args[3] < 1 ||
+      args[3] > C_THREADS_MAX ||
+      args[4] > 1 ||
+      args[5] > 1 ||
+      args[6] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[4]) run_gnp_test(args[0], args[1], args[2], args[3]);
+  if (args[5]) run_rmat_test(args[0], args[1], args[2], args[3]);
+  if (args[6]) run_geom_test(args[0], args[1], args[2], args[3]);
+  free(args);
+  args = NULL;
+  return 0;
+}
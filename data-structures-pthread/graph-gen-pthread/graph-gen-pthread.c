@@ -0,0 +1,620 @@
+/**
+   graph-gen-pthread.c
+
+   Functions for generating random graphs with generic integer vertices in
+   parallel, with the edges written directly to the edge arrays of a
+   graph_t struct.
+
+   Three random graph models are provided: i) G(n, p), where each of the
+   possible edges is added with probability p, and the vertex pairs
+   between two consecutive edges are skipped by drawing a number from a
+   geometric distribution, so that the runtime is linear in the number of
+   vertices and edges and not in the number of vertex pairs, ii) R-MAT
+   (recursive matrix, a Kronecker graph with a 2 x 2 initiator), where the
+   source and target of each edge are selected by recursively choosing a
+   quadrant of the adjacency matrix, and iii) random geometric graphs,
+   where each vertex is a point in the unit square and two vertices are
+   adjacent if their Euclidean distance is at most a radius, with
+   neighbors found in a grid of cells.
+
+   The work of a generator is partitioned into blocks of vertices, edges,
+   or cells with a count that does not depend on the number of threads,
+   and each block has its own random number sequence derived from a seed
+   and the index of the block. A generator runs a counting pass over the
+   blocks, followed by a prefix sum over the counts of edges in the blocks
+   and a pass that writes the edges of each block to their positions. A
+   generated graph is thereby a function of the seed and the parameters of
+   a generator, and does not depend on the number of threads. The blocks
+   are assigned to threads in a round-robin order for load balancing.
+
+   The random number sequence of a block is a splitmix sequence of size_t
+   values generalized to the width of size_t. The random number generator
+   is not suitable for cryptographic use. Given parameter values within
+   the specified ranges, the implementation provides an error message and
+   an exit is executed if an integer overflow is attempted or an allocation
+   is not completed due to insufficient resources. The behavior outside
+   the specified parameter ranges is undefined.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include "graph-gen-pthread.h"
+#include "graph.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef enum{GNP_DIR, GNP_UNDIR, RMAT, GEOM} model_t;
+typedef enum{PASS_POINTS, PASS_COUNT, PASS_WRITE} pass_t;
+
+static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+static const size_t C_VTS_BLOCK = 256; /* vertices per block */
+static const size_t C_ES_BLOCK = 65536; /* R-MAT edges per block */
+
+/* splitmix constants truncated to the width of size_t, all odd */
+static const size_t C_MIX_INCR = ((((((size_t)0x9e37u << 8 << 8) |
+				     0x79b9u) << 8 << 8) |
+				   0x7f4au) << 8 << 8) | 0x7c15u;
+static const size_t C_MIX_MUL_A = ((((((size_t)0xbf58u << 8 << 8) |
+				      0x476du) << 8 << 8) |
+				    0x1ce4u) << 8 << 8) | 0xe5b9u;
+static const size_t C_MIX_MUL_B = ((((((size_t)0x94d0u << 8 << 8) |
+				      0x49bbu) << 8 << 8) |
+				    0x1331u) << 8 << 8) | 0x11ebu;
+static const size_t C_MIX_SHIFT_A = CHAR_BIT * sizeof(size_t) * 15 / 32;
+static const size_t C_MIX_SHIFT_B = CHAR_BIT * sizeof(size_t) * 27 / 64;
+static const size_t C_MIX_SHIFT_C = CHAR_BIT * sizeof(size_t) / 2 - 1;
+
+typedef struct{
+  model_t model;
+  pass_t pass;
+  size_t num_vts;
+  size_t num_blocks;
+  size_t num_threads;
+  size_t seed;
+  size_t unif_bits;
+  size_t unif_shift;
+  double unif_scale;
+  size_t *offsets; /* num_blocks + 1 positions of the edges of blocks */
+  graph_t *g;
+  /* G(n, p) */
+  double p;
+  double log_q; /* log(1 - p) */
+  /* R-MAT */
+  size_t log_num_vts;
+  size_t num_es;
+  size_t a, ab, abc; /* cumulative quadrant probabilities * 2^unif_bits */
+  /* random geometric */
+  size_t side; /* number of cells per side of the unit square */
+  double r2;
+  double *xy;
+  size_t *cell_starts; /* side * side + 1 */
+  size_t *cell_vts;
+} gen_t;
+
+typedef struct{
+  size_t id;
+  gen_t *gen;
+} gen_arg_t;
+
+static void gen_init(gen_t *gen,
+		     model_t model,
+		     graph_t *g,
+		     size_t num_vts,
+		     size_t vt_size,
+		     size_t (*read_vt)(const void *),
+		     void (*write_vt)(void *, size_t),
+		     size_t seed,
+		     size_t num_threads);
+static void gnp(gen_t *gen, double p);
+static void gen_edges(gen_t *gen, size_t num_blocks);
+static void run_threads(gen_t *gen, size_t num_blocks, pass_t pass);
+static void *gen_thread(void *arg);
+static size_t gnp_block(const gen_t *gen, size_t i, size_t pos);
+static size_t rmat_block(const gen_t *gen, size_t i, size_t pos);
+static size_t rmat_threshold(const gen_t *gen, double p);
+static void points_block(const gen_t *gen, size_t i);
+static size_t geom_block(const gen_t *gen, size_t i, size_t pos);
+static void geom_cells(gen_t *gen);
+static size_t geom_cell(const gen_t *gen, double x);
+static void write_edge(const gen_t *gen, size_t pos, size_t u, size_t v);
+static size_t rng_init(size_t seed, size_t i);
+static size_t rng_next(size_t *s);
+static double rng_unif(const gen_t *gen, size_t *s);
+static size_t mix(size_t a);
+static size_t num_blocks(size_t n, size_t block);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Generates a directed unweighted G(n, p) graph with num_vts vertices,
+   where each of num_vts(num_vts - 1) possible edges is added with
+   probability p. The edges are ordered by source vertex and then by
+   target vertex.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   num_vts     : number of vertices
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   p           : >= 0.0 and <= 1.0 probability of an edge
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_gnp_dir_pthread(graph_t *g,
+				size_t num_vts,
+				size_t vt_size,
+				size_t (*read_vt)(const void *),
+				void (*write_vt)(void *, size_t),
+				double p,
+				size_t seed,
+				size_t num_threads){
+  gen_t gen;
+  gen_init(&gen, GNP_DIR, g, num_vts, vt_size, read_vt, write_vt,
+	   seed, num_threads);
+  gnp(&gen, p);
+}
+
+/**
+   Generates an undirected unweighted G(n, p) graph with num_vts vertices,
+   where each of num_vts(num_vts - 1)/2 possible edges is added with
+   probability p. Each edge (u, v) satisfies u < v, and the edges are
+   ordered by u and then by v. Please see the parameter specification in
+   graph_rand_gnp_dir_pthread.
+*/
+void graph_rand_gnp_undir_pthread(graph_t *g,
+				  size_t num_vts,
+				  size_t vt_size,
+				  size_t (*read_vt)(const void *),
+				  void (*write_vt)(void *, size_t),
+				  double p,
+				  size_t seed,
+				  size_t num_threads){
+  gen_t gen;
+  gen_init(&gen, GNP_UNDIR, g, num_vts, vt_size, read_vt, write_vt,
+	   seed, num_threads);
+  gnp(&gen, p);
+}
+
+/**
+   Generates a directed unweighted R-MAT graph with 2^log_num_vts vertices
+   and num_es edges. At each of log_num_vts levels, the quadrant of the
+   adjacency matrix is chosen with the probabilities a, b, c, and
+   1 - a - b - c for the top left, top right, bottom left, and bottom
+   right quadrants respectively. The graph may contain loops and multiple
+   edges.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   log_num_vts : < CHAR_BIT * sizeof(size_t)
+   num_es      : number of edges
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   a, b, c     : >= 0.0 probabilities with a + b + c <= 1.0
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_rmat_pthread(graph_t *g,
+			     size_t log_num_vts,
+			     size_t num_es,
+			     size_t vt_size,
+			     size_t (*read_vt)(const void *),
+			     void (*write_vt)(void *, size_t),
+			     double a,
+			     double b,
+			     double c,
+			     size_t seed,
+			     size_t num_threads){
+  gen_t gen;
+  gen_init(&gen, RMAT, g, (size_t)1 << log_num_vts, vt_size,
+	   read_vt, write_vt, seed, num_threads);
+  gen.log_num_vts = log_num_vts;
+  gen.num_es = num_es;
+  gen.a = rmat_threshold(&gen, a);
+  gen.ab = rmat_threshold(&gen, a + b);
+  gen.abc = rmat_threshold(&gen, a + b + c);
+  if (num_es > 0) gen_edges(&gen, num_blocks(num_es, C_ES_BLOCK));
+}
+
+/**
+   Generates an undirected unweighted random geometric graph with num_vts
+   vertices that are points in the unit square, where two vertices u < v
+   are adjacent if their Euclidean distance is at most radius. Each edge
+   (u, v) satisfies u < v.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   num_vts     : number of vertices
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   radius      : > 0.0
+   coords      : NULL, or pointer to a preallocated block of
+                 2 * num_vts doubles, where the x and y coordinates of the
+                 vertex u are written at indices 2 * u and 2 * u + 1
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_geom_pthread(graph_t *g,
+			     size_t num_vts,
+			     size_t vt_size,
+			     size_t (*read_vt)(const void *),
+			     void (*write_vt)(void *, size_t),
+			     double radius,
+			     double *coords,
+			     size_t seed,
+			     size_t num_threads){
+  gen_t gen;
+  gen_init(&gen, GEOM, g, num_vts, vt_size, read_vt, write_vt,
+	   seed, num_threads);
+  if (num_vts == 0) return;
+  gen.r2 = radius * radius;
+  gen.side = (radius < 1.0) ? (size_t)(1.0 / radius) : 1;
+  if (gen.side * (double)gen.side > (double)num_vts){
+    gen.side = (size_t)sqrt((double)num_vts);
+  }
+  if (gen.side == 0) gen.side = 1;
+  if (coords != NULL){
+    gen.xy = coords;
+  }else{
+    gen.xy = malloc_perror(mul_sz_perror(2, num_vts), sizeof(double));
+  }
+  run_threads(&gen, num_blocks(num_vts, C_VTS_BLOCK), PASS_POINTS);
+  geom_cells(&gen);
+  gen_edges(&gen, gen.side);
+  if (coords == NULL) free(gen.xy);
+  free(gen.cell_starts);
+  free(gen.cell_vts);
+  gen.xy = NULL;
+  gen.cell_starts = NULL;
+  gen.cell_vts = NULL;
+}
+
+/**
+   Initializes a generator and a graph with no edges.
+*/
+static void gen_init(gen_t *gen,
+		     model_t model,
+		     graph_t *g,
+		     size_t num_vts,
+		     size_t vt_size,
+		     size_t (*read_vt)(const void *),
+		     void (*write_vt)(void *, size_t),
+		     size_t seed,
+		     size_t num_threads){
+  size_t k = (C_FULL_BIT - 1 < DBL_MANT_DIG) ? C_FULL_BIT - 1 : DBL_MANT_DIG;
+  size_t i;
+  graph_base_init(g, num_vts, vt_size, 0, read_vt, write_vt);
+  gen->model = model;
+  gen->num_vts = num_vts;
+  gen->num_threads = num_threads;
+  gen->seed = seed;
+  gen->unif_bits = k;
+  gen->unif_shift = C_FULL_BIT - k;
+  gen->unif_scale = 1.0;
+  for (i = 0; i < k; i++){
+    gen->unif_scale *= 0.5;
+  }
+  gen->offsets = NULL;
+  gen->g = g;
+}
+
+/**
+   Generates the edges of a G(n, p) graph. No edges are generated if
+   log(1 - p) is rounded to 0.0.
+*/
+static void gnp(gen_t *gen, double p){
+  gen->p = p;
+  gen->log_q = (p < 1.0) ? log(1.0 - p) : 0.0;
+  if (gen->num_vts > 1 && p > 0.0 && (p >= 1.0 || gen->log_q < 0.0)){
+    gen_edges(gen, num_blocks(gen->num_vts, C_VTS_BLOCK));
+  }
+}
+
+/**
+   Runs the counting pass, the prefix sum, and the writing pass over the
+   blocks of a generator, and allocates the edge arrays of the graph.
+*/
+static void gen_edges(gen_t *gen, size_t num_blocks){
+  size_t i;
+  graph_t *g = gen->g;
+  gen->offsets = calloc_perror(add_sz_perror(num_blocks, 1),
+			       sizeof(size_t));
+  run_threads(gen, num_blocks, PASS_COUNT);
+  for (i = 0; i < num_blocks; i++){
+    gen->offsets[i + 1] = add_sz_perror(gen->offsets[i + 1],
+					gen->offsets[i]);
+  }
+  g->num_es = gen->offsets[num_blocks];
+  if (g->num_es > 0){
+    g->u = malloc_perror(g->num_es, g->vt_size);
+    g->v = malloc_perror(g->num_es, g->vt_size);
+    run_threads(gen, num_blocks, PASS_WRITE);
+  }
+  free(gen->offsets);
+  gen->offsets = NULL;
+}
+
+/**
+   Runs a pass over num_blocks blocks with num_threads threads and joins
+   the threads.
+*/
+static void run_threads(gen_t *gen, size_t num_blocks, pass_t pass){
+  size_t i;
+  pthread_t *tids = NULL;
+  gen_arg_t *args = NULL;
+  gen->pass = pass;
+  gen->num_blocks = num_blocks;
+  tids = malloc_perror(gen->num_threads, sizeof(pthread_t));
+  args = malloc_perror(gen->num_threads, sizeof(gen_arg_t));
+  for (i = 0; i < gen->num_threads; i++){
+    args[i].id = i;
+    args[i].gen = gen;
+    thread_create_perror(&tids[i], gen_thread, &args[i]);
+  }
+  for (i = 0; i < gen->num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  free(tids);
+  free(args);
+  tids = NULL;
+  args = NULL;
+}
+
+/**
+   Runs a pass over the blocks of a thread. In the counting pass, the
+   count of edges of the block at index i is stored at index i + 1 of the
+   offsets array. In the writing pass, the edges of the block at index i
+   are written starting from the position at index i.
+*/
+static void *gen_thread(void *arg){
+  size_t i, count = 0;
+  gen_arg_t *ga = arg;
+  gen_t *gen = ga->gen;
+  for (i = ga->id; i < gen->num_blocks; i += gen->num_threads){
+    if (gen->pass == PASS_POINTS){
+      points_block(gen, i);
+      continue;
+    }
+    switch (gen->model){
+    case GNP_DIR:
+    case GNP_UNDIR:
+      count = gnp_block(gen, i, gen->offsets[i]);
+      break;
+    case RMAT:
+      count = rmat_block(gen, i, gen->offsets[i]);
+      break;
+    case GEOM:
+      count = geom_block(gen, i, gen->offsets[i]);
+      break;
+    }
+    if (gen->pass == PASS_COUNT) gen->offsets[i + 1] = count;
+  }
+  return NULL;
+}
+
+/**
+   Generates the G(n, p) edges with a source vertex in the block of
+   vertices at index i and returns the number of edges. The number of
+   vertex pairs skipped before the next edge is floor(log(U) / log(1 - p)),
+   where U is uniform in (0, 1), and the skip is applied across the lists
+   of possible target vertices of the sources in the block.
+*/
+static size_t gnp_block(const gen_t *gen, size_t i, size_t pos){
+  size_t u, j, len, count = 0;
+  size_t s = rng_init(gen->seed, i);
+  size_t u_end = (gen->num_vts - i * C_VTS_BLOCK > C_VTS_BLOCK) ?
+    (i + 1) * C_VTS_BLOCK : gen->num_vts;
+  double d, rem;
+  u = i * C_VTS_BLOCK;
+  j = 0;
+  while (1){
+    d = (gen->p < 1.0) ? floor(log(rng_unif(gen, &s)) / gen->log_q) : 0.0;
+    while (u < u_end){
+      len = (gen->model == GNP_DIR) ? gen->num_vts - 1 : gen->num_vts - u - 1;
+      rem = (double)(len - j);
+      if (d < rem) break;
+      d -= rem;
+      u++;
+      j = 0;
+    }
+    if (u == u_end) break;
+    j += (size_t)d;
+    if (gen->pass == PASS_WRITE){
+      if (gen->model == GNP_DIR){
+	write_edge(gen, pos + count, u, j + (j >= u));
+      }else{
+	write_edge(gen, pos + count, u, u + 1 + j);
+      }
+    }
+    count++;
+    j++;
+  }
+  return count;
+}
+
+/**
+   Generates the R-MAT edges in the block of edges at index i and returns
+   the number of edges. A quadrant is chosen without branches by comparing
+   the top unif_bits bits of a random value with the thresholds of the
+   cumulative quadrant probabilities.
+*/
+static size_t rmat_block(const gen_t *gen, size_t i, size_t pos){
+  size_t e, k, u, v, r;
+  size_t s = rng_init(gen->seed, i);
+  size_t e_start = i * C_ES_BLOCK;
+  size_t e_end = (gen->num_es - e_start > C_ES_BLOCK) ?
+    e_start + C_ES_BLOCK : gen->num_es;
+  if (gen->pass == PASS_COUNT) return e_end - e_start;
+  for (e = e_start; e < e_end; e++){
+    u = 0;
+    v = 0;
+    for (k = 0; k < gen->log_num_vts; k++){
+      r = rng_next(&s) >> gen->unif_shift;
+      u = (u << 1) | (r >= gen->ab);
+      v = (v << 1) | ((r >= gen->a) ^ (r >= gen->ab) ^ (r >= gen->abc));
+    }
+    write_edge(gen, pos + e - e_start, u, v);
+  }
+  return e_end - e_start;
+}
+
+/**
+   Returns the threshold of a cumulative quadrant probability, which is
+   2^unif_bits if p >= 1.0, so that it is greater than any compared value.
+*/
+static size_t rmat_threshold(const gen_t *gen, double p){
+  if (p >= 1.0) return (size_t)1 << gen->unif_bits;
+  if (p <= 0.0) return 0;
+  return (size_t)(p / gen->unif_scale);
+}
+
+/**
+   Generates the points of the vertices in the block of vertices at index i
+   of a random geometric graph.
+*/
+static void points_block(const gen_t *gen, size_t i){
+  size_t u;
+  size_t s = rng_init(gen->seed, i);
+  size_t u_end = (gen->num_vts - i * C_VTS_BLOCK > C_VTS_BLOCK) ?
+    (i + 1) * C_VTS_BLOCK : gen->num_vts;
+  for (u = i * C_VTS_BLOCK; u < u_end; u++){
+    gen->xy[2 * u] = rng_unif(gen, &s);
+    gen->xy[2 * u + 1] = rng_unif(gen, &s);
+  }
+}
+
+/**
+   Generates the edges (u, v) of a random geometric graph, where u < v and
+   u is in a cell of the row of cells at index i, and returns the number of
+   edges. The side of a cell is at least the radius, so that the adjacent
+   vertices of u are in the cell of u and its neighboring cells.
+*/
+static size_t geom_block(const gen_t *gen, size_t i, size_t pos){
+  size_t cx, nx, ny, nx_end, ny_end;
+  size_t j, k, u, v, count = 0;
+  const size_t *cell = NULL, *ncell = NULL;
+  double dx, dy;
+  ny_end = (i + 1 < gen->side) ? i + 2 : gen->side;
+  for (cx = 0; cx < gen->side; cx++){
+    cell = gen->cell_starts + i * gen->side + cx;
+    nx_end = (cx + 1 < gen->side) ? cx + 2 : gen->side;
+    for (j = cell[0]; j < cell[1]; j++){
+      u = gen->cell_vts[j];
+      for (ny = (i > 0) ? i - 1 : 0; ny < ny_end; ny++){
+	for (nx = (cx > 0) ? cx - 1 : 0; nx < nx_end; nx++){
+	  ncell = gen->cell_starts + ny * gen->side + nx;
+	  for (k = ncell[0]; k < ncell[1]; k++){
+	    v = gen->cell_vts[k];
+	    if (v <= u) continue;
+	    dx = gen->xy[2 * u] - gen->xy[2 * v];
+	    dy = gen->xy[2 * u + 1] - gen->xy[2 * v + 1];
+	    if (dx * dx + dy * dy > gen->r2) continue;
+	    if (gen->pass == PASS_WRITE) write_edge(gen, pos + count, u, v);
+	    count++;
+	  }
+	}
+      }
+    }
+  }
+  return count;
+}
+
+/**
+   Distributes the vertices of a random geometric graph into cells with a
+   counting sort in a single thread, so that the vertices in each cell are
+   in increasing order.
+*/
+static void geom_cells(gen_t *gen){
+  size_t i, c;
+  size_t num_cells = mul_sz_perror(gen->side, gen->side);
+  size_t *starts = NULL;
+  gen->cell_starts = calloc_perror(add_sz_perror(num_cells, 1),
+				   sizeof(size_t));
+  gen->cell_vts = malloc_perror(gen->num_vts, sizeof(size_t));
+  starts = gen->cell_starts;
+  for (i = 0; i < gen->num_vts; i++){
+    c = geom_cell(gen, gen->xy[2 * i + 1]) * gen->side +
+      geom_cell(gen, gen->xy[2 * i]);
+    starts[c + 1]++;
+  }
+  for (c = 0; c < num_cells; c++){
+    starts[c + 1] += starts[c];
+  }
+  for (i = 0; i < gen->num_vts; i++){
+    c = geom_cell(gen, gen->xy[2 * i + 1]) * gen->side +
+      geom_cell(gen, gen->xy[2 * i]);
+    gen->cell_vts[starts[c]++] = i;
+  }
+  for (c = num_cells; c > 0; c--){
+    starts[c] = starts[c - 1];
+  }
+  starts[0] = 0;
+}
+
+/**
+   Returns the index of the cell of a coordinate in [0, 1) along a side.
+*/
+static size_t geom_cell(const gen_t *gen, double x){
+  size_t c = (size_t)(x * gen->side);
+  return (c < gen->side) ? c : gen->side - 1;
+}
+
+/**
+   Writes the edge (u, v) at the position pos of the edge arrays of the
+   graph of a generator.
+*/
+static void write_edge(const gen_t *gen, size_t pos, size_t u, size_t v){
+  const graph_t *g = gen->g;
+  g->write_vt(ptr(g->u, pos, g->vt_size), u);
+  g->write_vt(ptr(g->v, pos, g->vt_size), v);
+}
+
+/**
+   Returns the initial state of the random number sequence of the block at
+   index i, and returns the next value of a sequence with state s.
+*/
+
+static size_t rng_init(size_t seed, size_t i){
+  return mix(mix(seed) + i * C_MIX_INCR);
+}
+
+static size_t rng_next(size_t *s){
+  *s += C_MIX_INCR;
+  return mix(*s);
+}
+
+/**
+   Returns a uniform double in (0, 1) from the next value of a sequence
+   with state s.
+*/
+static double rng_unif(const gen_t *gen, size_t *s){
+  return ((double)(rng_next(s) >> gen->unif_shift) + 0.5) * gen->unif_scale;
+}
+
+/**
+   Mixes the bits of a size_t value with the finalizer of splitmix.
+*/
+static size_t mix(size_t a){
+  a = (a ^ (a >> C_MIX_SHIFT_A)) * C_MIX_MUL_A;
+  a = (a ^ (a >> C_MIX_SHIFT_B)) * C_MIX_MUL_B;
+  return a ^ (a >> C_MIX_SHIFT_C);
+}
+
+/**
+   Returns the number of blocks of a given size in n items.
+*/
+static size_t num_blocks(size_t n, size_t block){
+  return n / block + (n % block > 0);
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
@@ -0,0 +1,144 @@
+/**
+   graph-gen-pthread.h
+
+   Declarations of accessible functions for generating random graphs with
+   generic integer vertices in parallel, with the edges written directly
+   to the edge arrays of a graph_t struct.
+
+   Three random graph models are provided: i) G(n, p), where each of the
+   possible edges is added with probability p, and the vertex pairs
+   between two consecutive edges are skipped by drawing a number from a
+   geometric distribution, so that the runtime is linear in the number of
+   vertices and edges and not in the number of vertex pairs, ii) R-MAT
+   (recursive matrix, a Kronecker graph with a 2 x 2 initiator), where the
+   source and target of each edge are selected by recursively choosing a
+   quadrant of the adjacency matrix, and iii) random geometric graphs,
+   where each vertex is a point in the unit square and two vertices are
+   adjacent if their Euclidean distance is at most a radius, with
+   neighbors found in a grid of cells.
+
+   The work of a generator is partitioned into blocks of vertices, edges,
+   or cells with a count that does not depend on the number of threads,
+   and each block has its own random number sequence derived from a seed
+   and the index of the block. A generator runs a counting pass over the
+   blocks, followed by a prefix sum over the counts of edges in the blocks
+   and a pass that writes the edges of each block to their positions. A
+   generated graph is thereby a function of the seed and the parameters of
+   a generator, and does not depend on the number of threads.
+
+   The random number generator is not suitable for cryptographic use.
+   Given parameter values within the specified ranges, the implementation
+   provides an error message and an exit is executed if an integer overflow
+   is attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef GRAPH_GEN_PTHREAD_H
+#define GRAPH_GEN_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Generates a directed unweighted G(n, p) graph with num_vts vertices,
+   where each of num_vts(num_vts - 1) possible edges is added with
+   probability p. The edges are ordered by source vertex and then by
+   target vertex.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   num_vts     : number of vertices
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   p           : >= 0.0 and <= 1.0 probability of an edge
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_gnp_dir_pthread(graph_t *g,
+				size_t num_vts,
+				size_t vt_size,
+				size_t (*read_vt)(const void *),
+				void (*write_vt)(void *, size_t),
+				double p,
+				size_t seed,
+				size_t num_threads);
+
+/**
+   Generates an undirected unweighted G(n, p) graph with num_vts vertices,
+   where each of num_vts(num_vts - 1)/2 possible edges is added with
+   probability p. Each edge (u, v) satisfies u < v, and the edges are
+   ordered by u and then by v. Please see the parameter specification in
+   graph_rand_gnp_dir_pthread.
+*/
+void graph_rand_gnp_undir_pthread(graph_t *g,
+				  size_t num_vts,
+				  size_t vt_size,
+				  size_t (*read_vt)(const void *),
+				  void (*write_vt)(void *, size_t),
+				  double p,
+				  size_t seed,
+				  size_t num_threads);
+
+/**
+   Generates a directed unweighted R-MAT graph with 2^log_num_vts vertices
+   and num_es edges. At each of log_num_vts levels, the quadrant of the
+   adjacency matrix is chosen with the probabilities a, b, c, and
+   1 - a - b - c for the top left, top right, bottom left, and bottom
+   right quadrants respectively. The graph may contain loops and multiple
+   edges.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   log_num_vts : < CHAR_BIT * sizeof(size_t)
+   num_es      : number of edges
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   a, b, c     : >= 0.0 probabilities with a + b + c <= 1.0
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_rmat_pthread(graph_t *g,
+			     size_t log_num_vts,
+			     size_t num_es,
+			     size_t vt_size,
+			     size_t (*read_vt)(const void *),
+			     void (*write_vt)(void *, size_t),
+			     double a,
+			     double b,
+			     double c,
+			     size_t seed,
+			     size_t num_threads);
+
+/**
+   Generates an undirected unweighted random geometric graph with num_vts
+   vertices that are points in the unit square, where two vertices u < v
+   are adjacent if their Euclidean distance is at most radius. Each edge
+   (u, v) satisfies u < v.
+   g           : pointer to a preallocated block of size sizeof(graph_t),
+                 not initialized
+   num_vts     : number of vertices
+   vt_size     : > 0 size of the integer type used to represent a vertex
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+   radius      : > 0.0
+   coords      : NULL, or pointer to a preallocated block of
+                 2 * num_vts doubles, where the x and y coordinates of the
+                 vertex u are written at indices 2 * u and 2 * u + 1
+   seed        : seed of the random number sequences
+   num_threads : > 0
+*/
+void graph_rand_geom_pthread(graph_t *g,
+			     size_t num_vts,
+			     size_t vt_size,
+			     size_t (*read_vt)(const void *),
+			     void (*write_vt)(void *, size_t),
+			     double radius,
+			     double *coords,
+			     size_t seed,
+			     size_t num_threads);
+
+#endif
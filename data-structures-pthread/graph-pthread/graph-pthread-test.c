@@ -0,0 +1,325 @@
+/**
+   graph-pthread-test.c
+
+   Tests of the parallel construction of adjacency lists of graphs with
+   generic integer vertices and generic weights.
+
+   The following command line arguments can be used to customize tests:
+   graph-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, bit width of size_t / 2] : m for 2**m edges per vertex
+      [1, 2**8] : number of threads in parallel builds
+      [0, 1] : small graph test on/off
+      [0, 1] : random graph test on/off
+
+   usage examples:
+   ./graph-pthread-test
+   ./graph-pthread-test 10 20
+   ./graph-pthread-test 20 20 4 8 0 1
+
+   graph-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "graph-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "graph-pthread-test \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph \n"
+  "[0, bit width of size_t / 2] : m for 2**m edges per vertex \n"
+  "[1, 2**8] : number of threads in parallel builds \n"
+  "[0, 1] : small graph test on/off \n"
+  "[0, 1] : random graph test on/off \n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {0, 14, 3, 4, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_THREADS_MAX = 256;
+
+/* small graph tests */
+const size_t C_NUM_VTS = 5;
+const size_t C_NUM_ES = 5;
+const size_t C_U[5] = {0, 0, 0, 1, 4};
+const size_t C_V[5] = {1, 2, 3, 3, 4};
+const double C_WTS[5] = {4.0, 3.0, 2.0, 1.0, 0.0};
+
+void rand_graph_init(graph_t *g, size_t num_vts, size_t num_es);
+int same_lst(const adj_lst_t *a, const adj_lst_t *b);
+int same_csr(const adj_lst_t *a, const adj_csr_t *c);
+void print_test_result(int res);
+
+/**
+   Runs a test of parallel builds on a small graph with double weights and
+   a self-loop, across numbers of threads that are smaller, equal, and
+   greater than the number of edges.
+*/
+void run_small_graph_test(){
+  size_t i, num_threads;
+  int res = 1;
+  graph_t g;
+  adj_lst_t a, a_pthread;
+  adj_csr_t c;
+  graph_base_init(&g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
+  g.num_es = C_NUM_ES;
+  g.u = malloc_perror(g.num_es, g.vt_size);
+  g.v = malloc_perror(g.num_es, g.vt_size);
+  g.wts = malloc_perror(g.num_es, g.wt_size);
+  for (i = 0; i < g.num_es; i++){
+    *((size_t *)g.u + i) = C_U[i];
+    *((size_t *)g.v + i) = C_V[i];
+    *((double *)g.wts + i) = C_WTS[i];
+  }
+  printf("Run parallel build tests on a small graph with %lu edges\n",
+	 TOLU(g.num_es));
+  for (num_threads = 1; num_threads <= C_NUM_ES + 2; num_threads++){
+    adj_lst_base_init(&a, &g);
+    adj_lst_base_init(&a_pthread, &g);
+    adj_csr_base_init(&c, &g);
+    adj_lst_dir_build(&a, &g);
+    adj_lst_dir_build_pthread(&a_pthread, &g, num_threads);
+    adj_csr_dir_build_pthread(&c, &g, num_threads);
+    res *= same_lst(&a, &a_pthread);
+    res *= same_csr(&a, &c);
+    /* appending to non-empty lists */
+    adj_lst_undir_build(&a, &g);
+    adj_lst_undir_build_pthread(&a_pthread, &g, num_threads);
+    res *= same_lst(&a, &a_pthread);
+    adj_lst_free(&a);
+    adj_lst_free(&a_pthread);
+    adj_csr_free(&c);
+    adj_lst_base_init(&a, &g);
+    adj_csr_base_init(&c, &g);
+    adj_lst_undir_build(&a, &g);
+    adj_csr_undir_build_pthread(&c, &g, num_threads);
+    res *= same_csr(&a, &c);
+    adj_lst_free(&a);
+    adj_csr_free(&c);
+  }
+  graph_free(&g);
+  graph_base_init(&g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
+  adj_lst_base_init(&a, &g);
+  adj_csr_base_init(&c, &g);
+  adj_lst_undir_build_pthread(&a, &g, C_NUM_ES);
+  adj_csr_undir_build_pthread(&c, &g, C_NUM_ES);
+  res *= (a.num_es == 0 && c.num_es == 0 && c.vt_wts == NULL);
+  res *= same_csr(&a, &c);
+  adj_lst_free(&a);
+  adj_csr_free(&c);
+  graph_free(&g);
+  printf("\tcorrectness:                          ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of serial and parallel builds on random graphs with size_t
+   weights.
+*/
+void run_rand_graph_test(size_t log_start,
+			 size_t log_end,
+			 size_t log_deg,
+			 size_t num_threads){
+  size_t i;
+  int res = 1;
+  graph_t g;
+  adj_lst_t a, a_pthread;
+  adj_csr_t c, c_pthread;
+  clock_t t_lst, t_lst_pthread, t_csr, t_csr_pthread;
+  printf("Run serial and parallel build tests on random graphs with "
+	 "%lu threads\n", TOLU(num_threads));
+  for (i = log_start; i <= log_end; i++){
+    rand_graph_init(&g,
+		    pow_two_perror(i),
+		    mul_sz_perror(pow_two_perror(i), pow_two_perror(log_deg)));
+    printf("\tvertices: %lu, edges: %lu\n", TOLU(g.num_vts), TOLU(g.num_es));
+    adj_lst_base_init(&a, &g);
+    adj_lst_base_init(&a_pthread, &g);
+    adj_csr_base_init(&c, &g);
+    adj_csr_base_init(&c_pthread, &g);
+    t_lst = clock();
+    adj_lst_dir_build(&a, &g);
+    t_lst = clock() - t_lst;
+    t_lst_pthread = clock();
+    adj_lst_dir_build_pthread(&a_pthread, &g, num_threads);
+    t_lst_pthread = clock() - t_lst_pthread;
+    t_csr = clock();
+    adj_csr_dir_build(&c, &g);
+    t_csr = clock() - t_csr;
+    t_csr_pthread = clock();
+    adj_csr_dir_build_pthread(&c_pthread, &g, num_threads);
+    t_csr_pthread = clock() - t_csr_pthread;
+    res *= same_lst(&a, &a_pthread);
+    res *= same_csr(&a, &c);
+    res *= same_csr(&a, &c_pthread);
+    printf("\t\tdir adj_lst build time:          %.6f seconds\n"
+	   "\t\tdir adj_lst pthread build time:  %.6f seconds *\n"
+	   "\t\tdir adj_csr build time:          %.6f seconds\n"
+	   "\t\tdir adj_csr pthread build time:  %.6f seconds *\n",
+	   (double)t_lst / CLOCKS_PER_SEC,
+	   (double)t_lst_pthread / CLOCKS_PER_SEC,
+	   (double)t_csr / CLOCKS_PER_SEC,
+	   (double)t_csr_pthread / CLOCKS_PER_SEC);
+    adj_lst_free(&a);
+    adj_lst_free(&a_pthread);
+    adj_csr_free(&c);
+    adj_csr_free(&c_pthread);
+    adj_lst_base_init(&a, &g);
+    adj_lst_base_init(&a_pthread, &g);
+    adj_csr_base_init(&c_pthread, &g);
+    adj_lst_undir_build(&a, &g);
+    adj_lst_undir_build_pthread(&a_pthread, &g, num_threads);
+    adj_csr_undir_build_pthread(&c_pthread, &g, num_threads);
+    res *= same_lst(&a, &a_pthread);
+    res *= same_csr(&a, &c_pthread);
+    adj_lst_free(&a);
+    adj_lst_free(&a_pthread);
+    adj_csr_free(&c_pthread);
+    graph_free(&g);
+    printf("\t\tcorrectness:                     ");
+    print_test_result(res);
+    res = 1;
+  }
+  printf("\t* clock() sums the processor time of all threads\n");
+}
+
+/**
+   Initializes a graph with random edges and random size_t weights.
+*/
+void rand_graph_init(graph_t *g, size_t num_vts, size_t num_es){
+  size_t i;
+  graph_base_init(g,
+		  num_vts,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
+  g->num_es = num_es;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  for (i = 0; i < g->num_es; i++){
+    *((size_t *)g->u + i) = RANDOM() % num_vts;
+    *((size_t *)g->v + i) = RANDOM() % num_vts;
+    *((size_t *)g->wts + i) = RANDOM();
+  }
+}
+
+/**
+   Compare the lists of adjacency lists.
+*/
+
+int same_lst(const adj_lst_t *a, const adj_lst_t *b){
+  int res = 1;
+  size_t i, j;
+  size_t num_a, num_b;
+  const char *pa = NULL, *pb = NULL;
+  res *= (a->num_vts == b->num_vts && a->num_es == b->num_es);
+  for (i = 0; i < a->num_vts && res; i++){
+    pa = adj_lst_vt_wts(a, i, &num_a);
+    pb = adj_lst_vt_wts(b, i, &num_b);
+    res *= (num_a == num_b);
+    for (j = 0; j < num_a && res; j++){
+      res *= (a->read_vt(pa) == b->read_vt(pb));
+      res *= (memcmp(pa + a->wt_offset, pb + b->wt_offset, a->wt_size) == 0);
+      pa += a->pair_size;
+      pb += b->pair_size;
+    }
+  }
+  return res;
+}
+
+int same_csr(const adj_lst_t *a, const adj_csr_t *c){
+  int res = 1;
+  size_t i, j;
+  size_t num_a, num_c;
+  const char *pa = NULL, *pc = NULL;
+  res *= (a->num_vts == c->num_vts && a->num_es == c->num_es);
+  for (i = 0; i < a->num_vts && res; i++){
+    pa = adj_lst_vt_wts(a, i, &num_a);
+    pc = adj_csr_vt_wts(c, i, &num_c);
+    res *= (num_a == num_c);
+    for (j = 0; j < num_a && res; j++){
+      res *= (a->read_vt(pa) == c->read_vt(pc));
+      res *= (memcmp(pa + a->wt_offset, pc + c->wt_offset, a->wt_size) == 0);
+      pa += a->pair_size;
+      pc += c->pair_size;
+    }
+  }
+  return res;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_FULL_BIT / 2 ||
+      args[3] < 1 ||
+      args[3] > C_THREADS_MAX ||
+      args[4] > 1 ||
+      args[5] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[4]) run_small_graph_test();
+  if (args[5]) run_rand_graph_test(args[0], args[1], args[2], args[3]);
+  free(args);
+  args = NULL;
+  return 0;
+}
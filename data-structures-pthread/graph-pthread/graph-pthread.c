@@ -0,0 +1,374 @@
+/**
+   graph-pthread.c
+
+   Functions for building the adjacency list of a graph with generic
+   integer vertices and generic weights in parallel.
+
+   A build consists of three phases, each run by num_threads threads: i) a
+   histogram of the number of list entries of each vertex within each
+   contiguous range of edges of a graph, ii) a prefix sum across the
+   histograms of each vertex providing the position of each range in a
+   list, and iii) a scatter of the vertex weight pairs of each range of
+   edges. A thread keeps a histogram with a count that is equal to the
+   number of vertices in a graph. The order of vertex weight pairs in each
+   list is equal to the order obtained with the serial build of graph.h.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "graph-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef enum{FALSE, TRUE} boolean_t;
+
+typedef struct{
+  boolean_t undir;
+  size_t num_vts;
+  size_t num_threads;
+  size_t vt_size;
+  size_t wt_size;
+  size_t pair_size;
+  size_t wt_offset;
+  size_t *counts;  /* num_threads histograms, each with num_vts entries */
+  size_t *degs;    /* number of list entries of each vertex after a build */
+  adj_lst_t *a;    /* NULL if a CSR adjacency list is built */
+  adj_csr_t *c;    /* NULL if an adjacency list is built */
+  const graph_t *g;
+  size_t (*read_vt)(const void *);
+} build_t;
+
+typedef struct{
+  size_t id;
+  size_t es_start; /* range of edges of a thread */
+  size_t es_end;
+  size_t vts_start; /* range of vertices of a thread */
+  size_t vts_end;
+  build_t *b;
+} build_arg_t;
+
+static void build(build_t *b, size_t num_threads);
+static void run_threads(build_arg_t *args,
+			size_t num_threads,
+			void *(*start_routine)(void *));
+static void *count_thread(void *arg);
+static void prefix_range(void *arg);
+static void *prefix_lst_thread(void *arg);
+static void *prefix_csr_thread(void *arg);
+static void *scatter_thread(void *arg);
+static char *list_ptr(const build_t *b, size_t u);
+static void range(size_t *start, size_t *end, size_t n, size_t i, size_t k);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Builds the adjacency list of a directed graph with num_threads threads.
+   The vertex weight pairs are appended to the lists of an adjacency list
+   initialized with adj_lst_base_init, as in adj_lst_dir_build.
+   a           : pointer to an adjacency list initialized with at least
+                 adj_lst_base_init according to the graph pointed to by g
+   g           : pointer to a graph
+   num_threads : > 0
+*/
+void adj_lst_dir_build_pthread(adj_lst_t *a,
+			       const graph_t *g,
+			       size_t num_threads){
+  build_t b;
+  b.undir = FALSE;
+  b.a = a;
+  b.c = NULL;
+  b.g = g;
+  build(&b, num_threads);
+  a->num_es = add_sz_perror(a->num_es, g->num_es);
+}
+
+/**
+   Builds the adjacency list of an undirected graph with num_threads
+   threads. Please see the parameter specification in
+   adj_lst_dir_build_pthread.
+*/
+void adj_lst_undir_build_pthread(adj_lst_t *a,
+				 const graph_t *g,
+				 size_t num_threads){
+  build_t b;
+  b.undir = TRUE;
+  b.a = a;
+  b.c = NULL;
+  b.g = g;
+  build(&b, num_threads);
+  a->num_es = add_sz_perror(a->num_es, mul_sz_perror(2, g->num_es));
+}
+
+/**
+   Builds the CSR adjacency list of a directed graph with num_threads
+   threads, as in adj_csr_dir_build.
+   c           : pointer to a CSR adjacency list initialized with at least
+                 adj_csr_base_init according to the graph pointed to by g,
+                 with no lists built
+   g           : pointer to a graph
+   num_threads : > 0
+*/
+void adj_csr_dir_build_pthread(adj_csr_t *c,
+			       const graph_t *g,
+			       size_t num_threads){
+  build_t b;
+  b.undir = FALSE;
+  b.a = NULL;
+  b.c = c;
+  b.g = g;
+  build(&b, num_threads);
+}
+
+/**
+   Builds the CSR adjacency list of an undirected graph with num_threads
+   threads. Please see the parameter specification in
+   adj_csr_dir_build_pthread.
+*/
+void adj_csr_undir_build_pthread(adj_csr_t *c,
+				 const graph_t *g,
+				 size_t num_threads){
+  build_t b;
+  b.undir = TRUE;
+  b.a = NULL;
+  b.c = c;
+  b.g = g;
+  build(&b, num_threads);
+}
+
+/**
+   Runs the histogram, prefix sum, and scatter phases of a build. Between
+   the prefix sum and scatter phases of a CSR build, the beginnings of the
+   lists are computed from the vertex degrees, followed by the allocation
+   of the single block of vertex weight pairs.
+*/
+static void build(build_t *b, size_t num_threads){
+  size_t i;
+  size_t num_es;
+  build_arg_t *args = NULL;
+  if (b->a != NULL){
+    b->num_vts = b->a->num_vts;
+    b->vt_size = b->a->vt_size;
+    b->wt_size = b->a->wt_size;
+    b->pair_size = b->a->pair_size;
+    b->wt_offset = b->a->wt_offset;
+    b->read_vt = b->a->read_vt;
+  }else{
+    b->num_vts = b->c->num_vts;
+    b->vt_size = b->c->vt_size;
+    b->wt_size = b->c->wt_size;
+    b->pair_size = b->c->pair_size;
+    b->wt_offset = b->c->wt_offset;
+    b->read_vt = b->c->read_vt;
+  }
+  if (b->num_vts == 0) return;
+  b->num_threads = num_threads;
+  b->counts = calloc_perror(mul_sz_perror(num_threads, b->num_vts),
+			    sizeof(size_t));
+  b->degs = malloc_perror(b->num_vts, sizeof(size_t));
+  args = malloc_perror(num_threads, sizeof(build_arg_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].b = b;
+    range(&args[i].es_start, &args[i].es_end, b->g->num_es, i, num_threads);
+    range(&args[i].vts_start, &args[i].vts_end, b->num_vts, i, num_threads);
+  }
+  run_threads(args, num_threads, count_thread);
+  if (b->a != NULL){
+    run_threads(args, num_threads, prefix_lst_thread);
+  }else{
+    run_threads(args, num_threads, prefix_csr_thread);
+    b->c->offsets[0] = 0;
+    for (i = 0; i < b->num_vts; i++){
+      b->c->offsets[i + 1] = add_sz_perror(b->c->offsets[i], b->degs[i]);
+    }
+    num_es = b->c->offsets[b->num_vts];
+    b->c->num_es = num_es;
+    if (num_es > 0) b->c->vt_wts = calloc_large_perror(num_es, b->pair_size);
+  }
+  run_threads(args, num_threads, scatter_thread);
+  free(b->counts);
+  free(b->degs);
+  free(args);
+  b->counts = NULL;
+  b->degs = NULL;
+  args = NULL;
+}
+
+/**
+   Runs num_threads threads, each with an argument in the array pointed to
+   by args, and joins the threads.
+*/
+static void run_threads(build_arg_t *args,
+			size_t num_threads,
+			void *(*start_routine)(void *)){
+  size_t i;
+  pthread_t *tids = NULL;
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&tids[i], start_routine, &args[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  free(tids);
+  tids = NULL;
+}
+
+/**
+   Counts the number of list entries of each vertex within the range of
+   edges of a thread.
+*/
+static void *count_thread(void *arg){
+  size_t i;
+  build_arg_t *ba = arg;
+  const build_t *b = ba->b;
+  size_t *counts = b->counts + ba->id * b->num_vts;
+  const char *u = NULL, *v = NULL;
+  if (ba->es_start == ba->es_end) return NULL;
+  u = ptr(b->g->u, ba->es_start, b->vt_size);
+  v = ptr(b->g->v, ba->es_start, b->vt_size);
+  for (i = ba->es_start; i < ba->es_end; i++){
+    counts[b->read_vt(u)]++;
+    if (b->undir) counts[b->read_vt(v)]++;
+    u += b->vt_size;
+    v += b->vt_size;
+  }
+  return NULL;
+}
+
+/**
+   For each vertex in the range of vertices of a thread, replaces the count
+   of each histogram with the position of the corresponding range of edges
+   in the list of the vertex, starting from the position in degs, and
+   copies the number of list entries after a build to degs.
+*/
+static void prefix_range(void *arg){
+  size_t i, j;
+  size_t pos, count;
+  build_arg_t *ba = arg;
+  const build_t *b = ba->b;
+  size_t *counts = NULL;
+  for (i = ba->vts_start; i < ba->vts_end; i++){
+    pos = b->degs[i];
+    counts = b->counts + i;
+    for (j = 0; j < b->num_threads; j++){
+      count = *counts;
+      *counts = pos;
+      pos = add_sz_perror(pos, count);
+      counts += b->num_vts;
+    }
+    b->degs[i] = pos;
+  }
+}
+
+/**
+   Runs the prefix sum phase for an adjacency list, with the lists of the
+   range of vertices of a thread grown to their counts after a build.
+*/
+static void *prefix_lst_thread(void *arg){
+  size_t i;
+  build_arg_t *ba = arg;
+  const build_t *b = ba->b;
+  stack_t *s = NULL;
+  for (i = ba->vts_start; i < ba->vts_end; i++){
+    b->degs[i] = b->a->vt_wts[i]->num_elts;
+  }
+  prefix_range(arg);
+  for (i = ba->vts_start; i < ba->vts_end; i++){
+    s = b->a->vt_wts[i];
+    if (s->count < b->degs[i]){
+      s->elts = realloc_perror(s->elts, b->degs[i], s->elt_size);
+      s->count = b->degs[i];
+    }
+    s->num_elts = b->degs[i];
+  }
+  return NULL;
+}
+
+/**
+   Runs the prefix sum phase for a CSR adjacency list with no lists built.
+*/
+static void *prefix_csr_thread(void *arg){
+  size_t i;
+  build_arg_t *ba = arg;
+  const build_t *b = ba->b;
+  for (i = ba->vts_start; i < ba->vts_end; i++){
+    b->degs[i] = 0;
+  }
+  prefix_range(arg);
+  return NULL;
+}
+
+/**
+   Copies the vertex weight pairs of the range of edges of a thread to
+   their positions in the lists.
+*/
+static void *scatter_thread(void *arg){
+  size_t i;
+  build_arg_t *ba = arg;
+  const build_t *b = ba->b;
+  size_t *counts = b->counts + ba->id * b->num_vts;
+  size_t uv, vv;
+  const char *u = NULL, *v = NULL, *wt = NULL;
+  char *p = NULL;
+  boolean_t wtd = (b->wt_size > 0 && b->g->wts != NULL);
+  if (ba->es_start == ba->es_end) return NULL;
+  u = ptr(b->g->u, ba->es_start, b->vt_size);
+  v = ptr(b->g->v, ba->es_start, b->vt_size);
+  if (wtd) wt = ptr(b->g->wts, ba->es_start, b->wt_size);
+  for (i = ba->es_start; i < ba->es_end; i++){
+    uv = b->read_vt(u);
+    p = list_ptr(b, uv) + counts[uv]++ * b->pair_size;
+    memcpy(p, v, b->vt_size);
+    if (wtd) memcpy(p + b->wt_offset, wt, b->wt_size);
+    if (b->undir){
+      vv = b->read_vt(v);
+      p = list_ptr(b, vv) + counts[vv]++ * b->pair_size;
+      memcpy(p, u, b->vt_size);
+      if (wtd) memcpy(p + b->wt_offset, wt, b->wt_size);
+    }
+    u += b->vt_size;
+    v += b->vt_size;
+    if (wtd) wt += b->wt_size;
+  }
+  return NULL;
+}
+
+/**
+   Returns a pointer to the beginning of the list of a vertex u.
+*/
+static char *list_ptr(const build_t *b, size_t u){
+  if (b->a != NULL) return b->a->vt_wts[u]->elts;
+  return ptr(b->c->vt_wts, b->c->offsets[u], b->pair_size);
+}
+
+/**
+   Computes the ith of k contiguous ranges partitioning [0, n), where the
+   sizes of the ranges differ by at most one.
+*/
+static void range(size_t *start, size_t *end, size_t n, size_t i, size_t k){
+  size_t q = n / k;
+  size_t r = n % k;
+  *start = i * q + (i < r ? i : r);
+  *end = *start + q + (i < r);
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
@@ -0,0 +1,77 @@
+/**
+   graph-pthread.h
+
+   Declarations of accessible functions for building the adjacency list of
+   a graph with generic integer vertices and generic weights in parallel.
+
+   A build consists of three phases, each run by num_threads threads: i) a
+   histogram of the number of list entries of each vertex within each
+   contiguous range of edges of a graph, ii) a prefix sum across the
+   histograms of each vertex providing the position of each range in a
+   list, and iii) a scatter of the vertex weight pairs of each range of
+   edges. A thread keeps a histogram with a count that is equal to the
+   number of vertices in a graph. The order of vertex weight pairs in each
+   list is equal to the order obtained with the serial build of graph.h.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef GRAPH_PTHREAD_H  
+#define GRAPH_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Builds the adjacency list of a directed graph with num_threads threads.
+   The vertex weight pairs are appended to the lists of an adjacency list
+   initialized with adj_lst_base_init, as in adj_lst_dir_build.
+   a           : pointer to an adjacency list initialized with at least
+                 adj_lst_base_init according to the graph pointed to by g
+   g           : pointer to a graph
+   num_threads : > 0
+*/
+void adj_lst_dir_build_pthread(adj_lst_t *a,
+			       const graph_t *g,
+			       size_t num_threads);
+
+/**
+   Builds the adjacency list of an undirected graph with num_threads
+   threads. Please see the parameter specification in
+   adj_lst_dir_build_pthread.
+*/
+void adj_lst_undir_build_pthread(adj_lst_t *a,
+				 const graph_t *g,
+				 size_t num_threads);
+
+/**
+   Builds the CSR adjacency list of a directed graph with num_threads
+   threads, as in adj_csr_dir_build.
+   c           : pointer to a CSR adjacency list initialized with at least
+                 adj_csr_base_init according to the graph pointed to by g,
+                 with no lists built
+   g           : pointer to a graph
+   num_threads : > 0
+*/
+void adj_csr_dir_build_pthread(adj_csr_t *c,
+			       const graph_t *g,
+			       size_t num_threads);
+
+/**
+   Builds the CSR adjacency list of an undirected graph with num_threads
+   threads. Please see the parameter specification in
+   adj_csr_dir_build_pthread.
+*/
+void adj_csr_undir_build_pthread(adj_csr_t *c,
+				 const graph_t *g,
+				 size_t num_threads);
+
+#endif
@@ -0,0 +1,365 @@
+/**
+   heap-pthread-test.c
+
+   Tests of a generic dynamically allocated (min) priority queue that is
+   concurrently accessible and modifiable by threads pushing and popping at
+   the same time.
+
+   The following command line arguments can be used to customize tests:
+   heap-pthread-test
+      [0, # bits in size_t - 1) : i s.t. # pushes = 2**i
+      > 0 : number of threads
+      > 0 : c s.t. # heaps = c * # threads
+      [0, 1] : on/off single thread test
+      [0, 1] : on/off concurrent push pop test
+
+   usage examples:
+   ./heap-pthread-test
+   ./heap-pthread-test 20
+   ./heap-pthread-test 20 8 2
+
+   heap-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "heap-pthread.h"
+#include "heap.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "heap-pthread-test\n"
+  "[0, # bits in size_t - 1) : i s.t. # pushes = 2**i\n"
+  "> 0 : number of threads\n"
+  "> 0 : c s.t. # heaps = c * # threads\n"
+  "[0, 1] : on/off single thread test\n"
+  "[0, 1] : on/off concurrent push pop test\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {18, 4, 4, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* single thread test */
+const size_t C_NUM_QUEUES[3] = {1, 2, 7};
+const size_t C_NUM_QUEUES_COUNT = 3;
+
+int cmp_sz(const void *a, const void *b);
+void print_test_result(int res);
+double timer();
+
+/**
+   Runs a test of pushes and pops by a single thread with size_t priorities
+   and size_t elements. With one heap the popped priorities are
+   non-decreasing. With more heaps each element is popped exactly once.
+*/
+void run_single_thread_test(size_t log_num_ins){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins = (size_t)1 << log_num_ins;
+  size_t rand_state = 0;
+  size_t pty, elt, prev_pty;
+  size_t *ptys = NULL;
+  unsigned char *popped = NULL;
+  heap_pthread_t h;
+  ptys = malloc_perror(num_ins, sizeof(size_t));
+  popped = calloc_perror(num_ins, 1);
+  for (i = 0; i < num_ins; i++){
+    ptys[i] = RANDOM();
+  }
+  printf("Run a single thread test with %lu pushes\n", TOLU(num_ins));
+  for (i = 0; i < C_NUM_QUEUES_COUNT; i++){
+    heap_pthread_init(&h,
+		      sizeof(size_t),
+		      sizeof(size_t),
+		      0,
+		      C_NUM_QUEUES[i],
+		      cmp_sz,
+		      NULL);
+    heap_pthread_align(&h, sizeof(size_t), sizeof(size_t));
+    for (j = 0; j < num_ins; j++){
+      heap_pthread_push(&h, &ptys[j], &j, &rand_state);
+    }
+    prev_pty = 0;
+    memset(popped, 0, num_ins);
+    for (j = 0; j < num_ins; j++){
+      res *= heap_pthread_pop(&h, &pty, &elt, &rand_state);
+      res *= (elt < num_ins && !popped[elt] && ptys[elt] == pty);
+      if (C_NUM_QUEUES[i] == 1) res *= (prev_pty <= pty);
+      if (res) popped[elt] = 1;
+      prev_pty = pty;
+    }
+    pty = elt = num_ins;
+    res *= (heap_pthread_pop(&h, &pty, &elt, &rand_state) == 0);
+    res *= (pty == num_ins && elt == num_ins);
+    heap_pthread_free(&h);
+    printf("\t# heaps: %lu, correctness:    ", TOLU(C_NUM_QUEUES[i]));
+    print_test_result(res);
+    res = 1;
+  }
+  free(ptys);
+  free(popped);
+  ptys = NULL;
+  popped = NULL;
+}
+
+/**
+   Runs a test of concurrent pushes and pops. Each thread pushes a disjoint
+   range of size_t elements with random size_t priorities and pops an
+   element after every second push, followed by pops until the queue is
+   found empty. Each element is required to be popped exactly once with
+   its priority. The time is compared with the time of the same operations
+   on a heap_t protected by a single mutex.
+*/
+
+typedef struct{
+  size_t start;
+  size_t count;
+  size_t num_popped;
+  size_t *popped; /* popped elements */
+  const size_t *ptys;
+  heap_pthread_t *h;
+  heap_t *gh; /* heap_t protected by gh_lock in the baseline */
+  pthread_mutex_t *gh_lock;
+  int res;
+} push_pop_arg_t;
+
+void *push_pop_thread(void *arg){
+  size_t i, pty, elt;
+  size_t rand_state;
+  push_pop_arg_t *ppa = arg;
+  rand_state = ppa->start;
+  for (i = ppa->start; i < ppa->start + ppa->count; i++){
+    heap_pthread_push(ppa->h, &ppa->ptys[i], &i, &rand_state);
+    if ((i & 1) && heap_pthread_pop(ppa->h, &pty, &elt, &rand_state)){
+      ppa->res *= (ppa->ptys[elt] == pty);
+      ppa->popped[ppa->num_popped++] = elt;
+    }
+  }
+  while (heap_pthread_pop(ppa->h, &pty, &elt, &rand_state)){
+    ppa->res *= (ppa->ptys[elt] == pty);
+    ppa->popped[ppa->num_popped++] = elt;
+  }
+  return NULL;
+}
+
+void *push_pop_global_thread(void *arg){
+  size_t i, pty, elt;
+  int is_popped;
+  push_pop_arg_t *ppa = arg;
+  for (i = ppa->start; i < ppa->start + ppa->count; i++){
+    mutex_lock_perror(ppa->gh_lock);
+    heap_push(ppa->gh, &ppa->ptys[i], &i);
+    is_popped = 0;
+    if ((i & 1) && ppa->gh->num_elts > 0){
+      heap_pop(ppa->gh, &pty, &elt);
+      is_popped = 1;
+    }
+    mutex_unlock_perror(ppa->gh_lock);
+    if (is_popped){
+      ppa->res *= (ppa->ptys[elt] == pty);
+      ppa->popped[ppa->num_popped++] = elt;
+    }
+  }
+  while (1){
+    mutex_lock_perror(ppa->gh_lock);
+    is_popped = (ppa->gh->num_elts > 0);
+    if (is_popped) heap_pop(ppa->gh, &pty, &elt);
+    mutex_unlock_perror(ppa->gh_lock);
+    if (!is_popped) break;
+    ppa->res *= (ppa->ptys[elt] == pty);
+    ppa->popped[ppa->num_popped++] = elt;
+  }
+  return NULL;
+}
+
+void push_pop(push_pop_arg_t *ppas,
+	      size_t num_threads,
+	      size_t num_ins,
+	      void *(*start_routine)(void *),
+	      int *res,
+	      double *t){
+  size_t i, j;
+  unsigned char *popped = NULL;
+  pthread_t *ids = NULL;
+  ids = malloc_perror(num_threads, sizeof(pthread_t));
+  popped = calloc_perror(num_ins, 1);
+  *t = timer();
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&ids[i], start_routine, &ppas[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  *t = timer() - *t;
+  for (i = 0; i < num_threads; i++){
+    *res *= ppas[i].res;
+    for (j = 0; j < ppas[i].num_popped; j++){
+      *res *= (!popped[ppas[i].popped[j]]);
+      popped[ppas[i].popped[j]] = 1;
+    }
+  }
+  for (i = 0; i < num_ins; i++){
+    *res *= popped[i];
+  }
+  free(ids);
+  free(popped);
+  ids = NULL;
+  popped = NULL;
+}
+
+void run_push_pop_test(size_t log_num_ins,
+		       size_t num_threads,
+		       size_t queues_per_thread){
+  int res = 1;
+  size_t i, count;
+  size_t num_ins = (size_t)1 << log_num_ins;
+  size_t *ptys = NULL;
+  double t_h, t_gh;
+  heap_pthread_t h;
+  heap_t gh;
+  pthread_mutex_t gh_lock;
+  push_pop_arg_t *ppas = NULL;
+  ptys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    ptys[i] = RANDOM();
+  }
+  ppas = malloc_perror(num_threads, sizeof(push_pop_arg_t));
+  count = num_ins / num_threads;
+  for (i = 0; i < num_threads; i++){
+    ppas[i].start = i * count;
+    ppas[i].count = (i == num_threads - 1) ? num_ins - i * count : count;
+    ppas[i].num_popped = 0;
+    ppas[i].popped = malloc_perror(num_ins, sizeof(size_t));
+    ppas[i].ptys = ptys;
+    ppas[i].h = &h;
+    ppas[i].gh = &gh;
+    ppas[i].gh_lock = &gh_lock;
+    ppas[i].res = 1;
+  }
+  printf("Run a concurrent push pop test with %lu pushes, %lu threads, "
+	 "%lu heaps\n",
+	 TOLU(num_ins),
+	 TOLU(num_threads),
+	 TOLU(num_threads * queues_per_thread));
+  heap_pthread_init(&h,
+		    sizeof(size_t),
+		    sizeof(size_t),
+		    0,
+		    mul_sz_perror(num_threads, queues_per_thread),
+		    cmp_sz,
+		    NULL);
+  push_pop(ppas, num_threads, num_ins, push_pop_thread, &res, &t_h);
+  heap_pthread_free(&h);
+  for (i = 0; i < num_threads; i++){
+    ppas[i].num_popped = 0;
+  }
+  heap_init(&gh,
+	    sizeof(size_t),
+	    sizeof(size_t),
+	    num_ins,
+	    0,
+	    0,
+	    NULL,
+	    cmp_sz,
+	    NULL,
+	    NULL,
+	    NULL);
+  mutex_init_perror(&gh_lock);
+  push_pop(ppas, num_threads, num_ins, push_pop_global_thread, &res, &t_gh);
+  heap_free(&gh);
+  printf("\t\tmulti-queue push pop time:        %.4f seconds\n"
+	 "\t\theap_t with a mutex push pop time: %.4f seconds\n",
+	 t_h, t_gh);
+  printf("\t\tcorrectness:                      ");
+  print_test_result(res);
+  for (i = 0; i < num_threads; i++){
+    free(ppas[i].popped);
+    ppas[i].popped = NULL;
+  }
+  free(ppas);
+  free(ptys);
+  ppas = NULL;
+  ptys = NULL;
+}
+
+/**
+   Compares size_t priorities.
+*/
+int cmp_sz(const void *a, const void *b){
+  if (*(const size_t *)a > *(const size_t *)b){
+    return 1;
+  }else if (*(const size_t *)a < *(const size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] < 1 ||
+      args[2] < 1 ||
+      args[3] > 1 ||
+      args[4] > 1){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]) run_single_thread_test(args[0]);
+  if (args[4]) run_push_pop_test(args[0], args[1], args[2]);
+  free(args);
+  args = NULL;
+  return 0;
+}
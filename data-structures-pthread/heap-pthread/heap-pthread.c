@@ -0,0 +1,412 @@
+/**
+   heap-pthread.c
+
+   Implementation of a generic dynamically allocated (min) priority queue
+   that is concurrently accessible and modifiable by threads pushing and
+   popping at the same time.
+
+   The implementation provides a relaxed priority queue for any elements
+   in memory associated with priority values of basic type (e.g. char,
+   int, long, double), with the priority and element conventions of
+   heap_t. The queue is a multi-queue of num_queues binary (min) heaps,
+   each protected by its own mutex. A push inserts a pair into a heap
+   selected at random, and a pop locks two heaps selected at random and
+   pops a pair with the lesser minimal priority of the two. A thread holds
+   at most two locks at a time and does not wait for threads operating on
+   other heaps, so that with num_queues set to a small multiple of the
+   number of threads, threads rarely contend for the same lock.
+
+   The two locks of a pop are acquired in the order of the positions of
+   the heaps, which prevents a deadlock. Each heap struct begins at a
+   multiple of HEAP_PTHREAD_ALIGNMENT in memory; the address of the
+   allocated block is converted to size_t only to compute the offset, and
+   the correctness of operations does not depend on the result of the
+   conversion.
+
+   A heap is selected with a linear congruential generator modulo
+   2^(bit width of size_t) on a random state provided by each calling
+   thread, using the upper half of the bits of the state.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "heap-pthread.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+static const size_t C_H_INIT_COUNT = 1;
+static const size_t C_LCG_MUL = 1103515245u;
+static const size_t C_LCG_ADD = 12345u;
+static const size_t C_HALF_BIT = CHAR_BIT * sizeof(size_t) / 2;
+
+static size_t rand_queue(const heap_pthread_t *h, size_t *rand_state);
+static heap_pthread_queue_t *queue_ptr(const heap_pthread_t *h, size_t i);
+static void queue_push(const heap_pthread_t *h,
+		       heap_pthread_queue_t *q,
+		       const void *pty,
+		       const void *elt);
+static void queue_pop(const heap_pthread_t *h,
+		      heap_pthread_queue_t *q,
+		      void *pty,
+		      void *elt);
+static void swap(const heap_pthread_t *h,
+		 heap_pthread_queue_t *q,
+		 size_t i,
+		 size_t j);
+static void heapify_up(const heap_pthread_t *h,
+		       heap_pthread_queue_t *q,
+		       size_t i);
+static void heapify_down(const heap_pthread_t *h,
+			 heap_pthread_queue_t *q,
+			 size_t i);
+static void *pty_ptr(const heap_pthread_t *h,
+		     const heap_pthread_queue_t *q,
+		     size_t i);
+static void *elt_ptr(const heap_pthread_t *h,
+		     const heap_pthread_queue_t *q,
+		     size_t i);
+
+/**
+   Initializes a concurrent priority queue. The initialization operation
+   is called and must return before any thread calls a push or pop
+   operation.
+   h           : pointer to a preallocated block of size
+                 sizeof(heap_pthread_t)
+   pty_size    : size of a contiguous priority object
+   elt_size    : - size of an element, if the element is within a contiguous
+                 memory block and a copy of the element is inserted,
+                 - size of a pointer to an element, if the element is within
+                 a noncontiguous memory block or a pointer to a contiguous
+                 element is inserted
+   min_num     : minimum number of elements that are known or expected to
+                 become present simultaneously in a queue, resulting in a
+                 speedup by avoiding unnecessary growth steps of the heaps;
+                 0 if a positive value is not specified
+   num_queues  : > 0 number of heaps, e.g. 2 to 4 times the number of
+                 threads; a larger number reduces contention at the expense
+                 of the quality of the priority order of pops
+   cmp_pty     : comparison function which returns a negative integer value
+                 if the priority value pointed to by the first argument is
+                 less than the priority value pointed to by the second, a
+                 positive integer value if the priority value pointed to by
+                 the first argument is greater than the priority value
+                 pointed to by the second, and zero integer value if the two
+                 priority values are equal
+   free_elt    : - if an element is within a contiguous memory block and
+                 a copy of the element was inserted, then NULL as free_elt
+                 is sufficient to delete the element,
+                 - if an element is within a noncontiguous memory block or
+                 a pointer to a contiguous element was inserted, then an
+                 element-specific free_elt, taking a pointer to a pointer to an
+                 element as its argument and leaving a block of size elt_size
+                 pointed to by the argument, is necessary to delete the element
+*/
+void heap_pthread_init(heap_pthread_t *h,
+		       size_t pty_size,
+		       size_t elt_size,
+		       size_t min_num,
+		       size_t num_queues,
+		       int (*cmp_pty)(const void *, const void *),
+		       void (*free_elt)(void *)){
+  size_t i, count, elt_rem, pty_rem, q_rem, shift;
+  heap_pthread_queue_t *q = NULL;
+  h->pty_size = pty_size;
+  h->elt_size = elt_size;
+  /* align elt relative to a malloc's pointer and compute pair_size */
+  if (h->pty_size <= h->elt_size){
+    h->elt_offset = h->elt_size;
+  }else{
+    elt_rem = h->pty_size % h->elt_size;
+    h->elt_offset = add_sz_perror(h->pty_size,
+				  (elt_rem > 0) * (h->elt_size - elt_rem));
+  }
+  pty_rem = add_sz_perror(h->elt_offset, h->elt_size) % h->pty_size;
+  h->pair_size = add_sz_perror(h->elt_offset + h->elt_size,
+			       (pty_rem > 0) * (h->pty_size - pty_rem));
+  h->num_queues = num_queues;
+  q_rem = sizeof(heap_pthread_queue_t) % HEAP_PTHREAD_ALIGNMENT;
+  h->queue_size = sizeof(heap_pthread_queue_t) +
+    (q_rem > 0) * (HEAP_PTHREAD_ALIGNMENT - q_rem);
+  h->qs_blk = malloc_perror(add_sz_perror(mul_sz_perror(h->num_queues,
+							h->queue_size),
+					  HEAP_PTHREAD_ALIGNMENT),
+			    1);
+  shift = (HEAP_PTHREAD_ALIGNMENT -
+	   (size_t)h->qs_blk % HEAP_PTHREAD_ALIGNMENT) %
+    HEAP_PTHREAD_ALIGNMENT;
+  h->qs = (char *)h->qs_blk + shift;
+  h->cmp_pty = cmp_pty;
+  h->free_elt = free_elt;
+  count = min_num / h->num_queues + (min_num % h->num_queues > 0);
+  if (count == 0) count = C_H_INIT_COUNT;
+  for (i = 0; i < h->num_queues; i++){
+    q = queue_ptr(h, i);
+    q->count = count;
+    q->num_elts = 0;
+    q->buf = malloc_perror(1, h->pair_size);
+    q->pty_elts = malloc_perror(q->count, h->pair_size);
+    mutex_init_perror(&q->mutex);
+  }
+}
+
+/**
+   Aligns the priorities and elements of a concurrent priority queue
+   according to the values of the alignment parameters. If the alignment
+   requirement of only one type is known, then the size of the other type
+   can be used as a value of the other alignment parameter because size of
+   type >= alignment requirement of type (due to structure of arrays),
+   which may result in overalignment. The operation is optionally called
+   after heap_pthread_init is completed and before any other heap_pthread_
+   operation is called.
+   h             : pointer to an initialized heap_pthread_t struct
+   pty_alignment : alignment requirement or size of the type of a priority
+   elt_alignment : alignment requirement or size of the type of an element
+*/
+void heap_pthread_align(heap_pthread_t *h,
+			size_t pty_alignment,
+			size_t elt_alignment){
+  size_t i, elt_rem, pty_rem;
+  heap_pthread_queue_t *q = NULL;
+  if (h->pty_size <= elt_alignment){
+    h->elt_offset = elt_alignment;
+  }else{
+    elt_rem = h->pty_size % elt_alignment;
+    h->elt_offset = add_sz_perror(h->pty_size,
+				  (elt_rem > 0) * (elt_alignment - elt_rem));
+  }
+  pty_rem = add_sz_perror(h->elt_offset, h->elt_size) % pty_alignment;
+  h->pair_size = add_sz_perror(h->elt_offset + h->elt_size,
+			       (pty_rem > 0) * (pty_alignment - pty_rem));
+  for (i = 0; i < h->num_queues; i++){
+    q = queue_ptr(h, i);
+    q->buf = realloc_perror(q->buf, 1, h->pair_size);
+    q->pty_elts = realloc_perror(q->pty_elts, q->count, h->pair_size);
+  }
+}
+
+/**
+   Pushes an element and an associated priority value into a heap of a
+   concurrent priority queue selected at random.
+   h           : pointer to an initialized concurrent priority queue
+   pty         : pointer to a block of size pty_size that is an object of
+                 basic type (e.g. char, int, long, double)
+   elt         : pointer to a block of size elt_size that is either a
+                 contiguous element object or a pointer to a contiguous or
+                 non-contiguous element
+   rand_state  : pointer to a random state that is only used by the calling
+                 thread, initialized to an arbitrary value (e.g. a thread
+                 number) and updated by the operation
+*/
+void heap_pthread_push(heap_pthread_t *h,
+		       const void *pty,
+		       const void *elt,
+		       size_t *rand_state){
+  heap_pthread_queue_t *q = queue_ptr(h, rand_queue(h, rand_state));
+  mutex_lock_perror(&q->mutex);
+  queue_push(h, q, pty, elt);
+  mutex_unlock_perror(&q->mutex);
+}
+
+/**
+   Pops an element associated with a priority value that is minimal in two
+   heaps of a concurrent priority queue selected at random. If both heaps
+   are empty, an element is popped from the first heap that is found
+   non-empty when the heaps are locked in turn. Returns 1 if an element
+   was popped, and 0 if all heaps were found empty, in which case the
+   memory blocks pointed to by pty and elt remain unchanged. Please see
+   the parameter specification in heap_pthread_push.
+*/
+int heap_pthread_pop(heap_pthread_t *h,
+		     void *pty,
+		     void *elt,
+		     size_t *rand_state){
+  size_t i, j, k;
+  heap_pthread_queue_t *qi = NULL, *qj = NULL, *q = NULL;
+  i = rand_queue(h, rand_state);
+  j = rand_queue(h, rand_state);
+  if (i > j){
+    k = i;
+    i = j;
+    j = k;
+  }
+  qi = queue_ptr(h, i);
+  qj = queue_ptr(h, j);
+  mutex_lock_perror(&qi->mutex);
+  if (i != j) mutex_lock_perror(&qj->mutex);
+  if (qi->num_elts > 0 &&
+      (qj->num_elts == 0 ||
+       h->cmp_pty(qi->pty_elts, qj->pty_elts) <= 0)){
+    q = qi;
+  }else if (qj->num_elts > 0){
+    q = qj;
+  }
+  if (q != NULL) queue_pop(h, q, pty, elt);
+  if (i != j) mutex_unlock_perror(&qj->mutex);
+  mutex_unlock_perror(&qi->mutex);
+  if (q != NULL) return 1;
+  /* both heaps were empty */
+  for (k = 0; k < h->num_queues; k++){
+    q = queue_ptr(h, (i + k) % h->num_queues);
+    mutex_lock_perror(&q->mutex);
+    if (q->num_elts > 0){
+      queue_pop(h, q, pty, elt);
+      mutex_unlock_perror(&q->mutex);
+      return 1;
+    }
+    mutex_unlock_perror(&q->mutex);
+  }
+  return 0;
+}
+
+/**
+   Frees a concurrent priority queue and leaves a block of size
+   sizeof(heap_pthread_t) pointed to by an argument passed as the h
+   parameter. The operation is called after all threads completed their
+   push and pop operations.
+*/
+void heap_pthread_free(heap_pthread_t *h){
+  size_t i, j;
+  heap_pthread_queue_t *q = NULL;
+  for (i = 0; i < h->num_queues; i++){
+    q = queue_ptr(h, i);
+    if (h->free_elt != NULL){
+      for (j = 0; j < q->num_elts; j++){
+	h->free_elt(elt_ptr(h, q, j));
+      }
+    }
+    mutex_destroy_perror(&q->mutex);
+    free(q->buf);
+    free(q->pty_elts);
+    q->buf = NULL;
+    q->pty_elts = NULL;
+  }
+  free(h->qs_blk);
+  h->qs_blk = NULL;
+  h->qs = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Updates a random state and returns the position of a heap.
+*/
+static size_t rand_queue(const heap_pthread_t *h, size_t *rand_state){
+  *rand_state = *rand_state * C_LCG_MUL + C_LCG_ADD;
+  return (*rand_state >> C_HALF_BIT) % h->num_queues;
+}
+
+/**
+   Returns a pointer to the ith heap struct.
+*/
+static heap_pthread_queue_t *queue_ptr(const heap_pthread_t *h, size_t i){
+  return (heap_pthread_queue_t *)((char *)h->qs + i * h->queue_size);
+}
+
+/**
+   Pushes a pair into a heap that is locked by the calling thread.
+*/
+static void queue_push(const heap_pthread_t *h,
+		       heap_pthread_queue_t *q,
+		       const void *pty,
+		       const void *elt){
+  if (q->count == q->num_elts){
+    q->count = mul_sz_perror(2, q->count);
+    q->pty_elts = realloc_perror(q->pty_elts, q->count, h->pair_size);
+  }
+  memcpy(pty_ptr(h, q, q->num_elts), pty, h->pty_size);
+  memcpy(elt_ptr(h, q, q->num_elts), elt, h->elt_size);
+  q->num_elts++;
+  heapify_up(h, q, q->num_elts - 1);
+}
+
+/**
+   Pops a pair from a non-empty heap that is locked by the calling thread.
+*/
+static void queue_pop(const heap_pthread_t *h,
+		      heap_pthread_queue_t *q,
+		      void *pty,
+		      void *elt){
+  memcpy(pty, pty_ptr(h, q, 0), h->pty_size);
+  memcpy(elt, elt_ptr(h, q, 0), h->elt_size);
+  q->num_elts--;
+  if (q->num_elts > 0){
+    memcpy(q->pty_elts,
+	   pty_ptr(h, q, q->num_elts),
+	   h->pair_size);
+    heapify_down(h, q, 0);
+  }
+}
+
+/**
+   Swaps the pairs at indices i and j of a heap.
+*/
+static void swap(const heap_pthread_t *h,
+		 heap_pthread_queue_t *q,
+		 size_t i,
+		 size_t j){
+  memcpy(q->buf, pty_ptr(h, q, i), h->pair_size);
+  memcpy(pty_ptr(h, q, i), pty_ptr(h, q, j), h->pair_size);
+  memcpy(pty_ptr(h, q, j), q->buf, h->pair_size);
+}
+
+/**
+   Heapifies a heap upwards from index i.
+*/
+static void heapify_up(const heap_pthread_t *h,
+		       heap_pthread_queue_t *q,
+		       size_t i){
+  size_t ju;
+  while (i > 0){
+    ju = (i - 1) >> 1;
+    if (h->cmp_pty(pty_ptr(h, q, ju), pty_ptr(h, q, i)) > 0){
+      swap(h, q, i, ju);
+      i = ju;
+    }else{
+      break;
+    }
+  }
+}
+
+/**
+   Heapifies a heap downwards from index i.
+*/
+static void heapify_down(const heap_pthread_t *h,
+			 heap_pthread_queue_t *q,
+			 size_t i){
+  size_t jl, jr, j;
+  while (i < q->num_elts >> 1){
+    jl = 2 * i + 1;
+    jr = jl + 1;
+    j = (jr < q->num_elts &&
+	 h->cmp_pty(pty_ptr(h, q, jr), pty_ptr(h, q, jl)) < 0) ? jr : jl;
+    if (h->cmp_pty(pty_ptr(h, q, j), pty_ptr(h, q, i)) < 0){
+      swap(h, q, i, j);
+      i = j;
+    }else{
+      break;
+    }
+  }
+}
+
+/**
+   Computes a pointer to the priority or element of a pair at index i.
+*/
+static void *pty_ptr(const heap_pthread_t *h,
+		     const heap_pthread_queue_t *q,
+		     size_t i){
+  return (char *)q->pty_elts + i * h->pair_size;
+}
+
+static void *elt_ptr(const heap_pthread_t *h,
+		     const heap_pthread_queue_t *q,
+		     size_t i){
+  return (char *)q->pty_elts + i * h->pair_size + h->elt_offset;
+}
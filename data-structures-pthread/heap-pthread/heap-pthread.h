@@ -0,0 +1,175 @@
+/**
+   heap-pthread.h
+
+   Struct declarations and declarations of accessible functions of a
+   generic dynamically allocated (min) priority queue that is concurrently
+   accessible and modifiable by threads pushing and popping at the same
+   time.
+
+   The implementation provides a relaxed priority queue for any elements
+   in memory associated with priority values of basic type (e.g. char,
+   int, long, double), with the priority and element conventions of
+   heap_t. The queue is a multi-queue of num_queues binary (min) heaps,
+   each protected by its own mutex. A push inserts a pair into a heap
+   selected at random, and a pop locks two heaps selected at random and
+   pops a pair with the lesser minimal priority of the two. A thread holds
+   at most two locks at a time and does not wait for threads operating on
+   other heaps, so that with num_queues set to a small multiple of the
+   number of threads, threads rarely contend for the same lock.
+
+   A pop is relaxed: the popped priority is minimal in the two selected
+   heaps, and in expectation is among the O(num_queues) minimal
+   priorities in the queue if pushes are distributed uniformly. If
+   num_queues is 1, a pop returns a minimal priority in the queue. A pop
+   returns that the queue is empty only if all heaps were found empty
+   while each heap was locked. The guarantees with respect to the final
+   state of the queue after all operations are completed are the same as
+   for a single heap: each pushed pair is popped at most once, and a pair
+   that is not popped is in the queue.
+
+   The selection of heaps is based on a random state that is provided by
+   each calling thread, so that no random state is shared by threads.
+   In-queue search and update operations are not provided, because an
+   element may be in any of the heaps.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef HEAP_PTHREAD_H
+#define HEAP_PTHREAD_H
+
+#define _XOPEN_SOURCE 600
+
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+   The alignment of each heap struct in memory, so that the mutexes and
+   counters of different heaps are not in the same cache line on current
+   systems.
+*/
+#define HEAP_PTHREAD_ALIGNMENT 64
+
+typedef struct{
+  size_t count;
+  size_t num_elts;
+  void *buf; /* only used by heap operations internally */
+  void *pty_elts;
+  pthread_mutex_t mutex;
+} heap_pthread_queue_t;
+
+typedef struct{
+  size_t pty_size;
+  size_t elt_size;
+  size_t pair_size; /* size of a pty elt pair aligned in memory */
+  size_t elt_offset; /* number of bytes from beginning of pair to elt */
+  size_t num_queues;
+  size_t queue_size; /* multiple of HEAP_PTHREAD_ALIGNMENT */
+  void *qs_blk; /* allocated block containing qs */
+  void *qs; /* num_queues heap_pthread_queue_t structs, queue_size apart */
+  int (*cmp_pty)(const void *, const void *);
+  void (*free_elt)(void *);
+} heap_pthread_t;
+
+/**
+   Initializes a concurrent priority queue. The initialization operation
+   is called and must return before any thread calls a push or pop
+   operation.
+   h           : pointer to a preallocated block of size
+                 sizeof(heap_pthread_t)
+   pty_size    : size of a contiguous priority object
+   elt_size    : - size of an element, if the element is within a contiguous
+                 memory block and a copy of the element is inserted,
+                 - size of a pointer to an element, if the element is within
+                 a noncontiguous memory block or a pointer to a contiguous
+                 element is inserted
+   min_num     : minimum number of elements that are known or expected to
+                 become present simultaneously in a queue, resulting in a
+                 speedup by avoiding unnecessary growth steps of the heaps;
+                 0 if a positive value is not specified
+   num_queues  : > 0 number of heaps, e.g. 2 to 4 times the number of
+                 threads; a larger number reduces contention at the expense
+                 of the quality of the priority order of pops
+   cmp_pty     : comparison function which returns a negative integer value
+                 if the priority value pointed to by the first argument is
+                 less than the priority value pointed to by the second, a
+                 positive integer value if the priority value pointed to by
+                 the first argument is greater than the priority value
+                 pointed to by the second, and zero integer value if the two
+                 priority values are equal
+   free_elt    : - if an element is within a contiguous memory block and
+                 a copy of the element was inserted, then NULL as free_elt
+                 is sufficient to delete the element,
+                 - if an element is within a noncontiguous memory block or
+                 a pointer to a contiguous element was inserted, then an
+                 element-specific free_elt, taking a pointer to a pointer to an
+                 element as its argument and leaving a block of size elt_size
+                 pointed to by the argument, is necessary to delete the element
+*/
+void heap_pthread_init(heap_pthread_t *h,
+		       size_t pty_size,
+		       size_t elt_size,
+		       size_t min_num,
+		       size_t num_queues,
+		       int (*cmp_pty)(const void *, const void *),
+		       void (*free_elt)(void *));
+
+/**
+   Aligns the priorities and elements of a concurrent priority queue
+   according to the values of the alignment parameters. If the alignment
+   requirement of only one type is known, then the size of the other type
+   can be used as a value of the other alignment parameter because size of
+   type >= alignment requirement of type (due to structure of arrays),
+   which may result in overalignment. The operation is optionally called
+   after heap_pthread_init is completed and before any other heap_pthread_
+   operation is called.
+   h             : pointer to an initialized heap_pthread_t struct
+   pty_alignment : alignment requirement or size of the type of a priority
+   elt_alignment : alignment requirement or size of the type of an element
+*/
+void heap_pthread_align(heap_pthread_t *h,
+			size_t pty_alignment,
+			size_t elt_alignment);
+
+/**
+   Pushes an element and an associated priority value into a heap of a
+   concurrent priority queue selected at random.
+   h           : pointer to an initialized concurrent priority queue
+   pty         : pointer to a block of size pty_size that is an object of
+                 basic type (e.g. char, int, long, double)
+   elt         : pointer to a block of size elt_size that is either a
+                 contiguous element object or a pointer to a contiguous or
+                 non-contiguous element
+   rand_state  : pointer to a random state that is only used by the calling
+                 thread, initialized to an arbitrary value (e.g. a thread
+                 number) and updated by the operation
+*/
+void heap_pthread_push(heap_pthread_t *h,
+		       const void *pty,
+		       const void *elt,
+		       size_t *rand_state);
+
+/**
+   Pops an element associated with a priority value that is minimal in two
+   heaps of a concurrent priority queue selected at random. If both heaps
+   are empty, an element is popped from the first heap that is found
+   non-empty when the heaps are locked in turn. Returns 1 if an element
+   was popped, and 0 if all heaps were found empty, in which case the
+   memory blocks pointed to by pty and elt remain unchanged. Please see
+   the parameter specification in heap_pthread_push.
+*/
+int heap_pthread_pop(heap_pthread_t *h,
+		     void *pty,
+		     void *elt,
+		     size_t *rand_state);
+
+/**
+   Frees a concurrent priority queue and leaves a block of size
+   sizeof(heap_pthread_t) pointed to by an argument passed as the h
+   parameter. The operation is called after all threads completed their
+   push and pop operations.
+*/
+void heap_pthread_free(heap_pthread_t *h);
+
+#endif
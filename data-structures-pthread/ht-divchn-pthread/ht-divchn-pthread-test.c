@@ -48,13 +48,15 @@ const char *C_USAGE =
   "> 0 : d\n"
   "> 0 : e log base 2\n"
   "> 0 : f s.t. c / 2**e <= alpha <= d / 2**e, in f steps\n"
-  "[0, 1] : on/off insert search uint test\n"
-  "[0, 1] : on/off remove delete uint test\n"
-  "[0, 1] : on/off insert search uint_ptr test\n"
-  "[0, 1] : on/off remove delete uint_ptr test\n"
-  "[0, 1] : on/off corner cases test\n";
-const int C_ARGC_MAX = 13;
-const size_t C_ARGS_DEF[12] = {14, 0, 2, 1024, 30720u, 11, 10, 1, 1, 1, 1, 1};
+  "[0, 1] : insert search uint test\n"
+  "[0, 1] : remove delete uint test\n"
+  "[0, 1] : insert search uint_ptr test\n"
+  "[0, 1] : remove delete uint_ptr test\n"
+  "[0, 1] : corner cases test\n"
+  "[0, 1] : read pool stats tests\n";
+const int C_ARGC_MAX = 14;
+const size_t C_ARGS_DEF[13] = {14, 0, 2, 1024, 30720u, 11, 10, 1, 1, 1, 1, 1,
+			       1};
 const size_t C_SIZE_MAX = (size_t)-1;
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
@@ -67,6 +69,15 @@ const size_t C_CORNER_LOG_ALPHA_D = 15; /* alpha is 33/32768 */
 const size_t C_CORNER_MIN_NUM = 0;
 const size_t C_CORNER_NUM_LOCKS = 1;
 const size_t C_CORNER_NUM_GROW_THREADS = 1;
+const size_t C_MIN_NUM = 16384;
+const size_t C_MIN_NUM_ALPHA_N = 1;
+const size_t C_MIN_NUM_LOG_ALPHA_D = 1; /* alpha is 1/2 */
+
+/* concurrent read test */
+const size_t C_READ_PASSES = 4;
+
+/* stats test */
+const size_t C_HIST_COUNT = 16;
 
 void insert_search_free(size_t num_ins,
 			size_t key_size,
@@ -941,6 +952,422 @@ void remove_delete(size_t num_ins,
   elts = NULL;
 }
 
+/**
+   Runs a ht_divchn_pthread_read test in a read-optimized mode, with
+   num_threads reader threads reading a set of size_t keys that remains in
+   the hash table, concurrently with num_threads writer threads inserting
+   and deleting a disjoint set of keys, which results in growth steps. The
+   nodes are allocated from pools if pool is nonzero.
+*/
+
+typedef struct{
+  size_t start;
+  size_t count;
+  size_t batch_count;
+  size_t reader_ix;
+  size_t *res_count; /* for each reader thread */
+  const size_t *keys;
+  const ht_divchn_pthread_t *ht;
+} read_arg_t;
+
+void *read_thread(void *arg){
+  size_t i, j, k;
+  size_t count;
+  size_t *elts = NULL;
+  const read_arg_t *ra = arg;
+  elts = malloc_perror(ra->batch_count, sizeof(size_t));
+  *(ra->res_count) = 0;
+  for (i = 0; i < C_READ_PASSES; i++){
+    for (j = 0; j < ra->count; j += count){
+      count = ra->count - j;
+      if (count > ra->batch_count) count = ra->batch_count;
+      *(ra->res_count) +=
+	(ht_divchn_pthread_read(ra->ht,
+				ra->keys + ra->start + j,
+				elts,
+				count,
+				ra->reader_ix) == count);
+      for (k = 0; k < count; k++){
+	*(ra->res_count) -= (elts[k] != ra->keys[ra->start + j + k]);
+      }
+    }
+  }
+  free(elts);
+  elts = NULL;
+  return NULL;
+}
+
+typedef struct{
+  size_t start;
+  size_t count;
+  size_t batch_count;
+  const size_t *keys;
+  ht_divchn_pthread_t *ht;
+} write_arg_t;
+
+void *write_thread(void *arg){
+  size_t i;
+  size_t count;
+  const write_arg_t *wa = arg;
+  for (i = 0; i < wa->count; i += count){
+    count = wa->count - i;
+    if (count > wa->batch_count) count = wa->batch_count;
+    ht_divchn_pthread_insert(wa->ht,
+			     wa->keys + wa->start + i,
+			     wa->keys + wa->start + i,
+			     count);
+  }
+  for (i = 0; i < wa->count; i += count){
+    count = wa->count - i;
+    if (count > wa->batch_count) count = wa->batch_count;
+    ht_divchn_pthread_delete(wa->ht, wa->keys + wa->start + i, count);
+  }
+  return NULL;
+}
+
+void run_read_test(size_t log_ins,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t num_threads,
+		   size_t log_num_locks,
+		   size_t num_grow_threads,
+		   size_t batch_count,
+		   int pool){
+  int res = 1;
+  size_t i;
+  size_t num_ins;
+  size_t seg_count, rem_count, start = 0;
+  size_t num_batches = 0;
+  size_t *keys = NULL;
+  size_t *res_counts = NULL;
+  double t;
+  pthread_t *rids = NULL, *wids = NULL;
+  read_arg_t *ras = NULL;
+  write_arg_t *was = NULL;
+  ht_divchn_pthread_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(mul_sz_perror(2, num_ins), sizeof(size_t));
+  for (i = 0; i < 2 * num_ins; i++){
+    keys[i] = i;
+  }
+  res_counts = calloc_perror(num_threads, sizeof(size_t));
+  rids = malloc_perror(num_threads, sizeof(pthread_t));
+  wids = malloc_perror(num_threads, sizeof(pthread_t));
+  ras = malloc_perror(num_threads, sizeof(read_arg_t));
+  was = malloc_perror(num_threads, sizeof(write_arg_t));
+  printf("Run a ht_divchn_pthread_read test on size_t keys and size_t "
+	 "elements\n");
+  printf("\t# readers:        %lu\n"
+	 "\t# writers:        %lu\n"
+	 "\t# locks:          %lu\n"
+	 "\t# grow threads:   %lu\n"
+	 "\tbatch count:      %lu\n"
+	 "\tpool mode:        %s\n"
+	 "\t# in ht keys: %lu, # inserted and deleted keys: %lu\n",
+	 TOLU(num_threads),
+	 TOLU(num_threads),
+	 TOLU(pow_two_perror(log_num_locks)),
+	 TOLU(num_grow_threads),
+	 TOLU(batch_count),
+	 pool ? "yes" : "no",
+	 TOLU(num_ins),
+	 TOLU(num_ins));
+  ht_divchn_pthread_init(&ht,
+			 sizeof(size_t),
+			 sizeof(size_t),
+			 0,
+			 alpha_n,
+			 log_alpha_d,
+			 log_num_locks,
+			 num_grow_threads,
+			 NULL,
+			 NULL,
+			 NULL,
+			 NULL);
+  ht_divchn_pthread_align_elt(&ht, sizeof(size_t));
+  if (pool) ht_divchn_pthread_pool(&ht, 0);
+  ht_divchn_pthread_readers(&ht, num_threads);
+  ht_divchn_pthread_insert(&ht, keys, keys, num_ins);
+  seg_count = num_ins / num_threads;
+  rem_count = num_ins - seg_count * num_threads;
+  for (i = 0; i < num_threads; i++){
+    ras[i].start = start;
+    ras[i].count = seg_count;
+    ras[i].count += (rem_count > 0 && rem_count--);
+    ras[i].batch_count = batch_count;
+    ras[i].reader_ix = i;
+    ras[i].res_count = &res_counts[i];
+    ras[i].keys = keys;
+    ras[i].ht = &ht;
+    was[i].start = num_ins + ras[i].start;
+    was[i].count = ras[i].count;
+    was[i].batch_count = batch_count;
+    was[i].keys = keys;
+    was[i].ht = &ht;
+    num_batches += C_READ_PASSES *
+      ((ras[i].count + batch_count - 1) / batch_count);
+    start += ras[i].count;
+  }
+  t = timer();
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&rids[i], read_thread, &ras[i]);
+    thread_create_perror(&wids[i], write_thread, &was[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(rids[i], NULL);
+    thread_join_perror(wids[i], NULL);
+    num_batches -= res_counts[i];
+  }
+  t = timer() - t;
+  res *= (num_batches == 0 && ht.num_elts == num_ins);
+  for (i = 0; i < 2 * num_ins; i++){
+    res *= ((i < num_ins && *(size_t *)ht_divchn_pthread_search(&ht,
+								&keys[i]) ==
+	     i) ||
+	    (i >= num_ins && ht_divchn_pthread_search(&ht, &keys[i]) == NULL));
+  }
+  printf("\t\tread w/ insert delete time          %.4f seconds\n", t);
+  printf("\t\tread correctness:                   ");
+  print_test_result(res);
+  ht_divchn_pthread_free(&ht);
+  free(keys);
+  free(res_counts);
+  free(rids);
+  free(wids);
+  free(ras);
+  free(was);
+  keys = NULL;
+  res_counts = NULL;
+  rids = NULL;
+  wids = NULL;
+  ras = NULL;
+  was = NULL;
+}
+
+/**
+   Runs a test of the pool allocation mode on distinct size_t keys and
+   size_t elements, with writer threads inserting and deleting keys
+   concurrently, followed by an insertion of all keys.
+*/
+void run_pool_test(size_t log_ins,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t num_threads,
+		   size_t log_num_locks,
+		   size_t num_grow_threads,
+		   size_t batch_count){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t seg_count, rem_count, start;
+  size_t *keys = NULL;
+  double t_wr[2], t_free[2];
+  pthread_t *wids = NULL;
+  write_arg_t *was = NULL;
+  ht_divchn_pthread_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  wids = malloc_perror(num_threads, sizeof(pthread_t));
+  was = malloc_perror(num_threads, sizeof(write_arg_t));
+  printf("Run a ht_divchn_pthread_pool test on size_t keys and size_t "
+	 "elements\n");
+  printf("\t# writers:        %lu\n"
+	 "\t# locks:          %lu\n"
+	 "\t# grow threads:   %lu\n"
+	 "\tbatch count:      %lu\n"
+	 "\t# inserted and deleted keys: %lu\n",
+	 TOLU(num_threads),
+	 TOLU(pow_two_perror(log_num_locks)),
+	 TOLU(num_grow_threads),
+	 TOLU(batch_count),
+	 TOLU(num_ins));
+  seg_count = num_ins / num_threads;
+  for (j = 0; j < 2; j++){
+    ht_divchn_pthread_init(&ht,
+			   sizeof(size_t),
+			   sizeof(size_t),
+			   0,
+			   alpha_n,
+			   log_alpha_d,
+			   log_num_locks,
+			   num_grow_threads,
+			   NULL,
+			   NULL,
+			   NULL,
+			   NULL);
+    ht_divchn_pthread_align_elt(&ht, sizeof(size_t));
+    if (j) ht_divchn_pthread_pool(&ht, 0);
+    rem_count = num_ins - seg_count * num_threads;
+    start = 0;
+    for (i = 0; i < num_threads; i++){
+      was[i].start = start;
+      was[i].count = seg_count;
+      was[i].count += (rem_count > 0 && rem_count--);
+      was[i].batch_count = batch_count;
+      was[i].keys = keys;
+      was[i].ht = &ht;
+      start += was[i].count;
+    }
+    t_wr[j] = timer();
+    for (i = 0; i < num_threads; i++){
+      thread_create_perror(&wids[i], write_thread, &was[i]);
+    }
+    for (i = 0; i < num_threads; i++){
+      thread_join_perror(wids[i], NULL);
+    }
+    t_wr[j] = timer() - t_wr[j];
+    res *= (ht.num_elts == 0);
+    ht_divchn_pthread_insert(&ht, keys, keys, num_ins);
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_pthread_search(&ht, &keys[i]) == i);
+    }
+    t_free[j] = timer();
+    ht_divchn_pthread_free(&ht);
+    t_free[j] = timer() - t_free[j];
+  }
+  printf("\t\tinsert delete time:                 %.4f seconds\n"
+	 "\t\tinsert delete time (pool):          %.4f seconds\n"
+	 "\t\tfree time:                          %.4f seconds\n"
+	 "\t\tfree time (pool):                   %.4f seconds\n",
+	 t_wr[0], t_wr[1], t_free[0], t_free[1]);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(wids);
+  free(was);
+  keys = NULL;
+  wids = NULL;
+  was = NULL;
+}
+
+/**
+   Runs a test of ht_divchn_pthread_stats on distinct size_t keys and
+   size_t elements, with writer threads inserting and deleting keys
+   concurrently, followed by an insertion of all keys. Tests that the wait
+   counts of key locks add up to the total wait count, and that the
+   histogram of chain lengths accounts for each slot and each key.
+*/
+void run_stats_test(size_t log_ins,
+		    size_t alpha_n,
+		    size_t log_alpha_d,
+		    size_t num_threads,
+		    size_t log_num_locks,
+		    size_t num_grow_threads,
+		    size_t batch_count){
+  int res = 1;
+  size_t i;
+  size_t num_ins, num_slots, num_keys, num_waits;
+  size_t seg_count, rem_count, start;
+  size_t *keys = NULL;
+  size_t *hist = NULL;
+  size_t *lock_waits = NULL;
+  pthread_t *wids = NULL;
+  write_arg_t *was = NULL;
+  ht_divchn_pthread_t ht;
+  ht_divchn_pthread_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  hist = malloc_perror(C_HIST_COUNT, sizeof(size_t));
+  lock_waits = malloc_perror(pow_two_perror(log_num_locks), sizeof(size_t));
+  wids = malloc_perror(num_threads, sizeof(pthread_t));
+  was = malloc_perror(num_threads, sizeof(write_arg_t));
+  printf("Run a ht_divchn_pthread_stats test on size_t keys and size_t "
+	 "elements\n");
+  printf("\t# writers:        %lu\n"
+	 "\t# locks:          %lu\n"
+	 "\t# grow threads:   %lu\n"
+	 "\tbatch count:      %lu\n"
+	 "\t# inserted and deleted keys: %lu\n",
+	 TOLU(num_threads),
+	 TOLU(pow_two_perror(log_num_locks)),
+	 TOLU(num_grow_threads),
+	 TOLU(batch_count),
+	 TOLU(num_ins));
+  ht_divchn_pthread_init(&ht,
+			 sizeof(size_t),
+			 sizeof(size_t),
+			 0,
+			 alpha_n,
+			 log_alpha_d,
+			 log_num_locks,
+			 num_grow_threads,
+			 NULL,
+			 NULL,
+			 NULL,
+			 NULL);
+  ht_divchn_pthread_align_elt(&ht, sizeof(size_t));
+  seg_count = num_ins / num_threads;
+  rem_count = num_ins - seg_count * num_threads;
+  start = 0;
+  for (i = 0; i < num_threads; i++){
+    was[i].start = start;
+    was[i].count = seg_count;
+    was[i].count += (rem_count > 0 && rem_count--);
+    was[i].batch_count = batch_count;
+    was[i].keys = keys;
+    was[i].ht = &ht;
+    start += was[i].count;
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&wids[i], write_thread, &was[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(wids[i], NULL);
+  }
+  ht_divchn_pthread_stats(&ht, &s, NULL, 0, lock_waits);
+  num_waits = 0;
+  for (i = 0; i < s.num_key_locks; i++){
+    num_waits += lock_waits[i];
+  }
+  res *= (s.num_elts == 0 &&
+	  s.num_key_locks == pow_two_perror(log_num_locks) &&
+	  s.num_key_lock_waits == num_waits);
+  ht_divchn_pthread_insert(&ht, keys, keys, num_ins);
+  ht_divchn_pthread_stats(&ht, &s, hist, C_HIST_COUNT, NULL);
+  num_slots = 0;
+  num_keys = 0;
+  for (i = 0; i < C_HIST_COUNT; i++){
+    num_slots += hist[i];
+    num_keys += i * hist[i];
+    if (i > s.max_chain_len) res *= (hist[i] == 0);
+  }
+  res *= (s.num_elts == num_ins &&
+	  s.count == ht.count &&
+	  num_slots == ht.count &&
+	  (s.max_chain_len >= C_HIST_COUNT - 1 || num_keys == num_ins) &&
+	  (s.num_grows > 0) == (ht.count > C_CORNER_HT_COUNT) &&
+	  s.num_moves >= s.num_grows);
+  printf("\t\tchain lengths:                     ");
+  for (i = 0; i < C_HIST_COUNT && i <= s.max_chain_len; i++){
+    printf(" %lu", TOLU(hist[i]));
+  }
+  printf("\n\t\tgrowth steps, moved keys:           %lu, %lu\n"
+	 "\t\tkey lock waits:                     %lu\n",
+	 TOLU(s.num_grows),
+	 TOLU(s.num_moves),
+	 TOLU(s.num_key_lock_waits));
+  ht_divchn_pthread_free(&ht);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(hist);
+  free(lock_waits);
+  free(wids);
+  free(was);
+  keys = NULL;
+  hist = NULL;
+  lock_waits = NULL;
+  wids = NULL;
+  was = NULL;
+}
+
 /**
    Runs a corner cases test.
 */
@@ -989,6 +1416,34 @@ void run_corner_cases_test(size_t log_ins){
 	    ht_divchn_pthread_search(&ht, key) == NULL);
     ht_divchn_pthread_free(&ht);
   }
+  /* a large min_num with the bytes of ht set as if not initialized */
+  memset(&ht, 0xff, sizeof(ht_divchn_pthread_t));
+  ht_divchn_pthread_init(&ht,
+			 sizeof(size_t),
+			 elt_size,
+			 C_MIN_NUM,
+			 C_MIN_NUM_ALPHA_N,
+			 C_MIN_NUM_LOG_ALPHA_D,
+			 C_CORNER_NUM_LOCKS,
+			 C_CORNER_NUM_GROW_THREADS,
+			 NULL,
+			 NULL,
+			 NULL,
+			 NULL);
+  ht_divchn_pthread_align_elt(&ht, elt_alignment);
+  res *= (ht.alpha_n == C_MIN_NUM_ALPHA_N &&
+	  ht.log_alpha_d == C_MIN_NUM_LOG_ALPHA_D &&
+	  ht.count / pow_two_perror(C_MIN_NUM_LOG_ALPHA_D) *
+	  C_MIN_NUM_ALPHA_N >= C_MIN_NUM);
+  j = ht.count;
+  for (i = 0; i < C_MIN_NUM; i++){
+    ht_divchn_pthread_insert(&ht, &i, &i, 1);
+  }
+  res *= (ht.count == j && ht.num_elts == C_MIN_NUM);
+  for (i = 0; i < C_MIN_NUM; i++){
+    res *= (*(size_t *)ht_divchn_pthread_search(&ht, &i) == i);
+  }
+  ht_divchn_pthread_free(&ht);
   print_test_result(res);
   free(key);
   key = NULL;
@@ -1051,7 +1506,8 @@ int main(int argc, char *argv[]){
       args[8] > 1 ||
       args[9] > 1 ||
       args[10] > 1 ||
-      args[11] > 1){
+      args[11] > 1 ||
+      args[12] > 1){
     fprintf(stderr, "USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -1099,7 +1555,13 @@ int main(int argc, char *argv[]){
 						15,
 						4,
 						1000);
-  if (args[11]) run_corner_cases_test(args[0]); 
+  if (args[11]) run_corner_cases_test(args[0]);
+  if (args[12]){
+    run_read_test(args[0], args[4], args[5], 4, 15, 4, 1000, 0);
+    run_read_test(args[0], args[4], args[5], 4, 2, 4, 1000, 1);
+    run_pool_test(args[0], args[4], args[5], 4, 4, 4, 1000);
+    run_stats_test(args[0], args[4], args[5], 4, 2, 4, 64);
+  }
   free(args);
   args = NULL;
   return 0;
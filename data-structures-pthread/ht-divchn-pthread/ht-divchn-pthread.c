@@ -39,10 +39,29 @@
      exceeded**, or iii) after the hash table reaches its maximum count of
      slots on a given system and alpha no longer bounds the load factor.
 
+   In a read-optimized mode, set by ht_divchn_pthread_readers, threads
+   call read operations concurrently with insert, remove, and/or delete
+   operations. A reader does not lock or allocate memory, does not access
+   the gate of a hash table, and does not wait for a growth step. A reader
+   announces the epoch of the hash table in its own cache line, which also
+   holds its copy of an element until the copy is validated, loads the
+   published array of slots, and traverses a chain with atomic loads of
+   its links. A writer modifies a chain under the lock of its slot between
+   two increments of a sequence number of the lock, and a reader yields
+   while the sequence number is odd and repeats the traversal of a chain
+   if the sequence number changed. A removed or deleted node is freed
+   after a grace period, i.e. after each reader was found outside of a
+   read operation or in an operation that started after the removal, so
+   that a reader never accesses a freed node. A growth step copies the
+   keys and elements into new chains, publishes the new array of slots,
+   and frees the previous array and nodes after a grace period.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99. The requirements are: i) CHAR_BIT * sizeof(size_t) is greater
    or equal to 16 and is even (every bit is required to participate
-   in the value at this time), and ii) pthreads API is available.
+   in the value at this time), ii) pthreads API is available, and iii) the
+   __atomic builtins of GCC and Clang are available, which access the
+   links of the nodes of the chains, which are not of an atomic type.
 
    * unless the growth step that follows does not lower the load factor
    below alpha because the maximum count of slots is reached during the
@@ -55,6 +74,7 @@
 #define _XOPEN_SOURCE 600
 
 #include <unistd.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -66,6 +86,18 @@
 #include "utilities-mod.h"
 #include "utilities-pthread.h"
 
+/* the links of dll_node_t are not atomic objects, hence __atomic builtins */
+#if !defined(__GNUC__)
+#error "ht-divchn-pthread requires GCC/Clang __atomic builtins"
+#endif
+#define LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELAXED(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define FENCE_SEQ_CST() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
 /**
    An array of primes in the increasing order, approximately doubling in 
    magnitude, that are not too close to the powers of 2 and 10 to avoid 
@@ -138,9 +170,37 @@ static const size_t C_BYTE_BIT = CHAR_BIT;
 static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 static const size_t C_SIZE_MAX = (size_t)-1;
 
+static size_t convert_std_key(const ht_divchn_pthread_t *ht,
+			      const void *key);
 static size_t hash(const ht_divchn_pthread_t *ht, const void *key);
 static size_t mul_alpha_sz_max(size_t n, size_t alpha_n, size_t log_alpha_d);
 static void ht_grow(ht_divchn_pthread_t *ht);
+static dll_node_t *search_key(const ht_divchn_pthread_t *ht,
+			      dll_node_t **head,
+			      const void *key);
+static const dll_node_t *read_search_key(const ht_divchn_pthread_t *ht,
+					 dll_node_t * const *head,
+					 const void *key,
+					 size_t lock_ix,
+					 size_t seq);
+static void prepend_new(const ht_divchn_pthread_t *ht,
+			dll_node_t **head,
+			size_t lock_ix,
+			const void *key,
+			const void *elt);
+static void unlink_retire(const ht_divchn_pthread_t *ht,
+			  dll_node_t **head,
+			  dll_node_t *node,
+			  size_t lock_ix,
+			  dll_node_t **retired);
+static void reclaim(ht_divchn_pthread_t *ht,
+		    dll_node_t *retired,
+		    void (*free_elt)(void *));
+static void grace_period(ht_divchn_pthread_t *ht);
+static void seq_begin(const ht_divchn_pthread_t *ht, size_t lock_ix);
+static void seq_end(const ht_divchn_pthread_t *ht, size_t lock_ix);
+static size_t *reader_epoch(const ht_divchn_pthread_t *ht, size_t i);
+static void key_lock(const ht_divchn_pthread_t *ht, size_t lock_ix);
 static int incr_count(ht_divchn_pthread_t *ht);
 static int is_overflow(size_t start, size_t count);
 static size_t build_prime(size_t start, size_t count);
@@ -229,12 +289,13 @@ void ht_divchn_pthread_init(ht_divchn_pthread_t *ht,
   ht->group_ix = 0;
   ht->count_ix = 0;
   ht->count = build_prime(ht->count_ix, C_PARTS_PER_PRIME[ht->group_ix]);
+  mod_rcp_init(ht->count, &ht->count_mul, &ht->count_shift);
+  ht->alpha_n = alpha_n;
+  ht->log_alpha_d = log_alpha_d;
   /* 0 <= max_num_elts */
   ht->max_num_elts = mul_alpha_sz_max(ht->count, alpha_n, log_alpha_d);
   while (min_num > ht->max_num_elts && incr_count(ht));
   ht->num_elts = 0;
-  ht->alpha_n = alpha_n;
-  ht->log_alpha_d = log_alpha_d;
   ht->ll = malloc_perror(1, sizeof(dll_t));
   ht->key_elts = malloc_perror(ht->count, sizeof(dll_node_t *));
   for (i = 0; i < ht->count; i++){
@@ -254,6 +315,19 @@ void ht_divchn_pthread_init(ht_divchn_pthread_t *ht,
   }
   cond_init_perror(&ht->gate_open_cond);
   cond_init_perror(&ht->grow_cond);
+  ht->num_readers = 0;
+  ht->reader_epoch_size = 0;
+  ht->reader_epochs_blk = NULL;
+  ht->reader_epochs = NULL;
+  ht->epoch = 1;
+  ht->key_seqs = NULL;
+  ht->slots = NULL;
+  ht->pools = NULL;
+  /* statistics */
+  ht->num_grows = 0;
+  ht->num_moves = 0;
+  ht->resize_clocks = 0;
+  ht->key_lock_waits = calloc_perror(key_locks_count, sizeof(size_t));
   /* function pointers */
   ht->cmp_key = cmp_key;
   ht->rdc_key = rdc_key;
@@ -282,6 +356,73 @@ void ht_divchn_pthread_align_elt(ht_divchn_pthread_t *ht, size_t alignment){
   dll_align_elt(ht->ll, alignment);
 }
 
+/**
+   Sets a read-optimized mode of a hash table for num_readers reader
+   threads, each calling ht_divchn_pthread_read with a distinct reader_ix
+   value in [0, num_readers). The operation is optionally called after
+   ht_divchn_pthread_init is completed and before any other operation is
+   called.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   num_readers : > 0 number of reader threads
+*/
+void ht_divchn_pthread_readers(ht_divchn_pthread_t *ht, size_t num_readers){
+  size_t i;
+  size_t rem, shift;
+  ht->num_readers = num_readers;
+  /* an epoch and an elt_size block for copying an element per reader */
+  ht->reader_epoch_size = add_sz_perror(sizeof(size_t), ht->elt_size);
+  rem = ht->reader_epoch_size % HT_DIVCHN_PTHREAD_ALIGNMENT;
+  ht->reader_epoch_size = add_sz_perror(ht->reader_epoch_size,
+					(rem > 0) *
+					(HT_DIVCHN_PTHREAD_ALIGNMENT - rem));
+  ht->reader_epochs_blk =
+    malloc_perror(add_sz_perror(mul_sz_perror(num_readers,
+					      ht->reader_epoch_size),
+				HT_DIVCHN_PTHREAD_ALIGNMENT),
+		  1);
+  /* align the reader epochs relative to the cache lines if possible */
+  shift = (HT_DIVCHN_PTHREAD_ALIGNMENT -
+	   (size_t)ht->reader_epochs_blk % HT_DIVCHN_PTHREAD_ALIGNMENT) %
+    HT_DIVCHN_PTHREAD_ALIGNMENT;
+  ht->reader_epochs = (char *)ht->reader_epochs_blk + shift;
+  for (i = 0; i < num_readers; i++){
+    *reader_epoch(ht, i) = 0;
+  }
+  ht->key_seqs = calloc_perror(ht->key_locks_mask + 1, sizeof(size_t));
+  ht->slots = malloc_perror(1, sizeof(ht_divchn_pthread_slots_t));
+  ht->slots->count = ht->count;
+  ht->slots->count_mul = ht->count_mul;
+  ht->slots->count_shift = ht->count_shift;
+  ht->slots->key_elts = ht->key_elts;
+}
+
+/**
+   Sets a pool allocation mode of a hash table. In the mode, the nodes of
+   the chains are allocated from pools in blocks of nodes, one pool per key
+   lock, and a pool is only accessed by a thread holding its lock. The
+   nodes of removed and deleted keys are reused by subsequent insert
+   operations, and all nodes are freed at once when the hash table is
+   freed, instead of a malloc and free call per key under a lock. The
+   mode is effective if the expected number of keys per lock is large
+   relative to a block of nodes (e.g. 16 nodes). The operation is
+   optionally called after ht_divchn_pthread_init and
+   ht_divchn_pthread_align_elt are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   min_num     : minimum number of keys that are known or expected to become
+                 present simultaneously in a hash table, resulting in fewer
+                 allocations of blocks of nodes at the beginning; 0 if a
+                 positive value is not specified
+*/
+void ht_divchn_pthread_pool(ht_divchn_pthread_t *ht, size_t min_num){
+  size_t i;
+  size_t num_locks = ht->key_locks_mask + 1;
+  ht->pools = malloc_perror(num_locks, sizeof(dll_pool_t));
+  for (i = 0; i < num_locks; i++){
+    dll_pool_init(ht->ll, &ht->pools[i], ht->elt_size, min_num / num_locks);
+  }
+}
+
 /**
    Inserts a batch of keys and associated elements into a hash table.
    The batch_keys and batch_elts parameters are not NULL and point to
@@ -295,6 +436,7 @@ void ht_divchn_pthread_insert(ht_divchn_pthread_t *ht,
 			      size_t batch_count){
   size_t i, ix, lock_ix;
   size_t increased = 0;
+  clock_t start;
   const void *key = NULL, *elt = NULL;
   dll_node_t **head = NULL, *node = NULL;
   /* first critical section : go through gate or wait */
@@ -312,21 +454,25 @@ void ht_divchn_pthread_insert(ht_divchn_pthread_t *ht,
     ix = hash(ht, key);
     head = &ht->key_elts[ix];
     lock_ix = ix & ht->key_locks_mask;
-    mutex_lock_perror(&ht->key_locks[lock_ix]);
-    node = dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+    key_lock(ht, lock_ix);
+    node = search_key(ht, head, key);
     if (node == NULL){
       /* insert new key element pair */
-      dll_prepend_new(ht->ll, head, key, elt, ht->key_size, ht->elt_size);
+      prepend_new(ht, head, lock_ix, key, elt);
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
       increased++;
     }else if (ht->rdc_elts != NULL){
       /* reduce new element and current element */
+      seq_begin(ht, lock_ix);
       ht->rdc_elts(dll_elt_ptr(ht->ll, node), elt, ht->elt_size);
+      seq_end(ht, lock_ix);
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
     }else{
       /* update current element to new element */
+      seq_begin(ht, lock_ix);
       if (ht->free_elt != NULL) ht->free_elt(dll_elt_ptr(ht->ll, node));
       memcpy(dll_elt_ptr(ht->ll, node), elt, ht->elt_size);
+      seq_end(ht, lock_ix);
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
     }
   }
@@ -343,7 +489,9 @@ void ht_divchn_pthread_insert(ht_divchn_pthread_t *ht,
 	cond_wait_perror(&ht->grow_cond, &ht->gate_lock);
       }
       mutex_unlock_perror(&ht->gate_lock);
+      start = clock();
       ht_grow(ht); /* single thread */
+      ht->resize_clocks += clock() - start;
       mutex_lock_perror(&ht->gate_lock);
       ht->gate_open = TRUE;
       cond_broadcast_perror(&ht->gate_open_cond);
@@ -381,6 +529,62 @@ void *ht_divchn_pthread_search(const ht_divchn_pthread_t *ht,
   }
 }
 
+/**
+   Copies the elements or its pointers, associated with a batch of keys in
+   a hash table, into the array of elt_size blocks pointed to by batch_elts,
+   and returns the number of keys found in the hash table. If a key is not
+   in the hash table, leaves the corresponding elt_size block unchanged.
+   The operation is called concurrently with insert, remove, delete, and
+   read operations in a read-optimized mode. The batch_keys and batch_elts
+   parameters are not NULL and point to arrays of blocks of size key_size
+   and elt_size respectively. The batch_count parameter is the count of keys
+   in a batch. The reader_ix parameter is the index of the calling reader
+   thread. If a pointer to an element is copied into an elt_size block,
+   the element may be concurrently deleted by another thread unless the
+   deletion is otherwise synchronized by the user.
+*/
+size_t ht_divchn_pthread_read(const ht_divchn_pthread_t *ht,
+			      const void *batch_keys,
+			      void *batch_elts,
+			      size_t batch_count,
+			      size_t reader_ix){
+  size_t i, ix, lock_ix, seq;
+  size_t found = 0;
+  size_t *epoch = reader_epoch(ht, reader_ix);
+  const void *key = NULL;
+  void *elt = epoch + 1; /* copy of an element until it is validated */
+  const dll_node_t *node = NULL;
+  const ht_divchn_pthread_slots_t *slots = NULL;
+  /* announce the epoch before loading the slots and links */
+  STORE_RELAXED(epoch, LOAD_RELAXED(&ht->epoch));
+  FENCE_SEQ_CST();
+  slots = LOAD_ACQUIRE(&ht->slots);
+  for (i = 0; i < batch_count; i++){
+    key = ptr(batch_keys, i, ht->key_size);
+    ix = mod_rcp(convert_std_key(ht, key),
+		 slots->count,
+		 slots->count_mul,
+		 slots->count_shift);
+    lock_ix = ix & ht->key_locks_mask;
+    do{
+      while ((seq = LOAD_ACQUIRE(&ht->key_seqs[lock_ix])) & 1){
+	sched_yield();
+      }
+      node = read_search_key(ht, &slots->key_elts[ix], key, lock_ix, seq);
+      if (node != NULL){
+	memcpy(elt, dll_elt_ptr(ht->ll, node), ht->elt_size);
+      }
+      FENCE_ACQUIRE();
+    }while (LOAD_RELAXED(&ht->key_seqs[lock_ix]) != seq);
+    if (node != NULL){
+      memcpy(ptr(batch_elts, i, ht->elt_size), elt, ht->elt_size);
+      found++;
+    }
+  }
+  STORE_RELEASE(epoch, 0);
+  return found;
+}
+
 /**
    Removes a batch of keys and associated elements from a hash table by
    copying the elements or its pointers into the array of elt_size blocks
@@ -398,7 +602,7 @@ void ht_divchn_pthread_remove(ht_divchn_pthread_t *ht,
   size_t removed = 0;
   const void *key = NULL;
   void *elt = NULL;
-  dll_node_t **head = NULL, *node = NULL;
+  dll_node_t **head = NULL, *node = NULL, *retired = NULL;
   /* first critical section : go through gate or wait */
   mutex_lock_perror(&ht->gate_lock);
   while (!ht->gate_open){
@@ -413,18 +617,26 @@ void ht_divchn_pthread_remove(ht_divchn_pthread_t *ht,
     ix = hash(ht, key);
     head = &ht->key_elts[ix];
     lock_ix = ix & ht->key_locks_mask;
-    mutex_lock_perror(&ht->key_locks[lock_ix]);
-    node = dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+    key_lock(ht, lock_ix);
+    node = search_key(ht, head, key);
     if (node != NULL){
       memcpy(elt, dll_elt_ptr(ht->ll, node), ht->elt_size);
       /* if an element is noncontiguous, only the pointer to it is deleted */
-      dll_delete(ht->ll, head, node, NULL);
+      if (ht->slots != NULL){
+	unlink_retire(ht, head, node, lock_ix, &retired);
+      }else if (ht->pools != NULL){
+	dll_delete_pool(ht->ll, &ht->pools[lock_ix], head, node, NULL);
+      }else{
+	dll_delete(ht->ll, head, node, NULL);
+      }
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
       removed++;
     }else{
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
     }
   }
+  /* free the removed nodes before a growth step may change the count */
+  reclaim(ht, retired, NULL);
   /* finish */
   mutex_lock_perror(&ht->gate_lock);
   ht->num_elts -= removed;
@@ -446,7 +658,7 @@ void ht_divchn_pthread_delete(ht_divchn_pthread_t *ht,
   size_t i, ix, lock_ix;
   size_t deleted = 0;
   const void *key = NULL;
-  dll_node_t **head = NULL, *node = NULL;
+  dll_node_t **head = NULL, *node = NULL, *retired = NULL;
   /* first critical section : go through gate or wait */
   mutex_lock_perror(&ht->gate_lock);
   while (!ht->gate_open){
@@ -460,16 +672,24 @@ void ht_divchn_pthread_delete(ht_divchn_pthread_t *ht,
     ix = hash(ht, key);
     head = &ht->key_elts[ix];
     lock_ix = ix & ht->key_locks_mask;
-    mutex_lock_perror(&ht->key_locks[lock_ix]);
-    node = dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+    key_lock(ht, lock_ix);
+    node = search_key(ht, head, key);
     if (node != NULL){
-      dll_delete(ht->ll, head, node, ht->free_elt);
+      if (ht->slots != NULL){
+	unlink_retire(ht, head, node, lock_ix, &retired);
+      }else if (ht->pools != NULL){
+	dll_delete_pool(ht->ll, &ht->pools[lock_ix], head, node, ht->free_elt);
+      }else{
+	dll_delete(ht->ll, head, node, ht->free_elt);
+      }
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
       deleted++;
     }else{
       mutex_unlock_perror(&ht->key_locks[lock_ix]);
     }
   }
+  /* free the deleted nodes before a growth step may change the count */
+  reclaim(ht, retired, ht->free_elt);
   /* finish */
   mutex_lock_perror(&ht->gate_lock);
   ht->num_elts -= deleted;
@@ -478,6 +698,74 @@ void ht_divchn_pthread_delete(ht_divchn_pthread_t *ht,
   mutex_unlock_perror(&ht->gate_lock);
 }
 
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_divchn_pthread_stats_t) pointed to by s, and optionally
+   computes a histogram of chain lengths and copies the wait counts of key
+   locks. A wait of a key lock is counted if a thread found the lock
+   locked by another thread in an insert, remove, or delete operation, or
+   in a growth step. The counts of growth steps, moved keys, and waits,
+   and the processor time of growth steps, measured with clock and
+   including the processor time of other threads of the process during a
+   growth step, are accumulated since ht_divchn_pthread_init. The
+   operation is called before/after all threads started/completed insert,
+   read, remove, and delete operations on ht, and runs in O(count +
+   num_elts) time.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_divchn_pthread_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of slots with a chain
+                 of i keys for i < hist_count - 1, and hist[hist_count - 1]
+                 to the number of slots with a chain of >= hist_count - 1
+                 keys
+   hist_count  : > 0 if hist is not NULL
+   lock_waits  : - NULL if the wait counts of key locks are not copied
+                 - otherwise a pointer to an array of num_key_locks size_t
+                 values, i.e. 2**log_num_locks values, where the ith value
+                 is set to the wait count of the ith key lock that covers
+                 the slots with index i modulo num_key_locks
+*/
+void ht_divchn_pthread_stats(const ht_divchn_pthread_t *ht,
+			     ht_divchn_pthread_stats_t *s,
+			     size_t *hist,
+			     size_t hist_count,
+			     size_t *lock_waits){
+  size_t i, len;
+  const dll_node_t *node = NULL;
+  s->count = ht->count;
+  s->num_elts = ht->num_elts;
+  s->max_num_elts = ht->max_num_elts;
+  s->max_chain_len = 0;
+  s->num_grows = ht->num_grows;
+  s->num_moves = ht->num_moves;
+  s->resize_clocks = ht->resize_clocks;
+  s->num_key_locks = ht->key_locks_mask + 1;
+  s->num_key_lock_waits = 0;
+  for (i = 0; i <= ht->key_locks_mask; i++){
+    s->num_key_lock_waits += ht->key_lock_waits[i];
+    if (lock_waits != NULL) lock_waits[i] = ht->key_lock_waits[i];
+  }
+  if (hist != NULL){
+    for (i = 0; i < hist_count; i++){
+      hist[i] = 0;
+    }
+  }
+  for (i = 0; i < ht->count; i++){
+    len = 0;
+    node = ht->key_elts[i];
+    if (node != NULL){
+      do{
+	len++;
+	node = node->next;
+      }while (node != ht->key_elts[i]);
+    }
+    if (len > s->max_chain_len) s->max_chain_len = len;
+    if (hist != NULL) hist[(len < hist_count) ? len : hist_count - 1]++;
+  }
+}
+
 /**
    Frees a hash table. The operation is called after all threads completed
    insert, remove, delete, and search operations. Leaves a block of size
@@ -485,15 +773,37 @@ void ht_divchn_pthread_delete(ht_divchn_pthread_t *ht,
 */
 void ht_divchn_pthread_free(ht_divchn_pthread_t *ht){
   size_t i;
-  for (i = 0; i < ht->count; i++){
-    dll_free(ht->ll, &ht->key_elts[i], ht->free_elt);
+  if (ht->pools != NULL){
+    /* a node is freed into any pool because pools are freed together */
+    for (i = 0; i < ht->count; i++){
+      dll_free_pool(ht->ll, &ht->pools[i & ht->key_locks_mask],
+		    &ht->key_elts[i], ht->free_elt);
+    }
+    for (i = 0; i <= ht->key_locks_mask; i++){
+      dll_pool_free(&ht->pools[i]);
+    }
+    free(ht->pools);
+    ht->pools = NULL;
+  }else{
+    for (i = 0; i < ht->count; i++){
+      dll_free(ht->ll, &ht->key_elts[i], ht->free_elt);
+    }
   }
   free(ht->ll);
   free(ht->key_elts);
   free(ht->key_locks);
+  free(ht->key_lock_waits);
+  free(ht->reader_epochs_blk);
+  free(ht->key_seqs);
+  free(ht->slots);
   ht->ll = NULL;
   ht->key_elts = NULL;
   ht->key_locks = NULL;
+  ht->key_lock_waits = NULL;
+  ht->reader_epochs_blk = NULL;
+  ht->reader_epochs = NULL;
+  ht->key_seqs = NULL;
+  ht->slots = NULL;
 }
 
 /**
@@ -574,10 +884,14 @@ static size_t convert_std_key(const ht_divchn_pthread_t *ht,
 }
 
 /**
-   Maps a hash key to a slot index in a hash table with a division method. 
+   Maps a hash key to a slot index in a hash table with a division method,
+   where the division by the prime count is computed with its reciprocal.
 */
 static size_t hash(const ht_divchn_pthread_t *ht, const void *key){
-  return convert_std_key(ht, key) % ht->count;
+  return mod_rcp(convert_std_key(ht, key),
+		 ht->count,
+		 ht->count_mul,
+		 ht->count_shift);
 }
 
 /**
@@ -625,14 +939,29 @@ static void *reinsert_thread(void *arg){
   const reinsert_arg_t *ra = arg;
   for (i = ra->start; i < ra->start + ra->count; i++){
     head = &ra->prev_key_elts[i];
-    while (*head != NULL){
+    if (ra->ht->slots == NULL){
+      while (*head != NULL){
+	node = *head;
+	dll_remove(head, node);
+	ix = hash(ra->ht, dll_key_ptr(ra->ht->ll, node));
+	lock_ix = ix & ra->ht->key_locks_mask;
+	key_lock(ra->ht, lock_ix);
+	dll_prepend(&ra->ht->key_elts[ix], node);
+	mutex_unlock_perror(&ra->ht->key_locks[lock_ix]);
+      }
+    }else if (*head != NULL){
+      /* copy, because readers may traverse the previous chains */
       node = *head;
-      dll_remove(head, node);
-      ix = hash(ra->ht, dll_key_ptr(ra->ht->ll, node));
-      lock_ix = ix & ra->ht->key_locks_mask;
-      mutex_lock_perror(&ra->ht->key_locks[lock_ix]);
-      dll_prepend(&ra->ht->key_elts[ix], node);
-      mutex_unlock_perror(&ra->ht->key_locks[lock_ix]);
+      do{
+	ix = hash(ra->ht, dll_key_ptr(ra->ht->ll, node));
+	lock_ix = ix & ra->ht->key_locks_mask;
+	key_lock(ra->ht, lock_ix);
+	prepend_new(ra->ht, &ra->ht->key_elts[ix], lock_ix,
+		    dll_key_ptr(ra->ht->ll, node),
+		    dll_elt_ptr(ra->ht->ll, node));
+	mutex_unlock_perror(&ra->ht->key_locks[lock_ix]);
+	node = node->next;
+      }while (node != *head);
     }
   }
   return NULL;
@@ -643,16 +972,20 @@ static void ht_grow(ht_divchn_pthread_t *ht){
   size_t start = 0;
   size_t seg_count, rem_count;
   dll_node_t **prev_key_elts = ht->key_elts;
+  ht_divchn_pthread_slots_t *prev_slots = ht->slots, *slots = NULL;
   pthread_t *rids = NULL;
   reinsert_arg_t *ras = NULL;
   /* initialize next ht; num_elts can be used without lock */
   while (ht->num_elts > ht->max_num_elts && incr_count(ht));
   if (prev_count == ht->count) return; /* load factor not lowered */
+  ht->num_grows++;
+  ht->num_moves += ht->num_elts;
   rids = malloc_perror(ht->num_grow_threads, sizeof(pthread_t));
   ras = malloc_perror(ht->num_grow_threads, sizeof(reinsert_arg_t));
+  /* the offsets in ll are kept, because readers may access the nodes */
   ht->key_elts = malloc_perror(ht->count, sizeof(dll_node_t *));
   for (i = 0; i < ht->count; i++){
-    dll_init(ht->ll, &ht->key_elts[i], ht->key_size);
+    ht->key_elts[i] = NULL;
   }
   /* multithreaded reinsertion */
   seg_count = prev_count / ht->num_grow_threads;
@@ -669,10 +1002,31 @@ static void ht_grow(ht_divchn_pthread_t *ht){
   for (i = 0; i < ht->num_grow_threads; i++){
     thread_join_perror(rids[i], NULL);
   }
+  if (prev_slots != NULL){
+    /* publish the next slots, and free the previous after a grace period */
+    slots = malloc_perror(1, sizeof(ht_divchn_pthread_slots_t));
+    slots->count = ht->count;
+    slots->count_mul = ht->count_mul;
+    slots->count_shift = ht->count_shift;
+    slots->key_elts = ht->key_elts;
+    STORE_RELEASE(&ht->slots, slots);
+    grace_period(ht);
+    for (i = 0; i < prev_count; i++){
+      if (ht->pools != NULL){
+	dll_free_pool(ht->ll, &ht->pools[i & ht->key_locks_mask],
+		      &prev_key_elts[i], NULL);
+      }else{
+	dll_free(ht->ll, &prev_key_elts[i], NULL);
+      }
+    }
+    free(prev_slots);
+  }
   free(prev_key_elts);
   free(rids);
   free(ras);
   prev_key_elts = NULL;
+  prev_slots = NULL;
+  slots = NULL;
   rids = NULL;
   ras = NULL;
 }
@@ -695,6 +1049,7 @@ static int incr_count(ht_divchn_pthread_t *ht){
     return 0;
   }else{
     ht->count = build_prime(ht->count_ix, C_PARTS_PER_PRIME[ht->group_ix]);
+    mod_rcp_init(ht->count, &ht->count_mul, &ht->count_shift);
     /* 0 <= max_num_elts <= C_SIZE_MAX */
     ht->max_num_elts = mul_alpha_sz_max(ht->count,
 					ht->alpha_n,
@@ -733,6 +1088,187 @@ static size_t build_prime(size_t start, size_t count){
   return p;
 }
 
+/**
+   Searches a key in a chain under the lock of its slot. In a
+   read-optimized mode, the chain is not modified by the search, because
+   readers may traverse the chain at the same time.
+*/
+static dll_node_t *search_key(const ht_divchn_pthread_t *ht,
+			      dll_node_t **head,
+			      const void *key){
+  if (ht->slots != NULL){
+    return dll_search_uq_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+  }
+  return dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+}
+
+/**
+   Searches a key in a chain without a lock with atomic loads of the
+   links. Returns a pointer to the node with the key, or NULL if the key
+   was not found or the sequence number of the lock of the slot changed
+   from seq during the traversal, in which case the traversal may not
+   return to its first node and is repeated by the caller.
+*/
+static const dll_node_t *read_search_key(const ht_divchn_pthread_t *ht,
+					 dll_node_t * const *head,
+					 const void *key,
+					 size_t lock_ix,
+					 size_t seq){
+  const void *node_key = NULL;
+  const dll_node_t *first = LOAD_ACQUIRE(head), *node = first;
+  if (node == NULL) return NULL;
+  do{
+    node_key = dll_key_ptr(ht->ll, node);
+    if ((ht->cmp_key != NULL && ht->cmp_key(node_key, key) == 0) ||
+	(ht->cmp_key == NULL && memcmp(node_key, key, ht->key_size) == 0)){
+      return node;
+    }
+    node = LOAD_ACQUIRE(&node->next);
+  }while (node != first && LOAD_RELAXED(&ht->key_seqs[lock_ix]) == seq);
+  return NULL;
+}
+
+/**
+   Creates a node with a copy of a key and an element, and prepends the
+   node to a chain under the lock of its slot. In a read-optimized mode,
+   the node is initialized before it is linked with release stores, and a
+   reader that traverses the chain at the same time either finds the node
+   or not, and returns to its first node in both cases.
+*/
+static void prepend_new(const ht_divchn_pthread_t *ht,
+			dll_node_t **head,
+			size_t lock_ix,
+			const void *key,
+			const void *elt){
+  dll_node_t *node = NULL, *first = NULL;
+  dll_node_t **h = (ht->slots != NULL) ? &node : head;
+  if (ht->pools != NULL){
+    dll_prepend_new_pool(ht->ll, &ht->pools[lock_ix], h, key, elt,
+			 ht->key_size, ht->elt_size);
+  }else{
+    dll_prepend_new(ht->ll, h, key, elt, ht->key_size, ht->elt_size);
+  }
+  if (ht->slots == NULL) return;
+  first = *head;
+  if (first != NULL){
+    node->next = first;
+    node->prev = first->prev;
+    STORE_RELEASE(&first->prev->next, node);
+    first->prev = node;
+  }
+  STORE_RELEASE(head, node);
+}
+
+/**
+   In a read-optimized mode, unlinks a node from a chain under the lock of
+   its slot with release stores, and adds the node to a list of retired
+   nodes that is linked through the prev pointers. The next pointer of the
+   node is not modified, so that a reader at the node continues its
+   traversal.
+*/
+static void unlink_retire(const ht_divchn_pthread_t *ht,
+			  dll_node_t **head,
+			  dll_node_t *node,
+			  size_t lock_ix,
+			  dll_node_t **retired){
+  seq_begin(ht, lock_ix);
+  if (node->next == node){
+    STORE_RELEASE(head, NULL);
+  }else{
+    STORE_RELEASE(&node->prev->next, node->next);
+    node->next->prev = node->prev;
+    if (*head == node) STORE_RELEASE(head, node->next);
+  }
+  seq_end(ht, lock_ix);
+  node->prev = *retired;
+  *retired = node;
+}
+
+/**
+   Frees a list of retired nodes after a grace period. In a pool
+   allocation mode, a node is returned to the pool of its lock.
+*/
+static void reclaim(ht_divchn_pthread_t *ht,
+		    dll_node_t *retired,
+		    void (*free_elt)(void *)){
+  size_t lock_ix;
+  dll_node_t *head = NULL, *node = NULL;
+  if (retired == NULL) return;
+  grace_period(ht);
+  while (retired != NULL){
+    node = retired;
+    retired = retired->prev;
+    /* delete the node from a list of one node */
+    node->next = node;
+    node->prev = node;
+    head = node;
+    if (ht->pools != NULL){
+      lock_ix = hash(ht, dll_key_ptr(ht->ll, node)) & ht->key_locks_mask;
+      key_lock(ht, lock_ix);
+      dll_delete_pool(ht->ll, &ht->pools[lock_ix], &head, node, free_elt);
+      mutex_unlock_perror(&ht->key_locks[lock_ix]);
+    }else{
+      dll_delete(ht->ll, &head, node, free_elt);
+    }
+  }
+}
+
+/**
+   Waits until each read operation that started before the call is
+   completed. The epoch is odd and is incremented by 2, so that a reader
+   epoch of 0 denotes a reader outside of a read operation, and a reader
+   that announced the incremented or a later epoch started after the call
+   and is not waited for.
+*/
+static void grace_period(ht_divchn_pthread_t *ht){
+  size_t i, e, r;
+  e = __atomic_add_fetch(&ht->epoch, 2, __ATOMIC_SEQ_CST);
+  FENCE_SEQ_CST();
+  for (i = 0; i < ht->num_readers; i++){
+    while ((r = LOAD_ACQUIRE(reader_epoch(ht, i))) != 0 &&
+	   e - r - 1 < C_SIZE_MAX / 2){
+      sched_yield();
+    }
+  }
+}
+
+/**
+   Begins and ends a modification of a chain or an element under a key
+   lock in a read-optimized mode, by making the sequence number of the
+   lock odd and even again. A reader repeats its search if the sequence
+   number was odd or changed during the search.
+*/
+
+static void seq_begin(const ht_divchn_pthread_t *ht, size_t lock_ix){
+  if (ht->key_seqs == NULL) return;
+  STORE_RELAXED(&ht->key_seqs[lock_ix], ht->key_seqs[lock_ix] + 1);
+  FENCE_RELEASE();
+}
+
+static void seq_end(const ht_divchn_pthread_t *ht, size_t lock_ix){
+  if (ht->key_seqs == NULL) return;
+  STORE_RELEASE(&ht->key_seqs[lock_ix], ht->key_seqs[lock_ix] + 1);
+}
+
+/**
+   Returns a pointer to the epoch of the ith reader, which is followed by
+   the elt_size block of the reader.
+*/
+static size_t *reader_epoch(const ht_divchn_pthread_t *ht, size_t i){
+  return (size_t *)((char *)ht->reader_epochs + i * ht->reader_epoch_size);
+}
+
+/**
+   Locks a key lock, and counts a wait under the lock if the lock was
+   locked by another thread.
+*/
+static void key_lock(const ht_divchn_pthread_t *ht, size_t lock_ix){
+  if (!mutex_trylock_perror(&ht->key_locks[lock_ix])){
+    mutex_lock_perror(&ht->key_locks[lock_ix]);
+    ht->key_lock_waits[lock_ix]++;
+  }
+}
+
 /**
    Computes a pointer to the ith element of size size in a block.
 */
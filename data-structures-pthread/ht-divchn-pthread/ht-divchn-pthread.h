@@ -40,10 +40,29 @@
      exceeded**, or iii) after the hash table reaches its maximum count of
      slots on a given system and alpha no longer bounds the load factor.
 
+   In a read-optimized mode, set by ht_divchn_pthread_readers, threads
+   call read operations concurrently with insert, remove, and/or delete
+   operations. A reader does not lock or allocate memory, does not access
+   the gate of a hash table, and does not wait for a growth step. A reader
+   announces the epoch of the hash table in its own cache line, which also
+   holds its copy of an element until the copy is validated, loads the
+   published array of slots, and traverses a chain with atomic loads of
+   its links. A writer modifies a chain under the lock of its slot between
+   two increments of a sequence number of the lock, and a reader yields
+   while the sequence number is odd and repeats the traversal of a chain
+   if the sequence number changed. A removed or deleted node is freed
+   after a grace period, i.e. after each reader was found outside of a
+   read operation or in an operation that started after the removal, so
+   that a reader never accesses a freed node. A growth step copies the
+   keys and elements into new chains, publishes the new array of slots,
+   and frees the previous array and nodes after a grace period.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99. The requirements are: i) CHAR_BIT * sizeof(size_t) is greater
    or equal to 16 and is even (every bit is required to participate
-   in the value at this time), and ii) pthreads API is available.
+   in the value at this time), ii) pthreads API is available, and iii) the
+   __atomic builtins of GCC and Clang are available, which access the
+   links of the nodes of the chains, which are not of an atomic type.
 
    * unless the growth step that follows does not lower the load factor
    below alpha because the maximum count of slots is reached during the
@@ -59,11 +78,25 @@
 #define _XOPEN_SOURCE 600
 
 #include <stddef.h>
+#include <time.h>
 #include <pthread.h>
 #include "dll.h"
 
+/**
+   The alignment of each reader epoch in memory, so that the epochs of
+   different readers are not in the same cache line on current systems.
+*/
+#define HT_DIVCHN_PTHREAD_ALIGNMENT 64
+
 typedef enum{FALSE, TRUE} boolean_t;
 
+typedef struct{
+  size_t count;
+  size_t count_mul;
+  size_t count_shift;
+  dll_node_t **key_elts;
+} ht_divchn_pthread_slots_t; /* array of slots published to readers */
+
 typedef struct{
   /* hash table */
   size_t key_size;
@@ -72,6 +105,8 @@ typedef struct{
   size_t group_ix;
   size_t count_ix; /* max size_t value if last representable prime reached */
   size_t count;
+  size_t count_mul; /* reciprocal multiplier of count for mod_rcp */
+  size_t count_shift;
   size_t max_num_elts; /*  >= 0, <= C_SIZE_MAX, represents alpha */
   size_t num_elts;
   size_t alpha_n;
@@ -88,6 +123,20 @@ typedef struct{
   pthread_mutex_t *key_locks; /* locks, each covering a subset of slots */
   pthread_cond_t gate_open_cond;
   pthread_cond_t grow_cond;
+  size_t num_readers;
+  size_t reader_epoch_size; /* multiple of HT_DIVCHN_PTHREAD_ALIGNMENT */
+  void *reader_epochs_blk; /* allocated block containing reader_epochs */
+  void *reader_epochs; /* size_t epoch, 0 if not reading, and elt block */
+  size_t epoch; /* odd, incremented by 2 at the start of a grace period */
+  size_t *key_seqs; /* per key lock, odd while a chain is modified */
+  ht_divchn_pthread_slots_t *slots; /* NULL if not read-optimized */
+  dll_pool_t *pools; /* NULL or a pool per key lock */
+
+  /* statistics */
+  size_t num_grows;
+  size_t num_moves; /* keys moved to next slots by growth steps */
+  clock_t resize_clocks; /* processor time of growth steps */
+  size_t *key_lock_waits; /* per key lock, updated under the lock */
 
   /* function pointers */
   int (*cmp_key)(const void *, const void *);
@@ -96,6 +145,18 @@ typedef struct{
   void (*free_elt)(void *);
 } ht_divchn_pthread_t;
 
+typedef struct{
+  size_t count;
+  size_t num_elts;
+  size_t max_num_elts;
+  size_t max_chain_len;
+  size_t num_grows;
+  size_t num_moves;
+  clock_t resize_clocks; /* divided by CLOCKS_PER_SEC to obtain seconds */
+  size_t num_key_locks;
+  size_t num_key_lock_waits; /* total across key locks */
+} ht_divchn_pthread_stats_t;
+
 /**
    Initializes a hash table. The initialization operation is called and
    must return before any thread calls insert, remove, and/or delete,
@@ -189,6 +250,37 @@ void ht_divchn_pthread_init(ht_divchn_pthread_t *ht,
 */
 void ht_divchn_pthread_align_elt(ht_divchn_pthread_t *ht, size_t alignment);
 
+/**
+   Sets a read-optimized mode of a hash table for num_readers reader
+   threads, each calling ht_divchn_pthread_read with a distinct reader_ix
+   value in [0, num_readers). The operation is optionally called after
+   ht_divchn_pthread_init is completed and before any other operation is
+   called.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   num_readers : > 0 number of reader threads
+*/
+void ht_divchn_pthread_readers(ht_divchn_pthread_t *ht, size_t num_readers);
+
+/**
+   Sets a pool allocation mode of a hash table. In the mode, the nodes of
+   the chains are allocated from pools in blocks of nodes, one pool per key
+   lock, and a pool is only accessed by a thread holding its lock. The
+   nodes of removed and deleted keys are reused by subsequent insert
+   operations, and all nodes are freed at once when the hash table is
+   freed, instead of a malloc and free call per key under a lock. The
+   mode is effective if the expected number of keys per lock is large
+   relative to a block of nodes (e.g. 16 nodes). The operation is
+   optionally called after ht_divchn_pthread_init and
+   ht_divchn_pthread_align_elt are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   min_num     : minimum number of keys that are known or expected to become
+                 present simultaneously in a hash table, resulting in fewer
+                 allocations of blocks of nodes at the beginning; 0 if a
+                 positive value is not specified
+*/
+void ht_divchn_pthread_pool(ht_divchn_pthread_t *ht, size_t min_num);
+
 /**
    Inserts a batch of keys and associated elements into a hash table.
    The batch_keys and batch_elts parameters are not NULL and point to
@@ -211,6 +303,26 @@ void ht_divchn_pthread_insert(ht_divchn_pthread_t *ht,
 void *ht_divchn_pthread_search(const ht_divchn_pthread_t *ht,
 			       const void *key);
 
+/**
+   Copies the elements or its pointers, associated with a batch of keys in
+   a hash table, into the array of elt_size blocks pointed to by batch_elts,
+   and returns the number of keys found in the hash table. If a key is not
+   in the hash table, leaves the corresponding elt_size block unchanged.
+   The operation is called concurrently with insert, remove, delete, and
+   read operations in a read-optimized mode. The batch_keys and batch_elts
+   parameters are not NULL and point to arrays of blocks of size key_size
+   and elt_size respectively. The batch_count parameter is the count of keys
+   in a batch. The reader_ix parameter is the index of the calling reader
+   thread. If a pointer to an element is copied into an elt_size block,
+   the element may be concurrently deleted by another thread unless the
+   deletion is otherwise synchronized by the user.
+*/
+size_t ht_divchn_pthread_read(const ht_divchn_pthread_t *ht,
+			      const void *batch_keys,
+			      void *batch_elts,
+			      size_t batch_count,
+			      size_t reader_ix);
+
 /**
    Removes a batch of keys and associated elements from a hash table by
    copying the elements or its pointers into the array of elt_size blocks
@@ -236,6 +348,41 @@ void ht_divchn_pthread_delete(ht_divchn_pthread_t *ht,
 			      const void *batch_keys,
 			      size_t batch_count);
 
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_divchn_pthread_stats_t) pointed to by s, and optionally
+   computes a histogram of chain lengths and copies the wait counts of key
+   locks. A wait of a key lock is counted if a thread found the lock
+   locked by another thread in an insert, remove, or delete operation, or
+   in a growth step. The counts of growth steps, moved keys, and waits,
+   and the processor time of growth steps, measured with clock and
+   including the processor time of other threads of the process during a
+   growth step, are accumulated since ht_divchn_pthread_init. The
+   operation is called before/after all threads started/completed insert,
+   read, remove, and delete operations on ht, and runs in O(count +
+   num_elts) time.
+   ht          : pointer to an initialized ht_divchn_pthread_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_divchn_pthread_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of slots with a chain
+                 of i keys for i < hist_count - 1, and hist[hist_count - 1]
+                 to the number of slots with a chain of >= hist_count - 1
+                 keys
+   hist_count  : > 0 if hist is not NULL
+   lock_waits  : - NULL if the wait counts of key locks are not copied
+                 - otherwise a pointer to an array of num_key_locks size_t
+                 values, i.e. 2**log_num_locks values, where the ith value
+                 is set to the wait count of the ith key lock that covers
+                 the slots with index i modulo num_key_locks
+*/
+void ht_divchn_pthread_stats(const ht_divchn_pthread_t *ht,
+			     ht_divchn_pthread_stats_t *s,
+			     size_t *hist,
+			     size_t hist_count,
+			     size_t *lock_waits);
+
 /**
    Frees a hash table. The operation is called after all threads completed
    insert, remove, delete, and search operations. Leaves a block of size
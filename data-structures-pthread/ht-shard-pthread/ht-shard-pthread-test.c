@@ -0,0 +1,407 @@
+/**
+   ht-shard-pthread-test.c
+
+   Tests of a sharded hash table with generic hash keys and generic
+   elements that is concurrently accessible and modifiable, across the
+   multiplication-based and division-based hash tables as shards.
+
+   The following command line arguments can be used to customize tests:
+   ht-shard-pthread-test
+      [0, # bits in size_t - 1) : i s.t. # inserts = 2**i
+      [0, # bits in size_t) : j s.t. 2**0 <= # shards <= 2**j
+      > 0 : # threads
+      > 0 : batch count
+      [0, 1] : on/off insert search remove delete test
+      [0, 1] : on/off reduction test
+
+   usage examples:
+   ./ht-shard-pthread-test
+   ./ht-shard-pthread-test 20
+   ./ht-shard-pthread-test 20 8 8 4096
+   ./ht-shard-pthread-test 16 4 4 1 0 1
+
+   ht-shard-pthread-test can be run with any subset of command line
+   arguments in the above-defined order. If the (i + 1)th argument is
+   specified then the ith argument must be specified for i >= 0. Default
+   values are used for the unspecified arguments according to the
+   C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99. The requirements are: i) CHAR_BIT * sizeof(size_t) is
+   greater or equal to 16 and is even, and ii) pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/time.h>
+#include "ht-shard-pthread.h"
+#include "ht-divchn.h"
+#include "ht-muloa.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+#include "utilities-pthread.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "ht-shard-pthread-test\n"
+  "[0, # bits in size_t - 1) : i s.t. # inserts = 2**i\n"
+  "[0, # bits in size_t) : j s.t. 2**0 <= # shards <= 2**j\n"
+  "> 0 : # threads\n"
+  "> 0 : batch count\n"
+  "[0, 1] : on/off insert search remove delete test\n"
+  "[0, 1] : on/off reduction test\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {18, 6, 4, 1024, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* shard types */
+typedef struct{
+  const char *name;
+  size_t alpha_n;
+  size_t log_alpha_d;
+  ht_shard_pthread_ops_t ops;
+} shard_type_t;
+
+const size_t C_SHARD_TYPES_COUNT = 2;
+const shard_type_t C_SHARD_TYPES[2] = {
+  {"ht_muloa", 16384, 15,
+   {sizeof(ht_muloa_t),
+    ht_muloa_init_helper,
+    ht_muloa_align_helper,
+    ht_muloa_insert_helper,
+    ht_muloa_search_helper,
+    ht_muloa_remove_helper,
+    ht_muloa_delete_helper,
+    ht_muloa_free_helper}},
+  {"ht_divchn", 1, 0,
+   {sizeof(ht_divchn_t),
+    ht_divchn_init_helper,
+    ht_divchn_align_helper,
+    ht_divchn_insert_helper,
+    ht_divchn_search_helper,
+    ht_divchn_remove_helper,
+    ht_divchn_delete_helper,
+    ht_divchn_free_helper}}};
+
+/* step of log base 2 # shards in the insert search remove delete test */
+const size_t C_LOG_SHARDS_STEP = 2;
+
+void print_test_result(int res);
+double timer();
+
+/**
+   Threads running batch operations on segments of an array of keys.
+*/
+
+typedef enum{INSERT, REMOVE, DELETE} op_t;
+
+typedef struct{
+  size_t start;
+  size_t count;
+  size_t batch_count;
+  op_t op;
+  const size_t *keys;
+  size_t *elts;
+  ht_shard_pthread_t *ht;
+} op_arg_t;
+
+void *op_thread(void *arg){
+  size_t i, n;
+  const size_t *k = NULL;
+  size_t *e = NULL;
+  const op_arg_t *oa = arg;
+  for (i = 0; i < oa->count; i += n){
+    n = oa->count - i;
+    if (n > oa->batch_count) n = oa->batch_count;
+    k = oa->keys + oa->start + i;
+    if (oa->elts != NULL) e = oa->elts + oa->start + i;
+    if (oa->op == INSERT){
+      ht_shard_pthread_insert(oa->ht, k, e, n);
+    }else if (oa->op == REMOVE){
+      ht_shard_pthread_remove(oa->ht, k, e, n);
+    }else{
+      ht_shard_pthread_delete(oa->ht, k, n);
+    }
+  }
+  return NULL;
+}
+
+/**
+   Runs an operation on count keys and elements with num_threads threads,
+   each on a segment of keys, or on all keys if is_all is 1. Returns the
+   wall-clock runtime in seconds.
+*/
+double run_op(ht_shard_pthread_t *ht,
+	      const size_t *keys,
+	      size_t *elts,
+	      size_t count,
+	      size_t num_threads,
+	      size_t batch_count,
+	      op_t op,
+	      int is_all){
+  size_t i;
+  size_t seg_count, rem_count;
+  size_t start = 0;
+  double t;
+  pthread_t *ids = NULL;
+  op_arg_t *oas = NULL;
+  ids = malloc_perror(num_threads, sizeof(pthread_t));
+  oas = malloc_perror(num_threads, sizeof(op_arg_t));
+  seg_count = count / num_threads;
+  rem_count = count % num_threads; /* distribute among threads */
+  for (i = 0; i < num_threads; i++){
+    oas[i].start = start;
+    oas[i].count = seg_count;
+    oas[i].count += (rem_count > 0 && rem_count--);
+    if (is_all){
+      oas[i].start = 0;
+      oas[i].count = count;
+    }
+    oas[i].batch_count = batch_count;
+    oas[i].op = op;
+    oas[i].keys = keys;
+    oas[i].elts = elts;
+    if (is_all) oas[i].elts = elts + i * count; /* per thread */
+    oas[i].ht = ht;
+    start += oas[i].count;
+  }
+  t = timer();
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&ids[i], op_thread, &oas[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  t = timer() - t;
+  free(ids);
+  free(oas);
+  ids = NULL;
+  oas = NULL;
+  return t;
+}
+
+/**
+   Initializes count distinct random even keys and their elements.
+*/
+void keys_elts_init(size_t *keys, size_t *elts, size_t count){
+  size_t i;
+  for (i = 0; i < count; i++){
+    keys[i] = 2 * ((size_t)RANDOM() * count + i);
+    elts[i] = i;
+  }
+}
+
+/**
+   Runs a ht_shard_pthread_{insert, search, remove, delete} test on
+   distinct size_t keys and size_t elements across shard types and
+   numbers of shards.
+*/
+void run_insert_remove_test(size_t log_ins,
+			    size_t log_shards_end,
+			    size_t num_threads,
+			    size_t batch_count){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_ins;
+  size_t key;
+  size_t *keys = NULL, *elts = NULL, *rem_elts = NULL;
+  size_t *p = NULL;
+  double t_ins, t_rem, t_del;
+  const shard_type_t *st = NULL;
+  ht_shard_pthread_t ht;
+  ht_shard_pthread_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  elts = malloc_perror(num_ins, sizeof(size_t));
+  rem_elts = malloc_perror(num_ins, sizeof(size_t));
+  keys_elts_init(keys, elts, num_ins);
+  printf("Run a ht_shard_pthread_{insert, search, remove, delete} test on "
+	 "distinct size_t keys and size_t elements\n");
+  printf("\t# inserts: %lu, # threads: %lu, batch count: %lu\n",
+	 TOLU(num_ins), TOLU(num_threads), TOLU(batch_count));
+  for (i = 0; i < C_SHARD_TYPES_COUNT; i++){
+    st = &C_SHARD_TYPES[i];
+    printf("\t%s shards, load factor upper bound: %.4f\n",
+	   st->name, (float)st->alpha_n / pow_two_perror(st->log_alpha_d));
+    for (j = 0; j <= log_shards_end; j += C_LOG_SHARDS_STEP){
+      ht_shard_pthread_init(&ht,
+			    sizeof(size_t),
+			    sizeof(size_t),
+			    0,
+			    st->alpha_n,
+			    st->log_alpha_d,
+			    j,
+			    &st->ops,
+			    NULL,
+			    NULL,
+			    NULL,
+			    NULL);
+      ht_shard_pthread_align(&ht, sizeof(size_t));
+      t_ins = run_op(&ht, keys, elts, num_ins, num_threads, batch_count,
+		     INSERT, 0);
+      for (k = 0; k < num_ins; k++){
+	p = ht_shard_pthread_search(&ht, &keys[k]);
+	res *= (p != NULL && *p == elts[k]);
+	key = keys[k] + 1;
+	res *= (ht_shard_pthread_search(&ht, &key) == NULL);
+      }
+      memset(rem_elts, 0, num_ins * sizeof(size_t));
+      t_rem = run_op(&ht, keys, rem_elts, num_ins / 2, num_threads,
+		     batch_count, REMOVE, 0);
+      t_del = run_op(&ht, keys + num_ins / 2, NULL, num_ins - num_ins / 2,
+		     num_threads, batch_count, DELETE, 0);
+      for (k = 0; k < num_ins; k++){
+	if (k < num_ins / 2) res *= (rem_elts[k] == elts[k]);
+	res *= (ht_shard_pthread_search(&ht, &keys[k]) == NULL);
+      }
+      ht_shard_pthread_stats(&ht, &s, NULL);
+      printf("\t\t# shards: %lu\n"
+	     "\t\t\tinsert time:                 %.4f seconds\n"
+	     "\t\t\tremove time:                 %.4f seconds\n"
+	     "\t\t\tdelete time:                 %.4f seconds\n"
+	     "\t\t\tshard lock waits:            %lu\n",
+	     TOLU(s.num_shards), t_ins, t_rem, t_del,
+	     TOLU(s.num_lock_waits));
+      ht_shard_pthread_free(&ht);
+    }
+  }
+  printf("\tcorrectness:                         ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  free(rem_elts);
+  keys = NULL;
+  elts = NULL;
+  rem_elts = NULL;
+}
+
+/**
+   Runs a test of concurrent inserts of the same keys by all threads with
+   an add reduction of elements across shard types.
+*/
+
+void add_elts(void *ht_elt, const void *elt, size_t elt_size){
+  (void)elt_size;
+  *(size_t *)ht_elt += *(const size_t *)elt;
+}
+
+void run_rdc_test(size_t log_ins,
+		  size_t log_num_shards,
+		  size_t num_threads,
+		  size_t batch_count){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t *keys = NULL, *elts = NULL, *p = NULL;
+  double t;
+  const shard_type_t *st = NULL;
+  ht_shard_pthread_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  elts = malloc_perror(mul_sz_perror(num_ins, num_threads), sizeof(size_t));
+  keys_elts_init(keys, elts, num_ins);
+  for (i = 0; i < num_ins * num_threads; i++){
+    elts[i] = i / num_ins + 1; /* thread j inserts j + 1 per key */
+  }
+  printf("Run a ht_shard_pthread_insert test with a reduction of elements "
+	 "of the same keys across threads\n");
+  printf("\t# keys: %lu, # threads: %lu, batch count: %lu, # shards: %lu\n",
+	 TOLU(num_ins), TOLU(num_threads), TOLU(batch_count),
+	 TOLU(pow_two_perror(log_num_shards)));
+  for (i = 0; i < C_SHARD_TYPES_COUNT; i++){
+    st = &C_SHARD_TYPES[i];
+    ht_shard_pthread_init(&ht,
+			  sizeof(size_t),
+			  sizeof(size_t),
+			  num_ins,
+			  st->alpha_n,
+			  st->log_alpha_d,
+			  log_num_shards,
+			  &st->ops,
+			  NULL,
+			  NULL,
+			  add_elts,
+			  NULL);
+    ht_shard_pthread_align(&ht, sizeof(size_t));
+    t = run_op(&ht, keys, elts, num_ins, num_threads, batch_count,
+	       INSERT, 1);
+    for (j = 0; j < num_ins; j++){
+      p = ht_shard_pthread_search(&ht, &keys[j]);
+      res *= (p != NULL && *p == num_threads * (num_threads + 1) / 2);
+    }
+    printf("\t\t%s shards, insert time:    %.4f seconds\n", st->name, t);
+    ht_shard_pthread_free(&ht);
+  }
+  printf("\tcorrectness:                         ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  keys = NULL;
+  elts = NULL;
+}
+
+/**
+   Prints a test result.
+*/
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > C_FULL_BIT - 1 ||
+      args[2] < 1 ||
+      args[3] < 1 ||
+      args[4] > 1 ||
+      args[5] > 1){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[4]) run_insert_remove_test(args[0], args[1], args[2], args[3]);
+  if (args[5]) run_rdc_test(args[0], args[1], args[2], args[3]);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,490 @@
+/**
+   ht-shard-pthread.c
+
+   A sharded hash table with generic hash keys and generic elements that is
+   concurrently accessible and modifiable.
+
+   The keys are routed by the high bits of a multiplication-based hash
+   value to 2**log_num_shards independent shards. A shard is a
+   single-threaded hash table (e.g. ht_muloa_t or ht_divchn_t), accessed
+   through its helper functions, and a mutex lock. A thread holds at most
+   one shard lock at a time, and a shard grows under its lock
+   independently from other shards, so that a growth step only blocks the
+   threads that access the shard.
+
+   A hash key is an object within a contiguous block of memory (e.g. a basic
+   type, array, struct). If the key size is greater than sizeof(size_t)
+   bytes, then it is reduced to a sizeof(size_t)-byte block prior to
+   routing. An element is within a contiguous or noncontiguous block of
+   memory.
+
+   A batch operation sorts the keys of a batch by shard with a radix sort,
+   and visits each shard with keys once. In the first pass over the shards,
+   a shard lock is acquired with a trylock call, and a locked shard is
+   visited in the second pass with a blocking call, so that threads with
+   keys in the same shards do not wait in a convoy.
+
+   A hash table is modified by threads calling insert, remove, and/or delete
+   operations concurrently. The design provides the following guarantees
+   with respect to the final set of key-element pairs in a hash table after
+   all operations are completed:
+     - a single final set is guaranteed with respect to concurrent insert,
+     remove, and/or delete operations if the sets of keys used by threads
+     are disjoint,
+     - if insert operations are called by more than one thread concurrently
+     and the sets of keys used by threads are not disjoint, then a single
+     final set is guaranteed according to a user-defined reduction function
+     (e.g. min, max, add, multiply, and, or, xor of key-associated
+     elements).
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99. The requirements are: i) CHAR_BIT * sizeof(size_t) is greater
+   or equal to 16 and is even, and ii) pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "ht-shard-pthread.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+#include "utilities-pthread.h"
+
+/**
+   16-bit parts of the 64-bit multiplier of Fibonacci hashing, from the
+   most significant part, used to build an odd multiplier for routing.
+*/
+static const size_t C_SHARD_MUL_PARTS[4] = {0x9e37u,
+					    0x79b9u,
+					    0x7f4au,
+					    0x7c15u};
+static const size_t C_SHARD_MUL_PART_BIT = 16;
+static const size_t C_BYTE_BIT = CHAR_BIT;
+static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* digits of the radix sort of the keys of a batch by shard */
+enum{C_RADIX_BIT = 8, C_RADIX_COUNT = 256};
+
+typedef enum{INSERT, REMOVE, DELETE} op_t;
+
+typedef struct{
+  size_t shard;
+  size_t ix; /* index of a key in a batch */
+} route_t;
+
+static void batch_op(ht_shard_pthread_t *ht,
+		     const void *batch_keys,
+		     void *batch_elts,
+		     size_t batch_count,
+		     op_t op);
+static void shard_op(ht_shard_pthread_t *ht,
+		     const route_t *rs,
+		     size_t count,
+		     const char *keys,
+		     char *elts,
+		     op_t op);
+static void sort_routes(route_t *rs,
+			route_t *buf,
+			size_t count,
+			size_t log_num_shards);
+static size_t shard_ix(const ht_shard_pthread_t *ht, const void *key);
+static size_t convert_std_key(const ht_shard_pthread_t *ht, const void *key);
+
+/**
+   Initializes a sharded hash table. The initialization operation is
+   called and must return before any thread calls insert, remove, and/or
+   delete, or search operation.
+   ht               : a pointer to a preallocated block of size
+                      sizeof(ht_shard_pthread_t).
+   key_size         : non-zero size of a key object
+   elt_size         : - non-zero size of an element, if the element is
+                      within a contiguous memory block and a copy of the
+                      element is inserted,
+                      - size of a pointer to an element, if the element
+                      is within a noncontiguous memory block or a pointer to
+                      a contiguous element is inserted
+   min_num          : minimum number of keys that are known or expected to
+                      become present simultaneously in a hash table, divided
+                      among the shards; 0 if a positive value is not
+                      specified
+   alpha_n          : > 0 numerator of load factor upper bound of a shard
+   log_alpha_d      : < CHAR_BIT * sizeof(size_t) log base 2 of denominator
+                      of load factor upper bound of a shard, according to
+                      the hash table of a shard
+   log_num_shards   : < CHAR_BIT * sizeof(size_t) log base 2 number of
+                      shards; a larger number reduces the probability that
+                      threads access the same shard at the expense of space
+   ops              : pointer to a struct with the size of the hash table
+                      struct of a shard and its op helpers; the struct is
+                      copied
+   cmp_key          : - if NULL then a default memcmp-based comparison of
+                      keys is performed
+                      - otherwise comparison function is applied which
+                      returns a zero integer value iff the two keys accessed
+                      through the first and the second arguments are equal;
+                      each argument is a pointer to a key_size block
+   rdc_key          : - if NULL then a default conversion of a bit pattern
+                      in the block pointed to by key is performed prior to
+                      routing and hashing, which may introduce regularities
+                      - otherwise rdc_key is applied to a key prior to
+                      routing and hashing; the first argument points to a key
+                      and the second argument provides the size of the key
+   rdc_elts         : - NULL, if a key is in the hash table when the key is
+                      inserted, the key-associated element in the hash table
+                      is updated to the inserted element
+                      - non-NULL, if a key is in the hash table when the
+                      key is inserted, performs a reduction of the element
+                      already in the hash table and the inserted element;
+                      the result of the reduction is associated with the key
+                      in the hash table; the first argument points to an
+                      elt_size-sized block in the hash table, the second
+                      argument points to an elt_size-sized block of the
+                      inserted element, and the third argument is equal to a
+                      elt_size value
+   free_elt         : - if an element is within a contiguous memory block and
+                      a copy of the element was inserted, then NULL as
+                      free_elt is sufficient to delete the element,
+                      - if an element is within a noncontiguous memory block
+                      or a pointer to a contiguous element was inserted, then
+                      an element-specific free_elt, taking a pointer to a
+                      pointer to an element as its argument and leaving a
+                      block of size elt_size pointed to by the argument, is
+                      necessary to delete the element
+*/
+void ht_shard_pthread_init(ht_shard_pthread_t *ht,
+			   size_t key_size,
+			   size_t elt_size,
+			   size_t min_num,
+			   size_t alpha_n,
+			   size_t log_alpha_d,
+			   size_t log_num_shards,
+			   const ht_shard_pthread_ops_t *ops,
+			   int (*cmp_key)(const void *, const void *),
+			   size_t (*rdc_key)(const void *, size_t),
+			   void (*rdc_elts)(void *, const void *, size_t),
+			   void (*free_elt)(void *)){
+  size_t i;
+  size_t shard_min_num;
+  ht_shard_pthread_shard_t *s = NULL;
+  ht->key_size = key_size;
+  ht->elt_size = elt_size;
+  ht->log_num_shards = log_num_shards;
+  ht->num_shards = pow_two_perror(log_num_shards);
+  ht->shard_mul = 0;
+  for (i = 0; i < C_FULL_BIT; i += C_SHARD_MUL_PART_BIT){
+    /* two shifts to remain below the width of size_t */
+    ht->shard_mul = ((ht->shard_mul << C_BYTE_BIT) << C_BYTE_BIT) +
+      C_SHARD_MUL_PARTS[(i / C_SHARD_MUL_PART_BIT) % 4];
+  }
+  ht->shard_mul |= 1;
+  ht->ops = *ops;
+  ht->rdc_key = rdc_key;
+  ht->rdc_elts = rdc_elts;
+  shard_min_num = min_num / ht->num_shards +
+    (min_num % ht->num_shards > 0);
+  ht->shards = malloc_perror(ht->num_shards,
+			     sizeof(ht_shard_pthread_shard_t));
+  for (i = 0; i < ht->num_shards; i++){
+    s = &ht->shards[i];
+    mutex_init_perror(&s->lock);
+    s->ht = malloc_perror(1, ops->ht_size);
+    s->num_lock_waits = 0;
+    ops->init(s->ht,
+	      key_size,
+	      elt_size,
+	      shard_min_num,
+	      alpha_n,
+	      log_alpha_d,
+	      cmp_key,
+	      rdc_key,
+	      free_elt);
+  }
+}
+
+/**
+   Aligns each in-table elt_size block according to the align helper of
+   the hash table of a shard. The operation is optionally called after
+   ht_shard_pthread_init is completed and before any other operation is
+   called.
+   ht            : pointer to an initialized ht_shard_pthread_t struct
+   elt_alignment : alignment requirement or size of the type, a pointer to
+                   which is used to access an elt_size block
+*/
+void ht_shard_pthread_align(ht_shard_pthread_t *ht, size_t elt_alignment){
+  size_t i;
+  for (i = 0; i < ht->num_shards; i++){
+    ht->ops.align(ht->shards[i].ht, elt_alignment);
+  }
+}
+
+/**
+   Inserts a batch of keys and associated elements into a hash table.
+   The batch_keys and batch_elts parameters are not NULL and point to
+   arrays of blocks of size key_size and elt_size respectively. The
+   batch_count parameter is the count of keys in a batch. The keys of a
+   batch are grouped by shard, and the lock of each shard with keys is
+   acquired once. A shard that is locked by another thread is visited
+   after the other shards of the batch. See also the specification of
+   rdc_elts in ht_shard_pthread_init.
+*/
+void ht_shard_pthread_insert(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     const void *batch_elts,
+			     size_t batch_count){
+  batch_op(ht, batch_keys, (void *)batch_elts, batch_count, INSERT);
+}
+
+/**
+   If a key is present in a hash table, returns a pointer to its associated
+   element, otherwise returns NULL. The key parameter is not NULL.
+   The operation is called before/after all threads started/completed
+   insert, remove, and delete operations on ht and does not require
+   thread synchronization overhead.
+*/
+void *ht_shard_pthread_search(const ht_shard_pthread_t *ht,
+			      const void *key){
+  return ht->ops.search(ht->shards[shard_ix(ht, key)].ht, key);
+}
+
+/**
+   Removes a batch of keys and associated elements from a hash table by
+   copying the elements or its pointers into the array of elt_size blocks
+   pointed to by batch_elts. If a key is not in the hash table, leaves the
+   corresponding elt_size block unchanged. The batch_keys and batch_elts
+   parameters are not NULL and point to arrays of blocks of size key_size and
+   elt_size respectively. The batch_count parameter is the count of keys in a
+   batch. The shards are visited according to ht_shard_pthread_insert.
+*/
+void ht_shard_pthread_remove(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     void *batch_elts,
+			     size_t batch_count){
+  batch_op(ht, batch_keys, batch_elts, batch_count, REMOVE);
+}
+
+/**
+   Deletes a batch of keys and associated elements from a hash table.
+   If a key is not in the hash table, no operation with respect to the key
+   is performed. The batch_keys parameter is not NULL and points to an array
+   of blocks of size key_size. The batch_count parameter is the count of keys
+   in a batch. The shards are visited according to ht_shard_pthread_insert.
+*/
+void ht_shard_pthread_delete(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     size_t batch_count){
+  batch_op(ht, batch_keys, NULL, batch_count, DELETE);
+}
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_shard_pthread_stats_t) pointed to by s, and optionally copies
+   the wait counts of shard locks. A wait of a shard lock is counted if a
+   thread found the lock locked by another thread in an insert, remove, or
+   delete operation. The counts are accumulated since
+   ht_shard_pthread_init. The operation is called before/after all threads
+   started/completed insert, remove, and delete operations on ht.
+   ht          : pointer to an initialized ht_shard_pthread_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_shard_pthread_stats_t)
+   lock_waits  : - NULL if the wait counts of shard locks are not copied
+                 - otherwise a pointer to an array of num_shards size_t
+                 values, i.e. 2**log_num_shards values, where the ith value
+                 is set to the wait count of the lock of the ith shard
+*/
+void ht_shard_pthread_stats(const ht_shard_pthread_t *ht,
+			    ht_shard_pthread_stats_t *s,
+			    size_t *lock_waits){
+  size_t i;
+  size_t waits;
+  s->num_shards = ht->num_shards;
+  s->num_lock_waits = 0;
+  s->max_shard_lock_waits = 0;
+  for (i = 0; i < ht->num_shards; i++){
+    waits = ht->shards[i].num_lock_waits;
+    s->num_lock_waits += waits;
+    if (s->max_shard_lock_waits < waits) s->max_shard_lock_waits = waits;
+    if (lock_waits != NULL) lock_waits[i] = waits;
+  }
+}
+
+/**
+   Frees a hash table. The operation is called after all threads completed
+   insert, remove, delete, and search operations. Leaves a block of size
+   sizeof(ht_shard_pthread_t) pointed to by the ht parameter.
+*/
+void ht_shard_pthread_free(ht_shard_pthread_t *ht){
+  size_t i;
+  for (i = 0; i < ht->num_shards; i++){
+    ht->ops.free(ht->shards[i].ht);
+    free(ht->shards[i].ht);
+    ht->shards[i].ht = NULL;
+  }
+  free(ht->shards);
+  ht->shards = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Sorts the keys of a batch by shard and applies an operation to the keys
+   of each shard under the lock of the shard. A shard that is locked by
+   another thread in the first pass is visited in the second pass.
+*/
+static void batch_op(ht_shard_pthread_t *ht,
+		     const void *batch_keys,
+		     void *batch_elts,
+		     size_t batch_count,
+		     op_t op){
+  size_t i, j;
+  size_t num_pend = 0;
+  const char *keys = batch_keys;
+  route_t *rs = NULL, *pend = NULL;
+  ht_shard_pthread_shard_t *s = NULL;
+  if (batch_count == 0) return;
+  rs = malloc_perror(mul_sz_perror(2, batch_count), sizeof(route_t));
+  pend = rs + batch_count; /* buffer of the sort, then pending groups */
+  for (i = 0; i < batch_count; i++){
+    rs[i].shard = shard_ix(ht, keys + i * ht->key_size);
+    rs[i].ix = i;
+  }
+  sort_routes(rs, pend, batch_count, ht->log_num_shards);
+  for (i = 0; i < batch_count; i = j){
+    for (j = i + 1; j < batch_count && rs[j].shard == rs[i].shard; j++);
+    s = &ht->shards[rs[i].shard];
+    if (mutex_trylock_perror(&s->lock)){
+      shard_op(ht, &rs[i], j - i, keys, batch_elts, op);
+      mutex_unlock_perror(&s->lock);
+    }else{
+      pend[num_pend].shard = i; /* first and last routes of a group */
+      pend[num_pend].ix = j;
+      num_pend++;
+    }
+  }
+  for (i = 0; i < num_pend; i++){
+    s = &ht->shards[rs[pend[i].shard].shard];
+    mutex_lock_perror(&s->lock);
+    s->num_lock_waits++;
+    shard_op(ht,
+	     &rs[pend[i].shard],
+	     pend[i].ix - pend[i].shard,
+	     keys,
+	     batch_elts,
+	     op);
+    mutex_unlock_perror(&s->lock);
+  }
+  free(rs);
+  rs = NULL;
+  pend = NULL;
+}
+
+/**
+   Applies an operation to count keys of a batch in the same shard. The
+   operation is called by a thread holding the lock of the shard.
+*/
+static void shard_op(ht_shard_pthread_t *ht,
+		     const route_t *rs,
+		     size_t count,
+		     const char *keys,
+		     char *elts,
+		     op_t op){
+  size_t i;
+  const char *k = NULL;
+  char *e = NULL;
+  void *p = NULL;
+  void *sht = ht->shards[rs[0].shard].ht;
+  for (i = 0; i < count; i++){
+    k = keys + rs[i].ix * ht->key_size;
+    if (op == DELETE){
+      ht->ops.delete(sht, k);
+      continue;
+    }
+    e = elts + rs[i].ix * ht->elt_size;
+    if (op == REMOVE){
+      ht->ops.remove(sht, k, e);
+    }else if (ht->rdc_elts != NULL &&
+	      (p = ht->ops.search(sht, k)) != NULL){
+      ht->rdc_elts(p, e, ht->elt_size);
+    }else{
+      ht->ops.insert(sht, k, e);
+    }
+  }
+}
+
+/**
+   Sorts count routes by shard with a least significant digit radix sort,
+   using a buffer of count routes.
+*/
+static void sort_routes(route_t *rs,
+			route_t *buf,
+			size_t count,
+			size_t log_num_shards){
+  size_t i, d, shift;
+  size_t sum, c;
+  size_t mask = C_RADIX_COUNT - 1;
+  size_t counts[C_RADIX_COUNT];
+  route_t *src = rs, *dst = buf, *t = NULL;
+  for (shift = 0; shift < log_num_shards; shift += C_RADIX_BIT){
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < count; i++){
+      counts[(src[i].shard >> shift) & mask]++;
+    }
+    sum = 0;
+    for (d = 0; d < C_RADIX_COUNT; d++){
+      c = counts[d];
+      counts[d] = sum;
+      sum += c;
+    }
+    for (i = 0; i < count; i++){
+      dst[counts[(src[i].shard >> shift) & mask]++] = src[i];
+    }
+    t = src;
+    src = dst;
+    dst = t;
+  }
+  if (src != rs) memcpy(rs, src, count * sizeof(route_t));
+}
+
+/**
+   Maps a hash key to a shard index by the high bits of the product of
+   its standard key and an odd multiplier.
+*/
+static size_t shard_ix(const ht_shard_pthread_t *ht, const void *key){
+  if (ht->log_num_shards == 0) return 0;
+  return (ht->shard_mul * convert_std_key(ht, key)) >>
+    (C_FULL_BIT - ht->log_num_shards);
+}
+
+/**
+   Converts a key to a key of the standard size. This is a safe conversion
+   of any bit pattern in the block pointed to by key to size_t.
+*/
+static size_t convert_std_key(const ht_shard_pthread_t *ht, const void *key){
+  size_t i;
+  size_t sz_count, rem_size;
+  size_t std_key = 0;
+  size_t buf_size = sizeof(size_t);
+  unsigned char buf[sizeof(size_t)];
+  const char *k = NULL, *k_start = NULL, *k_end = NULL;
+  if (ht->rdc_key != NULL) return ht->rdc_key(key, ht->key_size);
+  sz_count = ht->key_size / buf_size; /* division by sizeof(size_t) */
+  rem_size = ht->key_size - sz_count * buf_size;
+  k = key;
+  memset(buf, 0, buf_size);
+  memcpy(buf, k, rem_size);
+  for (i = 0; i < rem_size; i++){
+    std_key += (size_t)buf[i] << (i * C_BYTE_BIT);
+  }
+  k_start = k + rem_size;
+  k_end = k_start + sz_count * buf_size;
+  for (k = k_start; k != k_end; k += buf_size){
+    memcpy(buf, k, buf_size);
+    for (i = 0; i < buf_size; i++){
+      std_key += (size_t)buf[i] << (i * C_BYTE_BIT);
+    }
+  }
+  return std_key;
+}
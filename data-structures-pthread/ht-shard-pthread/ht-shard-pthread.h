@@ -0,0 +1,262 @@
+/**
+   ht-shard-pthread.h
+
+   Struct declarations and declarations of accessible functions of a
+   sharded hash table with generic hash keys and generic elements that is
+   concurrently accessible and modifiable.
+
+   The keys are routed by the high bits of a multiplication-based hash
+   value to 2**log_num_shards independent shards. A shard is a
+   single-threaded hash table (e.g. ht_muloa_t or ht_divchn_t), accessed
+   through its helper functions, and a mutex lock. A thread holds at most
+   one shard lock at a time, and a shard grows under its lock
+   independently from other shards, so that a growth step only blocks the
+   threads that access the shard.
+
+   A hash key is an object within a contiguous block of memory (e.g. a basic
+   type, array, struct). If the key size is greater than sizeof(size_t)
+   bytes, then it is reduced to a sizeof(size_t)-byte block prior to
+   routing. An element is within a contiguous or noncontiguous block of
+   memory.
+
+   A hash table is modified by threads calling insert, remove, and/or delete
+   operations concurrently. The design provides the following guarantees
+   with respect to the final set of key-element pairs in a hash table after
+   all operations are completed:
+     - a single final set is guaranteed with respect to concurrent insert,
+     remove, and/or delete operations if the sets of keys used by threads
+     are disjoint,
+     - if insert operations are called by more than one thread concurrently
+     and the sets of keys used by threads are not disjoint, then a single
+     final set is guaranteed according to a user-defined reduction function
+     (e.g. min, max, add, multiply, and, or, xor of key-associated
+     elements).
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99. The requirements are: i) CHAR_BIT * sizeof(size_t) is greater
+   or equal to 16 and is even, and ii) pthreads API is available.
+*/
+
+#ifndef HT_SHARD_PTHREAD_H
+#define HT_SHARD_PTHREAD_H
+
+#define _XOPEN_SOURCE 600
+
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+   The minimal distance in memory between the locks of different shards,
+   so that the locks are not in the same cache line on current systems.
+*/
+#define HT_SHARD_PTHREAD_ALIGNMENT 64
+
+typedef struct{
+  size_t ht_size; /* size of a hash table struct of a shard */
+
+  /* pointers to hash table op helpers, pre-defined in each hash table */
+  void (*init)(void *,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       int (*)(const void *, const void *),
+	       size_t (*)(const void *, size_t),
+	       void (*)(void *));
+  void (*align)(void *, size_t);
+  void (*insert)(void *, const void *, const void *);
+  void *(*search)(const void *, const void *);
+  void (*remove)(void *, const void *, void *);
+  void (*delete)(void *, const void *);
+  void (*free)(void *);
+} ht_shard_pthread_ops_t;
+
+typedef struct{
+  char pad[HT_SHARD_PTHREAD_ALIGNMENT]; /* locks in separate cache lines */
+  pthread_mutex_t lock;
+  void *ht;
+  size_t num_lock_waits; /* updated under the lock */
+} ht_shard_pthread_shard_t;
+
+typedef struct{
+  size_t key_size;
+  size_t elt_size;
+  size_t log_num_shards;
+  size_t num_shards;
+  size_t shard_mul; /* odd multiplier for routing */
+  ht_shard_pthread_shard_t *shards;
+  ht_shard_pthread_ops_t ops;
+  size_t (*rdc_key)(const void *, size_t);
+  void (*rdc_elts)(void *, const void *, size_t); /* e.g. min, max, add */
+} ht_shard_pthread_t;
+
+typedef struct{
+  size_t num_shards;
+  size_t num_lock_waits; /* total across shards */
+  size_t max_shard_lock_waits;
+} ht_shard_pthread_stats_t;
+
+/**
+   Initializes a sharded hash table. The initialization operation is
+   called and must return before any thread calls insert, remove, and/or
+   delete, or search operation.
+   ht               : a pointer to a preallocated block of size
+                      sizeof(ht_shard_pthread_t).
+   key_size         : non-zero size of a key object
+   elt_size         : - non-zero size of an element, if the element is
+                      within a contiguous memory block and a copy of the
+                      element is inserted,
+                      - size of a pointer to an element, if the element
+                      is within a noncontiguous memory block or a pointer to
+                      a contiguous element is inserted
+   min_num          : minimum number of keys that are known or expected to
+                      become present simultaneously in a hash table, divided
+                      among the shards; 0 if a positive value is not
+                      specified
+   alpha_n          : > 0 numerator of load factor upper bound of a shard
+   log_alpha_d      : < CHAR_BIT * sizeof(size_t) log base 2 of denominator
+                      of load factor upper bound of a shard, according to
+                      the hash table of a shard
+   log_num_shards   : < CHAR_BIT * sizeof(size_t) log base 2 number of
+                      shards; a larger number reduces the probability that
+                      threads access the same shard at the expense of space
+   ops              : pointer to a struct with the size of the hash table
+                      struct of a shard and its op helpers; the struct is
+                      copied
+   cmp_key          : - if NULL then a default memcmp-based comparison of
+                      keys is performed
+                      - otherwise comparison function is applied which
+                      returns a zero integer value iff the two keys accessed
+                      through the first and the second arguments are equal;
+                      each argument is a pointer to a key_size block
+   rdc_key          : - if NULL then a default conversion of a bit pattern
+                      in the block pointed to by key is performed prior to
+                      routing and hashing, which may introduce regularities
+                      - otherwise rdc_key is applied to a key prior to
+                      routing and hashing; the first argument points to a key
+                      and the second argument provides the size of the key
+   rdc_elts         : - NULL, if a key is in the hash table when the key is
+                      inserted, the key-associated element in the hash table
+                      is updated to the inserted element
+                      - non-NULL, if a key is in the hash table when the
+                      key is inserted, performs a reduction of the element
+                      already in the hash table and the inserted element;
+                      the result of the reduction is associated with the key
+                      in the hash table; the first argument points to an
+                      elt_size-sized block in the hash table, the second
+                      argument points to an elt_size-sized block of the
+                      inserted element, and the third argument is equal to a
+                      elt_size value
+   free_elt         : - if an element is within a contiguous memory block and
+                      a copy of the element was inserted, then NULL as
+                      free_elt is sufficient to delete the element,
+                      - if an element is within a noncontiguous memory block
+                      or a pointer to a contiguous element was inserted, then
+                      an element-specific free_elt, taking a pointer to a
+                      pointer to an element as its argument and leaving a
+                      block of size elt_size pointed to by the argument, is
+                      necessary to delete the element
+*/
+void ht_shard_pthread_init(ht_shard_pthread_t *ht,
+			   size_t key_size,
+			   size_t elt_size,
+			   size_t min_num,
+			   size_t alpha_n,
+			   size_t log_alpha_d,
+			   size_t log_num_shards,
+			   const ht_shard_pthread_ops_t *ops,
+			   int (*cmp_key)(const void *, const void *),
+			   size_t (*rdc_key)(const void *, size_t),
+			   void (*rdc_elts)(void *, const void *, size_t),
+			   void (*free_elt)(void *));
+
+/**
+   Aligns each in-table elt_size block according to the align helper of
+   the hash table of a shard. The operation is optionally called after
+   ht_shard_pthread_init is completed and before any other operation is
+   called.
+   ht            : pointer to an initialized ht_shard_pthread_t struct
+   elt_alignment : alignment requirement or size of the type, a pointer to
+                   which is used to access an elt_size block
+*/
+void ht_shard_pthread_align(ht_shard_pthread_t *ht, size_t elt_alignment);
+
+/**
+   Inserts a batch of keys and associated elements into a hash table.
+   The batch_keys and batch_elts parameters are not NULL and point to
+   arrays of blocks of size key_size and elt_size respectively. The
+   batch_count parameter is the count of keys in a batch. The keys of a
+   batch are grouped by shard, and the lock of each shard with keys is
+   acquired once. A shard that is locked by another thread is visited
+   after the other shards of the batch. See also the specification of
+   rdc_elts in ht_shard_pthread_init.
+*/
+void ht_shard_pthread_insert(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     const void *batch_elts,
+			     size_t batch_count);
+
+/**
+   If a key is present in a hash table, returns a pointer to its associated
+   element, otherwise returns NULL. The key parameter is not NULL.
+   The operation is called before/after all threads started/completed
+   insert, remove, and delete operations on ht and does not require
+   thread synchronization overhead.
+*/
+void *ht_shard_pthread_search(const ht_shard_pthread_t *ht,
+			      const void *key);
+
+/**
+   Removes a batch of keys and associated elements from a hash table by
+   copying the elements or its pointers into the array of elt_size blocks
+   pointed to by batch_elts. If a key is not in the hash table, leaves the
+   corresponding elt_size block unchanged. The batch_keys and batch_elts
+   parameters are not NULL and point to arrays of blocks of size key_size and
+   elt_size respectively. The batch_count parameter is the count of keys in a
+   batch. The shards are visited according to ht_shard_pthread_insert.
+*/
+void ht_shard_pthread_remove(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     void *batch_elts,
+			     size_t batch_count);
+
+/**
+   Deletes a batch of keys and associated elements from a hash table.
+   If a key is not in the hash table, no operation with respect to the key
+   is performed. The batch_keys parameter is not NULL and points to an array
+   of blocks of size key_size. The batch_count parameter is the count of keys
+   in a batch. The shards are visited according to ht_shard_pthread_insert.
+*/
+void ht_shard_pthread_delete(ht_shard_pthread_t *ht,
+			     const void *batch_keys,
+			     size_t batch_count);
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_shard_pthread_stats_t) pointed to by s, and optionally copies
+   the wait counts of shard locks. A wait of a shard lock is counted if a
+   thread found the lock locked by another thread in an insert, remove, or
+   delete operation. The counts are accumulated since
+   ht_shard_pthread_init. The operation is called before/after all threads
+   started/completed insert, remove, and delete operations on ht.
+   ht          : pointer to an initialized ht_shard_pthread_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_shard_pthread_stats_t)
+   lock_waits  : - NULL if the wait counts of shard locks are not copied
+                 - otherwise a pointer to an array of num_shards size_t
+                 values, i.e. 2**log_num_shards values, where the ith value
+                 is set to the wait count of the lock of the ith shard
+*/
+void ht_shard_pthread_stats(const ht_shard_pthread_t *ht,
+			    ht_shard_pthread_stats_t *s,
+			    size_t *lock_waits);
+
+/**
+   Frees a hash table. The operation is called after all threads completed
+   insert, remove, delete, and search operations. Leaves a block of size
+   sizeof(ht_shard_pthread_t) pointed to by the ht parameter.
+*/
+void ht_shard_pthread_free(ht_shard_pthread_t *ht);
+
+#endif
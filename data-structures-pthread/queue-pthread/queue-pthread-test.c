@@ -0,0 +1,463 @@
+/**
+   queue-pthread-test.c
+
+   Tests of bounded generic fifo queues that are concurrently accessible by
+   threads pushing and popping at the same time without locks.
+
+   The following command line arguments can be used to customize tests:
+   queue-pthread-test
+      [0, # bits in size_t - 1) : i s.t. # pushes = 2**i
+      > 0 : number of producer threads and of consumer threads in MPMC test
+      [0, # bits in size_t - 1) : j s.t. queue count = 2**j
+      [0, 1] : on/off single thread test
+      [0, 1] : on/off SPSC test
+      [0, 1] : on/off MPMC test
+
+   usage examples:
+   ./queue-pthread-test
+   ./queue-pthread-test 20
+   ./queue-pthread-test 20 4 6
+
+   queue-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirement that the pthreads API and the
+   atomic operations of queue-pthread are available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "queue-pthread.h"
+#include "queue.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "queue-pthread-test\n"
+  "[0, # bits in size_t - 1) : i s.t. # pushes = 2**i\n"
+  "> 0 : number of producer threads and of consumer threads in MPMC test\n"
+  "[0, # bits in size_t - 1) : j s.t. queue count = 2**j\n"
+  "[0, 1] : on/off single thread test\n"
+  "[0, 1] : on/off SPSC test\n"
+  "[0, 1] : on/off MPMC test\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {18, 2, 10, 1, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* single thread test */
+const size_t C_MIN_COUNTS[3] = {1, 5, 64};
+const size_t C_MIN_COUNTS_COUNT = 3;
+
+typedef struct{
+  double *val;
+} double_ptr_t;
+
+void free_double_ptr(void *a);
+void print_test_result(int res);
+double timer();
+
+/**
+   A bounded queue_t protected by a mutex, with semaphores for the numbers
+   of elements and free slots, as a baseline of the concurrent tests.
+*/
+
+typedef struct{
+  size_t count;
+  queue_t q;
+  pthread_mutex_t mutex;
+  sema_t num_elts;
+  sema_t num_free;
+} locked_queue_t;
+
+void locked_queue_init(locked_queue_t *lq, size_t count){
+  lq->count = count;
+  queue_init(&lq->q, count, sizeof(size_t), NULL);
+  mutex_init_perror(&lq->mutex);
+  sema_init_perror(&lq->num_elts, 0);
+  sema_init_perror(&lq->num_free, count);
+}
+
+void locked_queue_push(locked_queue_t *lq, const size_t *elt){
+  sema_wait_perror(&lq->num_free);
+  mutex_lock_perror(&lq->mutex);
+  queue_push(&lq->q, elt);
+  mutex_unlock_perror(&lq->mutex);
+  sema_signal_perror(&lq->num_elts);
+}
+
+void locked_queue_pop(locked_queue_t *lq, size_t *elt){
+  sema_wait_perror(&lq->num_elts);
+  mutex_lock_perror(&lq->mutex);
+  queue_pop(&lq->q, elt);
+  mutex_unlock_perror(&lq->mutex);
+  sema_signal_perror(&lq->num_free);
+}
+
+void locked_queue_free(locked_queue_t *lq){
+  queue_free(&lq->q);
+}
+
+/**
+   Runs a test of try pushes and try pops by a single thread on size_t
+   elements across queue counts. Tests that a queue accepts count
+   elements, that the elements are popped in the order of pushing across
+   wrap-arounds, and that an empty queue is reported. The remaining
+   noncontiguous elements are freed with a queue.
+*/
+void run_single_thread_test(size_t log_num_ins){
+  int res = 1;
+  int is_pushed;
+  size_t i, j, k;
+  size_t num_ins = (size_t)1 << log_num_ins;
+  size_t elt, num_pushed, num_popped;
+  double_ptr_t dp;
+  queue_pthread_spsc_t sq;
+  queue_pthread_mpmc_t mq;
+  printf("Run a single thread test with %lu pushes\n", TOLU(num_ins));
+  for (i = 0; i < C_MIN_COUNTS_COUNT; i++){
+    for (j = 0; j < 2; j++){
+      if (j == 0){
+	queue_pthread_spsc_init(&sq, C_MIN_COUNTS[i], sizeof(size_t), NULL);
+      }else{
+	queue_pthread_mpmc_init(&mq, C_MIN_COUNTS[i], sizeof(size_t), NULL);
+      }
+      /* fill and empty */
+      k = 0;
+      while ((j == 0) ?
+	     queue_pthread_spsc_trypush(&sq, &k) :
+	     queue_pthread_mpmc_trypush(&mq, &k)){
+	k++;
+      }
+      res *= (k == ((j == 0) ? sq.count : mq.count) &&
+	      k >= C_MIN_COUNTS[i]);
+      for (k = 0; k < ((j == 0) ? sq.count : mq.count); k++){
+	elt = (size_t)-1;
+	if (j == 0){
+	  res *= queue_pthread_spsc_trypop(&sq, &elt);
+	}else{
+	  res *= queue_pthread_mpmc_trypop(&mq, &elt);
+	}
+	res *= (elt == k);
+      }
+      elt = (size_t)-1;
+      res *= !((j == 0) ?
+	       queue_pthread_spsc_trypop(&sq, &elt) :
+	       queue_pthread_mpmc_trypop(&mq, &elt));
+      res *= (elt == (size_t)-1);
+      /* interleaved pushes and pops across wrap-arounds */
+      num_pushed = 0;
+      num_popped = 0;
+      while (num_popped < num_ins){
+	is_pushed = 0;
+	if (num_pushed < num_ins &&
+	    ((j == 0) ?
+	     queue_pthread_spsc_trypush(&sq, &num_pushed) :
+	     queue_pthread_mpmc_trypush(&mq, &num_pushed))){
+	  num_pushed++;
+	  is_pushed = 1;
+	}
+	if ((num_pushed & 1 || !is_pushed) &&
+	    ((j == 0) ?
+	     queue_pthread_spsc_trypop(&sq, &elt) :
+	     queue_pthread_mpmc_trypop(&mq, &elt))){
+	  res *= (elt == num_popped);
+	  num_popped++;
+	}
+      }
+      if (j == 0){
+	queue_pthread_spsc_free(&sq);
+      }else{
+	queue_pthread_mpmc_free(&mq);
+      }
+    }
+    printf("\tmin count: %lu, correctness: ", TOLU(C_MIN_COUNTS[i]));
+    print_test_result(res);
+  }
+  /* noncontiguous elements left in queues */
+  queue_pthread_spsc_init(&sq,
+			  C_MIN_COUNTS[1],
+			  sizeof(double_ptr_t),
+			  free_double_ptr);
+  queue_pthread_mpmc_init(&mq,
+			  C_MIN_COUNTS[1],
+			  sizeof(double_ptr_t),
+			  free_double_ptr);
+  for (i = 0; i < C_MIN_COUNTS[1]; i++){
+    dp.val = malloc_perror(1, sizeof(double));
+    *dp.val = i;
+    queue_pthread_spsc_push(&sq, &dp);
+    dp.val = malloc_perror(1, sizeof(double));
+    *dp.val = i;
+    queue_pthread_mpmc_push(&mq, &dp);
+  }
+  queue_pthread_spsc_pop(&sq, &dp);
+  res *= (*dp.val == 0.0);
+  free_double_ptr(&dp);
+  queue_pthread_mpmc_pop(&mq, &dp);
+  res *= (*dp.val == 0.0);
+  free_double_ptr(&dp);
+  queue_pthread_spsc_free(&sq);
+  queue_pthread_mpmc_free(&mq);
+  printf("\tnoncontiguous elements, correctness: ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of a SPSC queue with a producer thread pushing size_t
+   elements in increasing order and a consumer thread popping and testing
+   the order of the elements. The time is compared with the time of the
+   same operations on a locked_queue_t.
+*/
+
+typedef struct{
+  size_t start;
+  size_t count;
+  size_t num_popped;
+  size_t *popped; /* popped elements, NULL in a producer */
+  queue_pthread_spsc_t *sq;
+  queue_pthread_mpmc_t *mq;
+  locked_queue_t *lq;
+} push_pop_arg_t;
+
+void *spsc_push_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = ppa->start; i < ppa->start + ppa->count; i++){
+    queue_pthread_spsc_push(ppa->sq, &i);
+  }
+  return NULL;
+}
+
+void *spsc_pop_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = 0; i < ppa->count; i++){
+    queue_pthread_spsc_pop(ppa->sq, &ppa->popped[ppa->num_popped++]);
+  }
+  return NULL;
+}
+
+void *mpmc_push_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = ppa->start; i < ppa->start + ppa->count; i++){
+    queue_pthread_mpmc_push(ppa->mq, &i);
+  }
+  return NULL;
+}
+
+void *mpmc_pop_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = 0; i < ppa->count; i++){
+    queue_pthread_mpmc_pop(ppa->mq, &ppa->popped[ppa->num_popped++]);
+  }
+  return NULL;
+}
+
+void *locked_push_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = ppa->start; i < ppa->start + ppa->count; i++){
+    locked_queue_push(ppa->lq, &i);
+  }
+  return NULL;
+}
+
+void *locked_pop_thread(void *arg){
+  size_t i;
+  push_pop_arg_t *ppa = arg;
+  for (i = 0; i < ppa->count; i++){
+    locked_queue_pop(ppa->lq, &ppa->popped[ppa->num_popped++]);
+  }
+  return NULL;
+}
+
+/**
+   Runs num_threads producer threads and num_threads consumer threads and
+   tests that each of num_ins elements is popped exactly once, and that the
+   elements of a producer are popped by a consumer in increasing order.
+*/
+void push_pop(push_pop_arg_t *ppas,
+	      size_t num_threads,
+	      size_t num_ins,
+	      void *(*push_routine)(void *),
+	      void *(*pop_routine)(void *),
+	      int *res,
+	      double *t){
+  size_t i, j, p, seg_count;
+  size_t *prev = NULL;
+  unsigned char *popped = NULL;
+  pthread_t *ids = NULL;
+  ids = malloc_perror(2 * num_threads, sizeof(pthread_t));
+  prev = malloc_perror(num_threads, sizeof(size_t));
+  popped = calloc_perror(num_ins, 1);
+  for (i = 0; i < 2 * num_threads; i++){
+    ppas[i].num_popped = 0;
+  }
+  *t = timer();
+  for (i = 0; i < num_threads; i++){
+    thread_create_perror(&ids[i], push_routine, &ppas[i]);
+    thread_create_perror(&ids[num_threads + i],
+			 pop_routine,
+			 &ppas[num_threads + i]);
+  }
+  for (i = 0; i < 2 * num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  *t = timer() - *t;
+  seg_count = num_ins / num_threads;
+  for (i = num_threads; i < 2 * num_threads; i++){
+    for (p = 0; p < num_threads; p++){
+      prev[p] = 0;
+    }
+    for (j = 0; j < ppas[i].num_popped; j++){
+      *res *= (ppas[i].popped[j] < num_ins &&
+	       !popped[ppas[i].popped[j]]);
+      if (!*res) break;
+      popped[ppas[i].popped[j]] = 1;
+      p = ppas[i].popped[j] / seg_count;
+      if (p >= num_threads) p = num_threads - 1;
+      *res *= (prev[p] <= ppas[i].popped[j] + 1);
+      prev[p] = ppas[i].popped[j] + 1;
+    }
+  }
+  for (i = 0; i < num_ins; i++){
+    *res *= popped[i];
+  }
+  free(ids);
+  free(prev);
+  free(popped);
+  ids = NULL;
+  prev = NULL;
+  popped = NULL;
+}
+
+void run_concurrent_test(size_t log_num_ins,
+			 size_t num_threads,
+			 size_t log_count,
+			 int is_mpmc){
+  int res = 1;
+  size_t i, seg_count;
+  size_t num_ins = (size_t)1 << log_num_ins;
+  size_t count = (size_t)1 << log_count;
+  double t_q, t_lq;
+  queue_pthread_spsc_t sq;
+  queue_pthread_mpmc_t mq;
+  locked_queue_t lq;
+  push_pop_arg_t *ppas = NULL;
+  if (!is_mpmc) num_threads = 1;
+  ppas = malloc_perror(2 * num_threads, sizeof(push_pop_arg_t));
+  seg_count = num_ins / num_threads;
+  for (i = 0; i < 2 * num_threads; i++){
+    ppas[i].start = (i % num_threads) * seg_count;
+    ppas[i].count = (i % num_threads == num_threads - 1) ?
+      num_ins - (i % num_threads) * seg_count : seg_count;
+    ppas[i].num_popped = 0;
+    ppas[i].popped = (i < num_threads) ?
+      NULL : malloc_perror(ppas[i].count, sizeof(size_t));
+    ppas[i].sq = &sq;
+    ppas[i].mq = &mq;
+    ppas[i].lq = &lq;
+  }
+  printf("Run a %s test with %lu pushes, %lu producers, %lu consumers, "
+	 "queue count %lu\n",
+	 is_mpmc ? "MPMC" : "SPSC",
+	 TOLU(num_ins),
+	 TOLU(num_threads),
+	 TOLU(num_threads),
+	 TOLU(count));
+  if (is_mpmc){
+    queue_pthread_mpmc_init(&mq, count, sizeof(size_t), NULL);
+    push_pop(ppas, num_threads, num_ins,
+	     mpmc_push_thread, mpmc_pop_thread, &res, &t_q);
+    queue_pthread_mpmc_free(&mq);
+  }else{
+    queue_pthread_spsc_init(&sq, count, sizeof(size_t), NULL);
+    push_pop(ppas, num_threads, num_ins,
+	     spsc_push_thread, spsc_pop_thread, &res, &t_q);
+    queue_pthread_spsc_free(&sq);
+  }
+  locked_queue_init(&lq, count);
+  push_pop(ppas, num_threads, num_ins,
+	   locked_push_thread, locked_pop_thread, &res, &t_lq);
+  locked_queue_free(&lq);
+  printf("\t\t%s queue push pop time:            %.4f seconds\n"
+	 "\t\tqueue_t with a mutex and semaphores: %.4f seconds\n",
+	 is_mpmc ? "MPMC" : "SPSC", t_q, t_lq);
+  printf("\t\tcorrectness:                         ");
+  print_test_result(res);
+  for (i = num_threads; i < 2 * num_threads; i++){
+    free(ppas[i].popped);
+    ppas[i].popped = NULL;
+  }
+  free(ppas);
+  ppas = NULL;
+}
+
+/**
+   Frees a noncontiguous double element.
+*/
+void free_double_ptr(void *a){
+  double_ptr_t *s = a;
+  free(s->val);
+  s->val = NULL;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  if (argc > C_ARGC_MAX){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] < 1 ||
+      args[2] > C_FULL_BIT - 2 ||
+      args[3] > 1 ||
+      args[4] > 1 ||
+      args[5] > 1){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]) run_single_thread_test(args[0]);
+  if (args[4]) run_concurrent_test(args[0], args[1], args[2], 0);
+  if (args[5]) run_concurrent_test(args[0], args[1], args[2], 1);
+  free(args);
+  args = NULL;
+  return 0;
+}
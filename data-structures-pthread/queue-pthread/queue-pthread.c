@@ -0,0 +1,313 @@
+/**
+   queue-pthread.c
+
+   Implementation of bounded generic fifo queues that are concurrently
+   accessible by threads pushing and popping at the same time without
+   locks.
+
+   A SPSC queue maintains a head index, updated only by the consumer, and
+   a tail index, updated only by the producer. The elements in the queue
+   are at the indices in [head, tail) modulo count. The producer publishes
+   an element by a release store of tail after copying the element, and the
+   consumer releases a slot by a release store of head after copying the
+   element out; the matching acquire loads order the copies. Each thread
+   keeps a copy of the index of the other thread, which is refreshed only
+   if the queue appears full or empty.
+
+   In a MPMC queue, the slot at index i modulo count holds a sequence
+   number s. A push at the push index p can claim the slot if s == p,
+   finds the queue full if s is behind p, and otherwise retries with the
+   updated push index, because another push claimed the slot. After
+   claiming the slot by a compare-and-swap of the push index, the element
+   is copied and s is set to p + 1. A pop at the pop index p can claim
+   the slot if s == p + 1, finds the queue empty if s is behind p + 1,
+   sets s to p + count after copying the element out, and otherwise
+   retries. The comparisons are modulo 2**(CHAR_BIT * sizeof(size_t)), a
+   sequence number being behind an index if their difference is at most
+   half of the range. The compare-and-swap operations are relaxed, because
+   the copies are ordered by the acquire loads and release stores of the
+   sequence numbers.
+
+   The implementation uses C11 atomics from stdatomic.h if compiled under
+   C11 without __STDC_NO_ATOMICS__, and otherwise the __atomic builtins of
+   GCC and Clang, which are available under C89/C90 and C99. The
+   implementation does not use stdint.h and is otherwise portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "queue-pthread.h"
+#include "utilities-mem.h"
+
+#ifdef QUEUE_PTHREAD_C11_ATOMICS
+#define IX_INIT(p, v) atomic_init((p), (v))
+#define IX_LOAD_RELAXED(p) atomic_load_explicit((p), memory_order_relaxed)
+#define IX_LOAD_ACQUIRE(p) atomic_load_explicit((p), memory_order_acquire)
+#define IX_STORE_RELEASE(p, v)					\
+  atomic_store_explicit((p), (v), memory_order_release)
+#define IX_CAS_RELAXED(p, e, v)						\
+  atomic_compare_exchange_weak_explicit((p), (e), (v),			\
+					memory_order_relaxed,		\
+					memory_order_relaxed)
+#else
+#define IX_INIT(p, v) (*(p) = (v))
+#define IX_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define IX_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define IX_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define IX_CAS_RELAXED(p, e, v)						\
+  __atomic_compare_exchange_n((p), (e), (v), 1,				\
+			      __ATOMIC_RELAXED,				\
+			      __ATOMIC_RELAXED)
+#endif
+
+static const size_t C_HALF_RANGE = (size_t)-1 / 2;
+
+static size_t pow_two_count(size_t min_count);
+static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
+static queue_pthread_ix_t *seq_ptr(const queue_pthread_mpmc_t *q, size_t i);
+static void fprintf_stderr_exit(const char *s, int line);
+
+/**
+   Initializes a SPSC or MPMC queue. The initialization operation is
+   called and must return before any thread calls a push or pop operation.
+   q           : pointer to a preallocated block of size
+                 sizeof(queue_pthread_spsc_t) or sizeof(queue_pthread_mpmc_t)
+   min_count   : > 0 minimum number of elements that can be in a queue at
+                 the same time; the count of the queue is the least power
+                 of two that is greater or equal to min_count, and is at
+                 least 2 in a MPMC queue, so that a sequence number of a
+                 published slot differs from the index of the next push
+   elt_size    : - the size of an element, if the element is within a
+                 contiguous memory block and a copy of the element is
+                 pushed
+                 - the size of a pointer to an element, if the element is
+                 within a noncontiguous memory block or a pointer to a
+                 contiguous element is pushed
+   free_elt    : - if an element is within a contiguous memory block and a
+                 copy of the element was pushed, then NULL as free_elt is
+                 sufficient to free the queue
+                 - if an element is within a noncontiguous memory block or
+                 a pointer to a contiguous element was pushed, then an
+                 element-specific free_elt, taking a pointer to a pointer to
+                 an element as its parameter, is necessary to free the queue
+*/
+void queue_pthread_spsc_init(queue_pthread_spsc_t *q,
+			     size_t min_count,
+			     size_t elt_size,
+			     void (*free_elt)(void *)){
+  q->count = pow_two_count(min_count);
+  q->elt_size = elt_size;
+  q->elts = malloc_perror(q->count, elt_size);
+  q->free_elt = free_elt;
+  IX_INIT(&q->head, 0);
+  q->tail_cache = 0;
+  IX_INIT(&q->tail, 0);
+  q->head_cache = 0;
+}
+
+void queue_pthread_mpmc_init(queue_pthread_mpmc_t *q,
+			     size_t min_count,
+			     size_t elt_size,
+			     void (*free_elt)(void *)){
+  size_t i, rem;
+  q->count = pow_two_count((min_count < 2) ? 2 : min_count);
+  q->elt_size = elt_size;
+  /* sequence numbers aligned as the blocks of an array */
+  q->elt_offset = sizeof(queue_pthread_ix_t);
+  q->slot_size = add_sz_perror(q->elt_offset, elt_size);
+  rem = q->slot_size % sizeof(queue_pthread_ix_t);
+  q->slot_size = add_sz_perror(q->slot_size,
+			       (rem > 0) * (sizeof(queue_pthread_ix_t) - rem));
+  q->slots = malloc_perror(q->count, q->slot_size);
+  q->free_elt = free_elt;
+  for (i = 0; i < q->count; i++){
+    IX_INIT(seq_ptr(q, i), i);
+  }
+  IX_INIT(&q->push_ix, 0);
+  IX_INIT(&q->pop_ix, 0);
+}
+
+/**
+   Attempts to push an element, pointed to by elt, onto a queue. Returns 1
+   if the element was pushed, and 0 if the queue was full. The elt
+   parameter is not NULL. In a SPSC queue, the operation is called by at
+   most one thread at a time.
+*/
+int queue_pthread_spsc_trypush(queue_pthread_spsc_t *q, const void *elt){
+  size_t tail = IX_LOAD_RELAXED(&q->tail);
+  if (tail - q->head_cache == q->count){
+    q->head_cache = IX_LOAD_ACQUIRE(&q->head);
+    if (tail - q->head_cache == q->count) return 0;
+  }
+  memcpy(elt_ptr(q->elts, tail & (q->count - 1), q->elt_size),
+	 elt,
+	 q->elt_size);
+  IX_STORE_RELEASE(&q->tail, tail + 1);
+  return 1;
+}
+
+int queue_pthread_mpmc_trypush(queue_pthread_mpmc_t *q, const void *elt){
+  size_t ix, seq;
+  queue_pthread_ix_t *s = NULL;
+  ix = IX_LOAD_RELAXED(&q->push_ix);
+  while (1){
+    s = seq_ptr(q, ix & (q->count - 1));
+    seq = IX_LOAD_ACQUIRE(s);
+    if (seq == ix){
+      /* on failure ix is set to the current push index */
+      if (IX_CAS_RELAXED(&q->push_ix, &ix, ix + 1)) break;
+    }else if (ix - seq <= C_HALF_RANGE){
+      return 0; /* slot not yet released by a pop */
+    }else{
+      ix = IX_LOAD_RELAXED(&q->push_ix);
+    }
+  }
+  memcpy((char *)s + q->elt_offset, elt, q->elt_size);
+  IX_STORE_RELEASE(s, ix + 1);
+  return 1;
+}
+
+/**
+   Attempts to pop an element off a queue and copy it to a block of size
+   elt_size pointed to by elt. Returns 1 if an element was popped, and 0
+   if the queue was empty, in which case the block pointed to by elt
+   remains unchanged. In a SPSC queue, the operation is called by at most
+   one thread at a time.
+*/
+int queue_pthread_spsc_trypop(queue_pthread_spsc_t *q, void *elt){
+  size_t head = IX_LOAD_RELAXED(&q->head);
+  if (head == q->tail_cache){
+    q->tail_cache = IX_LOAD_ACQUIRE(&q->tail);
+    if (head == q->tail_cache) return 0;
+  }
+  memcpy(elt,
+	 elt_ptr(q->elts, head & (q->count - 1), q->elt_size),
+	 q->elt_size);
+  IX_STORE_RELEASE(&q->head, head + 1);
+  return 1;
+}
+
+int queue_pthread_mpmc_trypop(queue_pthread_mpmc_t *q, void *elt){
+  size_t ix, seq;
+  queue_pthread_ix_t *s = NULL;
+  ix = IX_LOAD_RELAXED(&q->pop_ix);
+  while (1){
+    s = seq_ptr(q, ix & (q->count - 1));
+    seq = IX_LOAD_ACQUIRE(s);
+    if (seq == ix + 1){
+      /* on failure ix is set to the current pop index */
+      if (IX_CAS_RELAXED(&q->pop_ix, &ix, ix + 1)) break;
+    }else if (ix + 1 - seq <= C_HALF_RANGE){
+      return 0; /* slot not yet published by a push */
+    }else{
+      ix = IX_LOAD_RELAXED(&q->pop_ix);
+    }
+  }
+  memcpy(elt, (char *)s + q->elt_offset, q->elt_size);
+  IX_STORE_RELEASE(s, ix + q->count);
+  return 1;
+}
+
+/**
+   Pushes an element onto a queue, spinning and yielding the processor
+   while the queue is full. Please see the parameter specification in the
+   try push operations.
+*/
+void queue_pthread_spsc_push(queue_pthread_spsc_t *q, const void *elt){
+  while (!queue_pthread_spsc_trypush(q, elt)) sched_yield();
+}
+
+void queue_pthread_mpmc_push(queue_pthread_mpmc_t *q, const void *elt){
+  while (!queue_pthread_mpmc_trypush(q, elt)) sched_yield();
+}
+
+/**
+   Pops an element off a queue, spinning and yielding the processor while
+   the queue is empty. Please see the parameter specification in the try
+   pop operations.
+*/
+void queue_pthread_spsc_pop(queue_pthread_spsc_t *q, void *elt){
+  while (!queue_pthread_spsc_trypop(q, elt)) sched_yield();
+}
+
+void queue_pthread_mpmc_pop(queue_pthread_mpmc_t *q, void *elt){
+  while (!queue_pthread_mpmc_trypop(q, elt)) sched_yield();
+}
+
+/**
+   Frees a queue and the elements in the queue according to free_elt, and
+   leaves a block of size sizeof(queue_pthread_spsc_t) or
+   sizeof(queue_pthread_mpmc_t) pointed to by the q parameter. The
+   operation is called after all threads completed their push and pop
+   operations.
+*/
+void queue_pthread_spsc_free(queue_pthread_spsc_t *q){
+  size_t i, head, tail;
+  head = IX_LOAD_ACQUIRE(&q->head);
+  tail = IX_LOAD_ACQUIRE(&q->tail);
+  if (q->free_elt != NULL){
+    for (i = head; i != tail; i++){
+      q->free_elt(elt_ptr(q->elts, i & (q->count - 1), q->elt_size));
+    }
+  }
+  free(q->elts);
+  q->elts = NULL;
+}
+
+void queue_pthread_mpmc_free(queue_pthread_mpmc_t *q){
+  size_t i, pop_ix, push_ix;
+  pop_ix = IX_LOAD_ACQUIRE(&q->pop_ix);
+  push_ix = IX_LOAD_ACQUIRE(&q->push_ix);
+  if (q->free_elt != NULL){
+    for (i = pop_ix; i != push_ix; i++){
+      q->free_elt((char *)seq_ptr(q, i & (q->count - 1)) + q->elt_offset);
+    }
+  }
+  free(q->slots);
+  q->slots = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Returns the least power of two that is greater or equal to min_count,
+   or exits with an error message if the power of two is not representable
+   as size_t.
+*/
+static size_t pow_two_count(size_t min_count){
+  size_t count = 1;
+  while (count < min_count){
+    if (count > C_HALF_RANGE){
+      fprintf_stderr_exit("min_count > count maximum", __LINE__);
+    }
+    count *= 2;
+  }
+  return count;
+}
+
+/**
+   Computes a pointer to an element in an element array.
+*/
+static void *elt_ptr(const void *elts, size_t i, size_t elt_size){
+  return (void *)((char *)elts + i * elt_size);
+}
+
+/**
+   Computes a pointer to the sequence number of the slot i of a MPMC queue.
+*/
+static queue_pthread_ix_t *seq_ptr(const queue_pthread_mpmc_t *q, size_t i){
+  return (queue_pthread_ix_t *)((char *)q->slots + i * q->slot_size);
+}
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
+}
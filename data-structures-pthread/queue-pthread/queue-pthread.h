@@ -0,0 +1,180 @@
+/**
+   queue-pthread.h
+
+   Struct declarations and declarations of accessible functions of bounded
+   generic fifo queues that are concurrently accessible by threads pushing
+   and popping at the same time without locks.
+
+   A single-producer single-consumer (SPSC) queue is accessed by at most
+   one pushing thread and at most one popping thread at a time. Each of the
+   two threads updates its own index of a circular buffer and reads the
+   index of the other thread only if its cached copy of the index does not
+   allow the operation, so that in a pipeline with a nonempty and nonfull
+   queue the two threads rarely access the same cache line.
+
+   A multi-producer multi-consumer (MPMC) queue is accessed by any number
+   of pushing and popping threads. Each slot of a circular buffer holds a
+   sequence number next to an element, and a thread claims a slot by a
+   compare-and-swap on the push or pop index, after which it copies an
+   element without contention and publishes the slot by updating the
+   sequence number. The design follows the bounded MPMC queue of Dmitry
+   Vyukov.
+
+   In both queues, a push or pop is linearizable, and a try operation
+   returns without waiting if the queue is full or empty respectively. A
+   try pop may report an empty queue while a push that started earlier is
+   in progress, and a try push may report a full queue while a pop that
+   started earlier is in progress. The blocking operations spin and yield
+   the processor with sched_yield until the operation is completed, without
+   a context switch through a mutex or a condition variable. The elements
+   of a queue are copied with the elt_size convention of queue_t.
+
+   The count of a queue is a power of two, so that the indices are
+   incremented without bound, wrapping around modulo 2**(CHAR_BIT *
+   sizeof(size_t)), and masked to access a slot.
+
+   The implementation uses C11 atomics from stdatomic.h if compiled under
+   C11 without __STDC_NO_ATOMICS__, and otherwise the __atomic builtins of
+   GCC and Clang, which are available under C89/C90 and C99. The
+   implementation does not use stdint.h and is otherwise portable under
+   C89/C90 and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef QUEUE_PTHREAD_H
+#define QUEUE_PTHREAD_H
+
+#define _XOPEN_SOURCE 600
+
+#include <stddef.h>
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L &&	\
+  !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define QUEUE_PTHREAD_C11_ATOMICS
+typedef atomic_size_t queue_pthread_ix_t;
+#elif defined(__GNUC__)
+typedef size_t queue_pthread_ix_t; /* accessed with __atomic builtins */
+#else
+#error "queue-pthread requires C11 atomics or GCC/Clang __atomic builtins"
+#endif
+
+/**
+   The minimal distance in memory between the indices that are updated by
+   different threads, so that the indices are not in the same cache line
+   on current systems.
+*/
+#define QUEUE_PTHREAD_ALIGNMENT 64
+
+typedef struct{
+  size_t count; /* power of two */
+  size_t elt_size;
+  void *elts;
+  void (*free_elt)(void *);
+  char pad_head[QUEUE_PTHREAD_ALIGNMENT];
+  queue_pthread_ix_t head; /* # popped elements, updated by the consumer */
+  size_t tail_cache; /* consumer's copy of tail */
+  char pad_tail[QUEUE_PTHREAD_ALIGNMENT];
+  queue_pthread_ix_t tail; /* # pushed elements, updated by the producer */
+  size_t head_cache; /* producer's copy of head */
+  char pad_end[QUEUE_PTHREAD_ALIGNMENT];
+} queue_pthread_spsc_t;
+
+typedef struct{
+  size_t count; /* power of two */
+  size_t elt_size;
+  size_t elt_offset; /* number of bytes from beginning of slot to elt */
+  size_t slot_size; /* sequence number and element, aligned in memory */
+  void *slots;
+  void (*free_elt)(void *);
+  char pad_push[QUEUE_PTHREAD_ALIGNMENT];
+  queue_pthread_ix_t push_ix; /* index of the next slot to claim by a push */
+  char pad_pop[QUEUE_PTHREAD_ALIGNMENT];
+  queue_pthread_ix_t pop_ix; /* index of the next slot to claim by a pop */
+  char pad_end[QUEUE_PTHREAD_ALIGNMENT];
+} queue_pthread_mpmc_t;
+
+/**
+   Initializes a SPSC or MPMC queue. The initialization operation is
+   called and must return before any thread calls a push or pop operation.
+   q           : pointer to a preallocated block of size
+                 sizeof(queue_pthread_spsc_t) or sizeof(queue_pthread_mpmc_t)
+   min_count   : > 0 minimum number of elements that can be in a queue at
+                 the same time; the count of the queue is the least power
+                 of two that is greater or equal to min_count, and is at
+                 least 2 in a MPMC queue, so that a sequence number of a
+                 published slot differs from the index of the next push
+   elt_size    : - the size of an element, if the element is within a
+                 contiguous memory block and a copy of the element is
+                 pushed
+                 - the size of a pointer to an element, if the element is
+                 within a noncontiguous memory block or a pointer to a
+                 contiguous element is pushed
+   free_elt    : - if an element is within a contiguous memory block and a
+                 copy of the element was pushed, then NULL as free_elt is
+                 sufficient to free the queue
+                 - if an element is within a noncontiguous memory block or
+                 a pointer to a contiguous element was pushed, then an
+                 element-specific free_elt, taking a pointer to a pointer to
+                 an element as its parameter, is necessary to free the queue
+*/
+void queue_pthread_spsc_init(queue_pthread_spsc_t *q,
+			     size_t min_count,
+			     size_t elt_size,
+			     void (*free_elt)(void *));
+
+void queue_pthread_mpmc_init(queue_pthread_mpmc_t *q,
+			     size_t min_count,
+			     size_t elt_size,
+			     void (*free_elt)(void *));
+
+/**
+   Attempts to push an element, pointed to by elt, onto a queue. Returns 1
+   if the element was pushed, and 0 if the queue was full. The elt
+   parameter is not NULL. In a SPSC queue, the operation is called by at
+   most one thread at a time.
+*/
+int queue_pthread_spsc_trypush(queue_pthread_spsc_t *q, const void *elt);
+
+int queue_pthread_mpmc_trypush(queue_pthread_mpmc_t *q, const void *elt);
+
+/**
+   Attempts to pop an element off a queue and copy it to a block of size
+   elt_size pointed to by elt. Returns 1 if an element was popped, and 0
+   if the queue was empty, in which case the block pointed to by elt
+   remains unchanged. In a SPSC queue, the operation is called by at most
+   one thread at a time.
+*/
+int queue_pthread_spsc_trypop(queue_pthread_spsc_t *q, void *elt);
+
+int queue_pthread_mpmc_trypop(queue_pthread_mpmc_t *q, void *elt);
+
+/**
+   Pushes an element onto a queue, spinning and yielding the processor
+   while the queue is full. Please see the parameter specification in the
+   try push operations.
+*/
+void queue_pthread_spsc_push(queue_pthread_spsc_t *q, const void *elt);
+
+void queue_pthread_mpmc_push(queue_pthread_mpmc_t *q, const void *elt);
+
+/**
+   Pops an element off a queue, spinning and yielding the processor while
+   the queue is empty. Please see the parameter specification in the try
+   pop operations.
+*/
+void queue_pthread_spsc_pop(queue_pthread_spsc_t *q, void *elt);
+
+void queue_pthread_mpmc_pop(queue_pthread_mpmc_t *q, void *elt);
+
+/**
+   Frees a queue and the elements in the queue according to free_elt, and
+   leaves a block of size sizeof(queue_pthread_spsc_t) or
+   sizeof(queue_pthread_mpmc_t) pointed to by the q parameter. The
+   operation is called after all threads completed their push and pop
+   operations.
+*/
+void queue_pthread_spsc_free(queue_pthread_spsc_t *q);
+
+void queue_pthread_mpmc_free(queue_pthread_mpmc_t *q);
+
+#endif
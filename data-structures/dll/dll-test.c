@@ -11,11 +11,15 @@
       [0, 1] : on/off prepend append free int test
       [0, 1] : on/off prepend append free int_ptr (noncontiguous) test
       [0, 1] : on/off corner cases test
+      [0, 1] : on/off pool int test
+      [0, 1] : on/off intrusive int test
 
    usage examples:
    ./dll-test
    ./dll-test 23
    ./dll-test 24 1 0 0
+   ./dll-test 24 0 0 0 1
+   ./dll-test 24 0 0 0 0 1
 
    dll-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -33,6 +37,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <limits.h>
 #include <time.h>
@@ -46,13 +51,16 @@ const char *C_USAGE =
   "[0, bit width of int - 2) : i s.t. # inserts = 2**i\n"
   "[0, 1] : on/off prepend append free int test\n"
   "[0, 1] : on/off prepend append free int_ptr (noncontiguous) test\n"
-  "[0, 1] : on/off corner cases test\n";
-const int C_ARGC_MAX = 5;
-const size_t C_ARGS_DEF[4] = {13, 1, 1, 1};
+  "[0, 1] : on/off corner cases test\n"
+  "[0, 1] : on/off pool int test\n"
+  "[0, 1] : on/off intrusive int test\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {13, 1, 1, 1, 1, 1};
 const size_t C_INT_BIT = CHAR_BIT * sizeof(int);
 
 /* tests */
 const int C_START_VAL = 0;
+const int C_INTR_NUM_SEARCH = 1024; /* bounds the quadratic search time */
 
 void prepend_append_free(const dll_t *ll_prep,
 			 const dll_t *ll_app,
@@ -339,6 +347,202 @@ void run_corner_cases_test(){
   print_test_result(res);
 }
 
+/**
+   Runs a test of the allocation of nodes with int keys and int elements
+   from a pool, including the reuse of deleted nodes, and compares the
+   prepend and free times with the allocation of nodes without a pool.
+*/
+void run_pool_int_test(int log_ins){
+  int res = 1;
+  int i, num_ins;
+  int sum = 0, exp_sum = 0;
+  size_t key_size = sizeof(int);
+  size_t elt_size = sizeof(int);
+  dll_t ll;
+  dll_pool_t pool;
+  dll_node_t *head = NULL, *node = NULL;
+  clock_t t_prep, t_prep_pool, t_free, t_free_pool;
+  num_ins = pow_two_perror(log_ins);
+  dll_init(&ll, &head, key_size);
+  dll_align_elt(&ll, sizeof(int));
+  printf("Run a pool test on int keys and int elements\n");
+  printf("\t# nodes: %d\n", num_ins);
+  t_prep = clock();
+  for (i = 0; i < num_ins; i++){
+    dll_prepend_new(&ll, &head, &i, &i, key_size, elt_size);
+  }
+  t_prep = clock() - t_prep;
+  t_free = clock();
+  dll_free(&ll, &head, NULL);
+  t_free = clock() - t_free;
+  dll_pool_init(&ll, &pool, elt_size, 0);
+  t_prep_pool = clock();
+  for (i = 0; i < num_ins; i++){
+    dll_prepend_new_pool(&ll, &pool, &head, &i, &i, key_size, elt_size);
+  }
+  t_prep_pool = clock() - t_prep_pool;
+  /* delete every second node and reuse the nodes */
+  node = head;
+  for (i = 0; i < num_ins; i++){
+    res *= (*(int *)dll_key_ptr(&ll, node) == num_ins - 1 - i &&
+	    *(int *)dll_elt_ptr(&ll, node) == num_ins - 1 - i);
+    node = node->next;
+    if (i & 1){
+      dll_delete_pool(&ll, &pool, &head, node->prev, NULL);
+    }else{
+      exp_sum += num_ins - 1 - i;
+    }
+  }
+  for (i = 0; i < num_ins / 2; i++){
+    dll_append_new_pool(&ll, &pool, &head, &i, &i, key_size, elt_size);
+    exp_sum += i;
+  }
+  res *= (pool.free_nodes == NULL);
+  node = head;
+  for (i = 0; i < num_ins; i++){
+    sum += *(int *)dll_elt_ptr(&ll, node);
+    node = node->next;
+  }
+  res *= (node == head && sum == exp_sum);
+  t_free_pool = clock();
+  dll_free_pool(&ll, &pool, &head, NULL);
+  dll_pool_free(&pool);
+  t_free_pool = clock() - t_free_pool;
+  res *= (head == NULL && pool.blk == NULL);
+  printf("\t\tprepend time:            %.4f seconds\n",
+	 (float)t_prep / CLOCKS_PER_SEC);
+  printf("\t\tprepend time (pool):     %.4f seconds\n",
+	 (float)t_prep_pool / CLOCKS_PER_SEC);
+  printf("\t\tfree time:               %.4f seconds\n",
+	 (float)t_free / CLOCKS_PER_SEC);
+  printf("\t\tfree time (pool):        %.4f seconds\n",
+	 (float)t_free_pool / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:             ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of a list in the intrusive mode, where the nodes are
+   embedded in user-owned objects with int keys and int elements, including
+   prepend, append, search, remove, and move-to-front operations, and
+   compares the prepend time with the allocation of nodes by the list.
+*/
+
+typedef struct{
+  int key;
+  dll_node_t node;
+  int elt;
+} intr_obj_t;
+
+void run_intrusive_int_test(int log_ins){
+  int res = 1;
+  int i, num_ins, step;
+  size_t key_size = sizeof(int);
+  size_t elt_size = sizeof(int);
+  dll_t ll, ll_new;
+  dll_node_t *head = NULL, *head_new = NULL, *node = NULL;
+  intr_obj_t *objs = NULL;
+  clock_t t_prep, t_prep_new, t_search, t_search_uq;
+  num_ins = pow_two_perror(log_ins);
+  step = (num_ins > C_INTR_NUM_SEARCH) ? num_ins / C_INTR_NUM_SEARCH : 1;
+  objs = malloc_perror(num_ins, sizeof(intr_obj_t));
+  for (i = 0; i < num_ins; i++){
+    objs[i].key = i;
+    objs[i].elt = num_ins - i;
+  }
+  dll_init_intr(&ll,
+		&head,
+		offsetof(intr_obj_t, key),
+		offsetof(intr_obj_t, node),
+		offsetof(intr_obj_t, elt));
+  dll_init(&ll_new, &head_new, key_size);
+  dll_align_elt(&ll_new, sizeof(int));
+  printf("Run an intrusive mode test on int keys and int elements\n");
+  printf("\t# nodes: %d, # searched keys: %d\n",
+	 num_ins, (num_ins + step - 1) / step);
+  t_prep = clock();
+  for (i = 0; i < num_ins; i++){
+    if (i & 1){
+      dll_append(&head, &objs[i].node);
+    }else{
+      dll_prepend(&head, &objs[i].node);
+    }
+  }
+  t_prep = clock() - t_prep;
+  t_prep_new = clock();
+  for (i = 0; i < num_ins; i++){
+    dll_prepend_new(&ll_new, &head_new, &i, &i, key_size, elt_size);
+  }
+  t_prep_new = clock() - t_prep_new;
+  dll_free(&ll_new, &head_new, NULL);
+  /* order and embedded blocks */
+  node = head;
+  for (i = num_ins - 1 - ((num_ins - 1) & 1); i >= 0; i -= 2){
+    res *= (node == &objs[i].node &&
+	    dll_key_ptr(&ll, node) == (void *)&objs[i].key &&
+	    dll_elt_ptr(&ll, node) == (void *)&objs[i].elt);
+    node = node->next;
+  }
+  for (i = 1; i < num_ins; i += 2){
+    res *= (node == &objs[i].node);
+    node = node->next;
+  }
+  res *= (node == head);
+  /* search embedded keys */
+  t_search = clock();
+  for (i = 0; i < num_ins; i += step){
+    node = dll_search_key(&ll, &head, &i, key_size, NULL);
+    res *= (node == &objs[i].node &&
+	    *(int *)dll_elt_ptr(&ll, node) == num_ins - i);
+  }
+  t_search = clock() - t_search;
+  t_search_uq = clock();
+  for (i = 0; i < num_ins; i += step){
+    node = dll_search_uq_key(&ll, &head, &i, key_size, cmp_int);
+    res *= (node == &objs[i].node);
+  }
+  t_search_uq = clock() - t_search_uq;
+  res *= (dll_search_key(&ll, &head, &num_ins, key_size, cmp_int) == NULL);
+  res *= (dll_search_uq_key(&ll, &head, &num_ins, key_size, NULL) == NULL);
+  /* move to front, as in a LRU list, and remove */
+  for (i = 0; i < num_ins; i++){
+    dll_remove(&head, &objs[i].node);
+    dll_prepend(&head, &objs[i].node);
+    res *= (head == &objs[i].node);
+  }
+  node = head;
+  for (i = num_ins - 1; i >= 0; i--){
+    res *= (node == &objs[i].node);
+    node = node->next;
+  }
+  for (i = 0; i < num_ins; i += 2){
+    dll_remove(&head, &objs[i].node);
+  }
+  for (i = 0; i < num_ins; i += step){
+    node = dll_search_key(&ll, &head, &i, key_size, NULL);
+    res *= ((i & 1) ? node == &objs[i].node : node == NULL);
+  }
+  for (i = 1; i < num_ins; i += 2){
+    dll_remove(&head, &objs[i].node);
+  }
+  res *= (head == NULL);
+  for (i = 0; i < num_ins; i++){
+    res *= (objs[i].key == i && objs[i].elt == num_ins - i);
+  }
+  printf("\t\tprepend/append time:     %.4f seconds\n",
+	 (float)t_prep / CLOCKS_PER_SEC);
+  printf("\t\tprepend time (new node): %.4f seconds\n",
+	 (float)t_prep_new / CLOCKS_PER_SEC);
+  printf("\t\tsearch key time:         %.4f seconds\n",
+	 (float)t_search / CLOCKS_PER_SEC);
+  printf("\t\tsearch uq key time:      %.4f seconds\n",
+	 (float)t_search_uq / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:             ");
+  print_test_result(res);
+  free(objs);
+  objs = NULL;
+}
+
 /** Helper functions */
 
 /**
@@ -461,7 +665,9 @@ int main(int argc, char *argv[]){
   if (args[0] > C_INT_BIT - 3 ||
       args[1] > 1 ||
       args[2] > 1 ||
-      args[3] > 1){
+      args[3] > 1 ||
+      args[4] > 1 ||
+      args[5] > 1){
     fprintf(stderr, "USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -474,6 +680,12 @@ int main(int argc, char *argv[]){
   if (args[3]){
     run_corner_cases_test();
   }
+  if (args[4]){
+    run_pool_int_test(args[0]);
+  }
+  if (args[5]){
+    run_intrusive_int_test(args[0]);
+  }
   free(args);
   args = NULL;
   return 0;
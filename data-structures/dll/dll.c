@@ -18,6 +18,15 @@
    object within a contiguous memory block (e.g. basic type, array, or
    struct). An element is contiguous or non-contiguous.
 
+   Optionally, nodes are allocated from a dll_pool_t pool that allocates
+   blocks of nodes and keeps the nodes of deleted nodes for reuse, thus
+   replacing a malloc and free call per node with a small number of calls
+   per pool, and freeing the nodes of lists in a pool at once.
+
+   Optionally, a list is initialized in the intrusive mode, where the
+   dll_node_t structs are embedded in user-owned objects and are linked
+   without an allocation or a copy of a key and an element.
+
    The implementation provides a guarantee that a key, a dll_node_t struct,
    and an element/element pointer belonging to the same node keep their
    addresses in memory throughout the lifetime of the node in a list. The
@@ -47,6 +56,26 @@
 #include "dll.h"
 #include "utilities-mem.h"
 
+/**
+   A node block in a pool is aligned to C_POOL_ALIGN, which is a multiple
+   of the alignment requirements of the types in pool_align_t, to be
+   accessible as a malloc'ed block.
+*/
+typedef union{
+  long l;
+  double d;
+  long double ld;
+  void *p;
+  void (*f)(void);
+} pool_align_t;
+
+static const size_t C_POOL_ALIGN = sizeof(pool_align_t);
+static const size_t C_POOL_BLK_COUNT_MIN = 16;
+static const size_t C_POOL_BLK_COUNT_MAX = 65536; /* stop doubling */
+
+static dll_node_t *pool_node_new(const dll_t *ll, dll_pool_t *pool);
+static void fprintf_stderr_exit(const char *s, int line);
+
 /**
    Initializes an empty doubly linked list by setting a head pointer to NULL
    and key_offset and elt_offset in a dll_t struct to values according to
@@ -83,6 +112,40 @@ void dll_init(dll_t *ll,
   *head = NULL;
 }
 
+/**
+   Initializes an empty doubly linked list in the intrusive mode, where a
+   dll_node_t struct is embedded in a user-defined object, together with
+   a key and optionally an element, and the object is linked with
+   dll_prepend and dll_append without an allocation or a copy. The offsets
+   are the offsets in bytes of the key, embedded dll_node_t struct, and
+   element from the beginning of an object, e.g. as provided by offsetof,
+   and follow the order of the blocks in a node created by the list. Given
+   the offsets, dll_key_ptr, dll_elt_ptr, dll_search_key, and
+   dll_search_uq_key are applied to the embedded nodes and keys in the same
+   manner as to the nodes created by the list. dll_remove unlinks an
+   object, and the objects remain owned by the user; the operations that
+   create, delete, or free nodes are not called on a list in the intrusive
+   mode. If an element is not in an object, elt_offset can be any value
+   greater or equal to node_offset.
+   ll          : pointer to a preallocated block of size sizeof(dll_t)
+   head        : pointer to a preallocated block of size of a head pointer
+   key_offset  : offset of a key, less or equal to node_offset
+   node_offset : offset of an embedded dll_node_t struct
+   elt_offset  : offset of an element, greater or equal to node_offset
+*/
+void dll_init_intr(dll_t *ll,
+		   dll_node_t **head,
+		   size_t key_offset,
+		   size_t node_offset,
+		   size_t elt_offset){
+  if (key_offset > node_offset || elt_offset < node_offset){
+    fprintf_stderr_exit("intrusive offsets out of order", __LINE__);
+  }
+  ll->key_offset = node_offset - key_offset;
+  ll->elt_offset = elt_offset - node_offset;
+  *head = NULL;
+}
+
 /**
    Aligns each in-list elt_size block to be accessible with a pointer to a 
    type T other than character (in addition to a character pointer). If
@@ -394,3 +457,167 @@ void dll_free(const dll_t *ll,
   }
   *head = NULL;
 }
+
+/**
+   Initializes a pool of nodes for a list, or for lists with the same
+   offsets and element size, e.g. the lists of a hash table. A key in a
+   node of a pool can be accessed with a pointer to any type with which a
+   malloc'ed block can be accessed, and an element is aligned according to
+   dll_align_elt. The operation is called after dll_init and dll_align_elt
+   are completed.
+   ll          : pointer to an initialized dll_t struct
+   pool        : pointer to a preallocated block of size sizeof(dll_pool_t)
+   elt_size    : non-zero size of an element or a pointer to an element
+   min_num     : minimum number of nodes that are known or expected to be in
+                 the lists of a pool simultaneously, resulting in fewer
+                 allocations at the beginning; 0 if a positive value is not
+                 specified
+*/
+void dll_pool_init(const dll_t *ll,
+		   dll_pool_t *pool,
+		   size_t elt_size,
+		   size_t min_num){
+  size_t rem;
+  pool->node_size = add_sz_perror(ll->key_offset,
+				  add_sz_perror(ll->elt_offset, elt_size));
+  rem = pool->node_size % C_POOL_ALIGN;
+  pool->node_size = add_sz_perror(pool->node_size,
+				  (rem > 0) * (C_POOL_ALIGN - rem));
+  pool->blk_count = (min_num > C_POOL_BLK_COUNT_MIN) ?
+    min_num : C_POOL_BLK_COUNT_MIN;
+  pool->num_unused = 0;
+  pool->blk = NULL;
+  pool->free_nodes = NULL;
+}
+
+/**
+   Creates a node from a pool and prepends the node relative to a head
+   pointer. Please see the parameter specification in dll_prepend_new.
+*/
+void dll_prepend_new_pool(const dll_t *ll,
+			  dll_pool_t *pool,
+			  dll_node_t **head,
+			  const void *key,
+			  const void *elt,
+			  size_t key_size,
+			  size_t elt_size){
+  dll_node_t *node = pool_node_new(ll, pool);
+  memcpy(dll_key_ptr(ll, node), key, key_size);
+  memcpy(dll_elt_ptr(ll, node), elt, elt_size);
+  dll_prepend(head, node);
+}
+
+/**
+   Creates a node from a pool and appends the node relative to a head
+   pointer. Please see the parameter specification in dll_prepend_new.
+*/
+void dll_append_new_pool(const dll_t *ll,
+			 dll_pool_t *pool,
+			 dll_node_t **head,
+			 const void *key,
+			 const void *elt,
+			 size_t key_size,
+			 size_t elt_size){
+  dll_prepend_new_pool(ll, pool, head, key, elt, key_size, elt_size);
+  *head = (*head)->next;
+}
+
+/**
+   Deletes a node that was created from a pool and keeps the node in the
+   pool pointed to by the pool parameter for reuse. The node may be created
+   from another pool with the same node size, if the pools are freed
+   together. Please see the parameter specification in dll_delete.
+*/
+void dll_delete_pool(const dll_t *ll,
+		     dll_pool_t *pool,
+		     dll_node_t **head,
+		     dll_node_t *node,
+		     void (*free_elt)(void *)){
+  if (*head == NULL || node == NULL) return;
+  if (free_elt != NULL) free_elt(dll_elt_ptr(ll, node));
+  dll_remove(head, node);
+  node->next = pool->free_nodes;
+  pool->free_nodes = node;
+}
+
+/**
+   Frees a list with nodes created from a pool, and keeps the nodes in the
+   pool pointed to by the pool parameter for reuse. If free_elt is NULL, the
+   operation is completed in constant time. Please see the parameter
+   specification in dll_delete_pool.
+*/
+void dll_free_pool(const dll_t *ll,
+		   dll_pool_t *pool,
+		   dll_node_t **head,
+		   void (*free_elt)(void *)){
+  dll_node_t *node = *head;
+  if (node == NULL) return;
+  (*head)->prev->next = NULL;
+  if (free_elt != NULL){
+    while (node != NULL){
+      free_elt(dll_elt_ptr(ll, node));
+      node = node->next;
+    }
+  }
+  /* splice the list into the nodes for reuse */
+  (*head)->prev->next = pool->free_nodes;
+  pool->free_nodes = *head;
+  *head = NULL;
+}
+
+/**
+   Frees a pool and its nodes at once. The operation is called after the
+   lists with nodes created from the pool, or kept in the pool, are freed
+   with dll_free_pool, or are not accessed any more, if free_elt is not
+   necessary to delete the elements. Leaves a block of size
+   sizeof(dll_pool_t) pointed to by the pool parameter.
+*/
+void dll_pool_free(dll_pool_t *pool){
+  void *prev_blk = NULL;
+  while (pool->blk != NULL){
+    prev_blk = *(void **)pool->blk;
+    free(pool->blk);
+    pool->blk = prev_blk;
+  }
+  pool->num_unused = 0;
+  pool->free_nodes = NULL;
+}
+
+/**
+   Returns a node for reuse from a pool, or a never used node from the last
+   allocated block of the pool. If neither is available, allocates a block
+   with a pointer to the previous block, followed by blk_count node blocks,
+   and doubles blk_count upto C_POOL_BLK_COUNT_MAX.
+*/
+static dll_node_t *pool_node_new(const dll_t *ll, dll_pool_t *pool){
+  dll_node_t *node = NULL;
+  void *blk = NULL;
+  if (pool->free_nodes != NULL){
+    node = pool->free_nodes;
+    pool->free_nodes = node->next;
+    return node;
+  }
+  if (pool->num_unused == 0){
+    blk = malloc_perror(1, add_sz_perror(C_POOL_ALIGN,
+					 mul_sz_perror(pool->blk_count,
+						       pool->node_size)));
+    *(void **)blk = pool->blk;
+    pool->blk = blk;
+    pool->num_unused = pool->blk_count;
+    if (pool->blk_count < C_POOL_BLK_COUNT_MAX) pool->blk_count <<= 1;
+  }
+  pool->num_unused--;
+  node = (dll_node_t *)((char *)pool->blk +
+			C_POOL_ALIGN +
+			pool->num_unused * pool->node_size +
+			ll->key_offset);
+  return node;
+}
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
+}
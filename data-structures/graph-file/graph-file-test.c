@@ -0,0 +1,393 @@
+/**
+   graph-file-test.c
+
+   Tests of writing the lists of graphs with generic integer vertices and
+   generic weights to binary files, and of mapping binary files into memory
+   as CSR adjacency lists.
+
+   The following command line arguments can be used to customize tests:
+   graph-file-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, bit width of size_t / 2] : m for 2**m edges per vertex
+      [0, 1] : small graph test on/off
+      [0, 1] : random graph test on/off
+
+   usage examples:
+   ./graph-file-test
+   ./graph-file-test 10 20
+   ./graph-file-test 20 20 4 0 1
+
+   graph-file-test can be run with any subset of command line arguments in
+   the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The tests write and remove a file at C_PATH in the working directory. A
+   file with a corrupted header is mapped in a child process created with
+   fork, which is expected to exit with EXIT_FAILURE.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the POSIX mmap and fork APIs are
+   available.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "graph-file.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "graph-file-test \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph \n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph \n"
+  "[0, bit width of size_t / 2] : m for 2**m edges per vertex \n"
+  "[0, 1] : small graph test on/off \n"
+  "[0, 1] : random graph test on/off \n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 14, 3, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const char *C_PATH = "graph-file-test.bin";
+
+/* small graph tests */
+const size_t C_NUM_VTS = 5;
+const size_t C_NUM_ES = 5;
+const size_t C_U[5] = {0, 0, 0, 1, 4};
+const size_t C_V[5] = {1, 2, 3, 3, 4};
+const double C_WTS[5] = {4.0, 3.0, 2.0, 1.0, 0.0};
+
+/* corrupted header tests: positions of size_t values after the magic */
+const size_t C_MAGIC_SIZE = 8;
+const size_t C_H_NUM_ES = 4;
+const size_t C_H_PAIR_SIZE = 7;
+const size_t C_H_WT_OFFSET = 8;
+
+void small_graph_init(graph_t *g);
+void rand_graph_init(graph_t *g, size_t num_vts, size_t num_es);
+int map_fails(const adj_lst_t *a, size_t i, size_t val);
+int same_csr(const adj_lst_t *a, const adj_csr_t *c);
+void print_test_result(int res);
+
+/**
+   Runs a test of writing and mapping the lists of a small graph with
+   double weights and a self-loop, with default and non-default alignment,
+   and of a graph without edges.
+*/
+void run_small_graph_test(){
+  size_t i;
+  int res = 1;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c, c_map;
+  small_graph_init(&g);
+  printf("Run write and map tests on a small graph with %lu edges\n",
+	 TOLU(g.num_es));
+  for (i = 0; i < 2; i++){
+    adj_lst_base_init(&a, &g);
+    adj_csr_base_init(&c, &g);
+    if (i){
+      adj_lst_align(&a, sizeof(size_t), sizeof(double) * 2);
+      adj_csr_align(&c, sizeof(size_t), sizeof(double) * 2);
+    }
+    adj_lst_undir_build(&a, &g);
+    adj_csr_undir_build(&c, &g);
+    adj_lst_file_write(&a, C_PATH);
+    adj_csr_file_map(&c_map,
+		     C_PATH,
+		     g.vt_size,
+		     g.wt_size,
+		     g.read_vt,
+		     g.write_vt);
+    res *= (c_map.pair_size == a.pair_size && c_map.wt_offset == a.wt_offset);
+    res *= same_csr(&a, &c_map);
+    adj_csr_file_unmap(&c_map);
+    adj_csr_file_write(&c, C_PATH);
+    adj_csr_file_map(&c_map,
+		     C_PATH,
+		     g.vt_size,
+		     g.wt_size,
+		     g.read_vt,
+		     g.write_vt);
+    res *= same_csr(&a, &c_map);
+    adj_csr_file_unmap(&c_map);
+    res *= (c_map.offsets == NULL && c_map.vt_wts == NULL);
+    adj_lst_free(&a);
+    adj_csr_free(&c);
+  }
+  graph_free(&g);
+  graph_base_init(&g,
+		  C_NUM_VTS,
+		  sizeof(unsigned char),
+		  sizeof(double),
+		  graph_read_uchar,
+		  graph_write_uchar);
+  adj_lst_base_init(&a, &g);
+  adj_lst_dir_build(&a, &g);
+  adj_lst_file_write(&a, C_PATH);
+  adj_csr_file_map(&c_map,
+		   C_PATH,
+		   g.vt_size,
+		   g.wt_size,
+		   g.read_vt,
+		   g.write_vt);
+  res *= (c_map.num_es == 0 && c_map.vt_wts == NULL);
+  res *= same_csr(&a, &c_map);
+  adj_csr_file_unmap(&c_map);
+  adj_lst_free(&a);
+  graph_free(&g);
+  remove(C_PATH);
+  printf("\tcorrectness:                          ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of mapping the files of a small graph after a size_t value
+   of the header is set to a pair size, a weight offset, or a number of
+   edges that does not match the sizes or the offsets, and of mapping a
+   file after a value is set to its written value.
+*/
+void run_corrupt_header_test(){
+  int res = 1;
+  graph_t g;
+  adj_lst_t a;
+  small_graph_init(&g);
+  adj_lst_base_init(&a, &g);
+  adj_lst_undir_build(&a, &g);
+  printf("Run map tests on a small graph file with a corrupted header\n");
+  res *= !map_fails(&a, C_H_PAIR_SIZE, a.pair_size);
+  res *= !map_fails(&a, C_H_WT_OFFSET, a.wt_offset);
+  res *= !map_fails(&a, C_H_NUM_ES, a.num_es);
+  res *= map_fails(&a, C_H_PAIR_SIZE, a.wt_offset + a.wt_size - 1);
+  res *= map_fails(&a, C_H_PAIR_SIZE, a.vt_size);
+  res *= map_fails(&a, C_H_WT_OFFSET, a.vt_size - 1);
+  res *= map_fails(&a, C_H_WT_OFFSET, a.pair_size - a.wt_size + 1);
+  res *= map_fails(&a, C_H_NUM_ES, a.num_es + 1);
+  res *= map_fails(&a, C_H_NUM_ES, a.num_es - 1);
+  adj_lst_free(&a);
+  graph_free(&g);
+  remove(C_PATH);
+  printf("\tcorrectness:                          ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of writing and mapping the lists of random graphs with size_t
+   weights, comparing the time of mapping a file with the time of building
+   a CSR adjacency list.
+*/
+void run_rand_graph_test(size_t log_start, size_t log_end, size_t log_deg){
+  size_t i;
+  int res = 1;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  clock_t t_build, t_write, t_map;
+  printf("Run write and map tests on random graphs\n");
+  for (i = log_start; i <= log_end; i++){
+    rand_graph_init(&g,
+		    pow_two_perror(i),
+		    mul_sz_perror(pow_two_perror(i), pow_two_perror(log_deg)));
+    printf("\tvertices: %lu, edges: %lu\n", TOLU(g.num_vts), TOLU(g.num_es));
+    adj_lst_base_init(&a, &g);
+    adj_csr_base_init(&c, &g);
+    adj_lst_dir_build(&a, &g);
+    t_build = clock();
+    adj_csr_dir_build(&c, &g);
+    t_build = clock() - t_build;
+    t_write = clock();
+    adj_csr_file_write(&c, C_PATH);
+    t_write = clock() - t_write;
+    adj_csr_free(&c);
+    t_map = clock();
+    adj_csr_file_map(&c, C_PATH, g.vt_size, g.wt_size, g.read_vt, g.write_vt);
+    t_map = clock() - t_map;
+    res *= same_csr(&a, &c);
+    adj_csr_file_unmap(&c);
+    adj_lst_free(&a);
+    printf("\t\tdir adj_csr build time:          %.6f seconds\n"
+	   "\t\tdir adj_csr write time:          %.6f seconds\n"
+	   "\t\tdir adj_csr map time:            %.6f seconds\n",
+	   (double)t_build / CLOCKS_PER_SEC,
+	   (double)t_write / CLOCKS_PER_SEC,
+	   (double)t_map / CLOCKS_PER_SEC);
+    adj_lst_base_init(&a, &g);
+    adj_lst_undir_build(&a, &g);
+    adj_lst_file_write(&a, C_PATH);
+    adj_csr_file_map(&c, C_PATH, g.vt_size, g.wt_size, g.read_vt, g.write_vt);
+    res *= same_csr(&a, &c);
+    adj_csr_file_unmap(&c);
+    adj_lst_free(&a);
+    graph_free(&g);
+    printf("\t\tcorrectness:                     ");
+    print_test_result(res);
+    res = 1;
+  }
+  remove(C_PATH);
+}
+
+/**
+   Initializes a graph with random edges and random size_t weights.
+*/
+/**
+   Initializes the small graph with unsigned char vertices and double
+   weights.
+*/
+void small_graph_init(graph_t *g){
+  size_t i;
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(unsigned char),
+		  sizeof(double),
+		  graph_read_uchar,
+		  graph_write_uchar);
+  g->num_es = C_NUM_ES;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  for (i = 0; i < g->num_es; i++){
+    *((unsigned char *)g->u + i) = C_U[i];
+    *((unsigned char *)g->v + i) = C_V[i];
+    *((double *)g->wts + i) = C_WTS[i];
+  }
+}
+
+void rand_graph_init(graph_t *g, size_t num_vts, size_t num_es){
+  size_t i;
+  graph_base_init(g,
+		  num_vts,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
+  g->num_es = num_es;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  for (i = 0; i < g->num_es; i++){
+    *((size_t *)g->u + i) = RANDOM() % num_vts;
+    *((size_t *)g->v + i) = RANDOM() % num_vts;
+    *((size_t *)g->wts + i) = RANDOM();
+  }
+}
+
+/**
+   Compares the lists of an adjacency list and a CSR adjacency list.
+*/
+int same_csr(const adj_lst_t *a, const adj_csr_t *c){
+  int res = 1;
+  size_t i, j;
+  size_t num_a, num_c;
+  const char *pa = NULL, *pc = NULL;
+  res *= (a->num_vts == c->num_vts && a->num_es == c->num_es);
+  for (i = 0; i < a->num_vts && res; i++){
+    pa = adj_lst_vt_wts(a, i, &num_a);
+    pc = adj_csr_vt_wts(c, i, &num_c);
+    res *= (num_a == num_c);
+    for (j = 0; j < num_a && res; j++){
+      res *= (a->read_vt(pa) == c->read_vt(pc));
+      res *= (memcmp(pa + a->wt_offset, pc + c->wt_offset, a->wt_size) == 0);
+      pa += a->pair_size;
+      pc += c->pair_size;
+    }
+  }
+  return res;
+}
+
+/**
+   Writes the lists of an adjacency list to a file at C_PATH, sets the ith
+   size_t value of the header to val, and maps the file in a child
+   process. Returns 1 if the child process exited with EXIT_FAILURE,
+   otherwise returns 0.
+*/
+int map_fails(const adj_lst_t *a, size_t i, size_t val){
+  int status;
+  pid_t pid;
+  adj_csr_t c;
+  FILE *f = NULL;
+  adj_lst_file_write(a, C_PATH);
+  f = fopen(C_PATH, "r+b");
+  if (f == NULL ||
+      fseek(f, (long)(C_MAGIC_SIZE + i * sizeof(size_t)), SEEK_SET) != 0 ||
+      fwrite(&val, sizeof(size_t), 1, f) != 1 ||
+      fclose(f) != 0){
+    perror("graph file test write failed");
+    exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  fflush(stderr);
+  pid = fork();
+  if (pid == 0){
+    /* an error message of a rejected file is not printed */
+    if (freopen("/dev/null", "w", stderr) == NULL) _exit(EXIT_SUCCESS);
+    adj_csr_file_map(&c, C_PATH, a->vt_size, a->wt_size,
+		     a->read_vt, a->write_vt);
+    adj_csr_file_unmap(&c);
+    exit(EXIT_SUCCESS);
+  }
+  if (pid < 0 || waitpid(pid, &status, 0) != pid) return 0;
+  return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_FULL_BIT / 2 ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]){
+    run_small_graph_test();
+    run_corrupt_header_test();
+  }
+  if (args[4]) run_rand_graph_test(args[0], args[1], args[2]);
+  free(args);
+  args = NULL;
+  return 0;
+}
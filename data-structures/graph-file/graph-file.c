@@ -0,0 +1,263 @@
+/**
+   graph-file.c
+
+   Functions for writing the lists of a graph with generic integer vertices
+   and generic weights to a binary file, and for mapping a binary file into
+   memory as a read-only CSR adjacency list without copying.
+
+   The header, offsets, and block of vertex weight pairs are written in
+   this order with the stdio API. A file is mapped with a single mmap call
+   after its header is validated against the size of the file and the
+   vertex and weight sizes provided by the user. The offsets and vt_wts
+   pointers of a mapped CSR adjacency list point into the mapping, and no
+   list is copied or parsed after mapping.
+
+   The implementation provides an error message and an exit is executed if
+   a file operation fails or a file is not in the format. The
+   implementation does not use stdint.h and is portable under C89/C90 and
+   C99 with the requirement that the POSIX mmap API is available.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "graph-file.h"
+#include "graph.h"
+#include "utilities-mem.h"
+
+#define MAGIC_SIZE 8
+
+static const char C_MAGIC[MAGIC_SIZE] = {'C', 'S', 'R', 'G', 'R', 'P', 'H',
+					 '\0'};
+static const size_t C_BYTE_ORDER = 0x0304;
+static const size_t C_VERSION = 1;
+
+/* positions in the size_t array of a header */
+enum{H_SIZE_SZ,
+     H_BYTE_ORDER,
+     H_VERSION,
+     H_NUM_VTS,
+     H_NUM_ES,
+     H_VT_SIZE,
+     H_WT_SIZE,
+     H_PAIR_SIZE,
+     H_WT_OFFSET,
+     H_ALIGNMENT,
+     H_OFFSETS_POS,
+     H_PAIRS_POS,
+     H_FILE_SIZE,
+     H_COUNT};
+
+static void file_write(const adj_view_t *w, const char *path);
+static void header_init(size_t *h, const adj_view_t *w, size_t num_pairs);
+static size_t round_up(size_t n, size_t k);
+static void fwrite_perror(const void *s, size_t size, FILE *f);
+static void file_error_exit(const char *s, const char *path);
+
+/**
+   Writes the lists of an adjacency list or a CSR adjacency list to a
+   binary file at path. The file is created or truncated.
+   a           : pointer to an adjacency list
+   c           : pointer to a CSR adjacency list
+   path        : path of a file
+*/
+void adj_lst_file_write(const adj_lst_t *a, const char *path){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  file_write(&w, path);
+}
+
+void adj_csr_file_write(const adj_csr_t *c, const char *path){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  file_write(&w, path);
+}
+
+/**
+   Maps a binary file at path into memory as a read-only CSR adjacency
+   list. The offsets and vt_wts pointers of the CSR adjacency list point
+   into the mapping, which is shared across the processes mapping the file.
+   A CSR adjacency list initialized with adj_csr_file_map is released with
+   adj_csr_file_unmap and not with adj_csr_free, and is not modified.
+   c           : pointer to a preallocated block of size sizeof(adj_csr_t)
+   path        : path of a file written with adj_lst_file_write or
+                 adj_csr_file_write
+   vt_size     : size of a vertex, checked against the file
+   wt_size     : size of a weight, checked against the file
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+*/
+void adj_csr_file_map(adj_csr_t *c,
+		      const char *path,
+		      size_t vt_size,
+		      size_t wt_size,
+		      size_t (*read_vt)(const void *),
+		      void (*write_vt)(void *, size_t)){
+  int fd;
+  size_t i;
+  size_t h[H_COUNT];
+  size_t offsets_size;
+  char *base = NULL;
+  const size_t *offsets = NULL;
+  struct stat st;
+  fd = open(path, O_RDONLY);
+  if (fd < 0) file_error_exit("graph file open failed", path);
+  if (fstat(fd, &st) < 0) file_error_exit("graph file stat failed", path);
+  if (st.st_size < (off_t)(MAGIC_SIZE + sizeof(h))){
+    file_error_exit("graph file is too short", path);
+  }
+  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) file_error_exit("graph file mmap failed", path);
+  close(fd); /* the mapping remains valid */
+  memcpy(h, base + MAGIC_SIZE, sizeof(h));
+  if (memcmp(base, C_MAGIC, MAGIC_SIZE) != 0 ||
+      h[H_SIZE_SZ] != sizeof(size_t) ||
+      h[H_BYTE_ORDER] != C_BYTE_ORDER){
+    file_error_exit("graph file format or system mismatch", path);
+  }
+  if (h[H_VERSION] != C_VERSION ||
+      h[H_VT_SIZE] != vt_size ||
+      h[H_WT_SIZE] != wt_size ||
+      h[H_WT_OFFSET] < vt_size ||
+      h[H_PAIR_SIZE] < add_sz_perror(h[H_WT_OFFSET], wt_size) ||
+      h[H_ALIGNMENT] != GRAPH_FILE_ALIGNMENT ||
+      h[H_OFFSETS_POS] != MAGIC_SIZE + sizeof(h) ||
+      h[H_FILE_SIZE] != (size_t)st.st_size){
+    file_error_exit("graph file header mismatch", path);
+  }
+  offsets_size = mul_sz_perror(add_sz_perror(h[H_NUM_VTS], 1),
+			       sizeof(size_t));
+  if (h[H_PAIRS_POS] < add_sz_perror(h[H_OFFSETS_POS], offsets_size) ||
+      h[H_PAIRS_POS] % GRAPH_FILE_ALIGNMENT != 0 ||
+      h[H_PAIRS_POS] > h[H_FILE_SIZE]){
+    file_error_exit("graph file header mismatch", path);
+  }
+  offsets = (const size_t *)(base + h[H_OFFSETS_POS]);
+  for (i = 0; i < h[H_NUM_VTS]; i++){
+    if (offsets[i] > offsets[i + 1]){
+      file_error_exit("graph file offsets mismatch", path);
+    }
+  }
+  if (offsets[0] != 0 ||
+      offsets[h[H_NUM_VTS]] != h[H_NUM_ES] ||
+      h[H_FILE_SIZE] - h[H_PAIRS_POS] !=
+      mul_sz_perror(offsets[h[H_NUM_VTS]], h[H_PAIR_SIZE])){
+    file_error_exit("graph file offsets mismatch", path);
+  }
+  c->num_vts = h[H_NUM_VTS];
+  c->num_es = h[H_NUM_ES];
+  c->vt_size = vt_size;
+  c->wt_size = wt_size;
+  c->pair_size = h[H_PAIR_SIZE];
+  c->wt_offset = h[H_WT_OFFSET];
+  c->offsets = (size_t *)offsets;
+  c->vt_wts = (offsets[c->num_vts] > 0) ? base + h[H_PAIRS_POS] : NULL;
+  c->read_vt = read_vt;
+  c->write_vt = write_vt;
+}
+
+/**
+   Unmaps a CSR adjacency list initialized with adj_csr_file_map, and
+   leaves a block of size sizeof(adj_csr_t) pointed to by the c parameter.
+*/
+void adj_csr_file_unmap(adj_csr_t *c){
+  size_t h[H_COUNT];
+  char *base = (char *)c->offsets - (MAGIC_SIZE + sizeof(h));
+  memcpy(h, base + MAGIC_SIZE, sizeof(h));
+  if (munmap(base, h[H_FILE_SIZE]) < 0){
+    perror("graph file munmap failed");
+    exit(EXIT_FAILURE);
+  }
+  c->offsets = NULL;
+  c->vt_wts = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Writes the header, offsets, and lists of an adjacency list viewed
+   through w to a binary file at path.
+*/
+static void file_write(const adj_view_t *w, const char *path){
+  size_t i, num = 0, num_pairs = 0;
+  size_t h[H_COUNT];
+  size_t pad;
+  const void *vt_wts = NULL;
+  char zeros[GRAPH_FILE_ALIGNMENT] = {0};
+  FILE *f = NULL;
+  for (i = 0; i < w->num_vts; i++){
+    w->vt_wts(w->adj, i, &num);
+    num_pairs = add_sz_perror(num_pairs, num);
+  }
+  header_init(h, w, num_pairs);
+  f = fopen(path, "wb");
+  if (f == NULL) file_error_exit("graph file open failed", path);
+  fwrite_perror(C_MAGIC, MAGIC_SIZE, f);
+  fwrite_perror(h, sizeof(h), f);
+  num_pairs = 0;
+  fwrite_perror(&num_pairs, sizeof(size_t), f);
+  for (i = 0; i < w->num_vts; i++){
+    w->vt_wts(w->adj, i, &num);
+    num_pairs += num;
+    fwrite_perror(&num_pairs, sizeof(size_t), f);
+  }
+  pad = h[H_PAIRS_POS] - h[H_OFFSETS_POS] -
+    (w->num_vts + 1) * sizeof(size_t);
+  fwrite_perror(zeros, pad, f);
+  for (i = 0; i < w->num_vts; i++){
+    vt_wts = w->vt_wts(w->adj, i, &num);
+    if (num > 0) fwrite_perror(vt_wts, num * w->pair_size, f);
+  }
+  if (fclose(f) != 0) file_error_exit("graph file close failed", path);
+}
+
+/**
+   Initializes the size_t array of a header.
+*/
+static void header_init(size_t *h, const adj_view_t *w, size_t num_pairs){
+  size_t offsets_size;
+  offsets_size = mul_sz_perror(add_sz_perror(w->num_vts, 1),
+			       sizeof(size_t));
+  h[H_SIZE_SZ] = sizeof(size_t);
+  h[H_BYTE_ORDER] = C_BYTE_ORDER;
+  h[H_VERSION] = C_VERSION;
+  h[H_NUM_VTS] = w->num_vts;
+  h[H_NUM_ES] = w->num_es;
+  h[H_VT_SIZE] = w->vt_size;
+  h[H_WT_SIZE] = w->wt_size;
+  h[H_PAIR_SIZE] = w->pair_size;
+  h[H_WT_OFFSET] = w->wt_offset;
+  h[H_ALIGNMENT] = GRAPH_FILE_ALIGNMENT;
+  h[H_OFFSETS_POS] = MAGIC_SIZE + H_COUNT * sizeof(size_t);
+  h[H_PAIRS_POS] = round_up(add_sz_perror(h[H_OFFSETS_POS], offsets_size),
+			    GRAPH_FILE_ALIGNMENT);
+  h[H_FILE_SIZE] = add_sz_perror(h[H_PAIRS_POS],
+				 mul_sz_perror(num_pairs, w->pair_size));
+}
+
+/**
+   Rounds n up to a multiple of k > 0.
+*/
+static size_t round_up(size_t n, size_t k){
+  size_t rem = n % k;
+  return (rem == 0) ? n : add_sz_perror(n, k - rem);
+}
+
+static void fwrite_perror(const void *s, size_t size, FILE *f){
+  if (size > 0 && fwrite(s, 1, size, f) != size){
+    perror("graph file write failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void file_error_exit(const char *s, const char *path){
+  fprintf(stderr, "%s: %s\n", s, path);
+  exit(EXIT_FAILURE);
+}
@@ -0,0 +1,82 @@
+/**
+   graph-file.h
+
+   Declarations of accessible functions for writing the lists of a graph
+   with generic integer vertices and generic weights to a binary file, and
+   for mapping a binary file into memory as a read-only CSR adjacency list
+   without copying.
+
+   A file consists of i) a header, ii) the num_vts + 1 offsets of the lists
+   as an array of size_t, and iii) the block of vertex weight pairs of all
+   lists. The header consists of an 8-byte magic string followed by an
+   array of size_t values recording the size of size_t, a byte order check
+   value, the format version, num_vts, num_es, vt_size, wt_size, pair_size,
+   wt_offset, the alignment of the block of pairs relative to the beginning
+   of a file, the positions of the offsets and pairs, and the file size.
+   The block of pairs begins at a multiple of GRAPH_FILE_ALIGNMENT, so that
+   in a mapping, which begins at a page boundary, each vertex and weight has
+   the alignment that was set with adj_lst_align or adj_csr_align before
+   a file was written.
+
+   A file is readable on systems with the same size of size_t, byte order
+   and integer representation as the system where the file was written. A
+   mapped adjacency list can be used by functions taking a const pointer to
+   adj_csr_t, such as bfs_csr, dfs_csr, dijkstra_csr, and prim_csr.
+
+   The implementation provides an error message and an exit is executed if
+   a file operation fails or a file is not in the format. The
+   implementation does not use stdint.h and is portable under C89/C90 and
+   C99 with the requirement that the POSIX mmap API is available.
+*/
+
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   The alignment of the block of pairs relative to the beginning of a file.
+   It is a multiple of the alignment requirement of any basic type and a
+   divisor of the page size on current systems.
+*/
+#define GRAPH_FILE_ALIGNMENT 64
+
+/**
+   Writes the lists of an adjacency list or a CSR adjacency list to a
+   binary file at path. The file is created or truncated.
+   a           : pointer to an adjacency list
+   c           : pointer to a CSR adjacency list
+   path        : path of a file
+*/
+void adj_lst_file_write(const adj_lst_t *a, const char *path);
+void adj_csr_file_write(const adj_csr_t *c, const char *path);
+
+/**
+   Maps a binary file at path into memory as a read-only CSR adjacency
+   list. The offsets and vt_wts pointers of the CSR adjacency list point
+   into the mapping, which is shared across the processes mapping the file.
+   A CSR adjacency list initialized with adj_csr_file_map is released with
+   adj_csr_file_unmap and not with adj_csr_free, and is not modified.
+   c           : pointer to a preallocated block of size sizeof(adj_csr_t)
+   path        : path of a file written with adj_lst_file_write or
+                 adj_csr_file_write
+   vt_size     : size of a vertex, checked against the file
+   wt_size     : size of a weight, checked against the file
+   read_vt     : non-NULL pointer to a function for reading a vertex
+   write_vt    : non-NULL pointer to a function for writing a vertex
+*/
+void adj_csr_file_map(adj_csr_t *c,
+		      const char *path,
+		      size_t vt_size,
+		      size_t wt_size,
+		      size_t (*read_vt)(const void *),
+		      void (*write_vt)(void *, size_t));
+
+/**
+   Unmaps a CSR adjacency list initialized with adj_csr_file_map, and
+   leaves a block of size sizeof(adj_csr_t) pointed to by the c parameter.
+*/
+void adj_csr_file_unmap(adj_csr_t *c);
+
+#endif
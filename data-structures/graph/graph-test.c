@@ -10,12 +10,16 @@
       [0, 1] : small graph test on/off
       [0, 1] : non-random graph test on/off
       [0, 1] : random graph test on/off
+      [0, 1] : compressed adjacency list test on/off
+      [0, 1] : relabeling test on/off
 
    usage examples: 
    ./graph-test
    ./graph-test 10 14
    ./graph-test 0 10 0 1 0
    ./graph-test 14 14 0 0 1
+   ./graph-test 10 14 0 0 0 1
+   ./graph-test 10 14 0 0 0 0 1
 
    graph-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -59,9 +63,11 @@ const char *C_USAGE =
   "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph \n"
   "[0, 1] : small graph test on/off \n"
   "[0, 1] : non-random graph test on/off \n"
-  "[0, 1] : random graph test on/off \n";
-const int C_ARGC_MAX = 6;
-const size_t C_ARGS_DEF[5] = {0, 10, 1, 1, 1};
+  "[0, 1] : random graph test on/off \n"
+  "[0, 1] : compressed adjacency list test on/off \n"
+  "[0, 1] : relabeling test on/off \n";
+const int C_ARGC_MAX = 8;
+const size_t C_ARGS_DEF[7] = {0, 10, 1, 1, 1, 1, 1};
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
 /* small graph tests */
@@ -105,6 +111,7 @@ const char *C_VT_TYPES[4] = {"ushort", "uint  ", "ulong ", "sz    "};
 const double C_PROB_ONE = 1.0;
 const double C_PROB_HALF = 0.5;
 const double C_PROB_ZERO = 0.0;
+const size_t C_CMPR_DEG = 16;
 
 void print_uchar(const void *a);
 void print_ulong(const void *a);
@@ -113,6 +120,9 @@ void print_adj_lst(const adj_lst_t *a,
 		   void (*print_vt)(const void *),
 		   void (*print_wt)(const void *));
 size_t sum_vts(const adj_lst_t *a, size_t i);
+int same_lsts(const adj_lst_t *a, const adj_csr_t *c);
+int same_cmpr_lsts(const adj_lst_t *a, const adj_cmpr_t *c);
+int cmp_sz(const void *a, const void *b);
 void print_test_result(int res);
 
 /** 
@@ -295,6 +305,82 @@ void run_small_graph_test(){
   adj_lst_free(&a);
 }
 
+/**
+   Runs a test of adj_csr_{base_init, dir_build, undir_build, free} on 
+   small graphs by comparing the lists to the lists built with adj_lst_
+   functions.
+*/
+void run_small_csr_test(){
+  int res = 1;
+  size_t i;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  void (*graph_init[6])(graph_t *) = {uchar_uchar_graph_init,
+				      uchar_ulong_graph_init,
+				      uchar_double_graph_init,
+				      ulong_uchar_graph_init,
+				      ulong_ulong_graph_init,
+				      ulong_double_graph_init};
+  printf("Test adj_csr_{dir_build, undir_build} on small graphs --> ");
+  for (i = 0; i < 6; i++){
+    graph_init[i](&g);
+    adj_lst_base_init(&a, &g);
+    adj_csr_base_init(&c, &g);
+    adj_lst_dir_build(&a, &g);
+    adj_csr_dir_build(&c, &g);
+    res *= same_lsts(&a, &c);
+    adj_lst_free(&a);
+    adj_csr_free(&c);
+    adj_lst_base_init(&a, &g);
+    adj_csr_base_init(&c, &g);
+    adj_lst_undir_build(&a, &g);
+    adj_csr_undir_build(&c, &g);
+    res *= same_lsts(&a, &c);
+    adj_lst_free(&a);
+    adj_csr_free(&c);
+  }
+  print_test_result(res);
+}
+
+/**
+   Runs a test of adj_cmpr_{base_init, dir_build, undir_build, free} on
+   small graphs by comparing the decoded lists to the sorted lists built
+   with adj_lst_ functions.
+*/
+void run_small_cmpr_test(){
+  int res = 1;
+  size_t i;
+  graph_t g;
+  adj_lst_t a;
+  adj_cmpr_t c;
+  void (*graph_init[6])(graph_t *) = {uchar_uchar_graph_init,
+				      uchar_ulong_graph_init,
+				      uchar_double_graph_init,
+				      ulong_uchar_graph_init,
+				      ulong_ulong_graph_init,
+				      ulong_double_graph_init};
+  printf("Test adj_cmpr_{dir_build, undir_build} on small graphs --> ");
+  for (i = 0; i < 6; i++){
+    graph_init[i](&g);
+    adj_lst_base_init(&a, &g);
+    adj_cmpr_base_init(&c, &g);
+    adj_lst_dir_build(&a, &g);
+    adj_cmpr_dir_build(&c, &g);
+    res *= same_cmpr_lsts(&a, &c);
+    adj_lst_free(&a);
+    adj_cmpr_free(&c);
+    adj_lst_base_init(&a, &g);
+    adj_cmpr_base_init(&c, &g);
+    adj_lst_undir_build(&a, &g);
+    adj_cmpr_undir_build(&c, &g);
+    res *= same_cmpr_lsts(&a, &c);
+    adj_lst_free(&a);
+    adj_cmpr_free(&c);
+  }
+  print_test_result(res);
+}
+
 /**
    Test on non-random graphs.
 */
@@ -434,6 +520,45 @@ void run_adj_lst_undir_build_test(size_t log_start, size_t log_end){
   }
 }
 
+/**
+   Runs a adj_csr_undir_build test on complete unweighted graphs across
+   integer types for vertices.
+*/
+void run_adj_csr_undir_build_test(size_t log_start, size_t log_end){
+  int res = 1;
+  size_t i, j;
+  size_t num_vts;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  clock_t t;
+  printf("Test adj_csr_undir_build on complete unweighted graphs across"
+	 " vertex types\n");
+  printf("\tn vertices, n(n - 1)/2 edges represented by n(n - 1) "
+	 "directed edges\n");
+  for (i = log_start; i <= log_end; i++){
+    num_vts = pow_two_perror(i);
+    printf("\t\tvertices: %lu\n", TOLU(num_vts));
+    for (j = 0; j < C_FN_COUNT; j++){
+      C_CMPL_GRAPH_INIT[j](&g, pow_two_perror(i));
+      adj_csr_base_init(&c, &g);
+      t = clock();
+      adj_csr_undir_build(&c, &g);
+      t = clock() - t;
+      adj_lst_base_init(&a, &g);
+      adj_lst_undir_build(&a, &g);
+      res *= same_lsts(&a, &c);
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+      graph_free(&g);
+      printf("\t\t\t%s build time:      %.6f seconds\n",
+	     C_VT_TYPES[j], (float)t / CLOCKS_PER_SEC);
+    }
+  }
+  printf("\t\tcorrectness across all builds --> ");
+  print_test_result(res);
+}
+
 /**
    Test on random graphs.
 */
@@ -605,6 +730,234 @@ void rand_build_helper(size_t log_start,
   }
 }
 
+/**
+   Test adj_cmpr_dir_build and adj_cmpr_undir_build.
+*/
+
+/**
+   Initializes an unweighted graph with num_vts * C_CMPR_DEG edges with
+   random endpoints, including loops and repeated edges, so that the
+   lists of an adjacency list are not sorted.
+*/
+void rand_ends_graph_init(graph_t *g, size_t num_vts, size_t fn_ix){
+  size_t i;
+  char *up = NULL, *vp = NULL;
+  graph_base_init(g, num_vts, C_VT_SIZES[fn_ix], 0,
+		  C_READ[fn_ix], C_WRITE[fn_ix]);
+  g->num_es = mul_sz_perror(num_vts, C_CMPR_DEG);
+  up = g->u = malloc_perror(g->num_es, g->vt_size);
+  vp = g->v = malloc_perror(g->num_es, g->vt_size);
+  for (i = 0; i < g->num_es; i++){
+    g->write_vt(up, RANDOM() % num_vts);
+    g->write_vt(vp, RANDOM() % num_vts);
+    up += g->vt_size;
+    vp += g->vt_size;
+  }
+}
+
+/**
+   Runs a test of adj_cmpr_dir_build and adj_cmpr_undir_build on graphs
+   with random endpoints across integer types for vertices, and compares
+   the size of the encoded lists to the size of the vertices in a CSR
+   adjacency list.
+*/
+void run_adj_cmpr_build_test(size_t log_start, size_t log_end){
+  int res = 1;
+  size_t i, j;
+  size_t num_vts;
+  graph_t g;
+  adj_lst_t a;
+  adj_cmpr_t c;
+  clock_t t_dir, t_undir;
+  printf("Test adj_cmpr_{dir_build, undir_build} on graphs with random "
+	 "endpoints across vertex types\n");
+  printf("\tn vertices, %lu * n directed edges\n", TOLU(C_CMPR_DEG));
+  for (i = log_start; i <= log_end; i++){
+    num_vts = pow_two_perror(i);
+    printf("\t\tvertices: %lu\n", TOLU(num_vts));
+    for (j = 0; j < C_FN_COUNT; j++){
+      rand_ends_graph_init(&g, num_vts, j);
+      adj_lst_base_init(&a, &g);
+      adj_lst_dir_build(&a, &g);
+      adj_cmpr_base_init(&c, &g);
+      t_dir = clock();
+      adj_cmpr_dir_build(&c, &g);
+      t_dir = clock() - t_dir;
+      res *= same_cmpr_lsts(&a, &c);
+      printf("\t\t\t%s bytes per vertex in lists: %.2f (csr %lu)\n",
+	     C_VT_TYPES[j],
+	     (double)c.offsets[num_vts] / c.num_es,
+	     TOLU(C_VT_SIZES[j]));
+      adj_lst_free(&a);
+      adj_cmpr_free(&c);
+      adj_lst_base_init(&a, &g);
+      adj_lst_undir_build(&a, &g);
+      adj_cmpr_base_init(&c, &g);
+      t_undir = clock();
+      adj_cmpr_undir_build(&c, &g);
+      t_undir = clock() - t_undir;
+      res *= same_cmpr_lsts(&a, &c);
+      adj_lst_free(&a);
+      adj_cmpr_free(&c);
+      graph_free(&g);
+      printf("\t\t\t%s dir, undir build time: %.6f, %.6f seconds\n",
+	     C_VT_TYPES[j],
+	     (float)t_dir / CLOCKS_PER_SEC,
+	     (float)t_undir / CLOCKS_PER_SEC);
+    }
+  }
+  printf("\t\tcorrectness across all builds --> ");
+  print_test_result(res);
+}
+
+/**
+   Test adj_lst_order_{deg, bfs, rcm}, graph_relabel, adj_lst_relabel, and
+   graph_label_inv.
+*/
+
+/**
+   Initializes an unweighted undirected grid graph with num_vts vertices in
+   rows of width vertices, where num_vts is a multiple of width, and labels
+   the vertices with a random permutation, so that the adjacent vertices
+   of a grid are not at nearby labels.
+*/
+void shuffled_grid_graph_init(graph_t *g,
+			      size_t num_vts,
+			      size_t width,
+			      size_t fn_ix){
+  size_t i, j, t;
+  size_t *label = NULL;
+  char *up = NULL, *vp = NULL;
+  graph_base_init(g, num_vts, C_VT_SIZES[fn_ix], 0,
+		  C_READ[fn_ix], C_WRITE[fn_ix]);
+  g->num_es = (num_vts - num_vts / width) + (num_vts - width);
+  if (g->num_es == 0) return;
+  up = g->u = malloc_perror(g->num_es, g->vt_size);
+  vp = g->v = malloc_perror(g->num_es, g->vt_size);
+  for (i = 0; i < num_vts; i++){
+    if ((i + 1) % width != 0){
+      g->write_vt(up, i);
+      g->write_vt(vp, i + 1);
+      up += g->vt_size;
+      vp += g->vt_size;
+    }
+    if (i + width < num_vts){
+      g->write_vt(up, i);
+      g->write_vt(vp, i + width);
+      up += g->vt_size;
+      vp += g->vt_size;
+    }
+  }
+  label = malloc_perror(num_vts, sizeof(size_t));
+  for (i = 0; i < num_vts; i++){
+    label[i] = i;
+  }
+  for (i = num_vts - 1; i > 0; i--){
+    j = RANDOM() % (i + 1);
+    t = label[i];
+    label[i] = label[j];
+    label[j] = t;
+  }
+  graph_relabel(g, label);
+  free(label);
+  label = NULL;
+}
+
+/**
+   Returns the bandwidth max|u - v| over the edges of a graph.
+*/
+size_t bandwidth(const graph_t *g){
+  size_t i, u, v;
+  size_t ret = 0;
+  const char *up = g->u;
+  const char *vp = g->v;
+  for (i = 0; i < g->num_es; i++){
+    u = g->read_vt(up);
+    v = g->read_vt(vp);
+    if (u > v && u - v > ret) ret = u - v;
+    if (v > u && v - u > ret) ret = v - u;
+    up += g->vt_size;
+    vp += g->vt_size;
+  }
+  return ret;
+}
+
+/**
+   Returns 1 if label is a permutation of [0, num_vts) and inv is its
+   inverse, otherwise returns 0.
+*/
+int is_perm_inv(const size_t *label, const size_t *inv, size_t num_vts){
+  int res = 1;
+  size_t i;
+  for (i = 0; i < num_vts; i++){
+    res *= (label[i] < num_vts && inv[label[i]] == i);
+  }
+  return res;
+}
+
+/**
+   Runs a test of the relabeling of shuffled grid graphs across integer
+   types for vertices. A relabeled adjacency list is compared to a CSR
+   adjacency list built from the relabeled graph.
+*/
+void run_relabel_test(size_t log_start, size_t log_end){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_vts, width;
+  size_t *label = NULL, *inv = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  clock_t t;
+  void (*order[3])(const adj_lst_t *, size_t *) = {adj_lst_order_deg,
+						   adj_lst_order_bfs,
+						   adj_lst_order_rcm};
+  const char *order_names[3] = {"deg", "bfs", "rcm"};
+  printf("Test adj_lst_order_{deg, bfs, rcm} and relabeling on shuffled "
+	 "grid graphs across vertex types\n");
+  for (i = log_start; i <= log_end; i++){
+    num_vts = pow_two_perror(i);
+    width = pow_two_perror(i / 2);
+    label = malloc_perror(num_vts, sizeof(size_t));
+    inv = malloc_perror(num_vts, sizeof(size_t));
+    printf("\t\tvertices: %lu, grid width: %lu\n",
+	   TOLU(num_vts), TOLU(width));
+    for (j = 0; j < C_FN_COUNT; j++){
+      for (k = 0; k < 3; k++){
+	shuffled_grid_graph_init(&g, num_vts, width, j);
+	if (k == 0){
+	  printf("\t\t\t%s shuffled bandwidth: %lu\n",
+		 C_VT_TYPES[j], TOLU(bandwidth(&g)));
+	}
+	adj_lst_base_init(&a, &g);
+	adj_lst_undir_build(&a, &g);
+	t = clock();
+	order[k](&a, label);
+	t = clock() - t;
+	graph_label_inv(label, inv, num_vts);
+	res *= is_perm_inv(label, inv, num_vts);
+	graph_relabel(&g, label);
+	adj_lst_relabel(&a, label);
+	adj_csr_base_init(&c, &g);
+	adj_csr_undir_build(&c, &g);
+	res *= same_lsts(&a, &c);
+	printf("\t\t\t%s %s bandwidth:      %lu, order time: %.6f seconds\n",
+	       C_VT_TYPES[j], order_names[k], TOLU(bandwidth(&g)),
+	       (float)t / CLOCKS_PER_SEC);
+	adj_lst_free(&a);
+	adj_csr_free(&c);
+	graph_free(&g);
+      }
+    }
+    free(label);
+    free(inv);
+    label = NULL;
+    inv = NULL;
+  }
+  printf("\t\tcorrectness across all relabelings --> ");
+  print_test_result(res);
+}
+
 /**
    Auxiliary functions.
 */
@@ -624,6 +977,72 @@ size_t sum_vts(const adj_lst_t *a, size_t i){
   return ret;
 }
 
+/**
+   Tests if the lists of an adjacency list and a CSR adjacency list are
+   the same. Returns 1 if the lists are the same, otherwise returns 0.
+*/
+int same_lsts(const adj_lst_t *a, const adj_csr_t *c){
+  int res = 1;
+  size_t i;
+  size_t num_a, num_c;
+  const void *pa = NULL, *pc = NULL;
+  res *= (a->num_vts == c->num_vts);
+  res *= (a->num_es == c->num_es);
+  res *= (a->pair_size == c->pair_size);
+  res *= (a->wt_offset == c->wt_offset);
+  for (i = 0; res && i < a->num_vts; i++){
+    pa = adj_lst_vt_wts(a, i, &num_a);
+    pc = adj_csr_vt_wts(c, i, &num_c);
+    res *= (num_a == num_c);
+    if (res && num_a > 0){
+      res *= (memcmp(pa, pc, num_a * a->pair_size) == 0);
+    }
+  }
+  return res;
+}
+
+/**
+   Tests if the decoded lists of a compressed adjacency list are the sorted
+   lists of an adjacency list. Returns 1 if the lists are the same,
+   otherwise returns 0.
+*/
+int same_cmpr_lsts(const adj_lst_t *a, const adj_cmpr_t *c){
+  int res = 1;
+  size_t i, j;
+  size_t num_a, v;
+  size_t *vts = NULL;
+  const char *pa = NULL;
+  adj_cmpr_iter_t it;
+  res *= (a->num_vts == c->num_vts);
+  res *= (a->num_es == c->num_es);
+  for (i = 0; res && i < a->num_vts; i++){
+    pa = adj_lst_vt_wts(a, i, &num_a);
+    vts = realloc_perror(vts, num_a + 1, sizeof(size_t));
+    for (j = 0; j < num_a; j++){
+      vts[j] = a->read_vt(pa + j * a->pair_size);
+    }
+    qsort(vts, num_a, sizeof(size_t), cmp_sz);
+    adj_cmpr_iter_init(&it, c, i);
+    for (j = 0; res && adj_cmpr_iter_next(&it, &v); j++){
+      res *= (j < num_a && vts[j] == v);
+    }
+    res *= (j == num_a);
+  }
+  free(vts);
+  vts = NULL;
+  return res;
+}
+
+int cmp_sz(const void *a, const void *b){
+  if (*(const size_t *)a > *(const size_t *)b){
+    return 1;
+  }else if (*(const size_t *)a < *(const size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
 /**
    Printing functions.
 */
@@ -695,18 +1114,31 @@ int main(int argc, char *argv[]){
       args[1] < args[0] ||
       args[2] > 1 ||
       args[3] > 1 ||
-      args[4] > 1){
+      args[4] > 1 ||
+      args[5] > 1 ||
+      args[6] > 1){
     printf("USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
-  if (args[2]) run_small_graph_test();
-  if (args[3]) run_adj_lst_undir_build_test(args[0], args[1]);
+  if (args[2]){
+    run_small_graph_test();
+    run_small_csr_test();
+  }
+  if (args[3]){
+    run_adj_lst_undir_build_test(args[0], args[1]);
+    run_adj_csr_undir_build_test(args[0], args[1]);
+  }
   if (args[4]){
     run_adj_lst_add_dir_edge_test(args[0], args[1]);
     run_adj_lst_add_undir_edge_test(args[0], args[1]);
     run_adj_lst_rand_dir_test(args[0], args[1]);
     run_adj_lst_rand_undir_test(args[0], args[1]);
   }
+  if (args[5]){
+    run_small_cmpr_test();
+    run_adj_cmpr_build_test(args[0], args[1]);
+  }
+  if (args[6]) run_relabel_test(args[0], args[1]);
   free(args);
   args = NULL;
   return 0;
@@ -5,10 +5,16 @@
    generic weights. 
 
    Each list in an adjacency list is represented by a dynamically growing 
-   stack. A vertex is of any integer type with values starting from 0. If
-   a graph is weighted, an edge weight is an object within a contiguous 
-   memory block, such as an object of basic type (e.g. char, int, double)
-   or a struct (e.g. two unsigned integers).
+   stack. Alternatively, the lists of a graph are represented in the
+   compressed sparse row (CSR) form by an array of offsets and a single
+   block of vertex weight pairs that are built from a graph_t struct
+   without per-vertex allocations. For traversals of large unweighted
+   graphs, the lists can also be stored in a read-only compressed form of
+   sorted, delta-encoded and variable-length encoded vertices that are
+   decoded on the fly. A vertex is of any integer type with
+   values starting from 0. If a graph is weighted, an edge weight is an
+   object within a contiguous memory block, such as an object of basic type
+   (e.g. char, int, double) or a struct (e.g. two unsigned integers).
   
    A single stack of adjacent vertex weight pairs with adjustable alignment
    in memory is used to achieve cache efficiency in graph algorithms.
@@ -16,6 +22,12 @@
    type with a smaller size for vertices  may provide additional
    cache efficiency in addition to reducing space requirements.
 
+   If the vertices of an input graph are poorly ordered, a relabeling in
+   a degree, BFS, or reverse Cuthill-McKee (RCM) order places vertices
+   that are accessed together at nearby labels, so that the entries of
+   arrays indexed by vertices, such as dist and prev in graph algorithms,
+   are accessed with higher locality.
+
    The implementation only uses integer and pointer operations (any non-
    integer operations on weights are defined by the user). Given
    parameter values within the specified ranges, the implementation provides
@@ -47,6 +59,34 @@
 
 const size_t STACK_INIT_COUNT = 1;
 
+/* variable-length encoding of gaps in compressed lists */
+static const int C_VARINT_BITS = 7;
+static const unsigned char C_VARINT_MASK = 0x7f;
+static const unsigned char C_VARINT_CONT = 0x80;
+
+typedef struct{
+  size_t deg;
+  size_t vt;
+} deg_vt_t;
+
+static void align_pair(size_t vt_size,
+		       size_t wt_size,
+		       size_t vt_alignment,
+		       size_t wt_alignment,
+		       size_t *wt_offset,
+		       size_t *pair_size);
+static void build_offsets(adj_csr_t *c, size_t num_es);
+static void shift_offsets(adj_csr_t *c);
+static void reserve_degs(adj_lst_t *a, const graph_t *g, int is_undir);
+static size_t sort_degs(const adj_lst_t *a, size_t *vts);
+static void order_bfs(const adj_lst_t *a, size_t *label, int is_rcm);
+static int cmp_deg_vt(const void *a, const void *b);
+static void cmpr_build(adj_cmpr_t *c, const graph_t *g, int is_undir);
+static size_t varint_len(size_t val);
+static unsigned char *varint_write(unsigned char *p, size_t val);
+static int cmp_sz(const void *a, const void *b);
+static void *ptr(const void *block, size_t i, size_t size);
+
 /**
    Read and write vertices of different integer types.
 */
@@ -143,24 +183,17 @@ void graph_free(graph_t *g){
 */
 void adj_lst_base_init(adj_lst_t *a, const graph_t *g){
   size_t i;
-  size_t wt_rem, vt_rem;
   a->num_vts = g->num_vts;
   a->num_es = 0;
   a->vt_size = g->vt_size;
   a->wt_size = g->wt_size;
   /* align weight relative to a malloc's pointer and compute pair_size */
-  if (a->wt_size == 0){
-    a->wt_offset = a->vt_size;
-  }else if (a->vt_size <= a->wt_size){
-    a->wt_offset = a->wt_size;
-  }else{
-    wt_rem = a->vt_size % a->wt_size;
-    a->wt_offset = add_sz_perror(a->vt_size,
-				 (wt_rem > 0) * (a->wt_size - wt_rem)); 
-  }
-  vt_rem = add_sz_perror(a->wt_offset, a->wt_size) % a->vt_size;
-  a->pair_size = add_sz_perror(a->wt_offset + a->wt_size,
-			       (vt_rem > 0) * (a->vt_size - vt_rem));
+  align_pair(a->vt_size,
+	     a->wt_size,
+	     a->vt_size,
+	     a->wt_size,
+	     &a->wt_offset,
+	     &a->pair_size);
   a->buf = calloc_perror(1, a->pair_size);
   a->vt_wts = NULL;
   if (a->num_vts > 0){
@@ -195,22 +228,14 @@ void adj_lst_align(adj_lst_t *a,
 		   size_t vt_alignment,
 		   size_t wt_alignment){
   size_t i;
-  size_t wt_rem, vt_rem;
-  if (a->wt_size == 0){
-    a->wt_offset = a->vt_size;
-  }else if (a->vt_size <= wt_alignment){
-    a->wt_offset = wt_alignment;
-  }else{
-    wt_rem = a->vt_size % wt_alignment;
-    a->wt_offset = add_sz_perror(a->vt_size,
-				 (wt_rem > 0) * (wt_alignment - wt_rem));
-  }
-  vt_rem = add_sz_perror(a->wt_offset, a->wt_size) % vt_alignment;
-  a->pair_size = add_sz_perror(a->wt_offset + a->wt_size,
-			       (vt_rem > 0) * (vt_alignment - vt_rem));
+  align_pair(a->vt_size,
+	     a->wt_size,
+	     vt_alignment,
+	     wt_alignment,
+	     &a->wt_offset,
+	     &a->pair_size);
   a->buf = realloc_perror(a->buf, 1, a->pair_size);
   memset(a->buf, 0, a->pair_size);
-  a->vt_wts = NULL;
   /* initialize stacks */
   for (i = 0; i < a->num_vts; i++){
     stack_free(a->vt_wts[i]);
@@ -227,6 +252,7 @@ void adj_lst_dir_build(adj_lst_t *a, const graph_t *g){
   const char *v = g->v;
   const char *wt = g->wts;
   char *buf_wt = (char *)a->buf + a->wt_offset;
+  reserve_degs(a, g, 0);
   for (i = 0; i < g->num_es; i++){
     memcpy(a->buf, v, a->vt_size);
     if (a->wt_size > 0 && wt != NULL){
@@ -249,6 +275,7 @@ void adj_lst_undir_build(adj_lst_t *a, const graph_t *g){
   const char *v = g->v;
   const char *wt = g->wts;
   char *buf_wt = (char *)a->buf + a->wt_offset;
+  reserve_degs(a, g, 1);
   for (i = 0; i < g->num_es; i++){
     memcpy(a->buf, v, a->vt_size);
     if (a->wt_size > 0 && wt != NULL){
@@ -338,6 +365,9 @@ void adj_lst_rand_dir(adj_lst_t *a,
       }
     }
   }
+  for (i = 0; i < num_vts; i++){
+    stack_shrink(a->vt_wts[i]);
+  }
 }
 
 /**
@@ -367,6 +397,9 @@ void adj_lst_rand_undir(adj_lst_t *a,
       }
     }
   }
+  for (i = 0; i < num_vts; i++){
+    stack_shrink(a->vt_wts[i]);
+  }
 }
 
 /**
@@ -385,3 +418,662 @@ void adj_lst_free(adj_lst_t *a){
   a->buf = NULL;
   a->vt_wts = NULL;
 }
+
+/**
+   Compute a relabeling of the vertices of an adjacency list for cache
+   locality in graph algorithms, and set label[u] to the new label of the
+   vertex u in [0, num_vts). A relabeling is applied with graph_relabel
+   and adj_lst_relabel, and the outputs of an algorithm on a relabeled
+   graph are mapped back with graph_label_inv, e.g. dist_old[u] is
+   dist_new[label[u]] and prev_old[u] is inv[prev_new[label[u]]].
+   - adj_lst_order_deg : vertices in descending order of their degrees, so
+     that the lists of high-degree vertices are next to each other
+   - adj_lst_order_bfs : vertices in the order of a BFS of each component,
+     starting from the lowest unreached vertex, so that vertices reached at
+     the same time by a traversal are next to each other
+   - adj_lst_order_rcm : reverse Cuthill-McKee order, i.e. a BFS of each
+     component starting from an unreached vertex of minimum degree and
+     reaching the unreached neighbors of a vertex in ascending order of
+     their degrees, reversed, which reduces the bandwidth max|label[u] -
+     label[v]| of the graph
+   a           : pointer to an adjacency list; the degree of a vertex is
+                 the number of pairs in its list and a BFS follows the
+                 lists, so that in a directed graph a vertex not reached
+                 from previous start vertices starts a new BFS
+   label       : pointer to a preallocated array of num_vts elements
+*/
+void adj_lst_order_deg(const adj_lst_t *a, size_t *label){
+  size_t i;
+  size_t *vts = NULL;
+  if (a->num_vts == 0) return;
+  vts = malloc_perror(a->num_vts, sizeof(size_t));
+  sort_degs(a, vts);
+  for (i = 0; i < a->num_vts; i++){
+    label[vts[a->num_vts - 1 - i]] = i;
+  }
+  free(vts);
+  vts = NULL;
+}
+
+void adj_lst_order_bfs(const adj_lst_t *a, size_t *label){
+  order_bfs(a, label, 0);
+}
+
+void adj_lst_order_rcm(const adj_lst_t *a, size_t *label){
+  order_bfs(a, label, 1);
+}
+
+/**
+   Relabels the vertices of a graph or an adjacency list in place, with
+   label[u] as the new label of the vertex u. In an adjacency list, the
+   list of u becomes the list of label[u], and the vertices in the lists
+   are relabeled without changing the order of the lists and the weights.
+*/
+void graph_relabel(graph_t *g, const size_t *label){
+  size_t i;
+  char *up = g->u;
+  char *vp = g->v;
+  for (i = 0; i < g->num_es; i++){
+    g->write_vt(up, label[g->read_vt(up)]);
+    g->write_vt(vp, label[g->read_vt(vp)]);
+    up += g->vt_size;
+    vp += g->vt_size;
+  }
+}
+
+void adj_lst_relabel(adj_lst_t *a, const size_t *label){
+  size_t i;
+  char *p = NULL, *p_end = NULL;
+  stack_t **vt_wts = NULL;
+  if (a->num_vts == 0) return;
+  vt_wts = malloc_perror(a->num_vts, sizeof(stack_t *));
+  for (i = 0; i < a->num_vts; i++){
+    vt_wts[label[i]] = a->vt_wts[i];
+    p = a->vt_wts[i]->elts;
+    p_end = p + a->vt_wts[i]->num_elts * a->pair_size;
+    for (; p != p_end; p += a->pair_size){
+      a->write_vt(p, label[a->read_vt(p)]);
+    }
+  }
+  free(a->vt_wts);
+  a->vt_wts = vt_wts;
+}
+
+/**
+   Sets inv[label[u]] to u for each of num_vts vertices, so that inv maps
+   the new labels of a relabeling back to the original vertices.
+*/
+void graph_label_inv(const size_t *label, size_t *inv, size_t num_vts){
+  size_t i;
+  for (i = 0; i < num_vts; i++){
+    inv[label[i]] = i;
+  }
+}
+
+/**
+   Initializes an empty compressed sparse row (CSR) adjacency list according
+   to a graph. Aligns vertices and weights according to their sizes, which
+   may result in overalignment.
+   c           : pointer to a preallocated block of size sizeof(adj_csr_t)
+   g           : pointer to a graph previously constructed with at least
+                 graph_base_init
+*/
+void adj_csr_base_init(adj_csr_t *c, const graph_t *g){
+  c->num_vts = g->num_vts;
+  c->num_es = 0;
+  c->vt_size = g->vt_size;
+  c->wt_size = g->wt_size;
+  align_pair(c->vt_size,
+	     c->wt_size,
+	     c->vt_size,
+	     c->wt_size,
+	     &c->wt_offset,
+	     &c->pair_size);
+  c->offsets = calloc_large_perror(add_sz_perror(c->num_vts, 1),
+				    sizeof(size_t));
+  c->vt_wts = NULL;
+  c->read_vt = g->read_vt;
+  c->write_vt = g->write_vt;
+}
+
+/**
+   Aligns the vertices and weights of a CSR adjacency list according to the
+   values of the alignment parameters. Please see the specification of
+   adj_lst_align. The operation is optionally called after
+   adj_csr_base_init is completed and before any other adj_csr_ operation
+   is called.
+*/
+void adj_csr_align(adj_csr_t *c,
+		   size_t vt_alignment,
+		   size_t wt_alignment){
+  align_pair(c->vt_size,
+	     c->wt_size,
+	     vt_alignment,
+	     wt_alignment,
+	     &c->wt_offset,
+	     &c->pair_size);
+}
+
+/**
+   Builds the CSR adjacency list of a directed graph. The lists are built
+   with a counting pass over the edges of the graph, followed by a prefix
+   sum and a single pass placing each pair, requiring two allocations in
+   total. The order of pairs in each list is the same as in an adjacency
+   list built with adj_lst_dir_build.
+*/
+void adj_csr_dir_build(adj_csr_t *c, const graph_t *g){
+  size_t i;
+  const char *u = g->u;
+  const char *v = g->v;
+  const char *wt = g->wts;
+  char *p = NULL;
+  for (i = 0; i < g->num_es; i++){
+    c->offsets[c->read_vt(u) + 1]++;
+    u += c->vt_size;
+  }
+  build_offsets(c, g->num_es);
+  u = g->u;
+  for (i = 0; i < g->num_es; i++){
+    p = ptr(c->vt_wts, c->offsets[c->read_vt(u)]++, c->pair_size);
+    memcpy(p, v, c->vt_size);
+    if (c->wt_size > 0 && wt != NULL){
+      memcpy(p + c->wt_offset, wt, c->wt_size);
+      wt += c->wt_size;
+    }
+    u += c->vt_size;
+    v += c->vt_size;
+  }
+  shift_offsets(c);
+}
+
+/**
+   Builds the CSR adjacency list of an undirected graph. The order of pairs
+   in each list is the same as in an adjacency list built with
+   adj_lst_undir_build.
+*/
+void adj_csr_undir_build(adj_csr_t *c, const graph_t *g){
+  size_t i;
+  const char *u = g->u;
+  const char *v = g->v;
+  const char *wt = g->wts;
+  char *p = NULL;
+  for (i = 0; i < g->num_es; i++){
+    c->offsets[c->read_vt(u) + 1]++;
+    c->offsets[c->read_vt(v) + 1]++;
+    u += c->vt_size;
+    v += c->vt_size;
+  }
+  build_offsets(c, mul_sz_perror(2, g->num_es));
+  u = g->u;
+  v = g->v;
+  for (i = 0; i < g->num_es; i++){
+    p = ptr(c->vt_wts, c->offsets[c->read_vt(u)]++, c->pair_size);
+    memcpy(p, v, c->vt_size);
+    if (c->wt_size > 0 && wt != NULL){
+      memcpy(p + c->wt_offset, wt, c->wt_size);
+    }
+    p = ptr(c->vt_wts, c->offsets[c->read_vt(v)]++, c->pair_size);
+    memcpy(p, u, c->vt_size);
+    if (c->wt_size > 0 && wt != NULL){
+      memcpy(p + c->wt_offset, wt, c->wt_size);
+      wt += c->wt_size;
+    }
+    u += c->vt_size;
+    v += c->vt_size;
+  }
+  shift_offsets(c);
+}
+
+/**
+   Frees a CSR adjacency list and leaves a block of size sizeof(adj_csr_t)
+   pointed to by the c parameter.
+*/
+void adj_csr_free(adj_csr_t *c){
+  free_large(c->offsets);
+  free_large(c->vt_wts); /* free_large(NULL) performs no operation */
+  c->offsets = NULL;
+  c->vt_wts = NULL;
+}
+
+/**
+   Return a pointer to the first vertex weight pair in the list of the
+   vertex u, and set the value pointed to by num to the number of pairs in
+   the list. The a and c parameters point to adj_lst_t and adj_csr_t
+   structs respectively. The pointer returned for a vertex with no adjacent
+   vertices may be NULL and is not dereferenced.
+*/
+
+const void *adj_lst_vt_wts(const void *a, size_t u, size_t *num){
+  const stack_t *s = ((const adj_lst_t *)a)->vt_wts[u];
+  *num = s->num_elts;
+  return s->elts;
+}
+
+const void *adj_csr_vt_wts(const void *c, size_t u, size_t *num){
+  const adj_csr_t *cp = c;
+  *num = cp->offsets[u + 1] - cp->offsets[u];
+  return ptr(cp->vt_wts, cp->offsets[u], cp->pair_size);
+}
+
+/**
+   Initializes a view of an adjacency list, providing a single interface
+   to the lists of an adj_lst_t or an adj_csr_t struct in graph algorithms.
+   The view is valid as long as the viewed adjacency list is not modified
+   or freed.
+   w           : pointer to a preallocated block of size sizeof(adj_view_t)
+   a, c        : pointer to an adjacency list built with adj_lst_ or adj_csr_
+                 functions respectively
+*/
+
+void adj_lst_view(adj_view_t *w, const adj_lst_t *a){
+  w->num_vts = a->num_vts;
+  w->num_es = a->num_es;
+  w->vt_size = a->vt_size;
+  w->wt_size = a->wt_size;
+  w->pair_size = a->pair_size;
+  w->wt_offset = a->wt_offset;
+  w->adj = a;
+  w->vt_wts = adj_lst_vt_wts;
+  w->read_vt = a->read_vt;
+  w->write_vt = a->write_vt;
+}
+
+void adj_csr_view(adj_view_t *w, const adj_csr_t *c){
+  w->num_vts = c->num_vts;
+  w->num_es = c->num_es;
+  w->vt_size = c->vt_size;
+  w->wt_size = c->wt_size;
+  w->pair_size = c->pair_size;
+  w->wt_offset = c->wt_offset;
+  w->adj = c;
+  w->vt_wts = adj_csr_vt_wts;
+  w->read_vt = c->read_vt;
+  w->write_vt = c->write_vt;
+}
+
+/**
+   Initializes an empty compressed adjacency list according to a graph. A
+   compressed adjacency list is read-only after it is built and does not
+   store weights. The list of each vertex is sorted in ascending order and
+   stored as a sequence of gaps between consecutive vertices, starting
+   from 0, with each gap encoded as a variable-length integer of 7 bits per
+   byte (LEB128), so that a list of a vertex with nearby neighbors occupies
+   about one byte per vertex regardless of vt_size.
+   c           : pointer to a preallocated block of size sizeof(adj_cmpr_t)
+   g           : pointer to a graph previously constructed with at least
+                 graph_base_init
+*/
+void adj_cmpr_base_init(adj_cmpr_t *c, const graph_t *g){
+  c->num_vts = g->num_vts;
+  c->num_es = 0;
+  c->vt_size = g->vt_size;
+  c->offsets = calloc_large_perror(add_sz_perror(c->num_vts, 1),
+				    sizeof(size_t));
+  c->bytes = NULL;
+  c->read_vt = g->read_vt;
+  c->write_vt = g->write_vt;
+}
+
+/**
+   Builds the compressed adjacency list of a directed or undirected graph.
+   The lists are gathered with a counting pass and a prefix sum into a
+   temporary block of size_t vertices, sorted, measured and encoded into a
+   single block of bytes of the exact size. Each list contains the same
+   vertices, including repeated vertices, as the corresponding list built
+   with adj_lst_dir_build or adj_lst_undir_build respectively.
+*/
+void adj_cmpr_dir_build(adj_cmpr_t *c, const graph_t *g){
+  cmpr_build(c, g, 0);
+}
+
+void adj_cmpr_undir_build(adj_cmpr_t *c, const graph_t *g){
+  cmpr_build(c, g, 1);
+}
+
+/**
+   Frees a compressed adjacency list and leaves a block of size
+   sizeof(adj_cmpr_t) pointed to by the c parameter.
+*/
+void adj_cmpr_free(adj_cmpr_t *c){
+  free_large(c->offsets);
+  free_large(c->bytes); /* free_large(NULL) performs no operation */
+  c->offsets = NULL;
+  c->bytes = NULL;
+}
+
+/**
+   Initializes an iterator over the list of the vertex u in a compressed
+   adjacency list. The iterator is valid as long as the list is not freed,
+   and is a small struct that can be copied to save and restore the
+   position in a list, e.g. in the stack of a depth-first search.
+*/
+void adj_cmpr_iter_init(adj_cmpr_iter_t *it, const adj_cmpr_t *c, size_t u){
+  it->v = 0;
+  if (c->bytes == NULL){
+    it->p = NULL;
+    it->end = NULL;
+    return;
+  }
+  it->p = c->bytes + c->offsets[u];
+  it->end = c->bytes + c->offsets[u + 1];
+}
+
+/**
+   Decodes the next vertex of a list into the value pointed to by v and
+   returns 1, or returns 0 if the end of the list was reached. A gap that
+   fits in a single byte is decoded without entering the loop.
+*/
+int adj_cmpr_iter_next(adj_cmpr_iter_t *it, size_t *v){
+  size_t gap;
+  int shift = C_VARINT_BITS;
+  if (it->p == it->end) return 0;
+  gap = *it->p & C_VARINT_MASK;
+  while (*it->p++ & C_VARINT_CONT){
+    gap |= (size_t)(*it->p & C_VARINT_MASK) << shift;
+    shift += C_VARINT_BITS;
+  }
+  it->v += gap;
+  *v = it->v;
+  return 1;
+}
+
+/** Helper functions */
+
+/**
+   Computes the offset of a weight from the beginning of a vertex weight
+   pair, and the size of the pair, according to the alignment requirements
+   or sizes of the vertex and weight types.
+*/
+static void align_pair(size_t vt_size,
+		       size_t wt_size,
+		       size_t vt_alignment,
+		       size_t wt_alignment,
+		       size_t *wt_offset,
+		       size_t *pair_size){
+  size_t wt_rem, vt_rem;
+  if (wt_size == 0){
+    *wt_offset = vt_size;
+  }else if (vt_size <= wt_alignment){
+    *wt_offset = wt_alignment;
+  }else{
+    wt_rem = vt_size % wt_alignment;
+    *wt_offset = add_sz_perror(vt_size,
+			       (wt_rem > 0) * (wt_alignment - wt_rem));
+  }
+  vt_rem = add_sz_perror(*wt_offset, wt_size) % vt_alignment;
+  *pair_size = add_sz_perror(*wt_offset + wt_size,
+			     (vt_rem > 0) * (vt_alignment - vt_rem));
+}
+
+/**
+   Converts the counts of pairs in c->offsets[1, num_vts] to the offsets of
+   the beginnings of lists in c->offsets[0, num_vts - 1] with a prefix sum,
+   and allocates the block of pairs.
+*/
+static void build_offsets(adj_csr_t *c, size_t num_es){
+  size_t i;
+  for (i = 1; i < c->num_vts; i++){
+    c->offsets[i + 1] += c->offsets[i];
+  }
+  c->num_es = num_es;
+  if (c->num_es > 0){
+    c->vt_wts = calloc_large_perror(c->num_es, c->pair_size);
+  }
+}
+
+/**
+   Restores the offsets of the beginnings of lists after each entry in
+   c->offsets[0, num_vts - 1] was advanced to the end of its list by
+   placing the pairs.
+*/
+static void shift_offsets(adj_csr_t *c){
+  size_t i;
+  for (i = c->num_vts; i > 0; i--){
+    c->offsets[i] = c->offsets[i - 1];
+  }
+  c->offsets[0] = 0;
+}
+
+/**
+   Counts the out-degrees of vertices in the edges of a graph, in both
+   directions if is_undir is nonzero, and reserves the stacks of an
+   adjacency list for exactly the added degrees, so that the stacks do not
+   grow while the edges are added.
+*/
+static void reserve_degs(adj_lst_t *a, const graph_t *g, int is_undir){
+  size_t i;
+  size_t *degs = NULL;
+  const char *u = g->u;
+  const char *v = g->v;
+  if (a->num_vts == 0 || g->num_es == 0) return;
+  degs = calloc_perror(a->num_vts, sizeof(size_t));
+  for (i = 0; i < g->num_es; i++){
+    degs[a->read_vt(u)]++;
+    if (is_undir) degs[a->read_vt(v)]++;
+    u += a->vt_size;
+    v += a->vt_size;
+  }
+  for (i = 0; i < a->num_vts; i++){
+    stack_reserve(a->vt_wts[i], a->vt_wts[i]->num_elts + degs[i]);
+  }
+  free(degs);
+  degs = NULL;
+}
+
+/**
+   Builds a compressed adjacency list from the edges of a graph, in both
+   directions if is_undir is nonzero. The vertices are first placed in a
+   temporary CSR block of size_t values to sort each list with qsort.
+*/
+static void cmpr_build(adj_cmpr_t *c, const graph_t *g, int is_undir){
+  size_t i, j, u, prev;
+  size_t num_es;
+  size_t *offs = NULL, *vts = NULL;
+  unsigned char *p = NULL;
+  const char *up = g->u;
+  const char *vp = g->v;
+  num_es = is_undir ? mul_sz_perror(2, g->num_es) : g->num_es;
+  c->num_es = num_es;
+  if (num_es == 0) return;
+  offs = calloc_perror(add_sz_perror(c->num_vts, 1), sizeof(size_t));
+  for (i = 0; i < g->num_es; i++){
+    offs[c->read_vt(up) + 1]++;
+    if (is_undir) offs[c->read_vt(vp) + 1]++;
+    up += c->vt_size;
+    vp += c->vt_size;
+  }
+  for (i = 1; i < c->num_vts; i++){
+    offs[i + 1] += offs[i];
+  }
+  vts = malloc_perror(num_es, sizeof(size_t));
+  up = g->u;
+  vp = g->v;
+  for (i = 0; i < g->num_es; i++){
+    vts[offs[c->read_vt(up)]++] = c->read_vt(vp);
+    if (is_undir) vts[offs[c->read_vt(vp)]++] = c->read_vt(up);
+    up += c->vt_size;
+    vp += c->vt_size;
+  }
+  for (i = c->num_vts; i > 0; i--){
+    offs[i] = offs[i - 1];
+  }
+  offs[0] = 0;
+  /* sort and measure the encoded lists */
+  for (u = 0; u < c->num_vts; u++){
+    qsort(vts + offs[u], offs[u + 1] - offs[u], sizeof(size_t), cmp_sz);
+    c->offsets[u + 1] = c->offsets[u];
+    prev = 0;
+    for (j = offs[u]; j < offs[u + 1]; j++){
+      c->offsets[u + 1] = add_sz_perror(c->offsets[u + 1],
+					varint_len(vts[j] - prev));
+      prev = vts[j];
+    }
+  }
+  /* encode */
+  c->bytes = malloc_large_perror(c->offsets[c->num_vts], 1);
+  p = c->bytes;
+  for (u = 0; u < c->num_vts; u++){
+    prev = 0;
+    for (j = offs[u]; j < offs[u + 1]; j++){
+      p = varint_write(p, vts[j] - prev);
+      prev = vts[j];
+    }
+  }
+  free(offs);
+  free(vts);
+  offs = NULL;
+  vts = NULL;
+}
+
+/**
+   Sets vts to the vertices of an adjacency list in ascending order of
+   their degrees with a counting sort, and in ascending order of vertices
+   among vertices of the same degree. Returns the maximum degree.
+*/
+static size_t sort_degs(const adj_lst_t *a, size_t *vts){
+  size_t i;
+  size_t max_deg = 0;
+  size_t *cts = NULL;
+  for (i = 0; i < a->num_vts; i++){
+    if (a->vt_wts[i]->num_elts > max_deg){
+      max_deg = a->vt_wts[i]->num_elts;
+    }
+  }
+  cts = calloc_perror(add_sz_perror(max_deg, 2), sizeof(size_t));
+  for (i = 0; i < a->num_vts; i++){
+    cts[a->vt_wts[i]->num_elts + 1]++;
+  }
+  for (i = 1; i <= max_deg; i++){
+    cts[i + 1] += cts[i];
+  }
+  for (i = 0; i < a->num_vts; i++){
+    vts[cts[a->vt_wts[i]->num_elts]++] = i;
+  }
+  free(cts);
+  cts = NULL;
+  return max_deg;
+}
+
+/**
+   Computes a BFS order or, if is_rcm is nonzero, a reverse Cuthill-McKee
+   order of the vertices of an adjacency list. The queue of a BFS holds
+   the reached vertices in the order of reaching, and label[v] is the
+   position of v in the queue, or num_vts if v was not reached.
+*/
+static void order_bfs(const adj_lst_t *a, size_t *label, int is_rcm){
+  size_t i, j, s, v;
+  size_t head = 0, tail = 0, next;
+  size_t max_deg;
+  size_t *q = NULL, *starts = NULL;
+  deg_vt_t *dvs = NULL;
+  const char *p = NULL, *p_end = NULL;
+  if (a->num_vts == 0) return;
+  q = malloc_perror(a->num_vts, sizeof(size_t));
+  if (is_rcm){
+    starts = malloc_perror(a->num_vts, sizeof(size_t));
+    max_deg = sort_degs(a, starts);
+    if (max_deg > 0) dvs = malloc_perror(max_deg, sizeof(deg_vt_t));
+  }
+  for (i = 0; i < a->num_vts; i++){
+    label[i] = a->num_vts;
+  }
+  for (i = 0; i < a->num_vts; i++){
+    s = is_rcm ? starts[i] : i;
+    if (label[s] != a->num_vts) continue;
+    label[s] = tail;
+    q[tail++] = s;
+    while (head < tail){
+      p = a->vt_wts[q[head]]->elts;
+      p_end = p + a->vt_wts[q[head]]->num_elts * a->pair_size;
+      head++;
+      next = tail;
+      for (; p != p_end; p += a->pair_size){
+	v = a->read_vt(p);
+	if (label[v] == a->num_vts){
+	  label[v] = tail;
+	  q[tail++] = v;
+	}
+      }
+      if (is_rcm && tail - next > 1){
+	for (j = next; j < tail; j++){
+	  dvs[j - next].deg = a->vt_wts[q[j]]->num_elts;
+	  dvs[j - next].vt = q[j];
+	}
+	qsort(dvs, tail - next, sizeof(deg_vt_t), cmp_deg_vt);
+	for (j = next; j < tail; j++){
+	  q[j] = dvs[j - next].vt;
+	  label[q[j]] = j;
+	}
+      }
+    }
+  }
+  if (is_rcm){
+    for (i = 0; i < a->num_vts; i++){
+      label[q[i]] = a->num_vts - 1 - i;
+    }
+  }
+  free(q);
+  free(starts); /* free(NULL) performs no operation */
+  free(dvs);
+  q = NULL;
+  starts = NULL;
+  dvs = NULL;
+}
+
+/**
+   Compares two vertices by their degrees, and by vertices if the degrees
+   are equal.
+*/
+static int cmp_deg_vt(const void *a, const void *b){
+  const deg_vt_t *x = a;
+  const deg_vt_t *y = b;
+  if (x->deg != y->deg) return (x->deg > y->deg) ? 1 : -1;
+  if (x->vt != y->vt) return (x->vt > y->vt) ? 1 : -1;
+  return 0;
+}
+
+/**
+   Returns the number of bytes of a variable-length encoding of a value.
+*/
+static size_t varint_len(size_t val){
+  size_t n = 1;
+  while (val >> C_VARINT_BITS){
+    val >>= C_VARINT_BITS;
+    n++;
+  }
+  return n;
+}
+
+/**
+   Writes a variable-length encoding of a value starting at p, with the
+   least significant group of 7 bits first and the high bit of each byte
+   set if another byte follows. Returns a pointer past the last byte.
+*/
+static unsigned char *varint_write(unsigned char *p, size_t val){
+  while (val >> C_VARINT_BITS){
+    *p++ = (unsigned char)((val & C_VARINT_MASK) | C_VARINT_CONT);
+    val >>= C_VARINT_BITS;
+  }
+  *p++ = (unsigned char)val;
+  return p;
+}
+
+/**
+   Compares two size_t values for sorting the lists with qsort.
+*/
+static int cmp_sz(const void *a, const void *b){
+  if (*(const size_t *)a > *(const size_t *)b){
+    return 1;
+  }else if (*(const size_t *)a < *(const size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
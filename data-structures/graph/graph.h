@@ -6,10 +6,16 @@
    weights.
 
    Each list in an adjacency list is represented by a dynamically growing 
-   stack. A vertex is of any inteter type with values starting from 0. If
-   a graph is weighted, an edge weight is an object within a contiguous 
-   memory block, such as an object of basic type (e.g. char, int, double)
-   or a struct (e.g. two unsigned integers).
+   stack. Alternatively, the lists of a graph are represented in the
+   compressed sparse row (CSR) form by an array of offsets and a single
+   block of vertex weight pairs that are built from a graph_t struct
+   without per-vertex allocations. For traversals of large unweighted
+   graphs, the lists can also be stored in a read-only compressed form of
+   sorted, delta-encoded and variable-length encoded vertices that are
+   decoded on the fly. A vertex is of any inteter type with
+   values starting from 0. If a graph is weighted, an edge weight is an
+   object within a contiguous memory block, such as an object of basic type
+   (e.g. char, int, double) or a struct (e.g. two unsigned integers).
   
    A single stack of adjacent vertex weight pairs with adjustable alignment
    in memory is used to achieve cache efficiency in graph algorithms.
@@ -17,6 +23,12 @@
    type with a smaller size for vertices  may provide additional
    cache efficiency in addition to reducing space requirements.
 
+   If the vertices of an input graph are poorly ordered, a relabeling in
+   a degree, BFS, or reverse Cuthill-McKee (RCM) order places vertices
+   that are accessed together at nearby labels, so that the entries of
+   arrays indexed by vertices, such as dist and prev in graph algorithms,
+   are accessed with higher locality.
+
    The implementation only uses integer and pointer operations (any non-
    integer operations on weights are defined by the user). Given
    parameter values within the specified ranges, the implementation provides
@@ -70,6 +82,48 @@ typedef struct{
   void (*write_vt)(void *, size_t);
 } adj_lst_t;
 
+typedef struct{
+  size_t num_vts;
+  size_t num_es;
+  size_t vt_size;
+  size_t wt_size;
+  size_t pair_size; /* size of a vertex weight pair aligned in memory */
+  size_t wt_offset; /* number of bytes from beginning of pair to weight */
+  size_t *offsets;  /* num_vts + 1 offsets of lists in vt_wts, in pairs */
+  void *vt_wts;     /* lists of vertex weight pairs, NULL if no edges */
+  size_t (*read_vt)(const void *);
+  void (*write_vt)(void *, size_t);
+} adj_csr_t;
+
+typedef struct{
+  size_t num_vts;
+  size_t num_es;
+  size_t vt_size;
+  size_t wt_size;
+  size_t pair_size;
+  size_t wt_offset;
+  const void *adj;  /* adj_lst_t or adj_csr_t struct */
+  const void *(*vt_wts)(const void *, size_t, size_t *);
+  size_t (*read_vt)(const void *);
+  void (*write_vt)(void *, size_t);
+} adj_view_t;
+
+typedef struct{
+  size_t num_vts;
+  size_t num_es;
+  size_t vt_size;
+  size_t *offsets;      /* num_vts + 1 offsets of lists in bytes */
+  unsigned char *bytes; /* encoded lists, NULL if no edges */
+  size_t (*read_vt)(const void *);
+  void (*write_vt)(void *, size_t);
+} adj_cmpr_t;
+
+typedef struct{
+  const unsigned char *p;   /* next byte to decode */
+  const unsigned char *end; /* end of the list */
+  size_t v;                 /* last decoded vertex, 0 at the beginning */
+} adj_cmpr_iter_t;
+
 /**
    Read and write vertices of different integer types.
 */
@@ -217,4 +271,156 @@ void adj_lst_rand_undir(adj_lst_t *a,
 */
 void adj_lst_free(adj_lst_t *a);
 
+/**
+   Compute a relabeling of the vertices of an adjacency list for cache
+   locality in graph algorithms, and set label[u] to the new label of the
+   vertex u in [0, num_vts). A relabeling is applied with graph_relabel
+   and adj_lst_relabel, and the outputs of an algorithm on a relabeled
+   graph are mapped back with graph_label_inv, e.g. dist_old[u] is
+   dist_new[label[u]] and prev_old[u] is inv[prev_new[label[u]]].
+   - adj_lst_order_deg : vertices in descending order of their degrees, so
+     that the lists of high-degree vertices are next to each other
+   - adj_lst_order_bfs : vertices in the order of a BFS of each component,
+     starting from the lowest unreached vertex, so that vertices reached at
+     the same time by a traversal are next to each other
+   - adj_lst_order_rcm : reverse Cuthill-McKee order, i.e. a BFS of each
+     component starting from an unreached vertex of minimum degree and
+     reaching the unreached neighbors of a vertex in ascending order of
+     their degrees, reversed, which reduces the bandwidth max|label[u] -
+     label[v]| of the graph
+   a           : pointer to an adjacency list; the degree of a vertex is
+                 the number of pairs in its list and a BFS follows the
+                 lists, so that in a directed graph a vertex not reached
+                 from previous start vertices starts a new BFS
+   label       : pointer to a preallocated array of num_vts elements
+*/
+void adj_lst_order_deg(const adj_lst_t *a, size_t *label);
+void adj_lst_order_bfs(const adj_lst_t *a, size_t *label);
+void adj_lst_order_rcm(const adj_lst_t *a, size_t *label);
+
+/**
+   Relabels the vertices of a graph or an adjacency list in place, with
+   label[u] as the new label of the vertex u. In an adjacency list, the
+   list of u becomes the list of label[u], and the vertices in the lists
+   are relabeled without changing the order of the lists and the weights.
+*/
+void graph_relabel(graph_t *g, const size_t *label);
+void adj_lst_relabel(adj_lst_t *a, const size_t *label);
+
+/**
+   Sets inv[label[u]] to u for each of num_vts vertices, so that inv maps
+   the new labels of a relabeling back to the original vertices.
+*/
+void graph_label_inv(const size_t *label, size_t *inv, size_t num_vts);
+
+/**
+   Initializes an empty compressed sparse row (CSR) adjacency list according
+   to a graph. Aligns vertices and weights according to their sizes, which
+   may result in overalignment.
+   c           : pointer to a preallocated block of size sizeof(adj_csr_t)
+   g           : pointer to a graph previously constructed with at least
+                 graph_base_init
+*/
+void adj_csr_base_init(adj_csr_t *c, const graph_t *g);
+
+/**
+   Aligns the vertices and weights of a CSR adjacency list according to the
+   values of the alignment parameters. Please see the specification of
+   adj_lst_align. The operation is optionally called after
+   adj_csr_base_init is completed and before any other adj_csr_ operation
+   is called.
+*/
+void adj_csr_align(adj_csr_t *c,
+		   size_t vt_alignment,
+		   size_t wt_alignment);
+
+/**
+   Builds the CSR adjacency list of a directed graph. The lists are built
+   with a counting pass over the edges of the graph, followed by a prefix
+   sum and a single pass placing each pair, requiring two allocations in
+   total. The order of pairs in each list is the same as in an adjacency
+   list built with adj_lst_dir_build.
+*/
+void adj_csr_dir_build(adj_csr_t *c, const graph_t *g);
+
+/**
+   Builds the CSR adjacency list of an undirected graph. The order of pairs
+   in each list is the same as in an adjacency list built with
+   adj_lst_undir_build.
+*/
+void adj_csr_undir_build(adj_csr_t *c, const graph_t *g);
+
+/**
+   Frees a CSR adjacency list and leaves a block of size sizeof(adj_csr_t)
+   pointed to by the c parameter.
+*/
+void adj_csr_free(adj_csr_t *c);
+
+/**
+   Return a pointer to the first vertex weight pair in the list of the
+   vertex u, and set the value pointed to by num to the number of pairs in
+   the list. The a and c parameters point to adj_lst_t and adj_csr_t
+   structs respectively. The pointer returned for a vertex with no adjacent
+   vertices may be NULL and is not dereferenced.
+*/
+const void *adj_lst_vt_wts(const void *a, size_t u, size_t *num);
+const void *adj_csr_vt_wts(const void *c, size_t u, size_t *num);
+
+/**
+   Initializes a view of an adjacency list, providing a single interface
+   to the lists of an adj_lst_t or an adj_csr_t struct in graph algorithms.
+   The view is valid as long as the viewed adjacency list is not modified
+   or freed.
+   w           : pointer to a preallocated block of size sizeof(adj_view_t)
+   a, c        : pointer to an adjacency list built with adj_lst_ or adj_csr_
+                 functions respectively
+*/
+void adj_lst_view(adj_view_t *w, const adj_lst_t *a);
+void adj_csr_view(adj_view_t *w, const adj_csr_t *c);
+
+/**
+   Initializes an empty compressed adjacency list according to a graph. A
+   compressed adjacency list is read-only after it is built and does not
+   store weights. The list of each vertex is sorted in ascending order and
+   stored as a sequence of gaps between consecutive vertices, starting
+   from 0, with each gap encoded as a variable-length integer of 7 bits per
+   byte (LEB128), so that a list of a vertex with nearby neighbors occupies
+   about one byte per vertex regardless of vt_size.
+   c           : pointer to a preallocated block of size sizeof(adj_cmpr_t)
+   g           : pointer to a graph previously constructed with at least
+                 graph_base_init
+*/
+void adj_cmpr_base_init(adj_cmpr_t *c, const graph_t *g);
+
+/**
+   Builds the compressed adjacency list of a directed or undirected graph.
+   The lists are gathered with a counting pass and a prefix sum into a
+   temporary block of size_t vertices, sorted, measured and encoded into a
+   single block of bytes of the exact size. Each list contains the same
+   vertices, including repeated vertices, as the corresponding list built
+   with adj_lst_dir_build or adj_lst_undir_build respectively.
+*/
+void adj_cmpr_dir_build(adj_cmpr_t *c, const graph_t *g);
+void adj_cmpr_undir_build(adj_cmpr_t *c, const graph_t *g);
+
+/**
+   Frees a compressed adjacency list and leaves a block of size
+   sizeof(adj_cmpr_t) pointed to by the c parameter.
+*/
+void adj_cmpr_free(adj_cmpr_t *c);
+
+/**
+   Initializes an iterator over the list of the vertex u in a compressed
+   adjacency list. The iterator is valid as long as the list is not freed,
+   and is a small struct that can be copied to save and restore the
+   position in a list, e.g. in the stack of a depth-first search.
+*/
+void adj_cmpr_iter_init(adj_cmpr_iter_t *it, const adj_cmpr_t *c, size_t u);
+
+/**
+   Decodes the next vertex of a list into the value pointed to by v and
+   returns 1, or returns 0 if the end of the list was reached.
+*/
+int adj_cmpr_iter_next(adj_cmpr_iter_t *it, size_t *v);
+
 #endif
@@ -0,0 +1,319 @@
+/**
+   heap-pair-test.c
+
+   Tests of a pairing (min) heap with size_t elements in [0, n), and a
+   comparison with a heap_t with an index array.
+
+   The following command line arguments can be used to customize tests:
+   heap-pair-test
+      [0, # bits in size_t - 1) : i s.t. # elements = 2^i
+      [0, 1] : on/off push pop free test
+      [0, 1] : on/off update search reset test
+      [0, 1] : on/off decrease-heavy comparison test with heap_t
+
+   usage examples:
+   ./heap-pair-test
+   ./heap-pair-test 20
+   ./heap-pair-test 20 0 0 1
+
+   heap-pair-test can be run with any subset of command line arguments in
+   the above-defined order. If the (i + 1)th argument is specified then the
+   ith argument must be specified for i >= 0. Default values are used for
+   the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the only requirement that CHAR_BIT * sizeof(size_t)
+   is greater or equal to 16 and is even.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "heap-pair.h"
+#include "heap.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "heap-pair-test\n"
+  "[0, # bits in size_t - 1) : i s.t. # elements = 2^i\n"
+  "[0, 1] : on/off push pop free test\n"
+  "[0, 1] : on/off update search reset test\n"
+  "[0, 1] : on/off decrease-heavy comparison test with heap_t\n";
+const int C_ARGC_MAX = 5;
+const size_t C_ARGS_DEF[4] = {14, 1, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* decrease-heavy comparison test */
+const size_t C_NUM_DECR_ROUNDS = 8;
+
+int cmp_uint(const void *a, const void *b);
+size_t rand_pty(void);
+void pop_check(heap_pair_t *h, const size_t *ptys, size_t n, int *res);
+void print_test_result(int res);
+
+/**
+   Runs a heap_pair_{push, pop, free} test on size_t priorities in the
+   increasing, decreasing and random order of elements.
+*/
+void run_push_pop_free_test(size_t log_ins){
+  int res = 1;
+  size_t i, j, n;
+  size_t *ptys = NULL;
+  clock_t t_push, t_pop;
+  heap_pair_t h;
+  const char *orders[3] = {"increasing", "decreasing", "random"};
+  n = pow_two_perror(log_ins);
+  ptys = malloc_perror(n, sizeof(size_t));
+  heap_pair_init(&h, sizeof(size_t), n, cmp_uint);
+  printf("Run a heap_pair_{push, pop, free} test on size_t priorities\n");
+  printf("\tnumber of elements: %lu\n", TOLU(n));
+  for (j = 0; j < 3; j++){
+    for (i = 0; i < n; i++){
+      if (j == 0){
+	ptys[i] = i;
+      }else if (j == 1){
+	ptys[i] = n - 1 - i;
+      }else{
+	ptys[i] = rand_pty();
+      }
+    }
+    t_push = clock();
+    for (i = 0; i < n; i++){
+      heap_pair_push(&h, &ptys[i], &i);
+    }
+    t_push = clock() - t_push;
+    res *= (h.num_elts == n);
+    t_pop = clock();
+    pop_check(&h, ptys, n, &res);
+    t_pop = clock() - t_pop;
+    printf("\t\t%s priorities\n"
+	   "\t\t\tpush time:          %.4f seconds\n"
+	   "\t\t\tpop time:           %.4f seconds\n",
+	   orders[j],
+	   (double)t_push / CLOCKS_PER_SEC,
+	   (double)t_pop / CLOCKS_PER_SEC);
+  }
+  heap_pair_free(&h);
+  printf("\t\torder correctness:    ");
+  print_test_result(res);
+  free(ptys);
+  ptys = NULL;
+}
+
+/**
+   Runs a heap_pair_{update, search, reset} test on random size_t
+   priorities with decreases and increases of priorities, and pops of half
+   of the elements between the rounds of updates.
+*/
+void run_update_search_reset_test(size_t log_ins){
+  int res = 1;
+  size_t i, j, n, pty = 0, elt = 0, num_popped = 0;
+  size_t *ptys = NULL;
+  char *popped = NULL;
+  void *p = NULL;
+  heap_pair_t h;
+  n = pow_two_perror(log_ins);
+  ptys = malloc_perror(n, sizeof(size_t));
+  popped = calloc_perror(n, 1);
+  heap_pair_init(&h, sizeof(size_t), n, cmp_uint);
+  printf("Run a heap_pair_{update, search, reset} test on random size_t "
+	 "priorities\n");
+  printf("\tnumber of elements: %lu\n", TOLU(n));
+  for (i = 0; i < n; i++){
+    ptys[i] = rand_pty();
+    heap_pair_push(&h, &ptys[i], &i);
+  }
+  for (j = 0; j < 2; j++){
+    for (i = 0; i < n; i++){
+      if (popped[i]) continue;
+      /* decrease in even and increase in odd elements, or the reverse */
+      ptys[i] = ((i + j) & 1) ? ptys[i] / 2 : ptys[i] + rand_pty() / 2;
+      heap_pair_update(&h, &ptys[i], &i);
+      p = heap_pair_search(&h, &i);
+      res *= (p != NULL && *(size_t *)p == ptys[i]);
+    }
+    /* pop a half of the remaining elements */
+    for (i = 0; i < (n - num_popped) / 2; i++){
+      heap_pair_pop(&h, &pty, &elt);
+      res *= (pty == ptys[elt] && !popped[elt]);
+      popped[elt] = 1;
+    }
+    num_popped += i;
+    for (i = 0; i < n; i++){
+      p = heap_pair_search(&h, &i);
+      res *= ((p == NULL) == popped[i]);
+    }
+  }
+  res *= (h.num_elts == n - num_popped);
+  i = n;
+  res *= (heap_pair_search(&h, &i) == NULL);
+  heap_pair_reset(&h);
+  res *= (h.num_elts == 0);
+  for (i = 0; i < n; i++){
+    res *= (heap_pair_search(&h, &i) == NULL);
+  }
+  /* reuse after reset */
+  for (i = 0; i < n; i++){
+    ptys[i] = rand_pty();
+    heap_pair_push(&h, &ptys[i], &i);
+  }
+  pop_check(&h, ptys, n, &res);
+  heap_pair_reset(&h);
+  heap_pair_free(&h);
+  printf("\t\tcorrectness:          ");
+  print_test_result(res);
+  free(ptys);
+  free(popped);
+  ptys = NULL;
+  popped = NULL;
+}
+
+/**
+   Runs a test with rounds of decreases of the priorities of all elements
+   between pushes and pops, on a pairing heap and on a binary heap_t with
+   an index array, and compares the popped priorities.
+*/
+void run_decr_cmp_test(size_t log_ins){
+  int res = 1;
+  size_t i, j, n;
+  size_t pty, elt, pty_h, elt_h;
+  size_t *ptys = NULL, *decr = NULL;
+  clock_t t_pair, t_heap;
+  heap_pair_t hp;
+  heap_t h;
+  n = pow_two_perror(log_ins);
+  ptys = malloc_perror(n, sizeof(size_t));
+  decr = malloc_perror(n, sizeof(size_t));
+  for (i = 0; i < n; i++){
+    ptys[i] = rand_pty();
+    decr[i] = rand_pty() % (C_NUM_DECR_ROUNDS + 1);
+  }
+  printf("Run a decrease-heavy comparison test with %lu rounds of "
+	 "decreases\n", TOLU(C_NUM_DECR_ROUNDS));
+  printf("\tnumber of elements: %lu\n", TOLU(n));
+  heap_pair_init(&hp, sizeof(size_t), n, cmp_uint);
+  t_pair = clock();
+  for (i = 0; i < n; i++){
+    heap_pair_push(&hp, &ptys[i], &i);
+  }
+  for (j = 0; j < C_NUM_DECR_ROUNDS; j++){
+    for (i = 0; i < n; i++){
+      pty = *(size_t *)heap_pair_search(&hp, &i);
+      pty -= (pty >= decr[i]) ? decr[i] : pty;
+      heap_pair_update(&hp, &pty, &i);
+    }
+  }
+  t_pair = clock() - t_pair;
+  heap_init(&h, sizeof(size_t), sizeof(size_t), n, 0, 0, NULL, cmp_uint,
+	    NULL, NULL, NULL);
+  t_heap = clock();
+  for (i = 0; i < n; i++){
+    heap_push(&h, &ptys[i], &i);
+  }
+  for (j = 0; j < C_NUM_DECR_ROUNDS; j++){
+    for (i = 0; i < n; i++){
+      pty = *(size_t *)heap_search(&h, &i);
+      pty -= (pty >= decr[i]) ? decr[i] : pty;
+      heap_update(&h, &pty, &i);
+    }
+  }
+  t_heap = clock() - t_heap;
+  for (i = 0; i < n; i++){
+    heap_pair_pop(&hp, &pty, &elt);
+    heap_pop(&h, &pty_h, &elt_h);
+    res *= (pty == pty_h);
+  }
+  res *= (hp.num_elts == 0 && h.num_elts == 0);
+  heap_pair_free(&hp);
+  heap_free(&h);
+  printf("\t\theap_pair push and update time:  %.4f seconds\n"
+	 "\t\theap_t push and update time:     %.4f seconds\n",
+	 (double)t_pair / CLOCKS_PER_SEC,
+	 (double)t_heap / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                     ");
+  print_test_result(res);
+  free(ptys);
+  free(decr);
+  ptys = NULL;
+  decr = NULL;
+}
+
+/**
+   Compares size_t priorities.
+*/
+int cmp_uint(const void *a, const void *b){
+  if (*(const size_t *)a > *(const size_t *)b){
+    return 1;
+  }else if (*(const size_t *)a < *(const size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/**
+   Returns a random size_t priority that is less than SIZE_MAX / 2.
+*/
+size_t rand_pty(void){
+  return ((size_t)RANDOM() * ((size_t)RAND_MAX + 1) + RANDOM()) >> 1;
+}
+
+/**
+   Pops all n elements of a heap and tests that the priorities are popped
+   in the non-decreasing order, and each popped priority is the priority
+   of its element in the ptys array.
+*/
+void pop_check(heap_pair_t *h, const size_t *ptys, size_t n, int *res){
+  size_t i, pty = 0, elt = 0, prev_pty = 0;
+  for (i = 0; i < n; i++){
+    heap_pair_pop(h, &pty, &elt);
+    *res *= (prev_pty <= pty && ptys[elt] == pty);
+    prev_pty = pty;
+  }
+  *res *= (h->num_elts == 0);
+}
+
+/**
+   Prints a test result.
+*/
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  if (argc > C_ARGC_MAX){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > 1 ||
+      args[2] > 1 ||
+      args[3] > 1){
+    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[1]) run_push_pop_free_test(args[0]);
+  if (args[2]) run_update_search_reset_test(args[0]);
+  if (args[3]) run_decr_cmp_test(args[0]);
+  free(args);
+  args = NULL;
+  return 0;
+}
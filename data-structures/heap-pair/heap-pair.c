@@ -0,0 +1,300 @@
+/**
+   heap-pair.c
+
+   Implementation of a pairing (min) heap with size_t elements in [0, n)
+   and priority values of basic type (e.g. char, int, long, double) or
+   custom priorities within a contiguous block.
+
+   The heap has the push, search, update and pop semantics of a heap_t
+   with an index array. A heap is a tree where the priority of a node is
+   not greater than the priorities of its children. A push and a decrease
+   of a priority link a single node with the root in O(1) time, and a pop
+   merges the children of the root in a two-pass pairing in O(log n)
+   amortized time. The decrease of a priority runs in o(log n) amortized
+   time, so that the heap is suitable for algorithms that decrease
+   priorities more often than they pop, such as Dijkstra's algorithm on
+   dense graphs.
+
+   The nodes of a heap are in a pool that is allocated once with a node
+   for each element in [0, n), and an element is the index of its node.
+   The children of a node are in a list from the leftmost child by right
+   sibling links, and the prev link of a node points to its left sibling,
+   or to its parent if the node is a leftmost child, so that a subtree is
+   cut in O(1) time. The prev link of the root is C_ROOT, and of a node of
+   an element that is not in a heap is C_NIL. The priorities are in an
+   array that is parallel to the pool.
+
+   The first pass of a pairing links the pairs of children from left to
+   right and keeps the linked roots in a list in the reverse order by
+   their right sibling links, and the second pass links the roots in the
+   list, so that no memory is allocated.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heap-pair.h"
+#include "utilities-mem.h"
+
+static const size_t C_NIL = (size_t)-1; /* no node, or not in a heap */
+static const size_t C_ROOT = (size_t)-2; /* prev link of the root */
+
+static size_t link_roots(heap_pair_t *h, size_t a, size_t b);
+static void cut(heap_pair_t *h, size_t x);
+static size_t merge_pairs(heap_pair_t *h, size_t c);
+static void set_root(heap_pair_t *h, size_t r);
+static void *pty_ptr(const heap_pair_t *h, size_t i);
+static void fprintf_stderr_exit(const char *s, int line);
+
+/**
+   Initializes a pairing heap with a pool of count nodes.
+   h           : pointer to a preallocated block of size
+                 sizeof(heap_pair_t)
+   pty_size    : size of a contiguous priority object
+   count       : > 0 number of nodes; an element is a size_t value in
+                 [0, count)
+   cmp_pty     : comparison function which returns a negative integer value
+                 if the priority value pointed to by the first argument is
+                 less than the priority value pointed to by the second, a
+                 positive integer value if the priority value pointed to by
+                 the first argument is greater than the priority value
+                 pointed to by the second, and zero integer value if the two
+                 priority values are equal
+*/
+void heap_pair_init(heap_pair_t *h,
+		    size_t pty_size,
+		    size_t count,
+		    int (*cmp_pty)(const void *, const void *)){
+  size_t i;
+  if (count == 0 || count >= C_ROOT){
+    fprintf_stderr_exit("count is not in [1, SIZE_MAX - 1)", __LINE__);
+  }
+  h->pty_size = pty_size;
+  h->count = count;
+  h->num_elts = 0;
+  h->root = C_NIL;
+  h->ptys = malloc_large_perror(count, pty_size);
+  h->nodes = malloc_large_perror(count, sizeof(heap_pair_node_t));
+  for (i = 0; i < count; i++){
+    h->nodes[i].child = C_NIL;
+    h->nodes[i].next = C_NIL;
+    h->nodes[i].prev = C_NIL;
+  }
+  h->cmp_pty = cmp_pty;
+}
+
+/**
+   Pushes an element not in a heap and an associated priority value in
+   O(1) time.
+   h           : pointer to an initialized heap
+   pty         : pointer to a block of size pty_size
+   elt         : pointer to a size_t element in [0, count)
+*/
+void heap_pair_push(heap_pair_t *h, const void *pty, const size_t *elt){
+  size_t x = *elt;
+  memcpy(pty_ptr(h, x), pty, h->pty_size);
+  h->nodes[x].child = C_NIL;
+  if (h->root == C_NIL){
+    set_root(h, x);
+  }else{
+    set_root(h, link_roots(h, h->root, x));
+  }
+  h->num_elts++;
+}
+
+/**
+   Returns a pointer to the priority of an element in a heap or NULL if the
+   element is not in the heap in O(1) time. NULL is also returned for an
+   element that is not less than count. The returned pointer is guaranteed
+   to point to the current priority value until another heap operation is
+   performed.
+*/
+void *heap_pair_search(const heap_pair_t *h, const size_t *elt){
+  size_t x = *elt;
+  if (x >= h->count || h->nodes[x].prev == C_NIL) return NULL;
+  return pty_ptr(h, x);
+}
+
+/**
+   Updates the priority value of an element that is in a heap. A decrease
+   of the priority value cuts the subtree of the element and links it with
+   the root in O(1) time. An increase also merges the children of the
+   element, in O(log n) amortized time. Please see the parameter
+   specification in heap_pair_push.
+*/
+void heap_pair_update(heap_pair_t *h, const void *pty, const size_t *elt){
+  size_t x = *elt, r;
+  int c = h->cmp_pty(pty, pty_ptr(h, x));
+  memcpy(pty_ptr(h, x), pty, h->pty_size);
+  if (c == 0) return;
+  if (c < 0){
+    if (x == h->root) return;
+    cut(h, x);
+    set_root(h, link_roots(h, h->root, x));
+    return;
+  }
+  /* increase: x is linked again without its children */
+  r = merge_pairs(h, h->nodes[x].child);
+  h->nodes[x].child = C_NIL;
+  if (x == h->root){
+    set_root(h, (r == C_NIL) ? x : link_roots(h, x, r));
+    return;
+  }
+  cut(h, x);
+  if (r != C_NIL) x = link_roots(h, x, r);
+  set_root(h, link_roots(h, h->root, x));
+}
+
+/**
+   Pops an element associated with a minimal priority value in a heap
+   according to cmp_pty in O(log n) amortized time. If the heap is empty,
+   the memory blocks pointed to by elt and pty remain unchanged.
+*/
+void heap_pair_pop(heap_pair_t *h, void *pty, size_t *elt){
+  size_t x = h->root, r;
+  if (h->num_elts == 0) return;
+  memcpy(pty, pty_ptr(h, x), h->pty_size);
+  *elt = x;
+  r = merge_pairs(h, h->nodes[x].child);
+  h->nodes[x].child = C_NIL;
+  h->nodes[x].prev = C_NIL;
+  h->root = C_NIL;
+  if (r != C_NIL) set_root(h, r);
+  h->num_elts--;
+}
+
+/**
+   Deletes all elements and their priority values from a heap, keeping the
+   pool of nodes, in O(number of elements in the heap) time.
+*/
+void heap_pair_reset(heap_pair_t *h){
+  size_t x = h->root, c, last, next;
+  heap_pair_node_t *nodes = h->nodes;
+  /* the children of x are spliced after x in a list of remaining nodes */
+  while (x != C_NIL){
+    c = nodes[x].child;
+    if (c != C_NIL){
+      last = c;
+      while (nodes[last].next != C_NIL) last = nodes[last].next;
+      nodes[last].next = nodes[x].next;
+      nodes[x].next = c;
+    }
+    next = nodes[x].next;
+    nodes[x].child = C_NIL;
+    nodes[x].next = C_NIL;
+    nodes[x].prev = C_NIL;
+    x = next;
+  }
+  h->root = C_NIL;
+  h->num_elts = 0;
+}
+
+/**
+   Frees a heap and leaves a block of size sizeof(heap_pair_t) pointed to
+   by the h parameter.
+*/
+void heap_pair_free(heap_pair_t *h){
+  free_large(h->ptys);
+  free_large(h->nodes);
+  h->ptys = NULL;
+  h->nodes = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Links two roots of disjoint trees, and returns the root with a minimal
+   priority, with the other root as its leftmost child. The links of the
+   returned root to its siblings and parent are not updated.
+*/
+static size_t link_roots(heap_pair_t *h, size_t a, size_t b){
+  size_t t;
+  heap_pair_node_t *nodes = h->nodes;
+  if (h->cmp_pty(pty_ptr(h, b), pty_ptr(h, a)) < 0){
+    t = a;
+    a = b;
+    b = t;
+  }
+  nodes[b].next = nodes[a].child;
+  if (nodes[a].child != C_NIL) nodes[nodes[a].child].prev = b;
+  nodes[b].prev = a;
+  nodes[a].child = b;
+  return a;
+}
+
+/**
+   Cuts the subtree of a node that is not the root from its parent and
+   siblings.
+*/
+static void cut(heap_pair_t *h, size_t x){
+  heap_pair_node_t *nodes = h->nodes;
+  size_t p = nodes[x].prev;
+  if (nodes[p].child == x){
+    nodes[p].child = nodes[x].next;
+  }else{
+    nodes[p].next = nodes[x].next;
+  }
+  if (nodes[x].next != C_NIL) nodes[nodes[x].next].prev = p;
+  nodes[x].next = C_NIL;
+}
+
+/**
+   Merges the trees in the list of siblings from c with a two-pass pairing,
+   and returns the root of the merged tree, or C_NIL if c is C_NIL. The
+   first pass keeps the roots of the linked pairs in a list in the reverse
+   order, which the second pass links from right to left.
+*/
+static size_t merge_pairs(heap_pair_t *h, size_t c){
+  size_t a, b, r, next, list = C_NIL;
+  heap_pair_node_t *nodes = h->nodes;
+  while (c != C_NIL){
+    a = c;
+    b = nodes[a].next;
+    if (b == C_NIL){
+      next = C_NIL;
+      r = a;
+    }else{
+      next = nodes[b].next;
+      r = link_roots(h, a, b);
+    }
+    nodes[r].next = list;
+    list = r;
+    c = next;
+  }
+  if (list == C_NIL) return C_NIL;
+  r = list;
+  list = nodes[r].next;
+  while (list != C_NIL){
+    next = nodes[list].next;
+    r = link_roots(h, r, list);
+    list = next;
+  }
+  return r;
+}
+
+/**
+   Sets a node as the root of a heap.
+*/
+static void set_root(heap_pair_t *h, size_t r){
+  h->root = r;
+  h->nodes[r].next = C_NIL;
+  h->nodes[r].prev = C_ROOT;
+}
+
+/**
+   Computes a pointer to the priority of an element.
+*/
+static void *pty_ptr(const heap_pair_t *h, size_t i){
+  return (void *)((char *)h->ptys + i * h->pty_size);
+}
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
+}
@@ -0,0 +1,114 @@
+/**
+   heap-pair.h
+
+   Struct declarations and declarations of accessible functions of a
+   pairing (min) heap with size_t elements in [0, n) and priority values
+   of basic type (e.g. char, int, long, double) or custom priorities within
+   a contiguous block.
+
+   The heap has the push, search, update and pop semantics of a heap_t
+   with an index array. A heap is a tree where the priority of a node is
+   not greater than the priorities of its children. A push and a decrease
+   of a priority link a single node with the root in O(1) time, and a pop
+   merges the children of the root in a two-pass pairing in O(log n)
+   amortized time. The decrease of a priority runs in o(log n) amortized
+   time, so that the heap is suitable for algorithms that decrease
+   priorities more often than they pop, such as Dijkstra's algorithm on
+   dense graphs.
+
+   The nodes of a heap are in a pool that is allocated once with a node
+   for each element in [0, n), and an element is the index of its node.
+   No memory is allocated by heap operations after heap_pair_init.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#ifndef HEAP_PAIR_H
+#define HEAP_PAIR_H
+
+#include <stddef.h>
+
+typedef struct{
+  size_t child; /* leftmost child */
+  size_t next; /* right sibling */
+  size_t prev; /* left sibling, or parent if a node is a leftmost child */
+} heap_pair_node_t;
+
+typedef struct{
+  size_t pty_size;
+  size_t count; /* number of nodes in the pool */
+  size_t num_elts;
+  size_t root;
+  void *ptys; /* priority of each element in [0, count) */
+  heap_pair_node_t *nodes;
+  int (*cmp_pty)(const void *, const void *);
+} heap_pair_t;
+
+/**
+   Initializes a pairing heap with a pool of count nodes.
+   h           : pointer to a preallocated block of size
+                 sizeof(heap_pair_t)
+   pty_size    : size of a contiguous priority object
+   count       : > 0 number of nodes; an element is a size_t value in
+                 [0, count)
+   cmp_pty     : comparison function which returns a negative integer value
+                 if the priority value pointed to by the first argument is
+                 less than the priority value pointed to by the second, a
+                 positive integer value if the priority value pointed to by
+                 the first argument is greater than the priority value
+                 pointed to by the second, and zero integer value if the two
+                 priority values are equal
+*/
+void heap_pair_init(heap_pair_t *h,
+		    size_t pty_size,
+		    size_t count,
+		    int (*cmp_pty)(const void *, const void *));
+
+/**
+   Pushes an element not in a heap and an associated priority value in
+   O(1) time.
+   h           : pointer to an initialized heap
+   pty         : pointer to a block of size pty_size
+   elt         : pointer to a size_t element in [0, count)
+*/
+void heap_pair_push(heap_pair_t *h, const void *pty, const size_t *elt);
+
+/**
+   Returns a pointer to the priority of an element in a heap or NULL if the
+   element is not in the heap in O(1) time. NULL is also returned for an
+   element that is not less than count. The returned pointer is guaranteed
+   to point to the current priority value until another heap operation is
+   performed.
+*/
+void *heap_pair_search(const heap_pair_t *h, const size_t *elt);
+
+/**
+   Updates the priority value of an element that is in a heap. A decrease
+   of the priority value cuts the subtree of the element and links it with
+   the root in O(1) time. An increase also merges the children of the
+   element, in O(log n) amortized time. Please see the parameter
+   specification in heap_pair_push.
+*/
+void heap_pair_update(heap_pair_t *h, const void *pty, const size_t *elt);
+
+/**
+   Pops an element associated with a minimal priority value in a heap
+   according to cmp_pty in O(log n) amortized time. If the heap is empty,
+   the memory blocks pointed to by elt and pty remain unchanged.
+*/
+void heap_pair_pop(heap_pair_t *h, void *pty, size_t *elt);
+
+/**
+   Deletes all elements and their priority values from a heap, keeping the
+   pool of nodes, in O(number of elements in the heap) time.
+*/
+void heap_pair_reset(heap_pair_t *h);
+
+/**
+   Frees a heap and leaves a block of size sizeof(heap_pair_t) pointed to
+   by the h parameter.
+*/
+void heap_pair_free(heap_pair_t *h);
+
+#endif
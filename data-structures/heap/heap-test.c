@@ -2,8 +2,9 @@
    heap-test.c
 
    Tests of a generic (min) heap with a hash table parameter across 
-   i) division- and mutliplication-based hash tables, ii) contiguous and
-   noncontiguous elements, and iii) priority types.
+   i) division- and mutliplication-based hash tables and an index array,
+   ii) contiguous and noncontiguous elements, iii) priority types, and
+   iv) heap arities.
 
    The following command line arguments can be used to customize tests:
    heap-test
@@ -16,6 +17,10 @@
       [0, 1] : on/off update search division hash table test
       [0, 1] : on/off push pop free multiplication hash table test
       [0, 1] : on/off update search multiplication hash table test
+      [0, 1] : on/off push pop free index array test
+      [0, 1] : on/off update search index array test
+      [0, 1] : on/off structure-of-arrays index array test
+      [0, 1] : on/off bounded top-k test
 
    usage examples:
    ./heap-test
@@ -26,6 +31,7 @@
    ./heap-test 20 1 0 10 10 0 0
    ./heap-test 20 1 0 1 0 0 0
    ./heap-test 20 1 0 100 0 0 0
+   ./heap-test 20 1 0 341 10 0 0 0 0 0 0 0 1
 
    heap-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -48,6 +54,7 @@
 #include "utilities-mem.h"
 #include "utilities-mod.h"
 
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
 #define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
 
 /* input handling */
@@ -57,23 +64,43 @@ const char *C_USAGE =
   "> 0 : a\n"
   "< # bits in size_t : b s.t. 0.0 < a / 2**b\n"
   "> 0 : c\n"
-  "< # bits in size_t : d s.t. 0.0 < c / 2**d <= 1.0\n"
+  "< # bits in size_t : d s.t. 0.0 < c / 2**d <= 1.0\n";
+const char *C_USAGE_TESTS = /* each string literal within 509 characters */
   "[0, 1] : on/off push pop free division hash table test\n"
   "[0, 1] : on/off update search division hash table test\n"
   "[0, 1] : on/off push pop free multiplication hash table test\n"
-  "[0, 1] : on/off update search multiplication hash table test\n";
-const int C_ARGC_MAX = 10;
-const size_t C_ARGS_DEF[9] = {14, 1, 0, 341, 10, 1, 1, 1, 1};
+  "[0, 1] : on/off update search multiplication hash table test\n"
+  "[0, 1] : on/off push pop free index array test\n"
+  "[0, 1] : on/off update search index array test\n"
+  "[0, 1] : on/off structure-of-arrays index array test\n"
+  "[0, 1] : on/off bounded top-k test\n";
+const int C_ARGC_MAX = 14;
+const size_t C_ARGS_DEF[13] = {14, 1, 0, 341, 10, 1, 1, 1, 1, 1, 1, 1, 1};
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
+/* arities of heaps in index array tests */
+const int C_LOG_ARITIES_COUNT = 3;
+const size_t C_LOG_ARITIES[3] = {1, 2, 3};
+const size_t C_CHN_ALIGNMENT = 64;
+
+/* bounded top-k tests */
+const int C_TOPK_KS_COUNT = 3;
+const size_t C_TOPK_KS[3] = {1, 32, 1024};
+const int C_TOPK_MODES_COUNT = 3;
+const char *C_TOPK_MODES[3] = {"binary",
+			       "4-ary, aligned children",
+			       "8-ary, aligned children, SoA, size_t"};
+
 /* tests */
 const int C_PTY_TYPES_COUNT = 3;
 const char *C_PTY_TYPES[3] = {"size_t", "double", "long double"};
 const size_t C_PTY_SIZES[3] = {sizeof(size_t),
 			       sizeof(double),
 			       sizeof(long double)};
+const int C_PTY_SOA_TYPES[3] = {HEAP_PTY_SZ, HEAP_PTY_DOUBLE, HEAP_PTY_GEN};
 
 int cmp_uint(const void *a, const void *b);
+int cmp_uint_rev(const void *a, const void *b);
 int cmp_double(const void *a, const void *b);
 int cmp_long_double(const void *a, const void *b);
 void new_uint(void *a, size_t val);
@@ -86,26 +113,35 @@ int (*const C_CMP_PTY_ARR[3])(const void *, const void *) ={cmp_uint,
 void (*const C_NEW_PTY_ARR[3])(void *, size_t) = {new_uint,
 						  new_double,
 						  new_long_double};
-const size_t C_H_INIT_COUNT = 1;
 
 void push_pop_free(size_t num_ins,
 		   size_t pty_size,
 		   size_t elt_size,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t log_arity,
 		   const heap_ht_t *hht,
 		   int (*cmp_pty)(const void *, const void *),
 		   int (*cmp_elt)(const void *, const void *),
 		   void (*new_pty)(void *, size_t),
 		   void (*new_elt)(void *, size_t),
-		   void (*free_elt)(void *));
+		   void (*free_elt)(void *),
+		   int is_soa,
+		   int pty_type);
 void update_search(size_t num_ins,
 		   size_t pty_size,
 		   size_t elt_size,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t log_arity,
 		   const heap_ht_t *hht,
 		   int (*cmp_pty)(const void *, const void *),
 		   int (*cmp_elt)(const void *, const void *),
 		   void (*new_pty)(void *, size_t),
 		   void (*new_elt)(void *, size_t),
-		   void (*free_elt)(void *));
+		   void (*free_elt)(void *),
+		   int is_soa,
+		   int pty_type);
 void *ptr(const void *block, size_t i, size_t size);
 void print_test_result(int res);
 
@@ -127,6 +163,10 @@ int cmp_uint(const void *a, const void *b){
   }
 }
 
+int cmp_uint_rev(const void *a, const void *b){
+  return cmp_uint(b, a);
+}
+
 int cmp_double(const void *a, const void *b){
   if (*(double *)a > *(double *)b){
     return 1;
@@ -162,48 +202,6 @@ void new_long_double(void *a, size_t val){
   *s = val;
 }
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} ht_divchn_context_t;
-
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-  size_t (*rdc_key)(const void *, size_t);
-} ht_muloa_context_t;
-
-void ht_divchn_uint_init_helper(ht_divchn_t *ht,
-			   size_t key_size,
-			   size_t elt_size,
-			   void (*free_elt)(void *),
-			   void *context){
-  ht_divchn_context_t *c = context;
-  ht_divchn_init(ht,
-		 key_size,
-		 elt_size,
-		 0,
-		 c->alpha_n,
-		 c->log_alpha_d,
-		 free_elt);
-}
-
-void ht_muloa_init_helper(ht_muloa_t *ht,
-			  size_t key_size,
-			  size_t elt_size,
-			  void (*free_elt)(void *),
-			  void *context){
-  ht_muloa_context_t * c = context;
-  ht_muloa_init(ht,
-		key_size,
-		elt_size,
-		0,
-		c->alpha_n,
-		c->log_alpha_d,
-		c->rdc_key,
-		free_elt);
-}
-
 /**
    Runs a heap_{push, pop, free} test with a ht_divchn_t hash table on
    size_t elements across priority types.
@@ -214,18 +212,15 @@ void run_push_pop_free_divchn_uint_test(size_t log_ins,
   int i;
   size_t n;
   ht_divchn_t ht_divchn;
-  ht_divchn_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
   hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht.init = ht_divchn_init_helper;
+  hht.align = ht_divchn_align_helper;
+  hht.insert = ht_divchn_insert_helper;
+  hht.search = ht_divchn_search_helper;
+  hht.remove = ht_divchn_remove_helper;
+  hht.free = ht_divchn_free_helper;
   printf("Run a heap_{push, pop, free} test with a ht_divchn_t "
 	 "hash table on size_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -237,12 +232,17 @@ void run_push_pop_free_divchn_uint_test(size_t log_ins,
     push_pop_free(n,
 		  C_PTY_SIZES[i],
 		  sizeof(size_t),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint,
 		  C_NEW_PTY_ARR[i],
 		  new_uint,
-		  NULL);
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -256,18 +256,15 @@ void run_update_search_divchn_uint_test(size_t log_ins,
   int i;
   size_t n;
   ht_divchn_t ht_divchn;
-  ht_divchn_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
   hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht.init = ht_divchn_init_helper;
+  hht.align = ht_divchn_align_helper;
+  hht.insert = ht_divchn_insert_helper;
+  hht.search = ht_divchn_search_helper;
+  hht.remove = ht_divchn_remove_helper;
+  hht.free = ht_divchn_free_helper;
   printf("Run a heap_{update, search} test with a ht_divchn_t "
 	 "hash table on size_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -279,12 +276,17 @@ void run_update_search_divchn_uint_test(size_t log_ins,
     update_search(n,
 		  C_PTY_SIZES[i],
 		  sizeof(size_t),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint,
 		  C_NEW_PTY_ARR[i],
 		  new_uint,
-		  NULL);
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -298,19 +300,15 @@ void run_push_pop_free_muloa_uint_test(size_t log_ins,
   int i;
   size_t n;
   ht_muloa_t ht_muloa;
-  ht_muloa_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
-  context.rdc_key = NULL;
   hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht.init = ht_muloa_init_helper;
+  hht.align = ht_muloa_align_helper;
+  hht.insert = ht_muloa_insert_helper;
+  hht.search = ht_muloa_search_helper;
+  hht.remove = ht_muloa_remove_helper;
+  hht.free = ht_muloa_free_helper;
   printf("Run a heap_{push, pop, free} test with a ht_muloa_t "
 	 "hash table on size_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -323,12 +321,17 @@ void run_push_pop_free_muloa_uint_test(size_t log_ins,
     push_pop_free(n,
 		  C_PTY_SIZES[i],
 		  sizeof(size_t),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint,
 		  C_NEW_PTY_ARR[i],
 		  new_uint,
-		  NULL);
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -342,19 +345,15 @@ void run_update_search_muloa_uint_test(size_t log_ins,
   int i;
   size_t n;
   ht_muloa_t ht_muloa;
-  ht_muloa_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
-  context.rdc_key = NULL;
   hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht.init = ht_muloa_init_helper;
+  hht.align = ht_muloa_align_helper;
+  hht.insert = ht_muloa_insert_helper;
+  hht.search = ht_muloa_search_helper;
+  hht.remove = ht_muloa_remove_helper;
+  hht.free = ht_muloa_free_helper;
   printf("Run a heap_{update, search} test with a ht_muloa_t "
 	 "hash table on size_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -367,12 +366,133 @@ void run_update_search_muloa_uint_test(size_t log_ins,
     update_search(n,
 		  C_PTY_SIZES[i],
 		  sizeof(size_t),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint,
 		  C_NEW_PTY_ARR[i],
 		  new_uint,
-		  NULL);
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
+  }
+}
+
+/**
+   Runs a heap_{push, pop, free} test with an index array on size_t
+   elements with a given arity across priority types.
+*/
+void run_push_pop_free_ix_uint_test(size_t log_ins, size_t log_arity){
+  int i;
+  size_t n;
+  n = pow_two_perror(log_ins);
+  printf("Run a heap_{push, pop, free} test with an index array "
+	 "on size_t elements\n");
+  for (i = 0; i < C_PTY_TYPES_COUNT; i++){
+    printf("\tnumber of elements:      %lu\n"
+	   "\tarity:                   %lu\n"
+	   "\tpriority type:           %s\n",
+	   TOLU(n), TOLU(pow_two_perror(log_arity)), C_PTY_TYPES[i]);
+    push_pop_free(n,
+		  C_PTY_SIZES[i],
+		  sizeof(size_t),
+		  0,
+		  0,
+		  log_arity,
+		  NULL,
+		  C_CMP_PTY_ARR[i],
+		  cmp_uint,
+		  C_NEW_PTY_ARR[i],
+		  new_uint,
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
+  }
+}
+
+/**
+   Runs a heap_{update, search} test with an index array on size_t
+   elements with a given arity across priority types.
+*/
+void run_update_search_ix_uint_test(size_t log_ins, size_t log_arity){
+  int i;
+  size_t n;
+  n = pow_two_perror(log_ins);
+  printf("Run a heap_{update, search} test with an index array "
+	 "on size_t elements\n");
+  for (i = 0; i < C_PTY_TYPES_COUNT; i++){
+    printf("\tnumber of elements:      %lu\n"
+	   "\tarity:                   %lu\n"
+	   "\tpriority type:           %s\n",
+	   TOLU(n), TOLU(pow_two_perror(log_arity)), C_PTY_TYPES[i]);
+    update_search(n,
+		  C_PTY_SIZES[i],
+		  sizeof(size_t),
+		  0,
+		  0,
+		  log_arity,
+		  NULL,
+		  C_CMP_PTY_ARR[i],
+		  cmp_uint,
+		  C_NEW_PTY_ARR[i],
+		  new_uint,
+		  NULL,
+		  0,
+		  HEAP_PTY_GEN);
+  }
+}
+
+/**
+   Runs heap_{push, pop, free} and heap_{update, search} tests with an
+   index array on size_t elements with a given arity across priority
+   types in the structure-of-arrays layout. The size_t and double
+   priorities are compared with specialized comparisons, and the long
+   double priorities with cmp_pty.
+*/
+void run_soa_ix_uint_test(size_t log_ins, size_t log_arity){
+  int i;
+  size_t n;
+  n = pow_two_perror(log_ins);
+  printf("Run heap_{push, pop, free} and heap_{update, search} tests "
+	 "with an index array on size_t elements in the structure-of-arrays "
+	 "layout\n");
+  for (i = 0; i < C_PTY_TYPES_COUNT; i++){
+    printf("\tnumber of elements:      %lu\n"
+	   "\tarity:                   %lu\n"
+	   "\tpriority type:           %s\n"
+	   "\tspecialized comparison:  %s\n",
+	   TOLU(n), TOLU(pow_two_perror(log_arity)), C_PTY_TYPES[i],
+	   (C_PTY_SOA_TYPES[i] == HEAP_PTY_GEN) ? "no" : "yes");
+    push_pop_free(n,
+		  C_PTY_SIZES[i],
+		  sizeof(size_t),
+		  0,
+		  0,
+		  log_arity,
+		  NULL,
+		  C_CMP_PTY_ARR[i],
+		  cmp_uint,
+		  C_NEW_PTY_ARR[i],
+		  new_uint,
+		  NULL,
+		  1,
+		  C_PTY_SOA_TYPES[i]);
+    update_search(n,
+		  C_PTY_SIZES[i],
+		  sizeof(size_t),
+		  0,
+		  0,
+		  log_arity,
+		  NULL,
+		  C_CMP_PTY_ARR[i],
+		  cmp_uint,
+		  C_NEW_PTY_ARR[i],
+		  new_uint,
+		  NULL,
+		  1,
+		  C_PTY_SOA_TYPES[i]);
   }
 }
 
@@ -425,18 +545,15 @@ void run_push_pop_free_divchn_uint_ptr_test(size_t log_ins,
   int i;
   size_t n;
   ht_divchn_t ht_divchn;
-  ht_divchn_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
   hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht.init = ht_divchn_init_helper;
+  hht.align = ht_divchn_align_helper;
+  hht.insert = ht_divchn_insert_helper;
+  hht.search = ht_divchn_search_helper;
+  hht.remove = ht_divchn_remove_helper;
+  hht.free = ht_divchn_free_helper;
   printf("Run a heap_{push, pop, free} test with a ht_divchn_t "
 	 "hash table on noncontiguous uint_ptr_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -448,12 +565,17 @@ void run_push_pop_free_divchn_uint_ptr_test(size_t log_ins,
     push_pop_free(n,
 		  C_PTY_SIZES[i],
 		  sizeof(uint_ptr_t *),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint_ptr,
 		  C_NEW_PTY_ARR[i],
 		  new_uint_ptr,
-		  free_uint_ptr);
+		  free_uint_ptr,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -467,18 +589,15 @@ void run_update_search_divchn_uint_ptr_test(size_t log_ins,
   int i;
   size_t n;
   ht_divchn_t ht_divchn;
-  ht_divchn_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
   hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht.init = ht_divchn_init_helper;
+  hht.align = ht_divchn_align_helper;
+  hht.insert = ht_divchn_insert_helper;
+  hht.search = ht_divchn_search_helper;
+  hht.remove = ht_divchn_remove_helper;
+  hht.free = ht_divchn_free_helper;
   printf("Run a heap_{update, search} test with a ht_divchn_t "
 	 "hash table on noncontiguous uint_ptr_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -490,12 +609,17 @@ void run_update_search_divchn_uint_ptr_test(size_t log_ins,
     update_search(n,
 		  C_PTY_SIZES[i],
 		  sizeof(uint_ptr_t *),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint_ptr,
 		  C_NEW_PTY_ARR[i],
 		  new_uint_ptr,
-		  free_uint_ptr);
+		  free_uint_ptr,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -509,19 +633,15 @@ void run_push_pop_free_muloa_uint_ptr_test(size_t log_ins,
   int i;
   size_t n;
   ht_muloa_t ht_muloa;
-  ht_muloa_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
-  context.rdc_key = NULL;
   hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht.init = ht_muloa_init_helper;
+  hht.align = ht_muloa_align_helper;
+  hht.insert = ht_muloa_insert_helper;
+  hht.search = ht_muloa_search_helper;
+  hht.remove = ht_muloa_remove_helper;
+  hht.free = ht_muloa_free_helper;
   printf("Run a heap_{push, pop, free} test with a ht_muloa_t "
 	 "hash table on noncontiguous uint_ptr_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -534,12 +654,17 @@ void run_push_pop_free_muloa_uint_ptr_test(size_t log_ins,
     push_pop_free(n,
 		  C_PTY_SIZES[i],
 		  sizeof(uint_ptr_t *),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint_ptr,
 		  C_NEW_PTY_ARR[i],
 		  new_uint_ptr,
-		  free_uint_ptr);
+		  free_uint_ptr,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
@@ -553,18 +678,15 @@ void run_update_search_muloa_uint_ptr_test(size_t log_ins,
   int i;
   size_t n;
   ht_muloa_t ht_muloa;
-  ht_muloa_context_t context;
   heap_ht_t hht;
   n = pow_two_perror(log_ins);
-  context.alpha_n = alpha_n;
-  context.log_alpha_d = log_alpha_d;
   hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht.init = ht_muloa_init_helper;
+  hht.align = ht_muloa_align_helper;
+  hht.insert = ht_muloa_insert_helper;
+  hht.search = ht_muloa_search_helper;
+  hht.remove = ht_muloa_remove_helper;
+  hht.free = ht_muloa_free_helper;
   printf("Run a heap_{update, search} test with a ht_muloa_t "
 	 "hash table on noncontiguous uint_ptr_t elements\n");
   for (i = 0; i < C_PTY_TYPES_COUNT; i++){
@@ -577,15 +699,157 @@ void run_update_search_muloa_uint_ptr_test(size_t log_ins,
     update_search(n,
 		  C_PTY_SIZES[i],
 		  sizeof(uint_ptr_t *),
+		  alpha_n,
+		  log_alpha_d,
+		  1,
 		  &hht,
 		  C_CMP_PTY_ARR[i],
 		  cmp_uint_ptr,
 		  C_NEW_PTY_ARR[i],
 		  new_uint_ptr,
-		  free_uint_ptr);
+		  free_uint_ptr,
+		  0,
+		  HEAP_PTY_GEN);
   }
 }
 
+/**
+   Runs heap_topk_{init, offer, offer_n} tests on random size_t priorities
+   and size_t elements across numbers of kept elements and heap layouts,
+   and compares the popped priorities to the k maximal priorities of a
+   sorted copy. The time of heap_push_n and k pops of a heap with an index
+   array and reversed priorities is printed as a baseline. A
+   heap_replace_top test is run on a heap with an index array.
+*/
+void run_topk_uint_test(size_t log_ins){
+  int res = 1;
+  size_t i, j, k, kk, n;
+  size_t num_acc, num_acc_n, pty, elt, top_pty, top_elt;
+  size_t *ptys = NULL, *elts = NULL, *sorted = NULL;
+  void *top_ptr = NULL;
+  clock_t t_offer, t_offer_n, t_base;
+  heap_t h;
+  n = pow_two_perror(log_ins);
+  ptys = malloc_perror(n, sizeof(size_t));
+  elts = malloc_perror(2 * n, sizeof(size_t));
+  sorted = malloc_perror(n, sizeof(size_t));
+  for (i = 0; i < n; i++){
+    ptys[i] = (size_t)RANDOM() * ((size_t)RAND_MAX + 1) + RANDOM();
+    sorted[i] = ptys[i];
+  }
+  for (i = 0; i < 2 * n; i++){
+    elts[i] = i;
+  }
+  qsort(sorted, n, sizeof(size_t), cmp_uint);
+  printf("Run heap_topk_{init, offer, offer_n} tests on random size_t "
+	 "priorities and size_t elements\n");
+  printf("\tnumber of offers: %lu\n", TOLU(n));
+  for (k = 0; k < C_TOPK_KS_COUNT; k++){
+    kk = (C_TOPK_KS[k] < n) ? C_TOPK_KS[k] : n;
+    printf("\t\tk: %lu\n", TOLU(C_TOPK_KS[k]));
+    for (j = 0; j < C_TOPK_MODES_COUNT; j++){
+      heap_topk_init(&h,
+		     sizeof(size_t),
+		     sizeof(size_t),
+		     C_TOPK_KS[k],
+		     cmp_uint,
+		     NULL);
+      if (j > 0) heap_arity(&h, j + 1, C_CHN_ALIGNMENT);
+      if (j > 1) heap_soa(&h, HEAP_PTY_SZ);
+      num_acc = 0;
+      t_offer = clock();
+      for (i = 0; i < n; i++){
+	num_acc += heap_topk_offer(&h, &ptys[i], &elts[i]);
+      }
+      t_offer = clock() - t_offer;
+      res *= (h.num_elts == kk && h.count == C_TOPK_KS[k]);
+      for (i = 0; i < kk; i++){
+	heap_pop(&h, &pty, &elt);
+	res *= (pty == sorted[n - kk + i] && ptys[elt] == pty);
+      }
+      res *= (h.num_elts == 0);
+      /* offer in two calls, the first call not filling a large heap */
+      t_offer_n = clock();
+      num_acc_n = heap_topk_offer_n(&h, ptys, elts, n / 3);
+      num_acc_n += heap_topk_offer_n(&h,
+				     &ptys[n / 3],
+				     &elts[n / 3],
+				     n - n / 3);
+      t_offer_n = clock() - t_offer_n;
+      res *= (num_acc == num_acc_n && h.num_elts == kk);
+      for (i = 0; i < kk; i++){
+	heap_pop(&h, &pty, &elt);
+	res *= (pty == sorted[n - kk + i] && ptys[elt] == pty);
+      }
+      heap_free(&h);
+      printf("\t\t\t%s\n"
+	     "\t\t\t\toffer time:                 %.4f seconds\n"
+	     "\t\t\t\toffer_n time:               %.4f seconds\n",
+	     C_TOPK_MODES[j],
+	     (double)t_offer / CLOCKS_PER_SEC,
+	     (double)t_offer_n / CLOCKS_PER_SEC);
+    }
+    heap_init(&h,
+	      sizeof(size_t),
+	      sizeof(size_t),
+	      n,
+	      0,
+	      0,
+	      NULL,
+	      cmp_uint_rev,
+	      NULL,
+	      NULL,
+	      NULL);
+    t_base = clock();
+    heap_push_n(&h, ptys, elts, n);
+    for (i = 0; i < kk; i++){
+      heap_pop(&h, &pty, &elt);
+    }
+    t_base = clock() - t_base;
+    res *= (pty == sorted[n - kk]);
+    heap_free(&h);
+    printf("\t\t\tindex array push_n and k pops time: %.4f seconds\n",
+	   (double)t_base / CLOCKS_PER_SEC);
+  }
+  /* heap_replace_top with an index array */
+  heap_init(&h,
+	    sizeof(size_t),
+	    sizeof(size_t),
+	    2 * n,
+	    0,
+	    0,
+	    NULL,
+	    cmp_uint,
+	    NULL,
+	    NULL,
+	    NULL);
+  for (i = 0; i < n; i++){
+    heap_push(&h, &elts[i], &elts[i]);
+  }
+  for (i = 0; i < n; i++){
+    heap_replace_top(&h, &elts[n + i], &elts[n + i], &top_pty, &top_elt);
+    top_ptr = heap_search(&h, &elts[n + i]);
+    res *= (top_pty == i && top_elt == i && h.num_elts == n);
+    res *= (heap_search(&h, &elts[i]) == NULL &&
+	    top_ptr != NULL &&
+	    *(size_t *)top_ptr == n + i);
+  }
+  for (i = 0; i < n; i++){
+    heap_pop(&h, &pty, &elt);
+    res *= (pty == n + i && elt == n + i);
+  }
+  heap_free(&h);
+  printf("\t\torder correctness:                           ");
+  print_test_result(res);
+  free(ptys);
+  free(elts);
+  free(sorted);
+  ptys = NULL;
+  elts = NULL;
+  sorted = NULL;
+  top_ptr = NULL;
+}
+
 /** 
    Helper functions for heap_{push, pop, free} tests.
 */
@@ -603,14 +867,14 @@ void push_ptys_elts(heap_t *h,
   p_end = ptr(pty_elts, half_count, h->pair_size);
   t_first = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_push(h, p, p + h->pty_size);
+    heap_push(h, p, p + h->elt_offset);
   }
   t_first = clock() - t_first;
   p_start = ptr(pty_elts, half_count, h->pair_size);
   p_end = ptr(pty_elts, count, h->pair_size);
   t_second = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_push(h, p, p + h->pty_size);
+    heap_push(h, p, p + h->elt_offset);
   }
   t_second = clock() - t_second;
   printf("\t\tpush 1/2 elements:                           "
@@ -634,14 +898,14 @@ void push_rev_ptys_elts(heap_t *h,
   p_end = ptr(pty_elts, half_count, h->pair_size);
   t_first = clock();
   for (p = p_start; p != p_end; p -= h->pair_size){
-    heap_push(h, p, p + h->pty_size);
+    heap_push(h, p, p + h->elt_offset);
   }
   t_first = clock() - t_first;
   p_start = ptr(pty_elts, half_count, h->pair_size);
   p_end = pty_elts;
   t_second = clock();
   for (p = p_start; p >= p_end; p -= h->pair_size){
-    heap_push(h, p, p + h->pty_size);
+    heap_push(h, p, p + h->elt_offset);
   }
   t_second = clock() - t_second;
   printf("\t\tpush 1/2 elements, rev. pty order:           "
@@ -651,6 +915,50 @@ void push_rev_ptys_elts(heap_t *h,
   *res *= (h->num_elts == n + count);
 }
 
+/**
+   Pushes the pairs of a pty_elts array in the reverse order with two
+   heap_push_n calls, the first on 3/4 of the pairs and the second on the
+   residual pairs, using separate arrays of priorities and elements.
+*/
+void push_n_rev_ptys_elts(heap_t *h,
+			  const void *pty_elts,
+			  size_t count,
+			  int *res){
+  size_t i, first_count;
+  size_t n = h->num_elts;
+  void *ptys = NULL, *elts = NULL;
+  clock_t t_first, t_second;
+  first_count = count - (count >> 2); /* count > 0 */
+  ptys = malloc_perror(count, h->pty_size);
+  elts = malloc_perror(count, h->elt_size);
+  for (i = 0; i < count; i++){
+    memcpy(ptr(ptys, i, h->pty_size),
+	   ptr(pty_elts, count - 1 - i, h->pair_size),
+	   h->pty_size);
+    memcpy(ptr(elts, i, h->elt_size),
+	   (char *)ptr(pty_elts, count - 1 - i, h->pair_size) + h->elt_offset,
+	   h->elt_size);
+  }
+  t_first = clock();
+  heap_push_n(h, ptys, elts, first_count);
+  t_first = clock() - t_first;
+  t_second = clock();
+  heap_push_n(h,
+	      ptr(ptys, first_count, h->pty_size),
+	      ptr(elts, first_count, h->elt_size),
+	      count - first_count);
+  t_second = clock() - t_second;
+  printf("\t\tpush_n 3/4 elements, rev. pty order:         "
+	 "%.4f seconds\n", (float)t_first / CLOCKS_PER_SEC);
+  printf("\t\tpush_n residual elements, rev. pty order:    "
+	 "%.4f seconds\n", (float)t_second / CLOCKS_PER_SEC);
+  *res *= (h->num_elts == n + count);
+  free(ptys);
+  free(elts);
+  ptys = NULL;
+  elts = NULL;
+}
+
 void pop_ptys_elts(heap_t *h,
 		   const void *pty_elts,
 		   size_t count,
@@ -668,29 +976,29 @@ void pop_ptys_elts(heap_t *h,
   p_end = ptr(pop_pty_elts, half_count, h->pair_size);
   t_first = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_pop(h, p, p + h->pty_size);
+    heap_pop(h, p, p + h->elt_offset);
   }
   t_first = clock() - t_first;
   p_start = ptr(pop_pty_elts, half_count, h->pair_size);
   p_end = ptr(pop_pty_elts, count, h->pair_size);
   t_second = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_pop(h, p, p + h->pty_size);
+    heap_pop(h, p, p + h->elt_offset);
   }
   t_second = clock() - t_second;
   *res *= (h->num_elts == n - count);
   for (i = 0; i < count; i++){
     if (i == 0){
       *res *=
-	(cmp_elt((char *)ptr(pop_pty_elts, i, h->pair_size) + h->pty_size,
-		 (char *)ptr(pty_elts, i, h->pair_size) + h->pty_size) == 0);
+	(cmp_elt((char *)ptr(pop_pty_elts, i, h->pair_size) + h->elt_offset,
+		 (char *)ptr(pty_elts, i, h->pair_size) + h->elt_offset) == 0);
     }else{
       *res *=
 	(cmp_pty(ptr(pop_pty_elts, i, h->pair_size),
 		 ptr(pop_pty_elts, i - 1, h->pair_size)) >= 0);
       *res *=
-	(cmp_elt((char *)ptr(pop_pty_elts, i, h->pair_size) + h->pty_size,
-		 (char *)ptr(pty_elts, i, h->pair_size) + h->pty_size) == 0);
+	(cmp_elt((char *)ptr(pop_pty_elts, i, h->pair_size) + h->elt_offset,
+		 (char *)ptr(pty_elts, i, h->pair_size) + h->elt_offset) == 0);
     }
   }
   printf("\t\tpop 1/2 elements:                            "
@@ -726,7 +1034,7 @@ void update_ptys_elts(heap_t *h,
   p_end = ptr(pty_elts, half_count, h->pair_size);
   t_first = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_update(h, p, p + h->pty_size);
+    heap_update(h, p, p + h->elt_offset);
   }
   t_first = clock() - t_first;
   *res *= (h->num_elts == n);
@@ -734,7 +1042,7 @@ void update_ptys_elts(heap_t *h,
   p_end = ptr(pty_elts, count, h->pair_size);
   t_second = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    heap_update(h, p, p + h->pty_size);
+    heap_update(h, p, p + h->elt_offset);
   }
   t_second = clock() - t_second;
   printf("\t\tupdate 1/2 elements:                         "
@@ -744,6 +1052,29 @@ void update_ptys_elts(heap_t *h,
   *res *= (h->num_elts == n);
 }
 
+/**
+   Resets a heap and tests that the elements of a pty_elts array are not
+   in the heap.
+*/
+void reset_ptys_elts(heap_t *h,
+		     const void *pty_elts,
+		     size_t count,
+		     int *res){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  clock_t t;
+  t = clock();
+  heap_reset(h);
+  t = clock() - t;
+  *res *= (h->num_elts == 0);
+  p_start = pty_elts;
+  p_end = ptr(pty_elts, count, h->pair_size);
+  for (p = p_start; p != p_end; p += h->pair_size){
+    *res *= (heap_search(h, p + h->elt_offset) == NULL);
+  }
+  printf("\t\treset:                                       "
+	 "%.4f seconds\n", (float)t / CLOCKS_PER_SEC);
+}
+
 void search_ptys_elts(const heap_t *h,
 		      const void *pty_elts,
 		      const void *not_heap_elts,
@@ -757,11 +1088,11 @@ void search_ptys_elts(const heap_t *h,
   p_end = ptr(pty_elts, count, h->pair_size);
   t_heap = clock();
   for (p = p_start; p != p_end; p += h->pair_size){
-    rp = heap_search(h, p + h->pty_size);
+    rp = heap_search(h, p + h->elt_offset);
   }
   t_heap = clock() - t_heap;
   for (p = p_start; p != p_end; p += h->pair_size){
-    rp = heap_search(h, p + h->pty_size);
+    rp = heap_search(h, p + h->elt_offset);
     *res *= (rp != NULL);
   }
   *res *= (h->num_elts == n);
@@ -790,29 +1121,58 @@ void search_ptys_elts(const heap_t *h,
 void push_pop_free(size_t num_ins,
 		   size_t pty_size,
 		   size_t elt_size,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t log_arity,
 		   const heap_ht_t *hht,
 		   int (*cmp_pty)(const void *, const void *),
 		   int (*cmp_elt)(const void *, const void *),
 		   void (*new_pty)(void *, size_t),
 		   void (*new_elt)(void *, size_t),
-		   void (*free_elt)(void *)){
+		   void (*free_elt)(void *),
+		   int is_soa,
+		   int pty_type){
   int res = 1;
   size_t i;
-  size_t pair_size = add_sz_perror(pty_size, elt_size);
+  size_t pair_size, elt_offset;
   void *pty_elts = NULL;
   heap_t h;
+  /* an index array covers the elements in and not in a heap */
+  heap_init(&h,
+	    pty_size,
+	    elt_size,
+	    (hht == NULL) ? 2 * num_ins : 0,
+	    alpha_n,
+	    log_alpha_d,
+	    hht,
+	    cmp_pty,
+	    NULL,
+	    NULL,
+	    free_elt);
+  if (log_arity > 1) heap_arity(&h, log_arity, C_CHN_ALIGNMENT);
+  if (is_soa) heap_soa(&h, pty_type);
+  pair_size = h.pair_size;
+  elt_offset = h.elt_offset;
   /* num_ins > 0 */
   pty_elts = malloc_perror(num_ins, pair_size);
   for (i = 0; i < num_ins; i++){
     new_pty(ptr(pty_elts, i, pair_size), i); /* no decrease with i */
-    new_elt((char *)ptr(pty_elts, i, pair_size) + pty_size, i);
+    new_elt((char *)ptr(pty_elts, i, pair_size) + elt_offset, i);
   }
-  heap_init(&h, C_H_INIT_COUNT, pty_size, elt_size, hht, cmp_pty, free_elt);
   push_ptys_elts(&h, pty_elts, num_ins, &res);
   pop_ptys_elts(&h, pty_elts, num_ins, cmp_pty, cmp_elt, &res);
   push_rev_ptys_elts(&h, pty_elts, num_ins, &res);
   pop_ptys_elts(&h, pty_elts, num_ins, cmp_pty, cmp_elt, &res);
+  push_n_rev_ptys_elts(&h, pty_elts, num_ins, &res);
+  pop_ptys_elts(&h, pty_elts, num_ins, cmp_pty, cmp_elt, &res);
   push_ptys_elts(&h, pty_elts, num_ins, &res);
+  if (free_elt == NULL){
+    /* elements remain valid after a reset and are pushed again */
+    reset_ptys_elts(&h, pty_elts, num_ins, &res);
+    push_rev_ptys_elts(&h, pty_elts, num_ins, &res);
+    pop_ptys_elts(&h, pty_elts, num_ins, cmp_pty, cmp_elt, &res);
+    push_ptys_elts(&h, pty_elts, num_ins, &res);
+  }
   free_heap(&h);
   printf("\t\torder correctness:                           ");
   print_test_result(res);
@@ -823,33 +1183,53 @@ void push_pop_free(size_t num_ins,
 void update_search(size_t num_ins,
 		   size_t pty_size,
 		   size_t elt_size,
+		   size_t alpha_n,
+		   size_t log_alpha_d,
+		   size_t log_arity,
 		   const heap_ht_t *hht,
 		   int (*cmp_pty)(const void *, const void *),
 		   int (*cmp_elt)(const void *, const void *),
 		   void (*new_pty)(void *, size_t),
 		   void (*new_elt)(void *, size_t),
-		   void (*free_elt)(void *)){
+		   void (*free_elt)(void *),
+		   int is_soa,
+		   int pty_type){
   int res = 1;
   size_t i;
-  size_t pair_size = add_sz_perror(pty_size, elt_size);
+  size_t pair_size, elt_offset;
   void *pty_elts = NULL, *pty_rev_elts = NULL, *not_heap_elts = NULL;
   heap_t h;
+  /* an index array covers the elements in and not in a heap */
+  heap_init(&h,
+	    pty_size,
+	    elt_size,
+	    (hht == NULL) ? 2 * num_ins : 0,
+	    alpha_n,
+	    log_alpha_d,
+	    hht,
+	    cmp_pty,
+	    NULL,
+	    NULL,
+	    free_elt);
+  if (log_arity > 1) heap_arity(&h, log_arity, C_CHN_ALIGNMENT);
+  if (is_soa) heap_soa(&h, pty_type);
+  pair_size = h.pair_size;
+  elt_offset = h.elt_offset;
   /* num_ins > 0 */
   pty_elts = malloc_perror(num_ins, pair_size);
   pty_rev_elts = malloc_perror(num_ins, pair_size);
   not_heap_elts = malloc_perror(num_ins, elt_size);
   for (i = 0; i < num_ins; i++){
     new_pty(ptr(pty_elts, i, pair_size), i);  /* no decrease with i */
-    new_elt((char *)ptr(pty_elts, i, pair_size) + pty_size, i);
+    new_elt((char *)ptr(pty_elts, i, pair_size) + elt_offset, i);
     new_elt(ptr(not_heap_elts, i, elt_size), num_ins + i);
   }
   for (i = 0; i < num_ins; i++){
     new_pty(ptr(pty_rev_elts, i, pair_size), i);  /* no decrease with i */
-    memcpy((char *)ptr(pty_rev_elts, i, pair_size) + pty_size,
-	   (char *)ptr(pty_elts, num_ins - 1 - i, pair_size) + pty_size,
+    memcpy((char *)ptr(pty_rev_elts, i, pair_size) + elt_offset,
+	   (char *)ptr(pty_elts, num_ins - 1 - i, pair_size) + elt_offset,
 	   elt_size);
   }
-  heap_init(&h, C_H_INIT_COUNT, pty_size, elt_size, hht, cmp_pty, free_elt);
   push_ptys_elts(&h, pty_rev_elts, num_ins, &res);
   update_ptys_elts(&h, pty_elts, num_ins, &res);
   search_ptys_elts(&h, pty_elts, not_heap_elts, num_ins, &res);
@@ -859,7 +1239,7 @@ void update_search(size_t num_ins,
   print_test_result(res);
   if (free_elt != NULL){
     for (i = 0; i < num_ins; i++){
-      free_elt((char *)ptr(pty_elts, i, pair_size) + pty_size);
+      free_elt((char *)ptr(pty_elts, i, pair_size) + elt_offset);
       free_elt(ptr(not_heap_elts, i, elt_size));
     }
   }
@@ -893,7 +1273,7 @@ int main(int argc, char *argv[]){
   int i;
   size_t *args = NULL;
   if (argc > C_ARGC_MAX){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
@@ -910,8 +1290,12 @@ int main(int argc, char *argv[]){
       args[5] > 1 ||
       args[6] > 1 ||
       args[7] > 1 ||
-      args[8] > 1){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+      args[8] > 1 ||
+      args[9] > 1 ||
+      args[10] > 1 ||
+      args[11] > 1 ||
+      args[12] > 1){
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   if (args[5]){
@@ -930,6 +1314,12 @@ int main(int argc, char *argv[]){
     run_update_search_muloa_uint_test(args[0], args[3], args[4]);
     run_update_search_muloa_uint_ptr_test(args[0], args[3], args[4]);
   }
+  for (i = 0; i < C_LOG_ARITIES_COUNT; i++){
+    if (args[9]) run_push_pop_free_ix_uint_test(args[0], C_LOG_ARITIES[i]);
+    if (args[10]) run_update_search_ix_uint_test(args[0], C_LOG_ARITIES[i]);
+    if (args[11]) run_soa_ix_uint_test(args[0], C_LOG_ARITIES[i]);
+  }
+  if (args[12]) run_topk_uint_test(args[0]);
   free(args);
   args = NULL;
   return 0;
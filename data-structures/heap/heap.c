@@ -12,7 +12,11 @@
    search and modifications, and enables the optimization of space and
    time resources associated with heap operations by choice of a hash
    table, its load factor upper bound, and known or expected minimum
-   number of simultaneously present elements.
+   number of simultaneously present elements. If elements are size_t
+   values in [0, n), such as the vertices of a graph, NULL can be passed
+   as the hash table parameter with n as min_num, and an index array with
+   a count that is equal to n maps an element to its index in the heap
+   without hashing and without calls through a function pointer.
 
    The implementation assumes that for every element in a heap, the 
    block of size elt_size pointed to by an argument passed as the elt
@@ -21,6 +25,29 @@
    associating a given element in memory with more than one priority
    value in a heap.
 
+   A heap is binary by default. heap_arity sets a d-ary heap for d = 2^k,
+   k > 0, where the children of the ith node are at indices d * i + 1 to
+   d * i + d, and optionally offsets the array of pairs within its
+   allocated block, so that the children of each node begin at a multiple
+   of an alignment value (e.g. a cache line) in memory. A pair address is
+   converted to size_t only to compute the offset; the correctness of heap
+   operations does not depend on the result of the conversion.
+
+   With heap_soa, the priorities and elements are stored in two parallel
+   arrays, and the pair layout is only used in the internal buffer of a
+   heap. If the priority type is int, unsigned int, unsigned long, size_t,
+   or double, the comparisons are performed on typed values, and in the
+   structure-of-arrays layout the minimal priority among the children of a
+   node in a heapify loop is found by a scan of adjacent priority values.
+
+   A bounded heap has the count k set by heap_topk_init, and does not map
+   elements to indices. A priority offered to a full bounded heap is
+   compared to the priority of the root, and if it is greater, the element
+   of the root is replaced and heapified downwards in a single pass instead
+   of a pop followed by a push. heap_topk_offer_n compares the priorities
+   in its input array to the threshold in a loop that does not access the
+   heap, with typed comparisons if pty_type was set with heap_soa.
+
    Optimization:
 
    -  the pointer computations in pty_ptr and elt_ptr were optimized out
@@ -35,27 +62,83 @@
 #include "heap.h"
 #include "utilities-mem.h"
 
+static const size_t C_H_INIT_COUNT = 1;
+static const size_t C_IX_NONE = (size_t)-1; /* element not in index array */
+
+static void pty_elts_realloc(heap_t *h, size_t count);
+static void copy_pair(heap_t *h, size_t t, size_t s);
+static void load_pair(heap_t *h, void *buf, size_t i);
+static void store_pair(heap_t *h, size_t i, const void *buf);
+static int cmp(const heap_t *h, const void *a, const void *b);
+static size_t min_child(const heap_t *h, size_t jc, size_t jend);
+static size_t min_child_int(const heap_t *h, size_t jc, size_t jend);
+static size_t min_child_uint(const heap_t *h, size_t jc, size_t jend);
+static size_t min_child_ulong(const heap_t *h, size_t jc, size_t jend);
+static size_t min_child_sz(const heap_t *h, size_t jc, size_t jend);
+static size_t min_child_double(const heap_t *h, size_t jc, size_t jend);
+static void ix_insert(heap_t *h, const void *elt, size_t i);
 static void swap(heap_t *h, size_t i, size_t j);
 static void half_swap(heap_t *h, size_t t, size_t s);
 static void heapify_up(heap_t *h, size_t i);
 static void heapify_down(heap_t *h, size_t i);
+static void heapify_down_bin(heap_t *h, size_t i);
+static void heapify_down_dary(heap_t *h, size_t i);
+static void sift_down_build(heap_t *h, size_t i);
+static void replace_root(heap_t *h, const void *pty, const void *elt);
+static size_t next_above(const heap_t *h,
+			 const void *ptys,
+			 size_t i,
+			 size_t n);
+static size_t next_above_int(const heap_t *h,
+			     const void *ptys,
+			     size_t i,
+			     size_t n);
+static size_t next_above_uint(const heap_t *h,
+			      const void *ptys,
+			      size_t i,
+			      size_t n);
+static size_t next_above_ulong(const heap_t *h,
+			       const void *ptys,
+			       size_t i,
+			       size_t n);
+static size_t next_above_sz(const heap_t *h,
+			    const void *ptys,
+			    size_t i,
+			    size_t n);
+static size_t next_above_double(const heap_t *h,
+				const void *ptys,
+				size_t i,
+				size_t n);
 static void *pty_ptr(const heap_t *h, size_t i);
 static void *elt_ptr(const heap_t *h, size_t i);
+static void fprintf_stderr_exit(const char *s, int line);
 
 /**
    Initializes a heap.
    h           : pointer to a preallocated block of size sizeof(heap_t)
-   init_count  : > 0
    pty_size    : size of a contiguous priority object
    elt_size    : - size of an element, if the element is within a contiguous
                  memory block and a copy of the element is inserted,
                  - size of a pointer to an element, if the element is within
                  a noncontiguous memory block or a pointer to a contiguous
                  element is inserted
-   hht         : a non-NULL pointer to a set of parameters specifying a
+   min_num     : minimum number of elements that are known or expected to
+                 become present simultaneously in a heap, resulting in a
+                 speedup by avoiding unnecessary growth steps of the heap
+                 and its hash table; 0 if a positive value is not specified
+   alpha_n     : > 0 numerator of a load factor upper bound of the hash table
+   log_alpha_d : < CHAR_BIT * sizeof(size_t) log base 2 of the denominator
+                 of the load factor upper bound; denominator is a power of
+                 two
+   hht         : - a non-NULL pointer to a set of parameters specifying a
                  hash table for in-heap search and modifications; a hash
                  key has the size and bit pattern of the block of size
                  elt_size pointed to by elt in heap_push
+                 - NULL, if an element is a size_t value in [0, min_num)
+                 and elt_size is sizeof(size_t); an index array with a
+                 count that is equal to min_num is used for in-heap search
+                 and modifications, and alpha_n, log_alpha_d, cmp_elt, and
+                 rdc_elt are not used
    cmp_pty     : comparison function which returns a negative integer value
                  if the priority value pointed to by the first argument is
                  less than the priority value pointed to by the second, a
@@ -63,10 +146,18 @@ static void *elt_ptr(const heap_t *h, size_t i);
                  the first argument is greater than the priority value 
                  pointed to by the second, and zero integer value if the two
                  priority values are equal
-   cmp_elt     : 
-   rdc_elt     : both have to work on the same subset of bits in the element,
-                 whether the element is within a contiguous or non-contiguous
-                 memory block
+   cmp_elt     : - if NULL then a default memcmp-based comparison of
+                 elt_size blocks is performed by the hash table
+                 - otherwise comparison function is applied which returns a
+                 zero integer value iff the two elt_size blocks accessed
+                 through the first and the second arguments are equal
+   rdc_elt     : - if NULL then a default conversion of a bit pattern in an
+                 elt_size block is performed by the hash table prior to
+                 hashing
+                 - otherwise rdc_elt is applied to an elt_size block prior to
+                 hashing; cmp_elt and rdc_elt have to work on the same
+                 subset of bits in the block, whether the element is within
+                 a contiguous or noncontiguous memory block
    free_elt    : - if an element is within a contiguous memory block and
                  a copy of the element was inserted, then NULL as free_elt
                  is sufficient to delete the element,
@@ -80,16 +171,17 @@ void heap_init(heap_t *h,
 	       size_t pty_size,
 	       size_t elt_size,
 	       size_t min_num,
-	       size_t alpha_n;
-	       size_t log_alpha_d;
+	       size_t alpha_n,
+	       size_t log_alpha_d,
 	       const heap_ht_t *hht,
 	       int (*cmp_pty)(const void *, const void *),
 	       int (*cmp_elt)(const void *, const void *),
 	       size_t (*rdc_elt)(const void *, size_t),
 	       void (*free_elt)(void *)){
+  size_t elt_rem, pty_rem;
   h->pty_size = pty_size;
   h->elt_size = elt_size;
-  /* align priority relative to a malloc's pointer and compute pair_size */
+  /* align elt relative to a malloc's pointer and compute pair_size */
   if (h->pty_size <= h->elt_size){
     h->elt_offset = h->elt_size;
   }else{
@@ -100,37 +192,110 @@ void heap_init(heap_t *h,
   pty_rem = add_sz_perror(h->elt_offset, h->elt_size) % h->pty_size;
   h->pair_size = add_sz_perror(h->elt_offset + h->elt_size,
 			       (pty_rem > 0) * (h->pty_size - pty_rem));
-  h->count = min_num;
+  h->count = (min_num > 0) ? min_num : C_H_INIT_COUNT;
   h->num_elts = 0;
+  h->alpha_n = alpha_n;
+  h->log_alpha_d = log_alpha_d;
+  h->log_arity = 1;
+  h->chn_alignment = 0;
   h->buf = malloc_perror(2, h->pair_size); /* 1st heapify, 2nd swap */
-  h->pty_elts = malloc_perror(h->count, h->pair_size);
+  h->pty_elts_blk = NULL;
+  h->pty_elts = NULL;
+  h->elts = NULL;
+  h->pty_step = h->pair_size;
+  h->elt_step = h->pair_size;
+  h->is_soa = 0;
+  h->pty_type = HEAP_PTY_GEN;
+  h->is_bounded = 0;
+  pty_elts_realloc(h, h->count);
+  h->ixs = NULL;
+  h->ixs_count = 0;
   h->hht = hht;
   h->cmp_pty = cmp_pty;
   h->cmp_elt = cmp_elt;
   h->rdc_elt = rdc_elt;
   h->free_elt = free_elt;
+  if (h->hht == NULL){
+    /* index array maps a size_t element to an index */
+    h->ixs = malloc_perror((min_num > 0) ? min_num : 1, sizeof(size_t));
+    h->ixs_count = min_num;
+    memset(h->ixs, 0xff, min_num * sizeof(size_t)); /* C_IX_NONE */
+    return;
+  }
   /* hash table maps an elt_size block to an index */ 
-  h->hht->init(hht->ht,
-	       elt_size,
+  h->hht->init(h->hht->ht,
+	       h->elt_size,
 	       sizeof(size_t),
-	       h->count,
-	       alpha_n,
-	       log_alpha_d,
+	       min_num,
+	       h->alpha_n,
+	       h->log_alpha_d,
 	       h->cmp_elt,
 	       h->rdc_elt,
 	       NULL);
+  h->hht->align(h->hht->ht, sizeof(size_t));
+}
+
+/**
+   Initializes a bounded heap that keeps at most k elements with maximal
+   priorities according to cmp_pty, without a hash table and without an
+   index array. The root of a full bounded heap holds the minimal priority
+   among the kept priorities, which is the threshold of heap_topk_offer and
+   heap_topk_offer_n. The optional heap_align, heap_arity, and heap_soa
+   operations can be called after heap_topk_init as after heap_init.
+   The heap_push, heap_push_n, heap_pop, heap_replace_top, heap_reset, and
+   heap_free operations can be called on a bounded heap; a push to a full
+   bounded heap exits with an error message. heap_search returns NULL, and
+   heap_update is not called on a bounded heap.
+   h           : pointer to a preallocated block of size sizeof(heap_t)
+   pty_size    : size of a contiguous priority object
+   elt_size    : size of an element or a pointer to an element, as in
+                 heap_init; elements are not hashed and their bit patterns
+                 are not required to be unique
+   k           : > 0 maximal number of elements in the heap
+   cmp_pty     : comparison function of priorities as in heap_init; to
+                 keep k elements with minimal priorities, the sign of its
+                 result is reversed
+   free_elt    : NULL or an element-specific free_elt as in heap_init,
+                 that deletes an element replaced by heap_topk_offer or
+                 heap_topk_offer_n
+*/
+void heap_topk_init(heap_t *h,
+		    size_t pty_size,
+		    size_t elt_size,
+		    size_t k,
+		    int (*cmp_pty)(const void *, const void *),
+		    void (*free_elt)(void *)){
+  if (k == 0) fprintf_stderr_exit("k is 0", __LINE__);
+  heap_init(h, pty_size, elt_size, 1, 1, 0, NULL, cmp_pty, NULL, NULL,
+	    free_elt);
+  free(h->ixs);
+  h->ixs = NULL;
+  h->ixs_count = 0;
+  h->is_bounded = 1;
+  h->count = k;
+  pty_elts_realloc(h, h->count);
 }
 
 /**
+   Aligns the priorities and elements of a heap and the indices in the
+   hash table of the heap according to the values of the alignment
+   parameters. If the alignment requirement of only one type is known,
+   then the size of the other type can be used as a value of the other
+   alignment parameter because size of type >= alignment requirement of
+   type (due to structure of arrays), which may result in overalignment.
+   The operation is optionally called after heap_init is completed and
+   before any other heap_ operation is called.
+   h             : pointer to an initialized heap_t struct
+   pty_alignment : alignment requirement or size of the type of a priority
+   elt_alignment : alignment requirement or size of the type of an element
+   sz_alignment  : alignment requirement or size of size_t
 */
 void heap_align(heap_t *h,
 		size_t pty_alignment,
 		size_t elt_alignment,
 		size_t sz_alignment){
   size_t elt_rem, pty_rem;
-  if (h->elt_size == 0){
-    h->elt_offset = h->pty_size;
-  }else if (h->pty_size <= elt_alignment){
+  if (h->pty_size <= elt_alignment){
     h->elt_offset = elt_alignment;
   }else{
     elt_rem = h->pty_size % elt_alignment;
@@ -141,16 +306,81 @@ void heap_align(heap_t *h,
   h->pair_size = add_sz_perror(h->elt_offset + h->elt_size,
 			       (pty_rem > 0) * (pty_alignment - pty_rem));
   h->buf = realloc_perror(h->buf, 2, h->pair_size);
-  memset(a->buf, 0, 2 * a->pair_size);
-  h->pty_elts = realloc_perror(h->pty_elts, init_count, h->pair_size);
-  h->hht->align(hht->ht, sz_alignment);
+  memset(h->buf, 0, 2 * h->pair_size);
+  if (!h->is_soa){
+    h->pty_step = h->pair_size;
+    h->elt_step = h->pair_size;
+  }
+  pty_elts_realloc(h, h->count);
+  if (h->hht != NULL) h->hht->align(h->hht->ht, sz_alignment);
+}
+
+/**
+   Sets the arity of a heap to a power of two and optionally aligns the
+   block of the children of each node in memory. A heap is binary by
+   default. With an arity of 4 or 8, a pop touches fewer levels and, if
+   the children of a node fit in a cache line, fewer cache lines per
+   level. The operation is optionally called after heap_init and the
+   optional heap_align are completed and before any other heap_ operation
+   is called.
+   h             : pointer to an initialized heap_t struct
+   log_arity     : > 0 log base 2 of the number of children of a node,
+                   e.g. 2 for a 4-ary heap
+   chn_alignment : - 0 if the children of a node are not aligned
+                   - otherwise a power of two (e.g. 64 for cache lines);
+                   the first child of each node begins at a multiple of
+                   chn_alignment in memory if the product of the arity
+                   and pair_size is a multiple of chn_alignment
+*/
+void heap_arity(heap_t *h, size_t log_arity, size_t chn_alignment){
+  h->log_arity = log_arity;
+  h->chn_alignment = chn_alignment;
+  pty_elts_realloc(h, h->count);
+}
+
+/**
+   Sets the structure-of-arrays layout of a heap, with priorities in a
+   contiguous array and elements in a parallel array, and the type of
+   priorities for specialized comparisons. The operation is optionally
+   called after heap_init and the optional heap_align and heap_arity are
+   completed and before any other heap_ operation is called. If
+   chn_alignment was set, the priorities of the children of each node
+   begin at a multiple of chn_alignment in memory if the product of the
+   arity and pty_size is a multiple of chn_alignment.
+   h           : pointer to an initialized heap_t struct
+   pty_type    : - HEAP_PTY_INT, HEAP_PTY_UINT, HEAP_PTY_ULONG,
+                 HEAP_PTY_SZ, or HEAP_PTY_DOUBLE if the priority type is
+                 int, unsigned int, unsigned long, size_t, or double
+                 respectively and pty_size is the size of the type; the
+                 priorities are compared with the < and > operators,
+                 which is equivalent to a cmp_pty that returns the sign of
+                 a difference, and cmp_pty is not used
+                 - HEAP_PTY_GEN if the priorities are compared with cmp_pty
+*/
+void heap_soa(heap_t *h, int pty_type){
+  if ((pty_type == HEAP_PTY_INT && h->pty_size != sizeof(int)) ||
+      (pty_type == HEAP_PTY_UINT && h->pty_size != sizeof(unsigned int)) ||
+      (pty_type == HEAP_PTY_ULONG &&
+       h->pty_size != sizeof(unsigned long int)) ||
+      (pty_type == HEAP_PTY_SZ && h->pty_size != sizeof(size_t)) ||
+      (pty_type == HEAP_PTY_DOUBLE && h->pty_size != sizeof(double))){
+    fprintf_stderr_exit("pty_size is not the size of pty_type", __LINE__);
+  }
+  h->pty_type = pty_type;
+  if (h->is_soa) return;
+  h->is_soa = 1;
+  h->pty_step = h->pty_size;
+  h->elt_step = h->elt_size;
+  h->elts = NULL; /* pointed into the block of pairs */
+  pty_elts_realloc(h, h->count);
 }
 
 /**
    Pushes an element not in a heap and an associated priority value. 
    Prior to pushing, the membership of an element can be tested, if 
    necessary, with heap_search in O(1) time in expectation under the
-   uniformity assumptions suitable for the used hash table.
+   uniformity assumptions suitable for the used hash table, or in O(1)
+   time with an index array.
    h           : pointer to an initialized heap
    pty         : pointer to a block of size pty_size that is an object of
                  basic type (e.g. char, int, long, double)
@@ -162,28 +392,93 @@ void heap_align(heap_t *h,
 void heap_push(heap_t *h, const void *pty, const void *elt){
   size_t ix = h->num_elts;
   if (h->count == ix){
+    if (h->is_bounded){
+      fprintf_stderr_exit("push to a full bounded heap", __LINE__);
+    }
     /* grow heap; amortized constant overhead per push, 
        without considering realloc's search */
-    h->count *= mul_sz_perror(2, h->count);
-    h->pty_elts = realloc_perror(h->pty_elts, h->count, h->pair_size);
+    h->count = mul_sz_perror(2, h->count);
+    pty_elts_realloc(h, h->count);
   }
   memcpy(pty_ptr(h, ix), pty, h->pty_size);
   memcpy(elt_ptr(h, ix), elt, h->elt_size);
-  h->hht->insert(h->hht->ht, elt, &ix);
+  ix_insert(h, elt, ix);
   h->num_elts++;
   heapify_up(h, ix);
 }
 
+/**
+   Pushes n elements not in a heap and their associated priority values.
+   If n is not less than the number of elements in the heap, the pairs are
+   appended and the whole heap is heapified bottom-up in O(n + number of
+   elements in the heap) time, followed by a single pass mapping each
+   element to its index. Otherwise each appended pair is heapified upwards
+   as in heap_push. Please see the parameter specification in heap_push.
+   h           : pointer to an initialized heap
+   ptys        : pointer to an array of n priorities, each of size pty_size
+   elts        : pointer to an array of n elements, each of size elt_size,
+                 with a unique bit pattern for each pushed element
+   n           : number of elements in the ptys and elts arrays
+*/
+void heap_push_n(heap_t *h, const void *ptys, const void *elts, size_t n){
+  size_t i, num = h->num_elts;
+  size_t new_num = add_sz_perror(h->num_elts, n);
+  const char *pty = ptys, *elt = elts;
+  if (n == 0) return;
+  if (h->count < new_num){
+    if (h->is_bounded){
+      fprintf_stderr_exit("push to a full bounded heap", __LINE__);
+    }
+    h->count = (h->count > new_num - h->count) ?
+      mul_sz_perror(2, h->count) : new_num;
+    pty_elts_realloc(h, h->count);
+  }
+  for (i = num; i < new_num; i++){
+    memcpy(pty_ptr(h, i), pty, h->pty_size);
+    memcpy(elt_ptr(h, i), elt, h->elt_size);
+    pty += h->pty_size;
+    elt += h->elt_size;
+  }
+  h->num_elts = new_num;
+  if (n < num){
+    for (i = num; i < new_num; i++){
+      ix_insert(h, elt_ptr(h, i), i);
+      heapify_up(h, i);
+    }
+    return;
+  }
+  /* bottom-up from the last node with a child, without index updates */
+  if (new_num >= 2){
+    i = ((new_num - 2) >> h->log_arity) + 1;
+    while (i > 0){
+      i--;
+      sift_down_build(h, i);
+    }
+  }
+  for (i = 0; i < new_num; i++){
+    ix_insert(h, elt_ptr(h, i), i);
+  }
+}
+
 /** 
    Returns a pointer to the priority of an element in a heap or NULL if the
    element is not in the heap in O(1) time in expectation under the
-   uniformity assumptions suitable for the used hash table. The returned
+   uniformity assumptions suitable for the used hash table, or in O(1)
+   time with an index array. With an index array, NULL is also returned
+   for an element that is not less than min_num. The returned
    pointer is guaranteed to point to the current priority value until another
    heap operation is performed. Please see the parameter specification in
    heap_push.
 */
 void *heap_search(const heap_t *h, const void *elt){
-  const size_t *ix_ptr = h->hht->search(h->hht->ht, elt);
+  size_t k;
+  const size_t *ix_ptr = NULL;
+  if (h->hht == NULL){
+    k = *(const size_t *)elt;
+    if (k >= h->ixs_count || h->ixs[k] == C_IX_NONE) return NULL;
+    return pty_ptr(h, h->ixs[k]);
+  }
+  ix_ptr = h->hht->search(h->hht->ht, elt);
   if (ix_ptr != NULL){
     return pty_ptr(h, *ix_ptr);
   }else{
@@ -199,7 +494,12 @@ void *heap_search(const heap_t *h, const void *elt){
    specification in heap_push.
 */
 void heap_update(heap_t *h, const void *pty, const void *elt){
-  size_t ix = *(const size_t *)h->hht->search(h->hht->ht, elt);
+  size_t ix;
+  if (h->hht == NULL){
+    ix = h->ixs[*(const size_t *)elt];
+  }else{
+    ix = *(const size_t *)h->hht->search(h->hht->ht, elt);
+  }
   memcpy(pty_ptr(h, ix), pty, h->pty_size);
   heapify_up(h, ix);
   heapify_down(h, ix);
@@ -207,9 +507,9 @@ void heap_update(heap_t *h, const void *pty, const void *elt){
 
 /**
    Pops an element associated with a minimal priority value in a heap 
-   according to cmp_pty. If the heap is empty, the memory blocks pointed 
-   to by elt and pty remain unchanged. Please see the parameter
-   specification in heap_push.
+   according to cmp_pty or the specialized comparison of pty_type. If the
+   heap is empty, the memory blocks pointed to by elt and pty remain
+   unchanged. Please see the parameter specification in heap_push.
 */
 void heap_pop(heap_t *h, void *pty, void *elt){
   size_t ix_buf, ix = 0;
@@ -217,11 +517,123 @@ void heap_pop(heap_t *h, void *pty, void *elt){
   memcpy(pty, pty_ptr(h, ix), h->pty_size);
   memcpy(elt, elt_ptr(h, ix), h->elt_size);
   swap(h, ix, h->num_elts - 1);
-  h->hht->remove(h->hht->ht, elt, &ix_buf);
+  if (h->hht != NULL){
+    h->hht->remove(h->hht->ht, elt, &ix_buf);
+  }else if (!h->is_bounded){
+    h->ixs[*(const size_t *)elt] = C_IX_NONE;
+  }
   h->num_elts--;
   if (h->num_elts > 0) heapify_down(h, ix);
 }
 
+/**
+   Pops an element associated with a minimal priority value in a non-empty
+   heap and pushes an element not in the heap with an associated priority
+   value with a single downward heapify pass, which is faster than
+   heap_pop followed by heap_push. The popped priority and element are
+   copied to the blocks pointed to by top_pty and top_elt, which do not
+   overlap the blocks pointed to by pty and elt. If the heap is empty, the
+   element is pushed and the blocks pointed to by top_pty and top_elt
+   remain unchanged. Please see the parameter specification in heap_push.
+*/
+void heap_replace_top(heap_t *h,
+		      const void *pty,
+		      const void *elt,
+		      void *top_pty,
+		      void *top_elt){
+  size_t ix_buf;
+  if (h->num_elts == 0){
+    heap_push(h, pty, elt);
+    return;
+  }
+  memcpy(top_pty, pty_ptr(h, 0), h->pty_size);
+  memcpy(top_elt, elt_ptr(h, 0), h->elt_size);
+  if (h->hht != NULL){
+    h->hht->remove(h->hht->ht, top_elt, &ix_buf);
+  }else if (!h->is_bounded){
+    h->ixs[*(const size_t *)top_elt] = C_IX_NONE;
+  }
+  memcpy(pty_ptr(h, 0), pty, h->pty_size);
+  memcpy(elt_ptr(h, 0), elt, h->elt_size);
+  heapify_down(h, 0);
+}
+
+/**
+   Offers an element and an associated priority value to a bounded heap.
+   If the heap is not full, the element is pushed. Otherwise, if the
+   priority is greater than the priority of the root, the element of the
+   root is deleted according to free_elt and replaced by the offered
+   element, and if not, the heap remains unchanged. Returns 1 if the
+   element was copied into the heap, and 0 otherwise, in which case the
+   offered element is not deleted. Runs in O(1) time if the element is
+   not copied into the heap, and in O(log k) time otherwise.
+   h           : pointer to a heap initialized with heap_topk_init
+   pty         : pointer to a block of size pty_size
+   elt         : pointer to a block of size elt_size
+*/
+int heap_topk_offer(heap_t *h, const void *pty, const void *elt){
+  if (h->num_elts < h->count){
+    heap_push(h, pty, elt);
+    return 1;
+  }
+  if (cmp(h, pty, pty_ptr(h, 0)) <= 0) return 0;
+  replace_root(h, pty, elt);
+  return 1;
+}
+
+/**
+   Offers n elements and their associated priority values to a bounded
+   heap, with the result of n calls to heap_topk_offer in the order of the
+   arrays. The pairs that fit into a heap that is not full are pushed as
+   in heap_push_n. The remaining priorities are compared to the threshold
+   in the root in a scan of the ptys array that does not access the heap
+   until a priority is greater than the threshold; if pty_type was set with
+   heap_soa, the scan compares typed values without calls through cmp_pty.
+   Returns the number of elements that were copied into the heap.
+   h           : pointer to a heap initialized with heap_topk_init
+   ptys        : pointer to an array of n priorities, each of size pty_size
+   elts        : pointer to an array of n elements, each of size elt_size
+   n           : number of elements in the ptys and elts arrays
+*/
+size_t heap_topk_offer_n(heap_t *h,
+			 const void *ptys,
+			 const void *elts,
+			 size_t n){
+  size_t i, num_ins;
+  const char *pty = ptys, *elt = elts;
+  num_ins = (h->count - h->num_elts < n) ? h->count - h->num_elts : n;
+  heap_push_n(h, ptys, elts, num_ins);
+  i = num_ins;
+  while (i < n){
+    i = next_above(h, ptys, i, n);
+    if (i == n) break;
+    replace_root(h, pty + i * h->pty_size, elt + i * h->elt_size);
+    num_ins++;
+    i++;
+  }
+  return num_ins;
+}
+
+/**
+   Deletes all elements and their priority values from a heap according
+   to free_elt, keeping the allocated arrays of the heap and the grown
+   slots of its hash table or its index array, so that the heap can be
+   reused, e.g. across runs of an algorithm on the same graph, without
+   reallocation. Runs in O(number of elements in the heap) time.
+*/
+void heap_reset(heap_t *h){
+  size_t i, ix_buf;
+  for (i = 0; i < h->num_elts; i++){
+    if (h->hht != NULL){
+      h->hht->remove(h->hht->ht, elt_ptr(h, i), &ix_buf);
+    }else if (!h->is_bounded){
+      h->ixs[*(const size_t *)elt_ptr(h, i)] = C_IX_NONE;
+    }
+    if (h->free_elt != NULL) h->free_elt(elt_ptr(h, i));
+  }
+  h->num_elts = 0;
+}
+
 /**
    Frees a heap and leaves a block of size sizeof(heap_t) pointed to by
    an argument passed as the h parameter.
@@ -233,37 +645,127 @@ void heap_free(heap_t *h){
       h->free_elt(elt_ptr(h, i));
     } 
   }
-  free(h->pty_elts);
+  free_large(h->pty_elts_blk);
+  if (h->is_soa) free_large(h->elts);
   free(h->buf);
-  h->hht->free(h->hht->ht);
+  free(h->ixs); /* free(NULL) performs no operation */
+  if (h->hht != NULL) h->hht->free(h->hht->ht);
+  h->pty_elts_blk = NULL;
   h->pty_elts = NULL;
+  h->elts = NULL;
   h->buf = NULL;
+  h->ixs = NULL;
 }
 
 /** Helper functions */
 
+/**
+   Reallocates the block containing the array of pairs of a heap to hold
+   count pairs, and places the array within the block so that the pair at
+   index 1, the first child of the root, begins at a multiple of
+   chn_alignment in memory, if chn_alignment is not 0. In the
+   structure-of-arrays layout, the block contains the array of priorities
+   that is placed in the same way, and the parallel array of elements is
+   reallocated to hold count elements.
+*/
+static void pty_elts_realloc(heap_t *h, size_t count){
+  size_t old_shift = 0, new_shift = 0, rem;
+  size_t align = h->chn_alignment;
+  if (h->pty_elts_blk != NULL){
+    old_shift = (char *)h->pty_elts - (char *)h->pty_elts_blk;
+  }
+  h->pty_elts_blk =
+    realloc_large_perror(h->pty_elts_blk,
+			 add_sz_perror(mul_sz_perror(count, h->pty_step),
+				       align),
+			 1);
+  if (align > 0){
+    rem = ((size_t)h->pty_elts_blk + h->pty_step) & (align - 1);
+    new_shift = (align - rem) & (align - 1);
+  }
+  if (old_shift != new_shift){
+    memmove((char *)h->pty_elts_blk + new_shift,
+	    (char *)h->pty_elts_blk + old_shift,
+	    h->num_elts * h->pty_step);
+  }
+  h->pty_elts = (char *)h->pty_elts_blk + new_shift;
+  if (h->is_soa){
+    h->elts = realloc_large_perror(h->elts, count, h->elt_size);
+  }else{
+    h->elts = (char *)h->pty_elts + h->elt_offset;
+  }
+}
+
+/**
+   Copies the priority and element at index s to index t.
+*/
+static void copy_pair(heap_t *h, size_t t, size_t s){
+  if (h->is_soa){
+    memcpy(pty_ptr(h, t), pty_ptr(h, s), h->pty_size);
+    memcpy(elt_ptr(h, t), elt_ptr(h, s), h->elt_size);
+  }else{
+    memcpy(pty_ptr(h, t), pty_ptr(h, s), h->pair_size);
+  }
+}
+
+/**
+   Copies the priority and element at index i to a pair in buf.
+*/
+static void load_pair(heap_t *h, void *buf, size_t i){
+  if (h->is_soa){
+    memcpy(buf, pty_ptr(h, i), h->pty_size);
+    memcpy((char *)buf + h->elt_offset, elt_ptr(h, i), h->elt_size);
+  }else{
+    memcpy(buf, pty_ptr(h, i), h->pair_size);
+  }
+}
+
+/**
+   Copies a pair in buf to the priority and element at index i.
+*/
+static void store_pair(heap_t *h, size_t i, const void *buf){
+  if (h->is_soa){
+    memcpy(pty_ptr(h, i), buf, h->pty_size);
+    memcpy(elt_ptr(h, i), (const char *)buf + h->elt_offset, h->elt_size);
+  }else{
+    memcpy(pty_ptr(h, i), buf, h->pair_size);
+  }
+}
+
+/**
+   Maps an element to the index i in the index array or the hash table of
+   a heap that is not bounded.
+*/
+static void ix_insert(heap_t *h, const void *elt, size_t i){
+  if (h->hht != NULL){
+    h->hht->insert(h->hht->ht, elt, &i);
+  }else if (!h->is_bounded){
+    h->ixs[*(const size_t *)elt] = i;
+  }
+}
+
 /**
    Swaps priorities and elements at indices i and j and maps the elements
-   to their new indices in the hash table.
+   to their new indices.
 */
 static void swap(heap_t *h, size_t i, size_t j){
   void *buf = (char *)h->buf + h->pair_size; /* second subbuffer */
   if (i == j) return;
-  memcpy(buf, pty_ptr(h, i), h->pair_size);
-  memcpy(pty_ptr(h, i), pty_ptr(h, j), h->pair_size);
-  memcpy(pty_ptr(h, j), buf, h->pair_size);
-  h->hht->insert(h->hht->ht, elt_ptr(h, i), &i);
-  h->hht->insert(h->hht->ht, elt_ptr(h, j), &j);
+  load_pair(h, buf, i);
+  copy_pair(h, i, j);
+  store_pair(h, j, buf);
+  ix_insert(h, elt_ptr(h, i), i);
+  ix_insert(h, elt_ptr(h, j), j);
 }
 
 /**
    Copies the priority and element at index s to index t, and maps the
-   copied element at index t to t in the hash table.
+   copied element at index t to t.
 */
 static void half_swap(heap_t *h, size_t t, size_t s){
   if (s == t) return;
-  memcpy(pty_ptr(h, t), pty_ptr(h, s), h->pair_size);
-  h->hht->insert(h->hht->ht, elt_ptr(h, t), &t);
+  copy_pair(h, t, s);
+  ix_insert(h, elt_ptr(h, t), t);
 }
 
 /**
@@ -271,18 +773,18 @@ static void half_swap(heap_t *h, size_t t, size_t s){
 */
 static void heapify_up(heap_t *h, size_t i){
   size_t ju;
-  memcpy(h->buf, pty_ptr(h, i), h->pair_size);
+  load_pair(h, h->buf, i);
   while(i > 0){
-    ju = (i - 1) >> 1; /* divide by 2 */;
-    if (h->cmp_pty(pty_ptr(h, ju), h->buf) > 0){
+    ju = (i - 1) >> h->log_arity; /* divide by arity */
+    if (cmp(h, pty_ptr(h, ju), h->buf) > 0){
       half_swap(h, i, ju);
       i = ju;
     }else{
       break;
     }
   }
-  memcpy(pty_ptr(h, i), h->buf, h->pair_size);
-  h->hht->insert(h->hht->ht, elt_ptr(h, i), &i);
+  store_pair(h, i, h->buf);
+  ix_insert(h, elt_ptr(h, i), i);
 }
 
 /**
@@ -290,18 +792,30 @@ static void heapify_up(heap_t *h, size_t i){
    element downwards.
 */
 static void heapify_down(heap_t *h, size_t i){
+  if (h->log_arity == 1){
+    heapify_down_bin(h, i);
+  }else{
+    heapify_down_dary(h, i);
+  }
+}
+
+/**
+   Heapifies a binary heap with at least one element from the ith element
+   downwards.
+*/
+static void heapify_down_bin(heap_t *h, size_t i){
   size_t jl, jr;
-  memcpy(h->buf, pty_ptr(h, i), h->pair_size);
+  load_pair(h, h->buf, i);
   /* 0 <= i <= num_elts - 1 <= SIZE_MAX - 2 */
   while (i + 2 <= h->num_elts - 1 - i){
     /* both next left and next right indices have elements */
     jl = 2 * i + 1;
     jr = 2 * i + 2;
-    if (h->cmp_pty(h->buf, pty_ptr(h, jl)) > 0 &&
-	h->cmp_pty(pty_ptr(h, jl), pty_ptr(h, jr)) <= 0){
+    if (cmp(h, h->buf, pty_ptr(h, jl)) > 0 &&
+	cmp(h, pty_ptr(h, jl), pty_ptr(h, jr)) <= 0){
       half_swap(h, i, jl);
       i = jl;
-    }else if (h->cmp_pty(h->buf, pty_ptr(h, jr)) > 0){
+    }else if (cmp(h, h->buf, pty_ptr(h, jr)) > 0){
       /* jr has min pty relative to jl and the ith pty is greater */
       half_swap(h, i, jr);
       i = jr;
@@ -311,25 +825,294 @@ static void heapify_down(heap_t *h, size_t i){
   }
   if (i + 1 == h->num_elts - 1 - i){
     jl = 2 * i + 1;
-    if (h->cmp_pty(h->buf, pty_ptr(h, jl)) > 0){
+    if (cmp(h, h->buf, pty_ptr(h, jl)) > 0){
       half_swap(h, i, jl);
       i = jl;
     }
   }
-  memcpy(pty_ptr(h, i), h->buf, h->pair_size);
-  h->hht->insert(h->hht->ht, elt_ptr(h, i), &i);
+  store_pair(h, i, h->buf);
+  ix_insert(h, elt_ptr(h, i), i);
+}
+
+/**
+   Heapifies a d-ary heap with at least one element from the ith element
+   downwards. The element at index i is moved down to the child with a
+   minimal priority among at most d children at each level.
+*/
+static void heapify_down_dary(heap_t *h, size_t i){
+  size_t jc, jm, jend;
+  size_t n = h->num_elts;
+  size_t arity = (size_t)1 << h->log_arity;
+  load_pair(h, h->buf, i);
+  /* 0 <= i <= n - 1 <= SIZE_MAX - 2; i has a child iff i <= (n - 2) / d */
+  while (n >= 2 && i <= ((n - 2) >> h->log_arity)){
+    jc = (i << h->log_arity) + 1;
+    jend = (n - jc > arity) ? jc + arity : n;
+    jm = min_child(h, jc, jend);
+    if (cmp(h, h->buf, pty_ptr(h, jm)) > 0){
+      half_swap(h, i, jm);
+      i = jm;
+    }else{
+      break;
+    }
+  }
+  store_pair(h, i, h->buf);
+  ix_insert(h, elt_ptr(h, i), i);
+}
+
+/**
+   Heapifies the heap structure from the ith element downwards without
+   mapping the moved elements to their indices. Used by heap_push_n before
+   all elements are mapped in a single pass.
+*/
+static void sift_down_build(heap_t *h, size_t i){
+  size_t jc, jm, jend;
+  size_t n = h->num_elts;
+  size_t arity = (size_t)1 << h->log_arity;
+  load_pair(h, h->buf, i);
+  while (i <= ((n - 2) >> h->log_arity)){
+    jc = (i << h->log_arity) + 1;
+    jend = (n - jc > arity) ? jc + arity : n;
+    jm = min_child(h, jc, jend);
+    if (cmp(h, h->buf, pty_ptr(h, jm)) > 0){
+      copy_pair(h, i, jm);
+      i = jm;
+    }else{
+      break;
+    }
+  }
+  store_pair(h, i, h->buf);
+}
+
+/**
+   Deletes the element at the root of a non-empty bounded heap according
+   to free_elt, and replaces the root with a priority and an element that
+   are heapified downwards.
+*/
+static void replace_root(heap_t *h, const void *pty, const void *elt){
+  if (h->free_elt != NULL) h->free_elt(elt_ptr(h, 0));
+  memcpy(pty_ptr(h, 0), pty, h->pty_size);
+  memcpy(elt_ptr(h, 0), elt, h->elt_size);
+  heapify_down(h, 0);
 }
 
 /**
-   Computes a pointer to an element in the element-priority array of a heap.
+   Returns the least index j in [i, n) such that the jth priority in the
+   ptys array is greater than the priority at the root of a non-empty heap,
+   or n if there is no such index. Typed values are compared if pty_type
+   is specialized.
+*/
+static size_t next_above(const heap_t *h,
+			 const void *ptys,
+			 size_t i,
+			 size_t n){
+  const char *pty = ptys;
+  const void *root = pty_ptr(h, 0);
+  switch (h->pty_type){
+  case HEAP_PTY_INT:
+    return next_above_int(h, ptys, i, n);
+  case HEAP_PTY_UINT:
+    return next_above_uint(h, ptys, i, n);
+  case HEAP_PTY_ULONG:
+    return next_above_ulong(h, ptys, i, n);
+  case HEAP_PTY_SZ:
+    return next_above_sz(h, ptys, i, n);
+  case HEAP_PTY_DOUBLE:
+    return next_above_double(h, ptys, i, n);
+  }
+  while (i < n && h->cmp_pty(pty + i * h->pty_size, root) <= 0) i++;
+  return i;
+}
+
+static size_t next_above_int(const heap_t *h,
+			     const void *ptys,
+			     size_t i,
+			     size_t n){
+  const int *p = ptys;
+  int t = *(const int *)h->pty_elts;
+  while (i < n && p[i] <= t) i++;
+  return i;
+}
+
+static size_t next_above_uint(const heap_t *h,
+			      const void *ptys,
+			      size_t i,
+			      size_t n){
+  const unsigned int *p = ptys;
+  unsigned int t = *(const unsigned int *)h->pty_elts;
+  while (i < n && p[i] <= t) i++;
+  return i;
+}
+
+static size_t next_above_ulong(const heap_t *h,
+			       const void *ptys,
+			       size_t i,
+			       size_t n){
+  const unsigned long int *p = ptys;
+  unsigned long int t = *(const unsigned long int *)h->pty_elts;
+  while (i < n && p[i] <= t) i++;
+  return i;
+}
+
+static size_t next_above_sz(const heap_t *h,
+			    const void *ptys,
+			    size_t i,
+			    size_t n){
+  const size_t *p = ptys;
+  size_t t = *(const size_t *)h->pty_elts;
+  while (i < n && p[i] <= t) i++;
+  return i;
+}
+
+static size_t next_above_double(const heap_t *h,
+				const void *ptys,
+				size_t i,
+				size_t n){
+  const double *p = ptys;
+  double t = *(const double *)h->pty_elts;
+  while (i < n && p[i] <= t) i++;
+  return i;
+}
+
+/**
+   Compares two priorities according to the pty_type of a heap, or with
+   cmp_pty if pty_type is HEAP_PTY_GEN.
+*/
+static int cmp(const heap_t *h, const void *a, const void *b){
+  switch (h->pty_type){
+  case HEAP_PTY_INT:
+    return (*(const int *)a > *(const int *)b) -
+      (*(const int *)a < *(const int *)b);
+  case HEAP_PTY_UINT:
+    return (*(const unsigned int *)a > *(const unsigned int *)b) -
+      (*(const unsigned int *)a < *(const unsigned int *)b);
+  case HEAP_PTY_ULONG:
+    return (*(const unsigned long int *)a > *(const unsigned long int *)b) -
+      (*(const unsigned long int *)a < *(const unsigned long int *)b);
+  case HEAP_PTY_SZ:
+    return (*(const size_t *)a > *(const size_t *)b) -
+      (*(const size_t *)a < *(const size_t *)b);
+  case HEAP_PTY_DOUBLE:
+    return (*(const double *)a > *(const double *)b) -
+      (*(const double *)a < *(const double *)b);
+  default:
+    return h->cmp_pty(a, b);
+  }
+}
+
+/**
+   Returns the index of a child with a minimal priority among the children
+   at the indices in [jc, jend), where jc < jend. In the structure-of-arrays
+   layout with a specialized pty_type, the adjacent priorities are scanned
+   as typed values.
+*/
+static size_t min_child(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  if (h->is_soa){
+    switch (h->pty_type){
+    case HEAP_PTY_INT:
+      return min_child_int(h, jc, jend);
+    case HEAP_PTY_UINT:
+      return min_child_uint(h, jc, jend);
+    case HEAP_PTY_ULONG:
+      return min_child_ulong(h, jc, jend);
+    case HEAP_PTY_SZ:
+      return min_child_sz(h, jc, jend);
+    case HEAP_PTY_DOUBLE:
+      return min_child_double(h, jc, jend);
+    }
+  }
+  for (j = jc + 1; j < jend; j++){
+    if (cmp(h, pty_ptr(h, j), pty_ptr(h, jm)) < 0) jm = j;
+  }
+  return jm;
+}
+
+static size_t min_child_int(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  const int *ptys = h->pty_elts;
+  int min = ptys[jc];
+  for (j = jc + 1; j < jend; j++){
+    if (ptys[j] < min){
+      min = ptys[j];
+      jm = j;
+    }
+  }
+  return jm;
+}
+
+static size_t min_child_uint(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  const unsigned int *ptys = h->pty_elts;
+  unsigned int min = ptys[jc];
+  for (j = jc + 1; j < jend; j++){
+    if (ptys[j] < min){
+      min = ptys[j];
+      jm = j;
+    }
+  }
+  return jm;
+}
+
+static size_t min_child_ulong(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  const unsigned long int *ptys = h->pty_elts;
+  unsigned long int min = ptys[jc];
+  for (j = jc + 1; j < jend; j++){
+    if (ptys[j] < min){
+      min = ptys[j];
+      jm = j;
+    }
+  }
+  return jm;
+}
+
+static size_t min_child_sz(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  const size_t *ptys = h->pty_elts;
+  size_t min = ptys[jc];
+  for (j = jc + 1; j < jend; j++){
+    if (ptys[j] < min){
+      min = ptys[j];
+      jm = j;
+    }
+  }
+  return jm;
+}
+
+static size_t min_child_double(const heap_t *h, size_t jc, size_t jend){
+  size_t j, jm = jc;
+  const double *ptys = h->pty_elts;
+  double min = ptys[jc];
+  for (j = jc + 1; j < jend; j++){
+    if (ptys[j] < min){
+      min = ptys[j];
+      jm = j;
+    }
+  }
+  return jm;
+}
+
+/**
+   Computes a pointer to a priority in the priority-element array or the
+   priority array of a heap.
 */
 static void *pty_ptr(const heap_t *h, size_t i){
-  return (void *)((char *)h->pty_elts + i * h->pair_size);
+  return (void *)((char *)h->pty_elts + i * h->pty_step);
 }
 
 /**
-   Computes a pointer to a priority in the element-priority array of a heap.
+   Computes a pointer to an element in the priority-element array or the
+   element array of a heap.
 */
 static void *elt_ptr(const heap_t *h, size_t i){
-  return (void *)((char *)h->pty_elts + i * h->pair_size + h->elt_offset);
+  return (void *)((char *)h->elts + i * h->elt_step);
+}
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
 }
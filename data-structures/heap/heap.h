@@ -12,7 +12,11 @@
    search and modifications, and enables the optimization of space and
    time resources associated with heap operations by choice of a hash
    table, its load factor upper bound, and known or expected minimum
-   number of simultaneously present elements.
+   number of simultaneously present elements. If elements are size_t
+   values in [0, n), such as the vertices of a graph, NULL can be passed
+   as the hash table parameter with n as min_num, and an index array with
+   a count that is equal to n maps an element to its index in the heap
+   without hashing and without calls through a function pointer.
 
    The implementation assumes that for every element in a heap, the 
    block of size elt_size pointed to by an argument passed as the elt
@@ -20,6 +24,25 @@
    represented by its unique pointer, this invariant only prevents
    associating a given element in memory with more than one priority
    value in a heap.
+
+   A heap stores priority-element pairs in a single array by default.
+   With heap_soa, the priorities are stored in a contiguous array and the
+   elements in a parallel array, so that a comparison in a heapify loop
+   does not load the bytes of elements, and the priorities of the children
+   of a node in a d-ary heap are adjacent in memory. If the priority type
+   is int, unsigned int, unsigned long, size_t, or double, the comparisons
+   can be specialized and performed without calls through the cmp_pty
+   function pointer.
+
+   A bounded heap initialized with heap_topk_init keeps at most k
+   elements with maximal priorities out of a stream of offered elements,
+   with a fixed count and without a hash table or an index array. Its
+   root holds the kth maximal priority among the offered elements, and is
+   the threshold that an offered priority is compared to before the heap
+   is accessed. heap_topk_offer_n scans an array of priorities against the
+   threshold and accesses the heap only for a priority that exceeds it, so
+   that a stream of n elements is ranked in O(n + m log k) time, where m is
+   the number of replacements of the root.
 */
 
 #ifndef HEAP_H  
@@ -27,8 +50,21 @@
 
 #include <stddef.h>
 
+/**
+   Priority types with specialized comparisons in heap_soa; with
+   HEAP_PTY_GEN the priorities are compared with cmp_pty.
+*/
+#define HEAP_PTY_GEN 0
+#define HEAP_PTY_INT 1
+#define HEAP_PTY_SZ 2
+#define HEAP_PTY_DOUBLE 3
+#define HEAP_PTY_UINT 4
+#define HEAP_PTY_ULONG 5
+
 typedef struct{
   void *ht; /* points to a preallocated hash table struct */
+  size_t alpha_n; /* load factor upper bound used by algorithms with a */
+  size_t log_alpha_d; /* heap_ht_t parameter to initialize a heap */
   
   /* pointers to hash table op helpers, pre-defined in each hash table */
   void (*init)(void *,
@@ -56,8 +92,19 @@ typedef struct{
   size_t num_elts;
   size_t alpha_n;
   size_t log_alpha_d;
+  size_t log_arity; /* log base 2 of the number of children of a node */
+  size_t chn_alignment; /* 0 or alignment of the first child of a node */
   void *buf; /* only used by heap operations internally */
-  void *pty_elts;
+  void *pty_elts_blk; /* allocated block containing pty_elts */
+  void *pty_elts; /* pairs, or priorities only in the SoA layout */
+  void *elts; /* elements in pty_elts, or a parallel array in SoA layout */
+  size_t pty_step; /* pair_size, or pty_size in the SoA layout */
+  size_t elt_step; /* pair_size, or elt_size in the SoA layout */
+  int is_soa;
+  int pty_type; /* HEAP_PTY_ type of priorities */
+  int is_bounded; /* fixed count; no hash table and no index array */
+  size_t *ixs; /* index array if hht is NULL, otherwise NULL */
+  size_t ixs_count;
   const heap_ht_t *hht;
   int (*cmp_pty)(const void *, const void *);
   int (*cmp_elt)(const void *, const void *);
@@ -68,17 +115,29 @@ typedef struct{
 /**
    Initializes a heap.
    h           : pointer to a preallocated block of size sizeof(heap_t)
-   init_count  : > 0
    pty_size    : size of a contiguous priority object
    elt_size    : - size of an element, if the element is within a contiguous
                  memory block and a copy of the element is inserted,
                  - size of a pointer to an element, if the element is within
                  a noncontiguous memory block or a pointer to a contiguous
                  element is inserted
-   hht         : a non-NULL pointer to a set of parameters specifying a
+   min_num     : minimum number of elements that are known or expected to
+                 become present simultaneously in a heap, resulting in a
+                 speedup by avoiding unnecessary growth steps of the heap
+                 and its hash table; 0 if a positive value is not specified
+   alpha_n     : > 0 numerator of a load factor upper bound of the hash table
+   log_alpha_d : < CHAR_BIT * sizeof(size_t) log base 2 of the denominator
+                 of the load factor upper bound; denominator is a power of
+                 two
+   hht         : - a non-NULL pointer to a set of parameters specifying a
                  hash table for in-heap search and modifications; a hash
                  key has the size and bit pattern of the block of size
                  elt_size pointed to by elt in heap_push
+                 - NULL, if an element is a size_t value in [0, min_num)
+                 and elt_size is sizeof(size_t); an index array with a
+                 count that is equal to min_num is used for in-heap search
+                 and modifications, and alpha_n, log_alpha_d, cmp_elt, and
+                 rdc_elt are not used
    cmp_pty     : comparison function which returns a negative integer value
                  if the priority value pointed to by the first argument is
                  less than the priority value pointed to by the second, a
@@ -86,6 +145,18 @@ typedef struct{
                  the first argument is greater than the priority value 
                  pointed to by the second, and zero integer value if the two
                  priority values are equal
+   cmp_elt     : - if NULL then a default memcmp-based comparison of
+                 elt_size blocks is performed by the hash table
+                 - otherwise comparison function is applied which returns a
+                 zero integer value iff the two elt_size blocks accessed
+                 through the first and the second arguments are equal
+   rdc_elt     : - if NULL then a default conversion of a bit pattern in an
+                 elt_size block is performed by the hash table prior to
+                 hashing
+                 - otherwise rdc_elt is applied to an elt_size block prior to
+                 hashing; cmp_elt and rdc_elt have to work on the same
+                 subset of bits in the block, whether the element is within
+                 a contiguous or noncontiguous memory block
    free_elt    : - if an element is within a contiguous memory block and
                  a copy of the element was inserted, then NULL as free_elt
                  is sufficient to delete the element,
@@ -99,8 +170,8 @@ void heap_init(heap_t *h,
 	       size_t pty_size,
 	       size_t elt_size,
 	       size_t min_num,
-	       size_t alpha_n;
-	       size_t log_alpha_d;
+	       size_t alpha_n,
+	       size_t log_alpha_d,
 	       const heap_ht_t *hht,
 	       int (*cmp_pty)(const void *, const void *),
 	       int (*cmp_elt)(const void *, const void *),
@@ -108,17 +179,101 @@ void heap_init(heap_t *h,
 	       void (*free_elt)(void *));
 
 /**
+   Initializes a bounded heap that keeps at most k elements with maximal
+   priorities according to cmp_pty, without a hash table and without an
+   index array. The root of a full bounded heap holds the minimal priority
+   among the kept priorities, which is the threshold of heap_topk_offer and
+   heap_topk_offer_n. The optional heap_align, heap_arity, and heap_soa
+   operations can be called after heap_topk_init as after heap_init.
+   The heap_push, heap_push_n, heap_pop, heap_replace_top, heap_reset, and
+   heap_free operations can be called on a bounded heap; a push to a full
+   bounded heap exits with an error message. heap_search returns NULL, and
+   heap_update is not called on a bounded heap.
+   h           : pointer to a preallocated block of size sizeof(heap_t)
+   pty_size    : size of a contiguous priority object
+   elt_size    : size of an element or a pointer to an element, as in
+                 heap_init; elements are not hashed and their bit patterns
+                 are not required to be unique
+   k           : > 0 maximal number of elements in the heap
+   cmp_pty     : comparison function of priorities as in heap_init; to
+                 keep k elements with minimal priorities, the sign of its
+                 result is reversed
+   free_elt    : NULL or an element-specific free_elt as in heap_init,
+                 that deletes an element replaced by heap_topk_offer or
+                 heap_topk_offer_n
+*/
+void heap_topk_init(heap_t *h,
+		    size_t pty_size,
+		    size_t elt_size,
+		    size_t k,
+		    int (*cmp_pty)(const void *, const void *),
+		    void (*free_elt)(void *));
+
+/**
+   Aligns the priorities and elements of a heap and the indices in the
+   hash table of the heap according to the values of the alignment
+   parameters. If the alignment requirement of only one type is known,
+   then the size of the other type can be used as a value of the other
+   alignment parameter because size of type >= alignment requirement of
+   type (due to structure of arrays), which may result in overalignment.
+   The operation is optionally called after heap_init is completed and
+   before any other heap_ operation is called.
+   h             : pointer to an initialized heap_t struct
+   pty_alignment : alignment requirement or size of the type of a priority
+   elt_alignment : alignment requirement or size of the type of an element
+   sz_alignment  : alignment requirement or size of size_t
 */
 void heap_align(heap_t *h,
 		size_t pty_alignment,
 		size_t elt_alignment,
 		size_t sz_alignment);
 
+/**
+   Sets the arity of a heap to a power of two and optionally aligns the
+   block of the children of each node in memory. A heap is binary by
+   default. With an arity of 4 or 8, a pop touches fewer levels and, if
+   the children of a node fit in a cache line, fewer cache lines per
+   level. The operation is optionally called after heap_init and the
+   optional heap_align are completed and before any other heap_ operation
+   is called.
+   h             : pointer to an initialized heap_t struct
+   log_arity     : > 0 log base 2 of the number of children of a node,
+                   e.g. 2 for a 4-ary heap
+   chn_alignment : - 0 if the children of a node are not aligned
+                   - otherwise a power of two (e.g. 64 for cache lines);
+                   the first child of each node begins at a multiple of
+                   chn_alignment in memory if the product of the arity
+                   and pair_size is a multiple of chn_alignment
+*/
+void heap_arity(heap_t *h, size_t log_arity, size_t chn_alignment);
+
+/**
+   Sets the structure-of-arrays layout of a heap, with priorities in a
+   contiguous array and elements in a parallel array, and the type of
+   priorities for specialized comparisons. The operation is optionally
+   called after heap_init and the optional heap_align and heap_arity are
+   completed and before any other heap_ operation is called. If
+   chn_alignment was set, the priorities of the children of each node
+   begin at a multiple of chn_alignment in memory if the product of the
+   arity and pty_size is a multiple of chn_alignment.
+   h           : pointer to an initialized heap_t struct
+   pty_type    : - HEAP_PTY_INT, HEAP_PTY_UINT, HEAP_PTY_ULONG,
+                 HEAP_PTY_SZ, or HEAP_PTY_DOUBLE if the priority type is
+                 int, unsigned int, unsigned long, size_t, or double
+                 respectively and pty_size is the size of the type; the
+                 priorities are compared with the < and > operators,
+                 which is equivalent to a cmp_pty that returns the sign of
+                 a difference, and cmp_pty is not used
+                 - HEAP_PTY_GEN if the priorities are compared with cmp_pty
+*/
+void heap_soa(heap_t *h, int pty_type);
+
 /**
    Pushes an element not in a heap and an associated priority value. 
    Prior to pushing, the membership of an element can be tested, if 
    necessary, with heap_search in O(1) time in expectation under the
-   uniformity assumptions suitable for the used hash table.
+   uniformity assumptions suitable for the used hash table, or in O(1)
+   time with an index array.
    h           : pointer to an initialized heap
    pty         : pointer to a block of size pty_size that is an object of
                  basic type (e.g. char, int, long, double)
@@ -129,10 +284,27 @@ void heap_align(heap_t *h,
 */
 void heap_push(heap_t *h, const void *pty, const void *elt);
 
+/**
+   Pushes n elements not in a heap and their associated priority values.
+   If n is not less than the number of elements in the heap, the pairs are
+   appended and the whole heap is heapified bottom-up in O(n + number of
+   elements in the heap) time, followed by a single pass mapping each
+   element to its index. Otherwise each appended pair is heapified upwards
+   as in heap_push. Please see the parameter specification in heap_push.
+   h           : pointer to an initialized heap
+   ptys        : pointer to an array of n priorities, each of size pty_size
+   elts        : pointer to an array of n elements, each of size elt_size,
+                 with a unique bit pattern for each pushed element
+   n           : number of elements in the ptys and elts arrays
+*/
+void heap_push_n(heap_t *h, const void *ptys, const void *elts, size_t n);
+
 /** 
    Returns a pointer to the priority of an element in a heap or NULL if the
    element is not in the heap in O(1) time in expectation under the
-   uniformity assumptions suitable for the used hash table. The returned
+   uniformity assumptions suitable for the used hash table, or in O(1)
+   time with an index array. With an index array, NULL is also returned
+   for an element that is not less than min_num. The returned
    pointer is guaranteed to point to the current priority value until another
    heap operation is performed. Please see the parameter specification in
    heap_push.
@@ -156,6 +328,65 @@ void heap_update(heap_t *h, const void *pty, const void *elt);
 */
 void heap_pop(heap_t *h, void *pty, void *elt);
 
+/**
+   Pops an element associated with a minimal priority value in a non-empty
+   heap and pushes an element not in the heap with an associated priority
+   value with a single downward heapify pass, which is faster than
+   heap_pop followed by heap_push. The popped priority and element are
+   copied to the blocks pointed to by top_pty and top_elt, which do not
+   overlap the blocks pointed to by pty and elt. If the heap is empty, the
+   element is pushed and the blocks pointed to by top_pty and top_elt
+   remain unchanged. Please see the parameter specification in heap_push.
+*/
+void heap_replace_top(heap_t *h,
+		      const void *pty,
+		      const void *elt,
+		      void *top_pty,
+		      void *top_elt);
+
+/**
+   Offers an element and an associated priority value to a bounded heap.
+   If the heap is not full, the element is pushed. Otherwise, if the
+   priority is greater than the priority of the root, the element of the
+   root is deleted according to free_elt and replaced by the offered
+   element, and if not, the heap remains unchanged. Returns 1 if the
+   element was copied into the heap, and 0 otherwise, in which case the
+   offered element is not deleted. Runs in O(1) time if the element is
+   not copied into the heap, and in O(log k) time otherwise.
+   h           : pointer to a heap initialized with heap_topk_init
+   pty         : pointer to a block of size pty_size
+   elt         : pointer to a block of size elt_size
+*/
+int heap_topk_offer(heap_t *h, const void *pty, const void *elt);
+
+/**
+   Offers n elements and their associated priority values to a bounded
+   heap, with the result of n calls to heap_topk_offer in the order of the
+   arrays. The pairs that fit into a heap that is not full are pushed as
+   in heap_push_n. The remaining priorities are compared to the threshold
+   in the root in a scan of the ptys array that does not access the heap
+   until a priority is greater than the threshold; if pty_type was set with
+   heap_soa, the scan compares typed values without calls through cmp_pty.
+   Returns the number of elements that were copied into the heap.
+   h           : pointer to a heap initialized with heap_topk_init
+   ptys        : pointer to an array of n priorities, each of size pty_size
+   elts        : pointer to an array of n elements, each of size elt_size
+   n           : number of elements in the ptys and elts arrays
+*/
+size_t heap_topk_offer_n(heap_t *h,
+			 const void *ptys,
+			 const void *elts,
+			 size_t n);
+
+/**
+   Deletes all elements and their priority values from a heap according
+   to free_elt, keeping the allocated arrays of the heap and the grown
+   slots of its hash table or its index array, so that the heap can be
+   reused, e.g. across runs of an algorithm on the same graph, without
+   reallocation. Runs in O(number of elements in the heap) time.
+*/
+void heap_reset(heap_t *h);
+
 /**
    Frees a heap and leaves a block of size sizeof(heap_t) pointed to by
    an argument passed as the h parameter.
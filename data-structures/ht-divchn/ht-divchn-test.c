@@ -19,12 +19,19 @@
       [0, 1] : on/off insert search uint_ptr test
       [0, 1] : on/off remove delete uint_ptr test
       [0, 1] : on/off corner cases test
+      [0, 1] : on/off incremental growth, pool, and rdc_key tests
+      [0, 1] : on/off stats test
+      [0, 1] : on/off chunked chain test
+      [0, 1] : on/off batch search test
+      [0, 1] : on/off interleaved search test
 
    usage examples:
    ./ht-divchn-test
    ./ht-divchn-test 20
    ./ht-divchn-test 17 5 6
    ./ht-divchn-test 19 0 2 3000 4000 11 10
+   ./ht-divchn-test 20 0 0 1024 1024 11 1 1 0 0 0 0 0 0 0 1
+   ./ht-divchn-test 20 0 0 1024 1024 11 1 1 0 0 0 0 0 0 0 0 1
 
    ht-divchn-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -67,14 +74,21 @@ const char *C_USAGE =
   "> 0 : c\n"
   "> 0 : d\n"
   "> 0 : e log base 2\n"
-  "> 0 : f s.t. c / 2**e <= alpha <= d / 2**e, in f steps\n"
-  "[0, 1] : on/off insert search uint test\n"
-  "[0, 1] : on/off remove delete uint test\n"
-  "[0, 1] : on/off insert search uint_ptr test\n"
-  "[0, 1] : on/off remove delete uint_ptr test\n"
-  "[0, 1] : on/off corner cases test\n";
-const int C_ARGC_MAX = 13;
-const size_t C_ARGS_DEF[12] = {14, 0, 2, 1024, 30720u, 11, 10, 1, 1, 1, 1, 1};
+  "> 0 : f s.t. c / 2**e <= alpha <= d / 2**e, in f steps\n";
+const char *C_USAGE_TESTS = /* each string literal within 509 characters */
+  "[0, 1] : insert search uint test\n"
+  "[0, 1] : remove delete uint test\n"
+  "[0, 1] : insert search uint_ptr test\n"
+  "[0, 1] : remove delete uint_ptr test\n"
+  "[0, 1] : corner cases test\n"
+  "[0, 1] : incr pool rdc test\n"
+  "[0, 1] : stats test\n"
+  "[0, 1] : chunk test\n"
+  "[0, 1] : batch search test\n"
+  "[0, 1] : interleaved search test\n";
+const int C_ARGC_MAX = 18;
+const size_t C_ARGS_DEF[17] = {14, 0, 2, 1024, 30720u, 11, 10, 1, 1, 1, 1, 1,
+			       1, 1, 1, 1, 1};
 const size_t C_SIZE_MAX = (size_t)-1;
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
@@ -84,6 +98,30 @@ const size_t C_CORNER_LOG_KEY_END = 8;
 const size_t C_CORNER_HT_COUNT = 1543;
 const size_t C_CORNER_ALPHA_N = 33;
 const size_t C_CORNER_LOG_ALPHA_D = 15; /* alpha is 33/32768 */
+const size_t C_MIN_NUM = 16384;
+const size_t C_MIN_NUM_ALPHA_N = 1;
+const size_t C_MIN_NUM_LOG_ALPHA_D = 1; /* alpha is 1/2 */
+
+/* incremental growth test */
+const size_t C_INCR_NUM_SLOTS = 4;
+
+/* rdc_key test */
+const size_t C_RDC_KEY_COUNT = 4; /* count of size_t words in a key */
+
+/* stats test */
+const size_t C_HIST_COUNT = 16;
+const size_t C_HT_COUNT_MIN = 1543; /* count after init with min_num 0 */
+
+/* batch search test */
+const size_t C_BATCH_NUM_MODES = 4;
+const char *C_BATCH_MODES[4] = {"list",
+				"list, pool",
+				"chunk",
+				"chunk, incremental"};
+
+/* interleaved search test */
+const size_t C_NUM_LKS_COUNT = 4;
+const size_t C_NUM_LKS[4] = {1, 4, 16, 64};
 
 void insert_search_free(size_t num_ins,
 			size_t key_size,
@@ -430,6 +468,27 @@ void search_nin_ht(const ht_divchn_t *ht,
   *res *= (ht->num_elts == n);
 }
 
+void reset_ht(ht_divchn_t *ht,
+	      const unsigned char *keys,
+	      size_t count,
+	      int *res){
+  size_t i;
+  size_t init_count = ht->count;
+  const unsigned char *k = NULL;
+  clock_t t;
+  t = clock();
+  ht_divchn_reset(ht);
+  t = clock() - t;
+  k = keys;
+  for (i = 0; i < count; i++){
+    *res *= (ht_divchn_search(ht, k) == NULL);
+    k += ht->key_size;
+  }
+  printf("\t\treset time:                     "
+	 "%.4f seconds\n", (float)t / CLOCKS_PER_SEC);
+  *res *= (ht->num_elts == 0 && ht->count == init_count);
+}
+
 void free_ht(ht_divchn_t *ht){
   clock_t t;
   t = clock();
@@ -479,6 +538,8 @@ void insert_search_free(size_t num_ins,
 		 NULL,
 		 NULL);
   insert_keys_elts(&ht, keys, elts, num_ins, &res); /* no dereferencing */
+  reset_ht(&ht, keys, num_ins, &res);
+  insert_keys_elts(&ht, keys, elts, num_ins, &res);
   free_ht(&ht);
   ht_divchn_init(&ht,
 		 key_size,
@@ -685,6 +746,669 @@ void remove_delete(size_t num_ins,
   elts = NULL;
 }
 
+/**
+   Runs a test of the incremental growth mode on distinct size_t keys and
+   size_t elements, and compares the maximal time of an insert operation
+   in the mode with the maximal time of an insert operation without the
+   mode. The keys are removed and deleted while the keys of the last growth
+   step may still be moved.
+*/
+void run_incr_grow_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t elt;
+  size_t *keys = NULL;
+  clock_t t, t_max[2];
+  ht_divchn_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_divchn_incr_grow test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f, "
+	 "# slots moved: %lu\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d),
+	 TOLU(C_INCR_NUM_SLOTS));
+  for (j = 0; j < 2; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    t_max[j] = 0;
+    for (i = 0; i < num_ins; i++){
+      t = clock();
+      ht_divchn_insert(&ht, &keys[i], &keys[i]);
+      t = clock() - t;
+      if (t > t_max[j]) t_max[j] = t;
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht, &keys[i]) == keys[i]);
+    }
+    for (i = 0; i < num_ins; i++){
+      if (i & 1){
+	ht_divchn_delete(&ht, &keys[i]);
+      }else{
+	elt = num_ins;
+	ht_divchn_remove(&ht, &keys[i], &elt);
+	res *= (elt == keys[i]);
+      }
+    }
+    res *= (ht.num_elts == 0);
+    for (i = 0; i < num_ins; i++){
+      res *= (ht_divchn_search(&ht, &keys[i]) == NULL);
+    }
+    ht_divchn_free(&ht);
+  }
+  printf("\t\tmax insert time:                    %.6f seconds\n"
+	 "\t\tmax insert time (incremental):      %.6f seconds\n",
+	 (double)t_max[0] / CLOCKS_PER_SEC,
+	 (double)t_max[1] / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of the pool allocation mode on distinct size_t keys and
+   size_t elements, and compares the insert and free times in the mode with
+   the insert and free times without the mode. The nodes of removed and
+   deleted keys are reused by a second round of inserts.
+*/
+void run_pool_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t elt;
+  size_t *keys = NULL;
+  clock_t t_ins[2], t_free[2];
+  ht_divchn_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_divchn_pool test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < 2; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j) ht_divchn_pool(&ht, 0);
+    t_ins[j] = clock();
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i], &keys[i]);
+    }
+    t_ins[j] = clock() - t_ins[j];
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      if (i & 1){
+	ht_divchn_delete(&ht, &keys[i]);
+      }else{
+	elt = num_ins;
+	ht_divchn_remove(&ht, &keys[i], &elt);
+	res *= (elt == keys[i]);
+      }
+    }
+    res *= (ht.num_elts == 0);
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i], &keys[i]);
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht, &keys[i]) == keys[i]);
+    }
+    t_free[j] = clock();
+    ht_divchn_free(&ht);
+    t_free[j] = clock() - t_free[j];
+  }
+  printf("\t\tinsert time:                        %.6f seconds\n"
+	 "\t\tinsert time (pool):                 %.6f seconds\n"
+	 "\t\tfree time:                          %.6f seconds\n"
+	 "\t\tfree time (pool):                   %.6f seconds\n",
+	 (double)t_ins[0] / CLOCKS_PER_SEC,
+	 (double)t_ins[1] / CLOCKS_PER_SEC,
+	 (double)t_free[0] / CLOCKS_PER_SEC,
+	 (double)t_free[1] / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of insert and search times with the default conversion of
+   keys and with mem_hash as rdc_key, on distinct keys of C_RDC_KEY_COUNT
+   size_t words and size_t elements.
+*/
+void run_rdc_key_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t key_size = C_RDC_KEY_COUNT * sizeof(size_t);
+  size_t *keys = NULL;
+  clock_t t_ins[2], t_search[2];
+  ht_divchn_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, key_size);
+  for (i = 0; i < num_ins; i++){
+    for (j = 0; j < C_RDC_KEY_COUNT - 1; j++){
+      keys[i * C_RDC_KEY_COUNT + j] = RANDOM();
+    }
+    keys[i * C_RDC_KEY_COUNT + j] = i;
+  }
+  printf("Run a ht_divchn rdc_key test on distinct %lu-byte keys and size_t "
+	 "elements\n", TOLU(key_size));
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < 2; j++){
+    ht_divchn_init(&ht,
+		   key_size,
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   j ? mem_hash : NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    t_ins[j] = clock();
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i * C_RDC_KEY_COUNT], &i);
+    }
+    t_ins[j] = clock() - t_ins[j];
+    res *= (ht.num_elts == num_ins);
+    t_search[j] = clock();
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht,
+					  &keys[i * C_RDC_KEY_COUNT]) == i);
+    }
+    t_search[j] = clock() - t_search[j];
+    ht_divchn_free(&ht);
+  }
+  printf("\t\tinsert time:                        %.6f seconds\n"
+	 "\t\tinsert time (mem_hash):             %.6f seconds\n"
+	 "\t\tsearch time:                        %.6f seconds\n"
+	 "\t\tsearch time (mem_hash):             %.6f seconds\n",
+	 (double)t_ins[0] / CLOCKS_PER_SEC,
+	 (double)t_ins[1] / CLOCKS_PER_SEC,
+	 (double)t_search[0] / CLOCKS_PER_SEC,
+	 (double)t_search[1] / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of ht_divchn_stats on distinct size_t keys and size_t
+   elements, without and with an incremental growth mode. Tests that the
+   histogram of chain lengths accounts for each slot and each key, and that
+   the chain lengths are bounded by max_chain_len.
+*/
+void run_stats_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins, num_slots, num_keys;
+  size_t *keys = NULL;
+  size_t *hist = NULL;
+  ht_divchn_t ht;
+  ht_divchn_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  hist = malloc_perror(C_HIST_COUNT, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_divchn_stats test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < 2; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i], &keys[i]);
+    }
+    ht_divchn_stats(&ht, &s, hist, C_HIST_COUNT);
+    num_slots = 0;
+    num_keys = 0;
+    for (i = 0; i < C_HIST_COUNT; i++){
+      num_slots += hist[i];
+      num_keys += i * hist[i];
+      if (i > s.max_chain_len) res *= (hist[i] == 0);
+    }
+    res *= (s.num_elts == num_ins &&
+	    s.count == ht.count &&
+	    num_slots == ht.count + (ht.prev_count - ht.prev_ix) &&
+	    (s.max_chain_len >= C_HIST_COUNT - 1 || num_keys == num_ins) &&
+	    (s.num_grows > 0) == (ht.count > C_HT_COUNT_MIN) &&
+	    s.num_moves >= s.num_grows);
+    if (j == 0){
+      printf("\t\tchain lengths:                 ");
+      for (i = 0; i < C_HIST_COUNT && i <= s.max_chain_len; i++){
+	printf(" %lu", TOLU(hist[i]));
+      }
+      printf("\n\t\tgrowth steps, moved keys:       %lu, %lu\n",
+	     TOLU(s.num_grows), TOLU(s.num_moves));
+    }
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_delete(&ht, &keys[i]);
+    }
+    ht_divchn_stats(&ht, &s, hist, 1);
+    res *= (s.num_elts == 0 && s.max_chain_len == 0 && hist[0] > 0);
+    ht_divchn_free(&ht);
+  }
+  printf("\t\tcorrectness:                   ");
+  print_test_result(res);
+  free(keys);
+  free(hist);
+  keys = NULL;
+  hist = NULL;
+}
+
+/**
+   Runs a test of the chunked chain mode on distinct random size_t keys and
+   size_t elements, without and with an incremental growth mode, and
+   compares the insert and search times with the times of lists as chains.
+   Tests updates, removals, deletions, reinsertions, and the histogram of
+   chain lengths. Then runs a test of the mode on keys of sizeof(size_t) + 1
+   bytes and noncontiguous uint_ptr_t elements, which are freed by updates,
+   deletions, and ht_divchn_free.
+*/
+void run_chunk_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins, num_slots, num_keys;
+  size_t elt;
+  size_t key_size = sizeof(size_t) + 1;
+  size_t *keys = NULL;
+  size_t *hist = NULL;
+  unsigned char *bkeys = NULL;
+  void *elts = NULL;
+  clock_t t_ins[3], t_search[3];
+  ht_divchn_t ht;
+  ht_divchn_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  hist = malloc_perror(C_HIST_COUNT, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    /* distinct even keys; keys[i] + 1 is not in a hash table */
+    keys[i] = 2 * ((size_t)RANDOM() * num_ins + i);
+  }
+  printf("Run a ht_divchn_chunk test on distinct random size_t keys and "
+	 "size_t elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < 3; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j > 0) ht_divchn_chunk(&ht);
+    if (j > 1) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    t_ins[j] = clock();
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i], &i);
+    }
+    t_ins[j] = clock() - t_ins[j];
+    res *= (ht.num_elts == num_ins);
+    t_search[j] = clock();
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht, &keys[i]) == i);
+    }
+    for (i = 0; i < num_ins; i++){
+      elt = keys[i] + 1;
+      res *= (ht_divchn_search(&ht, &elt) == NULL);
+    }
+    t_search[j] = clock() - t_search[j];
+    for (i = 0; i < num_ins; i++){
+      elt = i + 1;
+      ht_divchn_insert(&ht, &keys[i], &elt);
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht, &keys[i]) == i + 1);
+    }
+    ht_divchn_stats(&ht, &s, hist, C_HIST_COUNT);
+    num_slots = 0;
+    num_keys = 0;
+    for (i = 0; i < C_HIST_COUNT; i++){
+      num_slots += hist[i];
+      num_keys += i * hist[i];
+    }
+    res *= (num_slots == ht.count + (ht.prev_count - ht.prev_ix) &&
+	    (s.max_chain_len >= C_HIST_COUNT - 1 || num_keys == num_ins));
+    for (i = 0; i < num_ins; i++){
+      if (i & 1){
+	ht_divchn_delete(&ht, &keys[i]);
+      }else{
+	elt = num_ins + 1;
+	ht_divchn_remove(&ht, &keys[i], &elt);
+	res *= (elt == i + 1);
+      }
+      if (i & 2) res *= (ht_divchn_search(&ht, &keys[i]) == NULL);
+    }
+    res *= (ht.num_elts == 0);
+    ht_divchn_stats(&ht, &s, NULL, 0);
+    res *= (s.max_chain_len == 0);
+    for (i = 0; i < num_ins; i++){
+      ht_divchn_insert(&ht, &keys[i], &i);
+    }
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_divchn_search(&ht, &keys[i]) == i);
+    }
+    ht_divchn_reset(&ht);
+    res *= (ht.num_elts == 0 && ht_divchn_search(&ht, &keys[0]) == NULL);
+    ht_divchn_free(&ht);
+  }
+  /* noncontiguous elements */
+  bkeys = malloc_perror(num_ins, key_size);
+  elts = malloc_perror(num_ins, sizeof(uint_ptr_t *));
+  for (i = 0; i < num_ins; i++){
+    memcpy(ptr(bkeys, i, key_size), &keys[i], sizeof(size_t));
+    *(unsigned char *)ptr(bkeys, i * key_size + sizeof(size_t), 1) = i;
+  }
+  ht_divchn_init(&ht,
+		 key_size,
+		 sizeof(uint_ptr_t *),
+		 0,
+		 alpha_n,
+		 log_alpha_d,
+		 NULL,
+		 NULL,
+		 free_uint_ptr);
+  ht_divchn_align(&ht, sizeof(uint_ptr_t *));
+  ht_divchn_chunk(&ht);
+  ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+  for (j = 0; j < 2; j++){
+    for (i = 0; i < num_ins; i++){
+      new_uint_ptr(ptr(elts, i, sizeof(uint_ptr_t *)), i + j);
+      ht_divchn_insert(&ht,
+		       ptr(bkeys, i, key_size),
+		       ptr(elts, i, sizeof(uint_ptr_t *)));
+    }
+  }
+  res *= (ht.num_elts == num_ins);
+  for (i = 0; i < num_ins; i++){
+    res *= (val_uint_ptr(ht_divchn_search(&ht,
+					  ptr(bkeys, i, key_size))) == i + 1);
+  }
+  for (i = 0; i < num_ins; i += 2){
+    ht_divchn_delete(&ht, ptr(bkeys, i, key_size));
+  }
+  res *= (ht.num_elts == num_ins / 2);
+  ht_divchn_free(&ht);
+  printf("\t\tinsert time:                        %.6f seconds\n"
+	 "\t\tinsert time (chunk):                %.6f seconds\n"
+	 "\t\tinsert time (chunk, incremental):   %.6f seconds\n"
+	 "\t\tsearch time:                        %.6f seconds\n"
+	 "\t\tsearch time (chunk):                %.6f seconds\n"
+	 "\t\tsearch time (chunk, incremental):   %.6f seconds\n",
+	 (double)t_ins[0] / CLOCKS_PER_SEC,
+	 (double)t_ins[1] / CLOCKS_PER_SEC,
+	 (double)t_ins[2] / CLOCKS_PER_SEC,
+	 (double)t_search[0] / CLOCKS_PER_SEC,
+	 (double)t_search[1] / CLOCKS_PER_SEC,
+	 (double)t_search[2] / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(hist);
+  free(bkeys);
+  free(elts);
+  keys = NULL;
+  hist = NULL;
+  bkeys = NULL;
+  elts = NULL;
+}
+
+/**
+   Runs a ht_divchn_search_batch test on distinct random size_t keys and
+   size_t elements, where half of the searched keys are not in a hash
+   table and the keys are searched in a random order, by comparing the
+   results to the results of ht_divchn_search.
+*/
+void run_search_batch_test(size_t log_ins,
+			   size_t alpha_n,
+			   size_t log_alpha_d){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_ins;
+  size_t key;
+  size_t *keys = NULL;
+  void **elts = NULL, **batch_elts = NULL;
+  clock_t t, t_batch;
+  ht_divchn_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(2 * num_ins, sizeof(size_t));
+  elts = malloc_perror(2 * num_ins, sizeof(void *));
+  batch_elts = malloc_perror(2 * num_ins, sizeof(void *));
+  for (i = 0; i < num_ins; i++){
+    /* distinct even keys; keys[i] + 1 is not in a hash table */
+    keys[i] = 2 * ((size_t)RANDOM() * num_ins + i);
+    keys[num_ins + i] = keys[i] + 1;
+  }
+  printf("Run a ht_divchn_search_batch test on distinct random size_t keys "
+	 "and size_t elements\n");
+  printf("\t# inserts: %lu, # searches: %lu, load factor upper bound: "
+	 "%.4f\n",
+	 TOLU(num_ins),
+	 TOLU(2 * num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < C_BATCH_NUM_MODES; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j == 1) ht_divchn_pool(&ht, 0);
+    if (j > 1) ht_divchn_chunk(&ht);
+    if (j > 2) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    for (i = 0; i < 2 * num_ins; i++){
+      if (!(keys[i] & 1)) ht_divchn_insert(&ht, &keys[i], &keys[i]);
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 2 * num_ins - 1; i > 0; i--){
+      k = RANDOM() % (i + 1);
+      key = keys[i];
+      keys[i] = keys[k];
+      keys[k] = key;
+    }
+    t = clock();
+    for (i = 0; i < 2 * num_ins; i++){
+      elts[i] = ht_divchn_search(&ht, &keys[i]);
+    }
+    t = clock() - t;
+    t_batch = clock();
+    ht_divchn_search_batch(&ht, keys, batch_elts, 2 * num_ins);
+    t_batch = clock() - t_batch;
+    for (i = 0; i < 2 * num_ins; i++){
+      res *= (elts[i] == batch_elts[i]);
+      if (keys[i] & 1){
+	res *= (batch_elts[i] == NULL);
+      }else{
+	res *= (batch_elts[i] != NULL &&
+		*(size_t *)batch_elts[i] == keys[i]);
+      }
+    }
+    ht_divchn_search_batch(&ht, keys, batch_elts, 0);
+    printf("\t\t%s\n"
+	   "\t\t\tsearch time:                 %.4f seconds\n"
+	   "\t\t\tbatch search time:           %.4f seconds\n",
+	   C_BATCH_MODES[j],
+	   (double)t / CLOCKS_PER_SEC,
+	   (double)t_batch / CLOCKS_PER_SEC);
+    ht_divchn_free(&ht);
+  }
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  free(batch_elts);
+  keys = NULL;
+  elts = NULL;
+  batch_elts = NULL;
+}
+
+/**
+   Runs a ht_divchn_search_interleave test on distinct random size_t keys
+   and size_t elements in the modes of the batch search test, with
+   different numbers of lookups in flight, by comparing the results to the
+   results of ht_divchn_search. In the incremental mode, the inserts stop
+   in a growth step after at least half of the keys were inserted, so that
+   the lookups continue in the previous slots. Half of the searched keys
+   are not in a hash table.
+*/
+void run_search_interleave_test(size_t log_ins,
+				size_t alpha_n,
+				size_t log_alpha_d){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_ins, num_present;
+  size_t key;
+  size_t *keys = NULL;
+  void **elts = NULL, **lk_elts = NULL;
+  clock_t t, t_lk;
+  ht_divchn_t ht;
+  ht_divchn_lookup_t *lks = NULL;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(2 * num_ins, sizeof(size_t));
+  elts = malloc_perror(2 * num_ins, sizeof(void *));
+  lk_elts = malloc_perror(2 * num_ins, sizeof(void *));
+  lks = malloc_perror(C_NUM_LKS[C_NUM_LKS_COUNT - 1],
+		      sizeof(ht_divchn_lookup_t));
+  for (i = 0; i < num_ins; i++){
+    /* distinct even keys; keys[i] + 1 is not in a hash table */
+    keys[i] = 2 * ((size_t)RANDOM() * num_ins + i);
+    keys[num_ins + i] = keys[i] + 1;
+  }
+  printf("Run a ht_divchn_search_interleave test on distinct random size_t "
+	 "keys and size_t elements\n");
+  printf("\t# inserts: %lu, # searches: %lu, load factor upper bound: "
+	 "%.4f\n",
+	 TOLU(num_ins),
+	 TOLU(2 * num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < C_BATCH_NUM_MODES; j++){
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   alpha_n,
+		   log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    ht_divchn_align(&ht, sizeof(size_t));
+    if (j == 1) ht_divchn_pool(&ht, 0);
+    if (j > 1) ht_divchn_chunk(&ht);
+    if (j > 2) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    num_present = 0;
+    for (i = 0; i < 2 * num_ins; i++){
+      if (keys[i] & 1) continue;
+      ht_divchn_insert(&ht, &keys[i], &keys[i]);
+      num_present++;
+      if (j > 2 && num_present >= num_ins / 2 && ht.prev_count > 0) break;
+    }
+    res *= (ht.num_elts == num_present);
+    for (i = 2 * num_ins - 1; i > 0; i--){
+      k = RANDOM() % (i + 1);
+      key = keys[i];
+      keys[i] = keys[k];
+      keys[k] = key;
+    }
+    t = clock();
+    for (i = 0; i < 2 * num_ins; i++){
+      elts[i] = ht_divchn_search(&ht, &keys[i]);
+    }
+    t = clock() - t;
+    printf("\t\t%s, in progress growth step: %s\n"
+	   "\t\t\tsearch time:                 %.4f seconds\n",
+	   C_BATCH_MODES[j],
+	   (ht.prev_count > 0) ? "yes" : "no",
+	   (double)t / CLOCKS_PER_SEC);
+    for (k = 0; k < C_NUM_LKS_COUNT; k++){
+      t_lk = clock();
+      ht_divchn_search_interleave(&ht,
+				  keys,
+				  lk_elts,
+				  2 * num_ins,
+				  lks,
+				  C_NUM_LKS[k]);
+      t_lk = clock() - t_lk;
+      for (i = 0; i < 2 * num_ins; i++){
+	res *= (elts[i] == lk_elts[i]);
+	if (keys[i] & 1){
+	  res *= (lk_elts[i] == NULL);
+	}else if (lk_elts[i] != NULL){
+	  res *= (*(size_t *)lk_elts[i] == keys[i]);
+	}
+      }
+      printf("\t\t\t%2lu in flight search time:     %.4f seconds\n",
+	     TOLU(C_NUM_LKS[k]),
+	     (double)t_lk / CLOCKS_PER_SEC);
+    }
+    ht_divchn_search_interleave(&ht, keys, lk_elts, 0, lks, 1);
+    ht_divchn_free(&ht);
+  }
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  free(lk_elts);
+  free(lks);
+  keys = NULL;
+  elts = NULL;
+  lk_elts = NULL;
+  lks = NULL;
+}
+
 /**
    Runs a corner cases test.
 */
@@ -731,6 +1455,31 @@ void run_corner_cases_test(size_t log_ins){
 	    ht_divchn_search(&ht, key) == NULL);
     ht_divchn_free(&ht);
   }
+  /* a large min_num with the bytes of ht set as if not initialized */
+  memset(&ht, 0xff, sizeof(ht_divchn_t));
+  ht_divchn_init(&ht,
+		 sizeof(size_t),
+		 elt_size,
+		 C_MIN_NUM,
+		 C_MIN_NUM_ALPHA_N,
+		 C_MIN_NUM_LOG_ALPHA_D,
+		 NULL,
+		 NULL,
+		 NULL);
+  ht_divchn_align(&ht, elt_alignment);
+  res *= (ht.alpha_n == C_MIN_NUM_ALPHA_N &&
+	  ht.log_alpha_d == C_MIN_NUM_LOG_ALPHA_D &&
+	  ht.count / pow_two_perror(C_MIN_NUM_LOG_ALPHA_D) *
+	  C_MIN_NUM_ALPHA_N >= C_MIN_NUM);
+  i = ht.count;
+  for (k = 0; k < C_MIN_NUM; k++){
+    ht_divchn_insert(&ht, &k, &k);
+  }
+  res *= (ht.count == i && ht.num_elts == C_MIN_NUM);
+  for (k = 0; k < C_MIN_NUM; k++){
+    res *= (*(const size_t *)ht_divchn_search(&ht, &k) == k);
+  }
+  ht_divchn_free(&ht);
   print_test_result(res);
   free(key);
   key = NULL;
@@ -763,7 +1512,7 @@ int main(int argc, char *argv[]){
   size_t *args = NULL;
   RGENS_SEED();
   if (argc > C_ARGC_MAX){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
@@ -784,8 +1533,13 @@ int main(int argc, char *argv[]){
       args[8] > 1 ||
       args[9] > 1 ||
       args[10] > 1 ||
-      args[11] > 1){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+      args[11] > 1 ||
+      args[12] > 1 ||
+      args[13] > 1 ||
+      args[14] > 1 ||
+      args[15] > 1 ||
+      args[16] > 1){
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   };
   if (args[7]) run_insert_search_free_uint_test(args[0],
@@ -817,6 +1571,15 @@ int main(int argc, char *argv[]){
 						args[5],
 						args[6]);
   if (args[11]) run_corner_cases_test(args[0]);
+  if (args[12]){
+    run_incr_grow_test(args[0], args[4], args[5]);
+    run_pool_test(args[0], args[4], args[5]);
+    run_rdc_key_test(args[0], args[4], args[5]);
+  }
+  if (args[13]) run_stats_test(args[0], args[4], args[5]);
+  if (args[14]) run_chunk_test(args[0], args[4], args[5]);
+  if (args[15]) run_search_batch_test(args[0], args[4], args[5]);
+  if (args[16]) run_search_interleave_test(args[0], args[4], args[5]);
   free(args);
   args = NULL;
   return 0;
@@ -40,11 +40,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
 #include "ht-divchn.h"
 #include "dll.h"
 #include "utilities-mem.h"
 #include "utilities-mod.h"
 
+#if defined(__GNUC__) && !defined(HT_DIVCHN_NO_PREFETCH)
+#define HT_DIVCHN_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define HT_DIVCHN_PREFETCH(p) ((void)(p))
+#endif
+
 /**
    An array of primes in the increasing order, approximately doubling in 
    magnitude, that are not too close to the powers of 2 and 10 to avoid 
@@ -117,10 +124,93 @@ static const size_t C_BYTE_BIT = CHAR_BIT;
 static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 static const size_t C_SIZE_MAX = (size_t)-1;
 
+/**
+   A chunk begins with a chunk_hdr_t struct, followed by pairs at
+   chunk_hdr_size. A key in a pair is aligned to a multiple of the minimum
+   of key_size and C_CHUNK_ALIGN, where C_CHUNK_ALIGN is a multiple of the
+   alignment requirements of the types in chunk_align_t, and an element is
+   aligned according to ht_divchn_align.
+*/
+typedef struct{
+  size_t num; /* number of pairs */
+  size_t cap; /* number of pairs that fit in the chunk */
+} chunk_hdr_t;
+
+typedef union{
+  long l;
+  double d;
+  long double ld;
+  void *p;
+  void (*f)(void);
+} chunk_align_t;
+
+static const size_t C_CHUNK_ALIGN = sizeof(chunk_align_t);
+static const size_t C_CHUNK_SIZE = 64; /* cache line on current systems */
+
+/* number of keys hashed and prefetched before their searches in a batch */
+enum{C_BATCH_GROUP = 16};
+
+/* next memory access of a lookup */
+enum{C_LOOKUP_SLOT, C_LOOKUP_CHAIN, C_LOOKUP_DONE};
+
+static size_t convert_std_key(const ht_divchn_t *ht, const void *key);
 static size_t hash(const ht_divchn_t *ht, const void *key);
+static size_t slot(const ht_divchn_t *ht, size_t std_key);
+static dll_node_t *search(const ht_divchn_t *ht,
+			  const void *key,
+			  size_t std_key,
+			  dll_node_t ***head);
+static char *chunk_search(const ht_divchn_t *ht,
+			  const void *key,
+			  size_t std_key,
+			  void ***chunk,
+			  size_t *i);
+static char *chunk_find(const ht_divchn_t *ht,
+			const void *chunk,
+			const void *key,
+			size_t *i);
+static void chunk_add(const ht_divchn_t *ht,
+		      void **chunk,
+		      const void *key,
+		      const void *elt);
+static void chunk_remove(const ht_divchn_t *ht, void **chunk, size_t i);
+static void chunk_free(const ht_divchn_t *ht, void **chunk);
+static void lookup_slot(const ht_divchn_t *ht,
+			ht_divchn_lookup_t *lk,
+			size_t ix,
+			int is_prev);
+static int lookup_stop(const ht_divchn_t *ht, ht_divchn_lookup_t *lk);
+static int lookup_done(ht_divchn_lookup_t *lk, void *elt);
 static size_t mul_alpha_sz_max(size_t n, size_t alpha_n, size_t log_alpha_d);
 static void ht_grow(ht_divchn_t *ht);
+static size_t incr_num_slots(const ht_divchn_t *ht);
+static void move_slots(ht_divchn_t *ht, size_t num_slots);
 static int incr_count(ht_divchn_t *ht);
+static size_t add_chain_lens(dll_node_t * const *key_elts,
+			     size_t start,
+			     size_t count,
+			     size_t *hist,
+			     size_t hist_count);
+static size_t add_chunk_lens(void * const *chunks,
+			     size_t start,
+			     size_t count,
+			     size_t *hist,
+			     size_t hist_count);
+static void apply_chains(const ht_divchn_t *ht,
+			 dll_node_t * const *key_elts,
+			 size_t start,
+			 size_t count,
+			 void (*apply)(const void *, const void *, void *),
+			 void *arg);
+static void apply_chunks(const ht_divchn_t *ht,
+			 void * const *chunks,
+			 size_t start,
+			 size_t count,
+			 void (*apply)(const void *, const void *, void *),
+			 void *arg);
+static size_t round_up(size_t n, size_t m);
+static size_t lcm(size_t a, size_t b);
+static void fprintf_stderr_exit(const char *s, int line);
 static int is_overflow(size_t start, size_t count);
 static size_t build_prime(size_t start, size_t count);
 
@@ -154,7 +244,9 @@ static size_t build_prime(size_t start, size_t count);
                  hashing, which may introduce regularities
                  - otherwise rdc_key is applied to a key prior to hashing;
                  the first argument points to a key and the second argument
-                 provides the size of the key
+                 provides the size of the key; mem_hash in utilities-mod
+                 hashes a key in sizeof(size_t)-byte increments without
+                 modular reduction
    free_elt    : - if an element is within a contiguous memory block and
                  a copy of the element was inserted, then NULL as free_elt
                  is sufficient to delete the element,
@@ -180,17 +272,34 @@ void ht_divchn_init(ht_divchn_t *ht,
   ht->group_ix = 0;
   ht->count_ix = 0;
   ht->count = build_prime(ht->count_ix, C_PARTS_PER_PRIME[ht->group_ix]);
+  mod_rcp_init(ht->count, &ht->count_mul, &ht->count_shift);
+  ht->alpha_n = alpha_n;
+  ht->log_alpha_d = log_alpha_d;
   /* 0 <= max_num_elts */
   ht->max_num_elts = mul_alpha_sz_max(ht->count, alpha_n, log_alpha_d);
   while (min_num > ht->max_num_elts && incr_count(ht));
   ht->num_elts = 0;
-  ht->alpha_n = alpha_n;
-  ht->log_alpha_d = log_alpha_d;
   ht->ll = malloc_perror(1, sizeof(dll_t));
   ht->key_elts = malloc_perror(ht->count, sizeof(dll_node_t *));
   for (i = 0; i < ht->count; i++){
     dll_init(ht->ll, &ht->key_elts[i], ht->key_size);
   }
+  ht->incr_num_slots = 0;
+  ht->prev_count = 0;
+  ht->prev_mul = 0;
+  ht->prev_shift = 0;
+  ht->prev_ix = 0;
+  ht->prev_key_elts = NULL;
+  ht->pool = NULL;
+  ht->chunks = NULL;
+  ht->prev_chunks = NULL;
+  ht->chunk_hdr_size = 0;
+  ht->chunk_min_cap = 0;
+  ht->pair_size = 0;
+  ht->pair_elt_offset = 0;
+  ht->num_grows = 0;
+  ht->num_moves = 0;
+  ht->resize_clocks = 0;
   ht->cmp_key = cmp_key;
   ht->rdc_key = rdc_key;
   ht->free_elt = free_elt;
@@ -217,6 +326,94 @@ void ht_divchn_align(ht_divchn_t *ht, size_t elt_alignment){
   dll_align_elt(ht->ll, elt_alignment);
 }
 
+/**
+   Sets an incremental growth mode of a hash table. In the mode, a growth
+   step allocates the slots of the next count, and the keys in the previous
+   slots are moved to the next slots in parts of at most num_slots previous
+   slots at the beginning of each remove and delete operation, and in parts
+   of at least num_slots previous slots at the beginning of each insert
+   operation, s.t. all keys are moved before alpha is exceeded again,
+   instead of moving all keys within a single insert operation. Until all
+   keys are moved, a search or modifying operation accesses the previous
+   and the next slots. The allocation and initialization of the next slots
+   remain in the insert operation that exceeded alpha. The operation is
+   optionally called after ht_divchn_init and ht_divchn_align are completed
+   and before any other operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+   num_slots   : > 0 number of previous slots with their keys moved in one
+                 operation; a larger number completes the move of keys in
+                 fewer operations at the expense of a larger operation
+                 cost during the move
+*/
+void ht_divchn_incr_grow(ht_divchn_t *ht, size_t num_slots){
+  ht->incr_num_slots = num_slots;
+}
+
+/**
+   Sets a pool allocation mode of a hash table. In the mode, the nodes of
+   the chains are allocated from a pool in blocks of nodes, the nodes of
+   removed and deleted keys are reused by subsequent insert operations, and
+   all nodes are freed at once when the hash table is freed, instead of a
+   malloc and free call per key. The operation is optionally called after
+   ht_divchn_init and ht_divchn_align are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+   min_num     : minimum number of keys that are known or expected to become
+                 present simultaneously in a hash table, resulting in fewer
+                 allocations of blocks of nodes at the beginning; 0 if a
+                 positive value is not specified
+*/
+void ht_divchn_pool(ht_divchn_t *ht, size_t min_num){
+  if (ht->chunks != NULL){
+    fprintf_stderr_exit("pool mode in chunked chain mode", __LINE__);
+  }
+  ht->pool = malloc_perror(1, sizeof(dll_pool_t));
+  dll_pool_init(ht->ll, ht->pool, ht->elt_size, min_num);
+}
+
+/**
+   Sets a chunked chain mode of a hash table. In the mode, the chain of a
+   slot is a chunk, which is a contiguous block of key-element pairs, instead
+   of a list with a node per key, so that a search accesses a slot and a
+   single block instead of following a pointer per key. A chunk is
+   allocated for the first key of a slot with the number of pairs that fit
+   into a cache line of 64 bytes, or one pair if a pair does not fit,
+   and is doubled if it is full. A remove or delete operation moves the
+   last pair of a chunk to the position of the removed pair, and a chunk is
+   freed with its last key. A key in a chunk can be accessed with a pointer
+   to its type if the size of the type is key_size. Because pairs are
+   moved, a pointer returned by ht_divchn_search is valid until a
+   modifying operation is called. The mode is not combined with the pool
+   allocation mode. The operation is optionally called after
+   ht_divchn_init and ht_divchn_align are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+*/
+void ht_divchn_chunk(ht_divchn_t *ht){
+  size_t i;
+  size_t key_align, pair_align;
+  if (ht->pool != NULL){
+    fprintf_stderr_exit("chunked chain mode in pool mode", __LINE__);
+  }
+  key_align = (ht->key_size < C_CHUNK_ALIGN) ? ht->key_size : C_CHUNK_ALIGN;
+  pair_align = lcm(key_align, ht->elt_alignment);
+  ht->pair_elt_offset = round_up(ht->key_size, ht->elt_alignment);
+  ht->pair_size = round_up(add_sz_perror(ht->pair_elt_offset, ht->elt_size),
+			   pair_align);
+  ht->chunk_hdr_size = round_up(sizeof(chunk_hdr_t), pair_align);
+  ht->chunk_min_cap = 1;
+  if (C_CHUNK_SIZE > ht->chunk_hdr_size &&
+      (C_CHUNK_SIZE - ht->chunk_hdr_size) / ht->pair_size > 1){
+    ht->chunk_min_cap = (C_CHUNK_SIZE - ht->chunk_hdr_size) / ht->pair_size;
+  }
+  free(ht->key_elts);
+  ht->key_elts = NULL;
+  ht->chunks = malloc_perror(ht->count, sizeof(void *));
+  for (i = 0; i < ht->count; i++){
+    ht->chunks[i] = NULL;
+  }
+}
+
 /**
    Inserts a key and an associated element into a hash table. If the key is
    in the hash table, associates the key with the new element. The key and 
@@ -224,13 +421,36 @@ void ht_divchn_align(ht_divchn_t *ht, size_t elt_alignment){
    elt_size respectively.
 */
 void ht_divchn_insert(ht_divchn_t *ht, const void *key, const void *elt){
-  size_t ix;
+  size_t i, std_key;
+  clock_t start;
+  char *pair = NULL;
+  void **chunk = NULL;
   dll_node_t **head = NULL, *node = NULL;
-  ix = hash(ht, key);
-  head = &ht->key_elts[ix];
-  node = dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
-  if (node == NULL){
-    dll_prepend_new(ht->ll, head, key, elt, ht->key_size, ht->elt_size);
+  if (ht->prev_count > 0) move_slots(ht, incr_num_slots(ht));
+  std_key = convert_std_key(ht, key);
+  if (ht->chunks == NULL) node = search(ht, key, std_key, &head);
+  if (ht->chunks != NULL){
+    pair = chunk_search(ht, key, std_key, &chunk, &i);
+    if (pair == NULL){
+      chunk_add(ht, &ht->chunks[slot(ht, std_key)], key, elt);
+      ht->num_elts++;
+    }else{
+      if (ht->free_elt != NULL) ht->free_elt(pair + ht->pair_elt_offset);
+      memcpy(pair + ht->pair_elt_offset, elt, ht->elt_size);
+    }
+  }else if (node == NULL){
+    head = &ht->key_elts[slot(ht, std_key)];
+    if (ht->pool != NULL){
+      dll_prepend_new_pool(ht->ll,
+			   ht->pool,
+			   head,
+			   key,
+			   elt,
+			   ht->key_size,
+			   ht->elt_size);
+    }else{
+      dll_prepend_new(ht->ll, head, key, elt, ht->key_size, ht->elt_size);
+    }
     ht->num_elts++;
   }else{
     if (ht->free_elt != NULL) ht->free_elt(dll_elt_ptr(ht->ll, node));
@@ -240,7 +460,11 @@ void ht_divchn_insert(ht_divchn_t *ht, const void *key, const void *elt){
   if (ht->num_elts > ht->max_num_elts && 
       ht->count_ix != C_SIZE_MAX &&
       ht->count_ix != C_PRIME_PARTS_COUNT){
+    start = clock();
+    /* complete the move of keys of an incremental growth step */
+    if (ht->prev_count > 0) move_slots(ht, ht->prev_count);
     ht_grow(ht);
+    ht->resize_clocks += clock() - start;
   }
 }
 
@@ -251,11 +475,16 @@ void ht_divchn_insert(ht_divchn_t *ht, const void *key, const void *elt){
    according to ht_divchn_init and ht_divchn_align_elt.
 */
 void *ht_divchn_search(const ht_divchn_t *ht, const void *key){
-  const dll_node_t *node = dll_search_key(ht->ll,
-					  &ht->key_elts[hash(ht, key)],
-					  key,
-					  ht->key_size,
-					  ht->cmp_key);
+  size_t i;
+  char *pair = NULL;
+  void **chunk = NULL;
+  dll_node_t **head = NULL;
+  const dll_node_t *node = NULL;
+  if (ht->chunks != NULL){
+    pair = chunk_search(ht, key, convert_std_key(ht, key), &chunk, &i);
+    return (pair == NULL) ? NULL : pair + ht->pair_elt_offset;
+  }
+  node = search(ht, key, convert_std_key(ht, key), &head);
   if (node == NULL){
     return NULL;
   }else{
@@ -263,6 +492,176 @@ void *ht_divchn_search(const ht_divchn_t *ht, const void *key){
   }
 }
 
+/**
+   Searches a batch of keys in a hash table. Sets batch_elts[i] to a
+   pointer to the element associated with the ith key, if the key is
+   present, and to NULL otherwise. The batch_keys parameter is not NULL and
+   points to an array of batch_count blocks of size key_size, and the
+   batch_elts parameter is not NULL and points to an array of batch_count
+   pointers. The keys are processed in groups: the keys of a group are
+   hashed and their slots are prefetched, then the chain heads or chunks
+   in the slots are prefetched, and then the keys are searched, so that
+   the cache misses of the keys in a group overlap. The pointers can be
+   dereferenced according to ht_divchn_search.
+*/
+void ht_divchn_search_batch(const ht_divchn_t *ht,
+			    const void *batch_keys,
+			    void **batch_elts,
+			    size_t batch_count){
+  size_t i, j, k, n;
+  size_t std_keys[C_BATCH_GROUP], ixs[C_BATCH_GROUP];
+  char *pair = NULL;
+  const char *key = NULL;
+  const char *keys = batch_keys;
+  void **chunk = NULL;
+  dll_node_t **head = NULL;
+  const dll_node_t *node = NULL;
+  for (i = 0; i < batch_count; i += n){
+    n = batch_count - i;
+    if (n > C_BATCH_GROUP) n = C_BATCH_GROUP;
+    for (j = 0; j < n; j++){
+      std_keys[j] = convert_std_key(ht, keys + (i + j) * ht->key_size);
+      ixs[j] = slot(ht, std_keys[j]);
+      if (ht->chunks != NULL){
+	HT_DIVCHN_PREFETCH(&ht->chunks[ixs[j]]);
+      }else{
+	HT_DIVCHN_PREFETCH(&ht->key_elts[ixs[j]]);
+      }
+    }
+    for (j = 0; j < n; j++){
+      if (ht->chunks != NULL){
+	if (ht->chunks[ixs[j]] != NULL){
+	  HT_DIVCHN_PREFETCH(ht->chunks[ixs[j]]);
+	}
+      }else if (ht->key_elts[ixs[j]] != NULL){
+	HT_DIVCHN_PREFETCH(dll_key_ptr(ht->ll, ht->key_elts[ixs[j]]));
+      }
+    }
+    for (j = 0; j < n; j++){
+      key = keys + (i + j) * ht->key_size;
+      if (ht->chunks != NULL){
+	pair = chunk_search(ht, key, std_keys[j], &chunk, &k);
+	batch_elts[i + j] =
+	  (pair == NULL) ? NULL : pair + ht->pair_elt_offset;
+      }else{
+	node = search(ht, key, std_keys[j], &head);
+	batch_elts[i + j] =
+	  (node == NULL) ? NULL : dll_elt_ptr(ht->ll, node);
+      }
+    }
+  }
+}
+
+/**
+   Starts a lookup of a key as a resumable state machine, and prefetches
+   the slot of its chain. The key parameter is not NULL and points to a
+   block of size key_size that is not modified until the lookup is
+   completed. A lookup is advanced with ht_divchn_lookup_step, so that the
+   lookups of independent requests are interleaved by a caller at their
+   memory accesses. No modifying operation is called on ht until the
+   lookups of ht are completed.
+   ht          : pointer to an initialized ht_divchn_t struct
+   lk          : pointer to a preallocated block of size
+                 sizeof(ht_divchn_lookup_t)
+   key         : pointer to a key
+*/
+void ht_divchn_lookup_init(const ht_divchn_t *ht,
+			   ht_divchn_lookup_t *lk,
+			   const void *key){
+  lk->key = key;
+  lk->elt = NULL;
+  lk->std_key = convert_std_key(ht, key);
+  lookup_slot(ht, lk, slot(ht, lk->std_key), 0);
+}
+
+/**
+   Advances a lookup by one memory access, i.e. a slot, a node, or a chunk
+   prefetched by the previous call, and prefetches the memory of the next
+   access. Returns 1 if the lookup is completed, in which case lk->elt is
+   set according to ht_divchn_search, and 0 otherwise. A completed lookup
+   is not advanced further by subsequent calls.
+*/
+int ht_divchn_lookup_step(const ht_divchn_t *ht, ht_divchn_lookup_t *lk){
+  size_t i;
+  const char *pair = NULL;
+  const dll_node_t *head = NULL, *node = NULL;
+  if (lk->state == C_LOOKUP_DONE) return 1;
+  if (ht->chunks != NULL){
+    if (lk->state == C_LOOKUP_SLOT){
+      lk->node = (lk->is_prev) ? ht->prev_chunks[lk->ix] : ht->chunks[lk->ix];
+      if (lk->node == NULL) return lookup_stop(ht, lk);
+      HT_DIVCHN_PREFETCH(lk->node);
+      lk->state = C_LOOKUP_CHAIN;
+      return 0;
+    }
+    pair = chunk_find(ht, lk->node, lk->key, &i);
+    if (pair == NULL) return lookup_stop(ht, lk);
+    return lookup_done(lk, (char *)pair + ht->pair_elt_offset);
+  }
+  head = (lk->is_prev) ? ht->prev_key_elts[lk->ix] : ht->key_elts[lk->ix];
+  if (lk->state == C_LOOKUP_SLOT){
+    if (head == NULL) return lookup_stop(ht, lk);
+    lk->node = head;
+    HT_DIVCHN_PREFETCH(dll_key_ptr(ht->ll, head));
+    lk->state = C_LOOKUP_CHAIN;
+    return 0;
+  }
+  node = lk->node;
+  if ((ht->cmp_key != NULL &&
+       ht->cmp_key(dll_key_ptr(ht->ll, node), lk->key) == 0) ||
+      (ht->cmp_key == NULL &&
+       memcmp(dll_key_ptr(ht->ll, node), lk->key, ht->key_size) == 0)){
+    return lookup_done(lk, dll_elt_ptr(ht->ll, node));
+  }
+  if (node->next == head) return lookup_stop(ht, lk);
+  lk->node = node->next;
+  HT_DIVCHN_PREFETCH(dll_key_ptr(ht->ll, node->next));
+  return 0;
+}
+
+/**
+   Searches keys with up to num_lks lookups in flight, which are advanced
+   in a round-robin order by ht_divchn_lookup_step, and a completed lookup
+   is replaced by the lookup of the next key, so that a long chain delays
+   only its own key. Sets elts[i] to a pointer to the element associated
+   with the ith key, if the key is present, and to NULL otherwise. The keys
+   parameter points to an array of count blocks of size key_size, elts
+   points to an array of count pointers, and lks points to an array of
+   num_lks > 0 preallocated ht_divchn_lookup_t structs.
+*/
+void ht_divchn_search_interleave(const ht_divchn_t *ht,
+				 const void *keys,
+				 void **elts,
+				 size_t count,
+				 ht_divchn_lookup_t *lks,
+				 size_t num_lks){
+  size_t i, j;
+  size_t num_active = 0;
+  const char *ks = keys;
+  for (i = 0; i < count && num_active < num_lks; i++){
+    ht_divchn_lookup_init(ht, &lks[num_active], ks + i * ht->key_size);
+    num_active++;
+  }
+  while (num_active > 0){
+    j = 0;
+    while (j < num_active){
+      if (!ht_divchn_lookup_step(ht, &lks[j])){
+	j++;
+	continue;
+      }
+      elts[((const char *)lks[j].key - ks) / ht->key_size] = lks[j].elt;
+      if (i < count){
+	ht_divchn_lookup_init(ht, &lks[j], ks + i * ht->key_size);
+	i++;
+	j++;
+      }else{
+	num_active--;
+	lks[j] = lks[num_active];
+      }
+    }
+  }
+}
+
 /**
    Removes a key and its associated element from a hash table by copying 
    the element or its pointer into a block of size elt_size pointed to
@@ -271,13 +670,29 @@ void *ht_divchn_search(const ht_divchn_t *ht, const void *key){
    to blocks of size key_size and elt_size respectively.
 */
 void ht_divchn_remove(ht_divchn_t *ht, const void *key, void *elt){
-  dll_node_t **head = &ht->key_elts[hash(ht, key)];
-  dll_node_t *node =
-    dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+  size_t i;
+  char *pair = NULL;
+  void **chunk = NULL;
+  dll_node_t **head = NULL, *node = NULL;
+  if (ht->prev_count > 0) move_slots(ht, ht->incr_num_slots);
+  if (ht->chunks != NULL){
+    pair = chunk_search(ht, key, convert_std_key(ht, key), &chunk, &i);
+    if (pair != NULL){
+      memcpy(elt, pair + ht->pair_elt_offset, ht->elt_size);
+      chunk_remove(ht, chunk, i);
+      ht->num_elts--;
+    }
+    return;
+  }
+  node = search(ht, key, convert_std_key(ht, key), &head);
   if (node != NULL){
     memcpy(elt, dll_elt_ptr(ht->ll, node), ht->elt_size);
     /* if an element is noncontiguous, only the pointer to it is deleted */
-    dll_delete(ht->ll, head, node, NULL);
+    if (ht->pool != NULL){
+      dll_delete_pool(ht->ll, ht->pool, head, node, NULL);
+    }else{
+      dll_delete(ht->ll, head, node, NULL);
+    }
     ht->num_elts--;
   }
 }
@@ -288,28 +703,192 @@ void ht_divchn_remove(ht_divchn_t *ht, const void *key, void *elt){
    to a block of size key_size.
 */
 void ht_divchn_delete(ht_divchn_t *ht, const void *key){
-  dll_node_t **head = &ht->key_elts[hash(ht, key)];
-  dll_node_t *node =
-    dll_search_key(ht->ll, head, key, ht->key_size, ht->cmp_key);
+  size_t i;
+  char *pair = NULL;
+  void **chunk = NULL;
+  dll_node_t **head = NULL, *node = NULL;
+  if (ht->prev_count > 0) move_slots(ht, ht->incr_num_slots);
+  if (ht->chunks != NULL){
+    pair = chunk_search(ht, key, convert_std_key(ht, key), &chunk, &i);
+    if (pair != NULL){
+      if (ht->free_elt != NULL) ht->free_elt(pair + ht->pair_elt_offset);
+      chunk_remove(ht, chunk, i);
+      ht->num_elts--;
+    }
+    return;
+  }
+  node = search(ht, key, convert_std_key(ht, key), &head);
   if (node != NULL){
-    dll_delete(ht->ll, head, node, ht->free_elt);
+    if (ht->pool != NULL){
+      dll_delete_pool(ht->ll, ht->pool, head, node, ht->free_elt);
+    }else{
+      dll_delete(ht->ll, head, node, ht->free_elt);
+    }
     ht->num_elts--;
   }
 }
 
+/**
+   Deletes all keys and their associated elements from a hash table
+   according to free_elt, keeping the count of slots of the hash table,
+   so that the hash table can be reused without growth steps. Completes
+   an incremental growth step, if any, by deleting the keys that were not
+   moved. Runs in O(count) time. In the pool allocation mode, the nodes are
+   kept in the pool for reuse.
+*/
+void ht_divchn_reset(ht_divchn_t *ht){
+  size_t i;
+  if (ht->chunks != NULL){
+    for (i = 0; i < ht->count; i++){
+      chunk_free(ht, &ht->chunks[i]);
+    }
+    if (ht->prev_chunks != NULL){
+      for (i = ht->prev_ix; i < ht->prev_count; i++){
+	chunk_free(ht, &ht->prev_chunks[i]);
+      }
+    }
+  }else if (ht->pool != NULL){
+    /* constant time per slot if free_elt is NULL */
+    for (i = 0; i < ht->count; i++){
+      dll_free_pool(ht->ll, ht->pool, &ht->key_elts[i], ht->free_elt);
+    }
+    if (ht->prev_key_elts != NULL){
+      for (i = ht->prev_ix; i < ht->prev_count; i++){
+	dll_free_pool(ht->ll, ht->pool, &ht->prev_key_elts[i], ht->free_elt);
+      }
+    }
+  }else{
+    for (i = 0; i < ht->count; i++){
+      dll_free(ht->ll, &ht->key_elts[i], ht->free_elt);
+    }
+    if (ht->prev_key_elts != NULL){
+      for (i = ht->prev_ix; i < ht->prev_count; i++){
+	dll_free(ht->ll, &ht->prev_key_elts[i], ht->free_elt);
+      }
+    }
+  }
+  free(ht->prev_key_elts);
+  free(ht->prev_chunks);
+  ht->prev_count = 0;
+  ht->prev_ix = 0;
+  ht->prev_key_elts = NULL;
+  ht->prev_chunks = NULL;
+  ht->num_elts = 0;
+}
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_divchn_stats_t) pointed to by s, and optionally computes a
+   histogram of chain lengths. The count of growth steps, the count of
+   moved keys, and the processor time of growth steps, measured with clock,
+   are accumulated since ht_divchn_init and are not cleared by
+   ht_divchn_reset. In an incremental growth mode, the processor time
+   includes the allocation of next slots and the completion of a move of
+   keys in an insert operation that exceeded alpha, but not the moves of
+   keys in parts, which are counted in num_moves. Runs in O(count +
+   num_elts) time.
+   ht          : pointer to an initialized ht_divchn_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_divchn_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of slots with a chain
+                 of i keys for i < hist_count - 1, and hist[hist_count - 1]
+                 to the number of slots with a chain of >= hist_count - 1
+                 keys; the previous slots of an incremental growth step
+                 with keys that were not moved are included
+   hist_count  : > 0 if hist is not NULL
+*/
+void ht_divchn_stats(const ht_divchn_t *ht,
+		     ht_divchn_stats_t *s,
+		     size_t *hist,
+		     size_t hist_count){
+  size_t i, max_len;
+  s->count = ht->count;
+  s->num_elts = ht->num_elts;
+  s->max_num_elts = ht->max_num_elts;
+  s->num_grows = ht->num_grows;
+  s->num_moves = ht->num_moves;
+  s->resize_clocks = ht->resize_clocks;
+  if (hist != NULL){
+    for (i = 0; i < hist_count; i++){
+      hist[i] = 0;
+    }
+  }
+  if (ht->chunks != NULL){
+    s->max_chain_len = add_chunk_lens(ht->chunks,
+				      0,
+				      ht->count,
+				      hist,
+				      hist_count);
+    if (ht->prev_chunks != NULL){
+      max_len = add_chunk_lens(ht->prev_chunks,
+			       ht->prev_ix,
+			       ht->prev_count,
+			       hist,
+			       hist_count);
+      if (max_len > s->max_chain_len) s->max_chain_len = max_len;
+    }
+    return;
+  }
+  s->max_chain_len = add_chain_lens(ht->key_elts,
+				    0,
+				    ht->count,
+				    hist,
+				    hist_count);
+  if (ht->prev_key_elts != NULL){
+    max_len = add_chain_lens(ht->prev_key_elts,
+			     ht->prev_ix,
+			     ht->prev_count,
+			     hist,
+			     hist_count);
+    if (max_len > s->max_chain_len) s->max_chain_len = max_len;
+  }
+}
+
+/**
+   Calls apply on each key and its associated element in a hash table,
+   including the keys in the previous slots of an incremental growth step
+   that were not moved. The first argument of apply points to a key, the
+   second argument points to its associated element, and the third argument
+   is arg. apply does not call a modifying operation on the hash table.
+   Runs in O(count + num_elts) time.
+*/
+void ht_divchn_apply(const ht_divchn_t *ht,
+		     void (*apply)(const void *, const void *, void *),
+		     void *arg){
+  if (ht->chunks != NULL){
+    apply_chunks(ht, ht->chunks, 0, ht->count, apply, arg);
+    if (ht->prev_chunks != NULL){
+      apply_chunks(ht, ht->prev_chunks, ht->prev_ix, ht->prev_count,
+		   apply, arg);
+    }
+    return;
+  }
+  apply_chains(ht, ht->key_elts, 0, ht->count, apply, arg);
+  if (ht->prev_key_elts != NULL){
+    apply_chains(ht, ht->prev_key_elts, ht->prev_ix, ht->prev_count,
+		 apply, arg);
+  }
+}
+
 /**
    Frees a hash table and leaves a block of size sizeof(ht_divchn_t)
    pointed to by the ht parameter.
 */
 void ht_divchn_free(ht_divchn_t *ht){
-  size_t i;
-  for (i = 0; i < ht->count; i++){
-    dll_free(ht->ll, &ht->key_elts[i], ht->free_elt);
+  ht_divchn_reset(ht);
+  if (ht->pool != NULL){
+    dll_pool_free(ht->pool);
+    free(ht->pool);
+    ht->pool = NULL;
   }
   free(ht->ll);
   free(ht->key_elts);
+  free(ht->chunks);
   ht->ll = NULL;
   ht->key_elts = NULL;
+  ht->chunks = NULL;
 }
 
 /**
@@ -353,7 +932,7 @@ void *ht_divchn_search_helper(const void *ht, const void *key){
   return ht_divchn_search(ht, key);
 }
 
-void ht_divchnn_remove_helper(void *ht, const void *key, void *elt){
+void ht_divchn_remove_helper(void *ht, const void *key, void *elt){
   ht_divchn_remove(ht, key, elt);
 }
 
@@ -361,6 +940,10 @@ void ht_divchn_delete_helper(void *ht, const void *key){
   ht_divchn_delete(ht, key);
 }
 
+void ht_divchn_reset_helper(void *ht){
+  ht_divchn_reset(ht);
+}
+
 void ht_divchn_free_helper(void *ht){
   ht_divchn_free(ht);
 } 
@@ -402,7 +985,222 @@ static size_t convert_std_key(const ht_divchn_t *ht, const void *key){
    Maps a hash key to a slot index in a hash table with a division method. 
 */
 static size_t hash(const ht_divchn_t *ht, const void *key){
-  return convert_std_key(ht, key) % ht->count; 
+  return slot(ht, convert_std_key(ht, key));
+}
+
+/**
+   Maps a standard key to a slot index with a division method, where the
+   division by the prime count is computed with its reciprocal.
+*/
+static size_t slot(const ht_divchn_t *ht, size_t std_key){
+  return mod_rcp(std_key, ht->count, ht->count_mul, ht->count_shift);
+}
+
+/**
+   If a key with a standard key std_key is present in a hash table, returns
+   a pointer to its node and sets *head to the head of the list containing
+   the node, otherwise returns NULL. If the keys of an incremental growth
+   step are being moved, the list in the previous slots is searched if the
+   key is not found in the next slots.
+*/
+static dll_node_t *search(const ht_divchn_t *ht,
+			  const void *key,
+			  size_t std_key,
+			  dll_node_t ***head){
+  size_t ix;
+  dll_node_t *node = NULL;
+  *head = &ht->key_elts[slot(ht, std_key)];
+  node = dll_search_key(ht->ll, *head, key, ht->key_size, ht->cmp_key);
+  if (node == NULL && ht->prev_key_elts != NULL){
+    ix = mod_rcp(std_key, ht->prev_count, ht->prev_mul, ht->prev_shift);
+    if (ix >= ht->prev_ix){
+      *head = &ht->prev_key_elts[ix];
+      node = dll_search_key(ht->ll, *head, key, ht->key_size, ht->cmp_key);
+    }
+  }
+  return node;
+}
+
+/**
+   If a key with a standard key std_key is present in a hash table in the
+   chunked chain mode, returns a pointer to its pair, and sets *chunk to
+   the slot of the chunk and *i to the index of the pair in the chunk,
+   otherwise returns NULL. If the keys of an incremental growth step are
+   being moved, the chunk in the previous slots is searched if the key is
+   not found in the next slots.
+*/
+static char *chunk_search(const ht_divchn_t *ht,
+			  const void *key,
+			  size_t std_key,
+			  void ***chunk,
+			  size_t *i){
+  size_t ix;
+  char *pair = NULL;
+  *chunk = &ht->chunks[slot(ht, std_key)];
+  pair = chunk_find(ht, **chunk, key, i);
+  if (pair == NULL && ht->prev_chunks != NULL){
+    ix = mod_rcp(std_key, ht->prev_count, ht->prev_mul, ht->prev_shift);
+    if (ix >= ht->prev_ix){
+      *chunk = &ht->prev_chunks[ix];
+      pair = chunk_find(ht, **chunk, key, i);
+    }
+  }
+  return pair;
+}
+
+/**
+   Returns a pointer to the pair with a key in a chunk, or NULL if the
+   chunk is NULL or the key is not in the chunk. Sets *i to the index of
+   the pair if the key is found.
+*/
+static char *chunk_find(const ht_divchn_t *ht,
+			const void *chunk,
+			const void *key,
+			size_t *i){
+  size_t j;
+  const char *pair = NULL;
+  const chunk_hdr_t *hdr = chunk;
+  if (hdr == NULL) return NULL;
+  pair = (const char *)chunk + ht->chunk_hdr_size;
+  if (ht->cmp_key != NULL){
+    for (j = 0; j < hdr->num; j++){
+      if (ht->cmp_key(pair, key) == 0){
+	*i = j;
+	return (char *)pair;
+      }
+      pair += ht->pair_size;
+    }
+  }else{
+    for (j = 0; j < hdr->num; j++){
+      if (memcmp(pair, key, ht->key_size) == 0){
+	*i = j;
+	return (char *)pair;
+      }
+      pair += ht->pair_size;
+    }
+  }
+  return NULL;
+}
+
+/**
+   Copies a key and an element into a new pair at the end of a chunk.
+   Allocates the chunk with chunk_min_cap pairs if *chunk is NULL, and
+   doubles the chunk if the chunk is full.
+*/
+static void chunk_add(const ht_divchn_t *ht,
+		      void **chunk,
+		      const void *key,
+		      const void *elt){
+  size_t cap;
+  char *pair = NULL;
+  chunk_hdr_t *hdr = *chunk;
+  if (hdr == NULL){
+    hdr = malloc_perror(1, add_sz_perror(ht->chunk_hdr_size,
+					 mul_sz_perror(ht->chunk_min_cap,
+						       ht->pair_size)));
+    hdr->num = 0;
+    hdr->cap = ht->chunk_min_cap;
+  }else if (hdr->num == hdr->cap){
+    cap = mul_sz_perror(hdr->cap, 2);
+    hdr = realloc_perror(hdr, 1, add_sz_perror(ht->chunk_hdr_size,
+					       mul_sz_perror(cap,
+							     ht->pair_size)));
+    hdr->cap = cap;
+  }
+  pair = (char *)hdr + ht->chunk_hdr_size + hdr->num * ht->pair_size;
+  memcpy(pair, key, ht->key_size);
+  memcpy(pair + ht->pair_elt_offset, elt, ht->elt_size);
+  hdr->num++;
+  *chunk = hdr;
+}
+
+/**
+   Removes the ith pair of a chunk by moving the last pair to its position,
+   and frees the chunk and sets *chunk to NULL if the pair was the last
+   pair in the chunk. An element is not freed.
+*/
+static void chunk_remove(const ht_divchn_t *ht, void **chunk, size_t i){
+  char *pairs = (char *)*chunk + ht->chunk_hdr_size;
+  chunk_hdr_t *hdr = *chunk;
+  hdr->num--;
+  if (hdr->num == 0){
+    free(hdr);
+    *chunk = NULL;
+  }else if (i < hdr->num){
+    memcpy(pairs + i * ht->pair_size,
+	   pairs + hdr->num * ht->pair_size,
+	   ht->pair_size);
+  }
+}
+
+/**
+   Frees a chunk and its elements according to free_elt, and sets *chunk
+   to NULL.
+*/
+static void chunk_free(const ht_divchn_t *ht, void **chunk){
+  size_t i;
+  char *pair = NULL;
+  chunk_hdr_t *hdr = *chunk;
+  if (hdr == NULL) return;
+  if (ht->free_elt != NULL){
+    pair = (char *)hdr + ht->chunk_hdr_size;
+    for (i = 0; i < hdr->num; i++){
+      ht->free_elt(pair + ht->pair_elt_offset);
+      pair += ht->pair_size;
+    }
+  }
+  free(hdr);
+  *chunk = NULL;
+}
+
+/**
+   Sets a lookup to the slot ix of the next slots if is_prev is 0 and of
+   the previous slots otherwise, and prefetches the slot.
+*/
+static void lookup_slot(const ht_divchn_t *ht,
+			ht_divchn_lookup_t *lk,
+			size_t ix,
+			int is_prev){
+  lk->ix = ix;
+  lk->node = NULL;
+  lk->is_prev = is_prev;
+  lk->state = C_LOOKUP_SLOT;
+  if (ht->chunks != NULL){
+    HT_DIVCHN_PREFETCH((is_prev) ? &ht->prev_chunks[ix] : &ht->chunks[ix]);
+  }else{
+    HT_DIVCHN_PREFETCH((is_prev) ?
+		       &ht->prev_key_elts[ix] :
+		       &ht->key_elts[ix]);
+  }
+}
+
+/**
+   Stops the search of a lookup whose key is not in the searched chain.
+   Continues in the previous slots if the next slots were searched and the
+   keys of an incremental growth step are being moved, and otherwise
+   completes the lookup. Returns 1 if the lookup is completed, and 0
+   otherwise.
+*/
+static int lookup_stop(const ht_divchn_t *ht, ht_divchn_lookup_t *lk){
+  size_t ix;
+  if (!lk->is_prev &&
+      (ht->prev_key_elts != NULL || ht->prev_chunks != NULL)){
+    ix = mod_rcp(lk->std_key, ht->prev_count, ht->prev_mul, ht->prev_shift);
+    if (ix >= ht->prev_ix){
+      lookup_slot(ht, lk, ix, 1);
+      return 0;
+    }
+  }
+  return lookup_done(lk, NULL);
+}
+
+/**
+   Completes a lookup with a pointer to an element or NULL, and returns 1.
+*/
+static int lookup_done(ht_divchn_lookup_t *lk, void *elt){
+  lk->elt = elt;
+  lk->state = C_LOOKUP_DONE;
+  return 1;
 }
 
 /**
@@ -433,29 +1231,90 @@ static size_t mul_alpha_sz_max(size_t n, size_t alpha_n, size_t log_alpha_d){
    If the largest representable prime is reached, count_ix may not yet be set
    to C_SIZE_MAX or C_PRIME_PARTS_COUNT, which requires one additional call
    that does not increase the count. Otherwise, each call increases the
-   count.
+   count. In an incremental growth mode, the keys are moved to the next
+   slots in subsequent operations.
 */
 static void ht_grow(ht_divchn_t *ht){
   size_t i, prev_count = ht->count;
-  dll_node_t **prev_key_elts = ht->key_elts;
-  dll_node_t **head = NULL, *node = NULL;
   while (ht->num_elts > ht->max_num_elts && incr_count(ht));
   if (prev_count == ht->count) return; /* load factor not lowered */
-  ht->key_elts = malloc_perror(ht->count, sizeof(dll_node_t *));
-  for (i = 0; i < ht->count; i++){
-    dll_init(ht->ll, &ht->key_elts[i], ht->key_size);
+  ht->num_grows++;
+  ht->prev_count = prev_count;
+  mod_rcp_init(prev_count, &ht->prev_mul, &ht->prev_shift);
+  ht->prev_ix = 0;
+  if (ht->chunks != NULL){
+    ht->prev_chunks = ht->chunks;
+    ht->chunks = malloc_perror(ht->count, sizeof(void *));
+    for (i = 0; i < ht->count; i++){
+      ht->chunks[i] = NULL;
+    }
+  }else{
+    ht->prev_key_elts = ht->key_elts;
+    ht->key_elts = malloc_perror(ht->count, sizeof(dll_node_t *));
+    for (i = 0; i < ht->count; i++){
+      dll_init(ht->ll, &ht->key_elts[i], ht->key_size);
+    }
+    if (ht->elt_alignment > 1) dll_align_elt(ht->ll, ht->elt_alignment);
   }
-  if (ht->elt_alignment > 1) dll_align_elt(ht->ll, ht->elt_alignment);
-  for (i = 0; i < prev_count; i++){
-    head = &prev_key_elts[i];
+  if (ht->incr_num_slots == 0) move_slots(ht, prev_count);
+}
+
+/**
+   Returns the number of previous slots with keys to move in an insert
+   operation, which is at least incr_num_slots and is sufficient to move
+   all keys before the insert operation that exceeds alpha.
+*/
+static size_t incr_num_slots(const ht_divchn_t *ht){
+  size_t rem = ht->prev_count - ht->prev_ix; /* > 0 */
+  size_t d = 0, num_slots;
+  if (ht->max_num_elts > ht->num_elts) d = ht->max_num_elts - ht->num_elts;
+  num_slots = (d == 0) ? rem : (rem - 1) / d + 1;
+  return (num_slots > ht->incr_num_slots) ? num_slots : ht->incr_num_slots;
+}
+
+/**
+   Moves the keys in at most num_slots previous slots of a growth step to
+   the next slots, starting at prev_ix. Frees the previous slots after all
+   keys were moved.
+*/
+static void move_slots(ht_divchn_t *ht, size_t num_slots){
+  size_t i, end = ht->prev_count;
+  char *pair = NULL;
+  chunk_hdr_t *hdr = NULL;
+  dll_node_t **head = NULL, *node = NULL;
+  if (end - ht->prev_ix > num_slots) end = ht->prev_ix + num_slots;
+  for (; ht->chunks != NULL && ht->prev_ix < end; ht->prev_ix++){
+    hdr = ht->prev_chunks[ht->prev_ix];
+    if (hdr == NULL) continue;
+    pair = (char *)hdr + ht->chunk_hdr_size;
+    for (i = 0; i < hdr->num; i++){
+      chunk_add(ht,
+		&ht->chunks[hash(ht, pair)],
+		pair,
+		pair + ht->pair_elt_offset);
+      pair += ht->pair_size;
+    }
+    ht->num_moves += hdr->num;
+    free(hdr);
+    ht->prev_chunks[ht->prev_ix] = NULL;
+  }
+  for (; ht->prev_ix < end; ht->prev_ix++){
+    head = &ht->prev_key_elts[ht->prev_ix];
     while (*head != NULL){
       node = *head;
       dll_remove(head, node);
       dll_prepend(&ht->key_elts[hash(ht, dll_key_ptr(ht->ll, node))], node);
+      ht->num_moves++;
     }
   }
-  free(prev_key_elts);
-  prev_key_elts = NULL;
+  if (ht->prev_ix == ht->prev_count){
+    free(ht->prev_key_elts);
+    free(ht->prev_chunks);
+    ht->prev_count = 0;
+    ht->prev_ix = 0;
+    ht->prev_key_elts = NULL;
+    ht->prev_chunks = NULL;
+  }
 }
 
 /**
@@ -476,6 +1335,7 @@ static int incr_count(ht_divchn_t *ht){
     return 0;
   }else{
     ht->count = build_prime(ht->count_ix, C_PARTS_PER_PRIME[ht->group_ix]);
+    mod_rcp_init(ht->count, &ht->count_mul, &ht->count_shift);
     /* 0 <= max_num_elts <= C_SIZE_MAX */
     ht->max_num_elts = mul_alpha_sz_max(ht->count,
 					ht->alpha_n,
@@ -484,6 +1344,122 @@ static int incr_count(ht_divchn_t *ht){
   return 1;
 }
 
+/**
+   Adds the chain lengths of the slots in [start, count) of an array of
+   slots to a histogram, if hist is not NULL, and returns the maximal chain
+   length.
+*/
+static size_t add_chain_lens(dll_node_t * const *key_elts,
+			     size_t start,
+			     size_t count,
+			     size_t *hist,
+			     size_t hist_count){
+  size_t i, len;
+  size_t max_len = 0;
+  const dll_node_t *node = NULL;
+  for (i = start; i < count; i++){
+    len = 0;
+    node = key_elts[i];
+    if (node != NULL){
+      do{
+	len++;
+	node = node->next;
+      }while (node != key_elts[i]);
+    }
+    if (len > max_len) max_len = len;
+    if (hist != NULL) hist[(len < hist_count) ? len : hist_count - 1]++;
+  }
+  return max_len;
+}
+
+/**
+   Adds the numbers of pairs in the chunks of the slots in [start, count)
+   of an array of slots to a histogram, if hist is not NULL, and returns
+   the maximal number of pairs in a chunk.
+*/
+static size_t add_chunk_lens(void * const *chunks,
+			     size_t start,
+			     size_t count,
+			     size_t *hist,
+			     size_t hist_count){
+  size_t i, len;
+  size_t max_len = 0;
+  for (i = start; i < count; i++){
+    len = (chunks[i] == NULL) ? 0 : ((const chunk_hdr_t *)chunks[i])->num;
+    if (len > max_len) max_len = len;
+    if (hist != NULL) hist[(len < hist_count) ? len : hist_count - 1]++;
+  }
+  return max_len;
+}
+
+/**
+   Calls apply on the keys and elements in the lists of the slots in
+   [start, count) of an array of slots.
+*/
+static void apply_chains(const ht_divchn_t *ht,
+			 dll_node_t * const *key_elts,
+			 size_t start,
+			 size_t count,
+			 void (*apply)(const void *, const void *, void *),
+			 void *arg){
+  size_t i;
+  const dll_node_t *node = NULL;
+  for (i = start; i < count; i++){
+    node = key_elts[i];
+    if (node != NULL){
+      do{
+	apply(dll_key_ptr(ht->ll, node), dll_elt_ptr(ht->ll, node), arg);
+	node = node->next;
+      }while (node != key_elts[i]);
+    }
+  }
+}
+
+/**
+   Calls apply on the keys and elements in the chunks of the slots in
+   [start, count) of an array of slots.
+*/
+static void apply_chunks(const ht_divchn_t *ht,
+			 void * const *chunks,
+			 size_t start,
+			 size_t count,
+			 void (*apply)(const void *, const void *, void *),
+			 void *arg){
+  size_t i, j;
+  const char *pair = NULL;
+  const chunk_hdr_t *hdr = NULL;
+  for (i = start; i < count; i++){
+    hdr = chunks[i];
+    if (hdr == NULL) continue;
+    pair = (const char *)hdr + ht->chunk_hdr_size;
+    for (j = 0; j < hdr->num; j++){
+      apply(pair, pair + ht->pair_elt_offset, arg);
+      pair += ht->pair_size;
+    }
+  }
+}
+
+/**
+   Rounds n up to a multiple of m > 0.
+*/
+static size_t round_up(size_t n, size_t m){
+  size_t rem = n % m;
+  return add_sz_perror(n, (rem > 0) * (m - rem));
+}
+
+/**
+   Computes the least common multiple of a > 0 and b > 0.
+*/
+static size_t lcm(size_t a, size_t b){
+  size_t x = a, y = b, r;
+  while (y > 0){
+    r = x % y;
+    x = y;
+    y = r;
+  }
+  return mul_sz_perror(a / x, b);
+}
+
 /**
    Tests if the next prime number results in an overflow of size_t
    on a given system. Returns 0 if no overflow, otherwise returns 1.
@@ -513,3 +1489,11 @@ static size_t build_prime(size_t start, size_t count){
   }
   return p;
 }
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
+}
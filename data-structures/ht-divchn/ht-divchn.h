@@ -41,6 +41,7 @@
 #define HT_DIVCHN_H
 
 #include <stddef.h>
+#include <time.h>
 #include "dll.h"
 
 typedef struct{
@@ -50,17 +51,55 @@ typedef struct{
   size_t group_ix;
   size_t count_ix; /* max size_t value if last representable prime reached */
   size_t count;
+  size_t count_mul; /* reciprocal multiplier of count for mod_rcp */
+  size_t count_shift;
   size_t max_num_elts; /*  >= 0, <= C_SIZE_MAX, represents alpha */
   size_t num_elts;
   size_t alpha_n;
   size_t log_alpha_d; 
   dll_t *ll;
   dll_node_t **key_elts; /* array of pointers to nodes */
+  size_t incr_num_slots; /* 0 if growth steps are not incremental */
+  size_t prev_count; /* 0 if all keys were moved */
+  size_t prev_mul; /* reciprocal multiplier of prev_count for mod_rcp */
+  size_t prev_shift;
+  size_t prev_ix; /* next slot in prev_key_elts with keys to move */
+  dll_node_t **prev_key_elts; /* NULL if all keys were moved */
+  dll_pool_t *pool; /* NULL if nodes are not allocated from a pool */
+  void **chunks; /* array of pointers to chunks, NULL if chains are lists */
+  void **prev_chunks; /* NULL if all keys were moved or chains are lists */
+  size_t chunk_hdr_size; /* bytes before the first pair in a chunk */
+  size_t chunk_min_cap; /* number of pairs in a chunk for a first key */
+  size_t pair_size;
+  size_t pair_elt_offset; /* bytes from the beginning of a pair to elt */
+  size_t num_grows;
+  size_t num_moves; /* keys moved to next slots by growth steps */
+  clock_t resize_clocks; /* processor time of growth steps */
   int (*cmp_key)(const void *, const void *);
   size_t (*rdc_key)(const void *, size_t);
   void (*free_elt)(void *);
 } ht_divchn_t;
 
+typedef struct{
+  const void *key;
+  void *elt;          /* result of a completed lookup */
+  size_t std_key;
+  size_t ix;          /* slot of the chain */
+  const void *node;   /* node or chunk of the next access */
+  int is_prev;        /* 1 if the previous slots are searched */
+  int state;          /* next access: slot, chain, or completed */
+} ht_divchn_lookup_t;
+
+typedef struct{
+  size_t count;          /* count of next slots */
+  size_t num_elts;
+  size_t max_num_elts;
+  size_t max_chain_len;  /* across next and previous slots */
+  size_t num_grows;
+  size_t num_moves;
+  clock_t resize_clocks; /* divided by CLOCKS_PER_SEC to obtain seconds */
+} ht_divchn_stats_t;
+
 /**
    Initializes a hash table. 
    ht          : a pointer to a preallocated block of size 
@@ -91,7 +130,9 @@ typedef struct{
                  hashing, which may introduce regularities
                  - otherwise rdc_key is applied to a key prior to hashing;
                  the first argument points to a key and the second argument
-                 provides the size of the key
+                 provides the size of the key; mem_hash in utilities-mod
+                 hashes a key in sizeof(size_t)-byte increments without
+                 modular reduction
    free_elt    : - if an element is within a contiguous memory block and
                  a copy of the element was inserted, then NULL as free_elt
                  is sufficient to delete the element,
@@ -129,6 +170,63 @@ void ht_divchn_init(ht_divchn_t *ht,
 */
 void ht_divchn_align(ht_divchn_t *ht, size_t alignment);
 
+/**
+   Sets an incremental growth mode of a hash table. In the mode, a growth
+   step allocates the slots of the next count, and the keys in the previous
+   slots are moved to the next slots in parts of at most num_slots previous
+   slots at the beginning of each remove and delete operation, and in parts
+   of at least num_slots previous slots at the beginning of each insert
+   operation, s.t. all keys are moved before alpha is exceeded again,
+   instead of moving all keys within a single insert operation. Until all
+   keys are moved, a search or modifying operation accesses the previous
+   and the next slots. The allocation and initialization of the next slots
+   remain in the insert operation that exceeded alpha. The operation is
+   optionally called after ht_divchn_init and ht_divchn_align are completed
+   and before any other operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+   num_slots   : > 0 number of previous slots with their keys moved in one
+                 operation; a larger number completes the move of keys in
+                 fewer operations at the expense of a larger operation
+                 cost during the move
+*/
+void ht_divchn_incr_grow(ht_divchn_t *ht, size_t num_slots);
+
+/**
+   Sets a pool allocation mode of a hash table. In the mode, the nodes of
+   the chains are allocated from a pool in blocks of nodes, the nodes of
+   removed and deleted keys are reused by subsequent insert operations, and
+   all nodes are freed at once when the hash table is freed, instead of a
+   malloc and free call per key. The operation is optionally called after
+   ht_divchn_init and ht_divchn_align are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+   min_num     : minimum number of keys that are known or expected to become
+                 present simultaneously in a hash table, resulting in fewer
+                 allocations of blocks of nodes at the beginning; 0 if a
+                 positive value is not specified
+*/
+void ht_divchn_pool(ht_divchn_t *ht, size_t min_num);
+
+/**
+   Sets a chunked chain mode of a hash table. In the mode, the chain of a
+   slot is a chunk, which is a contiguous block of key-element pairs, instead
+   of a list with a node per key, so that a search accesses a slot and a
+   single block instead of following a pointer per key. A chunk is
+   allocated for the first key of a slot with the number of pairs that fit
+   into a cache line of 64 bytes, or one pair if a pair does not fit,
+   and is doubled if it is full. A remove or delete operation moves the
+   last pair of a chunk to the position of the removed pair, and a chunk is
+   freed with its last key. A key in a chunk can be accessed with a pointer
+   to its type if the size of the type is key_size. Because pairs are
+   moved, a pointer returned by ht_divchn_search is valid until a
+   modifying operation is called. The mode is not combined with the pool
+   allocation mode. The operation is optionally called after
+   ht_divchn_init and ht_divchn_align are completed and before any other
+   operation is called.
+   ht          : pointer to an initialized ht_divchn_t struct
+*/
+void ht_divchn_chunk(ht_divchn_t *ht);
+
 /**
    Inserts a key and an associated element into a hash table. If the key is
    in the hash table, associates the key with the new element. The key and 
@@ -145,6 +243,66 @@ void ht_divchn_insert(ht_divchn_t *ht, const void *key, const void *elt);
 */
 void *ht_divchn_search(const ht_divchn_t *ht, const void *key);
 
+/**
+   Searches a batch of keys in a hash table. Sets batch_elts[i] to a
+   pointer to the element associated with the ith key, if the key is
+   present, and to NULL otherwise. The batch_keys parameter is not NULL and
+   points to an array of batch_count blocks of size key_size, and the
+   batch_elts parameter is not NULL and points to an array of batch_count
+   pointers. The keys are processed in groups: the keys of a group are
+   hashed and their slots are prefetched, then the chain heads or chunks
+   in the slots are prefetched, and then the keys are searched, so that
+   the cache misses of the keys in a group overlap. The pointers can be
+   dereferenced according to ht_divchn_search.
+*/
+void ht_divchn_search_batch(const ht_divchn_t *ht,
+			    const void *batch_keys,
+			    void **batch_elts,
+			    size_t batch_count);
+
+/**
+   Starts a lookup of a key as a resumable state machine, and prefetches
+   the slot of its chain. The key parameter is not NULL and points to a
+   block of size key_size that is not modified until the lookup is
+   completed. A lookup is advanced with ht_divchn_lookup_step, so that the
+   lookups of independent requests are interleaved by a caller at their
+   memory accesses. No modifying operation is called on ht until the
+   lookups of ht are completed.
+   ht          : pointer to an initialized ht_divchn_t struct
+   lk          : pointer to a preallocated block of size
+                 sizeof(ht_divchn_lookup_t)
+   key         : pointer to a key
+*/
+void ht_divchn_lookup_init(const ht_divchn_t *ht,
+			   ht_divchn_lookup_t *lk,
+			   const void *key);
+
+/**
+   Advances a lookup by one memory access, i.e. a slot, a node, or a chunk
+   prefetched by the previous call, and prefetches the memory of the next
+   access. Returns 1 if the lookup is completed, in which case lk->elt is
+   set according to ht_divchn_search, and 0 otherwise. A completed lookup
+   is not advanced further by subsequent calls.
+*/
+int ht_divchn_lookup_step(const ht_divchn_t *ht, ht_divchn_lookup_t *lk);
+
+/**
+   Searches keys with up to num_lks lookups in flight, which are advanced
+   in a round-robin order by ht_divchn_lookup_step, and a completed lookup
+   is replaced by the lookup of the next key, so that a long chain delays
+   only its own key. Sets elts[i] to a pointer to the element associated
+   with the ith key, if the key is present, and to NULL otherwise. The keys
+   parameter points to an array of count blocks of size key_size, elts
+   points to an array of count pointers, and lks points to an array of
+   num_lks > 0 preallocated ht_divchn_lookup_t structs.
+*/
+void ht_divchn_search_interleave(const ht_divchn_t *ht,
+				 const void *keys,
+				 void **elts,
+				 size_t count,
+				 ht_divchn_lookup_t *lks,
+				 size_t num_lks);
+
 /**
    Removes a key and its associated element from a hash table by copying 
    the element or its pointer into a block of size elt_size pointed to
@@ -161,6 +319,56 @@ void ht_divchn_remove(ht_divchn_t *ht, const void *key, void *elt);
 */
 void ht_divchn_delete(ht_divchn_t *ht, const void *key);
 
+/**
+   Deletes all keys and their associated elements from a hash table
+   according to free_elt, keeping the count of slots of the hash table,
+   so that the hash table can be reused without growth steps. Completes
+   an incremental growth step, if any, by deleting the keys that were not
+   moved. Runs in O(count) time. In the pool allocation mode, the nodes are
+   kept in the pool for reuse.
+*/
+void ht_divchn_reset(ht_divchn_t *ht);
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_divchn_stats_t) pointed to by s, and optionally computes a
+   histogram of chain lengths. The count of growth steps, the count of
+   moved keys, and the processor time of growth steps, measured with clock,
+   are accumulated since ht_divchn_init and are not cleared by
+   ht_divchn_reset. In an incremental growth mode, the processor time
+   includes the allocation of next slots and the completion of a move of
+   keys in an insert operation that exceeded alpha, but not the moves of
+   keys in parts, which are counted in num_moves. Runs in O(count +
+   num_elts) time.
+   ht          : pointer to an initialized ht_divchn_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_divchn_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of slots with a chain
+                 of i keys for i < hist_count - 1, and hist[hist_count - 1]
+                 to the number of slots with a chain of >= hist_count - 1
+                 keys; the previous slots of an incremental growth step
+                 with keys that were not moved are included
+   hist_count  : > 0 if hist is not NULL
+*/
+void ht_divchn_stats(const ht_divchn_t *ht,
+		     ht_divchn_stats_t *s,
+		     size_t *hist,
+		     size_t hist_count);
+
+/**
+   Calls apply on each key and its associated element in a hash table,
+   including the keys in the previous slots of an incremental growth step
+   that were not moved. The first argument of apply points to a key, the
+   second argument points to its associated element, and the third argument
+   is arg. apply does not call a modifying operation on the hash table.
+   Runs in O(count + num_elts) time.
+*/
+void ht_divchn_apply(const ht_divchn_t *ht,
+		     void (*apply)(const void *, const void *, void *),
+		     void *arg);
+
 /**
    Frees a hash table and leaves a block of size sizeof(ht_divchn_t)
    pointed to by the ht parameter.
@@ -192,10 +400,12 @@ void ht_divchn_insert_helper(void *ht, const void *key, const void *elt);
 
 void *ht_divchn_search_helper(const void *ht, const void *key);
 
-void ht_divchnn_remove_helper(void *ht, const void *key, void *elt);
+void ht_divchn_remove_helper(void *ht, const void *key, void *elt);
 
 void ht_divchn_delete_helper(void *ht, const void *key);
 
+void ht_divchn_reset_helper(void *ht);
+
 void ht_divchn_free_helper(void *ht);
 
 #endif
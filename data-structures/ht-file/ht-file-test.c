@@ -0,0 +1,440 @@
+/**
+   ht-file-test.c
+
+   Tests of writing hash tables of type ht_muloa_t and ht_divchn_t to
+   binary files, and of mapping binary files into memory as read-only hash
+   tables.
+
+   The following command line arguments can be used to customize tests:
+   ht-file-test
+      [0, # bits in size_t - 1) : i s.t. # inserts = 2**i
+      [0, 1] : on/off ht_muloa test
+      [0, 1] : on/off ht_divchn test
+      [0, 1] : on/off corner cases test
+
+   usage examples:
+   ./ht-file-test
+   ./ht-file-test 20
+   ./ht-file-test 20 1 0 0
+
+   ht-file-test can be run with any subset of command line arguments in the
+   above-defined order. If the (i + 1)th argument is specified then the ith
+   argument must be specified for i >= 0. Default values are used for the
+   unspecified arguments according to the C_ARGS_DEF array.
+
+   The tests write and remove files at C_PATH and C_PATH_B in the working
+   directory.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that CHAR_BIT * sizeof(size_t) is
+   greater or equal to 16 and is even, and the POSIX mmap API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "ht-file.h"
+#include "ht-muloa.h"
+#include "ht-divchn.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "ht-file-test\n"
+  "[0, # bits in size_t - 1) : i s.t. # inserts = 2**i\n"
+  "[0, 1] : on/off ht_muloa test\n"
+  "[0, 1] : on/off ht_divchn test\n"
+  "[0, 1] : on/off corner cases test\n";
+const int C_ARGC_MAX = 5;
+const size_t C_ARGS_DEF[4] = {14, 1, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const char *C_PATH = "ht-file-test.bin";
+const char *C_PATH_B = "ht-file-test-b.bin"; /* mapped with C_PATH */
+
+/* hash table parameters */
+const size_t C_ALPHA_N_MULOA = 13107; /* alpha is 0.4 */
+const size_t C_LOG_ALPHA_D_MULOA = 15;
+const size_t C_ALPHA_N_DIVCHN = 1;  /* alpha is 1.0 */
+const size_t C_LOG_ALPHA_D_DIVCHN = 0;
+const size_t C_INCR_NUM_SLOTS = 1;
+const size_t C_ELT_ALIGNMENT = 2 * sizeof(double);
+
+/* modes */
+const size_t C_MULOA_NUM_MODES = 4;
+const char *C_MULOA_MODES[4] = {"double hashing",
+				"double hashing, incremental",
+				"Robin Hood",
+				"Robin Hood, incremental"};
+const size_t C_DIVCHN_NUM_MODES = 4;
+const char *C_DIVCHN_MODES[4] = {"list",
+				 "list, pool",
+				 "chunk",
+				 "chunk, incremental"};
+
+/* corner cases test */
+const unsigned char C_CORNER_KEYS[3][3] = {{0, 1, 2}, {2, 1, 0}, {7, 7, 7}};
+
+void shuffle_keys(size_t *keys, size_t n);
+int same_muloa(const ht_muloa_t *ht,
+	       const ht_muloa_file_t *m,
+	       const size_t *keys,
+	       size_t n);
+int same_divchn(const ht_divchn_t *ht,
+		const ht_divchn_file_t *m,
+		const size_t *keys,
+		size_t n);
+void print_test_result(int res);
+
+/**
+   Runs a test of writing and mapping ht_muloa_t hash tables with size_t
+   keys and size_t elements in double hashing and Robin Hood modes, with a
+   completed or an incomplete incremental growth step. Placeholders are
+   created by deleting a quarter of the keys. The keys in [0, 2**(i + 1))
+   with even values are inserted, and all keys in the range are searched.
+*/
+void run_muloa_test(size_t log_ins){
+  size_t i, k, num_ins, n = (size_t)1 << (log_ins + 1);
+  size_t elt;
+  size_t *keys = NULL;
+  int res = 1;
+  ht_muloa_t ht;
+  ht_muloa_file_t m;
+  clock_t t_build, t_write, t_map, t_search, t_search_map;
+  keys = malloc_perror(n, sizeof(size_t));
+  for (i = 0; i < n; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa write and map test with %lu inserts\n",
+	 TOLU(n / 2));
+  for (k = 0; k < C_MULOA_NUM_MODES; k++){
+    shuffle_keys(keys, n);
+    t_build = clock();
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  C_ALPHA_N_MULOA,
+		  C_LOG_ALPHA_D_MULOA,
+		  NULL,
+		  NULL,
+		  NULL);
+    if (k >= 2) ht_muloa_robin_hood(&ht);
+    if (k % 2) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    num_ins = 0;
+    for (i = 0; i < n; i++){
+      if (keys[i] % 2) continue;
+      elt = 3 * keys[i];
+      ht_muloa_insert(&ht, &keys[i], &elt);
+      num_ins++;
+      /* incomplete growth step after half of the keys in incremental mode */
+      if (k % 2 && num_ins >= n / 4 && ht.prev_key_elts != NULL) break;
+    }
+    for (i = 0; i < n; i += 4){
+      ht_muloa_delete(&ht, &keys[i]);
+    }
+    t_build = clock() - t_build;
+    t_write = clock();
+    ht_muloa_file_write(&ht, C_PATH);
+    t_write = clock() - t_write;
+    t_map = clock();
+    ht_muloa_file_map(&m, C_PATH, sizeof(size_t), sizeof(size_t), NULL, NULL);
+    t_map = clock() - t_map;
+    t_search = clock();
+    for (i = 0; i < n; i++){
+      ht_muloa_search(&ht, &keys[i]);
+    }
+    t_search = clock() - t_search;
+    t_search_map = clock();
+    for (i = 0; i < n; i++){
+      ht_muloa_file_search(&m, &keys[i]);
+    }
+    t_search_map = clock() - t_search_map;
+    res *= (m.num_elts == ht.num_elts && m.num_blocks == ht.num_elts);
+    res *= (k % 2 == 0 || m.prev_slots != NULL);
+    res *= same_muloa(&ht, &m, keys, n);
+    ht_muloa_file_unmap(&m);
+    res *= (m.base == NULL && m.slots == NULL && m.blocks == NULL);
+    printf("\t%s, %lu keys, in progress growth step: %s\n",
+	   C_MULOA_MODES[k],
+	   TOLU(ht.num_elts),
+	   (ht.prev_key_elts != NULL) ? "yes" : "no");
+    printf("\t\tbuild time:              %.4f seconds\n"
+	   "\t\twrite time:              %.4f seconds\n"
+	   "\t\tmap time:                %.4f seconds\n"
+	   "\t\tsearch time:             %.4f seconds\n"
+	   "\t\tmapped search time:      %.4f seconds\n",
+	   (double)t_build / CLOCKS_PER_SEC,
+	   (double)t_write / CLOCKS_PER_SEC,
+	   (double)t_map / CLOCKS_PER_SEC,
+	   (double)t_search / CLOCKS_PER_SEC,
+	   (double)t_search_map / CLOCKS_PER_SEC);
+    ht_muloa_free(&ht);
+  }
+  printf("\tcorrectness:                   ");
+  print_test_result(res);
+  remove(C_PATH);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of writing and mapping ht_divchn_t hash tables with size_t
+   keys and size_t elements in list, pool, and chunked chain modes, with a
+   completed or an incomplete incremental growth step. The keys in
+   [0, 2**(i + 1)) with even values are inserted, a quarter of the keys is
+   deleted if the growth step is completed, and all keys in the range are
+   searched.
+*/
+void run_divchn_test(size_t log_ins){
+  size_t i, k, num_ins, n = (size_t)1 << (log_ins + 1);
+  size_t elt;
+  size_t *keys = NULL;
+  int res = 1;
+  ht_divchn_t ht;
+  ht_divchn_file_t m;
+  clock_t t_build, t_write, t_map, t_search, t_search_map;
+  keys = malloc_perror(n, sizeof(size_t));
+  for (i = 0; i < n; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_divchn write and map test with %lu inserts\n",
+	 TOLU(n / 2));
+  for (k = 0; k < C_DIVCHN_NUM_MODES; k++){
+    shuffle_keys(keys, n);
+    t_build = clock();
+    ht_divchn_init(&ht,
+		   sizeof(size_t),
+		   sizeof(size_t),
+		   0,
+		   C_ALPHA_N_DIVCHN,
+		   C_LOG_ALPHA_D_DIVCHN,
+		   NULL,
+		   NULL,
+		   NULL);
+    if (k == 1) ht_divchn_pool(&ht, n / 2);
+    if (k >= 2) ht_divchn_chunk(&ht);
+    if (k == 3) ht_divchn_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    num_ins = 0;
+    for (i = 0; i < n; i++){
+      if (keys[i] % 2) continue;
+      elt = 3 * keys[i];
+      ht_divchn_insert(&ht, &keys[i], &elt);
+      num_ins++;
+      if (k == 3 && num_ins >= n / 4 && ht.prev_count > 0) break;
+    }
+    /* deletes move the keys of an incomplete growth step in parts */
+    for (i = 0; k != 3 && i < n; i += 4){
+      ht_divchn_delete(&ht, &keys[i]);
+    }
+    t_build = clock() - t_build;
+    t_write = clock();
+    ht_divchn_file_write(&ht, C_PATH);
+    t_write = clock() - t_write;
+    t_map = clock();
+    ht_divchn_file_map(&m, C_PATH, sizeof(size_t), sizeof(size_t), NULL, NULL);
+    t_map = clock() - t_map;
+    t_search = clock();
+    for (i = 0; i < n; i++){
+      ht_divchn_search(&ht, &keys[i]);
+    }
+    t_search = clock() - t_search;
+    t_search_map = clock();
+    for (i = 0; i < n; i++){
+      ht_divchn_file_search(&m, &keys[i]);
+    }
+    t_search_map = clock() - t_search_map;
+    res *= (m.num_elts == ht.num_elts && m.count == ht.count);
+    res *= same_divchn(&ht, &m, keys, n);
+    ht_divchn_file_unmap(&m);
+    res *= (m.base == NULL && m.offsets == NULL && m.pairs == NULL);
+    printf("\t%s, %lu keys, in progress growth step: %s\n",
+	   C_DIVCHN_MODES[k],
+	   TOLU(ht.num_elts),
+	   (ht.prev_count > 0) ? "yes" : "no");
+    printf("\t\tbuild time:              %.4f seconds\n"
+	   "\t\twrite time:              %.4f seconds\n"
+	   "\t\tmap time:                %.4f seconds\n"
+	   "\t\tsearch time:             %.4f seconds\n"
+	   "\t\tmapped search time:      %.4f seconds\n",
+	   (double)t_build / CLOCKS_PER_SEC,
+	   (double)t_write / CLOCKS_PER_SEC,
+	   (double)t_map / CLOCKS_PER_SEC,
+	   (double)t_search / CLOCKS_PER_SEC,
+	   (double)t_search_map / CLOCKS_PER_SEC);
+    ht_divchn_free(&ht);
+  }
+  printf("\tcorrectness:                   ");
+  print_test_result(res);
+  remove(C_PATH);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of writing and mapping empty hash tables, and hash tables
+   with 3-byte keys and aligned double elements.
+*/
+void run_corner_cases_test(){
+  size_t i;
+  double elt;
+  const void *p = NULL;
+  int res = 1;
+  ht_muloa_t ht_muloa;
+  ht_divchn_t ht_divchn;
+  ht_muloa_file_t m_muloa;
+  ht_divchn_file_t m_divchn;
+  printf("Run a corner cases test\n");
+  ht_muloa_init(&ht_muloa, 3, sizeof(double), 0, C_ALPHA_N_MULOA,
+		C_LOG_ALPHA_D_MULOA, NULL, NULL, NULL);
+  ht_muloa_align(&ht_muloa, C_ELT_ALIGNMENT);
+  ht_divchn_init(&ht_divchn, 3, sizeof(double), 0, C_ALPHA_N_DIVCHN,
+		 C_LOG_ALPHA_D_DIVCHN, NULL, NULL, NULL);
+  ht_divchn_align(&ht_divchn, C_ELT_ALIGNMENT);
+  ht_divchn_chunk(&ht_divchn);
+  ht_muloa_file_write(&ht_muloa, C_PATH);
+  ht_muloa_file_map(&m_muloa, C_PATH, 3, sizeof(double), NULL, NULL);
+  ht_divchn_file_write(&ht_divchn, C_PATH_B);
+  ht_divchn_file_map(&m_divchn, C_PATH_B, 3, sizeof(double), NULL, NULL);
+  for (i = 0; i < 3; i++){
+    res *= (ht_muloa_file_search(&m_muloa, C_CORNER_KEYS[i]) == NULL);
+    res *= (ht_divchn_file_search(&m_divchn, C_CORNER_KEYS[i]) == NULL);
+  }
+  res *= (m_muloa.num_elts == 0 && m_divchn.num_elts == 0);
+  ht_muloa_file_unmap(&m_muloa);
+  ht_divchn_file_unmap(&m_divchn);
+  for (i = 0; i < 2; i++){
+    elt = 0.5 + i;
+    ht_muloa_insert(&ht_muloa, C_CORNER_KEYS[i], &elt);
+    ht_divchn_insert(&ht_divchn, C_CORNER_KEYS[i], &elt);
+  }
+  ht_muloa_file_write(&ht_muloa, C_PATH);
+  ht_muloa_file_map(&m_muloa, C_PATH, 3, sizeof(double), NULL, NULL);
+  ht_divchn_file_write(&ht_divchn, C_PATH_B);
+  ht_divchn_file_map(&m_divchn, C_PATH_B, 3, sizeof(double), NULL, NULL);
+  for (i = 0; i < 2; i++){
+    p = ht_muloa_file_search(&m_muloa, C_CORNER_KEYS[i]);
+    res *= (p != NULL &&
+	    *(const double *)p == 0.5 + i &&
+	    (size_t)((const char *)p - (const char *)m_muloa.base) %
+	    C_ELT_ALIGNMENT == 0);
+    p = ht_divchn_file_search(&m_divchn, C_CORNER_KEYS[i]);
+    res *= (p != NULL &&
+	    *(const double *)p == 0.5 + i &&
+	    (size_t)((const char *)p - (const char *)m_divchn.base) %
+	    C_ELT_ALIGNMENT == 0);
+  }
+  res *= (ht_muloa_file_search(&m_muloa, C_CORNER_KEYS[2]) == NULL);
+  res *= (ht_divchn_file_search(&m_divchn, C_CORNER_KEYS[2]) == NULL);
+  ht_muloa_file_unmap(&m_muloa);
+  ht_divchn_file_unmap(&m_divchn);
+  ht_muloa_free(&ht_muloa);
+  ht_divchn_free(&ht_divchn);
+  printf("\tcorrectness:                   ");
+  print_test_result(res);
+  remove(C_PATH);
+  remove(C_PATH_B);
+}
+
+/**
+   Shuffles an array of n keys.
+*/
+void shuffle_keys(size_t *keys, size_t n){
+  size_t i, j, t;
+  for (i = n - 1; i > 0; i--){
+    j = RANDOM() % (i + 1);
+    t = keys[i];
+    keys[i] = keys[j];
+    keys[j] = t;
+  }
+}
+
+/**
+   Returns 1 if the search results of n keys in an in-memory and a mapped
+   ht_muloa_t hash table are equal, and 0 otherwise.
+*/
+int same_muloa(const ht_muloa_t *ht,
+	       const ht_muloa_file_t *m,
+	       const size_t *keys,
+	       size_t n){
+  size_t i;
+  const void *p = NULL, *q = NULL;
+  for (i = 0; i < n; i++){
+    p = ht_muloa_search(ht, &keys[i]);
+    q = ht_muloa_file_search(m, &keys[i]);
+    if ((p == NULL) != (q == NULL)) return 0;
+    if (p != NULL && memcmp(p, q, sizeof(size_t)) != 0) return 0;
+  }
+  return 1;
+}
+
+/**
+   Returns 1 if the search results of n keys in an in-memory and a mapped
+   ht_divchn_t hash table are equal, and 0 otherwise.
+*/
+int same_divchn(const ht_divchn_t *ht,
+		const ht_divchn_file_t *m,
+		const size_t *keys,
+		size_t n){
+  size_t i;
+  const void *p = NULL, *q = NULL;
+  for (i = 0; i < n; i++){
+    p = ht_divchn_search(ht, &keys[i]);
+    q = ht_divchn_file_search(m, &keys[i]);
+    if ((p == NULL) != (q == NULL)) return 0;
+    if (p != NULL && memcmp(p, q, sizeof(size_t)) != 0) return 0;
+  }
+  return 1;
+}
+
+/**
+   Prints a test result.
+*/
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > 1 ||
+      args[2] > 1 ||
+      args[3] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[1]) run_muloa_test(args[0]);
+  if (args[2]) run_divchn_test(args[0]);
+  if (args[3]) run_corner_cases_test();
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,768 @@
+/**
+   ht-file.c
+
+   Functions for writing a hash table of type ht_muloa_t or ht_divchn_t to
+   a binary file, and for mapping a binary file into memory as a read-only
+   hash table without copying and without rehashing the keys.
+
+   A ht_muloa_t hash table is written in the order of its header, slot
+   arrays, and key element blocks with the stdio API, where the ith
+   non-empty slot without a placeholder is written as i + 2 and the key
+   element block of the slot is written as the ith block. A ht_divchn_t
+   hash table is written by counting the keys of each next slot with
+   ht_divchn_apply, and by placing each pair at the position of its slot in
+   a writable mapping of the file with a second ht_divchn_apply call.
+
+   A file is mapped with a single mmap call after its header is validated
+   against the size of the file and the key and element sizes provided by
+   the user. A search hashes a key with the parameters in the header and
+   accesses only the slots and keys of its probe sequence or chain.
+
+   The implementation provides an error message and an exit is executed if
+   a file operation fails or a file is not in the format. The
+   implementation does not use stdint.h and is portable under C89/C90 and
+   C99 with the requirement that the POSIX mmap API is available.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "ht-file.h"
+#include "ht-muloa.h"
+#include "ht-divchn.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+#define MAGIC_SIZE 8
+
+static const char C_MULOA_MAGIC[MAGIC_SIZE] = {'H', 'T', 'M', 'U', 'L', 'O',
+					       'A', '\0'};
+static const char C_DIVCHN_MAGIC[MAGIC_SIZE] = {'H', 'T', 'D', 'I', 'V', 'C',
+						'H', '\0'};
+static const size_t C_BYTE_ORDER = 0x0304;
+static const size_t C_VERSION = 1;
+static const size_t C_BYTE_BIT = CHAR_BIT;
+static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+static const size_t C_SLOT_EMPTY = 0;
+static const size_t C_SLOT_PH = 1;
+static const size_t C_SLOT_FIRST = 2; /* slot value of the first block */
+
+typedef union{
+  long l;
+  double d;
+  long double ld;
+  void *p;
+  void (*f)(void);
+} basic_align_t;
+
+static const size_t C_MAX_ALIGN = sizeof(basic_align_t);
+
+/* positions in the size_t array of a header, common to both tables */
+enum{H_SIZE_SZ,
+     H_BYTE_ORDER,
+     H_VERSION,
+     H_FILE_SIZE,
+     H_ALIGNMENT,
+     H_KEY_SIZE,
+     H_ELT_SIZE,
+     H_NUM_ELTS,
+     H_BASE_COUNT};
+
+/* positions in the size_t array of a ht_muloa_t header */
+enum{M_KEY_OFFSET = H_BASE_COUNT,
+     M_ELT_OFFSET,
+     M_BLOCK_SIZE,
+     M_LOG_COUNT,
+     M_MAX_NUM_PROBES,
+     M_PREV_COUNT, /* 0 if all keys were moved */
+     M_PREV_LOG_COUNT,
+     M_PREV_MAX_NUM_PROBES,
+     M_FPRIME,
+     M_SPRIME,
+     M_IS_RH,
+     M_NUM_BLOCKS,
+     M_SLOTS_POS,
+     M_PREV_SLOTS_POS,
+     M_BLOCKS_POS,
+     M_H_COUNT};
+
+/* positions in the size_t array of a ht_divchn_t header */
+enum{D_PAIR_SIZE = H_BASE_COUNT,
+     D_ELT_OFFSET,
+     D_SLOT_COUNT,
+     D_OFFSETS_POS,
+     D_PAIRS_POS,
+     D_H_COUNT};
+
+/* state of the ht_divchn_apply calls of ht_divchn_file_write */
+typedef struct{
+  size_t key_size;
+  size_t elt_size;
+  size_t pair_size;
+  size_t elt_offset;
+  size_t count;
+  size_t count_mul;
+  size_t count_shift;
+  size_t *pos; /* next pair position of each slot */
+  char *pairs; /* NULL if pairs are counted */
+  size_t (*rdc_key)(const void *, size_t);
+} divchn_write_t;
+
+static void muloa_write_slots(const ht_muloa_t *ht,
+			      ke_t * const *key_elts,
+			      size_t count,
+			      size_t *num_blocks,
+			      FILE *f);
+static void muloa_write_blocks(const ht_muloa_t *ht,
+			       ke_t * const *key_elts,
+			       size_t count,
+			       char *block,
+			       size_t block_size,
+			       FILE *f);
+static const void *muloa_search_slots(const ht_muloa_file_t *m,
+				      const size_t *slots,
+				      size_t log_count,
+				      size_t max_num_probes,
+				      const void *key,
+				      size_t fval,
+				      size_t sval);
+static void divchn_count_pair(const void *key, const void *elt, void *arg);
+static void divchn_place_pair(const void *key, const void *elt, void *arg);
+static char *file_map(const char *path,
+		      const char *magic,
+		      size_t *h,
+		      size_t h_count,
+		      size_t key_size,
+		      size_t elt_size);
+static void file_unmap(void *base, size_t map_size);
+static void header_base_init(size_t *h, size_t key_size, size_t elt_size);
+static size_t convert_std_key(const void *key,
+			      size_t key_size,
+			      size_t (*rdc_key)(const void *, size_t));
+static size_t adjust_dist(size_t dist);
+static size_t round_up(size_t n, size_t k);
+static size_t lcm(size_t a, size_t b);
+static void fwrite_perror(const void *s, size_t size, FILE *f);
+static void file_error_exit(const char *s, const char *path);
+
+/**
+   Writes a hash table to a binary file at path. The file is created or
+   truncated. The writing of a ht_divchn_t hash table maps the file into
+   memory and places each pair at its final position, so that no copy of
+   the keys and elements is allocated.
+   ht          : pointer to a hash table with elements within contiguous
+                 memory blocks; the elt_alignment value set with
+                 ht_muloa_align or ht_divchn_align is a divisor of
+                 HT_FILE_ALIGNMENT
+   path        : path of a file
+*/
+void ht_muloa_file_write(const ht_muloa_t *ht, const char *path){
+  size_t i, num_blocks = 0;
+  size_t prev_count = 0;
+  size_t h[M_H_COUNT];
+  size_t slots_size, prev_slots_size, block_size;
+  char zeros[HT_FILE_ALIGNMENT] = {0};
+  char *block = NULL;
+  FILE *f = NULL;
+  if (HT_FILE_ALIGNMENT % ht->elt_alignment != 0){
+    file_error_exit("ht file element alignment not supported", path);
+  }
+  if (ht->prev_key_elts != NULL) prev_count = ht->prev_count;
+  for (i = 0; i < ht->count; i++){
+    num_blocks += (ht->key_elts[i] != NULL && ht->key_elts[i] != ht->ph);
+  }
+  for (i = 0; i < prev_count; i++){
+    num_blocks += (ht->prev_key_elts[i] != NULL &&
+		   ht->prev_key_elts[i] != ht->ph);
+  }
+  block_size = add_sz_perror(ht->key_offset,
+			     add_sz_perror(ht->elt_offset, ht->elt_size));
+  block_size = round_up(block_size, lcm(C_MAX_ALIGN, ht->elt_alignment));
+  slots_size = mul_sz_perror(ht->count, sizeof(size_t));
+  prev_slots_size = mul_sz_perror(prev_count, sizeof(size_t));
+  header_base_init(h, ht->key_size, ht->elt_size);
+  h[H_NUM_ELTS] = ht->num_elts;
+  h[M_KEY_OFFSET] = ht->key_offset;
+  h[M_ELT_OFFSET] = ht->elt_offset;
+  h[M_BLOCK_SIZE] = block_size;
+  h[M_LOG_COUNT] = ht->log_count;
+  h[M_MAX_NUM_PROBES] = ht->max_num_probes;
+  h[M_PREV_COUNT] = prev_count;
+  h[M_PREV_LOG_COUNT] = (prev_count > 0) ? ht->prev_log_count : 0;
+  h[M_PREV_MAX_NUM_PROBES] = (prev_count > 0) ? ht->prev_max_num_probes : 0;
+  h[M_FPRIME] = ht->fprime;
+  h[M_SPRIME] = ht->sprime;
+  h[M_IS_RH] = ht->is_rh;
+  h[M_NUM_BLOCKS] = num_blocks;
+  h[M_SLOTS_POS] = MAGIC_SIZE + sizeof(h);
+  h[M_PREV_SLOTS_POS] = add_sz_perror(h[M_SLOTS_POS], slots_size);
+  h[M_BLOCKS_POS] = round_up(add_sz_perror(h[M_PREV_SLOTS_POS],
+					   prev_slots_size),
+			     HT_FILE_ALIGNMENT);
+  h[H_FILE_SIZE] = add_sz_perror(h[M_BLOCKS_POS],
+				 mul_sz_perror(num_blocks, block_size));
+  f = fopen(path, "wb");
+  if (f == NULL) file_error_exit("ht file open failed", path);
+  fwrite_perror(C_MULOA_MAGIC, MAGIC_SIZE, f);
+  fwrite_perror(h, sizeof(h), f);
+  num_blocks = 0;
+  muloa_write_slots(ht, ht->key_elts, ht->count, &num_blocks, f);
+  muloa_write_slots(ht, ht->prev_key_elts, prev_count, &num_blocks, f);
+  fwrite_perror(zeros,
+		h[M_BLOCKS_POS] - h[M_PREV_SLOTS_POS] - prev_slots_size,
+		f);
+  block = calloc_perror(1, block_size);
+  muloa_write_blocks(ht, ht->key_elts, ht->count, block, block_size, f);
+  muloa_write_blocks(ht, ht->prev_key_elts, prev_count, block, block_size, f);
+  free(block);
+  block = NULL;
+  if (fclose(f) != 0) file_error_exit("ht file close failed", path);
+}
+
+void ht_divchn_file_write(const ht_divchn_t *ht, const char *path){
+  int fd;
+  size_t i, num_pairs;
+  size_t h[D_H_COUNT];
+  size_t key_align, offsets_size;
+  size_t *offsets = NULL;
+  char *base = NULL;
+  divchn_write_t w;
+  if (HT_FILE_ALIGNMENT % ht->elt_alignment != 0){
+    file_error_exit("ht file element alignment not supported", path);
+  }
+  /* the pair layout of the chunked chain mode of ht_divchn_t */
+  key_align = (ht->key_size < C_MAX_ALIGN) ? ht->key_size : C_MAX_ALIGN;
+  w.key_size = ht->key_size;
+  w.elt_size = ht->elt_size;
+  w.elt_offset = round_up(ht->key_size, ht->elt_alignment);
+  w.pair_size = round_up(add_sz_perror(w.elt_offset, ht->elt_size),
+			 lcm(key_align, ht->elt_alignment));
+  w.count = ht->count;
+  w.count_mul = ht->count_mul;
+  w.count_shift = ht->count_shift;
+  w.pos = calloc_perror(add_sz_perror(ht->count, 1), sizeof(size_t));
+  w.pairs = NULL;
+  w.rdc_key = ht->rdc_key;
+  ht_divchn_apply(ht, divchn_count_pair, &w);
+  /* the count of the ith slot is at i + 1 */
+  for (i = 1; i <= ht->count; i++){
+    w.pos[i] = add_sz_perror(w.pos[i], w.pos[i - 1]);
+  }
+  num_pairs = w.pos[ht->count];
+  offsets_size = mul_sz_perror(add_sz_perror(ht->count, 1), sizeof(size_t));
+  header_base_init(h, ht->key_size, ht->elt_size);
+  h[H_NUM_ELTS] = num_pairs;
+  h[D_PAIR_SIZE] = w.pair_size;
+  h[D_ELT_OFFSET] = w.elt_offset;
+  h[D_SLOT_COUNT] = ht->count;
+  h[D_OFFSETS_POS] = MAGIC_SIZE + sizeof(h);
+  h[D_PAIRS_POS] = round_up(add_sz_perror(h[D_OFFSETS_POS], offsets_size),
+			    HT_FILE_ALIGNMENT);
+  h[H_FILE_SIZE] = add_sz_perror(h[D_PAIRS_POS],
+				 mul_sz_perror(num_pairs, w.pair_size));
+  fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) file_error_exit("ht file open failed", path);
+  if (ftruncate(fd, (off_t)h[H_FILE_SIZE]) < 0){
+    file_error_exit("ht file truncate failed", path);
+  }
+  base = mmap(NULL,
+	      h[H_FILE_SIZE],
+	      PROT_READ | PROT_WRITE,
+	      MAP_SHARED,
+	      fd,
+	      0);
+  if (base == MAP_FAILED) file_error_exit("ht file mmap failed", path);
+  if (close(fd) < 0) file_error_exit("ht file close failed", path);
+  memcpy(base, C_DIVCHN_MAGIC, MAGIC_SIZE);
+  memcpy(base + MAGIC_SIZE, h, sizeof(h));
+  offsets = (size_t *)(base + h[D_OFFSETS_POS]);
+  memcpy(offsets, w.pos, offsets_size);
+  w.pairs = base + h[D_PAIRS_POS];
+  ht_divchn_apply(ht, divchn_place_pair, &w);
+  if (msync(base, h[H_FILE_SIZE], MS_SYNC) < 0){
+    file_error_exit("ht file msync failed", path);
+  }
+  file_unmap(base, h[H_FILE_SIZE]);
+  free(w.pos);
+  w.pos = NULL;
+}
+
+/**
+   Maps a binary file at path into memory as a read-only hash table. A
+   hash table initialized with ht_muloa_file_map or ht_divchn_file_map is
+   released with the corresponding unmap operation, and is accessed only
+   with the corresponding search operation.
+   m           : pointer to a preallocated block of size
+                 sizeof(ht_muloa_file_t) or sizeof(ht_divchn_file_t)
+   path        : path of a file written with ht_muloa_file_write or
+                 ht_divchn_file_write respectively
+   key_size    : size of a key, checked against the file
+   elt_size    : size of an element, checked against the file
+   cmp_key     : - if NULL then a default memcmp-based comparison of keys
+                 is performed
+                 - otherwise comparison function is applied which returns a
+                 zero integer value iff the two keys accessed through the
+                 first and the second arguments are equal
+   rdc_key     : NULL or rdc_key of the written hash table
+*/
+void ht_muloa_file_map(ht_muloa_file_t *m,
+		       const char *path,
+		       size_t key_size,
+		       size_t elt_size,
+		       int (*cmp_key)(const void *, const void *),
+		       size_t (*rdc_key)(const void *, size_t)){
+  size_t h[M_H_COUNT];
+  size_t count, prev_count;
+  char *base = NULL;
+  base = file_map(path, C_MULOA_MAGIC, h, M_H_COUNT, key_size, elt_size);
+  if (h[M_LOG_COUNT] == 0 ||
+      h[M_LOG_COUNT] >= C_FULL_BIT ||
+      h[M_PREV_LOG_COUNT] >= C_FULL_BIT ||
+      h[M_BLOCK_SIZE] < add_sz_perror(h[M_KEY_OFFSET],
+				      add_sz_perror(h[M_ELT_OFFSET],
+						    elt_size)) ||
+      h[M_KEY_OFFSET] < key_size ||
+      h[M_ELT_OFFSET] < sizeof(ke_t)){
+    file_error_exit("ht file header mismatch", path);
+  }
+  count = (size_t)1 << h[M_LOG_COUNT];
+  prev_count = (h[M_PREV_COUNT] > 0) ? (size_t)1 << h[M_PREV_LOG_COUNT] : 0;
+  /* a search of an array without an empty slot ends at max_num_probes */
+  if (h[M_PREV_COUNT] != prev_count ||
+      h[M_MAX_NUM_PROBES] == 0 ||
+      h[M_MAX_NUM_PROBES] > count ||
+      (prev_count > 0 && h[M_PREV_MAX_NUM_PROBES] == 0) ||
+      h[M_PREV_MAX_NUM_PROBES] > prev_count ||
+      h[M_SLOTS_POS] != MAGIC_SIZE + sizeof(h) ||
+      h[M_PREV_SLOTS_POS] !=
+      add_sz_perror(h[M_SLOTS_POS], mul_sz_perror(count, sizeof(size_t))) ||
+      h[M_BLOCKS_POS] % HT_FILE_ALIGNMENT != 0 ||
+      h[M_BLOCKS_POS] <
+      add_sz_perror(h[M_PREV_SLOTS_POS],
+		    mul_sz_perror(prev_count, sizeof(size_t))) ||
+      h[M_BLOCKS_POS] > h[H_FILE_SIZE] ||
+      h[H_FILE_SIZE] - h[M_BLOCKS_POS] !=
+      mul_sz_perror(h[M_NUM_BLOCKS], h[M_BLOCK_SIZE])){
+    file_error_exit("ht file header mismatch", path);
+  }
+  m->key_size = key_size;
+  m->elt_size = elt_size;
+  m->key_offset = h[M_KEY_OFFSET];
+  m->elt_offset = h[M_ELT_OFFSET];
+  m->block_size = h[M_BLOCK_SIZE];
+  m->log_count = h[M_LOG_COUNT];
+  m->max_num_probes = h[M_MAX_NUM_PROBES];
+  m->prev_log_count = h[M_PREV_LOG_COUNT];
+  m->prev_max_num_probes = h[M_PREV_MAX_NUM_PROBES];
+  m->fprime = h[M_FPRIME];
+  m->sprime = h[M_SPRIME];
+  m->is_rh = (h[M_IS_RH] != 0);
+  m->num_elts = h[H_NUM_ELTS];
+  m->num_blocks = h[M_NUM_BLOCKS];
+  m->slots = (const size_t *)(base + h[M_SLOTS_POS]);
+  m->prev_slots =
+    (prev_count > 0) ? (const size_t *)(base + h[M_PREV_SLOTS_POS]) : NULL;
+  m->blocks = base + h[M_BLOCKS_POS];
+  m->base = base;
+  m->map_size = h[H_FILE_SIZE];
+  m->cmp_key = cmp_key;
+  m->rdc_key = rdc_key;
+}
+
+void ht_divchn_file_map(ht_divchn_file_t *m,
+			const char *path,
+			size_t key_size,
+			size_t elt_size,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t)){
+  size_t h[D_H_COUNT];
+  char *base = NULL;
+  base = file_map(path, C_DIVCHN_MAGIC, h, D_H_COUNT, key_size, elt_size);
+  if (h[D_SLOT_COUNT] == 0 ||
+      h[D_PAIR_SIZE] < add_sz_perror(h[D_ELT_OFFSET], elt_size) ||
+      h[D_ELT_OFFSET] < key_size ||
+      h[D_OFFSETS_POS] != MAGIC_SIZE + sizeof(h) ||
+      h[D_PAIRS_POS] % HT_FILE_ALIGNMENT != 0 ||
+      h[D_PAIRS_POS] <
+      add_sz_perror(h[D_OFFSETS_POS],
+		    mul_sz_perror(add_sz_perror(h[D_SLOT_COUNT], 1),
+				  sizeof(size_t))) ||
+      h[D_PAIRS_POS] > h[H_FILE_SIZE] ||
+      h[H_FILE_SIZE] - h[D_PAIRS_POS] !=
+      mul_sz_perror(h[H_NUM_ELTS], h[D_PAIR_SIZE])){
+    file_error_exit("ht file header mismatch", path);
+  }
+  m->key_size = key_size;
+  m->elt_size = elt_size;
+  m->pair_size = h[D_PAIR_SIZE];
+  m->elt_offset = h[D_ELT_OFFSET];
+  m->count = h[D_SLOT_COUNT];
+  mod_rcp_init(m->count, &m->count_mul, &m->count_shift);
+  m->num_elts = h[H_NUM_ELTS];
+  m->offsets = (const size_t *)(base + h[D_OFFSETS_POS]);
+  m->pairs = base + h[D_PAIRS_POS];
+  m->base = base;
+  m->map_size = h[H_FILE_SIZE];
+  m->cmp_key = cmp_key;
+  m->rdc_key = rdc_key;
+}
+
+/**
+   If a key is present in a mapped hash table, returns a pointer to its
+   associated element in the mapping, otherwise returns NULL. The key
+   parameter is not NULL and points to a block of size key_size. The
+   searches of a mapped hash table can be called by threads concurrently.
+*/
+const void *ht_muloa_file_search(const ht_muloa_file_t *m, const void *key){
+  size_t std_key = convert_std_key(key, m->key_size, m->rdc_key);
+  size_t fval = m->fprime * std_key; /* mod 2**FULL_BIT */
+  size_t sval = m->sprime * std_key; /* mod 2**FULL_BIT */
+  const void *elt = NULL;
+  elt = muloa_search_slots(m,
+			   m->slots,
+			   m->log_count,
+			   m->max_num_probes,
+			   key,
+			   fval,
+			   sval);
+  if (elt == NULL && m->prev_slots != NULL){
+    elt = muloa_search_slots(m,
+			     m->prev_slots,
+			     m->prev_log_count,
+			     m->prev_max_num_probes,
+			     key,
+			     fval,
+			     sval);
+  }
+  return elt;
+}
+
+const void *ht_divchn_file_search(const ht_divchn_file_t *m,
+				  const void *key){
+  size_t ix, i, end;
+  const char *pair = NULL;
+  ix = mod_rcp(convert_std_key(key, m->key_size, m->rdc_key),
+	       m->count,
+	       m->count_mul,
+	       m->count_shift);
+  i = m->offsets[ix];
+  end = m->offsets[ix + 1];
+  if (i > end || end > m->num_elts){
+    fprintf(stderr, "ht file offsets mismatch\n");
+    exit(EXIT_FAILURE);
+  }
+  pair = m->pairs + i * m->pair_size;
+  if (m->cmp_key != NULL){
+    for (; i < end; i++){
+      if (m->cmp_key(pair, key) == 0) return pair + m->elt_offset;
+      pair += m->pair_size;
+    }
+  }else{
+    for (; i < end; i++){
+      if (memcmp(pair, key, m->key_size) == 0) return pair + m->elt_offset;
+      pair += m->pair_size;
+    }
+  }
+  return NULL;
+}
+
+/**
+   Unmaps a hash table initialized with a map operation, and leaves a block
+   of size sizeof(ht_muloa_file_t) or sizeof(ht_divchn_file_t) pointed to
+   by the m parameter.
+*/
+void ht_muloa_file_unmap(ht_muloa_file_t *m){
+  file_unmap(m->base, m->map_size);
+  m->slots = NULL;
+  m->prev_slots = NULL;
+  m->blocks = NULL;
+  m->base = NULL;
+}
+
+void ht_divchn_file_unmap(ht_divchn_file_t *m){
+  file_unmap(m->base, m->map_size);
+  m->offsets = NULL;
+  m->pairs = NULL;
+  m->base = NULL;
+}
+
+/** Helper functions */
+
+/**
+   Writes the slot values of an array of count slots of a ht_muloa_t hash
+   table, where *num_blocks is the number of key element blocks in the slots
+   that were written before, and is updated.
+*/
+static void muloa_write_slots(const ht_muloa_t *ht,
+			      ke_t * const *key_elts,
+			      size_t count,
+			      size_t *num_blocks,
+			      FILE *f){
+  size_t i, val;
+  for (i = 0; i < count; i++){
+    if (key_elts[i] == NULL){
+      val = C_SLOT_EMPTY;
+    }else if (key_elts[i] == ht->ph){
+      val = C_SLOT_PH;
+    }else{
+      val = *num_blocks + C_SLOT_FIRST;
+      (*num_blocks)++;
+    }
+    fwrite_perror(&val, sizeof(size_t), f);
+  }
+}
+
+/**
+   Writes the key element blocks of an array of count slots of a
+   ht_muloa_t hash table in the order of slots, with the padding bytes of a
+   block set to zero. block points to a zeroed block of size block_size.
+*/
+static void muloa_write_blocks(const ht_muloa_t *ht,
+			       ke_t * const *key_elts,
+			       size_t count,
+			       char *block,
+			       size_t block_size,
+			       FILE *f){
+  size_t i;
+  const char *ke = NULL;
+  for (i = 0; i < count; i++){
+    if (key_elts[i] == NULL || key_elts[i] == ht->ph) continue;
+    ke = (const char *)key_elts[i];
+    memcpy(block, ke - ht->key_offset, ht->key_size);
+    memcpy(block + ht->key_offset, ke, sizeof(ke_t));
+    memcpy(block + ht->key_offset + ht->elt_offset,
+	   ke + ht->elt_offset,
+	   ht->elt_size);
+    fwrite_perror(block, block_size, f);
+  }
+}
+
+/**
+   If a key with hash values fval and sval is present in an array of
+   2**log_count mapped slots, returns a pointer to its element, otherwise
+   returns NULL. The probe sequence and the Robin Hood stop condition are
+   the same as in the search of the written ht_muloa_t hash table.
+*/
+static const void *muloa_search_slots(const ht_muloa_file_t *m,
+				      const size_t *slots,
+				      size_t log_count,
+				      size_t max_num_probes,
+				      const void *key,
+				      size_t fval,
+				      size_t sval){
+  size_t num_probes = 1;
+  size_t ix, dist, val;
+  size_t mask = ((size_t)1 << log_count) - 1;
+  const char *block = NULL;
+  const ke_t *ke = NULL;
+  ix = fval >> (C_FULL_BIT - log_count);
+  dist = (m->is_rh) ? 1 : adjust_dist(sval >> (C_FULL_BIT - log_count));
+  while ((val = slots[ix]) != C_SLOT_EMPTY){
+    if (val != C_SLOT_PH){
+      if (val - C_SLOT_FIRST >= m->num_blocks){
+	fprintf(stderr, "ht file slots mismatch\n");
+	exit(EXIT_FAILURE);
+      }
+      block = m->blocks + (val - C_SLOT_FIRST) * m->block_size;
+      ke = (const ke_t *)(block + m->key_offset);
+      if (m->is_rh &&
+	  ((ix - (ke->fval >> (C_FULL_BIT - log_count))) & mask) <
+	  num_probes - 1){
+	break;
+      }else if (m->cmp_key != NULL && m->cmp_key(block, key) == 0){
+	return block + m->key_offset + m->elt_offset;
+      }else if (m->cmp_key == NULL &&
+		memcmp(block, key, m->key_size) == 0){
+	return block + m->key_offset + m->elt_offset;
+      }
+    }
+    if (num_probes == max_num_probes) break;
+    ix = (ix + dist) & mask;
+    num_probes++;
+  }
+  return NULL;
+}
+
+/**
+   Increments the count of pairs of the next slot of a key, stored at the
+   position of the slot plus one.
+*/
+static void divchn_count_pair(const void *key, const void *elt, void *arg){
+  divchn_write_t *w = arg;
+  size_t ix;
+  (void)elt;
+  ix = mod_rcp(convert_std_key(key, w->key_size, w->rdc_key),
+	       w->count,
+	       w->count_mul,
+	       w->count_shift);
+  w->pos[ix + 1]++;
+}
+
+/**
+   Copies a key and its element into the next pair position of the next
+   slot of the key in a mapping.
+*/
+static void divchn_place_pair(const void *key, const void *elt, void *arg){
+  divchn_write_t *w = arg;
+  size_t ix;
+  char *pair = NULL;
+  ix = mod_rcp(convert_std_key(key, w->key_size, w->rdc_key),
+	       w->count,
+	       w->count_mul,
+	       w->count_shift);
+  pair = w->pairs + w->pos[ix] * w->pair_size;
+  memcpy(pair, key, w->key_size);
+  memcpy(pair + w->elt_offset, elt, w->elt_size);
+  w->pos[ix]++;
+}
+
+/**
+   Maps a file at path, validates the magic string and the common part of
+   its header with h_count values, copies the header to h, and returns a
+   pointer to the beginning of the mapping.
+*/
+static char *file_map(const char *path,
+		      const char *magic,
+		      size_t *h,
+		      size_t h_count,
+		      size_t key_size,
+		      size_t elt_size){
+  int fd;
+  size_t h_size = h_count * sizeof(size_t);
+  char *base = NULL;
+  struct stat st;
+  fd = open(path, O_RDONLY);
+  if (fd < 0) file_error_exit("ht file open failed", path);
+  if (fstat(fd, &st) < 0) file_error_exit("ht file stat failed", path);
+  if (st.st_size < (off_t)(MAGIC_SIZE + h_size)){
+    file_error_exit("ht file is too short", path);
+  }
+  base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) file_error_exit("ht file mmap failed", path);
+  close(fd); /* the mapping remains valid */
+  memcpy(h, base + MAGIC_SIZE, h_size);
+  if (memcmp(base, magic, MAGIC_SIZE) != 0 ||
+      h[H_SIZE_SZ] != sizeof(size_t) ||
+      h[H_BYTE_ORDER] != C_BYTE_ORDER){
+    file_error_exit("ht file format or system mismatch", path);
+  }
+  if (h[H_VERSION] != C_VERSION ||
+      h[H_FILE_SIZE] != (size_t)st.st_size ||
+      h[H_ALIGNMENT] != HT_FILE_ALIGNMENT ||
+      h[H_KEY_SIZE] != key_size ||
+      h[H_ELT_SIZE] != elt_size){
+    file_error_exit("ht file header mismatch", path);
+  }
+  return base;
+}
+
+static void file_unmap(void *base, size_t map_size){
+  if (munmap(base, map_size) < 0){
+    perror("ht file munmap failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+   Initializes the part of the size_t array of a header that is common to
+   both hash tables, except the file size and the number of keys.
+*/
+static void header_base_init(size_t *h, size_t key_size, size_t elt_size){
+  h[H_SIZE_SZ] = sizeof(size_t);
+  h[H_BYTE_ORDER] = C_BYTE_ORDER;
+  h[H_VERSION] = C_VERSION;
+  h[H_FILE_SIZE] = 0;
+  h[H_ALIGNMENT] = HT_FILE_ALIGNMENT;
+  h[H_KEY_SIZE] = key_size;
+  h[H_ELT_SIZE] = elt_size;
+  h[H_NUM_ELTS] = 0;
+}
+
+/**
+   Converts a key to a key of the standard size, according to the
+   conversion in ht_muloa_t and ht_divchn_t.
+*/
+static size_t convert_std_key(const void *key,
+			      size_t key_size,
+			      size_t (*rdc_key)(const void *, size_t)){
+  size_t i;
+  size_t sz_count, rem_size;
+  size_t std_key = 0;
+  size_t buf_size = sizeof(size_t);
+  unsigned char buf[sizeof(size_t)];
+  const char *k = NULL, *k_start = NULL, *k_end = NULL;
+  if (rdc_key != NULL) return rdc_key(key, key_size);
+  sz_count = key_size / buf_size; /* division by sizeof(size_t) */
+  rem_size = key_size - sz_count * buf_size;
+  k = key;
+  memset(buf, 0, buf_size);
+  memcpy(buf, k, rem_size);
+  for (i = 0; i < rem_size; i++){
+    std_key += (size_t)buf[i] << (i * C_BYTE_BIT);
+  }
+  k_start = k + rem_size;
+  k_end = k_start + sz_count * buf_size;
+  for (k = k_start; k != k_end; k += buf_size){
+    memcpy(buf, k, buf_size);
+    for (i = 0; i < buf_size; i++){
+      std_key += (size_t)buf[i] << (i * C_BYTE_BIT);
+    }
+  }
+  return std_key;
+}
+
+/**
+   Adjusts a probe distance to an odd distance, if necessary.
+*/
+static size_t adjust_dist(size_t dist){
+  size_t ret = dist;
+  if (!(dist & 1)){
+    if (dist == 0){
+      ret++;
+    }else{
+      ret--;
+    }
+  }
+  return ret;
+}
+
+/**
+   Rounds n up to a multiple of k > 0.
+*/
+static size_t round_up(size_t n, size_t k){
+  size_t rem = n % k;
+  return (rem == 0) ? n : add_sz_perror(n, k - rem);
+}
+
+/**
+   Computes the least common multiple of a > 0 and b > 0.
+*/
+static size_t lcm(size_t a, size_t b){
+  size_t x = a, y = b, r;
+  while (y > 0){
+    r = x % y;
+    x = y;
+    y = r;
+  }
+  return mul_sz_perror(a / x, b);
+}
+
+static void fwrite_perror(const void *s, size_t size, FILE *f){
+  if (size > 0 && fwrite(s, 1, size, f) != size){
+    perror("ht file write failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void file_error_exit(const char *s, const char *path){
+  fprintf(stderr, "%s: %s\n", s, path);
+  exit(EXIT_FAILURE);
+}
@@ -0,0 +1,174 @@
+/**
+   ht-file.h
+
+   Struct declarations and declarations of accessible functions for writing
+   a hash table of type ht_muloa_t or ht_divchn_t to a binary file, and for
+   mapping a binary file into memory as a read-only hash table without
+   copying and without rehashing the keys.
+
+   A file of a ht_muloa_t hash table consists of i) a header, ii) the slot
+   array as an array of size_t, iii) the previous slot array of an
+   incremental growth step, if the keys were not all moved, and iv) the
+   block of key element blocks. A slot value is 0 in an empty slot, 1 in a
+   slot with a placeholder, and i + 2 in a slot with the ith key element
+   block. A key element block has the in-table layout of a key, a ke_t
+   struct with the hash values of the key, and an element, so that a
+   mapped hash table is searched with the probe sequences, the Robin Hood
+   mode, and the primes of the written hash table.
+
+   A file of a ht_divchn_t hash table consists of i) a header, ii) the
+   count + 1 offsets of the chains of the count slots as an array of size_t,
+   and iii) the block of key element pairs of all chains. The keys in the
+   previous slots of an incremental growth step are written to their next
+   slots, so that a search in a mapped hash table accesses one chain.
+
+   The header consists of an 8-byte magic string followed by an array of
+   size_t values recording the size of size_t, a byte order check value,
+   the format version, the file size, the alignment of the block of key
+   element blocks or pairs relative to the beginning of a file, key_size,
+   elt_size, the number of keys, and the layout and hashing parameters of
+   the hash table. The block of key element blocks or pairs begins at a
+   multiple of HT_FILE_ALIGNMENT, so that in a mapping, which begins at a
+   page boundary, each element has the alignment that was set with
+   ht_muloa_align or ht_divchn_align before a file was written.
+
+   An element is written as a copy of its elt_size block. A file is
+   therefore meaningful in another process only if each element is within a
+   contiguous memory block and a copy of the element was inserted. The
+   cmp_key and rdc_key functions are not written and are provided when a
+   file is mapped; rdc_key must be the function, or NULL, with which the
+   hash table was initialized.
+
+   A file is readable on systems with the same size of size_t, byte order
+   and integer representation as the system where the file was written.
+   A header is validated in O(1) time when a file is mapped, and slot values
+   and offsets are checked against the bounds of a mapping in a search, so
+   that the slots and keys are not accessed before the first search. The
+   mapping is shared across the processes mapping the file, and a file is
+   not written or truncated while it is mapped.
+
+   The implementation provides an error message and an exit is executed if
+   a file operation fails or a file is not in the format. The
+   implementation does not use stdint.h and is portable under C89/C90 and
+   C99 with the requirement that the POSIX mmap API is available.
+*/
+
+#ifndef HT_FILE_H
+#define HT_FILE_H
+
+#include <stddef.h>
+#include "ht-muloa.h"
+#include "ht-divchn.h"
+
+/**
+   The alignment of the block of key element blocks or pairs relative to
+   the beginning of a file. It is a multiple of the alignment requirement of
+   any basic type and a divisor of the page size on current systems.
+*/
+#define HT_FILE_ALIGNMENT 64
+
+typedef struct{
+  size_t key_size;
+  size_t elt_size;
+  size_t key_offset;
+  size_t elt_offset;
+  size_t block_size; /* bytes between key element blocks */
+  size_t log_count;
+  size_t max_num_probes;
+  size_t prev_log_count;
+  size_t prev_max_num_probes;
+  size_t fprime;
+  size_t sprime;
+  int is_rh;
+  size_t num_elts;
+  size_t num_blocks;
+  const size_t *slots;
+  const size_t *prev_slots; /* NULL if all keys were moved */
+  const char *blocks;
+  void *base; /* beginning of the mapping */
+  size_t map_size;
+  int (*cmp_key)(const void *, const void *);
+  size_t (*rdc_key)(const void *, size_t);
+} ht_muloa_file_t;
+
+typedef struct{
+  size_t key_size;
+  size_t elt_size;
+  size_t pair_size;
+  size_t elt_offset; /* bytes from the beginning of a pair to elt */
+  size_t count;
+  size_t count_mul; /* reciprocal multiplier of count for mod_rcp */
+  size_t count_shift;
+  size_t num_elts;
+  const size_t *offsets; /* count + 1 offsets of chains in pairs */
+  const char *pairs;
+  void *base; /* beginning of the mapping */
+  size_t map_size;
+  int (*cmp_key)(const void *, const void *);
+  size_t (*rdc_key)(const void *, size_t);
+} ht_divchn_file_t;
+
+/**
+   Writes a hash table to a binary file at path. The file is created or
+   truncated. The writing of a ht_divchn_t hash table maps the file into
+   memory and places each pair at its final position, so that no copy of
+   the keys and elements is allocated.
+   ht          : pointer to a hash table with elements within contiguous
+                 memory blocks; the elt_alignment value set with
+                 ht_muloa_align or ht_divchn_align is a divisor of
+                 HT_FILE_ALIGNMENT
+   path        : path of a file
+*/
+void ht_muloa_file_write(const ht_muloa_t *ht, const char *path);
+void ht_divchn_file_write(const ht_divchn_t *ht, const char *path);
+
+/**
+   Maps a binary file at path into memory as a read-only hash table. A
+   hash table initialized with ht_muloa_file_map or ht_divchn_file_map is
+   released with the corresponding unmap operation, and is accessed only
+   with the corresponding search operation.
+   m           : pointer to a preallocated block of size
+                 sizeof(ht_muloa_file_t) or sizeof(ht_divchn_file_t)
+   path        : path of a file written with ht_muloa_file_write or
+                 ht_divchn_file_write respectively
+   key_size    : size of a key, checked against the file
+   elt_size    : size of an element, checked against the file
+   cmp_key     : - if NULL then a default memcmp-based comparison of keys
+                 is performed
+                 - otherwise comparison function is applied which returns a
+                 zero integer value iff the two keys accessed through the
+                 first and the second arguments are equal
+   rdc_key     : NULL or rdc_key of the written hash table
+*/
+void ht_muloa_file_map(ht_muloa_file_t *m,
+		       const char *path,
+		       size_t key_size,
+		       size_t elt_size,
+		       int (*cmp_key)(const void *, const void *),
+		       size_t (*rdc_key)(const void *, size_t));
+void ht_divchn_file_map(ht_divchn_file_t *m,
+			const char *path,
+			size_t key_size,
+			size_t elt_size,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t));
+
+/**
+   If a key is present in a mapped hash table, returns a pointer to its
+   associated element in the mapping, otherwise returns NULL. The key
+   parameter is not NULL and points to a block of size key_size. The
+   searches of a mapped hash table can be called by threads concurrently.
+*/
+const void *ht_muloa_file_search(const ht_muloa_file_t *m, const void *key);
+const void *ht_divchn_file_search(const ht_divchn_file_t *m,
+				  const void *key);
+
+/**
+   Unmaps a hash table initialized with a map operation, and leaves a block
+   of size sizeof(ht_muloa_file_t) or sizeof(ht_divchn_file_t) pointed to
+   by the m parameter.
+*/
+void ht_muloa_file_unmap(ht_muloa_file_t *m);
+void ht_divchn_file_unmap(ht_divchn_file_t *m);
+
+#endif
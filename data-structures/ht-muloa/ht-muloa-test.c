@@ -19,6 +19,12 @@
       [0, 1] : on/off insert search uint_ptr test
       [0, 1] : on/off remove delete uint_ptr test
       [0, 1] : on/off corner cases test
+      [0, 1] : on/off incremental growth test
+      [0, 1] : on/off stats test
+      [0, 1] : on/off churn test
+      [0, 1] : on/off Robin Hood test
+      [0, 1] : on/off batch search test
+      [0, 1] : on/off interleaved search test
 
    usage examples:
    ./ht-muloa-test
@@ -26,6 +32,9 @@
    ./ht-muloa-test 17 5 6 
    ./ht-muloa-test 19 0 2 3000 4000 15 10
    ./ht-muloa-test 19 0 2 3000 4000 15 10 1 1 0 0 0
+   ./ht-muloa-test 16 0 2 3000 4000 15 10 1 0 0 0 0 0 1
+   ./ht-muloa-test 20 0 0 3000 4000 15 1 1 0 0 0 0 0 0 0 0 1
+   ./ht-muloa-test 20 0 0 3000 4000 15 1 1 0 0 0 0 0 0 0 0 0 1
 
    ht-muloa-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -68,14 +77,22 @@ const char *C_USAGE =
   "> 0 : c\n"
   "> 0 : d\n"
   "> 0 : e log base 2 s.t. c <= d <= 2**e\n"
-  "> 0 : f s.t. c / 2**e <= alpha <= d / 2**e, in f steps\n"
-  "[0, 1] : on/off insert search uint test\n"
-  "[0, 1] : on/off remove delete uint test\n"
-  "[0, 1] : on/off insert search uint_ptr test\n"
-  "[0, 1] : on/off remove delete uint_ptr test\n"
-  "[0, 1] : on/off corner cases test\n";
-const int C_ARGC_MAX = 13;
-const size_t C_ARGS_DEF[12] = {14, 0, 2, 3277, 32768u, 15, 8, 1, 1, 1, 1, 1};
+  "> 0 : f s.t. c / 2**e <= alpha <= d / 2**e, in f steps\n";
+const char *C_USAGE_TESTS = /* each string literal within 509 characters */
+  "[0, 1] : insert search uint test\n"
+  "[0, 1] : remove delete uint test\n"
+  "[0, 1] : insert search uint_ptr test\n"
+  "[0, 1] : remove delete uint_ptr test\n"
+  "[0, 1] : corner cases\n"
+  "[0, 1] : incr\n"
+  "[0, 1] : stats\n"
+  "[0, 1] : churn\n"
+  "[0, 1] : rh\n"
+  "[0, 1] : batch search\n"
+  "[0, 1] : interleaved search\n";
+const int C_ARGC_MAX = 19;
+const size_t C_ARGS_DEF[18] = {14, 0, 2, 3277, 32768u, 15, 8, 1, 1, 1, 1, 1,
+			       1, 1, 1, 1, 1, 1};
 const size_t C_SIZE_MAX = (size_t)-1;
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
@@ -86,6 +103,28 @@ const size_t C_CORNER_KEY_SIZE = sizeof(unsigned char);
 const size_t C_CORNER_HT_COUNT = 2048;
 const size_t C_CORNER_ALPHA_N = 33;
 const size_t C_CORNER_LOG_ALPHA_D = 15; /* alpha is 33/32768 */
+const size_t C_MIN_NUM = 16384;
+const size_t C_MIN_NUM_ALPHA_N = 1;
+const size_t C_MIN_NUM_LOG_ALPHA_D = 1; /* alpha is 1/2 */
+
+/* incremental growth test */
+const size_t C_INCR_NUM_SLOTS = 4;
+
+/* stats test */
+const size_t C_HIST_COUNT = 16;
+
+/* churn test */
+const size_t C_CHURN_NUM_ROUNDS = 8;
+
+/* Robin Hood test */
+const size_t C_RH_NUM_MODES = 3;
+const char *C_RH_MODES[3] = {"double hashing",
+			     "Robin Hood",
+			     "Robin Hood, incremental"};
+
+/* interleaved search test */
+const size_t C_NUM_LKS_COUNT = 4;
+const size_t C_NUM_LKS[4] = {1, 4, 16, 64};
 
 void insert_search_free(size_t num_ins,
 			size_t key_size,
@@ -433,6 +472,27 @@ void search_nin_ht(const ht_muloa_t *ht,
   *res *= (ht->num_elts == n);
 }
 
+void reset_ht(ht_muloa_t *ht,
+	      const unsigned char *keys,
+	      size_t count,
+	      int *res){
+  size_t i;
+  size_t init_count = ht->count;
+  const unsigned char *k = NULL;
+  clock_t t;
+  t = clock();
+  ht_muloa_reset(ht);
+  t = clock() - t;
+  k = keys;
+  for (i = 0; i < count; i++){
+    *res *= (ht_muloa_search(ht, k) == NULL);
+    k += ht->key_size;
+  }
+  printf("\t\treset time:                     "
+	 "%.4f seconds\n", (float)t / CLOCKS_PER_SEC);
+  *res *= (ht->num_elts == 0 && ht->count == init_count);
+}
+
 void free_ht(ht_muloa_t *ht){
   clock_t t;
   t = clock();
@@ -481,6 +541,8 @@ void insert_search_free(size_t num_ins,
 		NULL,
 		NULL);
   insert_keys_elts(&ht, keys, elts, num_ins, &res); /* no dereferencing */
+  reset_ht(&ht, keys, num_ins, &res);
+  insert_keys_elts(&ht, keys, elts, num_ins, &res);
   free_ht(&ht);
   ht_muloa_init(&ht,
 		key_size,
@@ -686,6 +748,561 @@ void remove_delete(size_t num_ins,
   elts = NULL;
 }
 
+/**
+   Runs a test of the incremental growth mode on distinct size_t keys and
+   size_t elements, and compares the maximal time of an insert operation
+   in the mode with the maximal time of an insert operation without the
+   mode. The keys are removed and deleted while the keys of the last growth
+   step may still be moved.
+*/
+void run_incr_grow_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t elt;
+  size_t *keys = NULL;
+  clock_t t, t_max[2];
+  ht_muloa_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa_incr_grow test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f, "
+	 "# slots moved: %lu\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d),
+	 TOLU(C_INCR_NUM_SLOTS));
+  for (j = 0; j < 2; j++){
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  alpha_n,
+		  log_alpha_d,
+		  NULL,
+		  NULL,
+		  NULL);
+    ht_muloa_align(&ht, sizeof(size_t));
+    if (j) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    t_max[j] = 0;
+    for (i = 0; i < num_ins; i++){
+      t = clock();
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+      t = clock() - t;
+      if (t > t_max[j]) t_max[j] = t;
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      res *= (*(size_t *)ht_muloa_search(&ht, &keys[i]) == keys[i]);
+    }
+    for (i = 0; i < num_ins; i++){
+      if (i & 1){
+	ht_muloa_delete(&ht, &keys[i]);
+      }else{
+	elt = num_ins;
+	ht_muloa_remove(&ht, &keys[i], &elt);
+	res *= (elt == keys[i]);
+      }
+    }
+    res *= (ht.num_elts == 0);
+    for (i = 0; i < num_ins; i++){
+      res *= (ht_muloa_search(&ht, &keys[i]) == NULL);
+    }
+    ht_muloa_free(&ht);
+  }
+  printf("\t\tmax insert time:                    %.6f seconds\n"
+	 "\t\tmax insert time (incremental):      %.6f seconds\n",
+	 (double)t_max[0] / CLOCKS_PER_SEC,
+	 (double)t_max[1] / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a test of ht_muloa_stats on distinct size_t keys and size_t
+   elements, without and with an incremental growth mode. Tests that the
+   histogram of probe lengths accounts for each key and is bounded by
+   max_num_probes without an incremental growth step in progress, and that
+   deletions are reflected in the placeholder count.
+*/
+void run_stats_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins, sum;
+  size_t *keys = NULL;
+  size_t *hist = NULL;
+  ht_muloa_t ht;
+  ht_muloa_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(num_ins, sizeof(size_t));
+  hist = malloc_perror(C_HIST_COUNT, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa_stats test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < 2; j++){
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  alpha_n,
+		  log_alpha_d,
+		  NULL,
+		  NULL,
+		  NULL);
+    ht_muloa_align(&ht, sizeof(size_t));
+    if (j) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    for (i = 0; i < num_ins; i++){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+    ht_muloa_stats(&ht, &s, hist, C_HIST_COUNT);
+    sum = 0;
+    for (i = 0; i < C_HIST_COUNT; i++){
+      sum += hist[i];
+      if (ht.prev_key_elts == NULL && i >= s.max_num_probes){
+	res *= (hist[i] == 0);
+      }
+    }
+    res *= (sum == num_ins &&
+	    s.num_elts == num_ins &&
+	    s.count == ht.count &&
+	    s.num_phs == 0 &&
+	    s.num_cleans == 0 &&
+	    (s.num_grows > 0) == (ht.count > pow_two_perror(8)) &&
+	    s.num_moves >= s.num_grows);
+    if (j == 0){
+      printf("\t\tprobe lengths:                 ");
+      for (i = 0; i < C_HIST_COUNT && i < s.max_num_probes; i++){
+	printf(" %lu", TOLU(hist[i]));
+      }
+      printf("\n\t\tgrowth steps, moved keys:       %lu, %lu\n",
+	     TOLU(s.num_grows), TOLU(s.num_moves));
+    }
+    for (i = 0; i < num_ins; i += 2){
+      ht_muloa_delete(&ht, &keys[i]);
+    }
+    ht_muloa_stats(&ht, &s, NULL, 0);
+    res *= (s.num_elts == num_ins - (num_ins + 1) / 2 &&
+	    s.num_elts + s.num_phs <= s.count);
+    if (ht.prev_key_elts == NULL && s.num_cleans == 0){
+      res *= (s.num_phs == (num_ins + 1) / 2);
+    }
+    ht_muloa_stats(&ht, &s, hist, 1);
+    res *= (hist[0] == s.num_elts);
+    ht_muloa_free(&ht);
+  }
+  printf("\t\tcorrectness:                   ");
+  print_test_result(res);
+  free(keys);
+  free(hist);
+  keys = NULL;
+  hist = NULL;
+}
+
+/**
+   Runs a test of placeholder recycling on distinct size_t keys and size_t
+   elements. In the first part, each key is repeatedly deleted and
+   reinserted, and the reinserted key is tested to recycle the placeholder
+   of its deletion without a growth step or a cleanup, and without
+   increasing max_num_probes. In the second part, the oldest half of the
+   keys in a sliding window is repeatedly deleted and the same number of
+   new keys is inserted, and the remaining and deleted keys are searched
+   for.
+*/
+void run_churn_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins, half, start;
+  size_t max_num_probes, num_grows;
+  size_t *keys = NULL;
+  const size_t *elt = NULL;
+  ht_muloa_t ht;
+  ht_muloa_stats_t s;
+  num_ins = pow_two_perror(log_ins);
+  half = (num_ins + 1) / 2;
+  keys = malloc_perror(num_ins + C_CHURN_NUM_ROUNDS * half, sizeof(size_t));
+  for (i = 0; i < num_ins + C_CHURN_NUM_ROUNDS * half; i++){
+    keys[i] = i;
+  }
+  printf("Run a churn test on distinct size_t keys and size_t elements\n");
+  printf("\t# inserts: %lu, # rounds: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 TOLU(C_CHURN_NUM_ROUNDS),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  ht_muloa_init(&ht,
+		sizeof(size_t),
+		sizeof(size_t),
+		0,
+		alpha_n,
+		log_alpha_d,
+		NULL,
+		NULL,
+		NULL);
+  ht_muloa_align(&ht, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    ht_muloa_insert(&ht, &keys[i], &keys[i]);
+  }
+  max_num_probes = ht.max_num_probes;
+  num_grows = ht.num_grows;
+  for (j = 0; j < C_CHURN_NUM_ROUNDS; j++){
+    for (i = 0; i < num_ins; i++){
+      ht_muloa_delete(&ht, &keys[i]);
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+  }
+  ht_muloa_stats(&ht, &s, NULL, 0);
+  res *= (s.num_elts == num_ins &&
+	  s.num_phs == 0 &&
+	  s.num_cleans == 0 &&
+	  s.num_grows == num_grows &&
+	  s.max_num_probes == max_num_probes);
+  for (i = 0; i < num_ins; i++){
+    elt = ht_muloa_search(&ht, &keys[i]);
+    res *= (elt != NULL && *elt == keys[i]);
+  }
+  printf("\t\tdelete-reinsert max # probes:    %lu\n",
+	 TOLU(s.max_num_probes));
+  start = 0;
+  for (j = 0; j < C_CHURN_NUM_ROUNDS; j++){
+    for (i = start; i < start + half; i++){
+      ht_muloa_delete(&ht, &keys[i]);
+    }
+    for (i = start + num_ins; i < start + num_ins + half; i++){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+    start += half;
+  }
+  ht_muloa_stats(&ht, &s, NULL, 0);
+  res *= (s.num_elts == num_ins && s.num_elts + s.num_phs <= s.count);
+  for (i = 0; i < start; i++){
+    res *= (ht_muloa_search(&ht, &keys[i]) == NULL);
+  }
+  for (i = start; i < start + num_ins; i++){
+    elt = ht_muloa_search(&ht, &keys[i]);
+    res *= (elt != NULL && *elt == keys[i]);
+  }
+  printf("\t\tsliding window max # probes:     %lu\n"
+	 "\t\tsliding window cleanups:         %lu\n",
+	 TOLU(s.max_num_probes),
+	 TOLU(s.num_cleans));
+  ht_muloa_free(&ht);
+  printf("\t\tcorrectness:                     ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a ht_muloa_robin_hood test on distinct size_t keys and size_t
+   elements, with double hashing, and in the Robin Hood mode without and
+   with an incremental growth mode. Tests searches of keys in and not in a
+   hash table after insertions, after deletions of every other key, and
+   after the reinsertion of the deleted keys, and that no placeholders are
+   left in the Robin Hood mode without an incremental growth step in
+   progress.
+*/
+void run_robin_hood_test(size_t log_ins, size_t alpha_n, size_t log_alpha_d){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins;
+  size_t elt;
+  size_t *keys = NULL;
+  const size_t *p = NULL;
+  clock_t t;
+  ht_muloa_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(2 * num_ins, sizeof(size_t));
+  for (i = 0; i < 2 * num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa_robin_hood test on distinct size_t keys and size_t "
+	 "elements\n");
+  printf("\t# inserts: %lu, load factor upper bound: %.4f\n",
+	 TOLU(num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < C_RH_NUM_MODES; j++){
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  alpha_n,
+		  log_alpha_d,
+		  NULL,
+		  NULL,
+		  NULL);
+    ht_muloa_align(&ht, sizeof(size_t));
+    if (j > 0) ht_muloa_robin_hood(&ht);
+    if (j > 1) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    for (i = 0; i < num_ins; i++){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+    res *= (ht.num_elts == num_ins);
+    for (i = 0; i < num_ins; i++){
+      p = ht_muloa_search(&ht, &keys[i]);
+      res *= (p != NULL && *p == keys[i]);
+    }
+    t = clock();
+    for (i = num_ins; i < 2 * num_ins; i++){
+      res *= (ht_muloa_search(&ht, &keys[i]) == NULL);
+    }
+    t = clock() - t;
+    printf("\t\t%s\n"
+	   "\t\t\tmax # probes:                %lu\n"
+	   "\t\t\tnot in ht search time:       %.4f seconds\n",
+	   C_RH_MODES[j],
+	   TOLU(ht.max_num_probes),
+	   (float)t / CLOCKS_PER_SEC);
+    for (i = 0; i < num_ins; i += 2){
+      if (i & 2){
+	ht_muloa_delete(&ht, &keys[i]);
+      }else{
+	elt = num_ins;
+	ht_muloa_remove(&ht, &keys[i], &elt);
+	res *= (elt == keys[i]);
+      }
+    }
+    res *= (ht.num_elts == num_ins - (num_ins + 1) / 2);
+    if (j == 1) res *= (ht.num_phs == 0);
+    for (i = 0; i < num_ins; i++){
+      p = ht_muloa_search(&ht, &keys[i]);
+      if (i & 1){
+	res *= (p != NULL && *p == keys[i]);
+      }else{
+	res *= (p == NULL);
+      }
+    }
+    for (i = 0; i < num_ins; i += 2){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+    res *= (ht.num_elts == num_ins);
+    if (j == 1) res *= (ht.num_phs == 0);
+    for (i = 0; i < 2 * num_ins; i++){
+      p = ht_muloa_search(&ht, &keys[i]);
+      if (i < num_ins){
+	res *= (p != NULL && *p == keys[i]);
+      }else{
+	res *= (p == NULL);
+      }
+    }
+    ht_muloa_free(&ht);
+  }
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  keys = NULL;
+}
+
+/**
+   Runs a ht_muloa_search_batch test on distinct size_t keys and size_t
+   elements, where half of the searched keys are not in a hash table and
+   the keys are searched in a random order, by comparing the results to
+   the results of ht_muloa_search.
+*/
+void run_search_batch_test(size_t log_ins,
+			   size_t alpha_n,
+			   size_t log_alpha_d){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_ins;
+  size_t key;
+  size_t *keys = NULL;
+  void **elts = NULL, **batch_elts = NULL;
+  clock_t t, t_batch;
+  ht_muloa_t ht;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(2 * num_ins, sizeof(size_t));
+  elts = malloc_perror(2 * num_ins, sizeof(void *));
+  batch_elts = malloc_perror(2 * num_ins, sizeof(void *));
+  for (i = 0; i < 2 * num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa_search_batch test on distinct size_t keys and "
+	 "size_t elements\n");
+  printf("\t# inserts: %lu, # searches: %lu, load factor upper bound: "
+	 "%.4f\n",
+	 TOLU(num_ins),
+	 TOLU(2 * num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < C_RH_NUM_MODES; j++){
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  alpha_n,
+		  log_alpha_d,
+		  NULL,
+		  NULL,
+		  NULL);
+    ht_muloa_align(&ht, sizeof(size_t));
+    if (j > 0) ht_muloa_robin_hood(&ht);
+    if (j > 1) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    for (i = 0; i < num_ins; i++){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+    }
+    for (i = 2 * num_ins - 1; i > 0; i--){
+      k = RANDOM() % (i + 1);
+      key = keys[i];
+      keys[i] = keys[k];
+      keys[k] = key;
+    }
+    t = clock();
+    for (i = 0; i < 2 * num_ins; i++){
+      elts[i] = ht_muloa_search(&ht, &keys[i]);
+    }
+    t = clock() - t;
+    t_batch = clock();
+    ht_muloa_search_batch(&ht, keys, batch_elts, 2 * num_ins);
+    t_batch = clock() - t_batch;
+    for (i = 0; i < 2 * num_ins; i++){
+      res *= (elts[i] == batch_elts[i]);
+      if (keys[i] < num_ins){
+	res *= (batch_elts[i] != NULL &&
+		*(size_t *)batch_elts[i] == keys[i]);
+      }else{
+	res *= (batch_elts[i] == NULL);
+      }
+    }
+    ht_muloa_search_batch(&ht, keys, batch_elts, 0);
+    printf("\t\t%s\n"
+	   "\t\t\tsearch time:                 %.4f seconds\n"
+	   "\t\t\tbatch search time:           %.4f seconds\n",
+	   C_RH_MODES[j],
+	   (float)t / CLOCKS_PER_SEC,
+	   (float)t_batch / CLOCKS_PER_SEC);
+    ht_muloa_free(&ht);
+    for (i = 0; i < 2 * num_ins; i++){
+      keys[i] = i;
+    }
+  }
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  free(batch_elts);
+  keys = NULL;
+  elts = NULL;
+  batch_elts = NULL;
+}
+
+/**
+   Runs a ht_muloa_search_interleave test on distinct size_t keys and
+   size_t elements in double hashing and Robin Hood modes, with different
+   numbers of lookups in flight. In the incremental mode, the inserts stop
+   in a growth step after at least half of the keys were inserted, so that
+   the lookups continue in the previous slots. Half of the searched keys
+   are not in a hash table.
+*/
+void run_search_interleave_test(size_t log_ins,
+				size_t alpha_n,
+				size_t log_alpha_d){
+  int res = 1;
+  size_t i, j, k;
+  size_t num_ins, num_present;
+  size_t key;
+  size_t *keys = NULL;
+  void **elts = NULL, **lk_elts = NULL;
+  clock_t t, t_lk;
+  ht_muloa_t ht;
+  ht_muloa_lookup_t *lks = NULL;
+  num_ins = pow_two_perror(log_ins);
+  keys = malloc_perror(2 * num_ins, sizeof(size_t));
+  elts = malloc_perror(2 * num_ins, sizeof(void *));
+  lk_elts = malloc_perror(2 * num_ins, sizeof(void *));
+  lks = malloc_perror(C_NUM_LKS[C_NUM_LKS_COUNT - 1],
+		      sizeof(ht_muloa_lookup_t));
+  for (i = 0; i < 2 * num_ins; i++){
+    keys[i] = i;
+  }
+  printf("Run a ht_muloa_search_interleave test on distinct size_t keys "
+	 "and size_t elements\n");
+  printf("\t# inserts: %lu, # searches: %lu, load factor upper bound: "
+	 "%.4f\n",
+	 TOLU(num_ins),
+	 TOLU(2 * num_ins),
+	 (float)alpha_n / pow_two_perror(log_alpha_d));
+  for (j = 0; j < C_RH_NUM_MODES; j++){
+    ht_muloa_init(&ht,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  0,
+		  alpha_n,
+		  log_alpha_d,
+		  NULL,
+		  NULL,
+		  NULL);
+    ht_muloa_align(&ht, sizeof(size_t));
+    if (j > 0) ht_muloa_robin_hood(&ht);
+    if (j > 1) ht_muloa_incr_grow(&ht, C_INCR_NUM_SLOTS);
+    num_present = 0;
+    for (i = 0; i < num_ins; i++){
+      ht_muloa_insert(&ht, &keys[i], &keys[i]);
+      num_present++;
+      if (j > 1 && i >= num_ins / 2 && ht.prev_key_elts != NULL) break;
+    }
+    for (i = 2 * num_ins - 1; i > 0; i--){
+      k = RANDOM() % (i + 1);
+      key = keys[i];
+      keys[i] = keys[k];
+      keys[k] = key;
+    }
+    t = clock();
+    for (i = 0; i < 2 * num_ins; i++){
+      elts[i] = ht_muloa_search(&ht, &keys[i]);
+    }
+    t = clock() - t;
+    printf("\t\t%s, in progress growth step: %s\n"
+	   "\t\t\tsearch time:                 %.4f seconds\n",
+	   C_RH_MODES[j],
+	   (ht.prev_key_elts != NULL) ? "yes" : "no",
+	   (float)t / CLOCKS_PER_SEC);
+    for (k = 0; k < C_NUM_LKS_COUNT; k++){
+      t_lk = clock();
+      ht_muloa_search_interleave(&ht,
+				 keys,
+				 lk_elts,
+				 2 * num_ins,
+				 lks,
+				 C_NUM_LKS[k]);
+      t_lk = clock() - t_lk;
+      for (i = 0; i < 2 * num_ins; i++){
+	res *= (elts[i] == lk_elts[i]);
+	if (keys[i] < num_present){
+	  res *= (lk_elts[i] != NULL && *(size_t *)lk_elts[i] == keys[i]);
+	}else{
+	  res *= (lk_elts[i] == NULL);
+	}
+      }
+      printf("\t\t\t%2lu in flight search time:     %.4f seconds\n",
+	     TOLU(C_NUM_LKS[k]),
+	     (float)t_lk / CLOCKS_PER_SEC);
+    }
+    ht_muloa_search_interleave(&ht, keys, lk_elts, 0, lks, 1);
+    ht_muloa_free(&ht);
+    for (i = 0; i < 2 * num_ins; i++){
+      keys[i] = i;
+    }
+  }
+  printf("\t\tcorrectness:                        ");
+  print_test_result(res);
+  free(keys);
+  free(elts);
+  free(lk_elts);
+  free(lks);
+  keys = NULL;
+  elts = NULL;
+  lk_elts = NULL;
+  lks = NULL;
+}
+
 /**
    Runs a corner cases test.
 */
@@ -730,6 +1347,31 @@ void run_corner_cases_test(int log_ins){
 	  ht.num_elts == 0 &&
 	  ht_muloa_search(&ht, &C_CORNER_KEY_A) == NULL &&
 	  ht_muloa_search(&ht, &C_CORNER_KEY_B) == NULL);
+  ht_muloa_free(&ht);
+  /* a large min_num with the bytes of ht set as if not initialized */
+  memset(&ht, 0xff, sizeof(ht_muloa_t));
+  ht_muloa_init(&ht,
+		sizeof(size_t),
+		elt_size,
+		C_MIN_NUM,
+		C_MIN_NUM_ALPHA_N,
+		C_MIN_NUM_LOG_ALPHA_D,
+		NULL,
+		NULL,
+		NULL);
+  ht_muloa_align(&ht, elt_alignment);
+  res *= (ht.alpha_n == C_MIN_NUM_ALPHA_N &&
+	  ht.log_alpha_d == C_MIN_NUM_LOG_ALPHA_D &&
+	  ht.count / pow_two_perror(C_MIN_NUM_LOG_ALPHA_D) *
+	  C_MIN_NUM_ALPHA_N >= C_MIN_NUM);
+  num_ins = ht.count;
+  for (i = 0; i < C_MIN_NUM; i++){
+    ht_muloa_insert(&ht, &i, &i);
+  }
+  res *= (ht.count == num_ins && ht.num_elts == C_MIN_NUM);
+  for (i = 0; i < C_MIN_NUM; i++){
+    res *= (*(size_t *)ht_muloa_search(&ht, &i) == i);
+  }
   print_test_result(res);
   free_ht(&ht);
 }
@@ -761,7 +1403,7 @@ int main(int argc, char *argv[]){
   size_t *args = NULL;
   RGENS_SEED();
   if (argc > C_ARGC_MAX){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
@@ -784,8 +1426,14 @@ int main(int argc, char *argv[]){
       args[8] > 1 ||
       args[9] > 1 ||
       args[10] > 1 ||
-      args[11] > 1){
-    fprintf(stderr, "USAGE:\n%s", C_USAGE);
+      args[11] > 1 ||
+      args[12] > 1 ||
+      args[13] > 1 ||
+      args[14] > 1 ||
+      args[15] > 1 ||
+      args[16] > 1 ||
+      args[17] > 1){
+    fprintf(stderr, "USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   };
   if (args[7]) run_insert_search_free_uint_test(args[0],
@@ -817,6 +1465,12 @@ int main(int argc, char *argv[]){
 						args[5],
 						args[6]);
   if (args[11]) run_corner_cases_test(args[0]);
+  if (args[12]) run_incr_grow_test(args[0], args[4], args[5]);
+  if (args[13]) run_stats_test(args[0], args[4], args[5]);
+  if (args[14]) run_churn_test(args[0], args[4], args[5]);
+  if (args[15]) run_robin_hood_test(args[0], args[4], args[5]);
+  if (args[16]) run_search_batch_test(args[0], args[4], args[5]);
+  if (args[17]) run_search_interleave_test(args[0], args[4], args[5]);
   free(args);
   args = NULL;
   return 0;
@@ -45,10 +45,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
 #include "ht-muloa.h"
 #include "utilities-mem.h"
 #include "utilities-mod.h"
 
+#if defined(__GNUC__) && !defined(HT_MULOA_NO_PREFETCH)
+#define HT_MULOA_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define HT_MULOA_PREFETCH(p) ((void)(p))
+#endif
+
 static const size_t C_FIRST_PRIME_PARTS[1 + 8 * (2 + 3 + 4)] =
   {0xbe21u,                            /* 2**15 < 48673 < 2**16 */
    0xd8d5u, 0x0002u,                   /* 2**17 < 186581 < 2**18 */
@@ -74,7 +81,7 @@ static const size_t C_FIRST_PRIME_PARTS[1 + 8 * (2 + 3 + 4)] =
    0x6f8fu, 0x423bu, 0x8949u, 0x0304u, /* 2**57 < 217449629757435791 < 2**58 */
    0xbbc1u, 0x662cu, 0x4d90u, 0x0badu, /* 2**59 < 841413987972987841 < 2**60 */
    0xc647u, 0x3c91u, 0x46b2u, 0x2e9bu, /* 2**61 < 3358355678469146183 < 2**62 */
-   0x8969u, 0x4c70u, 0x6dbeu, 0xdad8u  /* 2**63 < 15769474759331449193 < 2**64 */
+   0x8969u, 0x4c70u, 0x6dbeu, 0xdad8u /* 2**63 < 15769474759331449193 < 2**64 */
   }; 
 
 static const size_t C_SECOND_PRIME_PARTS[1 + 8 * (2 + 3 + 4)] =
@@ -102,7 +109,7 @@ static const size_t C_SECOND_PRIME_PARTS[1 + 8 * (2 + 3 + 4)] =
    0x03a7u, 0x5cb0u, 0xba89u, 0x0302u, /* 2**57 < 216940831195530151 < 2**58 */
    0x12adu, 0x7477u, 0xb251u, 0x0c10u, /* 2**59 < 869390790998561453 < 2**60 */
    0xe411u, 0x4bacu, 0x9c82u, 0x2f17u, /* 2**61 < 3393352927676261393 < 2**62 */
-   0xd047u, 0x33a5u, 0x5cb7u, 0xbd8fu  /* 2**63 < 13659238136753279047 < 2**64 */
+   0xd047u, 0x33a5u, 0x5cb7u, 0xbd8fu /* 2**63 < 13659238136753279047 < 2**64 */
   };
 
 static const size_t C_LAST_PRIME_IX = 1 + 8 * (2 + 3 + 4) - 4;
@@ -117,6 +124,12 @@ static const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 static const size_t C_LOG_COUNT_MIN = 8; /* > 0 */
 static const size_t C_LOG_COUNT_MAX = CHAR_BIT * sizeof(size_t) - 1;
 
+/* number of keys hashed and prefetched before their searches in a batch */
+enum{C_BATCH_GROUP = 16};
+
+/* next memory access of a lookup */
+enum{C_LOOKUP_SLOT, C_LOOKUP_KE, C_LOOKUP_DONE};
+
 /* placeholder handling */
 static ke_t *ph_new();
 static int is_ph(const ke_t *ke);
@@ -136,14 +149,44 @@ static void ke_free(const ht_muloa_t *ht, ke_t *ke);
 /* hashing */
 static size_t convert_std_key(const ht_muloa_t *ht, const void *key);
 static size_t adjust_dist(size_t dist);
+static size_t probe_dist(const ht_muloa_t *ht, size_t sval, size_t log_count);
+static size_t rh_disp(const ke_t *ke, size_t ix, size_t log_count);
 
 /* hash table operations and maintenance*/
-static ke_t **search(const ht_muloa_t *ht, const void *key);
+static ke_t **search(const ht_muloa_t *ht, const void *key, int *is_prev);
+static ke_t **search_hashed(const ht_muloa_t *ht,
+			    const void *key,
+			    size_t fval,
+			    size_t sval,
+			    int *is_prev);
+static ke_t **search_slots(const ht_muloa_t *ht,
+			   ke_t * const *key_elts,
+			   size_t log_count,
+			   size_t max_num_probes,
+			   const void *key,
+			   size_t fval,
+			   size_t sval);
+static void lookup_probe(const ht_muloa_t *ht,
+			 ht_muloa_lookup_t *lk,
+			 int is_prev);
+static int lookup_advance(const ht_muloa_t *ht, ht_muloa_lookup_t *lk);
+static int lookup_stop(const ht_muloa_t *ht, ht_muloa_lookup_t *lk);
 static size_t mul_alpha(size_t n, size_t alpha_n, size_t log_alpha_d);
 static int incr_count(ht_muloa_t *ht);
 static void ht_grow(ht_muloa_t *ht);
 static void ht_clean(ht_muloa_t *ht);
+static void rehash(ht_muloa_t *ht, size_t prev_log_count);
+static size_t incr_num_slots(const ht_muloa_t *ht);
+static void move_slots(ht_muloa_t *ht, size_t num_slots);
 static void reinsert(ht_muloa_t *ht, const ke_t *prev_ke);
+static void rh_insert(ht_muloa_t *ht, size_t ix, size_t num_probes, ke_t *ke);
+static void vacate(ht_muloa_t *ht, ke_t **ke, int is_prev);
+static void add_probe_lens(const ht_muloa_t *ht,
+			   ke_t * const *key_elts,
+			   size_t log_count,
+			   size_t start,
+			   size_t *hist,
+			   size_t hist_count);
 
 /* integer constant construction */
 static size_t find_build_prime(const size_t *parts);
@@ -215,6 +258,8 @@ void ht_muloa_init(ht_muloa_t *ht,
   ht->elt_alignment = 1;
   ht->log_count = C_LOG_COUNT_MIN;
   ht->count = pow_two_perror(C_LOG_COUNT_MIN);
+  ht->alpha_n = alpha_n;
+  ht->log_alpha_d = log_alpha_d;
   /* 0 <= max_sum < count */
   ht->max_sum = mul_alpha(ht->count, alpha_n, log_alpha_d);
   if (ht->max_sum == ht->count) ht->max_sum = ht->count - 1;
@@ -224,13 +269,22 @@ void ht_muloa_init(ht_muloa_t *ht,
   ht->num_phs = 0;
   ht->fprime = find_build_prime(C_FIRST_PRIME_PARTS);
   ht->sprime = find_build_prime(C_SECOND_PRIME_PARTS);
-  ht->alpha_n = alpha_n;
-  ht->log_alpha_d = log_alpha_d;
   ht->ph = ph_new();
-  ht->key_elts = malloc_perror(ht->count, sizeof(ke_t *));
+  ht->key_elts = malloc_large_perror(ht->count, sizeof(ke_t *));
   for (i = 0; i < ht->count; i++){
     ht->key_elts[i] = NULL;
   }
+  ht->incr_num_slots = 0;
+  ht->is_rh = 0;
+  ht->prev_log_count = 0;
+  ht->prev_count = 0;
+  ht->prev_max_num_probes = 0;
+  ht->prev_ix = 0;
+  ht->prev_key_elts = NULL;
+  ht->num_grows = 0;
+  ht->num_cleans = 0;
+  ht->num_moves = 0;
+  ht->resize_clocks = 0;
   ht->cmp_key = cmp_key;
   ht->rdc_key = rdc_key;
   ht->free_elt = free_elt;
@@ -266,51 +320,147 @@ void ht_muloa_align(ht_muloa_t *ht, size_t elt_alignment){
   }
 }
 
+/**
+   Sets an incremental growth mode of a hash table. In the mode, a growth
+   step, or an elimination of placeholders, allocates the next slots, and
+   the keys in the previous slots are moved to the next slots in parts of
+   at most num_slots previous slots at the beginning of each remove and
+   delete operation, and in parts of at least num_slots previous slots at
+   the beginning of each insert operation, s.t. all keys are moved before
+   alpha is exceeded again, instead of moving all keys within a single
+   insert operation. Until all keys are moved, a search or modifying
+   operation accesses the previous and the next slots. The allocation and
+   initialization of the next slots remain in the insert operation that
+   exceeded alpha. The operation is optionally called after ht_muloa_init
+   and ht_muloa_align are completed and before any other operation is
+   called.
+   ht          : pointer to an initialized ht_muloa_t struct
+   num_slots   : > 0 number of previous slots with their keys moved in one
+                 operation; a larger number completes the move of keys in
+                 fewer operations at the expense of a larger operation
+                 cost during the move
+*/
+void ht_muloa_incr_grow(ht_muloa_t *ht, size_t num_slots){
+  ht->incr_num_slots = num_slots;
+}
+
+/**
+   Sets a Robin Hood mode of a hash table. In the mode, collisions are
+   resolved by linear probing, and an inserted key takes the slot of a key
+   that is closer to the first slot of its probe sequence, which continues
+   to be inserted from the next slot, so that the variance of the number
+   of probes is reduced. A search that reaches a key closer to the first
+   slot of its probe sequence than the searched key stops, because the
+   searched key is not in the hash table. A delete or remove operation
+   shifts the subsequent keys of a probe sequence backward instead of
+   leaving a placeholder. The probe sequence of a key is within adjacent
+   slots, and the number of probes in a search is upper-bounded by
+   max_num_probes. The operation is optionally called after ht_muloa_init
+   and ht_muloa_align are completed and before any other operation is
+   called, and can be combined with ht_muloa_incr_grow.
+   ht          : pointer to an initialized ht_muloa_t struct
+*/
+void ht_muloa_robin_hood(ht_muloa_t *ht){
+  ht->is_rh = 1;
+}
+
 /**
    Inserts a key and an associated element into a hash table. If the key is
    in the hash table, associates the key with the new element. The key and 
    elt parameters are not NULL and point to blocks of size key_size and
-   elt_size respectively.
+   elt_size respectively. A new key is inserted into the first placeholder
+   in its probe sequence, if any, before the first empty slot, so that
+   the slots of deleted keys are recycled without a cleanup.
 */
 void ht_muloa_insert(ht_muloa_t *ht, const void *key, const void *elt){
   size_t num_probes = 1;
   size_t std_key;
   size_t fval, sval;
   size_t ix, dist;
+  clock_t start;
   ke_t **ke = NULL;
+  ke_t **ph_ke = NULL;
+  if (ht->prev_key_elts != NULL) move_slots(ht, incr_num_slots(ht));
   std_key = convert_std_key(ht, key);
   fval = ht->fprime * std_key; /* mod 2**C_FULL_BIT */
   sval = ht->sprime * std_key; /* mod 2**C_FULL_BIT */
-  ix = fval >> (C_FULL_BIT - ht->log_count);
-  dist = adjust_dist(sval >> (C_FULL_BIT - ht->log_count));
-  ke = &ht->key_elts[ix];
-  while (*ke != NULL){
-    if (ht->cmp_key != NULL && /* loop invariant */
-	!is_ph(*ke) &&
-	ht->cmp_key(ke_key_ptr(ht, *ke), key) == 0){
+  if (ht->prev_key_elts != NULL){
+    ke = search_slots(ht,
+		      ht->prev_key_elts,
+		      ht->prev_log_count,
+		      ht->prev_max_num_probes,
+		      key,
+		      fval,
+		      sval);
+    if (ke != NULL){
       ke_elt_update(ht, *ke, elt);
       return;
-    }else if (ht->cmp_key == NULL && /* loop invariant */
-	      !is_ph(*ke) &&
-	      memcmp(ke_key_ptr(ht, *ke), key, ht->key_size) == 0){
+    }
+  }
+  ix = fval >> (C_FULL_BIT - ht->log_count);
+  fval -= fval & 1; /* 1st bit not used in hashing => 1 as ph identifier */
+  if (ht->is_rh){
+    ke = search_slots(ht,
+		      ht->key_elts,
+		      ht->log_count,
+		      ht->max_num_probes,
+		      key,
+		      fval,
+		      sval);
+    if (ke != NULL){
       ke_elt_update(ht, *ke, elt);
       return;
     }
-    ix = sum_mod(dist, ix, ht->count);
+    rh_insert(ht, ix, 1, ke_new(ht, fval, sval, key, elt));
+  }else{
+    dist = probe_dist(ht, sval, ht->log_count);
     ke = &ht->key_elts[ix];
-    num_probes++;
-    if (num_probes > ht->max_num_probes) ht->max_num_probes++;
+    /* a key is within max_num_probes probes of its probe sequence */
+    while (*ke != NULL && num_probes <= ht->max_num_probes){
+      if (is_ph(*ke)){
+	if (ph_ke == NULL) ph_ke = ke;
+      }else if (ht->cmp_key != NULL && /* loop invariant */
+		ht->cmp_key(ke_key_ptr(ht, *ke), key) == 0){
+	ke_elt_update(ht, *ke, elt);
+	return;
+      }else if (ht->cmp_key == NULL && /* loop invariant */
+		memcmp(ke_key_ptr(ht, *ke), key, ht->key_size) == 0){
+	ke_elt_update(ht, *ke, elt);
+	return;
+      }
+      ix = sum_mod(dist, ix, ht->count);
+      ke = &ht->key_elts[ix];
+      num_probes++;
+    }
+    if (ph_ke == NULL){
+      while (*ke != NULL && !is_ph(*ke)){
+	ix = sum_mod(dist, ix, ht->count);
+	ke = &ht->key_elts[ix];
+	num_probes++;
+      }
+      if (num_probes > ht->max_num_probes) ht->max_num_probes = num_probes;
+      if (*ke != NULL) ph_ke = ke;
+    }
+    if (ph_ke != NULL){
+      ke = ph_ke;
+      ht->num_phs--;
+    }
+    *ke = ke_new(ht, fval, sval, key, elt);
   }
-  fval -= fval & 1; /* 1st bit not used in hashing => 1 as ph identifier */
-  *ke = ke_new(ht, fval, sval, key, elt);
   ht->num_elts++;
   /* max_sum < count; grow ht after ensuring it was insertion, not update */
   if (ht->num_elts + ht->num_phs > ht->max_sum){
+    start = clock();
+    /* complete the move of keys of an incremental step */
+    if (ht->prev_key_elts != NULL) move_slots(ht, ht->prev_count);
     if (ht->num_elts < ht->num_phs){
       ht_clean(ht);
+      ht->num_cleans++;
     }else if (ht->log_count < C_LOG_COUNT_MAX){
       ht_grow(ht);
+      ht->num_grows++;
     }
+    ht->resize_clocks += clock() - start;
   }
 }
 
@@ -321,7 +471,7 @@ void ht_muloa_insert(ht_muloa_t *ht, const void *key, const void *elt){
    according to ht_muloa_init and ht_muloa_align_elt.
 */
 void *ht_muloa_search(const ht_muloa_t *ht, const void *key){
-  ke_t * const *ke = search(ht, key);
+  ke_t * const *ke = search(ht, key, NULL);
   if (ke != NULL){
     return ke_elt_ptr(ht, *ke);
   }else{
@@ -329,6 +479,157 @@ void *ht_muloa_search(const ht_muloa_t *ht, const void *key){
   }
 }
 
+/**
+   Searches a batch of keys in a hash table. Sets batch_elts[i] to a
+   pointer to the element associated with the ith key, if the key is
+   present, and to NULL otherwise. The batch_keys parameter is not NULL and
+   points to an array of batch_count blocks of size key_size, and the
+   batch_elts parameter is not NULL and points to an array of batch_count
+   pointers. The keys are processed in groups: the keys of a group are
+   hashed and their first slots are prefetched, then the blocks pointed to
+   by the first slots are prefetched, and then the keys are searched, so
+   that the cache misses of the keys in a group overlap. The pointers can
+   be dereferenced according to ht_muloa_search.
+*/
+void ht_muloa_search_batch(const ht_muloa_t *ht,
+			   const void *batch_keys,
+			   void **batch_elts,
+			   size_t batch_count){
+  size_t i, j, n;
+  size_t std_key;
+  size_t fvals[C_BATCH_GROUP], svals[C_BATCH_GROUP];
+  ke_t * const *slots[C_BATCH_GROUP];
+  ke_t * const *ke = NULL;
+  const char *keys = batch_keys;
+  for (i = 0; i < batch_count; i += n){
+    n = batch_count - i;
+    if (n > C_BATCH_GROUP) n = C_BATCH_GROUP;
+    for (j = 0; j < n; j++){
+      std_key = convert_std_key(ht, keys + (i + j) * ht->key_size);
+      fvals[j] = ht->fprime * std_key; /* mod 2**FULL_BIT */
+      svals[j] = ht->sprime * std_key; /* mod 2**FULL_BIT */
+      slots[j] = &ht->key_elts[fvals[j] >> (C_FULL_BIT - ht->log_count)];
+      HT_MULOA_PREFETCH(slots[j]);
+    }
+    for (j = 0; j < n; j++){
+      if (*slots[j] != NULL) HT_MULOA_PREFETCH(ke_key_ptr(ht, *slots[j]));
+    }
+    for (j = 0; j < n; j++){
+      ke = search_hashed(ht,
+			 keys + (i + j) * ht->key_size,
+			 fvals[j],
+			 svals[j],
+			 NULL);
+      batch_elts[i + j] = (ke == NULL) ? NULL : ke_elt_ptr(ht, *ke);
+    }
+  }
+}
+
+/**
+   Starts a lookup of a key as a resumable state machine, and prefetches
+   the first slot of its probe sequence. The key parameter is not NULL and
+   points to a block of size key_size that is not modified until the
+   lookup is completed. A lookup is advanced with ht_muloa_lookup_step, so
+   that the lookups of independent requests are interleaved by a caller at
+   their memory accesses. No modifying operation is called on ht until
+   the lookups of ht are completed.
+   ht          : pointer to an initialized ht_muloa_t struct
+   lk          : pointer to a preallocated block of size
+                 sizeof(ht_muloa_lookup_t)
+   key         : pointer to a key
+*/
+void ht_muloa_lookup_init(const ht_muloa_t *ht,
+			  ht_muloa_lookup_t *lk,
+			  const void *key){
+  size_t std_key = convert_std_key(ht, key);
+  lk->key = key;
+  lk->elt = NULL;
+  lk->fval = ht->fprime * std_key; /* mod 2**FULL_BIT */
+  lk->sval = ht->sprime * std_key; /* mod 2**FULL_BIT */
+  lookup_probe(ht, lk, 0);
+}
+
+/**
+   Advances a lookup by one memory access, i.e. a slot or a key element
+   block prefetched by the previous call, and prefetches the memory of the
+   next access. Returns 1 if the lookup is completed, in which case lk->elt
+   is set according to ht_muloa_search, and 0 otherwise. A completed
+   lookup is not advanced further by subsequent calls.
+*/
+int ht_muloa_lookup_step(const ht_muloa_t *ht, ht_muloa_lookup_t *lk){
+  size_t log_count;
+  const ke_t *ke = NULL;
+  if (lk->state == C_LOOKUP_DONE) return 1;
+  if (lk->is_prev){
+    ke = ht->prev_key_elts[lk->ix];
+    log_count = ht->prev_log_count;
+  }else{
+    ke = ht->key_elts[lk->ix];
+    log_count = ht->log_count;
+  }
+  if (lk->state == C_LOOKUP_SLOT){
+    if (ke == NULL) return lookup_stop(ht, lk);
+    if (is_ph(ke)) return lookup_advance(ht, lk);
+    HT_MULOA_PREFETCH(ke_key_ptr(ht, ke));
+    lk->state = C_LOOKUP_KE;
+    return 0;
+  }
+  if (ht->is_rh && rh_disp(ke, lk->ix, log_count) < lk->num_probes - 1){
+    return lookup_stop(ht, lk);
+  }else if ((ht->cmp_key != NULL &&
+	     ht->cmp_key(ke_key_ptr(ht, ke), lk->key) == 0) ||
+	    (ht->cmp_key == NULL &&
+	     memcmp(ke_key_ptr(ht, ke), lk->key, ht->key_size) == 0)){
+    lk->elt = ke_elt_ptr(ht, ke);
+    lk->state = C_LOOKUP_DONE;
+    return 1;
+  }
+  return lookup_advance(ht, lk);
+}
+
+/**
+   Searches keys with up to num_lks lookups in flight, which are advanced
+   in a round-robin order by ht_muloa_lookup_step, and a completed lookup
+   is replaced by the lookup of the next key, so that a long probe
+   sequence delays only its own key. Sets elts[i] to a pointer to the
+   element associated with the ith key, if the key is present, and to NULL
+   otherwise. The keys parameter points to an array of count blocks of size
+   key_size, elts points to an array of count pointers, and lks points to
+   an array of num_lks > 0 preallocated ht_muloa_lookup_t structs.
+*/
+void ht_muloa_search_interleave(const ht_muloa_t *ht,
+				const void *keys,
+				void **elts,
+				size_t count,
+				ht_muloa_lookup_t *lks,
+				size_t num_lks){
+  size_t i, j;
+  size_t num_active = 0;
+  const char *ks = keys;
+  for (i = 0; i < count && num_active < num_lks; i++){
+    ht_muloa_lookup_init(ht, &lks[num_active], ks + i * ht->key_size);
+    num_active++;
+  }
+  while (num_active > 0){
+    j = 0;
+    while (j < num_active){
+      if (!ht_muloa_lookup_step(ht, &lks[j])){
+	j++;
+	continue;
+      }
+      elts[((const char *)lks[j].key - ks) / ht->key_size] = lks[j].elt;
+      if (i < count){
+	ht_muloa_lookup_init(ht, &lks[j], ks + i * ht->key_size);
+	i++;
+	j++;
+      }else{
+	num_active--;
+	lks[j] = lks[num_active];
+      }
+    }
+  }
+}
+
 /**
    Removes a key and its associated element from a hash table by copying 
    the element or its pointer into a block of size elt_size pointed to
@@ -337,14 +638,16 @@ void *ht_muloa_search(const ht_muloa_t *ht, const void *key){
    to blocks of size key_size and elt_size respectively.
 */
 void ht_muloa_remove(ht_muloa_t *ht, const void *key, void *elt){
-  ke_t **ke = search(ht, key);
+  int is_prev;
+  ke_t **ke = NULL;
+  if (ht->prev_key_elts != NULL) move_slots(ht, ht->incr_num_slots);
+  ke = search(ht, key, &is_prev);
   if (ke != NULL){
     memcpy(elt, ke_elt_ptr(ht, *ke), ht->elt_size);
     /* if an element is noncontiguous, only the pointer to it is deleted */
     free(ke_key_ptr(ht, *ke));
-    *ke = ht->ph;
+    vacate(ht, ke, is_prev);
     ht->num_elts--;
-    ht->num_phs++;
   }
 }
 
@@ -354,12 +657,104 @@ void ht_muloa_remove(ht_muloa_t *ht, const void *key, void *elt){
    to a block of size key_size.
 */
 void ht_muloa_delete(ht_muloa_t *ht, const void *key){
-  ke_t **ke = search(ht, key);
+  int is_prev;
+  ke_t **ke = NULL;
+  if (ht->prev_key_elts != NULL) move_slots(ht, ht->incr_num_slots);
+  ke = search(ht, key, &is_prev);
   if (ke != NULL){
     ke_free(ht, *ke);
-    *ke = ht->ph;
+    vacate(ht, ke, is_prev);
     ht->num_elts--;
-    ht->num_phs++;
+  }
+}
+
+/**
+   Deletes all keys and their associated elements from a hash table
+   according to free_elt, keeping the count of slots of the hash table,
+   so that the hash table can be reused without growth steps. Completes
+   an incremental growth step, if any, by deleting the keys that were not
+   moved. Runs in O(count) time.
+*/
+void ht_muloa_reset(ht_muloa_t *ht){
+  size_t i;
+  ke_t **ke = NULL;
+  for (i = 0; i < ht->count; i++){
+    ke = &ht->key_elts[i];
+    if (*ke != NULL && !is_ph(*ke)){
+      ke_free(ht, *ke);
+    }
+    *ke = NULL;
+  }
+  if (ht->prev_key_elts != NULL){
+    for (i = ht->prev_ix; i < ht->prev_count; i++){
+      ke = &ht->prev_key_elts[i];
+      if (*ke != NULL && !is_ph(*ke)){
+	ke_free(ht, *ke);
+      }
+    }
+    free_large(ht->prev_key_elts);
+    ht->prev_log_count = 0;
+    ht->prev_count = 0;
+    ht->prev_max_num_probes = 0;
+    ht->prev_ix = 0;
+    ht->prev_key_elts = NULL;
+  }
+  ht->num_elts = 0;
+  ht->num_phs = 0;
+}
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_muloa_stats_t) pointed to by s, and optionally computes a
+   histogram of probe lengths, where a probe length of a key is the number
+   of probes in its search. The counts of grow and clean steps, the count
+   of moved keys, and the processor time of grow and clean steps, measured
+   with clock, are accumulated since ht_muloa_init and are not cleared by
+   ht_muloa_reset. In an incremental growth mode, the processor time
+   includes the allocation of next slots and the completion of a move of
+   keys in an insert operation that exceeded alpha, but not the moves of
+   keys in parts, which are counted in num_moves. The ratio of num_phs and
+   count is the placeholder ratio, and the ratio of num_elts + num_phs and
+   count is the load factor of the next slots. Runs in O(count) time and
+   the expected time of a search per key for a histogram.
+   ht          : pointer to an initialized ht_muloa_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_muloa_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of keys with a probe
+                 length i + 1 for i < hist_count - 1, and
+                 hist[hist_count - 1] to the number of keys with a probe
+                 length >= hist_count; the probe length of a key in the
+                 previous slots of an incremental growth step is relative
+                 to the previous slots
+   hist_count  : > 0 if hist is not NULL
+*/
+void ht_muloa_stats(const ht_muloa_t *ht,
+		    ht_muloa_stats_t *s,
+		    size_t *hist,
+		    size_t hist_count){
+  size_t i;
+  s->count = ht->count;
+  s->num_elts = ht->num_elts;
+  s->num_phs = ht->num_phs;
+  s->max_num_probes = ht->max_num_probes;
+  s->num_grows = ht->num_grows;
+  s->num_cleans = ht->num_cleans;
+  s->num_moves = ht->num_moves;
+  s->resize_clocks = ht->resize_clocks;
+  if (hist == NULL) return;
+  for (i = 0; i < hist_count; i++){
+    hist[i] = 0;
+  }
+  add_probe_lens(ht, ht->key_elts, ht->log_count, 0, hist, hist_count);
+  if (ht->prev_key_elts != NULL){
+    add_probe_lens(ht,
+		   ht->prev_key_elts,
+		   ht->prev_log_count,
+		   ht->prev_ix,
+		   hist,
+		   hist_count);
   }
 }
 
@@ -376,10 +771,20 @@ void ht_muloa_free(ht_muloa_t *ht){
       ke_free(ht, *ke);
     }
   }
+  if (ht->prev_key_elts != NULL){
+    for (i = ht->prev_ix; i < ht->prev_count; i++){
+      ke = &ht->prev_key_elts[i];
+      if (*ke != NULL && !is_ph(*ke)){
+	ke_free(ht, *ke);
+      }
+    }
+  }
   ph_free(ht->ph);
-  free(ht->key_elts);
+  free_large(ht->key_elts);
+  free_large(ht->prev_key_elts);
   ht->ph = NULL;
   ht->key_elts = NULL;
+  ht->prev_key_elts = NULL;
 }
 
 /**
@@ -431,6 +836,10 @@ void ht_muloa_delete_helper(void *ht, const void *key){
   ht_muloa_delete(ht, key);
 }
 
+void ht_muloa_reset_helper(void *ht){
+  ht_muloa_reset(ht);
+}
+
 void ht_muloa_free_helper(void *ht){
   ht_muloa_free(ht);
 }
@@ -547,23 +956,101 @@ static size_t adjust_dist(size_t dist){
   return ret;
 }
 
+/**
+   Returns the probe distance of a key with the second hash value sval in
+   an array of 2**log_count slots, which is 1 in the Robin Hood mode.
+*/
+static size_t probe_dist(const ht_muloa_t *ht, size_t sval, size_t log_count){
+  if (ht->is_rh) return 1;
+  return adjust_dist(sval >> (C_FULL_BIT - log_count));
+}
+
+/**
+   Returns the number of slots from the first slot of the probe sequence
+   of a key to the slot ix that stores the key in an array of
+   2**log_count slots in the Robin Hood mode.
+*/
+static size_t rh_disp(const ke_t *ke, size_t ix, size_t log_count){
+  size_t mask = ((size_t)1 << log_count) - 1;
+  return (ix - (ke->fval >> (C_FULL_BIT - log_count))) & mask;
+}
+
 /**
    If a key is present in a hash table, returns a pointer to a slot
-   in the key_elts array that stores a pointer to ke_t with the
-   key, otherwise returns NULL.
+   in the key_elts array, or in the prev_key_elts array if the keys of an
+   incremental step are being moved, that stores a pointer to ke_t with the
+   key, otherwise returns NULL. If is_prev is not NULL and the key is
+   present, sets the int pointed to by is_prev to 1 if the slot is in the
+   prev_key_elts array and to 0 otherwise.
+*/
+static ke_t **search(const ht_muloa_t *ht, const void *key, int *is_prev){
+  size_t std_key = convert_std_key(ht, key);
+  return search_hashed(ht,
+		       key,
+		       ht->fprime * std_key, /* mod 2**FULL_BIT */
+		       ht->sprime * std_key, /* mod 2**FULL_BIT */
+		       is_prev);
+}
+
+/**
+   Searches a key with hash values fval and sval according to search.
 */
-static ke_t **search(const ht_muloa_t *ht, const void *key){
+static ke_t **search_hashed(const ht_muloa_t *ht,
+			    const void *key,
+			    size_t fval,
+			    size_t sval,
+			    int *is_prev){
+  ke_t **ke = NULL;
+  ke = search_slots(ht,
+		    ht->key_elts,
+		    ht->log_count,
+		    ht->max_num_probes,
+		    key,
+		    fval,
+		    sval);
+  if (is_prev != NULL) *is_prev = 0;
+  if (ke == NULL && ht->prev_key_elts != NULL){
+    ke = search_slots(ht,
+		      ht->prev_key_elts,
+		      ht->prev_log_count,
+		      ht->prev_max_num_probes,
+		      key,
+		      fval,
+		      sval);
+    if (is_prev != NULL) *is_prev = 1;
+  }
+  return ke;
+}
+
+/**
+   If a key with hash values fval and sval is present in an array of
+   2**log_count slots, returns a pointer to a slot that stores a pointer
+   to ke_t with the key, otherwise returns NULL. In the Robin Hood mode,
+   the search stops at a key that is closer to the first slot of its probe
+   sequence than the searched key would be, and continues at a
+   placeholder, which is only in the previous slots of an incremental
+   growth step.
+*/
+static ke_t **search_slots(const ht_muloa_t *ht,
+			   ke_t * const *key_elts,
+			   size_t log_count,
+			   size_t max_num_probes,
+			   const void *key,
+			   size_t fval,
+			   size_t sval){
   size_t num_probes = 1;
-  size_t std_key, fval, sval, ix, dist;
+  size_t ix, dist;
+  size_t count = (size_t)1 << log_count;
   ke_t * const *ke = NULL;
-  std_key = convert_std_key(ht, key);
-  fval = ht->fprime * std_key; /* mod 2**FULL_BIT */
-  sval = ht->sprime * std_key; /* mod 2**FULL_BIT */
-  ix = fval >> (C_FULL_BIT - ht->log_count);
-  dist = adjust_dist(sval >> (C_FULL_BIT - ht->log_count));
-  ke = &ht->key_elts[ix];
+  ix = fval >> (C_FULL_BIT - log_count);
+  dist = probe_dist(ht, sval, log_count);
+  ke = &key_elts[ix];
   while (*ke != NULL){
-    if (ht->cmp_key != NULL && /* loop invariant */
+    if (ht->is_rh && /* loop invariant */
+	!is_ph(*ke) &&
+	rh_disp(*ke, ix, log_count) < num_probes - 1){
+      break;
+    }else if (ht->cmp_key != NULL && /* loop invariant */
 	!is_ph(*ke) &&
 	ht->cmp_key(ke_key_ptr(ht, *ke), key) == 0){
       return (ke_t **)ke;
@@ -571,17 +1058,81 @@ static ke_t **search(const ht_muloa_t *ht, const void *key){
 	      !is_ph(*ke) &&
 	      memcmp(ke_key_ptr(ht, *ke), key, ht->key_size) == 0){
       return (ke_t **)ke;
-    }else if (num_probes == ht->max_num_probes){
+    }else if (num_probes == max_num_probes){
       break;
     }else{
-      ix = sum_mod(dist, ix, ht->count);
-      ke = &ht->key_elts[ix];
+      ix = sum_mod(dist, ix, count);
+      ke = &key_elts[ix];
       num_probes++;
     }
   }
   return NULL;
 }
 
+/**
+   Sets a lookup to the first slot of the probe sequence of its key in the
+   next slots if is_prev is 0 and in the previous slots otherwise, and
+   prefetches the slot.
+*/
+static void lookup_probe(const ht_muloa_t *ht,
+			 ht_muloa_lookup_t *lk,
+			 int is_prev){
+  size_t log_count = (is_prev) ? ht->prev_log_count : ht->log_count;
+  lk->ix = lk->fval >> (C_FULL_BIT - log_count);
+  lk->dist = probe_dist(ht, lk->sval, log_count);
+  lk->num_probes = 1;
+  lk->is_prev = is_prev;
+  lk->state = C_LOOKUP_SLOT;
+  if (is_prev){
+    HT_MULOA_PREFETCH(&ht->prev_key_elts[lk->ix]);
+  }else{
+    HT_MULOA_PREFETCH(&ht->key_elts[lk->ix]);
+  }
+}
+
+/**
+   Advances a lookup to the next slot of its probe sequence and prefetches
+   the slot, or stops the probe sequence if max_num_probes is reached.
+   Returns 1 if the lookup is completed, and 0 otherwise.
+*/
+static int lookup_advance(const ht_muloa_t *ht, ht_muloa_lookup_t *lk){
+  size_t max_num_probes, count;
+  if (lk->is_prev){
+    max_num_probes = ht->prev_max_num_probes;
+    count = ht->prev_count;
+  }else{
+    max_num_probes = ht->max_num_probes;
+    count = ht->count;
+  }
+  if (lk->num_probes == max_num_probes) return lookup_stop(ht, lk);
+  lk->ix = sum_mod(lk->dist, lk->ix, count);
+  lk->num_probes++;
+  lk->state = C_LOOKUP_SLOT;
+  if (lk->is_prev){
+    HT_MULOA_PREFETCH(&ht->prev_key_elts[lk->ix]);
+  }else{
+    HT_MULOA_PREFETCH(&ht->key_elts[lk->ix]);
+  }
+  return 0;
+}
+
+/**
+   Stops the probe sequence of a lookup whose key is not in the probed
+   slots. Continues in the previous slots if the next slots were probed
+   and the keys of an incremental growth step are being moved, and
+   otherwise completes the lookup. Returns 1 if the lookup is completed,
+   and 0 otherwise.
+*/
+static int lookup_stop(const ht_muloa_t *ht, ht_muloa_lookup_t *lk){
+  if (!lk->is_prev && ht->prev_key_elts != NULL){
+    lookup_probe(ht, lk, 1);
+    return 0;
+  }
+  lk->elt = NULL;
+  lk->state = C_LOOKUP_DONE;
+  return 1;
+}
+
 /**
    Multiplies an unsigned integer n by a load factor upper bound, represented
    by a numerator and log base 2 of a denominator. The denominator is a
@@ -604,27 +1155,13 @@ static size_t mul_alpha(size_t n, size_t alpha_n, size_t log_alpha_d){
        sufficient power of two is available, or
    ii) lowers the load factor as low as possible.
    The count is doubled at least once. If 2**C_LOG_COUNT_MAX is reached
-   log_count is set to C_LOG_COUNT_MAX.
+   log_count is set to C_LOG_COUNT_MAX. In an incremental growth mode, the
+   keys are moved to the next slots in subsequent operations.
 */
 static void ht_grow(ht_muloa_t *ht){
-  size_t i, prev_count = ht->count;
-  ke_t **prev_key_elts = ht->key_elts;
-  ke_t * const *ke = NULL;
+  size_t prev_log_count = ht->log_count;
   while (ht->num_elts + ht->num_phs > ht->max_sum && incr_count(ht));
-  ht->max_num_probes = 1;
-  ht->num_phs = 0;
-  ht->key_elts = malloc_perror(ht->count, sizeof(ke_t *));
-  for (i = 0; i < ht->count; i++){
-    ht->key_elts[i] = NULL;
-  }
-  for (i = 0; i < prev_count; i++){
-    ke = &prev_key_elts[i];
-    if (*ke != NULL && !is_ph(*ke)){
-      reinsert(ht, *ke);
-    }
-  }
-  free(prev_key_elts);
-  prev_key_elts = NULL;
+  rehash(ht, prev_log_count);
 }
 		      
 /**
@@ -648,25 +1185,74 @@ static int incr_count(ht_muloa_t *ht){
    If called when num_elts < num_placeholders, then for every delete/remove 
    operation at most one rehashing operation is performed, resulting in a 
    constant overhead of at most one rehashing per delete/remove operation.
+   In an incremental growth mode, the keys are moved to the next slots in
+   subsequent operations.
 */
 static void ht_clean(ht_muloa_t *ht){
+  rehash(ht, ht->log_count);
+}
+
+/**
+   Allocates the next slots of a hash table after the count was set, and
+   moves the keys in the previous 2**prev_log_count slots to the next slots,
+   or sets the move of the keys in an incremental growth mode.
+*/
+static void rehash(ht_muloa_t *ht, size_t prev_log_count){
   size_t i;
-  ke_t **prev_key_elts = ht->key_elts;
-  ke_t * const *ke = NULL;
+  ht->prev_log_count = prev_log_count;
+  ht->prev_count = (size_t)1 << prev_log_count;
+  ht->prev_max_num_probes = ht->max_num_probes;
+  ht->prev_ix = 0;
+  ht->prev_key_elts = ht->key_elts;
   ht->max_num_probes = 1;
   ht->num_phs = 0;
-  ht->key_elts = malloc_perror(ht->count, sizeof(ke_t *));
+  ht->key_elts = malloc_large_perror(ht->count, sizeof(ke_t *));
   for (i = 0; i < ht->count; i++){
     ht->key_elts[i] = NULL;
   }
-  for (i = 0; i < ht->count; i++){
-    ke = &prev_key_elts[i];
+  if (ht->incr_num_slots == 0) move_slots(ht, ht->prev_count);
+}
+
+/**
+   Returns the number of previous slots with keys to move in an insert
+   operation, which is at least incr_num_slots and is sufficient to move
+   all keys before the insert operation that exceeds alpha.
+*/
+static size_t incr_num_slots(const ht_muloa_t *ht){
+  size_t rem = ht->prev_count - ht->prev_ix; /* > 0 */
+  size_t d = 0, num_slots;
+  if (ht->max_sum > ht->num_elts + ht->num_phs){
+    d = ht->max_sum - ht->num_elts - ht->num_phs;
+  }
+  num_slots = (d == 0) ? rem : (rem - 1) / d + 1;
+  return (num_slots > ht->incr_num_slots) ? num_slots : ht->incr_num_slots;
+}
+
+/**
+   Moves the keys in at most num_slots previous slots to the next slots,
+   starting at prev_ix. A previous slot with a moved key is set to a
+   placeholder, so that the probe sequences in the previous slots are
+   maintained. Frees the previous slots after all keys were moved.
+*/
+static void move_slots(ht_muloa_t *ht, size_t num_slots){
+  size_t end = ht->prev_count;
+  ke_t **ke = NULL;
+  if (end - ht->prev_ix > num_slots) end = ht->prev_ix + num_slots;
+  for (; ht->prev_ix < end; ht->prev_ix++){
+    ke = &ht->prev_key_elts[ht->prev_ix];
     if (*ke != NULL && !is_ph(*ke)){
       reinsert(ht, *ke);
+      *ke = ht->ph;
     }
   }
-  free(prev_key_elts);
-  prev_key_elts = NULL;
+  if (ht->prev_ix == ht->prev_count){
+    free_large(ht->prev_key_elts);
+    ht->prev_log_count = 0;
+    ht->prev_count = 0;
+    ht->prev_max_num_probes = 0;
+    ht->prev_ix = 0;
+    ht->prev_key_elts = NULL;
+  }
 }
 
 /**
@@ -679,7 +1265,12 @@ static void reinsert(ht_muloa_t *ht, const ke_t *prev_ke){
   size_t ix, dist;
   ke_t **ke = NULL;
   ix = prev_ke->fval >> (C_FULL_BIT - ht->log_count);
-  dist = adjust_dist(prev_ke->sval >> (C_FULL_BIT - ht->log_count));
+  ht->num_moves++;
+  if (ht->is_rh){
+    rh_insert(ht, ix, 1, (ke_t *)prev_ke);
+    return;
+  }
+  dist = probe_dist(ht, prev_ke->sval, ht->log_count);
   ke = &ht->key_elts[ix];
   while (*ke != NULL){
     ix = sum_mod(dist, ix, ht->count);
@@ -690,6 +1281,91 @@ static void reinsert(ht_muloa_t *ht, const ke_t *prev_ke){
   *ke = (ke_t *)prev_ke;
 }
 
+/**
+   Inserts a pointer to ke_t with a key that is not in the next slots of a
+   hash table in the Robin Hood mode, starting at the slot ix that is
+   num_probes probes into the probe sequence of the key. At a slot with a
+   key that is closer to the first slot of its probe sequence, the keys are
+   swapped and the insertion continues with the key of the slot, until an
+   empty slot is reached. The next slots do not contain placeholders in
+   the Robin Hood mode.
+*/
+static void rh_insert(ht_muloa_t *ht, size_t ix, size_t num_probes, ke_t *ke){
+  size_t d;
+  ke_t *t = NULL;
+  while (ht->key_elts[ix] != NULL){
+    d = rh_disp(ht->key_elts[ix], ix, ht->log_count);
+    if (d < num_probes - 1){
+      if (num_probes > ht->max_num_probes) ht->max_num_probes = num_probes;
+      t = ht->key_elts[ix];
+      ht->key_elts[ix] = ke;
+      ke = t;
+      num_probes = d + 1;
+    }
+    ix = sum_mod(1, ix, ht->count);
+    num_probes++;
+  }
+  if (num_probes > ht->max_num_probes) ht->max_num_probes = num_probes;
+  ht->key_elts[ix] = ke;
+}
+
+/**
+   Vacates a slot with a deleted key. In the Robin Hood mode, the keys that
+   follow in the next slots are shifted backward by one slot, until an
+   empty slot or a key in the first slot of its probe sequence is reached.
+   Otherwise, or if the slot is in the previous slots of an incremental
+   growth step, the slot is set to a placeholder, so that the probe
+   sequences of the other keys are maintained.
+*/
+static void vacate(ht_muloa_t *ht, ke_t **ke, int is_prev){
+  size_t ix, next_ix;
+  if (ht->is_rh && !is_prev){
+    ix = ke - ht->key_elts;
+    next_ix = sum_mod(1, ix, ht->count);
+    while (ht->key_elts[next_ix] != NULL &&
+	   rh_disp(ht->key_elts[next_ix], next_ix, ht->log_count) > 0){
+      ht->key_elts[ix] = ht->key_elts[next_ix];
+      ix = next_ix;
+      next_ix = sum_mod(1, ix, ht->count);
+    }
+    ht->key_elts[ix] = NULL;
+  }else{
+    *ke = ht->ph;
+    ht->num_phs++;
+  }
+}
+
+/**
+   Adds the probe lengths of the keys in an array of 2**log_count slots,
+   starting at the slot start, to a histogram. The probe length of a key
+   is the number of probes from the first slot of its probe sequence to
+   its slot, which is reached because the probe distance is odd.
+*/
+static void add_probe_lens(const ht_muloa_t *ht,
+			   ke_t * const *key_elts,
+			   size_t log_count,
+			   size_t start,
+			   size_t *hist,
+			   size_t hist_count){
+  size_t i, ix, dist, num_probes;
+  size_t count = (size_t)1 << log_count;
+  const ke_t *ke = NULL;
+  for (i = start; i < count; i++){
+    ke = key_elts[i];
+    if (ke != NULL && !is_ph(ke)){
+      num_probes = 1;
+      ix = ke->fval >> (C_FULL_BIT - log_count);
+      dist = probe_dist(ht, ke->sval, log_count);
+      while (ix != i){
+	ix = sum_mod(dist, ix, count);
+	num_probes++;
+      }
+      if (num_probes > hist_count) num_probes = hist_count;
+      hist[num_probes - 1]++;
+    }
+  }
+}
+
 /**
    Tests if a prime number in the C_FIRST_PRIME_PARTS or C_SECOND_PRIME_PARTS
    array results in an overflow of size_t on a given system. Returns 0 if no
@@ -5,7 +5,8 @@
    table with generic hash keys and generic elements. The implementation
    is based on a multiplication method for hashing into upto
    2**(CHAR_BIT * sizeof(size_t) - 1) slots and an open addressing method
-   with double hashing for resolving collisions.
+   with double hashing for resolving collisions, or with linear probing
+   and Robin Hood insertion in an optional mode.
    
    The load factor of a hash table is the expected number of keys in a slot 
    under the simple uniform hashing assumption, and is upper-bounded by 
@@ -46,6 +47,7 @@
 #define HT_MULOA_H
 
 #include <stddef.h>
+#include <time.h>
 
 typedef struct{
   size_t fval; /* first hash value with first bit only set in placeholder */
@@ -73,11 +75,45 @@ typedef struct{
   size_t log_alpha_d;
   ke_t *ph;
   ke_t **key_elts;
+  size_t incr_num_slots; /* 0 if growth steps are not incremental */
+  int is_rh; /* 1 if linear probing with Robin Hood insertion */
+  size_t prev_log_count;
+  size_t prev_count;
+  size_t prev_max_num_probes;
+  size_t prev_ix; /* next slot in prev_key_elts with a key to move */
+  ke_t **prev_key_elts; /* NULL if all keys were moved */
+  size_t num_grows;
+  size_t num_cleans;
+  size_t num_moves; /* keys moved to next slots by grow and clean steps */
+  clock_t resize_clocks; /* processor time of grow and clean steps */
   int (*cmp_key)(const void *, const void *);
   size_t (*rdc_key)(const void *, size_t);
   void (*free_elt)(void *);
 } ht_muloa_t;
 
+typedef struct{
+  const void *key;
+  void *elt;          /* result of a completed lookup */
+  size_t fval;
+  size_t sval;
+  size_t ix;          /* slot of the next access */
+  size_t dist;
+  size_t num_probes;
+  int is_prev;        /* 1 if the previous slots are probed */
+  int state;          /* next access: slot, key element, or completed */
+} ht_muloa_lookup_t;
+
+typedef struct{
+  size_t count;          /* count of next slots */
+  size_t num_elts;
+  size_t num_phs;        /* placeholders in next slots */
+  size_t max_num_probes; /* of next slots */
+  size_t num_grows;
+  size_t num_cleans;
+  size_t num_moves;
+  clock_t resize_clocks; /* divided by CLOCKS_PER_SEC to obtain seconds */
+} ht_muloa_stats_t;
+
 /**
    Initializes a hash table. 
    ht          : a pointer to a preallocated block of size
@@ -147,11 +183,53 @@ void ht_muloa_init(ht_muloa_t *ht,
 */
 void ht_muloa_align(ht_muloa_t *ht, size_t elt_alignment);
 
+/**
+   Sets an incremental growth mode of a hash table. In the mode, a growth
+   step, or an elimination of placeholders, allocates the next slots, and
+   the keys in the previous slots are moved to the next slots in parts of
+   at most num_slots previous slots at the beginning of each remove and
+   delete operation, and in parts of at least num_slots previous slots at
+   the beginning of each insert operation, s.t. all keys are moved before
+   alpha is exceeded again, instead of moving all keys within a single
+   insert operation. Until all keys are moved, a search or modifying
+   operation accesses the previous and the next slots. The allocation and
+   initialization of the next slots remain in the insert operation that
+   exceeded alpha. The operation is optionally called after ht_muloa_init
+   and ht_muloa_align are completed and before any other operation is
+   called.
+   ht          : pointer to an initialized ht_muloa_t struct
+   num_slots   : > 0 number of previous slots with their keys moved in one
+                 operation; a larger number completes the move of keys in
+                 fewer operations at the expense of a larger operation
+                 cost during the move
+*/
+void ht_muloa_incr_grow(ht_muloa_t *ht, size_t num_slots);
+
+/**
+   Sets a Robin Hood mode of a hash table. In the mode, collisions are
+   resolved by linear probing, and an inserted key takes the slot of a key
+   that is closer to the first slot of its probe sequence, which continues
+   to be inserted from the next slot, so that the variance of the number
+   of probes is reduced. A search that reaches a key closer to the first
+   slot of its probe sequence than the searched key stops, because the
+   searched key is not in the hash table. A delete or remove operation
+   shifts the subsequent keys of a probe sequence backward instead of
+   leaving a placeholder. The probe sequence of a key is within adjacent
+   slots, and the number of probes in a search is upper-bounded by
+   max_num_probes. The operation is optionally called after ht_muloa_init
+   and ht_muloa_align are completed and before any other operation is
+   called, and can be combined with ht_muloa_incr_grow.
+   ht          : pointer to an initialized ht_muloa_t struct
+*/
+void ht_muloa_robin_hood(ht_muloa_t *ht);
+
 /**
    Inserts a key and an associated element into a hash table. If the key is
    in the hash table, associates the key with the new element. The key and 
    elt parameters are not NULL and point to blocks of size key_size and
-   elt_size respectively.
+   elt_size respectively. A new key is inserted into the first placeholder
+   in its probe sequence, if any, before the first empty slot, so that
+   the slots of deleted keys are recycled without a cleanup.
 */
 void ht_muloa_insert(ht_muloa_t *ht, const void *key, const void *elt);
 
@@ -163,6 +241,66 @@ void ht_muloa_insert(ht_muloa_t *ht, const void *key, const void *elt);
 */
 void *ht_muloa_search(const ht_muloa_t *ht, const void *key);
 
+/**
+   Searches a batch of keys in a hash table. Sets batch_elts[i] to a
+   pointer to the element associated with the ith key, if the key is
+   present, and to NULL otherwise. The batch_keys parameter is not NULL and
+   points to an array of batch_count blocks of size key_size, and the
+   batch_elts parameter is not NULL and points to an array of batch_count
+   pointers. The keys are processed in groups: the keys of a group are
+   hashed and their first slots are prefetched, then the blocks pointed to
+   by the first slots are prefetched, and then the keys are searched, so
+   that the cache misses of the keys in a group overlap. The pointers can
+   be dereferenced according to ht_muloa_search.
+*/
+void ht_muloa_search_batch(const ht_muloa_t *ht,
+			   const void *batch_keys,
+			   void **batch_elts,
+			   size_t batch_count);
+
+/**
+   Starts a lookup of a key as a resumable state machine, and prefetches
+   the first slot of its probe sequence. The key parameter is not NULL and
+   points to a block of size key_size that is not modified until the
+   lookup is completed. A lookup is advanced with ht_muloa_lookup_step, so
+   that the lookups of independent requests are interleaved by a caller at
+   their memory accesses. No modifying operation is called on ht until
+   the lookups of ht are completed.
+   ht          : pointer to an initialized ht_muloa_t struct
+   lk          : pointer to a preallocated block of size
+                 sizeof(ht_muloa_lookup_t)
+   key         : pointer to a key
+*/
+void ht_muloa_lookup_init(const ht_muloa_t *ht,
+			  ht_muloa_lookup_t *lk,
+			  const void *key);
+
+/**
+   Advances a lookup by one memory access, i.e. a slot or a key element
+   block prefetched by the previous call, and prefetches the memory of the
+   next access. Returns 1 if the lookup is completed, in which case lk->elt
+   is set according to ht_muloa_search, and 0 otherwise. A completed
+   lookup is not advanced further by subsequent calls.
+*/
+int ht_muloa_lookup_step(const ht_muloa_t *ht, ht_muloa_lookup_t *lk);
+
+/**
+   Searches keys with up to num_lks lookups in flight, which are advanced
+   in a round-robin order by ht_muloa_lookup_step, and a completed lookup
+   is replaced by the lookup of the next key, so that a long probe
+   sequence delays only its own key. Sets elts[i] to a pointer to the
+   element associated with the ith key, if the key is present, and to NULL
+   otherwise. The keys parameter points to an array of count blocks of size
+   key_size, elts points to an array of count pointers, and lks points to
+   an array of num_lks > 0 preallocated ht_muloa_lookup_t structs.
+*/
+void ht_muloa_search_interleave(const ht_muloa_t *ht,
+				const void *keys,
+				void **elts,
+				size_t count,
+				ht_muloa_lookup_t *lks,
+				size_t num_lks);
+
 /**
    Removes a key and its associated element from a hash table by copying 
    the element or its pointer into a block of size elt_size pointed to
@@ -179,6 +317,47 @@ void ht_muloa_remove(ht_muloa_t *ht, const void *key, void *elt);
 */
 void ht_muloa_delete(ht_muloa_t *ht, const void *key);
 
+/**
+   Deletes all keys and their associated elements from a hash table
+   according to free_elt, keeping the count of slots of the hash table,
+   so that the hash table can be reused without growth steps. Completes
+   an incremental growth step, if any, by deleting the keys that were not
+   moved. Runs in O(count) time.
+*/
+void ht_muloa_reset(ht_muloa_t *ht);
+
+/**
+   Copies the statistics of a hash table into a block of size
+   sizeof(ht_muloa_stats_t) pointed to by s, and optionally computes a
+   histogram of probe lengths, where a probe length of a key is the number
+   of probes in its search. The counts of grow and clean steps, the count
+   of moved keys, and the processor time of grow and clean steps, measured
+   with clock, are accumulated since ht_muloa_init and are not cleared by
+   ht_muloa_reset. In an incremental growth mode, the processor time
+   includes the allocation of next slots and the completion of a move of
+   keys in an insert operation that exceeded alpha, but not the moves of
+   keys in parts, which are counted in num_moves. The ratio of num_phs and
+   count is the placeholder ratio, and the ratio of num_elts + num_phs and
+   count is the load factor of the next slots. Runs in O(count) time and
+   the expected time of a search per key for a histogram.
+   ht          : pointer to an initialized ht_muloa_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(ht_muloa_stats_t)
+   hist        : - NULL if a histogram is not computed
+                 - otherwise a pointer to an array of hist_count size_t
+                 values; hist[i] is set to the number of keys with a probe
+                 length i + 1 for i < hist_count - 1, and
+                 hist[hist_count - 1] to the number of keys with a probe
+                 length >= hist_count; the probe length of a key in the
+                 previous slots of an incremental growth step is relative
+                 to the previous slots
+   hist_count  : > 0 if hist is not NULL
+*/
+void ht_muloa_stats(const ht_muloa_t *ht,
+		    ht_muloa_stats_t *s,
+		    size_t *hist,
+		    size_t hist_count);
+
 /**
    Frees a hash table and leaves a block of size sizeof(ht_muloa_t)
    pointed to by the ht parameter.
@@ -214,6 +393,8 @@ void ht_muloa_remove_helper(void *ht, const void *key, void *elt);
 
 void ht_muloa_delete_helper(void *ht, const void *key);
 
+void ht_muloa_reset_helper(void *ht);
+
 void ht_muloa_free_helper(void *ht);
 
 #endif
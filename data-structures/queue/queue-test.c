@@ -10,12 +10,14 @@
       [0, 1] : on/off push pop first free uint test
       [0, 1] : on/off push pop first free uint_ptr (noncontiguous) test
       [0, 1] : on/off uchar queue test
+      [0, 1] : on/off push_n pop_n uint test
 
    usage examples:
    ./queue-test
    ./queue-test 23
    ./queue-test 24 32
    ./queue-test 24 32 0 0 1
+   ./queue-test 20 32 0 0 0 1
 
    queue-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -44,15 +46,19 @@ const char *C_USAGE =
   "[0, # bits in size_t - 1] : i s.t. # inserts = 2^i in uchar queue test\n"
   "[0, 1] : on/off push pop first free uint test\n"
   "[0, 1] : on/off push pop first free uint_ptr (noncontiguous) test\n"
-  "[0, 1] : on/off uchar queue test\n";
-const int C_ARGC_MAX = 6;
-const size_t C_ARGS_DEF[5] = {14, 15, 1, 1, 1};
+  "[0, 1] : on/off uchar queue test\n"
+  "[0, 1] : on/off push_n pop_n uint test\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {14, 15, 1, 1, 1, 1};
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
 /* tests */
 const unsigned char C_UCHAR_MAX = (unsigned char)-1;
 const size_t C_INIT_COUNT = 1;
 const size_t C_START_VAL = 0;
+const size_t C_BATCH_COUNT = 64;
+const size_t C_PUSH_N_MOD = 7; /* # pushed at a time in [1, C_PUSH_N_MOD] */
+const size_t C_POP_N_MOD = 5;  /* # popped at a time in [1, C_POP_N_MOD] */
 
 void print_test_result(int res);
 
@@ -344,6 +350,95 @@ void run_uchar_queue_test(int pow_ins){
   queue_free(&q);
 }
 
+/**
+   Runs a queue_{push_n, pop_n} test of a queue of size_t elements. Tests
+   interleaved pushes and pops of elements in batches of varying sizes,
+   and with queue_push and queue_pop, across growth steps with wrapped-
+   around elements, and compares the runtimes of pushes and pops in
+   batches of C_BATCH_COUNT elements with single pushes and pops.
+*/
+void run_uint_push_n_pop_n_test(int pow_ins){
+  int res = 1;
+  size_t i, j;
+  size_t num_ins, num, num_pushed, num_popped;
+  size_t *buf = NULL;
+  size_t *pushed = NULL, *popped = NULL;
+  clock_t t_push, t_pop;
+  queue_t q;
+  num_ins = pow_two(pow_ins);
+  buf = malloc_perror(C_PUSH_N_MOD + C_POP_N_MOD, sizeof(size_t));
+  pushed = malloc_perror(num_ins, sizeof(size_t));
+  popped = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    pushed[i] = i;
+  }
+  printf("Run a queue_{push_n, pop_n} test on size_t elements\n");
+  printf("\tinitial queue count: %lu, # inserts: %lu\n",
+	 TOLU(C_INIT_COUNT), TOLU(num_ins));
+  queue_init(&q, C_INIT_COUNT, sizeof(size_t), NULL);
+  num_pushed = 0;
+  num_popped = 0;
+  for (i = 0; num_popped < num_ins; i++){
+    num = i % C_PUSH_N_MOD + 1;
+    if (num > num_ins - num_pushed) num = num_ins - num_pushed;
+    if (i & 1){
+      queue_push_n(&q, &pushed[num_pushed], num);
+    }else{
+      for (j = 0; j < num; j++){
+	queue_push(&q, &pushed[num_pushed + j]);
+      }
+    }
+    num_pushed += num;
+    /* pop less than pushed on average until all elements are pushed */
+    num = (i % C_POP_N_MOD) * (num_pushed < num_ins) + C_POP_N_MOD;
+    num /= 2;
+    if (i & 2){
+      num = queue_pop_n(&q, buf, num);
+    }else{
+      for (j = 0; j < num && q.num_elts > 0; j++){
+	queue_pop(&q, &buf[j]);
+      }
+      num = j;
+    }
+    for (j = 0; j < num; j++){
+      res *= (buf[j] == num_popped + j);
+    }
+    num_popped += num;
+    res *= (q.num_elts == num_pushed - num_popped);
+  }
+  res *= (queue_pop_n(&q, buf, 1) == 0 && queue_first(&q) == NULL);
+  queue_free(&q);
+  queue_init(&q, C_INIT_COUNT, sizeof(size_t), NULL);
+  t_push = clock();
+  for (i = 0; i < num_ins; i += C_BATCH_COUNT){
+    num = (num_ins - i < C_BATCH_COUNT) ? num_ins - i : C_BATCH_COUNT;
+    queue_push_n(&q, &pushed[i], num);
+  }
+  t_push = clock() - t_push;
+  t_pop = clock();
+  for (i = 0; i < num_ins; i += num){
+    num = queue_pop_n(&q, &popped[i], C_BATCH_COUNT);
+  }
+  t_pop = clock() - t_pop;
+  res *= (q.num_elts == 0);
+  for (i = 0; i < num_ins; i++){
+    res *= (popped[i] == i);
+  }
+  queue_free(&q);
+  printf("\t\tpush_n time: %.4f seconds (batch count: %lu)\n",
+	 (float)t_push / CLOCKS_PER_SEC, TOLU(C_BATCH_COUNT));
+  printf("\t\tpop_n time:  %.4f seconds (batch count: %lu)\n",
+	 (float)t_pop / CLOCKS_PER_SEC, TOLU(C_BATCH_COUNT));
+  printf("\t\tcorrectness: ");
+  print_test_result(res);
+  free(buf);
+  free(pushed);
+  free(popped);
+  buf = NULL;
+  pushed = NULL;
+  popped = NULL;
+}
+
 void print_test_result(int res){
   if (res){
     printf("SUCCESS\n");
@@ -368,7 +463,8 @@ int main(int argc, char *argv[]){
       args[1] > C_FULL_BIT - 1 ||
       args[2] > 1 ||
       args[3] > 1 ||
-      args[4] > 1){
+      args[4] > 1 ||
+      args[5] > 1){
     fprintf(stderr, "USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -385,6 +481,9 @@ int main(int argc, char *argv[]){
   if (args[4]){
     run_uchar_queue_test(args[1]);
   }
+  if (args[5]){
+    run_uint_push_n_pop_n_test(args[0]);
+  }
   free(args);
   args = NULL;
   return 0;
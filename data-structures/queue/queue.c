@@ -5,6 +5,12 @@
    
    Through a user-defined deallocation function, the implementation provides 
    a dynamic set of any objects in the fifo queue form. 
+
+   The elements are stored in a circular buffer with a power-of-two count,
+   indexed by masking, so that push and pop operations do not move the
+   elements of a queue. A growth step doubles the count and copies at most
+   the wrapped-around part of the elements, resulting in a constant
+   amortized overhead per element.
 */
 
 #include <stdio.h>
@@ -14,14 +20,16 @@
 #include "utilities-mem.h"
 
 static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
+static void copy_in(queue_t *q, size_t ix, const void *elts, size_t num);
+static void copy_out(const queue_t *q, size_t ix, void *elts, size_t num);
 static void queue_grow(queue_t *q);
-static void queue_move(queue_t *q);
 static void fprintf_stderr_exit(const char *s, int line);
 
 /**
    Initializes a queue.
    q                : pointer to a preallocated block of size sizeof(queue_t)
-   init_count       : > 0
+   init_count       : > 0; the initial count is the least power of two that
+                      is greater or equal to init_count
    elt_size         : - the size of an element, if the element is within a 
                       contiguous memory block
                       - the size of a pointer to an element, if the element 
@@ -43,15 +51,19 @@ void queue_init(queue_t *q,
 		size_t init_count,
 		size_t elt_size,
 		void (*free_elt)(void *)){
-  q->count = init_count;
-  q->count_max = QUEUE_COUNT_MAX; /* the only use of the macro in the file */
-  if (q->count > q->count_max){
+  /* the only use of the macro in the file */
+  size_t count_max = QUEUE_COUNT_MAX;
+  q->count_max = 1;
+  while (q->count_max <= count_max / 2) q->count_max *= 2;
+  if (init_count > q->count_max){
     fprintf_stderr_exit("init_count > count maximum", __LINE__);
   }
+  q->count = 1;
+  while (q->count < init_count) q->count *= 2; /* <= count_max */
   q->num_elts = 0;
-  q->num_popped_elts = 0;
+  q->first = 0;
   q->elt_size = elt_size;
-  q->elts = malloc_perror(init_count, elt_size);
+  q->elts = malloc_perror(q->count, elt_size);
   q->free_elt = free_elt;
 }
 
@@ -59,13 +71,27 @@ void queue_init(queue_t *q,
    Pushes an element onto a queue. The elt parameter is not NULL.
 */
 void queue_push(queue_t *q, const void *elt){
-  if (q->count == q->num_popped_elts + q->num_elts) queue_grow(q);
-  memcpy(elt_ptr(q->elts, q->num_popped_elts + q->num_elts, q->elt_size),
+  if (q->count == q->num_elts) queue_grow(q);
+  memcpy(elt_ptr(q->elts,
+		 (q->first + q->num_elts) & (q->count - 1),
+		 q->elt_size),
 	 elt,
 	 q->elt_size);
   q->num_elts++;
 }
 
+/**
+   Pushes num elements onto a queue in the order of their indices in an
+   array pointed to by elts, with at most one growth step sequence and at
+   most two copy operations. The elts parameter is not NULL if num > 0.
+*/
+void queue_push_n(queue_t *q, const void *elts, size_t num){
+  if (num == 0) return;
+  while (q->count - q->num_elts < num) queue_grow(q);
+  copy_in(q, (q->first + q->num_elts) & (q->count - 1), elts, num);
+  q->num_elts += num;
+}
+
 /**
    Pops an element off a queue. Elt points to a preallocated memory block of 
    size elt_size. If the queue is empty, the memory block pointed to by elt 
@@ -73,14 +99,24 @@ void queue_push(queue_t *q, const void *elt){
 */
 void queue_pop(queue_t *q, void *elt){
   if (q->num_elts == 0) return;
-  memcpy(elt,
-	 elt_ptr(q->elts, q->num_popped_elts, q->elt_size),
-	 q->elt_size);
+  memcpy(elt, elt_ptr(q->elts, q->first, q->elt_size), q->elt_size);
+  q->first = (q->first + 1) & (q->count - 1);
   q->num_elts--;
-  q->num_popped_elts++;
-  if (q->count - q->num_popped_elts <= q->num_popped_elts){
-    queue_move(q);
-  }
+}
+
+/**
+   Pops min(num, num_elts) elements off a queue and copies them in the
+   order of popping to an array of at least num elements pointed to by
+   elts, with at most two copy operations. Returns the number of popped
+   elements.
+*/
+size_t queue_pop_n(queue_t *q, void *elts, size_t num){
+  if (num > q->num_elts) num = q->num_elts;
+  if (num == 0) return 0;
+  copy_out(q, q->first, elts, num);
+  q->first = (q->first + num) & (q->count - 1);
+  q->num_elts -= num;
+  return num;
 }
 
 /**
@@ -90,7 +126,7 @@ void queue_pop(queue_t *q, void *elt){
 */
 void *queue_first(const queue_t *q){
   if (q->num_elts == 0) return NULL;
-  return elt_ptr(q->elts, q->num_popped_elts, q->elt_size);
+  return elt_ptr(q->elts, q->first, q->elt_size);
 }
 
 /**
@@ -101,7 +137,9 @@ void queue_free(queue_t *q){
   size_t i;
   if (q->free_elt != NULL){
     for (i = 0; i < q->num_elts; i++){
-      q->free_elt(elt_ptr(q->elts, q->num_popped_elts + i, q->elt_size));
+      q->free_elt(elt_ptr(q->elts,
+			  (q->first + i) & (q->count - 1),
+			  q->elt_size));
     }
   }
   free(q->elts);
@@ -118,33 +156,46 @@ static void *elt_ptr(const void *elts, size_t i, size_t elt_size){
 }
 
 /**
-   Doubles the size of a queue, if possible. Amortized constant overhead for
-   copying in the worst case of realloc calls. realloc's search is O(size of
-   heap).
+   Copies num <= count elements from an array pointed to by elts to the
+   circular buffer of a queue, starting at the index ix.
+*/
+static void copy_in(queue_t *q, size_t ix, const void *elts, size_t num){
+  size_t n = q->count - ix;
+  if (n > num) n = num;
+  memcpy(elt_ptr(q->elts, ix, q->elt_size), elts, n * q->elt_size);
+  memcpy(q->elts, elt_ptr(elts, n, q->elt_size), (num - n) * q->elt_size);
+}
+
+/**
+   Copies num <= count elements from the circular buffer of a queue,
+   starting at the index ix, to an array pointed to by elts.
+*/
+static void copy_out(const queue_t *q, size_t ix, void *elts, size_t num){
+  size_t n = q->count - ix;
+  if (n > num) n = num;
+  memcpy(elts, elt_ptr(q->elts, ix, q->elt_size), n * q->elt_size);
+  memcpy(elt_ptr(elts, n, q->elt_size), q->elts, (num - n) * q->elt_size);
+}
+
+/**
+   Doubles the count of a queue, if possible. The wrapped-around part of
+   the elements at the beginning of the buffer, if any, is copied after the
+   previous end of the buffer, so that the elements are contiguous modulo
+   the new count. Amortized constant overhead for copying in the worst
+   case of realloc calls. realloc's search is O(size of heap).
 */
 static void queue_grow(queue_t *q){
+  size_t prev_count = q->count;
   if (q->count == q->count_max){
     fprintf_stderr_exit("tried to exceed the count maximum", __LINE__);
   }
-  if (q->count_max - q->count < q->count){
-    q->count = q->count_max;
-  }else{
-    q->count *= 2;
-  }
+  q->count *= 2;
   q->elts = realloc_perror(q->elts, q->count, q->elt_size);
-}
-
-/**
-   Moves elements to the beginning of the element array of a queue. 
-   Constant overhead in the worst case because each element is 
-   moved at most once. The destination and source regions must
-   not overlap.
-*/
-static void queue_move(queue_t *q){
-  memcpy(q->elts,
-	 elt_ptr(q->elts, q->num_popped_elts, q->elt_size),
-	 q->num_elts * q->elt_size);
-  q->num_popped_elts = 0;
+  if (q->first + q->num_elts > prev_count){
+    memcpy(elt_ptr(q->elts, prev_count, q->elt_size),
+	   q->elts,
+	   (q->first + q->num_elts - prev_count) * q->elt_size);
+  }
 }
 
 /**
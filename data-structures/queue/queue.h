@@ -6,6 +6,12 @@
 
    Through a user-defined deallocation function, the implementation provides
    a dynamic set of any objects in the fifo queue form.
+
+   The elements are stored in a circular buffer with a power-of-two count,
+   indexed by masking, so that push and pop operations do not move the
+   elements of a queue. A growth step doubles the count and copies at most
+   the wrapped-around part of the elements, resulting in a constant
+   amortized overhead per element.
 */
 
 #ifndef QUEUE_H  
@@ -14,10 +20,10 @@
 #include <stddef.h>
 
 typedef struct{
-  size_t count;
-  size_t count_max;
+  size_t count;     /* power of two */
+  size_t count_max; /* power of two */
   size_t num_elts;
-  size_t num_popped_elts;
+  size_t first;     /* index of the first element if num_elts > 0 */
   size_t elt_size;
   void *elts;
   void (*free_elt)(void *);
@@ -26,7 +32,8 @@ typedef struct{
 /**
    Initializes a queue.
    q                : pointer to a preallocated block of size sizeof(queue_t)
-   init_count       : > 0
+   init_count       : > 0; the initial count is the least power of two that
+                      is greater or equal to init_count
    elt_size         : - the size of an element, if the element is within a
                       contiguous memory block
                       - the size of a pointer to an element, if the element
@@ -54,6 +61,13 @@ void queue_init(queue_t *q,
 */
 void queue_push(queue_t *q, const void *elt);
 
+/**
+   Pushes num elements onto a queue in the order of their indices in an
+   array pointed to by elts, with at most one growth step sequence and at
+   most two copy operations. The elts parameter is not NULL if num > 0.
+*/
+void queue_push_n(queue_t *q, const void *elts, size_t num);
+
 /**
    Pops an element off a queue. Elt points to a preallocated memory block of
    size elt_size. If the queue is empty, the memory block pointed to by elt
@@ -61,6 +75,14 @@ void queue_push(queue_t *q, const void *elt);
 */
 void queue_pop(queue_t *q, void *elt);
 
+/**
+   Pops min(num, num_elts) elements off a queue and copies them in the
+   order of popping to an array of at least num elements pointed to by
+   elts, with at most two copy operations. Returns the number of popped
+   elements.
+*/
+size_t queue_pop_n(queue_t *q, void *elts, size_t num);
+
 /**
    If a queue is not empty, returns a pointer to the first element,
    otherwise returns NULL. The returned pointer is guaranteed to point to
@@ -76,14 +98,14 @@ void queue_free(queue_t *q);
 
 /**
    Sets the queue count maximum that may be reached, if possible, as a queue
-   grows by repetitive doubling from its initial count and by adding, if
-   necessary, the difference between QUEUE_COUNT_MAX and the last count in
-   the last step.
+   grows by repetitive doubling from its initial count. The count maximum
+   is the greatest power of two that is less or equal to QUEUE_COUNT_MAX.
 
    The program exits with an error message, if a) the value of the init_count
-   parameter in queue_init is greater than QUEUE_COUNT_MAX, or b) if a queue
-   growth step is attempted after QUEUE_COUNT_MAX was reached. The macro is
-   set to the maximal value of size_t by default and is used as size_t.
+   parameter in queue_init is greater than the count maximum, or b) if a
+   queue growth step is attempted after the count maximum was reached. The
+   macro is set to the maximal value of size_t by default and is used as
+   size_t.
 */
 #define QUEUE_COUNT_MAX ((size_t)-1)
 
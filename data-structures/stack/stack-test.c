@@ -10,12 +10,14 @@
       [0, 1] : on/off push pop first free uint test
       [0, 1] : on/off push pop first free uint_ptr (noncontiguous) test
       [0, 1] : on/off uchar stack test
+      [0, 1] : on/off push_n pop_n reserve shrink uint test
 
    usage examples:
    ./stack-test
    ./stack-test 23
    ./stack-test 24 32
    ./stack-test 24 32 0 0 1
+   ./stack-test 20 32 0 0 0 1
 
    stack-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -44,15 +46,18 @@ const char *C_USAGE =
   "[0, # bits in size_t - 1] : i s.t. # inserts = 2^i in uchar stack test\n"
   "[0, 1] : on/off push pop first free uint test\n"
   "[0, 1] : on/off push pop first free uint_ptr (noncontiguous) test\n"
-  "[0, 1] : on/off uchar stack test\n";
-const int C_ARGC_MAX = 6;
-const size_t C_ARGS_DEF[5] = {14, 15, 1, 1, 1};
+  "[0, 1] : on/off uchar stack test\n"
+  "[0, 1] : on/off push_n pop_n reserve shrink uint test\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {14, 15, 1, 1, 1, 1};
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
 /* tests */
 const unsigned char C_UCHAR_MAX = (unsigned char)-1;
 const size_t C_INIT_COUNT = 1;
 const size_t C_START_VAL = 0;
+const size_t C_PUSH_N_MOD = 7;
+const size_t C_POP_N_MOD = 5;
 
 void print_test_result(int res);
 
@@ -345,6 +350,101 @@ void run_uchar_stack_test(int pow_ins){
   stack_free(&s);
 }
 
+/**
+   Runs a test of stack_{push_n, pop_n, reserve, shrink} on size_t
+   elements. Elements are pushed and popped in batches of varying sizes,
+   including empty batches, and the order of elements is compared with the
+   order of single element operations.
+*/
+void run_uint_push_n_pop_n_test(int pow_ins){
+  int res = 1;
+  size_t i, num, count;
+  size_t num_ins;
+  size_t *pushed = NULL, *popped = NULL;
+  stack_t s;
+  clock_t t_push, t_pop;
+  num_ins = pow_two(pow_ins);
+  pushed = malloc_perror(num_ins, sizeof(size_t));
+  popped = malloc_perror(num_ins, sizeof(size_t));
+  for (i = 0; i < num_ins; i++){
+    pushed[i] = C_START_VAL + i;
+  }
+  stack_init(&s, C_INIT_COUNT, sizeof(size_t), NULL);
+  printf("Run a stack_{push_n, pop_n} test on size_t elements\n");
+  printf("\tinitial stack count: %lu, # inserts: %lu\n",
+	 TOLU(C_INIT_COUNT), TOLU(num_ins));
+  /* batches of pushes and single pops */
+  t_push = clock();
+  for (i = 0; i < num_ins; i += num){
+    num = i % C_PUSH_N_MOD;
+    if (num > num_ins - i) num = num_ins - i;
+    stack_push_n(&s, &pushed[i], num);
+    if (num == 0) stack_push_n(&s, &pushed[i], ++num);
+  }
+  t_push = clock() - t_push;
+  res *= (s.num_elts == num_ins);
+  for (i = 0; i < num_ins; i++){
+    stack_pop(&s, &popped[i]);
+    res *= (popped[i] == num_ins - 1 - i + C_START_VAL);
+  }
+  /* single pushes and batches of pops */
+  for (i = 0; i < num_ins; i++){
+    stack_push(&s, &pushed[i]);
+  }
+  t_pop = clock();
+  for (i = num_ins; i > 0; i -= num){
+    num = stack_pop_n(&s, &popped[0], i % C_POP_N_MOD);
+    res *= (num == i % C_POP_N_MOD);
+    if (num == 0) num = stack_pop_n(&s, &popped[0], 1);
+    res *= (num > 0 && popped[num - 1] == pushed[i - 1]);
+    res *= (popped[0] == pushed[i - num]);
+  }
+  t_pop = clock() - t_pop;
+  res *= (s.num_elts == 0);
+  res *= (stack_pop_n(&s, popped, num_ins) == 0);
+  stack_push_n(&s, pushed, num_ins);
+  res *= (stack_pop_n(&s, popped, num_ins + 1) == num_ins);
+  for (i = 0; i < num_ins; i++){
+    res *= (popped[i] == pushed[i]);
+  }
+  printf("\t\tpush_n time: %.4f seconds\n", (float)t_push / CLOCKS_PER_SEC);
+  printf("\t\tpop_n time:  %.4f seconds\n", (float)t_pop / CLOCKS_PER_SEC);
+  printf("\t\tcorrectness: ");
+  print_test_result(res);
+  stack_free(&s);
+  /* reserve and shrink */
+  res = 1;
+  stack_init(&s, C_INIT_COUNT, sizeof(size_t), NULL);
+  printf("Run a stack_{reserve, shrink} test on size_t elements\n");
+  stack_reserve(&s, num_ins);
+  count = s.count;
+  res *= (count == ((num_ins > C_INIT_COUNT) ? num_ins : C_INIT_COUNT));
+  for (i = 0; i < num_ins; i++){
+    stack_push(&s, &pushed[i]);
+  }
+  res *= (s.count == count);
+  stack_reserve(&s, num_ins / 2);
+  res *= (s.count == count);
+  stack_pop_n(&s, popped, num_ins / 2);
+  stack_shrink(&s);
+  res *= (s.count == num_ins - num_ins / 2 && s.num_elts == s.count);
+  for (i = 0; i < num_ins - num_ins / 2; i++){
+    stack_pop(&s, &popped[i]);
+    res *= (popped[i] == pushed[num_ins - num_ins / 2 - 1 - i]);
+  }
+  stack_shrink(&s);
+  res *= (s.count == 1 && s.num_elts == 0);
+  stack_push_n(&s, pushed, num_ins);
+  res *= (s.num_elts == num_ins && s.count >= num_ins);
+  printf("\t\tcorrectness: ");
+  print_test_result(res);
+  stack_free(&s);
+  free(pushed);
+  free(popped);
+  pushed = NULL;
+  popped = NULL;
+}
+
 void print_test_result(int res){
   if (res){
     printf("SUCCESS\n");
@@ -369,7 +469,8 @@ int main(int argc, char *argv[]){
       args[1] > C_FULL_BIT - 1 ||
       args[2] > 1 ||
       args[3] > 1 ||
-      args[4] > 1){
+      args[4] > 1 ||
+      args[5] > 1){
     fprintf(stderr, "USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -386,6 +487,9 @@ int main(int argc, char *argv[]){
   if (args[4]){
     run_uchar_stack_test(args[1]);
   }
+  if (args[5]){
+    run_uint_push_n_pop_n_test(args[0]);
+  }
   free(args);
   args = NULL;
   return 0;
@@ -68,6 +68,22 @@ void stack_push(stack_t *s, const void *elt){
   s->num_elts++;
 }
 
+/**
+   Pushes num elements from an array pointed to by elts onto a stack with
+   a single copy operation, in the order of the array, so that the last
+   element of the array becomes the first element of the stack. If
+   necessary, the stack grows by repetitive doubling before the copy. The
+   elts parameter is not NULL if num > 0.
+*/
+void stack_push_n(stack_t *s, const void *elts, size_t num){
+  if (num == 0) return;
+  while (s->count - s->num_elts < num) stack_grow(s);
+  memcpy(elt_ptr(s->elts, s->num_elts, s->elt_size),
+	 elts,
+	 num * s->elt_size);
+  s->num_elts += num;
+}
+
 /**
    Pops an element of a stack. Elt points to a preallocated memory block of
    size elt_size. If the stack is empty, the memory block pointed to by elt
@@ -81,6 +97,23 @@ void stack_pop(stack_t *s, void *elt){
   s->num_elts--;
 }
 
+/**
+   Pops min(num, num_elts) elements of a stack and copies them to an array
+   of at least num elements pointed to by elts with a single copy
+   operation. The elements are copied in the order in which they were
+   pushed, so that stack_pop_n reverses stack_push_n with the same
+   parameters. Returns the number of popped elements.
+*/
+size_t stack_pop_n(stack_t *s, void *elts, size_t num){
+  if (num > s->num_elts) num = s->num_elts;
+  if (num == 0) return 0;
+  s->num_elts -= num;
+  memcpy(elts,
+	 elt_ptr(s->elts, s->num_elts, s->elt_size),
+	 num * s->elt_size);
+  return num;
+}
+
 /**
    If a stack is not empty, returns a pointer to the first element,
    otherwise returns NULL. The returned pointer is guaranteed to point to
@@ -91,6 +124,33 @@ void *stack_first(const stack_t *s){
   return elt_ptr(s->elts, s->num_elts - 1, s->elt_size);
 }
 
+/**
+   Ensures that a stack accommodates at least count elements without
+   growing in subsequent push operations. If count is greater than the
+   stack count, the stack is reallocated to exactly count elements,
+   otherwise the stack remains unchanged. The program exits with an error
+   message if count is greater than STACK_COUNT_MAX.
+*/
+void stack_reserve(stack_t *s, size_t count){
+  if (count <= s->count) return;
+  if (count > s->count_max){
+    fprintf_stderr_exit("reserved count > count maximum", __LINE__);
+  }
+  s->count = count;
+  s->elts = realloc_perror(s->elts, s->count, s->elt_size);
+}
+
+/**
+   Reallocates a stack to the number of its elements, or to one element if
+   the stack is empty, and releases the remaining memory.
+*/
+void stack_shrink(stack_t *s){
+  size_t count = (s->num_elts > 0) ? s->num_elts : 1;
+  if (count == s->count) return;
+  s->count = count;
+  s->elts = realloc_perror(s->elts, s->count, s->elt_size);
+}
+
 /**
    Frees a stack, and leaves a block of size sizeof(stack_t) pointed to by
    the s parameter.
@@ -57,6 +57,15 @@ void stack_init(stack_t *s,
 */
 void stack_push(stack_t *s, const void *elt);
 
+/**
+   Pushes num elements from an array pointed to by elts onto a stack with
+   a single copy operation, in the order of the array, so that the last
+   element of the array becomes the first element of the stack. If
+   necessary, the stack grows by repetitive doubling before the copy. The
+   elts parameter is not NULL if num > 0.
+*/
+void stack_push_n(stack_t *s, const void *elts, size_t num);
+
 /**
    Pops an element of a stack. Elt points to a preallocated memory block of
    size elt_size. If the stack is empty, the memory block pointed to by elt
@@ -64,6 +73,15 @@ void stack_push(stack_t *s, const void *elt);
 */
 void stack_pop(stack_t *s, void *elt);
 
+/**
+   Pops min(num, num_elts) elements of a stack and copies them to an array
+   of at least num elements pointed to by elts with a single copy
+   operation. The elements are copied in the order in which they were
+   pushed, so that stack_pop_n reverses stack_push_n with the same
+   parameters. Returns the number of popped elements.
+*/
+size_t stack_pop_n(stack_t *s, void *elts, size_t num);
+
 /**
    If a stack is not empty, returns a pointer to the first element,
    otherwise returns NULL. The returned pointer is guaranteed to point to
@@ -71,6 +89,21 @@ void stack_pop(stack_t *s, void *elt);
 */
 void *stack_first(const stack_t *s);
 
+/**
+   Ensures that a stack accommodates at least count elements without
+   growing in subsequent push operations. If count is greater than the
+   stack count, the stack is reallocated to exactly count elements,
+   otherwise the stack remains unchanged. The program exits with an error
+   message if count is greater than STACK_COUNT_MAX.
+*/
+void stack_reserve(stack_t *s, size_t count);
+
+/**
+   Reallocates a stack to the number of its elements, or to one element if
+   the stack is empty, and releases the remaining memory.
+*/
+void stack_shrink(stack_t *s);
+
 /**
    Frees a stack, and leaves a block of size sizeof(stack_t) pointed to by
    the s parameter.
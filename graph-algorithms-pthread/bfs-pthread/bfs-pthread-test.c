@@ -0,0 +1,339 @@
+/**
+   bfs-pthread-test.c
+
+   Tests of the direction-optimizing BFS algorithm with num_threads threads
+   on random directed and undirected graphs, by comparing the distances to
+   the distances computed by bfs and by testing if each previous vertex is
+   an adjacent vertex at the previous level.
+
+   The following command line arguments can be used to customize tests:
+   bfs-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, 8] : k for 2**k threads in the largest thread test
+      [0, 1] : random directed graph test on/off
+      [0, 1] : random undirected graph test on/off
+
+   usage examples:
+   ./bfs-pthread-test
+   ./bfs-pthread-test 10 14
+   ./bfs-pthread-test 14 14 3 1 0
+
+   bfs-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "bfs-pthread.h"
+#include "bfs.h"
+#include "graph.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "bfs-pthread-test\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph\n"
+  "[0, 8] : k for 2**k threads in the largest thread test\n"
+  "[0, 1] : random directed graph test on/off\n"
+  "[0, 1] : random undirected graph test on/off\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 12, 2, 1, 1};
+const size_t C_THREADS_LOG_MAX = 8;
+
+/* random graph tests */
+const int C_ITER = 5;
+const int C_PROBS_COUNT = 4;
+const double C_PROBS[4] = {1.000000, 0.250000, 0.015625, 0.000977};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
+double timer();
+void print_test_result(int res);
+
+/**
+   Construct adjacency lists of random graphs.
+*/
+
+typedef struct{
+  double p;
+} bern_arg_t;
+
+int bern(void *arg){
+  bern_arg_t *b = arg;
+  if (b->p >= 1.0) return 1;
+  if (b->p <= 0.0) return 0;
+  if (b->p > DRAND()) return 1;
+  return 0;
+}
+
+/**
+   Builds the adjacency list of the reversed graph of a directed graph.
+*/
+void adj_lst_rev(adj_lst_t *r, const adj_lst_t *a){
+  void *t = NULL;
+  graph_t g;
+  lst_graph_init(&g, a);
+  t = g.u;
+  g.u = g.v;
+  g.v = t;
+  adj_lst_base_init(r, &g);
+  adj_lst_dir_build(r, &g);
+  graph_free(&g);
+}
+
+/**
+   Builds a CSR adjacency list with the edges of an adjacency list.
+*/
+void adj_csr_lst(adj_csr_t *c, const adj_lst_t *a){
+  graph_t g;
+  lst_graph_init(&g, a);
+  adj_csr_base_init(c, &g);
+  adj_csr_dir_build(c, &g);
+  graph_free(&g);
+}
+
+/**
+   Tests if the distances are equal to the distances computed by bfs, and
+   each previous vertex of a reached vertex is at the previous level and
+   has an edge to the vertex.
+*/
+int is_bfs(const adj_lst_t *a,
+	   size_t start,
+	   const size_t *dist,
+	   const size_t *prev,
+	   const size_t *dist_b,
+	   const size_t *prev_b){
+  int found;
+  size_t i, j, num_vt_wts;
+  const char *p = NULL;
+  size_t n = a->num_vts;
+  for (i = 0; i < n; i++){
+    if ((prev[i] == n) != (prev_b[i] == n)) return 0;
+    if (prev[i] == n) continue;
+    if (dist[i] != dist_b[i]) return 0;
+    if (i == start){
+      if (prev[i] != start || dist[i] != 0) return 0;
+      continue;
+    }
+    if (prev[prev[i]] == n || dist[prev[i]] + 1 != dist[i]) return 0;
+    found = 0;
+    p = adj_lst_vt_wts(a, prev[i], &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      if (a->read_vt(p) == i) found = 1;
+      p += a->pair_size;
+    }
+    if (!found) return 0;
+  }
+  return 1;
+}
+
+/**
+   Runs a test on random graphs.
+*/
+void run_rand_test(int pow_start, int pow_end, size_t log_threads,
+		   int is_undir){
+  int p, i, j;
+  int res = 1;
+  size_t k, n, num_threads;
+  size_t *rand_start = NULL;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *dist_p = NULL, *prev_p = NULL;
+  adj_lst_t a, r;
+  adj_csr_t c, c_r;
+  bern_arg_t b;
+  bfs_ws_t ws;
+  double t;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist_p = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev_p = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  printf("Run a bfs_pthread test on random %s graphs\n",
+	 is_undir ? "undirected" : "directed");
+  fflush(stdout);
+  for (p = 0; p < C_PROBS_COUNT; p++){
+    b.p = C_PROBS[p];
+    printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      if (is_undir){
+	adj_lst_rand_undir(&a, n, sizeof(size_t),
+			   graph_read_sz, graph_write_sz, bern, &b);
+	r = a;
+      }else{
+	adj_lst_rand_dir(&a, n, sizeof(size_t),
+			 graph_read_sz, graph_write_sz, bern, &b);
+	adj_lst_rev(&r, &a);
+      }
+      adj_csr_lst(&c, &a);
+      if (is_undir){
+	c_r = c;
+      }else{
+	adj_csr_lst(&c_r, &r);
+      }
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+      }
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      bfs_ws_init(&ws, n, sizeof(size_t));
+      t = timer();
+      for (j = 0; j < C_ITER; j++){
+	bfs_ws(&a, rand_start[j], dist, prev, &ws, bfs_cmpat_sz, bfs_incr_sz);
+      }
+      t = timer() - t;
+      bfs_ws_free(&ws);
+      printf("\t\t\tbfs_ws ave runtime:                 %.6f seconds\n",
+	     t / C_ITER);
+      for (k = 0; k <= log_threads; k++){
+	num_threads = pow_two(k);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  bfs_pthread(&a, &r, rand_start[j], dist_p, prev_p, num_threads);
+	}
+	t = timer() - t;
+	/* compare the last run */
+	res *= is_bfs(&a, rand_start[C_ITER - 1], dist_p, prev_p, dist, prev);
+	printf("\t\t\tbfs_pthread, %3lu threads:          %.6f seconds\n",
+	       TOLU(num_threads), t / C_ITER);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  bfs_pthread_csr(&c, &c_r, rand_start[j], dist_p, prev_p,
+			  num_threads);
+	}
+	t = timer() - t;
+	res *= is_bfs(&a, rand_start[C_ITER - 1], dist_p, prev_p, dist, prev);
+	printf("\t\t\tbfs_pthread_csr, %3lu threads:      %.6f seconds\n",
+	       TOLU(num_threads), t / C_ITER);
+      }
+      printf("\t\t\tcorrectness:                        ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+      if (!is_undir){
+	adj_lst_free(&r);
+	adj_csr_free(&c_r);
+      }
+    }
+  }
+  free(rand_start);
+  free(dist);
+  free(prev);
+  free(dist_p);
+  free(prev_p);
+  rand_start = NULL;
+  dist = NULL;
+  prev = NULL;
+  dist_p = NULL;
+  prev_p = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  up = g->u;
+  vp = g->v;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]) run_rand_test(args[0], args[1], args[2], 0);
+  if (args[4]) run_rand_test(args[0], args[1], args[2], 1);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,406 @@
+/**
+   bfs-pthread.c
+
+   Functions for running a direction-optimizing
+   BFS algorithm on graphs with generic integer vertices indexed from 0
+   with num_threads threads.
+
+   A graph may be unweighted or weighted. In the latter case the weights of
+   the graph are ignored.
+
+   The algorithm processes the graph in levels. A level is processed
+   top-down, by relaxing the edges from the vertices of the frontier, or
+   bottom-up, by searching each unreached vertex for a neighbor in the
+   frontier in the reversed graph, and stopping at the first neighbor
+   found. Bottom-up levels are selected when the count of edges from the
+   frontier exceeds 1/14 of the count of edges from unreached vertices, and
+   top-down levels are selected again when the frontier drops below 1/24
+   of the vertices. On low-diameter graphs most edges are then never
+   examined in the middle levels.
+
+   Each vertex is owned by a thread according to the word of a bit array
+   that contains the vertex, and the words are assigned to threads
+   cyclically. A thread is the only thread that writes the dist and prev
+   entries and the bits of its vertices, so that BFS requires no locks and
+   no atomic operations. In a top-down level, a thread sends the edges
+   from its frontier vertices to unreached vertices as requests to the
+   owners of the unreached vertices through a request buffer for each pair
+   of threads. In a bottom-up level, the frontier is a bit array that is
+   read by all threads. The levels and their phases are separated by
+   barriers.
+
+   A distance value in the dist array is only set if the corresponding
+   vertex was reached. The prev array is set as in bfs, with the number of
+   vertices as the special value for unreached vertices. If a vertex has
+   several previous vertices at the same distance from start, prev may
+   provide a different previous vertex than bfs.
+
+   A bit array decreased the performance of bfs in tests. Here the bit
+   arrays of reached and frontier vertices are read for many edges in a
+   bottom-up level, and a bottom-up level skips a word of reached vertices
+   at a time.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "bfs-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef struct{
+  size_t num_threads;
+  size_t num_wds;             /* count of words in a bit array */
+  size_t start;
+  const adj_view_t *a;
+  const adj_view_t *r;
+  void *dist;
+  void *prev;
+  unsigned long *reached;     /* bit array of reached vertices */
+  unsigned long *front;       /* bit array of a bottom-up frontier */
+  size_t *nfs;                /* per thread, count of frontier vertices */
+  size_t *mfs;                /* per thread, count of frontier edges */
+  size_t *mus;                /* per thread, count of unreached edges */
+  stack_t *reqs;              /* [src * num_threads + dst] */
+  barrier_t barrier;
+} bfs_t;
+
+typedef struct{
+  size_t id;
+  bfs_t *b;
+} bfs_arg_t;
+
+static const size_t C_BIT = CHAR_BIT * sizeof(unsigned long);
+static const size_t C_ALPHA = 14; /* top-down to bottom-up */
+static const size_t C_BETA = 24; /* bottom-up to top-down */
+static const size_t C_STACK_INIT_COUNT = 1;
+
+static void bfs_pthread_view(const adj_view_t *a,
+			     const adj_view_t *r,
+			     size_t start,
+			     void *dist,
+			     void *prev,
+			     size_t num_threads);
+static void *bfs_thread(void *arg);
+static void top_down(bfs_t *b, size_t id, stack_t *f, stack_t *next,
+		     size_t level);
+static void bottom_up(bfs_t *b, size_t id, stack_t *f, stack_t *next,
+		      size_t level);
+static void reach(bfs_t *b, size_t id, stack_t *next, size_t v, size_t u,
+		  size_t level);
+static int is_set(const unsigned long *bits, size_t i);
+static size_t owner(const bfs_t *b, size_t v);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Computes and copies to an array pointed to by dist the lowest # of edges
+   from start to each reached vertex, and provides a previous vertex in
+   the array pointed to by prev, with the number of vertices in a graph as
+   the special value in prev for unreached vertices, with num_threads
+   threads. Assumes start is valid and there is at least one vertex.
+   a           : pointer to an adjacency list with at least one vertex
+   r           : pointer to the adjacency list of the reversed graph of the
+                 graph of a, with the same vertex type; equal to a if the
+                 graph is undirected
+   start       : a start vertex for running bfs_pthread
+   dist        : pointer to a preallocated array with the count of elements
+                 equal to the number of vertices in the adjacency list; each
+                 element is of the integer type used to represent vertices
+                 in the adjacency list; only the elements corresponding to
+                 reached vertices are set
+   prev        : pointer to a preallocated array with the count equal to the
+                 number of vertices in the adjacency list; each element is
+                 of the integer type used to represent vertices and the
+                 value of every element is set by the algorithm
+   num_threads : > 0 number of threads
+*/
+void bfs_pthread(const adj_lst_t *a,
+		 const adj_lst_t *r,
+		 size_t start,
+		 void *dist,
+		 void *prev,
+		 size_t num_threads){
+  adj_view_t w, w_r;
+  adj_lst_view(&w, a);
+  adj_lst_view(&w_r, r);
+  bfs_pthread_view(&w, &w_r, start, dist, prev, num_threads);
+}
+
+/**
+   Runs bfs_pthread on compressed sparse row (CSR) adjacency lists with at
+   least one vertex. Please see the parameter specification in
+   bfs_pthread.
+*/
+void bfs_pthread_csr(const adj_csr_t *c,
+		     const adj_csr_t *r,
+		     size_t start,
+		     void *dist,
+		     void *prev,
+		     size_t num_threads){
+  adj_view_t w, w_r;
+  adj_csr_view(&w, c);
+  adj_csr_view(&w_r, r);
+  bfs_pthread_view(&w, &w_r, start, dist, prev, num_threads);
+}
+
+/**
+   Runs bfs_pthread on views of adjacency lists. The caller thread runs as
+   the thread with id 0.
+*/
+static void bfs_pthread_view(const adj_view_t *a,
+			     const adj_view_t *r,
+			     size_t start,
+			     void *dist,
+			     void *prev,
+			     size_t num_threads){
+  size_t i;
+  size_t num_reqs = mul_sz_perror(num_threads, num_threads);
+  pthread_t *tids = NULL;
+  bfs_t b;
+  bfs_arg_t *args = NULL;
+  b.num_threads = num_threads;
+  b.num_wds = a->num_vts / C_BIT + (a->num_vts % C_BIT > 0);
+  b.start = start;
+  b.a = a;
+  b.r = r;
+  b.dist = dist;
+  b.prev = prev;
+  b.reached = malloc_perror(b.num_wds, sizeof(unsigned long));
+  b.front = malloc_perror(b.num_wds, sizeof(unsigned long));
+  b.nfs = malloc_perror(num_threads, sizeof(size_t));
+  b.mfs = malloc_perror(num_threads, sizeof(size_t));
+  b.mus = malloc_perror(num_threads, sizeof(size_t));
+  b.reqs = malloc_perror(num_reqs, sizeof(stack_t));
+  for (i = 0; i < num_reqs; i++){
+    stack_init(&b.reqs[i], C_STACK_INIT_COUNT, 2 * sizeof(size_t), NULL);
+  }
+  barrier_init_perror(&b.barrier, num_threads);
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  args = malloc_perror(num_threads, sizeof(bfs_arg_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].b = &b;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&tids[i], bfs_thread, &args[i]);
+  }
+  bfs_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  for (i = 0; i < num_reqs; i++){
+    stack_free(&b.reqs[i]);
+  }
+  free(b.reached);
+  free(b.front);
+  free(b.nfs);
+  free(b.mfs);
+  free(b.mus);
+  free(b.reqs);
+  free(tids);
+  free(args);
+  b.reached = NULL;
+  b.front = NULL;
+  b.nfs = NULL;
+  b.mfs = NULL;
+  b.mus = NULL;
+  b.reqs = NULL;
+  tids = NULL;
+  args = NULL;
+}
+
+/**
+   Runs a thread of bfs_pthread. A thread i) initializes the prev entries
+   and the bits of its vertices, and ii) processes the levels, where the
+   direction of a level is computed by each thread from the per thread
+   counts written before a barrier. A per thread count is written again
+   only after another barrier that follows all reads of the count.
+*/
+static void *bfs_thread(void *arg){
+  int is_bu = 0;
+  size_t id = ((bfs_arg_t *)arg)->id;
+  size_t i, j, u, num_vt_wts;
+  size_t level = 0, nf, mf, mu;
+  bfs_t *b = ((bfs_arg_t *)arg)->b;
+  const adj_view_t *a = b->a;
+  stack_t f, next, t;
+  stack_init(&f, C_STACK_INIT_COUNT, sizeof(size_t), NULL);
+  stack_init(&next, C_STACK_INIT_COUNT, sizeof(size_t), NULL);
+  b->mus[id] = 0;
+  for (i = id; i < b->num_wds; i += b->num_threads){
+    b->reached[i] = 0;
+    for (j = 0; j < C_BIT && i * C_BIT + j < a->num_vts; j++){
+      u = i * C_BIT + j;
+      a->write_vt(ptr(b->prev, u, a->vt_size), a->num_vts);
+      a->vt_wts(a->adj, u, &num_vt_wts);
+      b->mus[id] += num_vt_wts;
+    }
+  }
+  b->mfs[id] = 0;
+  if (owner(b, b->start) == id){
+    reach(b, id, &next, b->start, b->start, level);
+  }
+  for (;;){
+    t = f;
+    f = next;
+    next = t;
+    next.num_elts = 0;
+    b->nfs[id] = f.num_elts;
+    barrier_wait_perror(&b->barrier);
+    nf = 0;
+    mf = 0;
+    mu = 0;
+    for (i = 0; i < b->num_threads; i++){
+      nf += b->nfs[i];
+      mf += b->mfs[i];
+      mu += b->mus[i];
+    }
+    if (nf == 0) break;
+    if (!is_bu && mf > mu / C_ALPHA){
+      is_bu = 1;
+    }else if (is_bu && nf < a->num_vts / C_BETA){
+      is_bu = 0;
+    }
+    if (is_bu){
+      bottom_up(b, id, &f, &next, level);
+    }else{
+      top_down(b, id, &f, &next, level);
+    }
+    level++;
+  }
+  stack_free(&f);
+  stack_free(&next);
+  return NULL;
+}
+
+/**
+   Processes a level top-down. A thread sends the edges from the vertices
+   of its frontier to unreached vertices, and after a barrier, applies the
+   requests sent to its vertices. The reached bits are only written in
+   the second phase.
+*/
+static void top_down(bfs_t *b, size_t id, stack_t *f, stack_t *next,
+		     size_t level){
+  size_t i, j, u, v, num_vt_wts;
+  size_t uv[2];
+  const size_t *fs = f->elts;
+  const size_t *p_uv = NULL;
+  const adj_view_t *a = b->a;
+  const char *p = NULL, *p_end = NULL;
+  stack_t *s = NULL;
+  for (i = 0; i < f->num_elts; i++){
+    u = fs[i];
+    p = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p + num_vt_wts * a->pair_size;
+    uv[0] = u;
+    for (; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      if (is_set(b->reached, v)) continue;
+      uv[1] = v;
+      stack_push(&b->reqs[id * b->num_threads + owner(b, v)], uv);
+    }
+  }
+  barrier_wait_perror(&b->barrier);
+  b->mfs[id] = 0;
+  for (i = 0; i < b->num_threads; i++){
+    s = &b->reqs[i * b->num_threads + id];
+    p_uv = s->elts;
+    for (j = 0; j < s->num_elts; j++){
+      if (!is_set(b->reached, p_uv[1])){
+	reach(b, id, next, p_uv[1], p_uv[0], level + 1);
+      }
+      p_uv += 2;
+    }
+    s->num_elts = 0;
+  }
+}
+
+/**
+   Processes a level bottom-up. A thread writes the frontier bits of its
+   vertices, and after a barrier, searches the reversed graph from each of
+   its unreached vertices for a vertex in the frontier.
+*/
+static void bottom_up(bfs_t *b, size_t id, stack_t *f, stack_t *next,
+		      size_t level){
+  size_t i, j, u, v, num_vt_wts;
+  const size_t *fs = f->elts;
+  const adj_view_t *a = b->a;
+  const adj_view_t *r = b->r;
+  const char *p = NULL, *p_end = NULL;
+  for (i = id; i < b->num_wds; i += b->num_threads){
+    b->front[i] = 0;
+  }
+  for (i = 0; i < f->num_elts; i++){
+    b->front[fs[i] / C_BIT] |= 1UL << (fs[i] % C_BIT);
+  }
+  barrier_wait_perror(&b->barrier);
+  b->mfs[id] = 0;
+  for (i = id; i < b->num_wds; i += b->num_threads){
+    if (b->reached[i] == ~0UL) continue;
+    for (j = 0; j < C_BIT && i * C_BIT + j < a->num_vts; j++){
+      v = i * C_BIT + j;
+      if (is_set(b->reached, v)) continue;
+      p = r->vt_wts(r->adj, v, &num_vt_wts);
+      p_end = p + num_vt_wts * r->pair_size;
+      for (; p != p_end; p += r->pair_size){
+	u = r->read_vt(p);
+	if (is_set(b->front, u)){
+	  reach(b, id, next, v, u, level + 1);
+	  break;
+	}
+      }
+    }
+  }
+}
+
+/**
+   Sets a vertex v owned by a thread as reached from u at a level, and
+   pushes v into the next frontier of the thread.
+*/
+static void reach(bfs_t *b, size_t id, stack_t *next, size_t v, size_t u,
+		  size_t level){
+  size_t num_vt_wts;
+  const adj_view_t *a = b->a;
+  b->reached[v / C_BIT] |= 1UL << (v % C_BIT);
+  a->write_vt(ptr(b->dist, v, a->vt_size), level);
+  a->write_vt(ptr(b->prev, v, a->vt_size), u);
+  a->vt_wts(a->adj, v, &num_vt_wts);
+  b->mfs[id] += num_vt_wts;
+  b->mus[id] -= num_vt_wts;
+  stack_push(next, &v);
+}
+
+/**
+   Returns non-zero if the ith bit of a bit array is set.
+*/
+static int is_set(const unsigned long *bits, size_t i){
+  return (bits[i / C_BIT] >> (i % C_BIT)) & 1UL;
+}
+
+/**
+   Returns the thread that owns a vertex.
+*/
+static size_t owner(const bfs_t *b, size_t v){
+  return (v / C_BIT) % b->num_threads;
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
@@ -0,0 +1,101 @@
+/**
+   bfs-pthread.h
+
+   Declarations of accessible functions for running a direction-optimizing
+   BFS algorithm on graphs with generic integer vertices indexed from 0
+   with num_threads threads.
+
+   A graph may be unweighted or weighted. In the latter case the weights of
+   the graph are ignored.
+
+   The algorithm processes the graph in levels. A level is processed
+   top-down, by relaxing the edges from the vertices of the frontier, or
+   bottom-up, by searching each unreached vertex for a neighbor in the
+   frontier in the reversed graph, and stopping at the first neighbor
+   found. Bottom-up levels are selected when the count of edges from the
+   frontier exceeds 1/14 of the count of edges from unreached vertices, and
+   top-down levels are selected again when the frontier drops below 1/24
+   of the vertices. On low-diameter graphs most edges are then never
+   examined in the middle levels.
+
+   Each vertex is owned by a thread according to the word of a bit array
+   that contains the vertex, and the words are assigned to threads
+   cyclically. A thread is the only thread that writes the dist and prev
+   entries and the bits of its vertices, so that BFS requires no locks and
+   no atomic operations. In a top-down level, a thread sends the edges
+   from its frontier vertices to unreached vertices as requests to the
+   owners of the unreached vertices through a request buffer for each pair
+   of threads. In a bottom-up level, the frontier is a bit array that is
+   read by all threads. The levels and their phases are separated by
+   barriers.
+
+   A distance value in the dist array is only set if the corresponding
+   vertex was reached. The prev array is set as in bfs, with the number of
+   vertices as the special value for unreached vertices. If a vertex has
+   several previous vertices at the same distance from start, prev may
+   provide a different previous vertex than bfs.
+
+   A bit array decreased the performance of bfs in tests. Here the bit
+   arrays of reached and frontier vertices are read for many edges in a
+   bottom-up level, and a bottom-up level skips a word of reached vertices
+   at a time.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef BFS_PTHREAD_H  
+#define BFS_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Computes and copies to an array pointed to by dist the lowest # of edges
+   from start to each reached vertex, and provides a previous vertex in
+   the array pointed to by prev, with the number of vertices in a graph as
+   the special value in prev for unreached vertices, with num_threads
+   threads. Assumes start is valid and there is at least one vertex.
+   a           : pointer to an adjacency list with at least one vertex
+   r           : pointer to the adjacency list of the reversed graph of the
+                 graph of a, with the same vertex type; equal to a if the
+                 graph is undirected
+   start       : a start vertex for running bfs_pthread
+   dist        : pointer to a preallocated array with the count of elements
+                 equal to the number of vertices in the adjacency list; each
+                 element is of the integer type used to represent vertices
+                 in the adjacency list; only the elements corresponding to
+                 reached vertices are set
+   prev        : pointer to a preallocated array with the count equal to the
+                 number of vertices in the adjacency list; each element is
+                 of the integer type used to represent vertices and the
+                 value of every element is set by the algorithm
+   num_threads : > 0 number of threads
+*/
+void bfs_pthread(const adj_lst_t *a,
+		 const adj_lst_t *r,
+		 size_t start,
+		 void *dist,
+		 void *prev,
+		 size_t num_threads);
+
+/**
+   Runs bfs_pthread on compressed sparse row (CSR) adjacency lists with at
+   least one vertex. Please see the parameter specification in
+   bfs_pthread.
+*/
+void bfs_pthread_csr(const adj_csr_t *c,
+		     const adj_csr_t *r,
+		     size_t start,
+		     void *dist,
+		     void *prev,
+		     size_t num_threads);
+
+#endif
@@ -0,0 +1,259 @@
+/**
+   cc-pthread-test.c
+
+   Tests of the parallel connected components algorithm with num_threads
+   threads on random graphs with size_t and unsigned int vertices, by
+   comparing the components to the components computed by a serial
+   traversal of the undirected adjacency list of a graph.
+
+   The following command line arguments can be used to customize tests:
+   cc-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, 8] : k for 2**k threads in the largest thread test
+      [0, 1] : size_t vertex test on/off
+      [0, 1] : unsigned int vertex test on/off
+
+   usage examples:
+   ./cc-pthread-test
+   ./cc-pthread-test 10 18
+   ./cc-pthread-test 18 18 3 1 0
+
+   cc-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "cc-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "cc-pthread-test\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph\n"
+  "[0, 8] : k for 2**k threads in the largest thread test\n"
+  "[0, 1] : size_t vertex test on/off\n"
+  "[0, 1] : unsigned int vertex test on/off\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 16, 2, 1, 1};
+const size_t C_THREADS_LOG_MAX = 8;
+
+/* random graph tests; # edges = # vertices * C_ES_NUM[i] / 4 */
+const int C_ITER = 5;
+const int C_ES_COUNT = 5;
+const size_t C_ES_NUM[5] = {0, 2, 4, 8, 64};
+const size_t C_ES_DEN = 4;
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+void rand_graph_init(graph_t *g,
+		     size_t num_vts,
+		     size_t num_es,
+		     size_t vt_size,
+		     size_t (*read_vt)(const void *),
+		     void (*write_vt)(void *, size_t));
+double timer();
+void print_test_result(int res);
+
+/**
+   Computes the lowest vertex of the component of each vertex with a serial
+   traversal of the undirected adjacency list of a graph, and returns the
+   number of components.
+*/
+size_t serial_cc(const adj_lst_t *a, size_t *comp){
+  size_t i, j, u, v, num_vt_wts;
+  size_t ret = 0;
+  const char *p = NULL;
+  stack_t s;
+  stack_init(&s, 1, sizeof(size_t), NULL);
+  for (i = 0; i < a->num_vts; i++){
+    comp[i] = a->num_vts;
+  }
+  for (i = 0; i < a->num_vts; i++){
+    if (comp[i] < a->num_vts) continue;
+    ret++;
+    comp[i] = i;
+    stack_push(&s, &i);
+    while (s.num_elts > 0){
+      stack_pop(&s, &u);
+      p = adj_lst_vt_wts(a, u, &num_vt_wts);
+      for (j = 0; j < num_vt_wts; j++){
+	v = a->read_vt(p);
+	if (comp[v] == a->num_vts){
+	  comp[v] = i;
+	  stack_push(&s, &v);
+	}
+	p += a->pair_size;
+      }
+    }
+  }
+  stack_free(&s);
+  return ret;
+}
+
+/**
+   Runs a test on random graphs.
+*/
+void run_rand_test(int pow_start,
+		   int pow_end,
+		   size_t log_threads,
+		   size_t vt_size,
+		   size_t (*read_vt)(const void *),
+		   void (*write_vt)(void *, size_t),
+		   const char *type_string){
+  int e, i, j;
+  int res = 1;
+  size_t k, l, n, num_threads, num_comps, num_comps_p = 0;
+  size_t *comp = NULL;
+  void *comp_p = NULL;
+  graph_t g;
+  adj_lst_t a;
+  double t;
+  comp = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  comp_p = malloc_perror(pow_two(pow_end), vt_size);
+  printf("Run a cc_pthread test on random graphs with %s vertices\n",
+	 type_string);
+  fflush(stdout);
+  for (e = 0; e < C_ES_COUNT; e++){
+    printf("\t# of edges / # of vertices = %.2f\n",
+	   (double)C_ES_NUM[e] / C_ES_DEN);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      rand_graph_init(&g, n, n * C_ES_NUM[e] / C_ES_DEN,
+		      vt_size, read_vt, write_vt);
+      printf("\t\tvertices: %lu, # of edges: %lu\n",
+	     TOLU(g.num_vts), TOLU(g.num_es));
+      t = timer();
+      adj_lst_base_init(&a, &g);
+      adj_lst_undir_build(&a, &g);
+      num_comps = serial_cc(&a, comp);
+      t = timer() - t;
+      printf("\t\t\tserial adj_lst build and traversal: %.6f seconds\n", t);
+      for (k = 0; k <= log_threads; k++){
+	num_threads = pow_two(k);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  num_comps_p = cc_pthread(&g, comp_p, num_threads);
+	}
+	t = timer() - t;
+	res *= (num_comps == num_comps_p);
+	for (l = 0; l < n; l++){
+	  res *= (comp[l] == read_vt((char *)comp_p + l * vt_size));
+	}
+	printf("\t\t\tcc_pthread, %3lu threads:            %.6f seconds\n",
+	       TOLU(num_threads), t / C_ITER);
+      }
+      printf("\t\t\tcomponents:                         %lu\n",
+	     TOLU(num_comps));
+      printf("\t\t\tcorrectness:                        ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      graph_free(&g);
+    }
+  }
+  free(comp);
+  free(comp_p);
+  comp = NULL;
+  comp_p = NULL;
+}
+
+/**
+   Initializes a graph with num_es edges with random endpoints.
+*/
+void rand_graph_init(graph_t *g,
+		     size_t num_vts,
+		     size_t num_es,
+		     size_t vt_size,
+		     size_t (*read_vt)(const void *),
+		     void (*write_vt)(void *, size_t)){
+  size_t i;
+  graph_base_init(g, num_vts, vt_size, 0, read_vt, write_vt);
+  if (num_es == 0) return;
+  g->num_es = num_es;
+  g->u = malloc_perror(num_es, vt_size);
+  g->v = malloc_perror(num_es, vt_size);
+  for (i = 0; i < num_es; i++){
+    write_vt((char *)g->u + i * vt_size, RANDOM() % num_vts);
+    write_vt((char *)g->v + i * vt_size, RANDOM() % num_vts);
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]){
+    run_rand_test(args[0], args[1], args[2], sizeof(size_t),
+		  graph_read_sz, graph_write_sz, "size_t");
+  }
+  if (args[4]){
+    run_rand_test(args[0], args[1], args[2], sizeof(unsigned int),
+		  graph_read_uint, graph_write_uint, "unsigned int");
+  }
+  free(args);
+  args = NULL;
+  return 0;
+}
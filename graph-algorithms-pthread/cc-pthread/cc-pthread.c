@@ -0,0 +1,282 @@
+/**
+   cc-pthread.c
+
+   Functions for computing connected components of
+   graphs with generic integer vertices indexed from 0 with num_threads
+   threads.
+
+   The edges of a graph are provided in the u and v arrays of a graph_t
+   struct, and each edge is treated as undirected. A graph may be
+   unweighted or weighted. In the latter case the weights of the graph are
+   ignored.
+
+   The algorithm is a variant of the Shiloach-Vishkin algorithm on a
+   forest of parent pointers, where a parent is always lower than its
+   child. In a round, i) the edges are scanned and an edge with endpoints
+   in different trees sends a request to hook the higher root to the lower
+   root, ii) the requests are applied, and iii) the trees are flattened to
+   stars by pointer jumping. The number of trees in a component at least
+   halves in a round, and the algorithm ends after a round without hook
+   requests. The root of a component is its lowest vertex.
+
+   Each vertex is owned by a thread according to a block of consecutive
+   vertices, and the edges are divided into blocks of consecutive edges.
+   A parent is only written by the owner of the vertex, and hook requests
+   are sent to the owners of roots through a request buffer for each pair
+   of threads, so that each parent has a single writer in a phase and the
+   result of a round does not depend on the interleaving of threads.
+   Pointer jumping alternates between two parent arrays. The phases are
+   separated by barriers. An edge with both endpoints in the same tree is
+   marked in a bit array and is not scanned in later rounds.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "cc-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef struct{
+  size_t num_threads;
+  size_t num_vts_blk;         /* count of vertices per thread */
+  size_t num_wds_blk;         /* count of words of edges per thread */
+  const graph_t *g;
+  void *comp;
+  size_t *pa;                 /* parent arrays for pointer jumping */
+  size_t *pb;
+  unsigned long *same;        /* bit array of edges within a tree */
+  size_t *counts;             /* [parity * num_threads + id] */
+  stack_t *reqs;              /* [src * num_threads + dst] */
+  barrier_t barrier;
+} cc_t;
+
+typedef struct{
+  size_t id;
+  size_t num_comps;
+  cc_t *b;
+} cc_arg_t;
+
+static const size_t C_BIT = CHAR_BIT * sizeof(unsigned long);
+static const unsigned long C_ONES = (unsigned long)-1;
+static const size_t C_STACK_INIT_COUNT = 1;
+
+static void *cc_thread(void *arg);
+static size_t hook(cc_t *b, size_t id, const size_t *p);
+static size_t sum_counts(cc_t *b, size_t id, size_t *parity, size_t count);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Computes the connected components of a graph with num_threads threads,
+   copies the lowest vertex of the component of each vertex to the array
+   pointed to by comp, and returns the number of components.
+   g           : pointer to a graph with at least one vertex; the vertices
+                 are read with the read_vt function of the graph
+   comp        : pointer to a preallocated array with the count equal to the
+                 number of vertices in the graph; each element is of the
+                 integer type used to represent vertices in the graph, and
+                 is written with the write_vt function of the graph
+   num_threads : > 0 number of threads
+*/
+size_t cc_pthread(const graph_t *g, void *comp, size_t num_threads){
+  size_t i;
+  size_t num_wds = g->num_es / C_BIT + (g->num_es % C_BIT > 0);
+  size_t num_reqs = mul_sz_perror(num_threads, num_threads);
+  pthread_t *tids = NULL;
+  cc_t b;
+  cc_arg_t *args = NULL;
+  b.num_threads = num_threads;
+  b.num_vts_blk = g->num_vts / num_threads + (g->num_vts % num_threads > 0);
+  b.num_wds_blk = num_wds / num_threads + (num_wds % num_threads > 0);
+  b.g = g;
+  b.comp = comp;
+  b.pa = malloc_perror(g->num_vts, sizeof(size_t));
+  b.pb = malloc_perror(g->num_vts, sizeof(size_t));
+  b.same = calloc_perror(num_wds + 1, sizeof(unsigned long));
+  b.counts = malloc_perror(mul_sz_perror(2, num_threads), sizeof(size_t));
+  b.reqs = malloc_perror(num_reqs, sizeof(stack_t));
+  for (i = 0; i < num_reqs; i++){
+    stack_init(&b.reqs[i], C_STACK_INIT_COUNT, 2 * sizeof(size_t), NULL);
+  }
+  barrier_init_perror(&b.barrier, num_threads);
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  args = malloc_perror(num_threads, sizeof(cc_arg_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].num_comps = 0;
+    args[i].b = &b;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&tids[i], cc_thread, &args[i]);
+  }
+  cc_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  for (i = 0; i < num_reqs; i++){
+    stack_free(&b.reqs[i]);
+  }
+  free(b.pa);
+  free(b.pb);
+  free(b.same);
+  free(b.counts);
+  free(b.reqs);
+  free(tids);
+  b.pa = NULL;
+  b.pb = NULL;
+  b.same = NULL;
+  b.counts = NULL;
+  b.reqs = NULL;
+  tids = NULL;
+  i = args[0].num_comps;
+  free(args);
+  args = NULL;
+  return i;
+}
+
+/**
+   Runs a thread of cc_pthread. A thread i) initializes the parents of its
+   vertices, and ii) runs the rounds, where the end of a round and of
+   pointer jumping is computed by each thread from the per thread counts
+   written before a barrier. The parent arrays of all threads are swapped
+   in the same steps; an array is written again only after a barrier that
+   follows all reads of the array.
+*/
+static void *cc_thread(void *arg){
+  size_t id = ((cc_arg_t *)arg)->id;
+  size_t i, u, hi, lo, vt_beg, vt_end;
+  size_t count, parity = 0;
+  size_t uv[2];
+  size_t *p = NULL, *q = NULL, *t = NULL;
+  cc_t *b = ((cc_arg_t *)arg)->b;
+  const graph_t *g = b->g;
+  stack_t *s = NULL;
+  p = b->pa;
+  q = b->pb;
+  vt_beg = id * b->num_vts_blk;
+  vt_end = vt_beg + b->num_vts_blk;
+  if (vt_beg > g->num_vts) vt_beg = g->num_vts;
+  if (vt_end > g->num_vts) vt_end = g->num_vts;
+  for (u = vt_beg; u < vt_end; u++){
+    p[u] = u;
+  }
+  barrier_wait_perror(&b->barrier);
+  for (;;){
+    count = hook(b, id, p);
+    if (sum_counts(b, id, &parity, count) == 0) break;
+    /* apply the hook requests to the roots of the thread */
+    for (i = 0; i < b->num_threads; i++){
+      s = &b->reqs[i * b->num_threads + id];
+      while (s->num_elts > 0){
+	stack_pop(s, uv);
+	hi = uv[0];
+	lo = uv[1];
+	if (lo < p[hi]) p[hi] = lo;
+      }
+    }
+    barrier_wait_perror(&b->barrier);
+    /* pointer jumping until each tree is a star */
+    do{
+      count = 0;
+      for (u = vt_beg; u < vt_end; u++){
+	q[u] = p[p[u]];
+	count += (q[u] != p[u]);
+      }
+      t = p;
+      p = q;
+      q = t;
+    }while (sum_counts(b, id, &parity, count) > 0);
+  }
+  count = 0;
+  for (u = vt_beg; u < vt_end; u++){
+    g->write_vt(ptr(b->comp, u, g->vt_size), p[u]);
+    count += (p[u] == u);
+  }
+  ((cc_arg_t *)arg)->num_comps = sum_counts(b, id, &parity, count);
+  return NULL;
+}
+
+/**
+   Scans the edges of a thread that are not within a tree, marks the edges
+   found within a tree, and sends a request for each other edge to the
+   owner of the higher root. Each parent is a root when hook is called.
+   Returns the number of sent requests. Consecutive equal requests to the
+   same owner are sent once.
+*/
+static size_t hook(cc_t *b, size_t id, const size_t *p){
+  size_t i, j, wd, wd_beg, wd_end, pu, pv, hi, lo, dst;
+  size_t count = 0;
+  size_t uv[2];
+  size_t *last = NULL;
+  const graph_t *g = b->g;
+  stack_t *s = NULL;
+  wd_beg = id * b->num_wds_blk;
+  wd_end = wd_beg + b->num_wds_blk;
+  for (wd = wd_beg; wd < wd_end && wd * C_BIT < g->num_es; wd++){
+    if (b->same[wd] == C_ONES) continue;
+    for (j = 0; j < C_BIT; j++){
+      i = wd * C_BIT + j;
+      if (i == g->num_es) break;
+      if (b->same[wd] & (1UL << j)) continue;
+      pu = p[g->read_vt(ptr(g->u, i, g->vt_size))];
+      pv = p[g->read_vt(ptr(g->v, i, g->vt_size))];
+      if (pu == pv){
+	b->same[wd] |= 1UL << j;
+	continue;
+      }
+      hi = (pu < pv) ? pv : pu;
+      lo = (pu < pv) ? pu : pv;
+      dst = hi / b->num_vts_blk;
+      s = &b->reqs[id * b->num_threads + dst];
+      if (s->num_elts > 0){
+	last = ptr(s->elts, s->num_elts - 1, s->elt_size);
+	if (last[0] == hi && last[1] == lo) continue;
+      }
+      uv[0] = hi;
+      uv[1] = lo;
+      stack_push(s, uv);
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+   Writes the count of a thread, and returns the sum of the counts of all
+   threads after a barrier. The counts alternate between two parities, so
+   that a count is written again only after the barrier of the next call,
+   which follows all reads of the count.
+*/
+static size_t sum_counts(cc_t *b, size_t id, size_t *parity, size_t count){
+  size_t i;
+  size_t ret = 0;
+  size_t *counts = b->counts + *parity * b->num_threads;
+  counts[id] = count;
+  barrier_wait_perror(&b->barrier);
+  for (i = 0; i < b->num_threads; i++){
+    ret += counts[i];
+  }
+  *parity = 1 - *parity;
+  return ret;
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
@@ -0,0 +1,63 @@
+/**
+   cc-pthread.h
+
+   Declarations of accessible functions for computing connected components of
+   graphs with generic integer vertices indexed from 0 with num_threads
+   threads.
+
+   The edges of a graph are provided in the u and v arrays of a graph_t
+   struct, and each edge is treated as undirected. A graph may be
+   unweighted or weighted. In the latter case the weights of the graph are
+   ignored.
+
+   The algorithm is a variant of the Shiloach-Vishkin algorithm on a
+   forest of parent pointers, where a parent is always lower than its
+   child. In a round, i) the edges are scanned and an edge with endpoints
+   in different trees sends a request to hook the higher root to the lower
+   root, ii) the requests are applied, and iii) the trees are flattened to
+   stars by pointer jumping. The number of trees in a component at least
+   halves in a round, and the algorithm ends after a round without hook
+   requests. The root of a component is its lowest vertex.
+
+   Each vertex is owned by a thread according to a block of consecutive
+   vertices, and the edges are divided into blocks of consecutive edges.
+   A parent is only written by the owner of the vertex, and hook requests
+   are sent to the owners of roots through a request buffer for each pair
+   of threads, so that each parent has a single writer in a phase and the
+   result of a round does not depend on the interleaving of threads.
+   Pointer jumping alternates between two parent arrays. The phases are
+   separated by barriers. An edge with both endpoints in the same tree is
+   marked in a bit array and is not scanned in later rounds.
+
+   The implementation only uses integer and pointer operations. Given
+   parameter values within the specified ranges, the implementation provides
+   an error message and an exit is executed if an integer overflow is
+   attempted or an allocation is not completed due to insufficient
+   resources. The behavior outside the specified parameter ranges is
+   undefined.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef CC_PTHREAD_H
+#define CC_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Computes the connected components of a graph with num_threads threads,
+   copies the lowest vertex of the component of each vertex to the array
+   pointed to by comp, and returns the number of components.
+   g           : pointer to a graph with at least one vertex; the vertices
+                 are read with the read_vt function of the graph
+   comp        : pointer to a preallocated array with the count equal to the
+                 number of vertices in the graph; each element is of the
+                 integer type used to represent vertices in the graph, and
+                 is written with the write_vt function of the graph
+   num_threads : > 0 number of threads
+*/
+size_t cc_pthread(const graph_t *g, void *comp, size_t num_threads);
+
+#endif
@@ -0,0 +1,340 @@
+/**
+   delta-stepping-pthread-test.c
+
+   Tests of the delta-stepping algorithm with num_threads threads on random
+   directed graphs with random size_t weights, by comparing the distances
+   to the distances computed by Dijkstra's algorithm.
+
+   The following command line arguments can be used to customize tests:
+   delta-stepping-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, 8] : k for 2**k threads in the largest thread test
+      [1, 2**12] : delta as max weight / delta
+      [0, 1] : random graph test on/off
+
+   usage examples:
+   ./delta-stepping-pthread-test
+   ./delta-stepping-pthread-test 10 14
+   ./delta-stepping-pthread-test 14 14 3 16 1
+   ./delta-stepping-pthread-test 10 12 2 4096 1
+
+   delta-stepping-pthread-test can be run with any subset of command line
+   arguments in the above-defined order. If the (i + 1)th argument is
+   specified then the ith argument must be specified for i >= 0. Default
+   values are used for the unspecified arguments according to the
+   C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "delta-stepping-pthread.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "delta-stepping-pthread-test\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph\n"
+  "[0, 8] : k for 2**k threads in the largest thread test\n"
+  "[1, 2**12] : delta as max weight / delta\n"
+  "[0, 1] : random graph test on/off\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 11, 2, 16, 1};
+const size_t C_THREADS_LOG_MAX = 8;
+const size_t C_DELTA_DIV_MAX = 4096;
+
+/* random graph test */
+const int C_ITER = 5;
+const int C_PROBS_COUNT = 4;
+const double C_PROBS[4] = {1.000000, 0.250000, 0.015625, 0.000977};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_SIZE_MAX = (size_t)-1;
+const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
+			      ((CHAR_BIT * sizeof(size_t) + 1) / 2));
+
+size_t delta = 1; /* set in main */
+
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
+double timer();
+void print_test_result(int res);
+
+/**
+   Weight functions.
+*/
+
+void add_uint(void *sum, const void *wt_a, const void *wt_b){
+  *(size_t *)sum = *(size_t *)wt_a + *(size_t *)wt_b;
+}
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+size_t bkt_uint(const void *a){
+  return *(size_t *)a / delta;
+}
+
+/**
+   Construct adjacency lists of random directed graphs with random
+   weights.
+*/
+
+typedef struct{
+  double p;
+} bern_arg_t;
+
+int bern(void *arg){
+  bern_arg_t *b = arg;
+  if (b->p >= 1.0) return 1;
+  if (b->p <= 0.0) return 0;
+  if (b->p > DRAND()) return 1;
+  return 0;
+}
+
+void adj_lst_rand_dir_wts(adj_lst_t *a,
+			  size_t n,
+			  size_t wt_l,
+			  size_t wt_h,
+			  bern_arg_t *b){
+  size_t i, j;
+  size_t wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n - 1; i++){
+    for (j = i + 1; j < n; j++){
+      wt = wt_l + DRAND() * (wt_h - wt_l);
+      adj_lst_add_dir_edge(a, i, j, &wt, bern, b);
+      wt = wt_l + DRAND() * (wt_h - wt_l);
+      adj_lst_add_dir_edge(a, j, i, &wt, bern, b);
+    }
+  }
+  graph_free(&g);
+}
+
+/**
+   Run a test on random directed graphs with random size_t weights.
+*/
+
+int same_dist(size_t n,
+	      const size_t *dist_a,
+	      const size_t *prev_a,
+	      const size_t *dist_b,
+	      const size_t *prev_b){
+  size_t i;
+  for (i = 0; i < n; i++){
+    if ((prev_a[i] == C_SIZE_MAX) != (prev_b[i] == C_SIZE_MAX)) return 0;
+    if (prev_a[i] != C_SIZE_MAX && dist_a[i] != dist_b[i]) return 0;
+  }
+  return 1;
+}
+
+void run_rand_test(int pow_start, int pow_end, size_t log_threads){
+  int p, i, j;
+  int res = 1;
+  size_t k, n, num_threads;
+  size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
+  size_t *rand_start = NULL;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *dist_d = NULL, *prev_d = NULL;
+  adj_lst_t a;
+  adj_csr_t c;
+  graph_t g;
+  bern_arg_t b;
+  dijkstra_ws_t ws;
+  double t;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist_d = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev_d = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  printf("Run a delta_stepping_pthread test on random directed graphs "
+	 "with random size_t weights in [%lu, %lu], delta %lu\n",
+	 TOLU(wt_l), TOLU(wt_h), TOLU(delta));
+  fflush(stdout);
+  for (p = 0; p < C_PROBS_COUNT; p++){
+    b.p = C_PROBS[p];
+    printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      adj_lst_rand_dir_wts(&a, n, wt_l, wt_h, &b);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+      }
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      dijkstra_ws_init(&ws, n, sizeof(size_t), NULL, cmp_uint);
+      t = timer();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws(&a, rand_start[j], dist, prev, &ws, add_uint, cmp_uint);
+      }
+      t = timer() - t;
+      dijkstra_ws_free(&ws);
+      printf("\t\t\tdijkstra_ws ave runtime:               %.6f seconds\n",
+	     t / C_ITER);
+      for (k = 0; k <= log_threads; k++){
+	num_threads = pow_two(k);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  delta_stepping_pthread(&a, rand_start[j], dist_d, prev_d,
+				 num_threads, add_uint, cmp_uint, bkt_uint);
+	}
+	t = timer() - t;
+	/* compare the last run */
+	res *= same_dist(n, dist, prev, dist_d, prev_d);
+	printf("\t\t\tdelta_stepping_pthread, %3lu threads:  %.6f seconds\n",
+	       TOLU(num_threads), t / C_ITER);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  delta_stepping_pthread_csr(&c, rand_start[j], dist_d, prev_d,
+				     num_threads, add_uint, cmp_uint, bkt_uint);
+	}
+	t = timer() - t;
+	res *= same_dist(n, dist, prev, dist_d, prev_d);
+	printf("\t\t\tdelta_stepping_pthread_csr, %3lu threads: %.6f "
+	       "seconds\n", TOLU(num_threads), t / C_ITER);
+      }
+      printf("\t\t\tcorrectness:                           ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+    }
+  }
+  free(rand_start);
+  free(dist);
+  free(prev);
+  free(dist_d);
+  free(prev_d);
+  rand_start = NULL;
+  dist = NULL;
+  prev = NULL;
+  dist_d = NULL;
+  prev_d = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] < 1 ||
+      args[3] > C_DELTA_DIV_MAX ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  delta = C_WEIGHT_HIGH / args[3];
+  if (args[4]) run_rand_test(args[0], args[1], args[2]);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,511 @@
+/**
+   delta-stepping-pthread.c
+
+   The delta-stepping algorithm for single-source shortest paths on graphs
+   with generic non-negative weights with num_threads threads.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block, with the weight functions of dijkstra and a bucket
+   function that returns floor(w / delta) for a weight w and a width
+   delta chosen by the user. An edge is light if its weight is in bucket 0
+   and heavy otherwise.
+
+   Each vertex is owned by a thread according to the block of 2**6
+   consecutive vertices that contains the vertex. A thread keeps the
+   buckets of its vertices and is the only thread that reads and writes
+   the distances, previous vertices, and bucket positions of its vertices,
+   so that each of these values has a single writer. A relaxation of an
+   edge (u, v) is sent by the owner of u as a request to the owner of v
+   through a request buffer for each pair of threads. The threads process
+   the current bucket in rounds separated by barriers: i) each thread
+   removes the vertices of its part of the bucket and sends light edge
+   requests, ii) each thread applies the requests to its vertices, and
+   iii) the threads test if the bucket is empty. When the bucket is empty,
+   the heavy edges of the removed vertices are relaxed and the threads
+   move to the next non-empty bucket.
+
+   A vertex is in at most one bucket position at a time according to the
+   pos array, and an entry of a bucket with a different position is
+   skipped. A vertex that is removed from the current bucket is added to
+   the set of the removed vertices of its owner at most once per bucket.
+
+   The buckets of a thread are a window of cyclic buckets and an overflow
+   bucket. The count of cyclic buckets is the lowest power of two that is
+   not less than two plus the maximal bucket of an edge weight in the
+   graph, and is at most 2**10. A vertex with a bucket beyond the window
+   is pushed into the overflow bucket, and is moved to the window when the
+   window reaches its bucket. A delta that is small relative to the
+   maximal edge weight results in scans of the overflow bucket, and a
+   delta that is large relative to the edge weights results in more
+   relaxations of light edges. A delta approximately equal to the maximal
+   edge weight divided by the average degree is a common starting point.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "delta-stepping-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef struct{
+  size_t num_threads;
+  size_t num_bkts;            /* count of cyclic buckets, power of two */
+  size_t req_size;            /* v, u, and weight of a request */
+  size_t start;
+  const adj_view_t *a;
+  void *dist;
+  size_t *prev;
+  size_t *pos;                /* absolute bucket of a vertex or C_NQUEUED */
+  char *in_s;                 /* non-zero if in a set of removed vertices */
+  int *nonempty;              /* per thread */
+  size_t *maxs;               /* per thread, maximum edge bucket */
+  size_t *mins;               /* per thread, minimum non-empty bucket */
+  stack_t *reqs;              /* [src * num_threads + dst] */
+  stack_t *sets;              /* per thread, removed vertices */
+  barrier_t barrier;
+  void (*add_wt)(void *, const void *, const void *);
+  int (*cmp_wt)(const void *, const void *);
+  size_t (*bkt_wt)(const void *);
+} dstep_t;
+
+typedef struct{
+  size_t id;
+  dstep_t *d;
+} dstep_arg_t;
+
+typedef struct{
+  size_t cur;                 /* absolute index of the current bucket */
+  size_t ovf_min;             /* lower bound of the buckets in ovf */
+  stack_t *bkts;              /* num_bkts cyclic buckets from cur */
+  stack_t ovf;                /* vertex and bucket beyond the cyclic ones */
+} dstep_bkts_t;
+
+static const size_t C_NREACHED = (size_t)-1;
+static const size_t C_NQUEUED = (size_t)-1;
+static const size_t C_LOG_BLK = 6; /* log base 2 of ownership block */
+static const size_t C_STACK_INIT_COUNT = 1;
+static const size_t C_NUM_BKTS_MAX = 1024; /* power of two */
+
+static void delta_stepping_view(const adj_view_t *a,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				size_t num_threads,
+				void (*add_wt)(void *, const void *,
+					       const void *),
+				int (*cmp_wt)(const void *, const void *),
+				size_t (*bkt_wt)(const void *));
+static void *dstep_thread(void *arg);
+static void send(dstep_t *d,
+		 size_t id,
+		 size_t u,
+		 int is_light,
+		 char *req);
+static void apply(dstep_t *d, size_t id, dstep_bkts_t *db, void *wt);
+static void push_bkt(dstep_t *d, dstep_bkts_t *db, size_t v, size_t b);
+static size_t flush_ovf(dstep_t *d, dstep_bkts_t *db);
+static size_t owner(const dstep_t *d, size_t v);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, with the maximal value of size_t in the prev array for unreached
+   vertices, with num_threads threads. The output is the same as the output
+   of dijkstra if each vertex has a single shortest path from start, and
+   otherwise prev may provide a different shortest path.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   num_threads : > 0 number of threads
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+   bkt_wt      : bucket function which returns floor(w / delta) as size_t,
+                 where w is the weight value pointed to by the argument; the
+                 function is non-decreasing in w and returns 0 for a zero
+                 weight
+*/
+void delta_stepping_pthread(const adj_lst_t *a,
+			    size_t start,
+			    void *dist,
+			    size_t *prev,
+			    size_t num_threads,
+			    void (*add_wt)(void *, const void *, const void *),
+			    int (*cmp_wt)(const void *, const void *),
+			    size_t (*bkt_wt)(const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  delta_stepping_view(&w, start, dist, prev, num_threads,
+		      add_wt, cmp_wt, bkt_wt);
+}
+
+/**
+   Runs delta_stepping_pthread on a compressed sparse row (CSR) adjacency
+   list. Please see the parameter specification in delta_stepping_pthread.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void delta_stepping_pthread_csr(const adj_csr_t *c,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				size_t num_threads,
+				void (*add_wt)(void *, const void *,
+					       const void *),
+				int (*cmp_wt)(const void *, const void *),
+				size_t (*bkt_wt)(const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  delta_stepping_view(&w, start, dist, prev, num_threads,
+		      add_wt, cmp_wt, bkt_wt);
+}
+
+/**
+   Runs delta-stepping on a view of an adjacency list. The caller thread
+   runs as the thread with id 0.
+*/
+static void delta_stepping_view(const adj_view_t *a,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				size_t num_threads,
+				void (*add_wt)(void *, const void *,
+					       const void *),
+				int (*cmp_wt)(const void *, const void *),
+				size_t (*bkt_wt)(const void *)){
+  size_t i;
+  size_t num_reqs = mul_sz_perror(num_threads, num_threads);
+  pthread_t *tids = NULL;
+  dstep_t d;
+  dstep_arg_t *args = NULL;
+  d.num_threads = num_threads;
+  d.num_bkts = 0; /* set by the threads */
+  d.req_size = add_sz_perror(2 * sizeof(size_t), a->wt_size);
+  d.start = start;
+  d.a = a;
+  d.dist = dist;
+  d.prev = prev;
+  d.pos = malloc_perror(a->num_vts, sizeof(size_t));
+  d.in_s = malloc_perror(a->num_vts, 1);
+  d.nonempty = malloc_perror(num_threads, sizeof(int));
+  d.maxs = malloc_perror(num_threads, sizeof(size_t));
+  d.mins = malloc_perror(num_threads, sizeof(size_t));
+  d.reqs = malloc_perror(num_reqs, sizeof(stack_t));
+  d.sets = malloc_perror(num_threads, sizeof(stack_t));
+  d.add_wt = add_wt;
+  d.cmp_wt = cmp_wt;
+  d.bkt_wt = bkt_wt;
+  memset(dist, 0, a->num_vts * a->wt_size);
+  memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */
+  memset(d.pos, 0xff, a->num_vts * sizeof(size_t)); /* C_NQUEUED */
+  memset(d.in_s, 0, a->num_vts);
+  for (i = 0; i < num_reqs; i++){
+    stack_init(&d.reqs[i], C_STACK_INIT_COUNT, d.req_size, NULL);
+  }
+  for (i = 0; i < num_threads; i++){
+    stack_init(&d.sets[i], C_STACK_INIT_COUNT, sizeof(size_t), NULL);
+  }
+  barrier_init_perror(&d.barrier, num_threads);
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  args = malloc_perror(num_threads, sizeof(dstep_arg_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].d = &d;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&tids[i], dstep_thread, &args[i]);
+  }
+  dstep_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  for (i = 0; i < num_reqs; i++){
+    stack_free(&d.reqs[i]);
+  }
+  for (i = 0; i < num_threads; i++){
+    stack_free(&d.sets[i]);
+  }
+  free(d.pos);
+  free(d.in_s);
+  free(d.nonempty);
+  free(d.maxs);
+  free(d.mins);
+  free(d.reqs);
+  free(d.sets);
+  free(tids);
+  free(args);
+  d.pos = NULL;
+  d.in_s = NULL;
+  d.nonempty = NULL;
+  d.maxs = NULL;
+  d.mins = NULL;
+  d.reqs = NULL;
+  d.sets = NULL;
+  tids = NULL;
+  args = NULL;
+}
+
+/**
+   Runs a thread of delta-stepping. A thread i) computes the maximal edge
+   bucket of its vertices, ii) allocates its buckets after a barrier, and
+   iii) processes the buckets in the order of their absolute indices,
+   which each thread computes from the per thread values written before a
+   barrier. A per thread value is written again only after another
+   barrier that follows all reads of the value. The overflow bucket is
+   flushed when the current bucket moves past its lower bound, and when
+   the cyclic buckets of the thread are empty.
+*/
+static void *dstep_thread(void *arg){
+  int any;
+  size_t id = ((dstep_arg_t *)arg)->id;
+  size_t i, j, k, u, cur, num_bkts, num_vt_wts;
+  size_t *bs = NULL;
+  const char *p = NULL, *p_end = NULL;
+  char *req = NULL;
+  void *wt = NULL;
+  dstep_t *d = ((dstep_arg_t *)arg)->d;
+  const adj_view_t *a = d->a;
+  stack_t *bkts = NULL, *s = NULL;
+  dstep_bkts_t db;
+  req = malloc_perror(1, d->req_size);
+  wt = malloc_perror(1, a->wt_size);
+  /* maximal edge bucket */
+  d->maxs[id] = 0;
+  for (u = id << C_LOG_BLK; u < a->num_vts;
+       u += d->num_threads << C_LOG_BLK){
+    for (j = u; j < a->num_vts && j < u + ((size_t)1 << C_LOG_BLK); j++){
+      p = a->vt_wts(a->adj, j, &num_vt_wts);
+      p_end = p + num_vt_wts * a->pair_size;
+      for (; p != p_end; p += a->pair_size){
+	k = d->bkt_wt(p + a->wt_offset);
+	if (k > d->maxs[id]) d->maxs[id] = k;
+      }
+    }
+  }
+  barrier_wait_perror(&d->barrier);
+  k = 0;
+  for (i = 0; i < d->num_threads; i++){
+    if (d->maxs[i] > k) k = d->maxs[i];
+  }
+  num_bkts = 2;
+  while (num_bkts < C_NUM_BKTS_MAX && num_bkts - 2 < k) num_bkts *= 2;
+  if (id == 0) d->num_bkts = num_bkts;
+  bkts = malloc_perror(num_bkts, sizeof(stack_t));
+  for (i = 0; i < num_bkts; i++){
+    stack_init(&bkts[i], C_STACK_INIT_COUNT, sizeof(size_t), NULL);
+  }
+  db.bkts = bkts;
+  db.ovf_min = C_NQUEUED;
+  stack_init(&db.ovf, C_STACK_INIT_COUNT, 2 * sizeof(size_t), NULL);
+  barrier_wait_perror(&d->barrier); /* num_bkts is set */
+  cur = d->bkt_wt(ptr(d->dist, d->start, a->wt_size));
+  db.cur = cur;
+  if (owner(d, d->start) == id){
+    d->prev[d->start] = d->start;
+    push_bkt(d, &db, d->start, cur);
+  }
+  s = &d->sets[id];
+  for (;;){
+    /* light edges of the current bucket */
+    for (;;){
+      k = cur & (num_bkts - 1);
+      bs = bkts[k].elts;
+      for (i = 0; i < bkts[k].num_elts; i++){
+	u = bs[i];
+	if (d->pos[u] != cur) continue; /* entry of a moved vertex */
+	d->pos[u] = C_NQUEUED;
+	if (!d->in_s[u]){
+	  d->in_s[u] = 1;
+	  stack_push(s, &u);
+	}
+	send(d, id, u, 1, req);
+      }
+      bkts[k].num_elts = 0;
+      barrier_wait_perror(&d->barrier);
+      apply(d, id, &db, wt);
+      d->nonempty[id] = (bkts[k].num_elts > 0);
+      barrier_wait_perror(&d->barrier);
+      any = 0;
+      for (i = 0; i < d->num_threads; i++){
+	any = any || d->nonempty[i];
+      }
+      if (!any) break;
+    }
+    /* heavy edges of the removed vertices */
+    bs = s->elts;
+    for (i = 0; i < s->num_elts; i++){
+      d->in_s[bs[i]] = 0;
+      send(d, id, bs[i], 0, req);
+    }
+    s->num_elts = 0;
+    barrier_wait_perror(&d->barrier);
+    apply(d, id, &db, wt);
+    d->mins[id] = C_NQUEUED;
+    for (i = 1; i < num_bkts; i++){
+      if (bkts[(cur + i) & (num_bkts - 1)].num_elts > 0){
+	d->mins[id] = cur + i;
+	break;
+      }
+    }
+    if (d->mins[id] == C_NQUEUED && db.ovf.num_elts > 0){
+      d->mins[id] = flush_ovf(d, &db);
+    }
+    barrier_wait_perror(&d->barrier);
+    cur = C_NQUEUED;
+    for (i = 0; i < d->num_threads; i++){
+      if (d->mins[i] < cur) cur = d->mins[i];
+    }
+    if (cur == C_NQUEUED) break;
+    db.cur = cur;
+    if (db.ovf_min != C_NQUEUED &&
+	(db.ovf_min < cur || db.ovf_min - cur < num_bkts)){
+      flush_ovf(d, &db);
+    }
+  }
+  for (i = 0; i < num_bkts; i++){
+    stack_free(&bkts[i]);
+  }
+  stack_free(&db.ovf);
+  free(bkts);
+  free(req);
+  free(wt);
+  bkts = NULL;
+  req = NULL;
+  wt = NULL;
+  return NULL;
+}
+
+/**
+   Sends the requests of the light or heavy edges of a vertex u owned by
+   a thread to the owners of the adjacent vertices. The req parameter
+   points to a block of size req_size.
+*/
+static void send(dstep_t *d,
+		 size_t id,
+		 size_t u,
+		 int is_light,
+		 char *req){
+  size_t v, num_vt_wts;
+  const adj_view_t *a = d->a;
+  const char *p = NULL, *p_end = NULL;
+  const void *u_wt = ptr(d->dist, u, a->wt_size);
+  p = a->vt_wts(a->adj, u, &num_vt_wts);
+  p_end = p + num_vt_wts * a->pair_size;
+  memcpy(req + sizeof(size_t), &u, sizeof(size_t));
+  for (; p != p_end; p += a->pair_size){
+    if ((d->bkt_wt(p + a->wt_offset) == 0) != is_light) continue;
+    v = a->read_vt(p);
+    memcpy(req, &v, sizeof(size_t));
+    d->add_wt(req + 2 * sizeof(size_t), u_wt, p + a->wt_offset);
+    stack_push(&d->reqs[id * d->num_threads + owner(d, v)], req);
+  }
+}
+
+/**
+   Applies the requests sent to a thread with buckets db. The wt
+   parameter points to a block of size wt_size for copying a requested
+   distance.
+*/
+static void apply(dstep_t *d, size_t id, dstep_bkts_t *db, void *wt){
+  size_t i, j, u, v;
+  size_t wt_size = d->a->wt_size;
+  void *v_wt = NULL;
+  const char *p = NULL;
+  stack_t *r = NULL;
+  for (i = 0; i < d->num_threads; i++){
+    r = &d->reqs[i * d->num_threads + id];
+    p = r->elts;
+    for (j = 0; j < r->num_elts; j++){
+      memcpy(&v, p, sizeof(size_t));
+      memcpy(&u, p + sizeof(size_t), sizeof(size_t));
+      memcpy(wt, p + 2 * sizeof(size_t), wt_size);
+      v_wt = ptr(d->dist, v, wt_size);
+      if (d->prev[v] == C_NREACHED || d->cmp_wt(v_wt, wt) > 0){
+	memcpy(v_wt, wt, wt_size);
+	d->prev[v] = u;
+	push_bkt(d, db, v, d->bkt_wt(wt));
+      }
+      p += d->req_size;
+    }
+    r->num_elts = 0;
+  }
+}
+
+/**
+   Pushes a vertex into the bucket b >= cur of the buckets of its owner,
+   unless the vertex is in the bucket. The vertex is pushed into the
+   overflow bucket with b if b is beyond the cyclic buckets.
+*/
+static void push_bkt(dstep_t *d, dstep_bkts_t *db, size_t v, size_t b){
+  size_t vb[2];
+  if (d->pos[v] == b) return;
+  d->pos[v] = b;
+  if (b - db->cur < d->num_bkts){
+    stack_push(&db->bkts[b & (d->num_bkts - 1)], &v);
+  }else{
+    vb[0] = v;
+    vb[1] = b;
+    stack_push(&db->ovf, vb);
+    if (b < db->ovf_min) db->ovf_min = b;
+  }
+}
+
+/**
+   Moves the vertices of the overflow bucket with a bucket within the
+   cyclic buckets from cur to the cyclic buckets, removes the entries of
+   moved vertices, and returns the minimal bucket in the overflow bucket,
+   or C_NQUEUED if the overflow bucket is empty. The returned value is
+   also the new lower bound of the overflow bucket.
+*/
+static size_t flush_ovf(dstep_t *d, dstep_bkts_t *db){
+  size_t i, n = 0;
+  size_t *vbs = db->ovf.elts;
+  db->ovf_min = C_NQUEUED;
+  for (i = 0; i < db->ovf.num_elts; i++){
+    if (d->pos[vbs[2 * i]] != vbs[2 * i + 1]) continue; /* moved vertex */
+    if (vbs[2 * i + 1] - db->cur < d->num_bkts){
+      stack_push(&db->bkts[vbs[2 * i + 1] & (d->num_bkts - 1)],
+		 &vbs[2 * i]);
+    }else{
+      vbs[2 * n] = vbs[2 * i];
+      vbs[2 * n + 1] = vbs[2 * i + 1];
+      if (vbs[2 * n + 1] < db->ovf_min) db->ovf_min = vbs[2 * n + 1];
+      n++;
+    }
+  }
+  db->ovf.num_elts = n;
+  return db->ovf_min;
+}
+
+/**
+   Returns the thread that owns a vertex.
+*/
+static size_t owner(const dstep_t *d, size_t v){
+  return (v >> C_LOG_BLK) % d->num_threads;
+}
+
+/**
+   Computes a pointer to an entry in an array of entries of size size.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
@@ -0,0 +1,104 @@
+/**
+   delta-stepping-pthread.h
+
+   Declarations of accessible functions for running the delta-stepping
+   algorithm for single-source shortest paths on graphs with generic
+   non-negative weights with num_threads threads.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block, with the weight functions of dijkstra and a bucket
+   function that returns floor(w / delta) for a weight w and a width
+   delta chosen by the user. An edge is light if its weight is in bucket 0
+   and heavy otherwise.
+
+   Each vertex is owned by a thread according to the block of 2**6
+   consecutive vertices that contains the vertex. A thread keeps the
+   buckets of its vertices and is the only thread that reads and writes
+   the distances, previous vertices, and bucket positions of its vertices,
+   so that each of these values has a single writer. A relaxation of an
+   edge (u, v) is sent by the owner of u as a request to the owner of v
+   through a request buffer for each pair of threads. The threads process
+   the current bucket in rounds separated by barriers: i) each thread
+   removes the vertices of its part of the bucket and sends light edge
+   requests, ii) each thread applies the requests to its vertices, and
+   iii) the threads test if the bucket is empty. When the bucket is empty,
+   the heavy edges of the removed vertices are relaxed and the threads
+   move to the next non-empty bucket.
+
+   The buckets of a thread are a window of cyclic buckets and an overflow
+   bucket. The count of cyclic buckets is the lowest power of two that is
+   not less than two plus the maximal bucket of an edge weight in the
+   graph, and is at most 2**10. A vertex with a bucket beyond the window
+   is pushed into the overflow bucket, and is moved to the window when the
+   window reaches its bucket. A delta that is small relative to the
+   maximal edge weight results in scans of the overflow bucket, and a
+   delta that is large relative to the edge weights results in more
+   relaxations of light edges. A delta approximately equal to the maximal
+   edge weight divided by the average degree is a common starting point.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef DELTA_STEPPING_PTHREAD_H  
+#define DELTA_STEPPING_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, with the maximal value of size_t in the prev array for unreached
+   vertices, with num_threads threads. The output is the same as the output
+   of dijkstra if each vertex has a single shortest path from start, and
+   otherwise prev may provide a different shortest path.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   num_threads : > 0 number of threads
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value 
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+   bkt_wt      : bucket function which returns floor(w / delta) as size_t,
+                 where w is the weight value pointed to by the argument; the
+                 function is non-decreasing in w and returns 0 for a zero
+                 weight
+*/
+void delta_stepping_pthread(const adj_lst_t *a,
+			    size_t start,
+			    void *dist,
+			    size_t *prev,
+			    size_t num_threads,
+			    void (*add_wt)(void *, const void *, const void *),
+			    int (*cmp_wt)(const void *, const void *),
+			    size_t (*bkt_wt)(const void *));
+
+/**
+   Runs delta_stepping_pthread on a compressed sparse row (CSR) adjacency
+   list. Please see the parameter specification in delta_stepping_pthread.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void delta_stepping_pthread_csr(const adj_csr_t *c,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				size_t num_threads,
+				void (*add_wt)(void *, const void *,
+					       const void *),
+				int (*cmp_wt)(const void *, const void *),
+				size_t (*bkt_wt)(const void *));
+
+#endif
@@ -0,0 +1,469 @@
+/**
+   kruskal-pthread-test.c
+
+   Tests of the parallel filter-Kruskal msf algorithm on random undirected
+   graphs with size_t and double weights, by comparing the msf to the
+   trees computed by prim from the lowest vertex of each component.
+
+   The following command line arguments can be used to customize tests:
+   kruskal-pthread-test
+      [0, bit width of size_t / 2] : n for 2**n vertices in smallest graph
+      [0, bit width of size_t / 2] : n for 2**n vertices in largest graph
+      [0, 8] : k for 2**k threads in the largest thread test
+      [0, 1] : size_t weight test on/off
+      [0, 1] : double weight test on/off
+
+   usage examples:
+   ./kruskal-pthread-test
+   ./kruskal-pthread-test 10 12
+   ./kruskal-pthread-test 12 12 3 1 0
+
+   kruskal-pthread-test can be run with any subset of command line
+   arguments in the above-defined order. If the (i + 1)th argument is
+   specified then the ith argument must be specified for i >= 0. Default
+   values are used for the unspecified arguments according to the
+   C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the requirements that the number of value bits
+   (width) of size_t is even and the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "kruskal-pthread.h"
+#include "prim.h"
+#include "graph.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "kruskal-pthread-test\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in smallest graph\n"
+  "[0, bit width of size_t / 2] : n for 2**n vertices in largest graph\n"
+  "[0, 8] : k for 2**k threads in the largest thread test\n"
+  "[0, 1] : size_t weight test on/off\n"
+  "[0, 1] : double weight test on/off\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 11, 2, 1, 1};
+const size_t C_THREADS_LOG_MAX = 8;
+
+/* base counts of filter-Kruskal and mergesort_pthread */
+const size_t C_BASE_COUNT = 1024;
+const size_t C_SBASE_COUNT = 16384;
+const size_t C_MBASE_COUNT = 16384;
+
+/* random graph tests */
+const int C_ITER = 3;
+const int C_PROBS_COUNT = 7;
+const double C_PROBS[7] = {1.000000, 0.250000, 0.062500,
+			   0.015625, 0.003906, 0.000977,
+			   0.000000};
+const double C_REL_ERROR = 1e-9;
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_PRIM_NR = (size_t)-1; /* unreached vertex in prim */
+const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
+			      ((CHAR_BIT * sizeof(size_t) + 1) / 2));
+
+typedef struct{
+  double p;
+} bern_arg_t;
+
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
+double timer();
+void print_test_result(int res);
+
+/**
+   Comparison functions and conversion of weights for summation.
+*/
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+int cmp_double(const void *a, const void *b){
+  if (*(double *)a > *(double *)b){
+    return 1;
+  }else if (*(double *)a < *(double *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+double uint_to_double(const void *a){
+  return (double)*(size_t *)a;
+}
+
+double double_to_double(const void *a){
+  return *(double *)a;
+}
+
+/**
+    Construct adjacency lists of random undirected graphs with random
+    weights.
+*/
+
+int bern(void *arg){
+  bern_arg_t *b = arg;
+  if (b->p >= 1.0) return 1;
+  if (b->p <= 0.0) return 0;
+  if (b->p > DRAND()) return 1;
+  return 0;
+}
+
+void add_undir_uint_edge(adj_lst_t *a,
+			 size_t u,
+			 size_t v,
+			 size_t wt_l,
+			 size_t wt_h,
+			 int (*bern)(void *),
+			 void *arg){
+  size_t rand_val = wt_l + DRAND() * (wt_h - wt_l);
+  adj_lst_add_undir_edge(a, u, v, &rand_val, bern, arg);
+}
+
+void add_undir_double_edge(adj_lst_t *a,
+			   size_t u,
+			   size_t v,
+			   size_t wt_l,
+			   size_t wt_h,
+			   int (*bern)(void *),
+			   void *arg){
+  double rand_val = wt_l + DRAND() * (wt_h - wt_l);
+  adj_lst_add_undir_edge(a, u, v, &rand_val, bern, arg);
+}
+
+void adj_lst_rand_undir_wts(adj_lst_t *a,
+			    size_t n,
+			    size_t wt_size,
+			    size_t wt_l,
+			    size_t wt_h,
+			    int (*bern)(void *),
+			    void *arg,
+			    void (*add_undir_edge)(adj_lst_t *,
+						   size_t,
+						   size_t,
+						   size_t,
+						   size_t,
+						   int (*)(void *),
+						   void *)){
+  size_t i, j;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n - 1; i++){
+    for (j = i + 1; j < n; j++){
+      add_undir_edge(a, i, j, wt_l, wt_h, bern, arg);
+    }
+  }
+  graph_free(&g);
+}
+
+/**
+   Runs prim from the lowest unreached vertex until all vertices are
+   reached, sets the lowest vertex of the component of each vertex, and
+   returns the number of components. The msf weight is summed in *wt_msf.
+*/
+size_t prim_msf(const adj_lst_t *a,
+		size_t *comp,
+		double *wt_msf,
+		void *dist,
+		size_t *prev,
+		int (*cmp_wt)(const void *, const void *),
+		double (*to_double)(const void *)){
+  size_t i, j;
+  size_t ret = 0;
+  *wt_msf = 0.0;
+  for (i = 0; i < a->num_vts; i++){
+    comp[i] = C_PRIM_NR;
+  }
+  for (i = 0; i < a->num_vts; i++){
+    if (comp[i] != C_PRIM_NR) continue;
+    ret++;
+    prim(a, i, dist, prev, NULL, cmp_wt);
+    for (j = i; j < a->num_vts; j++){
+      if (prev[j] == C_PRIM_NR) continue;
+      comp[j] = i;
+      *wt_msf += to_double((char *)dist + j * a->wt_size);
+    }
+  }
+  return ret;
+}
+
+/**
+   Returns 1 if dist and prev describe a forest of edges of a graph, where
+   the root of each tree is the lowest vertex of its component, and the
+   weight sum is equal to the msf weight up to a relative error. Otherwise
+   returns 0.
+*/
+int check_msf(const adj_lst_t *a,
+	      const size_t *comp,
+	      double wt_msf,
+	      const void *dist,
+	      const size_t *prev,
+	      int (*cmp_wt)(const void *, const void *),
+	      double (*to_double)(const void *)){
+  int is_edge;
+  size_t i, j, u, steps, num_vt_wts;
+  double wt = 0.0, err;
+  const char *p = NULL;
+  const void *wt_u = NULL;
+  for (i = 0; i < a->num_vts; i++){
+    wt_u = (const char *)dist + i * a->wt_size;
+    if (prev[i] == i){
+      if (comp[i] != i) return 0;
+      continue;
+    }
+    if (prev[i] >= a->num_vts) return 0;
+    is_edge = 0;
+    p = adj_lst_vt_wts(a, prev[i], &num_vt_wts);
+    for (j = 0; j < num_vt_wts && !is_edge; j++){
+      is_edge = (a->read_vt(p) == i &&
+		 cmp_wt(p + a->wt_offset, wt_u) == 0);
+      p += a->pair_size;
+    }
+    if (!is_edge) return 0;
+    u = i;
+    steps = 0;
+    while (prev[u] != u && steps < a->num_vts){
+      u = prev[u];
+      steps++;
+    }
+    if (u != comp[i]) return 0;
+    wt += to_double(wt_u);
+  }
+  err = wt - wt_msf;
+  if (err < 0.0) err = -err;
+  if (wt_msf < 0.0) wt_msf = -wt_msf;
+  return err <= C_REL_ERROR * (wt_msf > 1.0 ? wt_msf : 1.0);
+}
+
+/**
+   Runs a test on random undirected graphs with random weights.
+*/
+void run_rand_test(int pow_start,
+		   int pow_end,
+		   size_t log_threads,
+		   size_t wt_size,
+		   void (*add_undir_edge)(adj_lst_t *,
+					  size_t,
+					  size_t,
+					  size_t,
+					  size_t,
+					  int (*)(void *),
+					  void *),
+		   int (*cmp_wt)(const void *, const void *),
+		   double (*to_double)(const void *),
+		   const char *type_string){
+  int p, i, j;
+  int res = 1;
+  size_t k, n, num_comps, num_threads;
+  size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
+  size_t *comp = NULL, *prev = NULL;
+  void *dist = NULL;
+  double wt_msf;
+  double t_prim, t_kr, t_fkr, t_fkr_csr;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  bern_arg_t b;
+  comp = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist = malloc_perror(pow_two(pow_end), wt_size);
+  printf("Run a kruskal_pthread test on random undirected graphs with "
+	 "random %s weights in [%lu, %lu]\n",
+	 type_string, TOLU(wt_l), TOLU(wt_h));
+  fflush(stdout);
+  for (p = 0; p < C_PROBS_COUNT; p++){
+    b.p = C_PROBS[p];
+    printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      adj_lst_rand_undir_wts(&a,
+			     n,
+			     wt_size,
+			     wt_l,
+			     wt_h,
+			     bern,
+			     &b,
+			     add_undir_edge);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
+      t_prim = timer();
+      num_comps = prim_msf(&a, comp, &wt_msf, dist, prev,
+			   cmp_wt, to_double);
+      t_prim = timer() - t_prim;
+      t_kr = timer();
+      for (j = 0; j < C_ITER; j++){
+	kruskal_pthread(&a, dist, prev, 1, a.num_es, C_SBASE_COUNT,
+			C_MBASE_COUNT, cmp_wt);
+      }
+      t_kr = timer() - t_kr;
+      res *= check_msf(&a, comp, wt_msf, dist, prev, cmp_wt, to_double);
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      printf("\t\t\tprim from each component:                 %.6f seconds\n"
+	     "\t\t\tkruskal_pthread, single sort:             %.6f seconds\n",
+	     t_prim,
+	     t_kr / C_ITER);
+      for (k = 0; k <= log_threads; k++){
+	num_threads = pow_two(k);
+	t_fkr = timer();
+	for (j = 0; j < C_ITER; j++){
+	  kruskal_pthread(&a, dist, prev, num_threads, C_BASE_COUNT,
+			  C_SBASE_COUNT, C_MBASE_COUNT, cmp_wt);
+	}
+	t_fkr = timer() - t_fkr;
+	res *= check_msf(&a, comp, wt_msf, dist, prev, cmp_wt, to_double);
+	t_fkr_csr = timer();
+	for (j = 0; j < C_ITER; j++){
+	  kruskal_pthread_csr(&c, dist, prev, num_threads, C_BASE_COUNT,
+			      C_SBASE_COUNT, C_MBASE_COUNT, cmp_wt);
+	}
+	t_fkr_csr = timer() - t_fkr_csr;
+	res *= check_msf(&a, comp, wt_msf, dist, prev, cmp_wt, to_double);
+	printf("\t\t\tkruskal_pthread, filter, %3lu threads:     %.6f seconds\n"
+	       "\t\t\tkruskal_pthread_csr, filter, %3lu threads: %.6f "
+	       "seconds\n",
+	       TOLU(num_threads), t_fkr / C_ITER,
+	       TOLU(num_threads), t_fkr_csr / C_ITER);
+      }
+      printf("\t\t\tcomponents:                               %lu\n",
+	     TOLU(num_comps));
+      printf("\t\t\tcorrectness:                              ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+    }
+  }
+  free(comp);
+  free(prev);
+  free(dist);
+  comp = NULL;
+  prev = NULL;
+  dist = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]){
+    run_rand_test(args[0], args[1], args[2], sizeof(size_t),
+		  add_undir_uint_edge, cmp_uint, uint_to_double, "size_t");
+  }
+  if (args[4]){
+    run_rand_test(args[0], args[1], args[2], sizeof(double),
+		  add_undir_double_edge, cmp_double, double_to_double,
+		  "double");
+  }
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,641 @@
+/**
+   kruskal-pthread.c
+
+   Functions for running an msf algorithm on
+   undirected graphs with generic weights, with a parallel sort of edges.
+
+   A minimum spanning forest (msf) is computed, i.e. an mst of each
+   connected component. The tree of a component is rooted at the lowest
+   vertex of the component, and the result is provided in the format of
+   prim, where the root of a tree is its own previous vertex.
+
+   Vertices are indexed from 0. Edge weights may include negative weights,
+   and are of any basic type (e.g. char, int, long, float, double), or are
+   custom weights within a contiguous block.
+
+   The algorithm is filter-Kruskal. A range of edges with more than
+   base_count edges is partitioned around a pivot weight into the edges
+   with lower, equal, and higher weights, and the ranges are processed in
+   this order. Before a range is processed, the edges with both endpoints
+   in the same tree of a union-find forest are filtered out, so that on
+   dense graphs most of the heavy edges are discarded without sorting. A
+   range with at most base_count edges is sorted with mergesort_pthread
+   and scanned as in Kruskal's algorithm. If base_count is not less than
+   the number of edges, the algorithm is Kruskal's algorithm with a single
+   parallel sort.
+
+   The filter and partition passes over a range with at least
+   num_threads * 2**12 edges are run by num_threads threads. Each thread
+   classifies the edges of a block of the range and counts the edges of
+   each class, the counts are combined by a prefix sum, and each thread
+   scatters its edges to a buffer at the offsets of its block and copies a
+   block of the buffer back to the range. The union-find forest is only
+   read during a parallel filter pass.
+
+   An edge is stored in a record that begins with its weight, so that the
+   cmp_wt function of prim is used without a wrapper by mergesort_pthread.
+   The partition is emulated on a dynamically allocated stack to avoid an
+   overflow of the memory stack.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "kruskal-pthread.h"
+#include "graph.h"
+#include "stack.h"
+#include "mergesort-pthread.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef struct{
+  size_t beg;
+  size_t end;
+  int is_eq; /* non-zero if the weights in the range are equal */
+} range_t;
+
+typedef struct{
+  size_t wt_size;
+  size_t rec_size;  /* weight block rounded up to size_t + two vertices */
+  size_t vt_offset; /* offset of the size_t vertices in a record */
+  size_t num_tes;   /* count of msf edges */
+  size_t *uf;       /* union-find parents */
+  char *tes;        /* records of msf edges */
+  void *tmp;        /* records for swaps and the pivot */
+  void *pivot;
+  int (*cmp_wt)(const void *, const void *);
+  /* parallel split */
+  size_t num_threads;
+  size_t beg;       /* range of a split */
+  size_t end;
+  int is_part;      /* non-zero if a split is a partition */
+  char *recs;
+  char *aux;        /* records of a range after a split */
+  char *cls;        /* class of a record in a split */
+  size_t *cnts;     /* [id * C_NUM_CLS + class] */
+  pthread_t *tids;
+  barrier_t barrier;
+} kruskal_t;
+
+typedef struct{
+  size_t id;
+  kruskal_t *k;
+} kruskal_arg_t;
+
+static const size_t C_STACK_INIT_COUNT = 1;
+static const size_t C_SPLIT_BLOCK_MIN = 4096; /* records per thread */
+static const size_t C_NUM_CLS = 3; /* lower, equal, higher, or kept */
+static const char C_CLS_DROP = 3; /* filtered out */
+
+static void kruskal_view(const adj_view_t *a,
+			 void *dist,
+			 size_t *prev,
+			 size_t num_threads,
+			 size_t base_count,
+			 size_t sbase_count,
+			 size_t mbase_count,
+			 int (*cmp_wt)(const void *, const void *));
+static size_t filter(kruskal_t *k, char *recs, size_t num);
+static size_t split(kruskal_t *k,
+		    char *recs,
+		    const range_t *r,
+		    int is_part,
+		    size_t *lt,
+		    size_t *gt);
+static void *split_thread(void *arg);
+static void block(size_t num, size_t num_blks, size_t i,
+		  size_t *beg, size_t *end);
+static void scan(kruskal_t *k, const char *recs, size_t num);
+static void partition(kruskal_t *k,
+		      char *recs,
+		      const range_t *r,
+		      size_t *lt,
+		      size_t *gt);
+static void set_pivot(kruskal_t *k, const char *recs, const range_t *r);
+static void root(const kruskal_t *k, void *dist, size_t *prev,
+		 size_t num_vts);
+static size_t find(size_t *uf, size_t u);
+static size_t find_const(const size_t *uf, size_t u);
+static void swap(kruskal_t *k, char *recs, size_t i, size_t j);
+static size_t *rec_vts(const kruskal_t *k, const void *rec);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Computes and copies the edge weights of an msf of an undirected graph to
+   the array pointed to by dist, and the previous vertices to the array
+   pointed to by prev. The root of a tree is the lowest vertex of its
+   component, with a zero weight block in dist and the vertex in prev.
+   a           : pointer to an adjacency list of an undirected graph with
+                 at least one vertex
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   num_threads : > 0 number of threads for the filter and partition passes
+   base_count  : > 0 upper bound for the count of edges in a range that is
+                 sorted instead of partitioned
+   sbase_count : > 0 base case upper bound for parallel sorting in
+                 mergesort_pthread
+   mbase_count : > 1 base case upper bound for parallel merging in
+                 mergesort_pthread
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value 
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void kruskal_pthread(const adj_lst_t *a,
+		     void *dist,
+		     size_t *prev,
+		     size_t num_threads,
+		     size_t base_count,
+		     size_t sbase_count,
+		     size_t mbase_count,
+		     int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  kruskal_view(&w, dist, prev, num_threads, base_count, sbase_count,
+	       mbase_count, cmp_wt);
+}
+
+/**
+   Runs kruskal_pthread on a compressed sparse row (CSR) adjacency list.
+   Please see the parameter specification in kruskal_pthread.
+*/
+void kruskal_pthread_csr(const adj_csr_t *c,
+			 void *dist,
+			 size_t *prev,
+			 size_t num_threads,
+			 size_t base_count,
+			 size_t sbase_count,
+			 size_t mbase_count,
+			 int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  kruskal_view(&w, dist, prev, num_threads, base_count, sbase_count,
+	       mbase_count, cmp_wt);
+}
+
+/**
+   Runs filter-Kruskal on a view of an adjacency list. An undirected edge
+   is included once, from the lower to the higher vertex, and self-loops
+   are excluded.
+*/
+static void kruskal_view(const adj_view_t *a,
+			 void *dist,
+			 size_t *prev,
+			 size_t num_threads,
+			 size_t base_count,
+			 size_t sbase_count,
+			 size_t mbase_count,
+			 int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_end = NULL;
+  size_t u, v, lt, gt, num_vt_wts, split_min;
+  size_t num_es = 0;
+  size_t *vts = NULL;
+  char *recs = NULL, *rec = NULL;
+  range_t r, s;
+  stack_t ranges;
+  kruskal_t k;
+  k.wt_size = a->wt_size;
+  k.vt_offset = mul_sz_perror(a->wt_size / sizeof(size_t) +
+			      (a->wt_size % sizeof(size_t) > 0),
+			      sizeof(size_t));
+  k.rec_size = add_sz_perror(k.vt_offset, 2 * sizeof(size_t));
+  k.num_tes = 0;
+  k.cmp_wt = cmp_wt;
+  k.num_threads = num_threads;
+  k.aux = NULL;
+  k.cls = NULL;
+  k.cnts = NULL;
+  k.tids = NULL;
+  for (u = 0; u < a->num_vts; u++){
+    p = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p + num_vt_wts * a->pair_size;
+    for (; p != p_end; p += a->pair_size){
+      if (u < a->read_vt(p)) num_es++;
+    }
+  }
+  recs = malloc_perror(num_es + 1, k.rec_size);
+  rec = recs;
+  for (u = 0; u < a->num_vts; u++){
+    p = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p + num_vt_wts * a->pair_size;
+    for (; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      if (u < v){
+	memcpy(rec, p + a->wt_offset, k.wt_size);
+	vts = rec_vts(&k, rec);
+	vts[0] = u;
+	vts[1] = v;
+	rec += k.rec_size;
+      }
+    }
+  }
+  k.uf = malloc_perror(a->num_vts, sizeof(size_t));
+  for (u = 0; u < a->num_vts; u++){
+    k.uf[u] = u;
+  }
+  k.tes = malloc_perror(a->num_vts, k.rec_size);
+  k.tmp = malloc_perror(2, k.rec_size);
+  k.pivot = ptr(k.tmp, 1, k.rec_size);
+  split_min = (num_threads > 1) ?
+    mul_sz_perror(num_threads, C_SPLIT_BLOCK_MIN) : num_es + 1;
+  if (num_es >= split_min){
+    k.aux = malloc_perror(num_es, k.rec_size);
+    k.cls = malloc_perror(num_es, 1);
+    k.cnts = malloc_perror(mul_sz_perror(num_threads, C_NUM_CLS),
+			   sizeof(size_t));
+    k.tids = malloc_perror(num_threads, sizeof(pthread_t));
+    barrier_init_perror(&k.barrier, num_threads);
+  }
+  stack_init(&ranges, C_STACK_INIT_COUNT, sizeof(range_t), NULL);
+  r.beg = 0;
+  r.end = num_es;
+  r.is_eq = 0;
+  if (num_es > 0) stack_push(&ranges, &r);
+  while (ranges.num_elts > 0 && k.num_tes < a->num_vts - 1){
+    stack_pop(&ranges, &r);
+    if (k.num_tes > 0 && r.end - r.beg >= split_min){
+      r.end = r.beg + split(&k, recs, &r, 0, &lt, &gt);
+    }else if (k.num_tes > 0){
+      r.end = r.beg + filter(&k, ptr(recs, r.beg, k.rec_size),
+			     r.end - r.beg);
+    }
+    if (r.end == r.beg) continue;
+    if (r.is_eq){
+      scan(&k, ptr(recs, r.beg, k.rec_size), r.end - r.beg);
+    }else if (r.end - r.beg <= base_count){
+      mergesort_pthread(ptr(recs, r.beg, k.rec_size),
+			r.end - r.beg,
+			k.rec_size,
+			sbase_count,
+			mbase_count,
+			cmp_wt);
+      scan(&k, ptr(recs, r.beg, k.rec_size), r.end - r.beg);
+    }else{
+      /* push higher, equal, lower ranges to process lower ranges first */
+      if (r.end - r.beg >= split_min){
+	split(&k, recs, &r, 1, &lt, &gt);
+      }else{
+	partition(&k, recs, &r, &lt, &gt);
+      }
+      s.is_eq = 0;
+      s.beg = gt;
+      s.end = r.end;
+      if (s.end > s.beg) stack_push(&ranges, &s);
+      s.is_eq = 1;
+      s.beg = lt;
+      s.end = gt;
+      stack_push(&ranges, &s);
+      s.is_eq = 0;
+      s.beg = r.beg;
+      s.end = lt;
+      if (s.end > s.beg) stack_push(&ranges, &s);
+    }
+  }
+  root(&k, dist, prev, a->num_vts);
+  stack_free(&ranges);
+  free(recs);
+  free(k.uf);
+  free(k.tes);
+  free(k.tmp);
+  free(k.aux);
+  free(k.cls);
+  free(k.cnts);
+  free(k.tids);
+  recs = NULL;
+  k.uf = NULL;
+  k.tes = NULL;
+  k.tmp = NULL;
+  k.pivot = NULL;
+  k.aux = NULL;
+  k.cls = NULL;
+  k.cnts = NULL;
+  k.tids = NULL;
+}
+
+/**
+   Removes the records of the edges with both endpoints in the same tree
+   from num records in place, and returns the number of remaining records.
+*/
+static size_t filter(kruskal_t *k, char *recs, size_t num){
+  size_t i, ret = 0;
+  size_t *vts = NULL;
+  for (i = 0; i < num; i++){
+    vts = rec_vts(k, ptr(recs, i, k->rec_size));
+    if (find(k->uf, vts[0]) != find(k->uf, vts[1])){
+      if (ret != i){
+	memcpy(ptr(recs, ret, k->rec_size),
+	       ptr(recs, i, k->rec_size),
+	       k->rec_size);
+      }
+      ret++;
+    }
+  }
+  return ret;
+}
+
+/**
+   Runs a filter pass (is_part is zero) or a partition pass (is_part is
+   non-zero) over the records in a range with num_threads threads, and
+   returns the number of remaining records. A filter pass keeps the
+   records of the edges with endpoints in different trees in their order.
+   A partition pass sets lt and gt as in partition. The caller thread runs
+   as the thread with id 0.
+*/
+static size_t split(kruskal_t *k,
+		    char *recs,
+		    const range_t *r,
+		    int is_part,
+		    size_t *lt,
+		    size_t *gt){
+  size_t i, c;
+  size_t ret = 0;
+  kruskal_arg_t *args = NULL;
+  args = malloc_perror(k->num_threads, sizeof(kruskal_arg_t));
+  k->beg = r->beg;
+  k->end = r->end;
+  k->is_part = is_part;
+  k->recs = recs;
+  if (is_part) set_pivot(k, recs, r);
+  for (i = 0; i < k->num_threads; i++){
+    args[i].id = i;
+    args[i].k = k;
+  }
+  for (i = 1; i < k->num_threads; i++){
+    thread_create_perror(&k->tids[i], split_thread, &args[i]);
+  }
+  split_thread(&args[0]);
+  for (i = 1; i < k->num_threads; i++){
+    thread_join_perror(k->tids[i], NULL);
+  }
+  *lt = r->beg;
+  *gt = r->beg;
+  for (i = 0; i < k->num_threads; i++){
+    for (c = 0; c < C_NUM_CLS; c++){
+      ret += k->cnts[i * C_NUM_CLS + c];
+    }
+    *lt += k->cnts[i * C_NUM_CLS];
+    *gt += k->cnts[i * C_NUM_CLS] + k->cnts[i * C_NUM_CLS + 1];
+  }
+  free(args);
+  args = NULL;
+  return ret;
+}
+
+/**
+   Runs a thread of a split. A thread i) classifies and counts the records
+   of its block of the range, ii) computes its offset of each class from
+   the counts of all threads after a barrier, iii) scatters its records
+   to the buffer, and iv) copies its block of the buffer back to the range
+   after a barrier. In a filter pass, a kept record is in the class 0.
+*/
+static void *split_thread(void *arg){
+  size_t i, j, c, beg, end, num = 0;
+  size_t offs[3]; /* C_NUM_CLS */
+  size_t id = ((kruskal_arg_t *)arg)->id;
+  kruskal_t *k = ((kruskal_arg_t *)arg)->k;
+  size_t *cnts = &k->cnts[id * C_NUM_CLS];
+  const size_t *vts = NULL;
+  const char *rec = NULL;
+  int cmp;
+  block(k->end - k->beg, k->num_threads, id, &beg, &end);
+  for (c = 0; c < C_NUM_CLS; c++){
+    cnts[c] = 0;
+  }
+  for (i = k->beg + beg; i < k->beg + end; i++){
+    rec = ptr(k->recs, i, k->rec_size);
+    if (k->is_part){
+      cmp = k->cmp_wt(rec, k->pivot);
+      k->cls[i] = (cmp < 0) ? 0 : ((cmp > 0) ? 2 : 1);
+    }else{
+      vts = rec_vts(k, rec);
+      k->cls[i] = (find_const(k->uf, vts[0]) != find_const(k->uf, vts[1])) ?
+	0 : C_CLS_DROP;
+    }
+    if (k->cls[i] != C_CLS_DROP) cnts[(size_t)k->cls[i]]++;
+  }
+  barrier_wait_perror(&k->barrier);
+  for (c = 0; c < C_NUM_CLS; c++){
+    for (j = 0; j < k->num_threads; j++){
+      if (j == id) offs[c] = k->beg + num;
+      num += k->cnts[j * C_NUM_CLS + c];
+    }
+  }
+  for (i = k->beg + beg; i < k->beg + end; i++){
+    if (k->cls[i] == C_CLS_DROP) continue;
+    c = k->cls[i];
+    memcpy(ptr(k->aux, offs[c], k->rec_size),
+	   ptr(k->recs, i, k->rec_size),
+	   k->rec_size);
+    offs[c]++;
+  }
+  barrier_wait_perror(&k->barrier);
+  block(num, k->num_threads, id, &beg, &end);
+  memcpy(ptr(k->recs, k->beg + beg, k->rec_size),
+	 ptr(k->aux, k->beg + beg, k->rec_size),
+	 (end - beg) * k->rec_size);
+  return NULL;
+}
+
+/**
+   Computes the ith of num_blks blocks of consecutive indices in [0, num),
+   where the counts of blocks differ by at most one.
+*/
+static void block(size_t num, size_t num_blks, size_t i,
+		  size_t *beg, size_t *end){
+  size_t q = num / num_blks, rem = num % num_blks;
+  *beg = i * q + (i < rem ? i : rem);
+  *end = *beg + q + (i < rem);
+}
+
+/**
+   Scans num records in an order of non-decreasing weights, and adds an
+   edge to the msf if its endpoints are in different trees. The root with
+   the higher index is linked to the root with the lower index.
+*/
+static void scan(kruskal_t *k, const char *recs, size_t num){
+  size_t i, ru, rv;
+  const size_t *vts = NULL;
+  for (i = 0; i < num; i++){
+    vts = rec_vts(k, ptr(recs, i, k->rec_size));
+    ru = find(k->uf, vts[0]);
+    rv = find(k->uf, vts[1]);
+    if (ru == rv) continue;
+    if (ru < rv){
+      k->uf[rv] = ru;
+    }else{
+      k->uf[ru] = rv;
+    }
+    memcpy(ptr(k->tes, k->num_tes, k->rec_size),
+	   ptr(recs, i, k->rec_size),
+	   k->rec_size);
+    k->num_tes++;
+  }
+}
+
+/**
+   Partitions the records in a range into the records with lower, equal,
+   and higher weights than the pivot weight, in [r->beg, lt), [lt, gt),
+   and [gt, r->end) respectively.
+*/
+static void partition(kruskal_t *k,
+		      char *recs,
+		      const range_t *r,
+		      size_t *lt,
+		      size_t *gt){
+  int c;
+  size_t i = r->beg;
+  set_pivot(k, recs, r);
+  *lt = r->beg;
+  *gt = r->end;
+  while (i < *gt){
+    c = k->cmp_wt(ptr(recs, i, k->rec_size), k->pivot);
+    if (c < 0){
+      swap(k, recs, *lt, i);
+      (*lt)++;
+      i++;
+    }else if (c > 0){
+      (*gt)--;
+      swap(k, recs, i, *gt);
+    }else{
+      i++;
+    }
+  }
+}
+
+/**
+   Copies the record with the median weight of the first, middle, and last
+   records in a range to the pivot block.
+*/
+static void set_pivot(kruskal_t *k, const char *recs, const range_t *r){
+  const void *a = ptr(recs, r->beg, k->rec_size);
+  const void *b = ptr(recs, r->beg + (r->end - r->beg) / 2, k->rec_size);
+  const void *c = ptr(recs, r->end - 1, k->rec_size);
+  const void *m = NULL;
+  if (k->cmp_wt(a, b) < 0){
+    if (k->cmp_wt(b, c) < 0){
+      m = b;
+    }else{
+      m = (k->cmp_wt(a, c) < 0) ? c : a;
+    }
+  }else{
+    if (k->cmp_wt(a, c) < 0){
+      m = a;
+    }else{
+      m = (k->cmp_wt(b, c) < 0) ? c : b;
+    }
+  }
+  memcpy(k->pivot, m, k->rec_size);
+}
+
+/**
+   Sets dist and prev by traversing the trees of the msf from the lowest
+   vertex of each component.
+*/
+static void root(const kruskal_t *k, void *dist, size_t *prev,
+		 size_t num_vts){
+  size_t i, u, v, num_q;
+  size_t *offs = NULL, *nbrs = NULL, *q = NULL;
+  const size_t *vts = NULL;
+  const char *rec = NULL;
+  offs = calloc_perror(num_vts + 1, sizeof(size_t));
+  nbrs = malloc_perror(2 * k->num_tes + 1, 2 * sizeof(size_t));
+  q = malloc_perror(num_vts, sizeof(size_t));
+  for (i = 0; i < k->num_tes; i++){
+    vts = rec_vts(k, ptr(k->tes, i, k->rec_size));
+    offs[vts[0] + 1]++;
+    offs[vts[1] + 1]++;
+  }
+  for (u = 0; u < num_vts; u++){
+    offs[u + 1] += offs[u];
+  }
+  for (i = 0; i < k->num_tes; i++){
+    vts = rec_vts(k, ptr(k->tes, i, k->rec_size));
+    nbrs[2 * offs[vts[0]]] = vts[1];
+    nbrs[2 * offs[vts[0]] + 1] = i;
+    offs[vts[0]]++;
+    nbrs[2 * offs[vts[1]]] = vts[0];
+    nbrs[2 * offs[vts[1]] + 1] = i;
+    offs[vts[1]]++;
+  }
+  for (u = num_vts; u > 0; u--){
+    offs[u] = offs[u - 1];
+  }
+  offs[0] = 0;
+  for (u = 0; u < num_vts; u++){
+    prev[u] = num_vts;
+  }
+  for (u = 0; u < num_vts; u++){
+    if (prev[u] != num_vts) continue;
+    prev[u] = u;
+    memset(ptr(dist, u, k->wt_size), 0, k->wt_size);
+    q[0] = u;
+    num_q = 1;
+    while (num_q > 0){
+      v = q[--num_q];
+      for (i = offs[v]; i < offs[v + 1]; i++){
+	if (prev[nbrs[2 * i]] != num_vts) continue;
+	prev[nbrs[2 * i]] = v;
+	rec = ptr(k->tes, nbrs[2 * i + 1], k->rec_size);
+	memcpy(ptr(dist, nbrs[2 * i], k->wt_size), rec, k->wt_size);
+	q[num_q++] = nbrs[2 * i];
+      }
+    }
+  }
+  free(offs);
+  free(nbrs);
+  free(q);
+  offs = NULL;
+  nbrs = NULL;
+  q = NULL;
+}
+
+/**
+   Returns the root of a vertex in a union-find forest with path halving.
+*/
+static size_t find(size_t *uf, size_t u){
+  while (uf[u] != u){
+    uf[u] = uf[uf[u]];
+    u = uf[u];
+  }
+  return u;
+}
+
+/**
+   Returns the root of a vertex in a union-find forest without modifying
+   the forest, for reads of the forest by concurrent threads.
+*/
+static size_t find_const(const size_t *uf, size_t u){
+  while (uf[u] != u) u = uf[u];
+  return u;
+}
+
+static void swap(kruskal_t *k, char *recs, size_t i, size_t j){
+  if (i == j) return;
+  memcpy(k->tmp, ptr(recs, i, k->rec_size), k->rec_size);
+  memcpy(ptr(recs, i, k->rec_size), ptr(recs, j, k->rec_size), k->rec_size);
+  memcpy(ptr(recs, j, k->rec_size), k->tmp, k->rec_size);
+}
+
+/**
+   Returns a pointer to the two size_t vertices of a record.
+*/
+static size_t *rec_vts(const kruskal_t *k, const void *rec){
+  return (size_t *)((char *)rec + k->vt_offset);
+}
+
+/**
+   Computes a pointer to the ith element in the block of elements.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
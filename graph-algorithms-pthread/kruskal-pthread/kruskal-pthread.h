@@ -0,0 +1,98 @@
+/**
+   kruskal-pthread.h
+
+   Declarations of accessible functions for running an msf algorithm on
+   undirected graphs with generic weights, with a parallel sort of edges.
+
+   A minimum spanning forest (msf) is computed, i.e. an mst of each
+   connected component. The tree of a component is rooted at the lowest
+   vertex of the component, and the result is provided in the format of
+   prim, where the root of a tree is its own previous vertex.
+
+   Vertices are indexed from 0. Edge weights may include negative weights,
+   and are of any basic type (e.g. char, int, long, float, double), or are
+   custom weights within a contiguous block.
+
+   The algorithm is filter-Kruskal. A range of edges with more than
+   base_count edges is partitioned around a pivot weight into the edges
+   with lower, equal, and higher weights, and the ranges are processed in
+   this order. Before a range is processed, the edges with both endpoints
+   in the same tree of a union-find forest are filtered out, so that on
+   dense graphs most of the heavy edges are discarded without sorting. A
+   range with at most base_count edges is sorted with mergesort_pthread
+   and scanned as in Kruskal's algorithm. If base_count is not less than
+   the number of edges, the algorithm is Kruskal's algorithm with a single
+   parallel sort.
+
+   The filter and partition passes over a range with at least
+   num_threads * 2**12 edges are run by num_threads threads. Each thread
+   classifies the edges of a block of the range and counts the edges of
+   each class, the counts are combined by a prefix sum, and each thread
+   scatters its edges to a buffer at the offsets of its block and copies a
+   block of the buffer back to the range.
+
+   An edge is stored in a record that begins with its weight, so that the
+   cmp_wt function of prim is used without a wrapper by mergesort_pthread.
+   The partition is emulated on a dynamically allocated stack to avoid an
+   overflow of the memory stack.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef KRUSKAL_PTHREAD_H
+#define KRUSKAL_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Computes and copies the edge weights of an msf of an undirected graph to
+   the array pointed to by dist, and the previous vertices to the array
+   pointed to by prev. The root of a tree is the lowest vertex of its
+   component, with a zero weight block in dist and the vertex in prev.
+   a           : pointer to an adjacency list of an undirected graph with
+                 at least one vertex
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   num_threads : > 0 number of threads for the filter and partition passes
+   base_count  : > 0 upper bound for the count of edges in a range that is
+                 sorted instead of partitioned
+   sbase_count : > 0 base case upper bound for parallel sorting in
+                 mergesort_pthread
+   mbase_count : > 1 base case upper bound for parallel merging in
+                 mergesort_pthread
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value 
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void kruskal_pthread(const adj_lst_t *a,
+		     void *dist,
+		     size_t *prev,
+		     size_t num_threads,
+		     size_t base_count,
+		     size_t sbase_count,
+		     size_t mbase_count,
+		     int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs kruskal_pthread on a compressed sparse row (CSR) adjacency list.
+   Please see the parameter specification in kruskal_pthread.
+*/
+void kruskal_pthread_csr(const adj_csr_t *c,
+			 void *dist,
+			 size_t *prev,
+			 size_t num_threads,
+			 size_t base_count,
+			 size_t sbase_count,
+			 size_t mbase_count,
+			 int (*cmp_wt)(const void *, const void *));
+
+#endif
@@ -0,0 +1,521 @@
+/**
+   tsp-heur-pthread-test.c
+
+   Tests of a heuristic solution of TSP with parallel randomized restarts
+   i) on random complete graphs with random size_t weights by comparison
+   with the exact solution of tsp, ii) on random k-nearest neighbor
+   graphs of points in a unit square with Euclidean double weights, and
+   iii) on sparse graphs with and without a tour.
+
+   The following command line arguments can be used to customize tests:
+   tsp-heur-pthread-test:
+   -  [1, 16] : a
+   -  [1, 16] : b s.t. a <= |V| <= b for the comparison test with tsp
+   -  [0, # bits in size_t / 2] : c
+   -  [0, # bits in size_t / 2] : d s.t. 2^c <= |V| <= 2^d for the
+      nearest neighbor graph test
+   -  [0, 1] : on/off for the comparison test with tsp
+   -  [0, 1] : on/off for the nearest neighbor graph test
+   -  [0, 1] : on/off for the sparse graph test
+
+   usage examples:
+   ./tsp-heur-pthread-test
+   ./tsp-heur-pthread-test 4 12 10 14
+   ./tsp-heur-pthread-test 1 1 14 14 0 1 0
+
+   tsp-heur-pthread-test can be run with any subset of command line
+   arguments in the above-defined order. If the (i + 1)th argument is
+   specified then the ith argument must be specified for i >= 0. Default
+   values are used for the unspecified arguments according to the
+   C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 with the only requirement that CHAR_BIT * sizeof(size_t) is
+   greater or equal to 16 and is even, and that the pthreads API is
+   available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include "tsp-heur-pthread.h"
+#include "tsp.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "tsp-heur-pthread-test\n"
+  "[1, 16] : a\n"
+  "[1, 16] : b s.t. a <= |V| <= b for the comparison test with tsp\n"
+  "[0, # bits in size_t / 2] : c\n"
+  "[0, # bits in size_t / 2] : d s.t. 2^c <= |V| <= 2^d for the\n"
+  "nearest neighbor graph test\n"
+  "[0, 1] : on/off for the comparison test with tsp\n"
+  "[0, 1] : on/off for the nearest neighbor graph test\n"
+  "[0, 1] : on/off for the sparse graph test\n";
+const int C_ARGC_MAX = 8;
+const size_t C_ARGS_DEF[7] = {1, 11, 8, 13, 1, 1, 1};
+const size_t C_EXACT_MAX = 16;
+
+/* heuristic parameters */
+const size_t C_NUM_NBRS = 8;
+const size_t C_NUM_RESTARTS = 8;
+const size_t C_NUM_THREADS[3] = {1, 2, 4};
+const int C_NUM_THREADS_COUNT = 3;
+
+/* random graph tests */
+const int C_ITER = 10;
+const size_t C_KNN = 10; /* number of nearest neighbors of a point */
+const double C_REL_ERR = 1e-9;
+const size_t C_SPARSE_MIN = 3; /* a path graph has no tour */
+
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
+			      ((CHAR_BIT * sizeof(size_t) + 1) / 2));
+
+int bern_one(void *arg);
+void perm_rand(size_t *perm, size_t n);
+int is_tour(const size_t *tour, size_t n, unsigned char *is_seen);
+double timer();
+void print_test_result(int res);
+
+/**
+   Compare the results of tsp_heur_pthread and tsp on random complete
+   graphs with random size_t weights.
+*/
+
+void add_uint(void *sum, const void *a, const void *b){
+  *(size_t *)sum = *(size_t *)a + *(size_t *)b;
+}
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/**
+   Returns the weight of a tour in a complete graph with a weight matrix.
+*/
+size_t uint_tour_wt(const size_t *wts, const size_t *tour, size_t n){
+  size_t i, wt = 0;
+  if (n == 1) return 0;
+  for (i = 0; i < n; i++){
+    wt += wts[tour[i] * n + tour[(i + 1) % n]];
+  }
+  return wt;
+}
+
+void adj_lst_rand_complete(adj_lst_t *a, size_t *wts, size_t n){
+  size_t i, j, wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n; i++){
+    for (j = i + 1; j < n; j++){
+      wt = 1 + RANDOM() % C_WEIGHT_HIGH;
+      wts[i * n + j] = wt;
+      wts[j * n + i] = wt;
+      adj_lst_add_undir_edge(a, i, j, &wt, bern_one, NULL);
+    }
+  }
+  graph_free(&g);
+}
+
+void run_exact_cmp_test(size_t n_start, size_t n_end){
+  int res = 1, ret, ret_exact;
+  int i, k;
+  size_t n, num_opt;
+  size_t wt, wt_ref, wt_exact;
+  size_t *tour = NULL, *wts = NULL;
+  unsigned char *is_seen = NULL;
+  double ratio_max;
+  adj_lst_t a;
+  tour = malloc_perror(n_end, sizeof(size_t));
+  wts = malloc_perror(n_end * n_end, sizeof(size_t));
+  is_seen = malloc_perror(n_end, 1);
+  printf("Run a tsp_heur_pthread test on random complete graphs with "
+	 "random size_t weights by comparison with tsp\n");
+  for (n = n_start; n <= n_end; n++){
+    num_opt = 0;
+    ratio_max = 1.0;
+    for (i = 0; i < C_ITER; i++){
+      adj_lst_rand_complete(&a, wts, n);
+      ret_exact = tsp(&a, 0, &wt_exact, NULL, add_uint, cmp_uint);
+      res *= (ret_exact == 0);
+      for (k = 0; k < C_NUM_THREADS_COUNT; k++){
+	ret = tsp_heur_pthread(&a, tour, &wt, C_NUM_NBRS, C_NUM_RESTARTS,
+			       i, C_NUM_THREADS[k], add_uint, cmp_uint);
+	res *= (ret == 0);
+	res *= (is_tour(tour, n, is_seen) && tour[0] == 0);
+	res *= (wt == uint_tour_wt(wts, tour, n));
+	res *= (wt >= wt_exact);
+	if (k == 0){
+	  wt_ref = wt;
+	}else{
+	  res *= (wt == wt_ref); /* independent of the number of threads */
+	}
+      }
+      num_opt += (wt_ref == wt_exact);
+      if (wt_exact > 0 && (double)wt_ref / wt_exact > ratio_max){
+	ratio_max = (double)wt_ref / wt_exact;
+      }
+      adj_lst_free(&a);
+    }
+    printf("\t\tvertices: %lu, optimal tours: %lu/%d, max ratio to "
+	   "optimal: %.4f\n", TOLU(n), TOLU(num_opt), C_ITER, ratio_max);
+  }
+  printf("\t\tcorrectness:                    ");
+  print_test_result(res);
+  free(tour);
+  free(wts);
+  free(is_seen);
+  tour = NULL;
+  wts = NULL;
+  is_seen = NULL;
+}
+
+/**
+   Run a test on random k-nearest neighbor graphs with Euclidean double
+   weights. The vertices are random points in a unit square, and an
+   undirected edge connects two points if one point is among the C_KNN
+   nearest points of the other point, so that each vertex has a degree of
+   at least C_KNN.
+   The weight of an optimal tour of n random points in a unit square is
+   approximately 0.7124 * sqrt(n) for large n.
+*/
+
+void add_double(void *sum, const void *a, const void *b){
+  *(double *)sum = *(double *)a + *(double *)b;
+}
+
+int cmp_double(const void *a, const void *b){
+  if (*(double *)a > *(double *)b){
+    return 1;
+  }else if (*(double *)a < *(double *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+double euclid(const double *x, const double *y, size_t u, size_t v){
+  return sqrt((x[u] - x[v]) * (x[u] - x[v]) + (y[u] - y[v]) * (y[u] - y[v]));
+}
+
+/**
+   Returns 1 if v is among the k nearest vertices of u in the nbrs array,
+   and 0 otherwise.
+*/
+int is_knn(const size_t *nbrs, size_t k, size_t u, size_t v){
+  size_t i;
+  for (i = 0; i < k; i++){
+    if (nbrs[u * k + i] == v) return 1;
+  }
+  return 0;
+}
+
+void adj_lst_rand_knn(adj_lst_t *a,
+		      double *x,
+		      double *y,
+		      size_t *nbrs,
+		      double *dists,
+		      size_t n,
+		      size_t k){
+  size_t i, j, h, v;
+  double wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(double),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n; i++){
+    x[i] = DRAND();
+    y[i] = DRAND();
+  }
+  for (i = 0; i < n; i++){
+    h = 0;
+    for (j = 0; j < n; j++){
+      if (j == i) continue;
+      wt = euclid(x, y, i, j);
+      if (h == k && wt >= dists[k - 1]) continue;
+      v = (h < k) ? h++ : k - 1;
+      while (v > 0 && wt < dists[v - 1]){
+	nbrs[i * k + v] = nbrs[i * k + v - 1];
+	dists[v] = dists[v - 1];
+	v--;
+      }
+      nbrs[i * k + v] = j;
+      dists[v] = wt;
+    }
+  }
+  for (i = 0; i < n; i++){
+    for (h = 0; h < k; h++){
+      j = nbrs[i * k + h];
+      if (i < j || !is_knn(nbrs, k, j, i)){
+	wt = euclid(x, y, i, j);
+	adj_lst_add_undir_edge(a, i, j, &wt, bern_one, NULL);
+      }
+    }
+  }
+  graph_free(&g);
+}
+
+int same_dist(double a, double b){
+  double d = (a > b) ? a - b : b - a;
+  return d <= C_REL_ERR * ((a > b) ? a : b);
+}
+
+void run_knn_test(int pow_start, int pow_end){
+  int res = 1, ret, ret_one;
+  int i, k;
+  size_t j, n, num_knn;
+  size_t *tour = NULL, *nbrs = NULL;
+  unsigned char *is_seen = NULL;
+  double wt, wt_ref = 0.0, wt_one, wt_sum, t;
+  double *x = NULL, *y = NULL, *dists = NULL;
+  adj_lst_t a;
+  tour = malloc_perror(pow_two_perror(pow_end), sizeof(size_t));
+  is_seen = malloc_perror(pow_two_perror(pow_end), 1);
+  x = malloc_perror(pow_two_perror(pow_end), sizeof(double));
+  y = malloc_perror(pow_two_perror(pow_end), sizeof(double));
+  nbrs = malloc_perror(mul_sz_perror(pow_two_perror(pow_end), C_KNN),
+		       sizeof(size_t));
+  dists = malloc_perror(C_KNN, sizeof(double));
+  printf("Run a tsp_heur_pthread test on random k-nearest neighbor graphs "
+	 "with Euclidean double weights\n");
+  printf("\tk: %lu, neighbors: %lu, restarts: %lu\n",
+	 TOLU(C_KNN), TOLU(C_NUM_NBRS), TOLU(C_NUM_RESTARTS));
+  fflush(stdout);
+  for (i = pow_start; i <= pow_end; i++){
+    n = pow_two_perror(i); /* 0 < n */
+    num_knn = (n - 1 < C_KNN) ? n - 1 : C_KNN;
+    adj_lst_rand_knn(&a, x, y, nbrs, dists, n, num_knn);
+    printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	   TOLU(a.num_vts), TOLU(a.num_es));
+    ret_one = tsp_heur_pthread(&a, tour, &wt_one, C_NUM_NBRS, 1, i, 1,
+			       add_double, cmp_double);
+    printf("\t\t\tone restart tour found:            %s\n",
+	   (ret_one == 0) ? "yes" : "no");
+    for (k = 0; k < C_NUM_THREADS_COUNT; k++){
+      t = timer();
+      ret = tsp_heur_pthread(&a, tour, &wt, C_NUM_NBRS, C_NUM_RESTARTS,
+			     i, C_NUM_THREADS[k], add_double, cmp_double);
+      t = timer() - t;
+      if (k == 0 && ret == 0){
+	printf("\t\t\ttour weight / sqrt(n):             %.4f\n",
+	       wt / sqrt((double)n));
+      }
+      printf("\t\t\t# threads: %lu, runtime:            %.4f seconds\n",
+	     TOLU(C_NUM_THREADS[k]), t);
+      fflush(stdout);
+      res *= (ret == 0);
+      if (ret != 0) continue;
+      res *= is_tour(tour, n, is_seen);
+      wt_sum = 0.0;
+      for (j = 0; j < n && n > 1; j++){
+	wt_sum += euclid(x, y, tour[j], tour[(j + 1) % n]);
+      }
+      res *= same_dist(wt, wt_sum);
+      if (k == 0){
+	wt_ref = wt;
+      }else{
+	res *= (wt == wt_ref); /* independent of the number of threads */
+      }
+    }
+    /* the restarts include the single restart */
+    res *= (ret_one != 0 || (ret == 0 && cmp_double(&wt_ref, &wt_one) <= 0));
+    printf("\t\t\tcorrectness:                       ");
+    print_test_result(res);
+    res = 1;
+    adj_lst_free(&a);
+  }
+  free(tour);
+  free(is_seen);
+  free(x);
+  free(y);
+  free(nbrs);
+  free(dists);
+  tour = NULL;
+  is_seen = NULL;
+  x = NULL;
+  y = NULL;
+  nbrs = NULL;
+  dists = NULL;
+}
+
+/**
+   Run a test on a cycle graph with a single tour and on a path graph
+   without a tour, with n >= C_SPARSE_MIN vertices, random size_t weights
+   and randomly permuted vertices.
+*/
+void run_sparse_test(size_t n){
+  int res = 1, ret;
+  int k;
+  size_t i, wt, wt_cycle;
+  size_t *perm = NULL, *tour = NULL, *wts = NULL;
+  unsigned char *is_seen = NULL;
+  graph_t g;
+  adj_lst_t a, b;
+  perm = malloc_perror(n, sizeof(size_t));
+  tour = malloc_perror(n, sizeof(size_t));
+  wts = malloc_perror(n, sizeof(size_t));
+  is_seen = malloc_perror(n, 1);
+  perm_rand(perm, n);
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(&a, &g);
+  adj_lst_base_init(&b, &g);
+  wt_cycle = 0;
+  for (i = 0; i < n; i++){
+    wts[i] = 1 + RANDOM() % C_WEIGHT_HIGH;
+    wt_cycle += wts[i];
+    adj_lst_add_undir_edge(&a, perm[i], perm[(i + 1) % n], &wts[i],
+			   bern_one, NULL);
+    if (i + 1 < n){
+      adj_lst_add_undir_edge(&b, perm[i], perm[i + 1], &wts[i],
+			     bern_one, NULL);
+    }
+  }
+  printf("Run a tsp_heur_pthread test on a cycle graph and a path graph "
+	 "with random size_t weights\n");
+  printf("\tvertices: %lu\n", TOLU(n));
+  for (k = 0; k < C_NUM_THREADS_COUNT; k++){
+    ret = tsp_heur_pthread(&a, tour, &wt, C_NUM_NBRS, C_NUM_RESTARTS, k,
+			   C_NUM_THREADS[k], add_uint, cmp_uint);
+    res *= (ret == 0 && wt == wt_cycle && is_tour(tour, n, is_seen));
+    ret = tsp_heur_pthread(&b, tour, &wt, C_NUM_NBRS, C_NUM_RESTARTS, k,
+			   C_NUM_THREADS[k], add_uint, cmp_uint);
+    res *= (ret == 1);
+  }
+  printf("\t\tcorrectness:                    ");
+  print_test_result(res);
+  adj_lst_free(&a);
+  adj_lst_free(&b);
+  graph_free(&g);
+  free(perm);
+  free(tour);
+  free(wts);
+  free(is_seen);
+  perm = NULL;
+  tour = NULL;
+  wts = NULL;
+  is_seen = NULL;
+}
+
+/**
+   Auxiliary functions.
+*/
+
+int bern_one(void *arg){
+  (void)arg;
+  return 1;
+}
+
+/**
+   Copies a random permutation of [0, n) to the array pointed to by perm.
+*/
+void perm_rand(size_t *perm, size_t n){
+  size_t i, j, t;
+  for (i = 0; i < n; i++){
+    perm[i] = i;
+  }
+  for (i = n - 1; i > 0; i--){
+    j = ((size_t)RANDOM() * ((size_t)RAND_MAX + 1) + RANDOM()) % (i + 1);
+    t = perm[i];
+    perm[i] = perm[j];
+    perm[j] = t;
+  }
+}
+
+/**
+   Tests if an array of n vertices is a permutation of [0, n) with the
+   is_seen block of size n.
+*/
+int is_tour(const size_t *tour, size_t n, unsigned char *is_seen){
+  size_t i;
+  memset(is_seen, 0, n);
+  for (i = 0; i < n; i++){
+    if (tour[i] >= n || is_seen[tour[i]]) return 0;
+    is_seen[tour[i]] = 1;
+  }
+  return 1;
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] < 1 ||
+      args[1] > C_EXACT_MAX ||
+      args[1] < args[0] ||
+      args[2] > C_FULL_BIT / 2 ||
+      args[3] > C_FULL_BIT / 2 ||
+      args[3] < args[2] ||
+      args[4] > 1 ||
+      args[5] > 1 ||
+      args[6] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[4]) run_exact_cmp_test(args[0], args[1]);
+  if (args[5]) run_knn_test(args[2], args[3]);
+  if (args[6]){
+    run_sparse_test(C_SPARSE_MIN);
+    if (pow_two_perror(args[2]) > C_SPARSE_MIN){
+      run_sparse_test(pow_two_perror(args[2]));
+    }
+  }
+  free(args);
+  args = NULL;
+  return 0;
+}
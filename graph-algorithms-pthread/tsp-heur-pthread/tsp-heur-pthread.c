@@ -0,0 +1,1066 @@
+/**
+   tsp-heur-pthread.c
+
+   A heuristic solution of TSP without vertex revisiting on undirected
+   graphs with generic weights, with randomized restarts that run in
+   parallel on num_threads threads.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The graph is undirected, i.e. each edge (u, v)
+   is in the adjacency list together with an edge (v, u) with the same
+   weight, as built with adj_lst_undir_build or adj_lst_add_undir_edge.
+
+   Each restart constructs a tour by the nearest neighbor heuristic from a
+   random start vertex, and improves the tour with 2-opt moves and Or-opt
+   moves of segments of up to C_OR_MAX vertices until no improving move is
+   found. The moves at a vertex are only searched with the vertices in its
+   neighbor list, which consists of at most num_nbrs adjacent vertices with
+   minimal weights, and a move is only searched with a neighbor c of a
+   vertex a if the weight of (a, c) is less than the weight of the tour
+   edge at a that the move removes. The vertices to be processed are in a
+   queue, which initially contains all vertices, and the vertices with a
+   changed tour edge are pushed again after a move, so that a local search
+   runs in near-linear time on sparse and geometric graphs.
+
+   A tour is an array of vertices with the position of each vertex in a
+   second array. A 2-opt move reverses a path of the tour, and the shorter
+   of the path and the rest of the tour is reversed, which results in the
+   same cycle. An Or-opt move is performed as a sequence of two or three
+   2-opt moves, each specified by the vertices of the removed edges
+   regardless of the direction of the array.
+
+   The heuristic does not require an edge between each pair of vertices.
+   If a construction does not find an unvisited adjacent vertex, it
+   continues from a random unvisited vertex, and a tour edge that is not in
+   the graph is weighted as greater than any edge in the graph, i.e. a move
+   is compared by the number of removed and added edges that are not in the
+   graph first, and by the sums of the weights of the edges that are in
+   the graph second. The weight of an edge is found by a binary search in
+   a list of the adjacent vertices of a vertex sorted by vertex, in which
+   parallel edges are replaced by an edge with a minimal weight.
+
+   Each restart has its own random number sequence derived from a seed and
+   the index of the restart, and a tie between restarts is resolved by
+   the lower index, so that the result is a function of the seed and the
+   parameters and does not depend on the number of threads. The restarts
+   are taken by the threads from a counter that is protected by a mutex.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "tsp-heur-pthread.h"
+#include "graph.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t wt_size;
+  size_t num_nbrs;            /* maximal number of vertices in a nbr list */
+  size_t num_restarts;
+  size_t seed;
+  size_t next;                /* next restart, protected by mutex */
+  size_t *offsets;            /* num_vts + 1 offsets of lists in vts */
+  size_t *vts;                /* lists sorted by vertex */
+  void *wts;                  /* weights parallel to vts */
+  size_t *nbrs;               /* [u * num_nbrs + i], indices in vts */
+  size_t *nbr_counts;
+  pthread_mutex_t mutex;
+  void (*add_wt)(void *, const void *, const void *);
+  int (*cmp_wt)(const void *, const void *);
+} tsph_t;
+
+typedef struct{
+  size_t *tour;               /* vertex at each position */
+  size_t *pos;                /* position of each vertex */
+  size_t *queue;              /* circular queue of vertices to process */
+  size_t queue_head;
+  size_t queue_num;
+  unsigned char *in_queue;    /* also the visited flags of a construction */
+  size_t *marks;              /* BFS marks of a construction */
+  size_t mark;
+  size_t *hops;               /* BFS hops from the first vertex of a tour */
+  void *wt_bufs;              /* four weight buffers */
+  int found;                  /* non-zero if a restart found a tour */
+  size_t best_ix;             /* restart of the best tour */
+  size_t *best_tour;
+  void *best_wt;
+  tsph_t *d;
+} tsph_ws_t;
+
+static const size_t C_OR_MAX = 3; /* max number of vertices in an Or-opt */
+static const size_t C_ROT_MAX = 1024; /* max rotations of a path end */
+static const size_t C_BFS_MAX = 4096; /* max vertices reached by a BFS */
+static const size_t C_NONE = (size_t)-1;
+
+/* splitmix constants truncated to the width of size_t, all odd */
+static const size_t C_MIX_INCR = ((((((size_t)0x9e37u << 8 << 8) |
+				     0x79b9u) << 8 << 8) |
+				   0x7f4au) << 8 << 8) | 0x7c15u;
+static const size_t C_MIX_MUL_A = ((((((size_t)0xbf58u << 8 << 8) |
+				      0x476du) << 8 << 8) |
+				    0x1ce4u) << 8 << 8) | 0xe5b9u;
+static const size_t C_MIX_MUL_B = ((((((size_t)0x94d0u << 8 << 8) |
+				      0x49bbu) << 8 << 8) |
+				    0x1331u) << 8 << 8) | 0x11ebu;
+static const size_t C_MIX_SHIFT_A = CHAR_BIT * sizeof(size_t) * 15 / 32;
+static const size_t C_MIX_SHIFT_B = CHAR_BIT * sizeof(size_t) * 27 / 64;
+static const size_t C_MIX_SHIFT_C = CHAR_BIT * sizeof(size_t) / 2 - 1;
+
+static int tsp_heur_view(const adj_view_t *a,
+			 size_t *tour,
+			 void *dist,
+			 size_t num_nbrs,
+			 size_t num_restarts,
+			 size_t seed,
+			 size_t num_threads,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *));
+
+/* auxiliary functions */
+static void lists_build(tsph_t *d, const adj_view_t *a);
+static void lists_free(tsph_t *d);
+static void ws_init(tsph_ws_t *w, tsph_t *d);
+static void ws_free(tsph_ws_t *w);
+static void *tsp_heur_thread(void *arg);
+static void construct(tsph_ws_t *w, size_t *s);
+static int insert(tsph_ws_t *w, size_t num, size_t x);
+static size_t nearest_unvisited(const tsph_ws_t *w, size_t u);
+static int rotate(tsph_ws_t *w, size_t num, int is_close, size_t *s);
+static void reverse_path(tsph_ws_t *w, size_t i, size_t j);
+static void bfs_hops(tsph_ws_t *w, size_t u);
+static size_t bfs_unvisited(tsph_ws_t *w, size_t u);
+static void local_search(tsph_ws_t *w);
+static int two_opt(tsph_ws_t *w, size_t a);
+static int or_opt(tsph_ws_t *w, size_t a);
+static int or_try(tsph_ws_t *w,
+		  size_t f,
+		  size_t len,
+		  size_t x,
+		  size_t y,
+		  int is_fwd);
+static void move_two_opt(tsph_ws_t *w, size_t a, size_t b, size_t c, size_t e);
+static void move_or_opt(tsph_ws_t *w,
+			size_t p,
+			size_t f,
+			size_t l,
+			size_t q,
+			size_t x,
+			size_t y,
+			int is_fwd);
+static void reverse(tsph_ws_t *w, size_t i, size_t j);
+static int cmp_move(tsph_ws_t *w,
+		    const size_t *rm,
+		    const size_t *add,
+		    size_t k);
+static size_t sum_wts(tsph_ws_t *w, const size_t *es, size_t k, void *sum);
+static size_t tour_wt(tsph_ws_t *w, void *wt);
+static const void *find_wt(const tsph_t *d, size_t u, size_t v);
+static void push(tsph_ws_t *w, size_t v);
+static size_t succ(const tsph_ws_t *w, size_t v);
+static size_t pred(const tsph_ws_t *w, size_t v);
+static int in_seg(const tsph_ws_t *w, size_t f, size_t len, size_t v);
+static size_t rng_init(size_t seed, size_t i);
+static size_t rng_next(size_t *s);
+static size_t mix(size_t a);
+static int cmp_vt_ix(const void *a, const void *b);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Copies to the block pointed to by dist the weight of a tour across all
+   vertices without revisiting, and copies the tour to the array pointed
+   to by tour starting from vertex 0, if a tour is found. Returns 0 if a
+   tour is found, otherwise returns 1.
+   a            : pointer to an undirected adjacency list with at least one
+                  vertex
+   tour         : pointer to a preallocated array of num_vts size_t
+                  vertices; the ith edge of a tour is (tour[i],
+                  tour[(i + 1) % num_vts])
+   dist         : pointer to a preallocated block of the size of a weight
+                  in the adjacency list
+   num_nbrs     : > 0 maximal number of vertices in a neighbor list
+   num_restarts : > 0 number of restarts
+   seed         : seed of the random number sequences of the restarts
+   num_threads  : > 0 number of threads
+   add_wt       : addition function which copies the sum of the weight
+                  values pointed to by the second and third arguments to
+                  the preallocated weight block pointed to by the first
+                  argument
+   cmp_wt       : comparison function which returns a negative integer
+                  value if the weight value pointed to by the first argument
+                  is less than the weight value pointed to by the second, a
+                  positive integer value if the weight value pointed to by
+                  the first argument is greater than the weight value
+                  pointed to by the second, and zero integer value if the
+                  two weight values are equal
+*/
+int tsp_heur_pthread(const adj_lst_t *a,
+		     size_t *tour,
+		     void *dist,
+		     size_t num_nbrs,
+		     size_t num_restarts,
+		     size_t seed,
+		     size_t num_threads,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return tsp_heur_view(&w, tour, dist, num_nbrs, num_restarts, seed,
+		       num_threads, add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_heur_pthread on a compressed sparse row (CSR) adjacency list.
+   Please see the parameter specification in tsp_heur_pthread.
+   c            : pointer to an undirected CSR adjacency list with at least
+                  one vertex
+*/
+int tsp_heur_pthread_csr(const adj_csr_t *c,
+			 size_t *tour,
+			 void *dist,
+			 size_t num_nbrs,
+			 size_t num_restarts,
+			 size_t seed,
+			 size_t num_threads,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return tsp_heur_view(&w, tour, dist, num_nbrs, num_restarts, seed,
+		       num_threads, add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_heur_pthread on a view of an adjacency list. The caller thread
+   runs as the thread with id 0. The lists are built before the threads
+   are created, and are only read by the threads.
+*/
+static int tsp_heur_view(const adj_view_t *a,
+			 size_t *tour,
+			 void *dist,
+			 size_t num_nbrs,
+			 size_t num_restarts,
+			 size_t seed,
+			 size_t num_threads,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *)){
+  size_t i, j, n = a->num_vts;
+  pthread_t *tids = NULL;
+  tsph_ws_t *ws = NULL, *best = NULL;
+  tsph_t d;
+  memset(dist, 0, a->wt_size);
+  if (n == 1){
+    tour[0] = 0;
+    return 0;
+  }
+  d.num_vts = n;
+  d.wt_size = a->wt_size;
+  d.num_nbrs = num_nbrs;
+  d.num_restarts = num_restarts;
+  d.seed = seed;
+  d.next = 0;
+  d.add_wt = add_wt;
+  d.cmp_wt = cmp_wt;
+  mutex_init_perror(&d.mutex);
+  lists_build(&d, a);
+  ws = malloc_perror(num_threads, sizeof(tsph_ws_t));
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  for (i = 0; i < num_threads; i++){
+    ws_init(&ws[i], &d);
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&tids[i], tsp_heur_thread, &ws[i]);
+  }
+  tsp_heur_thread(&ws[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  for (i = 0; i < num_threads; i++){
+    if (!ws[i].found) continue;
+    if (best == NULL || cmp_wt(best->best_wt, ws[i].best_wt) > 0 ||
+	(cmp_wt(best->best_wt, ws[i].best_wt) == 0 &&
+	 best->best_ix > ws[i].best_ix)){
+      best = &ws[i];
+    }
+  }
+  if (best != NULL){
+    memcpy(dist, best->best_wt, a->wt_size);
+    for (i = 0; best->best_tour[i] != 0; i++);
+    for (j = 0; j < n; j++){
+      tour[j] = best->best_tour[i];
+      i = (i + 1 == n) ? 0 : i + 1;
+    }
+  }
+  for (i = 0; i < num_threads; i++){
+    ws_free(&ws[i]);
+  }
+  lists_free(&d);
+  free(ws);
+  free(tids);
+  ws = NULL;
+  tids = NULL;
+  return (best == NULL);
+}
+
+/**
+   Builds the lists of the adjacent vertices of each vertex sorted by
+   vertex without self-loops, where parallel edges are replaced by an edge
+   with a minimal weight, and the neighbor list of each vertex with the
+   indices of at most num_nbrs vertices with minimal weights in the
+   non-decreasing order of weights.
+*/
+static void lists_build(tsph_t *d, const adj_view_t *a){
+  size_t i, j, k, m, u, v, num, max_num = 0;
+  size_t n = a->num_vts, wt_size = a->wt_size, nn = d->num_nbrs;
+  size_t *ixs = NULL, *nbr = NULL;
+  const char *p = NULL;
+  const void *wt = NULL;
+  for (u = 0; u < n; u++){
+    a->vt_wts(a->adj, u, &num);
+    if (max_num < num) max_num = num;
+  }
+  d->offsets = malloc_perror(add_sz_perror(n, 1), sizeof(size_t));
+  d->vts = malloc_perror(add_sz_perror(a->num_es, 1), sizeof(size_t));
+  d->wts = malloc_perror(add_sz_perror(a->num_es, 1), wt_size);
+  d->nbrs = malloc_perror(mul_sz_perror(n, nn), sizeof(size_t));
+  d->nbr_counts = malloc_perror(n, sizeof(size_t));
+  ixs = malloc_perror(mul_sz_perror(add_sz_perror(max_num, 1), 2),
+		      sizeof(size_t));
+  d->offsets[0] = 0;
+  for (u = 0; u < n; u++){
+    p = a->vt_wts(a->adj, u, &num);
+    k = 0;
+    for (j = 0; j < num; j++){
+      v = a->read_vt(p + j * a->pair_size);
+      if (v == u) continue;
+      ixs[2 * k] = v;
+      ixs[2 * k + 1] = j;
+      k++;
+    }
+    qsort(ixs, k, 2 * sizeof(size_t), cmp_vt_ix);
+    m = d->offsets[u];
+    for (j = 0; j < k; j++){
+      wt = p + ixs[2 * j + 1] * a->pair_size + a->wt_offset;
+      if (m > d->offsets[u] && d->vts[m - 1] == ixs[2 * j]){
+	if (d->cmp_wt(wt, ptr(d->wts, m - 1, wt_size)) < 0){
+	  memcpy(ptr(d->wts, m - 1, wt_size), wt, wt_size);
+	}
+	continue;
+      }
+      d->vts[m] = ixs[2 * j];
+      memcpy(ptr(d->wts, m, wt_size), wt, wt_size);
+      m++;
+    }
+    d->offsets[u + 1] = m;
+    /* insertion into a neighbor list of at most nn indices */
+    nbr = &d->nbrs[u * nn];
+    k = 0;
+    for (j = d->offsets[u]; j < m; j++){
+      wt = ptr(d->wts, j, wt_size);
+      if (k == nn && d->cmp_wt(wt, ptr(d->wts, nbr[nn - 1], wt_size)) >= 0){
+	continue;
+      }
+      i = (k < nn) ? k++ : nn - 1;
+      while (i > 0 && d->cmp_wt(wt, ptr(d->wts, nbr[i - 1], wt_size)) < 0){
+	nbr[i] = nbr[i - 1];
+	i--;
+      }
+      nbr[i] = j;
+    }
+    d->nbr_counts[u] = k;
+  }
+  free(ixs);
+  ixs = NULL;
+}
+
+static void lists_free(tsph_t *d){
+  free(d->offsets);
+  free(d->vts);
+  free(d->wts);
+  free(d->nbrs);
+  free(d->nbr_counts);
+  d->offsets = NULL;
+  d->vts = NULL;
+  d->wts = NULL;
+  d->nbrs = NULL;
+  d->nbr_counts = NULL;
+}
+
+/**
+   Initializes and frees the workspace of a thread.
+*/
+
+static void ws_init(tsph_ws_t *w, tsph_t *d){
+  size_t n = d->num_vts;
+  w->tour = malloc_perror(n, sizeof(size_t));
+  w->pos = malloc_perror(n, sizeof(size_t));
+  w->queue = malloc_perror(n, sizeof(size_t));
+  w->queue_head = 0;
+  w->queue_num = 0;
+  w->in_queue = calloc_perror(n, 1);
+  w->marks = calloc_perror(n, sizeof(size_t));
+  w->mark = 0;
+  w->hops = malloc_perror(n, sizeof(size_t));
+  w->wt_bufs = malloc_perror(4, d->wt_size);
+  w->found = 0;
+  w->best_ix = 0;
+  w->best_tour = malloc_perror(n, sizeof(size_t));
+  w->best_wt = malloc_perror(1, d->wt_size);
+  w->d = d;
+}
+
+static void ws_free(tsph_ws_t *w){
+  free(w->tour);
+  free(w->pos);
+  free(w->queue);
+  free(w->in_queue);
+  free(w->marks);
+  free(w->hops);
+  free(w->wt_bufs);
+  free(w->best_tour);
+  free(w->best_wt);
+  w->tour = NULL;
+  w->pos = NULL;
+  w->queue = NULL;
+  w->in_queue = NULL;
+  w->marks = NULL;
+  w->hops = NULL;
+  w->wt_bufs = NULL;
+  w->best_tour = NULL;
+  w->best_wt = NULL;
+}
+
+/**
+   Runs a thread of tsp_heur_pthread. A thread takes the next restart
+   until all restarts are taken, and keeps the tour of a restart if it is
+   lighter than the tours of the previous restarts of the thread. Because
+   the restarts of a thread are taken in the increasing order of indices,
+   a tour of the same weight is not kept.
+*/
+static void *tsp_heur_thread(void *arg){
+  size_t i, s, num_miss;
+  tsph_ws_t *w = arg;
+  tsph_t *d = w->d;
+  void *wt = ptr(w->wt_bufs, 3, d->wt_size);
+  for (;;){
+    mutex_lock_perror(&d->mutex);
+    i = d->next;
+    if (d->next < d->num_restarts) d->next++;
+    mutex_unlock_perror(&d->mutex);
+    if (i == d->num_restarts) break;
+    s = rng_init(d->seed, i);
+    construct(w, &s);
+    local_search(w);
+    num_miss = tour_wt(w, wt);
+    if (num_miss > 0) continue;
+    if (!w->found || d->cmp_wt(w->best_wt, wt) > 0){
+      memcpy(w->best_wt, wt, d->wt_size);
+      memcpy(w->best_tour, w->tour, d->num_vts * sizeof(size_t));
+      w->best_ix = i;
+      w->found = 1;
+    }
+  }
+  return NULL;
+}
+
+/**
+   Constructs a tour by the nearest neighbor heuristic from a random start
+   vertex, where the tour is a path until all vertices are visited. If the
+   last vertex u of the path has no unvisited adjacent vertex, the path is
+   rotated at most C_ROT_MAX times: a random adjacent vertex v of u in the
+   path other than its predecessor is selected, the path after v is
+   reversed, so that (v, u) is in the path, and the path is extended from
+   the new last vertex if it has an unvisited adjacent vertex. Otherwise,
+   an unvisited vertex is found by a BFS from u, or the next unvisited
+   vertex in the order of vertices is visited. The last vertex is rotated
+   in the same way to be adjacent to the start vertex. The visited flags
+   are in in_queue, which is cleared at the end.
+*/
+static void construct(tsph_ws_t *w, size_t *s){
+  size_t i, j, v, num = 0, next = 0;
+  size_t n = w->d->num_vts;
+  int is_stuck = 0;
+  const tsph_t *d = w->d;
+  v = rng_next(s) % n;
+  w->tour[num++] = v;
+  w->pos[v] = 0;
+  w->in_queue[v] = 1;
+  while (num < n){
+    v = nearest_unvisited(w, w->tour[num - 1]);
+    if (v == C_NONE && nearest_unvisited(w, w->tour[0]) != C_NONE){
+      reverse_path(w, 0, num - 1);
+      v = nearest_unvisited(w, w->tour[num - 1]);
+    }
+    for (j = 0; v == C_NONE && !is_stuck && j < C_ROT_MAX; j++){
+      if (!rotate(w, num, 0, s)) break;
+      v = nearest_unvisited(w, w->tour[num - 1]);
+    }
+    if (v == C_NONE){
+      v = bfs_unvisited(w, w->tour[num - 1]);
+      while (w->in_queue[next]){
+	next++;
+      }
+      if (v == C_NONE) v = next;
+      if (insert(w, num, v)){
+	num++;
+	is_stuck = 1;
+	continue;
+      }
+      if (is_stuck){
+	is_stuck = 0; /* rotate the path after the insertions */
+	continue;
+      }
+    }
+    is_stuck = 0;
+    w->tour[num] = v;
+    w->pos[v] = num;
+    w->in_queue[v] = 1;
+    num++;
+  }
+  if (find_wt(d, w->tour[n - 1], w->tour[0]) == NULL){
+    bfs_hops(w, w->tour[0]);
+    for (j = 0; j < C_ROT_MAX; j++){
+      if (w->hops[w->tour[n - 1]] <= 1 || !rotate(w, n, 1, s)) break;
+    }
+  }
+  for (i = 0; i < n; i++){
+    w->in_queue[w->tour[i]] = 0;
+  }
+}
+
+/**
+   Inserts an unvisited vertex x into a path of num vertices in tour
+   between two consecutive vertices of the path that are adjacent to x.
+   Returns 1 if x was inserted, and 0 if the path has no such vertices.
+*/
+static int insert(tsph_ws_t *w, size_t num, size_t x){
+  size_t i, j, y;
+  const tsph_t *d = w->d;
+  for (j = d->offsets[x]; j < d->offsets[x + 1]; j++){
+    y = d->vts[j];
+    if (!w->in_queue[y] || w->pos[y] + 1 >= num ||
+	find_wt(d, x, w->tour[w->pos[y] + 1]) == NULL) continue;
+    for (i = num; i > w->pos[y] + 1; i--){
+      w->tour[i] = w->tour[i - 1];
+      w->pos[w->tour[i]] = i;
+    }
+    w->tour[i] = x;
+    w->pos[x] = i;
+    w->in_queue[x] = 1;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+   Returns an unvisited adjacent vertex of u with a minimal weight, or
+   C_NONE if all adjacent vertices of u are visited.
+*/
+static size_t nearest_unvisited(const tsph_ws_t *w, size_t u){
+  size_t j, ix;
+  const tsph_t *d = w->d;
+  ix = d->offsets[u + 1];
+  for (j = d->offsets[u]; j < d->offsets[u + 1]; j++){
+    if (w->in_queue[d->vts[j]]) continue;
+    if (ix == d->offsets[u + 1] ||
+	d->cmp_wt(ptr(d->wts, j, d->wt_size),
+		  ptr(d->wts, ix, d->wt_size)) < 0){
+      ix = j;
+    }
+  }
+  return (ix < d->offsets[u + 1]) ? d->vts[ix] : C_NONE;
+}
+
+/**
+   Rotates a path of num vertices in tour with an adjacent vertex v of the
+   last vertex u other than its predecessor, by reversing the path after v,
+   so that the successor of v becomes the last vertex. If is_close is zero,
+   v is selected such that the new last vertex has an unvisited adjacent
+   vertex, and otherwise v is selected such that the new last vertex has a
+   minimal number of hops from the first vertex. A tie is resolved at
+   random. Returns 1 if the path was rotated, and 0 if u has no such
+   adjacent vertex v.
+*/
+static int rotate(tsph_ws_t *w, size_t num, int is_close, size_t *s){
+  size_t j, u, v, x, key, min_key = C_NONE, k = 0;
+  size_t last = num - 1;
+  const tsph_t *d = w->d;
+  u = w->tour[last];
+  v = C_NONE;
+  for (j = d->offsets[u]; j < d->offsets[u + 1]; j++){
+    if (!w->in_queue[d->vts[j]] || w->pos[d->vts[j]] + 1 >= last) continue;
+    x = w->tour[w->pos[d->vts[j]] + 1]; /* the last vertex after rotation */
+    if (is_close){
+      key = w->hops[x];
+    }else{
+      key = (nearest_unvisited(w, x) == C_NONE);
+    }
+    if (v != C_NONE && key > min_key) continue;
+    if (v == C_NONE || key < min_key){
+      min_key = key;
+      k = 0;
+    }
+    k++;
+    if (rng_next(s) % k == 0) v = d->vts[j]; /* reservoir sampling */
+  }
+  if (v == C_NONE) return 0;
+  reverse_path(w, w->pos[v] + 1, last);
+  return 1;
+}
+
+/**
+   Reverses the vertices of tour from position i to position j, where
+   i <= j, without wrapping around.
+*/
+static void reverse_path(tsph_ws_t *w, size_t i, size_t j){
+  size_t u;
+  for (; i < j; i++, j--){
+    u = w->tour[i];
+    w->tour[i] = w->tour[j];
+    w->pos[w->tour[i]] = i;
+    w->tour[j] = u;
+    w->pos[u] = j;
+  }
+}
+
+/**
+   Computes in hops the number of hops of each vertex from u by a BFS, with
+   C_NONE for a vertex that is not reached. The queue of a local search is
+   used as the queue of the BFS.
+*/
+static void bfs_hops(tsph_ws_t *w, size_t u){
+  size_t i, j, v, head = 0, num = 0;
+  const tsph_t *d = w->d;
+  for (i = 0; i < d->num_vts; i++){
+    w->hops[i] = C_NONE;
+  }
+  w->hops[u] = 0;
+  w->queue[num++] = u;
+  while (head < num){
+    u = w->queue[head++];
+    for (j = d->offsets[u]; j < d->offsets[u + 1]; j++){
+      v = d->vts[j];
+      if (w->hops[v] != C_NONE) continue;
+      w->hops[v] = w->hops[u] + 1;
+      w->queue[num++] = v;
+    }
+  }
+}
+
+/**
+   Returns an unvisited vertex that is reached first by a BFS from u, or
+   C_NONE if no unvisited vertex is found in the first C_BFS_MAX vertices
+   reached by the BFS. The queue of a local search is used as the queue of
+   the BFS, and a vertex is marked by the index of the BFS in marks.
+*/
+static size_t bfs_unvisited(tsph_ws_t *w, size_t u){
+  size_t j, v, head = 0, num = 0;
+  const tsph_t *d = w->d;
+  w->mark++;
+  w->marks[u] = w->mark;
+  w->queue[num++] = u;
+  while (head < num && num < C_BFS_MAX){
+    u = w->queue[head++];
+    for (j = d->offsets[u]; j < d->offsets[u + 1]; j++){
+      v = d->vts[j];
+      if (!w->in_queue[v]) return v;
+      if (w->marks[v] == w->mark) continue;
+      w->marks[v] = w->mark;
+      w->queue[num++] = v;
+    }
+  }
+  return C_NONE;
+}
+
+/**
+   Improves a tour with 2-opt and Or-opt moves until the queue of vertices
+   to be processed is empty. The vertices of the edges that are removed by
+   a move are pushed into the queue.
+*/
+static void local_search(tsph_ws_t *w){
+  size_t i, a, n = w->d->num_vts;
+  for (i = 0; i < n; i++){
+    push(w, w->tour[i]);
+  }
+  while (w->queue_num > 0){
+    a = w->queue[w->queue_head];
+    w->queue_head = (w->queue_head + 1 == n) ? 0 : w->queue_head + 1;
+    w->queue_num--;
+    w->in_queue[a] = 0;
+    if (!two_opt(w, a)) or_opt(w, a);
+  }
+}
+
+/**
+   Searches and performs an improving 2-opt move that removes a tour edge
+   (a, b) and a tour edge (c, e), and adds the edges (a, c) and (b, e),
+   where c is in the neighbor list of a, and b and e follow a and c in the
+   same direction. Returns 1 if a move was performed, and 0 otherwise.
+*/
+static int two_opt(tsph_ws_t *w, size_t a){
+  size_t i, j, b, c, e, ix;
+  size_t rm[4], add[4];
+  const tsph_t *d = w->d;
+  const size_t *nbr = &d->nbrs[a * d->num_nbrs];
+  const void *wt_ab = NULL;
+  for (i = 0; i < 2; i++){
+    b = (i == 0) ? succ(w, a) : pred(w, a);
+    wt_ab = find_wt(d, a, b);
+    for (j = 0; j < d->nbr_counts[a]; j++){
+      ix = nbr[j];
+      if (wt_ab != NULL &&
+	  d->cmp_wt(ptr(d->wts, ix, d->wt_size), wt_ab) >= 0) break;
+      c = d->vts[ix];
+      e = (i == 0) ? succ(w, c) : pred(w, c);
+      if (c == b || e == a) continue;
+      rm[0] = a;
+      rm[1] = b;
+      rm[2] = c;
+      rm[3] = e;
+      add[0] = a;
+      add[1] = c;
+      add[2] = b;
+      add[3] = e;
+      if (cmp_move(w, rm, add, 2) < 0){
+	move_two_opt(w, a, b, c, e);
+	push(w, a);
+	push(w, b);
+	push(w, c);
+	push(w, e);
+	return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+   Searches and performs an improving Or-opt move that moves a segment of
+   the tour with an endpoint a and at most C_OR_MAX vertices between two
+   adjacent vertices x and y, where x or y is in the neighbor list of a and
+   becomes adjacent to a. If a tour edge (a, b) is not in the graph, also
+   searches a move of a segment with an endpoint c in the neighbor list of
+   a between a and b, where c becomes adjacent to a. Returns 1 if a move
+   was performed, and 0 otherwise.
+*/
+static int or_opt(tsph_ws_t *w, size_t a){
+  size_t i, j, k, len, f, c, e, b, ix;
+  size_t n = w->d->num_vts;
+  const tsph_t *d = w->d;
+  const size_t *nbr = &d->nbrs[a * d->num_nbrs];
+  const void *wt_a = NULL;
+  for (len = 1; len <= C_OR_MAX && len + 3 <= n; len++){
+    for (i = 0; i < 2; i++){
+      if (i == 1 && len == 1) break;
+      /* the segment from f in the direction of the array ends at a if i */
+      f = (i == 0) ? a : w->tour[(w->pos[a] + n - (len - 1)) % n];
+      wt_a = (i == 0) ? find_wt(d, pred(w, a), a) : find_wt(d, a, succ(w, a));
+      for (j = 0; j < d->nbr_counts[a]; j++){
+	ix = nbr[j];
+	if (wt_a != NULL &&
+	    d->cmp_wt(ptr(d->wts, ix, d->wt_size), wt_a) >= 0) break;
+	c = d->vts[ix];
+	for (k = 0; k < 2; k++){
+	  e = (k == 0) ? succ(w, c) : pred(w, c);
+	  /* a is adjacent to x as f or to y as the end of the segment */
+	  if ((k == 0 && or_try(w, f, len, c, e, (i == 0))) ||
+	      (k == 1 && or_try(w, f, len, e, c, (i == 1)))){
+	    return 1;
+	  }
+	}
+      }
+    }
+  }
+  for (k = 0; k < 2; k++){
+    b = (k == 0) ? succ(w, a) : pred(w, a);
+    if (find_wt(d, a, b) != NULL) continue;
+    for (j = 0; j < d->nbr_counts[a]; j++){
+      c = d->vts[nbr[j]];
+      for (len = 1; len <= C_OR_MAX && len + 3 <= n; len++){
+	for (i = 0; i < 2; i++){
+	  if (i == 1 && len == 1) break;
+	  f = (i == 0) ? c : w->tour[(w->pos[c] + n - (len - 1)) % n];
+	  if ((k == 0 && or_try(w, f, len, a, b, (i == 0))) ||
+	      (k == 1 && or_try(w, f, len, b, a, (i == 1)))){
+	    return 1;
+	  }
+	}
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+   Tests and performs an Or-opt move if it is improving, and returns 1 if
+   the move was performed and 0 otherwise. The move moves the segment of
+   len vertices from f to l between two adjacent vertices x and y that are
+   not in the segment, where in the direction of the array y follows x, p
+   precedes f and q follows l. The new tour has x, f, ..., l, y if is_fwd
+   is non-zero, and x, l, ..., f, y otherwise.
+*/
+static int or_try(tsph_ws_t *w,
+		  size_t f,
+		  size_t len,
+		  size_t x,
+		  size_t y,
+		  int is_fwd){
+  size_t l, p, q;
+  size_t n = w->d->num_vts;
+  size_t rm[6], add[6];
+  if (in_seg(w, f, len, x) || in_seg(w, f, len, y)) return 0;
+  l = w->tour[(w->pos[f] + len - 1) % n];
+  p = pred(w, f);
+  q = succ(w, l);
+  rm[0] = p;
+  rm[1] = f;
+  rm[2] = l;
+  rm[3] = q;
+  rm[4] = x;
+  rm[5] = y;
+  add[0] = p;
+  add[1] = q;
+  add[2] = x;
+  add[3] = is_fwd ? f : l;
+  add[4] = is_fwd ? l : f;
+  add[5] = y;
+  if (cmp_move(w, rm, add, 3) >= 0) return 0;
+  move_or_opt(w, p, f, l, q, x, y, is_fwd);
+  push(w, p);
+  push(w, f);
+  push(w, l);
+  push(w, q);
+  push(w, x);
+  push(w, y);
+  return 1;
+}
+
+/**
+   Performs a 2-opt move that removes the tour edges (a, b) and (c, e) and
+   adds the edges (a, c) and (b, e), where b and e follow a and c in the
+   same direction, which is the direction of the array or the reverse.
+*/
+static void move_two_opt(tsph_ws_t *w, size_t a, size_t b, size_t c, size_t e){
+  (void)e;
+  if (succ(w, a) == b){
+    reverse(w, w->pos[b], w->pos[c]);
+  }else{
+    reverse(w, w->pos[c], w->pos[b]);
+  }
+}
+
+/**
+   Performs an Or-opt move that moves the segment from f to l between p
+   and q to the tour edge (x, y), where in the direction of the array p
+   precedes f, q follows l, and y follows x. The segment is reversed by
+   the second 2-opt move, i.e. x, l, ..., f, y, and is reversed again by
+   the third 2-opt move if is_fwd is non-zero, i.e. x, f, ..., l, y.
+*/
+static void move_or_opt(tsph_ws_t *w,
+			size_t p,
+			size_t f,
+			size_t l,
+			size_t q,
+			size_t x,
+			size_t y,
+			int is_fwd){
+  move_two_opt(w, p, f, x, y); /* p, x, ..., q, l, ..., f, y */
+  if (x != q) move_two_opt(w, p, x, q, l); /* p, q, ..., x, l, ..., f, y */
+  if (is_fwd && f != l) move_two_opt(w, x, l, f, y);
+}
+
+/**
+   Reverses the path of a tour from position i to position j in the
+   direction of the array, or the rest of the tour if it is shorter.
+*/
+static void reverse(tsph_ws_t *w, size_t i, size_t j){
+  size_t k, u, v, n = w->d->num_vts;
+  size_t len = (j + n - i) % n + 1;
+  if (2 * len > n){
+    k = i;
+    i = (j + 1 == n) ? 0 : j + 1;
+    j = (k == 0) ? n - 1 : k - 1;
+    len = n - len;
+  }
+  for (k = 0; k < len / 2; k++){
+    u = w->tour[i];
+    v = w->tour[j];
+    w->tour[i] = v;
+    w->pos[v] = i;
+    w->tour[j] = u;
+    w->pos[u] = j;
+    i = (i + 1 == n) ? 0 : i + 1;
+    j = (j == 0) ? n - 1 : j - 1;
+  }
+}
+
+/**
+   Compares the k edges that are added by a move to the k edges that are
+   removed by the move. The edges are given by pairs of vertices. Returns
+   a negative integer value if the move is improving, a positive integer
+   value if the move is worsening, and zero otherwise.
+*/
+static int cmp_move(tsph_ws_t *w,
+		    const size_t *rm,
+		    const size_t *add,
+		    size_t k){
+  size_t rm_miss, add_miss;
+  void *rm_wt = w->wt_bufs;
+  void *add_wt = ptr(w->wt_bufs, 1, w->d->wt_size);
+  rm_miss = sum_wts(w, rm, k, rm_wt);
+  add_miss = sum_wts(w, add, k, add_wt);
+  if (add_miss != rm_miss) return (add_miss < rm_miss) ? -1 : 1;
+  if (add_miss == k) return 0;
+  return w->d->cmp_wt(add_wt, rm_wt);
+}
+
+/**
+   Copies the sum of the weights of the k edges that are in the graph
+   to the block pointed to by sum, if there is at least one such edge, and
+   returns the number of edges that are not in the graph.
+*/
+static size_t sum_wts(tsph_ws_t *w, const size_t *es, size_t k, void *sum){
+  size_t i, num_miss = 0;
+  const tsph_t *d = w->d;
+  const void *wt = NULL;
+  void *tmp = ptr(w->wt_bufs, 2, d->wt_size);
+  for (i = 0; i < k; i++){
+    wt = find_wt(d, es[2 * i], es[2 * i + 1]);
+    if (wt == NULL){
+      num_miss++;
+    }else if (num_miss == i){
+      memcpy(sum, wt, d->wt_size);
+    }else{
+      d->add_wt(tmp, sum, wt);
+      memcpy(sum, tmp, d->wt_size);
+    }
+  }
+  return num_miss;
+}
+
+/**
+   Copies the weight of a tour to the block pointed to by wt, if the tour
+   has at least one edge in the graph, and returns the number of tour edges
+   that are not in the graph.
+*/
+static size_t tour_wt(tsph_ws_t *w, void *wt){
+  size_t i, num_miss = 0;
+  size_t e[2];
+  const tsph_t *d = w->d;
+  void *sum = ptr(w->wt_bufs, 1, d->wt_size);
+  for (i = 0; i < d->num_vts; i++){
+    e[0] = w->tour[i];
+    e[1] = w->tour[(i + 1 == d->num_vts) ? 0 : i + 1];
+    if (sum_wts(w, e, 1, sum) > 0){
+      num_miss++;
+    }else if (i == num_miss){
+      memcpy(wt, sum, d->wt_size);
+    }else{
+      d->add_wt(w->wt_bufs, wt, sum);
+      memcpy(wt, w->wt_bufs, d->wt_size);
+    }
+  }
+  return num_miss;
+}
+
+/**
+   Returns a pointer to the weight of the edge (u, v), or NULL if the edge
+   is not in the graph, by a binary search in the list of u.
+*/
+static const void *find_wt(const tsph_t *d, size_t u, size_t v){
+  size_t lo = d->offsets[u], hi = d->offsets[u + 1], mid;
+  while (lo < hi){
+    mid = lo + (hi - lo) / 2;
+    if (d->vts[mid] < v){
+      lo = mid + 1;
+    }else{
+      hi = mid;
+    }
+  }
+  if (lo < d->offsets[u + 1] && d->vts[lo] == v){
+    return ptr(d->wts, lo, d->wt_size);
+  }
+  return NULL;
+}
+
+/**
+   Pushes a vertex that is not in the queue.
+*/
+static void push(tsph_ws_t *w, size_t v){
+  size_t n = w->d->num_vts;
+  if (w->in_queue[v]) return;
+  w->queue[(w->queue_head + w->queue_num) % n] = v;
+  w->queue_num++;
+  w->in_queue[v] = 1;
+}
+
+/**
+   Return the vertex that follows and precedes a vertex in the direction
+   of the array of a tour, and test if a vertex is in the segment of len
+   vertices from f in the direction of the array.
+*/
+
+static size_t succ(const tsph_ws_t *w, size_t v){
+  size_t i = w->pos[v] + 1;
+  return w->tour[(i == w->d->num_vts) ? 0 : i];
+}
+
+static size_t pred(const tsph_ws_t *w, size_t v){
+  size_t i = w->pos[v];
+  return w->tour[(i == 0) ? w->d->num_vts - 1 : i - 1];
+}
+
+static int in_seg(const tsph_ws_t *w, size_t f, size_t len, size_t v){
+  size_t n = w->d->num_vts;
+  return (w->pos[v] + n - w->pos[f]) % n < len;
+}
+
+/**
+   Returns the initial state of the random number sequence of the restart
+   at index i, and returns the next value of a sequence with state s.
+*/
+
+static size_t rng_init(size_t seed, size_t i){
+  return mix(mix(seed) + i * C_MIX_INCR);
+}
+
+static size_t rng_next(size_t *s){
+  *s += C_MIX_INCR;
+  return mix(*s);
+}
+
+/**
+   Mixes the bits of a size_t value with the finalizer of splitmix.
+*/
+static size_t mix(size_t a){
+  a = (a ^ (a >> C_MIX_SHIFT_A)) * C_MIX_MUL_A;
+  a = (a ^ (a >> C_MIX_SHIFT_B)) * C_MIX_MUL_B;
+  return a ^ (a >> C_MIX_SHIFT_C);
+}
+
+/**
+   Compares pairs of a vertex and an index in a list by vertex and then by
+   index.
+*/
+static int cmp_vt_ix(const void *a, const void *b){
+  const size_t *s = a;
+  const size_t *t = b;
+  if (s[0] != t[0]) return (s[0] < t[0]) ? -1 : 1;
+  if (s[1] != t[1]) return (s[1] < t[1]) ? -1 : 1;
+  return 0;
+}
+
+/**
+   Computes a pointer to an entry in an array of entries of size size.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
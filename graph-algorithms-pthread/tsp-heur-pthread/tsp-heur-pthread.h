@@ -0,0 +1,102 @@
+/**
+   tsp-heur-pthread.h
+
+   Declarations of accessible functions for running a heuristic solution of
+   TSP without vertex revisiting on undirected graphs with generic weights,
+   with randomized restarts that run in parallel on num_threads threads.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The graph is undirected, i.e. each edge (u, v)
+   is in the adjacency list together with an edge (v, u) with the same
+   weight, as built with adj_lst_undir_build or adj_lst_add_undir_edge.
+
+   Each restart constructs a tour by the nearest neighbor heuristic from a
+   random start vertex, and improves the tour with 2-opt moves and Or-opt
+   moves of segments of up to three vertices until no improving move is
+   found. The moves at a vertex are only searched with the vertices in its
+   neighbor list, which consists of at most num_nbrs adjacent vertices with
+   minimal weights, and the vertices with a changed tour edge are processed
+   again, so that a local search runs in near-linear time on sparse and
+   geometric graphs. The restarts are distributed across the threads, and
+   the result is the tour with the minimal weight.
+
+   The heuristic does not require an edge between each pair of vertices.
+   If a construction does not find an unvisited adjacent vertex, it
+   continues from a random unvisited vertex, and a move that decreases the
+   number of tour edges that are not in the graph is an improving move.
+   A restart finds a tour only if all edges of its improved tour are in
+   the graph.
+
+   Each restart has its own random number sequence derived from a seed and
+   the index of the restart, and a tie between restarts is resolved by
+   the lower index, so that the result is a function of the seed and the
+   parameters and does not depend on the number of threads. The exact
+   solution in tsp can be used to validate the results on small graphs.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef TSP_HEUR_PTHREAD_H
+#define TSP_HEUR_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+   Copies to the block pointed to by dist the weight of a tour across all
+   vertices without revisiting, and copies the tour to the array pointed
+   to by tour starting from vertex 0, if a tour is found. Returns 0 if a
+   tour is found, otherwise returns 1.
+   a            : pointer to an undirected adjacency list with at least one
+                  vertex
+   tour         : pointer to a preallocated array of num_vts size_t
+                  vertices; the ith edge of a tour is (tour[i],
+                  tour[(i + 1) % num_vts])
+   dist         : pointer to a preallocated block of the size of a weight
+                  in the adjacency list
+   num_nbrs     : > 0 maximal number of vertices in a neighbor list
+   num_restarts : > 0 number of restarts
+   seed         : seed of the random number sequences of the restarts
+   num_threads  : > 0 number of threads
+   add_wt       : addition function which copies the sum of the weight
+                  values pointed to by the second and third arguments to
+                  the preallocated weight block pointed to by the first
+                  argument
+   cmp_wt       : comparison function which returns a negative integer
+                  value if the weight value pointed to by the first argument
+                  is less than the weight value pointed to by the second, a
+                  positive integer value if the weight value pointed to by
+                  the first argument is greater than the weight value
+                  pointed to by the second, and zero integer value if the
+                  two weight values are equal
+*/
+int tsp_heur_pthread(const adj_lst_t *a,
+		     size_t *tour,
+		     void *dist,
+		     size_t num_nbrs,
+		     size_t num_restarts,
+		     size_t seed,
+		     size_t num_threads,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs tsp_heur_pthread on a compressed sparse row (CSR) adjacency list.
+   Please see the parameter specification in tsp_heur_pthread.
+   c            : pointer to an undirected CSR adjacency list with at least
+                  one vertex
+*/
+int tsp_heur_pthread_csr(const adj_csr_t *c,
+			 size_t *tour,
+			 void *dist,
+			 size_t num_nbrs,
+			 size_t num_restarts,
+			 size_t seed,
+			 size_t num_threads,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *));
+
+#endif
@@ -0,0 +1,364 @@
+/**
+   tsp-pthread-test.c
+
+   Tests of an exact solution of TSP without vertex revisiting with
+   num_threads threads across default and division-based hash tables, by
+   comparing the tour lengths to the tour lengths computed by tsp.
+
+   The following command line arguments can be used to customize tests:
+   tsp-pthread-test:
+   -  [1, # bits in size_t) : a
+   -  [1, # bits in size_t) : b s.t. a <= |V| <= b for random graph test
+   -  [0, 8] : k for 2**k threads in the largest thread test
+   -  [0, 1] : on/off for random graph test
+
+   usage examples:
+   ./tsp-pthread-test
+   ./tsp-pthread-test 18 20
+   ./tsp-pthread-test 20 20 3 1
+
+   tsp-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 with the requirements that CHAR_BIT * sizeof(size_t) is greater
+   or equal to 16 and is even, and the pthreads API is available.
+*/
+
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "tsp-pthread.h"
+#include "tsp.h"
+#include "ht-divchn.h"
+#include "graph.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "tsp-pthread-test \n"
+  "[1, # bits in size_t) : a \n"
+  "[1, # bits in size_t) : b s.t. a <= |V| <= b for random graph test \n"
+  "[0, 8] : k for 2**k threads in the largest thread test \n"
+  "[0, 1] : on/off for random graph test \n";
+const int C_ARGC_MAX = 5;
+const size_t C_ARGS_DEF[4] = {1, 16, 2, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_THREADS_LOG_MAX = 8;
+
+/* hash table load factor upper bounds */
+const size_t C_ALPHA_N_DIVCHN = 1;
+const size_t C_LOG_ALPHA_D_DIVCHN = 0;
+
+/* random graph tests */
+const int C_ITER = 2;
+const int C_PROBS_COUNT = 3;
+const double C_PROBS[3] = {1.0000, 0.2500, 0.0000};
+const double C_PROB_ONE = 1.0;
+const double C_PROB_ZERO = 0.0;
+const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
+			      ((CHAR_BIT * sizeof(size_t) + 1) / 2));
+
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
+double timer();
+void print_test_result(int res);
+
+/**
+   Weight functions.
+*/
+
+void add_uint(void *sum, const void *a, const void *b){
+  *(size_t *)sum = *(size_t *)a + *(size_t *)b;
+}
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/**
+   Set the parameters of division-based hash table shards.
+*/
+
+void tht_divchn_init(tsp_ht_t *tht, ht_divchn_t *ht_divchn){
+  tht->ht = ht_divchn;
+  tht->alpha_n = C_ALPHA_N_DIVCHN;
+  tht->log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  tht->init = ht_divchn_init_helper;
+  tht->insert = ht_divchn_insert_helper;
+  tht->search = ht_divchn_search_helper;
+  tht->remove = ht_divchn_remove_helper;
+  tht->free = ht_divchn_free_helper;
+}
+
+/**
+   Construct adjacency lists of random directed graphs with random size_t
+   non-tour weights and a known tour of length equal to the number of
+   vertices.
+*/
+
+typedef struct{
+  double p;
+} bern_arg_t;
+
+int bern(void *arg){
+  bern_arg_t *b = arg;
+  if (b->p >= C_PROB_ONE) return 1;
+  if (b->p <= C_PROB_ZERO) return 0;
+  if (b->p > DRAND()) return 1;
+  return 0;
+}
+
+void add_dir_uint_edge(adj_lst_t *a,
+		       size_t u,
+		       size_t v,
+		       size_t wt_l,
+		       size_t wt_h,
+		       int (*bern)(void *),
+		       void *arg){
+  size_t rand_val = wt_l + DRAND() * (wt_h - wt_l);
+  adj_lst_add_dir_edge(a, u, v, &rand_val, bern, arg);
+}
+
+void adj_lst_rand_dir_wts(adj_lst_t *a,
+			  size_t n,
+			  size_t wt_l,
+			  size_t wt_h,
+			  int (*bern)(void *),
+			  void *arg){
+  size_t i, j;
+  graph_t g;
+  bern_arg_t arg_true;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  arg_true.p = C_PROB_ONE;
+  for (i = 0; i < n - 1; i++){
+    for (j = i + 1; j < n; j++){
+      if (n == 2){
+	add_dir_uint_edge(a, i, j, 1, 1, bern, &arg_true);
+	add_dir_uint_edge(a, j, i, 1, 1, bern, &arg_true);
+      }else if (j - i == 1){
+	add_dir_uint_edge(a, i, j, 1, 1, bern, &arg_true);
+	add_dir_uint_edge(a, j, i, wt_l, wt_h, bern, arg);
+      }else if (i == 0 && j == n - 1){
+	add_dir_uint_edge(a, i, j, wt_l, wt_h, bern, arg);
+	add_dir_uint_edge(a, j, i, 1, 1, bern, &arg_true);
+      }else{
+	add_dir_uint_edge(a, i, j, wt_l, wt_h, bern, arg);
+	add_dir_uint_edge(a, j, i, wt_l, wt_h, bern, arg);
+      }
+    }
+  }
+  graph_free(&g);
+}
+
+/**
+   Tests tsp_pthread with default and division-based hash tables on random
+   directed graphs with random size_t non-tour weights and a known tour.
+*/
+void run_rand_uint_test(int num_vts_start, int num_vts_end,
+			size_t log_threads){
+  int p, i, j;
+  int res = 1;
+  int ret = -1, ret_def = -1, ret_divchn = -1, ret_csr = -1;
+  size_t k, n, num_threads;
+  size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
+  size_t dist, dist_def, dist_divchn, dist_csr;
+  size_t *rand_start = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  bern_arg_t b;
+  ht_divchn_t *ht_divchns = NULL;
+  tsp_ht_t *thts = NULL;
+  double t;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  ht_divchns = malloc_perror(pow_two(log_threads), sizeof(ht_divchn_t));
+  thts = malloc_perror(pow_two(log_threads), sizeof(tsp_ht_t));
+  for (k = 0; k < pow_two(log_threads); k++){
+    tht_divchn_init(&thts[k], &ht_divchns[k]);
+  }
+  printf("Run a tsp_pthread test on random directed graphs \n"
+	 "with random size_t non-tour weights in [%lu, %lu]\n",
+	 TOLU(wt_l), TOLU(wt_h));
+  fflush(stdout);
+  for (p = 0; p < C_PROBS_COUNT; p++){
+    b.p = C_PROBS[p];
+    printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+    for (i = num_vts_start; i <= num_vts_end; i++){
+      n = i;
+      adj_lst_rand_dir_wts(&a, n, wt_l, wt_h, bern, &b);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+      }
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      t = timer();
+      for (j = 0; j < C_ITER; j++){
+	ret = tsp(&a, rand_start[j], &dist, NULL, add_uint, cmp_uint);
+      }
+      t = timer() - t;
+      printf("\t\t\ttsp default ht ave runtime:                   "
+	     "%.6f seconds\n", t / C_ITER);
+      res *= (ret == 0 && dist == (n == 1 ? 0 : n));
+      for (k = 0; k <= log_threads; k++){
+	num_threads = pow_two(k);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  ret_def = tsp_pthread(&a, rand_start[j], &dist_def, NULL,
+				num_threads, add_uint, cmp_uint);
+	}
+	t = timer() - t;
+	printf("\t\t\ttsp_pthread default ht, %3lu threads:          "
+	       "%.6f seconds\n", TOLU(num_threads), t / C_ITER);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  ret_divchn = tsp_pthread(&a, rand_start[j], &dist_divchn, thts,
+				   num_threads, add_uint, cmp_uint);
+	}
+	t = timer() - t;
+	printf("\t\t\ttsp_pthread ht_divchn shards, %3lu threads:    "
+	       "%.6f seconds\n", TOLU(num_threads), t / C_ITER);
+	t = timer();
+	for (j = 0; j < C_ITER; j++){
+	  ret_csr = tsp_pthread_csr(&c, rand_start[j], &dist_csr, NULL,
+				    num_threads, add_uint, cmp_uint);
+	}
+	t = timer() - t;
+	printf("\t\t\ttsp_pthread_csr default ht, %3lu threads:      "
+	       "%.6f seconds\n", TOLU(num_threads), t / C_ITER);
+	res *= (ret_def == ret && dist_def == dist);
+	res *= (ret_divchn == ret && dist_divchn == dist);
+	res *= (ret_csr == ret && dist_csr == dist);
+      }
+      printf("\t\t\tcorrectness:                                 ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+    }
+  }
+  free(rand_start);
+  free(ht_divchns);
+  free(thts);
+  rand_start = NULL;
+  ht_divchns = NULL;
+  thts = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / 1e6;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] < 1 ||
+      args[0] > C_FULL_BIT - 1 ||
+      args[1] < 1 ||
+      args[1] > C_FULL_BIT - 1 ||
+      args[1] < args[0] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]) run_rand_uint_test(args[0], args[1], args[2]);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,609 @@
+/**
+   tsp-pthread.c
+
+   An exact solution of TSP without vertex revisiting on graphs with generic
+   weights, including negative weights, with num_threads threads and
+   sharded hash tables.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition).
+
+   The algorithm is the algorithm of tsp, where the sets of the same size
+   are processed in parallel. A set, together with the last reached vertex,
+   is owned by a thread according to a hash value of its representation,
+   and the distance of the set is kept in the hash table shard of the
+   owner. A thread extends its sets of the current size and sends each
+   extended set with a distance as a request to the owner of the extended
+   set through a request buffer for each pair of threads, and after a
+   barrier each owner applies the requests to its shard. Because a shard
+   is only accessed by its owner, a shard is a non-concurrent hash table
+   and no locks or atomic operations are used. The sets of a size are
+   processed in rounds of a bounded number of sets per thread to bound the
+   space of the request buffers.
+
+   The hash table parameter specifies an array of num_threads hash tables
+   used as shards. If NULL is passed as a hash table parameter value, a
+   default hash table is used and shared by the threads, which contains an
+   array with a count that is equal to n * 2^n, where n is the number of
+   vertices in the graph, and where each thread only accesses the entries
+   of its sets.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "tsp-pthread.h"
+#include "tsp.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+typedef enum{FALSE, TRUE} boolean_t;
+
+typedef struct{
+  size_t key_size;
+  size_t elt_size;
+  size_t num_vts;
+  boolean_t *key_present;
+  void *elts;
+  void (*free_elt)(void *);
+} ht_def_t;
+
+typedef struct{
+  size_t ix; /* index of the set element with a single set bit */
+  size_t bit; /* set element with a single set bit */
+} ibit_t;
+
+typedef struct{
+  size_t num_threads;
+  size_t set_count;           /* count of size_t in a set representation */
+  size_t set_size;
+  size_t req_size;            /* set and distance of a request */
+  size_t start;
+  const adj_view_t *a;
+  const tsp_ht_t *thts;       /* per thread shard */
+  int *more;                  /* per thread, non-zero if sets remain */
+  int *found;                 /* per thread, non-zero if a tour is found */
+  void *dists;                /* per thread, shortest tour found */
+  stack_t *reqs;              /* [src * num_threads + dst] */
+  barrier_t barrier;
+  void (*add_wt)(void *, const void *, const void *);
+  int (*cmp_wt)(const void *, const void *);
+} tspp_t;
+
+typedef struct{
+  size_t id;
+  tspp_t *d;
+} tspp_arg_t;
+
+static const size_t C_SET_ELT_SIZE = sizeof(size_t);
+static const size_t C_SET_ELT_BIT = CHAR_BIT * sizeof(size_t);
+static const size_t C_ROUND_COUNT = 4096; /* sets per thread in a round */
+static const size_t C_HASH_MUL = 0x9e3779b1;
+static const size_t C_STACK_INIT_COUNT = 1;
+
+/* set operations based on a bit array representation */
+static void set_init(ibit_t *ibit, size_t n);
+static size_t *set_member(const ibit_t *ibit, const size_t *set);
+static void set_union(const ibit_t *ibit, size_t *set);
+
+/* default hash table operations */
+static void ht_def_init(void *ht,
+			size_t key_size,
+			size_t elt_size,
+			size_t min_num,
+			size_t alpha_n,
+			size_t log_alpha_d,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t),
+			void (*free_elt)(void *));
+static void ht_def_insert(void *ht, const void *key, const void *elt);
+static void *ht_def_search(const void *ht, const void *key);
+static void ht_def_remove(void *ht, const void *key, void *elt);
+static void ht_def_free(void *ht);
+
+static int tsp_pthread_view(const adj_view_t *a,
+			    size_t start,
+			    void *dist,
+			    const tsp_ht_t *thts,
+			    size_t num_threads,
+			    void (*add_wt)(void *, const void *, const void *),
+			    int (*cmp_wt)(const void *, const void *));
+
+/* auxiliary functions */
+static void *tsp_thread(void *arg);
+static void send(tspp_t *d,
+		 size_t id,
+		 const size_t *set,
+		 const void *wt,
+		 char *req,
+		 void *sum_wt);
+static void apply(tspp_t *d,
+		  size_t id,
+		  stack_t *next_s,
+		  size_t *set,
+		  void *wt);
+static size_t owner(const tspp_t *d, const size_t *set);
+static size_t pow_two(size_t k);
+static void fprintf_stderr_exit(const char *s, int line);
+static void *ptr(const void *block, size_t i, size_t size);
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with num_threads threads. Returns 0 if a tour exists, otherwise returns
+   1.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated block of the size of a weight in
+                 the adjacency list
+   thts        : - NULL pointer, if a default hash table is used for
+                 set hashing operations; please see the specification of
+                 a default hash table in tsp
+                 - a pointer to an array of num_threads sets of parameters
+                 specifying num_threads distinct hash tables; please see the
+                 specification of a hash table parameter in tsp
+   num_threads : > 0 number of threads
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+int tsp_pthread(const adj_lst_t *a,
+		size_t start,
+		void *dist,
+		const tsp_ht_t *thts,
+		size_t num_threads,
+		void (*add_wt)(void *, const void *, const void *),
+		int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return tsp_pthread_view(&w, start, dist, thts, num_threads,
+			  add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_pthread on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_pthread.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+int tsp_pthread_csr(const adj_csr_t *c,
+		    size_t start,
+		    void *dist,
+		    const tsp_ht_t *thts,
+		    size_t num_threads,
+		    void (*add_wt)(void *, const void *, const void *),
+		    int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return tsp_pthread_view(&w, start, dist, thts, num_threads,
+			  add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_pthread on a view of an adjacency list. The caller thread runs
+   as the thread with id 0. If the default hash table is used, each thread
+   accesses the default hash table through its own copy of the parameters.
+*/
+static int tsp_pthread_view(const adj_view_t *a,
+			    size_t start,
+			    void *dist,
+			    const tsp_ht_t *thts,
+			    size_t num_threads,
+			    void (*add_wt)(void *, const void *, const void *),
+			    int (*cmp_wt)(const void *, const void *)){
+  boolean_t found = FALSE;
+  size_t i;
+  size_t num_reqs = mul_sz_perror(num_threads, num_threads);
+  void *wt = NULL;
+  pthread_t *tids = NULL;
+  tsp_ht_t *thts_def = NULL;
+  ht_def_t ht_def;
+  tspp_t d;
+  tspp_arg_t *args = NULL;
+  d.num_threads = num_threads;
+  d.set_count = a->num_vts / C_SET_ELT_BIT;
+  if (a->num_vts % C_SET_ELT_BIT){
+    d.set_count++;
+  }
+  d.set_count++; /* + last reached vertex representation */
+  d.set_size = d.set_count * C_SET_ELT_SIZE;
+  d.req_size = add_sz_perror(d.set_size, a->wt_size);
+  d.start = start;
+  d.a = a;
+  d.more = malloc_perror(num_threads, sizeof(int));
+  d.found = malloc_perror(num_threads, sizeof(int));
+  d.dists = malloc_perror(num_threads, a->wt_size);
+  d.reqs = malloc_perror(num_reqs, sizeof(stack_t));
+  d.add_wt = add_wt;
+  d.cmp_wt = cmp_wt;
+  memset(dist, 0, a->wt_size);
+  if (thts == NULL){
+    ht_def.num_vts = a->num_vts; /* sets the count of the default table */
+    thts_def = malloc_perror(num_threads, sizeof(tsp_ht_t));
+    for (i = 0; i < num_threads; i++){
+      thts_def[i].ht = &ht_def;
+      thts_def[i].alpha_n = 1;
+      thts_def[i].log_alpha_d = 0;
+      thts_def[i].init = ht_def_init;
+      thts_def[i].insert = ht_def_insert;
+      thts_def[i].search = ht_def_search;
+      thts_def[i].remove = ht_def_remove;
+      thts_def[i].free = ht_def_free;
+    }
+    ht_def_init(&ht_def, d.set_size, a->wt_size, 0, 1, 0, NULL, NULL, NULL);
+    d.thts = thts_def;
+  }else{
+    for (i = 0; i < num_threads; i++){
+      thts[i].init(thts[i].ht,
+		   d.set_size,
+		   a->wt_size,
+		   0,
+		   thts[i].alpha_n,
+		   thts[i].log_alpha_d,
+		   NULL,
+		   NULL,
+		   NULL);
+    }
+    d.thts = thts;
+  }
+  for (i = 0; i < num_reqs; i++){
+    stack_init(&d.reqs[i], C_STACK_INIT_COUNT, d.req_size, NULL);
+  }
+  barrier_init_perror(&d.barrier, num_threads);
+  tids = malloc_perror(num_threads, sizeof(pthread_t));
+  args = malloc_perror(num_threads, sizeof(tspp_arg_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].d = &d;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&tids[i], tsp_thread, &args[i]);
+  }
+  tsp_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(tids[i], NULL);
+  }
+  for (i = 0; i < num_threads; i++){
+    if (!d.found[i]) continue;
+    wt = ptr(d.dists, i, a->wt_size);
+    if (!found || cmp_wt(dist, wt) > 0){
+      memcpy(dist, wt, a->wt_size);
+      found = TRUE;
+    }
+  }
+  if (thts == NULL){
+    ht_def_free(&ht_def);
+  }else{
+    for (i = 0; i < num_threads; i++){
+      thts[i].free(thts[i].ht);
+    }
+  }
+  for (i = 0; i < num_reqs; i++){
+    stack_free(&d.reqs[i]);
+  }
+  free(d.more);
+  free(d.found);
+  free(d.dists);
+  free(d.reqs);
+  free(thts_def);
+  free(tids);
+  free(args);
+  d.more = NULL;
+  d.found = NULL;
+  d.dists = NULL;
+  d.reqs = NULL;
+  thts_def = NULL;
+  tids = NULL;
+  args = NULL;
+  if (!found && a->num_vts > 1) return 1;
+  return 0;
+}
+
+/**
+   Runs a thread of tsp_pthread. For each set size, a thread processes its
+   sets in rounds, where in a round a thread i) sends the extended sets of
+   at most C_ROUND_COUNT of its sets, and after a barrier ii) applies the
+   requests sent to the thread, and after a barrier iii) tests if any
+   thread has remaining sets. A per thread value is written again only
+   after another barrier that follows all reads of the value.
+*/
+static void *tsp_thread(void *arg){
+  int any;
+  size_t id = ((tspp_arg_t *)arg)->id;
+  size_t i, j, u, v, num_vt_wts;
+  size_t *set = NULL;
+  const char *p = NULL, *p_end = NULL;
+  char *req = NULL;
+  void *wt = NULL, *sum_wt = NULL;
+  tspp_t *d = ((tspp_arg_t *)arg)->d;
+  const adj_view_t *a = d->a;
+  const tsp_ht_t *tht = &d->thts[id];
+  stack_t prev_s, next_s, t;
+  set = calloc_perror(1, d->set_size);
+  req = malloc_perror(1, d->req_size);
+  wt = malloc_perror(1, a->wt_size);
+  sum_wt = malloc_perror(1, a->wt_size);
+  stack_init(&prev_s, C_STACK_INIT_COUNT, d->set_size, NULL);
+  stack_init(&next_s, C_STACK_INIT_COUNT, d->set_size, NULL);
+  set[0] = d->start;
+  if (owner(d, set) == id){
+    memset(wt, 0, a->wt_size);
+    tht->insert(tht->ht, set, wt);
+    stack_push(&prev_s, set);
+  }
+  for (i = 0; i + 1 < a->num_vts; i++){
+    for (;;){
+      for (j = 0; j < C_ROUND_COUNT && prev_s.num_elts > 0; j++){
+	stack_pop(&prev_s, set);
+	tht->remove(tht->ht, set, wt);
+	send(d, id, set, wt, req, sum_wt);
+      }
+      barrier_wait_perror(&d->barrier);
+      apply(d, id, &next_s, set, wt);
+      d->more[id] = (prev_s.num_elts > 0);
+      barrier_wait_perror(&d->barrier);
+      any = 0;
+      for (j = 0; j < d->num_threads; j++){
+	any = any || d->more[j];
+      }
+      if (!any) break;
+    }
+    t = prev_s;
+    prev_s = next_s;
+    next_s = t;
+  }
+  /* compute the return to start */
+  d->found[id] = 0;
+  while (prev_s.num_elts > 0){
+    stack_pop(&prev_s, set);
+    u = set[0];
+    p = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p + num_vt_wts * a->pair_size;
+    for (; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      if (v == d->start){
+	d->add_wt(sum_wt, tht->search(tht->ht, set), p + a->wt_offset);
+	if (!d->found[id] ||
+	    d->cmp_wt(ptr(d->dists, id, a->wt_size), sum_wt) > 0){
+	  memcpy(ptr(d->dists, id, a->wt_size), sum_wt, a->wt_size);
+	  d->found[id] = 1;
+	}
+      }
+    }
+  }
+  stack_free(&prev_s);
+  stack_free(&next_s);
+  free(set);
+  free(req);
+  free(wt);
+  free(sum_wt);
+  set = NULL;
+  req = NULL;
+  wt = NULL;
+  sum_wt = NULL;
+  return NULL;
+}
+
+/**
+   Sends each extension of a set with a distance wt by an adjacent vertex
+   of the last reached vertex as a request to the owner of the extended
+   set. The req and sum_wt parameters point to blocks of size req_size
+   and wt_size.
+*/
+static void send(tspp_t *d,
+		 size_t id,
+		 const size_t *set,
+		 const void *wt,
+		 char *req,
+		 void *sum_wt){
+  size_t u, v, num_vt_wts;
+  size_t *next_set = (size_t *)req; /* req is aligned by malloc */
+  const adj_view_t *a = d->a;
+  const char *p = NULL, *p_end = NULL;
+  ibit_t ibit;
+  u = set[0];
+  p = a->vt_wts(a->adj, u, &num_vt_wts);
+  p_end = p + num_vt_wts * a->pair_size;
+  for (; p != p_end; p += a->pair_size){
+    v = a->read_vt(p);
+    set_init(&ibit, v);
+    if (set_member(&ibit, &set[1]) == NULL){
+      memcpy(next_set, set, d->set_size);
+      next_set[0] = v;
+      set_init(&ibit, u);
+      set_union(&ibit, &next_set[1]);
+      d->add_wt(sum_wt, wt, p + a->wt_offset);
+      memcpy(req + d->set_size, sum_wt, a->wt_size);
+      stack_push(&d->reqs[id * d->num_threads + owner(d, next_set)], req);
+    }
+  }
+}
+
+/**
+   Applies the requests sent to a thread to the shard of the thread, and
+   pushes each set that is new in the shard into next_s. The set and wt
+   parameters point to blocks of size set_size and wt_size for copying a
+   requested set and distance.
+*/
+static void apply(tspp_t *d,
+		  size_t id,
+		  stack_t *next_s,
+		  size_t *set,
+		  void *wt){
+  size_t i, j;
+  const tsp_ht_t *tht = &d->thts[id];
+  const char *p = NULL;
+  void *next_wt = NULL;
+  stack_t *r = NULL;
+  for (i = 0; i < d->num_threads; i++){
+    r = &d->reqs[i * d->num_threads + id];
+    p = r->elts;
+    for (j = 0; j < r->num_elts; j++){
+      memcpy(set, p, d->set_size);
+      memcpy(wt, p + d->set_size, d->a->wt_size);
+      next_wt = tht->search(tht->ht, set);
+      if (next_wt == NULL){
+	tht->insert(tht->ht, set, wt);
+	stack_push(next_s, set);
+      }else if (d->cmp_wt(next_wt, wt) > 0){
+	tht->insert(tht->ht, set, wt);
+      }
+      p += d->req_size;
+    }
+    r->num_elts = 0;
+  }
+}
+
+/**
+   Returns the thread that owns a set.
+*/
+static size_t owner(const tspp_t *d, const size_t *set){
+  size_t i;
+  size_t h = 0;
+  for (i = 0; i < d->set_count; i++){
+    h = h * C_HASH_MUL + set[i];
+  }
+  h ^= h >> (C_SET_ELT_BIT / 2);
+  return h % d->num_threads;
+}
+
+/**
+   Set operations based on a bit array representation.
+*/
+
+static void set_init(ibit_t *ibit, size_t n){
+  ibit->ix = n / C_SET_ELT_BIT;
+  ibit->bit = 1;
+  ibit->bit <<= n % C_SET_ELT_BIT;
+}
+
+static size_t *set_member(const ibit_t *ibit, const size_t *set){
+  if (set[ibit->ix] & ibit->bit){
+    return (size_t *)(&set[ibit->ix]);
+  }else{
+    return NULL;
+  }
+}
+
+static void set_union(const ibit_t *ibit, size_t *set){
+  set[ibit->ix] |= ibit->bit;
+}
+
+/**
+   Default hash table operations. The entries of distinct sets are distinct
+   objects, and the threads access the default hash table without locks.
+*/
+
+static void ht_def_init(void *ht,
+			size_t key_size,
+			size_t elt_size,
+			size_t min_num,
+			size_t alpha_n,
+			size_t log_alpha_d,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t),
+			void (*free_elt)(void *)){
+  ht_def_t *htd = ht; /* num_vts is set before initialization */
+  if (htd->num_vts >= C_SET_ELT_BIT){
+    fprintf_stderr_exit("default hash table allocation failed", __LINE__);
+  }
+  htd->key_size = key_size;
+  htd->elt_size = elt_size;
+  htd->key_present = calloc_perror(mul_sz_perror(htd->num_vts,
+						 pow_two(htd->num_vts)),
+				   sizeof(boolean_t));
+  htd->elts = malloc_perror(mul_sz_perror(htd->num_vts,
+					  pow_two(htd->num_vts)),
+			    elt_size);
+  htd->free_elt = free_elt;
+  (void)min_num;
+  (void)alpha_n;
+  (void)log_alpha_d;
+  (void)cmp_key;
+  (void)rdc_key;
+}
+
+static void ht_def_insert(void *ht, const void *key, const void *elt){
+  ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  htd->key_present[ix] = TRUE;
+  memcpy(ptr(htd->elts, ix, htd->elt_size),
+	 elt,
+	 htd->elt_size);
+}
+
+static void *ht_def_search(const void *ht, const void *key){
+  const ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  if (htd->key_present[ix]){
+    return ptr(htd->elts, ix, htd->elt_size);
+  }else{
+    return NULL;
+  }
+}
+
+static void ht_def_remove(void *ht, const void *key, void *elt){
+  ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  htd->key_present[ix] = FALSE;
+  memcpy(elt,
+	 ptr(htd->elts, ix, htd->elt_size),
+	 htd->elt_size);
+}
+
+static void ht_def_free(void *ht){
+  size_t i;
+  ht_def_t *htd = ht;
+  if (htd->free_elt != NULL){
+    for (i = 0; i < htd->num_vts * pow_two(htd->num_vts); i++){
+      if (htd->key_present[i]){
+	htd->free_elt(ptr(htd->elts, i, htd->elt_size));
+      }
+    }
+  }
+  free(htd->key_present);
+  free(htd->elts);
+  htd->key_present = NULL;
+  htd->elts = NULL;
+}
+
+/**
+   Returns the kth power of 2, where 0 <= k < C_SET_ELT_BIT.
+*/
+static size_t pow_two(size_t k){
+  size_t ret = 1;
+  return ret << k;
+}
+
+/**
+   Prints an error message and exits.
+*/
+static void fprintf_stderr_exit(const char *s, int line){
+  fprintf(stderr, "%s in %s at line %d\n", s,  __FILE__, line);
+  exit(EXIT_FAILURE);
+}
+
+/**
+   Computes a pointer to an entry in an array of entries of size size.
+*/
+static void *ptr(const void *block, size_t i, size_t size){
+  return (void *)((char *)block + i * size);
+}
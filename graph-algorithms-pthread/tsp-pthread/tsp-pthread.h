@@ -0,0 +1,92 @@
+/**
+   tsp-pthread.h
+
+   Declarations of accessible functions for running an exact solution of
+   TSP without vertex revisiting on graphs with generic weights, including
+   negative weights, with num_threads threads and sharded hash tables.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition).
+
+   The algorithm is the algorithm of tsp, where the sets of the same size
+   are processed in parallel. A set, together with the last reached vertex,
+   is owned by a thread according to a hash value of its representation,
+   and the distance of the set is kept in the hash table shard of the
+   owner. A thread extends its sets of the current size and sends each
+   extended set with a distance as a request to the owner of the extended
+   set through a request buffer for each pair of threads, and after a
+   barrier each owner applies the requests to its shard. Because a shard
+   is only accessed by its owner, a shard is a non-concurrent hash table
+   and no locks or atomic operations are used. The sets of a size are
+   processed in rounds of a bounded number of sets per thread to bound the
+   space of the request buffers.
+
+   The hash table parameter specifies an array of num_threads hash tables
+   used as shards. If NULL is passed as a hash table parameter value, a
+   default hash table is used and shared by the threads, which contains an
+   array with a count that is equal to n * 2^n, where n is the number of
+   vertices in the graph, and where each thread only accesses the entries
+   of its sets.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirement that the pthreads API is available.
+*/
+
+#ifndef TSP_PTHREAD_H  
+#define TSP_PTHREAD_H
+
+#include <stddef.h>
+#include "graph.h"
+#include "tsp.h"
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with num_threads threads. Returns 0 if a tour exists, otherwise returns
+   1.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated block of the size of a weight in
+                 the adjacency list
+   thts        : - NULL pointer, if a default hash table is used for
+                 set hashing operations; please see the specification of
+                 a default hash table in tsp
+                 - a pointer to an array of num_threads sets of parameters
+                 specifying num_threads distinct hash tables; please see the
+                 specification of a hash table parameter in tsp
+   num_threads : > 0 number of threads
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+int tsp_pthread(const adj_lst_t *a,
+		size_t start,
+		void *dist,
+		const tsp_ht_t *thts,
+		size_t num_threads,
+		void (*add_wt)(void *, const void *, const void *),
+		int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs tsp_pthread on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_pthread.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+int tsp_pthread_csr(const adj_csr_t *c,
+		    size_t start,
+		    void *dist,
+		    const tsp_ht_t *thts,
+		    size_t num_threads,
+		    void (*add_wt)(void *, const void *, const void *),
+		    int (*cmp_wt)(const void *, const void *));
+
+#endif
@@ -0,0 +1,464 @@
+/**
+   astar-test.c
+
+   Tests of the A* algorithm with a hash table parameter and a heuristic
+   parameter on a small graph with a zero heuristic and on random
+   geometric graphs with a Euclidean heuristic, by comparing the distances
+   to the distances computed by Dijkstra's algorithm.
+
+   The following command line arguments can be used to customize tests:
+   astar-test:
+   -  [0, # bits in size_t / 2] : n for 2^n vertices in the smallest graph
+   -  [0, # bits in size_t / 2] : n for 2^n vertices in the largest graph
+   -  [0, 1] : small graph test on/off
+   -  [0, 1] : random geometric graph test on/off
+
+   usage examples:
+   ./astar-test
+   ./astar-test 10 14
+   ./astar-test 14 14 0 1
+
+   astar-test can be run with any subset of command line arguments in the
+   above-defined order. If the (i + 1)th argument is specified then the ith
+   argument must be specified for i >= 0. Default values are used for the
+   unspecified arguments, which are 0 for the first argument, 12 for the
+   second argument, and 1 for the following arguments.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the only requirement that CHAR_BIT * sizeof(size_t)
+   is greater or equal to 16 and is even.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include "astar.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "ht-muloa.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "astar-test \n"
+  "[0, # bits in size_t / 2] : n for 2^n vertices in smallest graph\n"
+  "[0, # bits in size_t / 2] : n for 2^n vertices in largest graph\n"
+  "[0, 1] : small graph test on/off\n"
+  "[0, 1] : random geometric graph test on/off\n";
+const int C_ARGC_MAX = 5;
+const size_t C_ARGS_DEF[4] = {0, 12, 1, 1};
+
+/* hash table load factor upper bound */
+const size_t C_ALPHA_N_MULOA = 13107;
+const size_t C_LOG_ALPHA_D_MULOA = 15;
+
+/* small graph test */
+const size_t C_NUM_VTS = 5;
+const size_t C_NUM_ES = 4;
+const size_t C_U[4] = {0, 0, 0, 1};
+const size_t C_V[4] = {1, 2, 3, 3};
+const size_t C_WTS_UINT[4] = {4, 3, 2, 1};
+
+/* random geometric graph test */
+const int C_ITER = 10;
+const double C_RAD_MULS[3] = {1.0, 2.0, 4.0}; /* of connectivity radius */
+const int C_RAD_MULS_COUNT = 3;
+const double C_REL_ERR = 1e-9;
+const double C_PI = 3.14159265358979;
+
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_SIZE_MAX = (size_t)-1;
+
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
+void print_test_result(int res);
+
+/**
+   Run a test on a small graph with size_t weights and a zero heuristic.
+*/
+
+void add_uint(void *sum, const void *wt_a, const void *wt_b){
+  *(size_t *)sum = *(size_t *)wt_a + *(size_t *)wt_b;
+}
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+void zero_uint(void *wt, size_t u, const void *arg){
+  *(size_t *)wt = 0;
+  (void)u;
+  (void)arg;
+}
+
+void hht_muloa_init(heap_ht_t *hht, ht_muloa_t *ht_muloa){
+  hht->ht = ht_muloa;
+  hht->alpha_n = C_ALPHA_N_MULOA;
+  hht->log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  hht->init = ht_muloa_init_helper;
+  hht->align = ht_muloa_align_helper;
+  hht->insert = ht_muloa_insert_helper;
+  hht->search = ht_muloa_search_helper;
+  hht->remove = ht_muloa_remove_helper;
+  hht->free = ht_muloa_free_helper;
+}
+
+void run_uint_graph_test(){
+  int res = 1;
+  size_t i, j;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *dist_a = NULL, *prev_a = NULL;
+  graph_t g;
+  adj_lst_t a;
+  ht_muloa_t ht_muloa;
+  heap_ht_t hht;
+  dist = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  prev = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  dist_a = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  prev_a = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  graph_base_init(&g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
+  g.num_es = C_NUM_ES;
+  g.u = malloc_perror(g.num_es, g.vt_size);
+  g.v = malloc_perror(g.num_es, g.vt_size);
+  g.wts = malloc_perror(g.num_es, g.wt_size);
+  memcpy(g.u, C_U, g.num_es * g.vt_size);
+  memcpy(g.v, C_V, g.num_es * g.vt_size);
+  memcpy(g.wts, C_WTS_UINT, g.num_es * g.wt_size);
+  hht_muloa_init(&hht, &ht_muloa);
+  printf("Run an astar test on a small graph with size_t weights and a "
+	 "zero heuristic\n");
+  adj_lst_base_init(&a, &g);
+  adj_lst_dir_build(&a, &g);
+  for (i = 0; i < a.num_vts; i++){
+    dijkstra(&a, i, dist, prev, NULL, add_uint, cmp_uint);
+    for (j = 0; j < a.num_vts; j++){
+      astar(&a, i, j, dist_a, prev_a, NULL, zero_uint, NULL,
+	    add_uint, cmp_uint);
+      res *= (prev_a[j] == prev[j]);
+      res *= (prev[j] == C_SIZE_MAX || dist_a[j] == dist[j]);
+      astar(&a, i, j, dist_a, prev_a, &hht, zero_uint, NULL,
+	    add_uint, cmp_uint);
+      res *= (prev_a[j] == prev[j]);
+      res *= (prev[j] == C_SIZE_MAX || dist_a[j] == dist[j]);
+    }
+  }
+  printf("\tdirected graph, default and ht_muloa hash tables: ");
+  print_test_result(res);
+  adj_lst_free(&a);
+  graph_free(&g);
+  free(dist);
+  free(prev);
+  free(dist_a);
+  free(prev_a);
+  dist = NULL;
+  prev = NULL;
+  dist_a = NULL;
+  prev_a = NULL;
+}
+
+/**
+   Run a test on random geometric graphs with Euclidean double weights and
+   a Euclidean heuristic. The vertices are random points in a unit square,
+   and an undirected edge connects two points within a radius, which is a
+   multiple of sqrt(log(n) / (pi n)).
+*/
+
+typedef struct{
+  size_t target;
+  const double *x;
+  const double *y;
+} heu_arg_t;
+
+void add_double(void *sum, const void *wt_a, const void *wt_b){
+  *(double *)sum = *(double *)wt_a + *(double *)wt_b;
+}
+
+int cmp_double(const void *a, const void *b){
+  if (*(double *)a > *(double *)b){
+    return 1;
+  }else if (*(double *)a < *(double *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+double euclid(const double *x, const double *y, size_t u, size_t v){
+  return sqrt((x[u] - x[v]) * (x[u] - x[v]) + (y[u] - y[v]) * (y[u] - y[v]));
+}
+
+void euclid_heu(void *wt, size_t u, const void *arg){
+  const heu_arg_t *ha = arg;
+  *(double *)wt = euclid(ha->x, ha->y, u, ha->target);
+}
+
+int bern_one(void *arg){
+  (void)arg;
+  return 1;
+}
+
+void adj_lst_rand_geo(adj_lst_t *a,
+		      double *x,
+		      double *y,
+		      size_t n,
+		      double rad){
+  size_t i, j;
+  double wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(double),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n; i++){
+    x[i] = DRAND();
+    y[i] = DRAND();
+  }
+  for (i = 0; i < n; i++){
+    for (j = i + 1; j < n; j++){
+      wt = euclid(x, y, i, j);
+      if (wt <= rad) adj_lst_add_undir_edge(a, i, j, &wt, bern_one, NULL);
+    }
+  }
+  graph_free(&g);
+}
+
+int same_dist(double a, double b){
+  double d = (a > b) ? a - b : b - a;
+  return d <= C_REL_ERR * ((a > b) ? a : b);
+}
+
+void run_geo_test(int pow_start, int pow_end){
+  int i, j, k;
+  int res = 1;
+  size_t n;
+  size_t num_dijkstra, num_astar;
+  size_t *rand_start = NULL, *rand_target = NULL;
+  size_t *prev = NULL, *prev_a = NULL;
+  size_t *ref_prev = NULL;
+  double rad;
+  double *x = NULL, *y = NULL;
+  double *dist = NULL, *dist_a = NULL;
+  double *ref_dist = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  heu_arg_t ha;
+  dijkstra_ws_t ws;
+  clock_t t_dijkstra, t_astar, t_astar_csr;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  rand_target = malloc_perror(C_ITER, sizeof(size_t));
+  ref_dist = malloc_perror(C_ITER, sizeof(double));
+  ref_prev = malloc_perror(C_ITER, sizeof(size_t));
+  x = malloc_perror(pow_two(pow_end), sizeof(double));
+  y = malloc_perror(pow_two(pow_end), sizeof(double));
+  dist = malloc_perror(pow_two(pow_end), sizeof(double));
+  dist_a = malloc_perror(pow_two(pow_end), sizeof(double));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev_a = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  ha.x = x;
+  ha.y = y;
+  printf("Run an astar test on random geometric graphs with Euclidean "
+	 "double weights and a Euclidean heuristic\n");
+  fflush(stdout);
+  for (k = 0; k < C_RAD_MULS_COUNT; k++){
+    printf("\tradius: %.1f * sqrt(log(n) / (pi n))\n", C_RAD_MULS[k]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      rad = C_RAD_MULS[k] * sqrt(log((double)n + 1.0) / (C_PI * n));
+      adj_lst_rand_geo(&a, x, y, n, rad);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+	rand_target[j] = RANDOM() % n;
+      }
+      num_dijkstra = 0;
+      num_astar = 0;
+      dijkstra_ws_init(&ws, n, sizeof(double), NULL, cmp_double);
+      t_dijkstra = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws_target(&a, rand_start[j], rand_target[j], dist, prev,
+			   &ws, add_double, cmp_double);
+	num_dijkstra += ws.vts.num_elts;
+	ref_dist[j] = dist[rand_target[j]];
+	ref_prev[j] = prev[rand_target[j]];
+      }
+      t_dijkstra = clock() - t_dijkstra;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_init(&ws, n, sizeof(double), NULL, cmp_double);
+      t_astar = clock();
+      for (j = 0; j < C_ITER; j++){
+	ha.target = rand_target[j];
+	astar_ws(&a, rand_start[j], rand_target[j], dist_a, prev_a, &ws,
+		 euclid_heu, &ha, add_double, cmp_double);
+	num_astar += ws.vts.num_elts;
+	res *= ((prev_a[rand_target[j]] == C_SIZE_MAX) ==
+		(ref_prev[j] == C_SIZE_MAX));
+	res *= (ref_prev[j] == C_SIZE_MAX ||
+		same_dist(dist_a[rand_target[j]], ref_dist[j]));
+      }
+      t_astar = clock() - t_astar;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_init(&ws, n, sizeof(double), NULL, cmp_double);
+      t_astar_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	ha.target = rand_target[j];
+	astar_ws_csr(&c, rand_start[j], rand_target[j], dist_a, prev_a, &ws,
+		     euclid_heu, &ha, add_double, cmp_double);
+	res *= ((prev_a[rand_target[j]] == C_SIZE_MAX) ==
+		(ref_prev[j] == C_SIZE_MAX));
+	res *= (ref_prev[j] == C_SIZE_MAX ||
+		same_dist(dist_a[rand_target[j]], ref_dist[j]));
+      }
+      t_astar_csr = clock() - t_astar_csr;
+      dijkstra_ws_free(&ws);
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      printf("\t\t\tdijkstra_ws_target ave runtime: %.8f seconds, "
+	     "ave reached: %lu\n"
+	     "\t\t\tastar_ws ave runtime:           %.8f seconds, "
+	     "ave reached: %lu\n"
+	     "\t\t\tastar_ws_csr ave runtime:       %.8f seconds\n",
+	     (float)t_dijkstra / C_ITER / CLOCKS_PER_SEC,
+	     TOLU(num_dijkstra / C_ITER),
+	     (float)t_astar / C_ITER / CLOCKS_PER_SEC,
+	     TOLU(num_astar / C_ITER),
+	     (float)t_astar_csr / C_ITER / CLOCKS_PER_SEC);
+      printf("\t\t\tcorrectness:                    ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_csr_free(&c);
+    }
+  }
+  free(rand_start);
+  free(rand_target);
+  free(ref_dist);
+  free(ref_prev);
+  free(x);
+  free(y);
+  free(dist);
+  free(dist_a);
+  free(prev);
+  free(prev_a);
+  rand_start = NULL;
+  rand_target = NULL;
+  ref_dist = NULL;
+  ref_prev = NULL;
+  x = NULL;
+  y = NULL;
+  dist = NULL;
+  dist_a = NULL;
+  prev = NULL;
+  prev_a = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Printing functions.
+*/
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > 1 ||
+      args[3] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[2]) run_uint_graph_test();
+  if (args[3]) run_geo_test(args[0], args[1]);
+  free(args);
+  args = NULL;
+  return 0;
+}
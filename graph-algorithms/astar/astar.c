@@ -0,0 +1,248 @@
+/**
+   astar.c
+
+   The A* algorithm on
+   graphs with generic non-negative weights, a hash table parameter, and a
+   heuristic parameter.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The weight functions and the hash table
+   parameter are as in dijkstra.
+
+   The heuristic parameter provides an estimate of the weight of a
+   shortest path from a vertex to the target. A vertex is popped from the
+   heap in the order of the sum of its distance from start and its
+   estimate. If the estimate is admissible, i.e. is not greater than the
+   weight of a shortest path to the target, then the distance of the target
+   is the weight of a shortest path when the target is popped. If the
+   estimate is also consistent, i.e. is not greater than the weight of an
+   edge (u, v) plus the estimate at v for each vertex u, then each vertex
+   is popped at most once, and otherwise a vertex is pushed again when its
+   distance decreases after it was popped. A zero estimate results in
+   dijkstra_ws_target.
+
+   A* runs with a workspace of Dijkstra's algorithm that is allocated once
+   per thread and is reset in O(number of vertices reached in the previous
+   run) time.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "astar.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "heap.h"
+#include "stack.h"
+
+static const size_t C_NREACHED = (size_t)-1; /* not reached as index */
+
+static void astar_view(const adj_view_t *a,
+		       size_t start,
+		       size_t target,
+		       void *dist,
+		       size_t *prev,
+		       dijkstra_ws_t *ws,
+		       void (*heu_wt)(void *, size_t, const void *),
+		       const void *heu_arg,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *));
+
+/* functions for computing pointers */
+static void *wt_ptr(const void *wts, size_t i, size_t wt_size);
+
+/**
+   Computes and copies the shortest distance from start to target to the
+   array pointed to by dist at target, and the previous vertices on the
+   path from target to start to the array pointed to by prev. The prev
+   array has the maximal value of size_t at target if target is not
+   reachable from start. The entries at other vertices are only specified
+   for the vertices on the path. The dist and prev parameters point to the
+   same arrays in each run with a workspace, and between runs the caller
+   may read but not modify the arrays.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   target      : target vertex
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   ws          : pointer to a workspace initialized with dijkstra_ws_init
+                 with the number of vertices and the weight size of the
+                 adjacency list
+   heu_wt      : heuristic function which copies the estimate of the weight
+                 of a shortest path from the vertex provided by the second
+                 argument to the target to the preallocated weight block
+                 pointed to by the first argument; the third argument is
+                 heu_arg
+   heu_arg     : argument of heu_wt, e.g. a pointer to vertex coordinates
+                 and the target
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value 
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void astar_ws(const adj_lst_t *a,
+	      size_t start,
+	      size_t target,
+	      void *dist,
+	      size_t *prev,
+	      dijkstra_ws_t *ws,
+	      void (*heu_wt)(void *, size_t, const void *),
+	      const void *heu_arg,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  astar_view(&w, start, target, dist, prev, ws, heu_wt, heu_arg,
+	     add_wt, cmp_wt);
+}
+
+void astar_ws_csr(const adj_csr_t *c,
+		  size_t start,
+		  size_t target,
+		  void *dist,
+		  size_t *prev,
+		  dijkstra_ws_t *ws,
+		  void (*heu_wt)(void *, size_t, const void *),
+		  const void *heu_arg,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  astar_view(&w, start, target, dist, prev, ws, heu_wt, heu_arg,
+	     add_wt, cmp_wt);
+}
+
+/**
+   Runs astar_ws with a workspace that is used in a single run. Please see
+   the parameter specification in astar_ws.
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; a vertex is a hash key in 
+                 the hash table
+*/
+void astar(const adj_lst_t *a,
+	   size_t start,
+	   size_t target,
+	   void *dist,
+	   size_t *prev,
+	   const heap_ht_t *hht,
+	   void (*heu_wt)(void *, size_t, const void *),
+	   const void *heu_arg,
+	   void (*add_wt)(void *, const void *, const void *),
+	   int (*cmp_wt)(const void *, const void *)){
+  dijkstra_ws_t ws;
+  dijkstra_ws_init(&ws, a->num_vts, a->wt_size, hht, cmp_wt);
+  astar_ws(a, start, target, dist, prev, &ws, heu_wt, heu_arg,
+	   add_wt, cmp_wt);
+  dijkstra_ws_free(&ws);
+}
+
+void astar_csr(const adj_csr_t *c,
+	       size_t start,
+	       size_t target,
+	       void *dist,
+	       size_t *prev,
+	       const heap_ht_t *hht,
+	       void (*heu_wt)(void *, size_t, const void *),
+	       const void *heu_arg,
+	       void (*add_wt)(void *, const void *, const void *),
+	       int (*cmp_wt)(const void *, const void *)){
+  dijkstra_ws_t ws;
+  dijkstra_ws_init(&ws, c->num_vts, c->wt_size, hht, cmp_wt);
+  astar_ws_csr(c, start, target, dist, prev, &ws, heu_wt, heu_arg,
+	       add_wt, cmp_wt);
+  dijkstra_ws_free(&ws);
+}
+
+/**
+   Runs the A* algorithm on a view of an adjacency list with a workspace.
+   A vertex is a size_t index in the heap and its hash table, and the
+   priority of a vertex is the sum of its distance and its estimate. The
+   first weight buffer of the workspace receives a popped priority and
+   then an estimate, the second the distance of a relaxed path, and the
+   third the priority of the path. The dist and prev arrays are reset by
+   dijkstra_ws_reset.
+*/
+static void astar_view(const adj_view_t *a,
+		       size_t start,
+		       size_t target,
+		       void *dist,
+		       size_t *prev,
+		       dijkstra_ws_t *ws,
+		       void (*heu_wt)(void *, size_t, const void *),
+		       const void *heu_arg,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  size_t wt_size = a->wt_size;
+  size_t num_vt_wts;
+  size_t u, v;
+  void *heu = NULL, *sum_wt = NULL, *pty = NULL;
+  void *u_wt = NULL, *v_wt = NULL;
+  heap_t *h = &ws->h;
+  heu = ws->wt_bufs;
+  sum_wt = wt_ptr(ws->wt_bufs, 1, wt_size);
+  pty = wt_ptr(ws->wt_bufs, 2, wt_size);
+  dijkstra_ws_reset(ws, dist, prev);
+  heu_wt(heu, start, heu_arg);
+  add_wt(pty, wt_ptr(dist, start, wt_size), heu);
+  heap_push(h, pty, &start);
+  prev[start] = start;
+  stack_push(&ws->vts, &start);
+  while (h->num_elts > 0){
+    heap_pop(h, pty, &u);
+    if (u == target) break;
+    u_wt = wt_ptr(dist, u, wt_size);
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
+    for (p = p_start; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      v_wt = wt_ptr(dist, v, wt_size);
+      add_wt(sum_wt, u_wt, p + a->wt_offset);
+      if (prev[v] == C_NREACHED){
+	memcpy(v_wt, sum_wt, wt_size);
+	heu_wt(heu, v, heu_arg);
+	add_wt(pty, v_wt, heu);
+	heap_push(h, pty, &v);
+	prev[v] = u;
+	stack_push(&ws->vts, &v);
+      }else if (cmp_wt(v_wt, sum_wt) > 0){
+	memcpy(v_wt, sum_wt, wt_size);
+	heu_wt(heu, v, heu_arg);
+	add_wt(pty, v_wt, heu);
+	if (heap_search(h, &v) != NULL){
+	  heap_update(h, pty, &v);
+	}else{
+	  /* popped before with an inconsistent estimate */
+	  heap_push(h, pty, &v);
+	}
+	prev[v] = u;
+      }
+    }
+  }
+}
+
+/** Functions for computing pointers */
+
+/**
+   Computes a pointer to an entry in an array of weights.
+*/
+static void *wt_ptr(const void *wts, size_t i, size_t wt_size){
+  return (void *)((char *)wts + i * wt_size);
+}
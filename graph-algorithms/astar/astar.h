@@ -0,0 +1,134 @@
+/**
+   astar.h
+
+   Declarations of accessible functions for running the A* algorithm on
+   graphs with generic non-negative weights, a hash table parameter, and a
+   heuristic parameter.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The weight functions and the hash table
+   parameter are as in dijkstra.
+
+   The heuristic parameter provides an estimate of the weight of a
+   shortest path from a vertex to the target. A vertex is popped from the
+   heap in the order of the sum of its distance from start and its
+   estimate. If the estimate is admissible, i.e. is not greater than the
+   weight of a shortest path to the target, then the distance of the target
+   is the weight of a shortest path when the target is popped. If the
+   estimate is also consistent, i.e. is not greater than the weight of an
+   edge (u, v) plus the estimate at v for each vertex u, then each vertex
+   is popped at most once, and otherwise a vertex is pushed again when its
+   distance decreases after it was popped. A zero estimate results in
+   dijkstra_ws_target.
+
+   A* runs with a workspace of Dijkstra's algorithm that is allocated once
+   per thread and is reset in O(number of vertices reached in the previous
+   run) time.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#ifndef ASTAR_H  
+#define ASTAR_H
+
+#include <stddef.h>
+#include "graph.h"
+#include "heap.h"
+#include "dijkstra.h"
+
+/**
+   Computes and copies the shortest distance from start to target to the
+   array pointed to by dist at target, and the previous vertices on the
+   path from target to start to the array pointed to by prev. The prev
+   array has the maximal value of size_t at target if target is not
+   reachable from start. The entries at other vertices are only specified
+   for the vertices on the path. The dist and prev parameters point to the
+   same arrays in each run with a workspace, and between runs the caller
+   may read but not modify the arrays.
+   a           : pointer to an adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   target      : target vertex
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   ws          : pointer to a workspace initialized with dijkstra_ws_init
+                 with the number of vertices and the weight size of the
+                 adjacency list
+   heu_wt      : heuristic function which copies the estimate of the weight
+                 of a shortest path from the vertex provided by the second
+                 argument to the target to the preallocated weight block
+                 pointed to by the first argument; the third argument is
+                 heu_arg
+   heu_arg     : argument of heu_wt, e.g. a pointer to vertex coordinates
+                 and the target
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value 
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void astar_ws(const adj_lst_t *a,
+	      size_t start,
+	      size_t target,
+	      void *dist,
+	      size_t *prev,
+	      dijkstra_ws_t *ws,
+	      void (*heu_wt)(void *, size_t, const void *),
+	      const void *heu_arg,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *));
+
+void astar_ws_csr(const adj_csr_t *c,
+		  size_t start,
+		  size_t target,
+		  void *dist,
+		  size_t *prev,
+		  dijkstra_ws_t *ws,
+		  void (*heu_wt)(void *, size_t, const void *),
+		  const void *heu_arg,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs astar_ws with a workspace that is used in a single run. Please see
+   the parameter specification in astar_ws.
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; a vertex is a hash key in 
+                 the hash table
+*/
+void astar(const adj_lst_t *a,
+	   size_t start,
+	   size_t target,
+	   void *dist,
+	   size_t *prev,
+	   const heap_ht_t *hht,
+	   void (*heu_wt)(void *, size_t, const void *),
+	   const void *heu_arg,
+	   void (*add_wt)(void *, const void *, const void *),
+	   int (*cmp_wt)(const void *, const void *));
+
+void astar_csr(const adj_csr_t *c,
+	       size_t start,
+	       size_t target,
+	       void *dist,
+	       size_t *prev,
+	       const heap_ht_t *hht,
+	       void (*heu_wt)(void *, size_t, const void *),
+	       const void *heu_arg,
+	       void (*add_wt)(void *, const void *, const void *),
+	       int (*cmp_wt)(const void *, const void *));
+
+#endif
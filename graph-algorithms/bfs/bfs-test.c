@@ -16,11 +16,15 @@
      [0, 1] : on/off for max edges test
      [0, 1] : on/off for no edges test
      [0, 1] : on/off for random graph test
+     [0, 1] : on/off for multi-source test on random graphs
+     [0, 1] : on/off for compressed list test on random graphs
 
    usage examples: 
    ./bfs-test
    ./bfs-test 10 14 10 14 10 14
    ./bfs-test 10 14 10 14 10 14 0 1 1 1
+   ./bfs-test 10 14 10 14 10 12 0 0 0 0 1
+   ./bfs-test 10 14 10 14 10 14 0 0 0 0 0 1
 
    bfs-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -68,13 +72,16 @@ const char *C_USAGE =
   "[0, ushort width - 1] : c\n"
   "[0, ushort width - 1] : d s.t. 2**c <= V <= 2**d for no edges test\n"
   "[0, ushort width - 1] : e\n"
-  "[0, ushort width - 1] : f s.t. 2**e <= V <= 2**f for rand graph test\n"
+  "[0, ushort width - 1] : f s.t. 2**e <= V <= 2**f for rand graph test\n";
+const char *C_USAGE_TESTS = /* each string literal within 509 characters */
   "[0, 1] : on/off for small graph tests\n"
   "[0, 1] : on/off for max edges test\n"
   "[0, 1] : on/off for no edges test\n"
-  "[0, 1] : on/off for random graph test\n";
-const int C_ARGC_MAX = 11;
-const size_t C_ARGS_DEF[10] = {0, 6, 0, 6, 0, 14, 1, 1, 1, 1};
+  "[0, 1] : on/off for random graph test\n"
+  "[0, 1] : on/off for multi-source test\n"
+  "[0, 1] : on/off for compressed list test\n";
+const int C_ARGC_MAX = 13;
+const size_t C_ARGS_DEF[12] = {0, 6, 0, 6, 0, 14, 1, 1, 1, 1, 1, 1};
 const size_t C_USHORT_BIT = CHAR_BIT * sizeof(unsigned short);
 
 /* first small graph test */
@@ -242,7 +249,11 @@ const size_t C_PROBS_COUNT = 5;
 const double C_PROBS[5] = {1.00, 0.75, 0.50, 0.25, 0.00};
 const double C_PROB_ONE = 1.0;
 const double C_PROB_ZERO = 0.0;
+const size_t C_MULTI_COUNT = 300; /* more than one batch */
+const size_t C_MULTI_PROBS_COUNT = 2;
+const double C_MULTI_PROBS[2] = {0.015625, 0.000244};
 
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
 static void *ptr(const void *block, size_t i, size_t size);
 void print_test_result(int res);
 
@@ -753,16 +764,29 @@ void run_random_dir_graph_helper(size_t num_vts,
 				 void (*incr)(void *),
 				 int bern(void *),
 				 bern_arg_t *b){
-  size_t i;
+  int res = 1;
+  size_t i, j;
   size_t *start = NULL;
   void *dist = NULL, *prev = NULL;
+  void *dist_csr = NULL, *prev_csr = NULL;
+  void *dist_ws = NULL, *prev_ws = NULL;
+  graph_t g;
   adj_lst_t a;
-  clock_t t;
+  adj_csr_t c;
+  bfs_ws_t ws;
+  clock_t t, t_csr, t_ws;
   /* no declared type after malloc; effective type is set by bfs */
   start = malloc_perror(C_ITER, sizeof(size_t));
   dist = malloc_perror(num_vts, vt_size);
   prev = malloc_perror(num_vts, vt_size);
+  dist_csr = malloc_perror(num_vts, vt_size);
+  prev_csr = malloc_perror(num_vts, vt_size);
+  dist_ws = malloc_perror(num_vts, vt_size);
+  prev_ws = malloc_perror(num_vts, vt_size);
   adj_lst_rand_dir(&a, num_vts, vt_size, read, write, bern, b);
+  lst_graph_init(&g, &a);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
   for (i = 0; i < C_ITER; i++){
     start[i] =  RANDOM() % num_vts;
   }
@@ -771,21 +795,345 @@ void run_random_dir_graph_helper(size_t num_vts,
     bfs(&a, start[i], dist, prev, cmpat, incr);
   }
   t = clock() - t;
-  printf("\t\t\t%s ave runtime:     %.6f seconds\n",
-	 vt_type, (float)t / C_ITER / CLOCKS_PER_SEC);
+  t_csr = clock();
+  for (i = 0; i < C_ITER; i++){
+    bfs_csr(&c, start[i], dist_csr, prev_csr, cmpat, incr);
+  }
+  t_csr = clock() - t_csr;
+  t_ws = clock();
+  bfs_ws_init(&ws, num_vts, vt_size);
+  for (i = 0; i < C_ITER; i++){
+    bfs_ws(&a, start[i], dist_ws, prev_ws, &ws, cmpat, incr);
+  }
+  bfs_ws_free(&ws);
+  t_ws = clock() - t_ws;
+  for (j = 0; j < num_vts; j++){
+    res *= (read(ptr(prev, j, vt_size)) == read(ptr(prev_csr, j, vt_size)));
+    if (read(ptr(prev, j, vt_size)) != num_vts){
+      res *= (read(ptr(dist, j, vt_size)) ==
+	      read(ptr(dist_csr, j, vt_size)));
+    }
+  }
+  printf("\t\t\t%s ave runtime:     %.6f seconds\n"
+	 "\t\t\t%s csr ave runtime: %.6f seconds\n",
+	 vt_type, (float)t / C_ITER / CLOCKS_PER_SEC,
+	 vt_type, (float)t_csr / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tcsr correctness:        ");
+  print_test_result(res);
+  res = 1;
+  for (j = 0; j < num_vts; j++){
+    res *= (read(ptr(prev, j, vt_size)) == read(ptr(prev_ws, j, vt_size)));
+    if (read(ptr(prev, j, vt_size)) != num_vts){
+      res *= (read(ptr(dist, j, vt_size)) ==
+	      read(ptr(dist_ws, j, vt_size)));
+    }
+  }
+  printf("\t\t\t%s ws ave runtime:  %.6f seconds\n",
+	 vt_type, (float)t_ws / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tws correctness:         ");
+  print_test_result(res);
   adj_lst_free(&a); /* deallocates blocks with effective vertex type */
+  adj_csr_free(&c);
+  graph_free(&g);
   free(start);
   free(dist);
   free(prev);
+  free(dist_csr);
+  free(prev_csr);
+  free(dist_ws);
+  free(prev_ws);
   start = NULL;
   dist = NULL;
   prev = NULL;
+  dist_csr = NULL;
+  prev_csr = NULL;
+  dist_ws = NULL;
+  prev_ws = NULL;
+}
+
+/**
+   Run a bfs_multi test on random directed graphs.
+*/
+
+void run_multi_helper(size_t num_vts,
+		      size_t vt_size,
+		      const char *vt_type,
+		      size_t (*read)(const void *),
+		      void (*write)(void *, size_t),
+		      int (*cmpat)(const void *,
+				   const void *,
+				   const void *),
+		      void (*incr)(void *),
+		      int bern(void *),
+		      bern_arg_t *b);
+
+void run_multi_test(size_t log_start, size_t log_end){
+  size_t i, j;
+  size_t num_vts;
+  bern_arg_t b;
+  printf("Run a bfs_multi test on random directed graphs from %lu random "
+	 "start vertices in each graph\n", TOLU(C_MULTI_COUNT));
+  for (i = 0; i < C_MULTI_PROBS_COUNT; i++){
+    b.p = C_MULTI_PROBS[i];
+    printf("\tP[an edge is in a graph] = %.6f\n", b.p);
+    for (j = log_start; j <= log_end; j++){
+      num_vts = pow_two_perror(j);
+      printf("\t\tvertices: %lu, E[# of directed edges]: %.1f\n",
+	     TOLU(num_vts), b.p * num_vts * (num_vts - 1));
+      run_multi_helper(num_vts,
+		       C_VT_SIZES[0],
+		       C_VT_TYPES[0],
+		       C_READ[0],
+		       C_WRITE[0],
+		       C_CMPAT[0],
+		       C_INCR[0],
+		       bern,
+		       &b);
+    }
+  }
+}
+
+void run_multi_helper(size_t num_vts,
+		      size_t vt_size,
+		      const char *vt_type,
+		      size_t (*read)(const void *),
+		      void (*write)(void *, size_t),
+		      int (*cmpat)(const void *,
+				   const void *,
+				   const void *),
+		      void (*incr)(void *),
+		      int bern(void *),
+		      bern_arg_t *b){
+  int res = 1;
+  size_t i, j;
+  size_t ld = num_vts + 1; /* strided rows */
+  size_t *start = NULL;
+  void *dist = NULL, *prev = NULL, *dist_m = NULL;
+  const char *row = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  bfs_ws_t ws;
+  clock_t t, t_m, t_csr;
+  start = malloc_perror(C_MULTI_COUNT, sizeof(size_t));
+  dist = malloc_perror(mul_sz_perror(C_MULTI_COUNT, num_vts), vt_size);
+  prev = malloc_perror(num_vts, vt_size);
+  dist_m = malloc_perror(mul_sz_perror(C_MULTI_COUNT, ld), vt_size);
+  adj_lst_rand_dir(&a, num_vts, vt_size, read, write, bern, b);
+  lst_graph_init(&g, &a);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
+  for (i = 0; i < C_MULTI_COUNT; i++){
+    start[i] =  RANDOM() % num_vts;
+  }
+  bfs_ws_init(&ws, num_vts, vt_size);
+  t = clock();
+  for (i = 0; i < C_MULTI_COUNT; i++){
+    bfs_ws(&a, start[i], ptr(dist, i * num_vts, vt_size), prev, &ws,
+	   cmpat, incr);
+    /* unreached distances are set to num_vts for comparison */
+    for (j = 0; j < num_vts; j++){
+      if (read(ptr(prev, j, vt_size)) == num_vts){
+	write(ptr(dist, i * num_vts + j, vt_size), num_vts);
+      }
+    }
+  }
+  t = clock() - t;
+  bfs_ws_free(&ws);
+  t_m = clock();
+  bfs_multi(&a, start, C_MULTI_COUNT, dist_m, ld);
+  t_m = clock() - t_m;
+  for (i = 0; i < C_MULTI_COUNT; i++){
+    row = ptr(dist_m, i * ld, vt_size);
+    for (j = 0; j < num_vts; j++){
+      res *= (read(ptr(dist, i * num_vts + j, vt_size)) ==
+	      read(ptr(row, j, vt_size)));
+    }
+  }
+  t_csr = clock();
+  bfs_multi_csr(&c, start, C_MULTI_COUNT, dist_m, ld);
+  t_csr = clock() - t_csr;
+  for (i = 0; i < C_MULTI_COUNT; i++){
+    row = ptr(dist_m, i * ld, vt_size);
+    for (j = 0; j < num_vts; j++){
+      res *= (read(ptr(dist, i * num_vts + j, vt_size)) ==
+	      read(ptr(row, j, vt_size)));
+    }
+  }
+  printf("\t\t\t%s bfs_ws runtime:        %.6f seconds\n"
+	 "\t\t\t%s bfs_multi runtime:     %.6f seconds\n"
+	 "\t\t\t%s bfs_multi_csr runtime: %.6f seconds\n",
+	 vt_type, (float)t / CLOCKS_PER_SEC,
+	 vt_type, (float)t_m / CLOCKS_PER_SEC,
+	 vt_type, (float)t_csr / CLOCKS_PER_SEC);
+  printf("\t\t\tcorrectness:                  ");
+  print_test_result(res);
+  adj_lst_free(&a);
+  adj_csr_free(&c);
+  graph_free(&g);
+  free(start);
+  free(dist);
+  free(prev);
+  free(dist_m);
+  start = NULL;
+  dist = NULL;
+  prev = NULL;
+  dist_m = NULL;
+}
+
+/**
+   Run a bfs_cmpr test on random directed graphs.
+*/
+
+void run_cmpr_helper(size_t num_vts,
+		     size_t vt_size,
+		     const char *vt_type,
+		     size_t (*read)(const void *),
+		     void (*write)(void *, size_t),
+		     int (*cmpat)(const void *,
+				  const void *,
+				  const void *),
+		     void (*incr)(void *),
+		     int bern(void *),
+		     bern_arg_t *b);
+
+void run_cmpr_test(size_t log_start, size_t log_end){
+  size_t i, j;
+  size_t num_vts;
+  bern_arg_t b;
+  printf("Run a bfs_cmpr test on random directed graphs from %lu random "
+	 "start vertices in each graph\n", TOLU(C_ITER));
+  for (i = 0; i < C_PROBS_COUNT; i++){
+    b.p = C_PROBS[i];
+    printf("\tP[an edge is in a graph] = %.2f\n", b.p);
+    for (j = log_start; j <= log_end; j++){
+      num_vts = pow_two_perror(j);
+      printf("\t\tvertices: %lu, E[# of directed edges]: %.1f\n",
+	     TOLU(num_vts), b.p * num_vts * (num_vts - 1));
+      run_cmpr_helper(num_vts,
+		      C_VT_SIZES[0],
+		      C_VT_TYPES[0],
+		      C_READ[0],
+		      C_WRITE[0],
+		      C_CMPAT[0],
+		      C_INCR[0],
+		      bern,
+		      &b);
+    }
+  }
+}
+
+void run_cmpr_helper(size_t num_vts,
+		     size_t vt_size,
+		     const char *vt_type,
+		     size_t (*read)(const void *),
+		     void (*write)(void *, size_t),
+		     int (*cmpat)(const void *,
+				  const void *,
+				  const void *),
+		     void (*incr)(void *),
+		     int bern(void *),
+		     bern_arg_t *b){
+  int res = 1;
+  size_t i, j;
+  size_t *start = NULL;
+  void *dist = NULL, *prev = NULL;
+  void *dist_cmpr = NULL, *prev_cmpr = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  adj_cmpr_t cc;
+  clock_t t_csr, t_cmpr;
+  /* no declared type after malloc; effective type is set by bfs */
+  start = malloc_perror(C_ITER, sizeof(size_t));
+  dist = malloc_perror(num_vts, vt_size);
+  prev = malloc_perror(num_vts, vt_size);
+  dist_cmpr = malloc_perror(num_vts, vt_size);
+  prev_cmpr = malloc_perror(num_vts, vt_size);
+  adj_lst_rand_dir(&a, num_vts, vt_size, read, write, bern, b);
+  lst_graph_init(&g, &a);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
+  adj_cmpr_base_init(&cc, &g);
+  adj_cmpr_dir_build(&cc, &g);
+  for (i = 0; i < C_ITER; i++){
+    start[i] =  RANDOM() % num_vts;
+  }
+  t_csr = 0;
+  t_cmpr = 0;
+  for (i = 0; i < C_ITER; i++){
+    t_csr -= clock();
+    bfs_csr(&c, start[i], dist, prev, cmpat, incr);
+    t_csr += clock();
+    t_cmpr -= clock();
+    bfs_cmpr(&cc, start[i], dist_cmpr, prev_cmpr, cmpat, incr);
+    t_cmpr += clock();
+    for (j = 0; j < num_vts; j++){
+      res *= ((read(ptr(prev, j, vt_size)) == num_vts) ==
+	      (read(ptr(prev_cmpr, j, vt_size)) == num_vts));
+      if (read(ptr(prev, j, vt_size)) != num_vts){
+	res *= (read(ptr(dist, j, vt_size)) ==
+		read(ptr(dist_cmpr, j, vt_size)));
+      }
+    }
+  }
+  printf("\t\t\t%s csr bytes:            %lu\n"
+	 "\t\t\t%s cmpr bytes:           %lu\n",
+	 vt_type, TOLU(c.num_es * c.pair_size),
+	 vt_type, TOLU(cc.offsets[num_vts]));
+  printf("\t\t\t%s csr ave runtime:      %.6f seconds\n"
+	 "\t\t\t%s cmpr ave runtime:     %.6f seconds\n",
+	 vt_type, (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	 vt_type, (float)t_cmpr / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tcmpr correctness:            ");
+  print_test_result(res);
+  adj_lst_free(&a); /* deallocates blocks with effective vertex type */
+  adj_csr_free(&c);
+  adj_cmpr_free(&cc);
+  graph_free(&g);
+  free(start);
+  free(dist);
+  free(prev);
+  free(dist_cmpr);
+  free(prev_cmpr);
+  start = NULL;
+  dist = NULL;
+  prev = NULL;
+  dist_cmpr = NULL;
+  prev_cmpr = NULL;
 }
 
 /**
    Auxiliary functions.
 */
 
+/**
+   Initializes a directed graph with the edges of an adjacency list.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL;
+  const char *p = NULL;
+  graph_base_init(g, a->num_vts, a->vt_size, 0, a->read_vt, a->write_vt);
+  g->num_es = a->num_es;
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  up = g->u;
+  vp = g->v;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
 /**
    Computes a pointer to the ith element in the block of elements.
 */
@@ -806,7 +1154,7 @@ int main(int argc, char *argv[]){
   size_t *args = NULL;
   RGENS_SEED();
   if (argc > C_ARGC_MAX){
-    printf("USAGE:\n%s", C_USAGE);
+    printf("USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
@@ -826,8 +1174,10 @@ int main(int argc, char *argv[]){
       args[6] > 1 ||
       args[7] > 1 ||
       args[8] > 1 ||
-      args[9] > 1){
-    printf("USAGE:\n%s", C_USAGE);
+      args[9] > 1 ||
+      args[10] > 1 ||
+      args[11] > 1){
+    printf("USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   if (args[6]){
@@ -837,6 +1187,8 @@ int main(int argc, char *argv[]){
   if (args[7]) run_max_edges_graph_test(args[0], args[1]);
   if (args[8]) run_no_edges_graph_test(args[2], args[3]);
   if (args[9]) run_random_dir_graph_test(args[4], args[5]);
+  if (args[10]) run_multi_test(args[4], args[5]);
+  if (args[11]) run_cmpr_test(args[4], args[5]);
   free(args);
   args = NULL;
   return 0;
@@ -20,6 +20,24 @@
    and it is safe to read such a representation even if the value
    was not set by the algorithm.
 
+   If bfs is run repeatedly on a graph, bfs_ws and bfs_ws_csr run with a
+   workspace that is allocated once per thread. The reached vertices of a
+   run are kept in the workspace in the BFS order, serving as the queue,
+   and the prev array is reset in O(number of vertices reached in the
+   previous run) time.
+
+   If bfs is run from many start vertices on a graph, bfs_multi and
+   bfs_multi_csr run from a batch of start vertices at once. A vertex has
+   a bit for each start vertex of a batch in each of three bit arrays
+   (seen, current level, next level), so that a single scan of the
+   adjacency list of a vertex in a level serves all start vertices, and
+   the distances are written into a strided matrix.
+
+   bfs_cmpr runs on a read-only compressed adjacency list, where the sorted
+   lists are delta-encoded and variable-length encoded, decoding each list
+   with an iterator while it is scanned, so that the lists of a large
+   graph occupy fewer cache lines and less memory bandwidth.
+
    The implementation only uses integer and pointer operations. Given
    parameter values within the specified ranges, the implementation provides
    an error message and an exit is executed if an integer overflow is
@@ -40,6 +58,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "bfs.h"
 #include "graph.h"
 #include "queue.h"
@@ -47,7 +66,29 @@
 #include "utilities-mem.h"
 
 static const size_t QUEUE_INIT_COUNT = 1;
+static const size_t C_BIT = CHAR_BIT * sizeof(unsigned long);
+static const size_t C_MULTI_BITS = 256; /* max start vertices in a batch */
 
+static void bfs_view(const adj_view_t *a,
+		     size_t start,
+		     void *dist,
+		     void *prev,
+		     int (*cmpat_vt)(const void *, const void *, const void *),
+		     void (*incr_vt)(void *));
+static void bfs_ws_view(const adj_view_t *a,
+			size_t start,
+			void *dist,
+			void *prev,
+			bfs_ws_t *ws,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *));
+static void bfs_multi_view(const adj_view_t *a,
+			   const size_t *starts,
+			   size_t num_starts,
+			   void *dist,
+			   size_t ld);
 static void *ptr(const void *block, size_t i, size_t size);
 
 int bfs_cmpat_ushort(const void *a, const void *i, const void *v){
@@ -126,6 +167,197 @@ void bfs(const adj_lst_t *a,
 	 void *prev,
 	 int (*cmpat_vt)(const void *, const void *, const void *),
 	 void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  bfs_view(&w, start, dist, prev, cmpat_vt, incr_vt);
+}
+
+/**
+   Runs bfs on a compressed sparse row (CSR) adjacency list with at least
+   one vertex. Please see the parameter specification in bfs.
+*/
+void bfs_csr(const adj_csr_t *c,
+	     size_t start,
+	     void *dist,
+	     void *prev,
+	     int (*cmpat_vt)(const void *, const void *, const void *),
+	     void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  bfs_view(&w, start, dist, prev, cmpat_vt, incr_vt);
+}
+
+/**
+   Initializes a workspace for repeated runs of bfs_ws and bfs_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(bfs_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   vt_size     : size of the integer type used to represent vertices in the
+                 graphs in the runs
+*/
+void bfs_ws_init(bfs_ws_t *ws, size_t num_vts, size_t vt_size){
+  ws->num_vts = num_vts;
+  ws->vt_size = vt_size;
+  ws->is_first = 1;
+  ws->unr = malloc_perror(2, vt_size);
+  stack_init(&ws->vts, QUEUE_INIT_COUNT, vt_size, NULL);
+}
+
+/**
+   Runs bfs with a workspace. The prev parameter points to the same array
+   in each run with the workspace, and only the entries of the vertices
+   reached in the previous run are reset. Between runs, the caller may
+   read but not modify the array. The values set in the dist and prev
+   arrays are the same as the values set by bfs with the same parameters.
+   Please see the parameter specification in bfs.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the vertex size of the adjacency list
+*/
+void bfs_ws(const adj_lst_t *a,
+	    size_t start,
+	    void *dist,
+	    void *prev,
+	    bfs_ws_t *ws,
+	    int (*cmpat_vt)(const void *, const void *, const void *),
+	    void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  bfs_ws_view(&w, start, dist, prev, ws, cmpat_vt, incr_vt);
+}
+
+void bfs_ws_csr(const adj_csr_t *c,
+		size_t start,
+		void *dist,
+		void *prev,
+		bfs_ws_t *ws,
+		int (*cmpat_vt)(const void *, const void *, const void *),
+		void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  bfs_ws_view(&w, start, dist, prev, ws, cmpat_vt, incr_vt);
+}
+
+/**
+   Frees a workspace and leaves a block of size sizeof(bfs_ws_t) pointed
+   to by the ws parameter.
+*/
+void bfs_ws_free(bfs_ws_t *ws){
+  stack_free(&ws->vts);
+  free(ws->unr);
+  ws->unr = NULL;
+}
+
+/**
+   Computes and copies to the rows of a dist matrix the lowest # of edges
+   from each of num_starts start vertices to each vertex, with the number
+   of vertices in a graph as the special value for unreached vertices.
+   Up to 256 start vertices are processed in a single pass over the
+   adjacency lists in each level, with a bit per start vertex in a bit
+   array of each vertex. Assumes the start vertices are valid and there is
+   at least one vertex.
+   a           : pointer to an adjacency list with at least one vertex
+   starts      : pointer to an array of num_starts start vertices; a start
+                 vertex may occur more than once
+   num_starts  : number of start vertices
+   dist        : pointer to a preallocated matrix of num_starts rows, where
+                 the ith row begins at the (i * ld)th element and contains
+                 at least as many elements as the number of vertices; each
+                 element is of the integer type used to represent vertices
+                 and the value of every element of the first num_vts
+                 elements of a row is set by the algorithm
+   ld          : >= number of vertices, count of elements between the
+                 beginnings of two consecutive rows of the dist matrix
+*/
+void bfs_multi(const adj_lst_t *a,
+	       const size_t *starts,
+	       size_t num_starts,
+	       void *dist,
+	       size_t ld){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  bfs_multi_view(&w, starts, num_starts, dist, ld);
+}
+
+/**
+   Runs bfs_multi on a compressed sparse row (CSR) adjacency list with at
+   least one vertex. Please see the parameter specification in bfs_multi.
+*/
+void bfs_multi_csr(const adj_csr_t *c,
+		   const size_t *starts,
+		   size_t num_starts,
+		   void *dist,
+		   size_t ld){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  bfs_multi_view(&w, starts, num_starts, dist, ld);
+}
+
+/**
+   Runs bfs on a compressed adjacency list with at least one vertex,
+   decoding the list of each popped vertex on the fly. The lists are
+   visited in ascending order of vertices, which may differ from the order
+   in bfs on an adjacency list built from the same graph, so that prev may
+   differ in the choice among previous vertices at the same distance. The
+   dist array is the same as in bfs. Please see the parameter specification
+   in bfs.
+*/
+void bfs_cmpr(const adj_cmpr_t *c,
+	      size_t start,
+	      void *dist,
+	      void *prev,
+	      int (*cmpat_vt)(const void *, const void *, const void *),
+	      void (*incr_vt)(void *)){
+  size_t v;
+  char *dp = NULL, *pp = NULL;
+  const char *du = NULL;
+  void *unr = NULL; /* vertex, not reached vertex value, decoded vertex */
+  void *u = NULL, *nr = NULL, *vb = NULL;
+  adj_cmpr_iter_t it;
+  queue_t q;
+  /* single block for cache-efficiency; same type */
+  unr = malloc_perror(3, c->vt_size);
+  u = unr;
+  nr = ptr(unr, 1, c->vt_size);
+  vb = ptr(unr, 2, c->vt_size);
+  c->write_vt(u, start);
+  c->write_vt(nr, c->num_vts);
+  c->write_vt(ptr(dist, start, c->vt_size), 0);
+  for (pp = prev; pp != ptr(prev, c->num_vts, c->vt_size); pp += c->vt_size){
+    memcpy(pp, nr, c->vt_size);
+  }
+  queue_init(&q, QUEUE_INIT_COUNT, c->vt_size, NULL);
+  memcpy(ptr(prev, start, c->vt_size), u, c->vt_size);
+  queue_push(&q, u);
+  while (q.num_elts > 0){
+    queue_pop(&q, u);
+    du = ptr(dist, c->read_vt(u), c->vt_size);
+    adj_cmpr_iter_init(&it, c, c->read_vt(u));
+    while (adj_cmpr_iter_next(&it, &v)){
+      c->write_vt(vb, v);
+      if (cmpat_vt(prev, vb, nr) == 0){
+        dp = ptr(dist, v, c->vt_size);
+        pp = ptr(prev, v, c->vt_size);
+	memcpy(dp, du, c->vt_size);
+        incr_vt(dp);
+	memcpy(pp, u, c->vt_size);
+	queue_push(&q, vb);
+      }
+    }
+  }
+  queue_free(&q);
+  free(unr);
+  unr = NULL;
+}
+
+/**
+   Runs bfs on a view of an adjacency list.
+*/
+static void bfs_view(const adj_view_t *a,
+		     size_t start,
+		     void *dist,
+		     void *prev,
+		     int (*cmpat_vt)(const void *, const void *, const void *),
+		     void (*incr_vt)(void *)){
+  size_t num_vt_wts;
   char *dp = NULL, *pp = NULL;
   const char *du = NULL;
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
@@ -148,8 +380,8 @@ void bfs(const adj_lst_t *a,
   while (q.num_elts > 0){
     queue_pop(&q, u);
     du = ptr(dist, a->read_vt(u), a->vt_size);
-    p_start = a->vt_wts[a->read_vt(u)]->elts;
-    p_end = p_start + a->vt_wts[a->read_vt(u)]->num_elts * a->pair_size;
+    p_start = a->vt_wts(a->adj, a->read_vt(u), &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
       if (cmpat_vt(prev, p, nr) == 0){
         dp = ptr(dist, a->read_vt(p), a->vt_size);
@@ -166,6 +398,165 @@ void bfs(const adj_lst_t *a,
   unr = NULL;
 }
 
+/**
+   Runs bfs on a view of an adjacency list with a workspace. The stack of
+   the workspace is used as a queue by iterating over its elements in the
+   order of pushes, so that after a run it contains the reached vertices.
+*/
+static void bfs_ws_view(const adj_view_t *a,
+			size_t start,
+			void *dist,
+			void *prev,
+			bfs_ws_t *ws,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *)){
+  size_t i;
+  size_t num_vt_wts;
+  char *dp = NULL, *pp = NULL;
+  const char *du = NULL;
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  void *u = NULL, *nr = NULL;
+  u = ws->unr;
+  nr = ptr(ws->unr, 1, a->vt_size);
+  a->write_vt(nr, a->num_vts);
+  if (ws->is_first){
+    for (pp = prev;
+	 pp != ptr(prev, a->num_vts, a->vt_size);
+	 pp += a->vt_size){
+      memcpy(pp, nr, a->vt_size);
+    }
+    ws->is_first = 0;
+  }else{
+    for (i = 0; i < ws->vts.num_elts; i++){
+      pp = ptr(prev, a->read_vt(ptr(ws->vts.elts, i, a->vt_size)), a->vt_size);
+      memcpy(pp, nr, a->vt_size);
+    }
+  }
+  ws->vts.num_elts = 0;
+  a->write_vt(u, start);
+  a->write_vt(ptr(dist, start, a->vt_size), 0);
+  memcpy(ptr(prev, start, a->vt_size), u, a->vt_size);
+  stack_push(&ws->vts, u);
+  for (i = 0; i < ws->vts.num_elts; i++){
+    /* copy, because a push may reallocate the elements of the stack */
+    memcpy(u, ptr(ws->vts.elts, i, a->vt_size), a->vt_size);
+    du = ptr(dist, a->read_vt(u), a->vt_size);
+    p_start = a->vt_wts(a->adj, a->read_vt(u), &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
+    for (p = p_start; p != p_end; p += a->pair_size){
+      if (cmpat_vt(prev, p, nr) == 0){
+	dp = ptr(dist, a->read_vt(p), a->vt_size);
+	pp = ptr(prev, a->read_vt(p), a->vt_size);
+	memcpy(dp, du, a->vt_size);
+	incr_vt(dp);
+	memcpy(pp, u, a->vt_size);
+	stack_push(&ws->vts, p);
+      }
+    }
+  }
+}
+
+/**
+   Runs bfs_multi on a view of an adjacency list. A batch uses
+   num_wds words per vertex in each bit array, and a level consists of a
+   pass that propagates the current level bits of each vertex with a set
+   bit to its adjacent vertices, and a pass that removes the seen bits
+   from the next level bits and writes the distances of the new bits.
+*/
+static void bfs_multi_view(const adj_view_t *a,
+			   const size_t *starts,
+			   size_t num_starts,
+			   void *dist,
+			   size_t ld){
+  int is_active;
+  size_t i, j, k, u, v, s;
+  size_t level, num_wds, num_vt_wts;
+  size_t max_wds = C_MULTI_BITS / C_BIT;
+  size_t num_bits = mul_sz_perror(a->num_vts, max_wds);
+  size_t row_size = mul_sz_perror(ld, a->vt_size);
+  unsigned long d;
+  unsigned long *seen = NULL, *cur = NULL, *next = NULL, *t = NULL;
+  unsigned long *sv = NULL, *nv = NULL;
+  const unsigned long *cu = NULL;
+  const char *p = NULL, *p_end = NULL;
+  char *row = NULL;
+  if (num_starts == 0) return;
+  if (max_wds > (num_starts - 1) / C_BIT + 1){
+    max_wds = (num_starts - 1) / C_BIT + 1;
+    num_bits = mul_sz_perror(a->num_vts, max_wds);
+  }
+  seen = malloc_perror(num_bits, sizeof(unsigned long));
+  cur = malloc_perror(num_bits, sizeof(unsigned long));
+  next = malloc_perror(num_bits, sizeof(unsigned long));
+  for (i = 0; i < num_starts; i++){
+    row = ptr(dist, i, row_size);
+    for (v = 0; v < a->num_vts; v++){
+      a->write_vt(ptr(row, v, a->vt_size), a->num_vts);
+    }
+  }
+  for (s = 0; s < num_starts; s += num_wds * C_BIT){
+    num_wds = (num_starts - s - 1) / C_BIT + 1;
+    if (num_wds > max_wds) num_wds = max_wds;
+    memset(seen, 0, a->num_vts * num_wds * sizeof(unsigned long));
+    memset(cur, 0, a->num_vts * num_wds * sizeof(unsigned long));
+    memset(next, 0, a->num_vts * num_wds * sizeof(unsigned long));
+    for (i = s; i < s + num_wds * C_BIT && i < num_starts; i++){
+      k = i - s;
+      v = starts[i];
+      cur[v * num_wds + k / C_BIT] |= 1UL << (k % C_BIT);
+      seen[v * num_wds + k / C_BIT] |= 1UL << (k % C_BIT);
+      a->write_vt(ptr(ptr(dist, i, row_size), v, a->vt_size), 0);
+    }
+    level = 0;
+    is_active = 1;
+    while (is_active){
+      level++;
+      is_active = 0;
+      for (u = 0; u < a->num_vts; u++){
+	cu = cur + u * num_wds;
+	for (j = 0; j < num_wds && cu[j] == 0; j++);
+	if (j == num_wds) continue;
+	p = a->vt_wts(a->adj, u, &num_vt_wts);
+	p_end = p + num_vt_wts * a->pair_size;
+	for (; p != p_end; p += a->pair_size){
+	  nv = next + a->read_vt(p) * num_wds;
+	  for (j = 0; j < num_wds; j++){
+	    nv[j] |= cu[j];
+	  }
+	}
+      }
+      for (v = 0; v < a->num_vts; v++){
+	nv = next + v * num_wds;
+	sv = seen + v * num_wds;
+	for (j = 0; j < num_wds; j++){
+	  d = nv[j] & ~sv[j];
+	  nv[j] = d;
+	  if (d == 0) continue;
+	  sv[j] |= d;
+	  is_active = 1;
+	  for (k = s + j * C_BIT; d != 0; k++, d >>= 1){
+	    if (d & 1UL){
+	      a->write_vt(ptr(ptr(dist, k, row_size), v, a->vt_size), level);
+	    }
+	  }
+	}
+      }
+      t = cur;
+      cur = next;
+      next = t;
+      memset(next, 0, a->num_vts * num_wds * sizeof(unsigned long));
+    }
+  }
+  free(seen);
+  free(cur);
+  free(next);
+  seen = NULL;
+  cur = NULL;
+  next = NULL;
+}
+
 /**
    Computes a pointer to the ith element in the block of elements.
 */
@@ -20,6 +20,24 @@
    and it is safe to read such a representation even if the value
    was not set by the algorithm.
 
+   If bfs is run repeatedly on a graph, bfs_ws and bfs_ws_csr run with a
+   workspace that is allocated once per thread. The reached vertices of a
+   run are kept in the workspace in the BFS order, serving as the queue,
+   and the prev array is reset in O(number of vertices reached in the
+   previous run) time.
+
+   If bfs is run from many start vertices on a graph, bfs_multi and
+   bfs_multi_csr run from a batch of start vertices at once. A vertex has
+   a bit for each start vertex of a batch in each of three bit arrays
+   (seen, current level, next level), so that a single scan of the
+   adjacency list of a vertex in a level serves all start vertices, and
+   the distances are written into a strided matrix.
+
+   bfs_cmpr runs on a read-only compressed adjacency list, where the sorted
+   lists are delta-encoded and variable-length encoded, decoding each list
+   with an iterator while it is scanned, so that the lists of a large
+   graph occupy fewer cache lines and less memory bandwidth.
+
    The implementation only uses integer and pointer operations. Given
    parameter values within the specified ranges, the implementation provides
    an error message and an exit is executed if an integer overflow is
@@ -42,6 +60,15 @@
 
 #include <stddef.h>
 #include "graph.h"
+#include "stack.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t vt_size;
+  int is_first; /* non-zero before the first run */
+  void *unr; /* vertex and not reached vertex value buffers */
+  stack_t vts; /* vertices reached in the last run, in BFS order */
+} bfs_ws_t;
 
 int bfs_cmpat_ushort(const void *a, const void *i, const void *v);
 int bfs_cmpat_uint(const void *a, const void *i, const void *v);
@@ -95,4 +122,109 @@ void bfs(const adj_lst_t *a,
 	 int (*cmpat_vt)(const void *, const void *, const void *),
 	 void (*incr_vt)(void *));
 
+/**
+   Runs bfs on a compressed sparse row (CSR) adjacency list with at least
+   one vertex. Please see the parameter specification in bfs.
+*/
+void bfs_csr(const adj_csr_t *c,
+	     size_t start,
+	     void *dist,
+	     void *prev,
+	     int (*cmpat_vt)(const void *, const void *, const void *),
+	     void (*incr_vt)(void *));
+
+/**
+   Initializes a workspace for repeated runs of bfs_ws and bfs_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(bfs_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   vt_size     : size of the integer type used to represent vertices in the
+                 graphs in the runs
+*/
+void bfs_ws_init(bfs_ws_t *ws, size_t num_vts, size_t vt_size);
+
+/**
+   Runs bfs with a workspace. The prev parameter points to the same array
+   in each run with the workspace, and only the entries of the vertices
+   reached in the previous run are reset. Between runs, the caller may
+   read but not modify the array. The values set in the dist and prev
+   arrays are the same as the values set by bfs with the same parameters.
+   Please see the parameter specification in bfs.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the vertex size of the adjacency list
+*/
+void bfs_ws(const adj_lst_t *a,
+	    size_t start,
+	    void *dist,
+	    void *prev,
+	    bfs_ws_t *ws,
+	    int (*cmpat_vt)(const void *, const void *, const void *),
+	    void (*incr_vt)(void *));
+
+void bfs_ws_csr(const adj_csr_t *c,
+		size_t start,
+		void *dist,
+		void *prev,
+		bfs_ws_t *ws,
+		int (*cmpat_vt)(const void *, const void *, const void *),
+		void (*incr_vt)(void *));
+
+/**
+   Frees a workspace and leaves a block of size sizeof(bfs_ws_t) pointed
+   to by the ws parameter.
+*/
+void bfs_ws_free(bfs_ws_t *ws);
+
+/**
+   Computes and copies to the rows of a dist matrix the lowest # of edges
+   from each of num_starts start vertices to each vertex, with the number
+   of vertices in a graph as the special value for unreached vertices.
+   Up to 256 start vertices are processed in a single pass over the
+   adjacency lists in each level, with a bit per start vertex in a bit
+   array of each vertex. Assumes the start vertices are valid and there is
+   at least one vertex.
+   a           : pointer to an adjacency list with at least one vertex
+   starts      : pointer to an array of num_starts start vertices; a start
+                 vertex may occur more than once
+   num_starts  : number of start vertices
+   dist        : pointer to a preallocated matrix of num_starts rows, where
+                 the ith row begins at the (i * ld)th element and contains
+                 at least as many elements as the number of vertices; each
+                 element is of the integer type used to represent vertices
+                 and the value of every element of the first num_vts
+                 elements of a row is set by the algorithm
+   ld          : >= number of vertices, count of elements between the
+                 beginnings of two consecutive rows of the dist matrix
+*/
+void bfs_multi(const adj_lst_t *a,
+	       const size_t *starts,
+	       size_t num_starts,
+	       void *dist,
+	       size_t ld);
+
+/**
+   Runs bfs_multi on a compressed sparse row (CSR) adjacency list with at
+   least one vertex. Please see the parameter specification in bfs_multi.
+*/
+void bfs_multi_csr(const adj_csr_t *c,
+		   const size_t *starts,
+		   size_t num_starts,
+		   void *dist,
+		   size_t ld);
+
+/**
+   Runs bfs on a compressed adjacency list with at least one vertex,
+   decoding the list of each popped vertex on the fly. The lists are
+   visited in ascending order of vertices, which may differ from the order
+   in bfs on an adjacency list built from the same graph, so that prev may
+   differ in the choice among previous vertices at the same distance. The
+   dist array is the same as in bfs. Please see the parameter specification
+   in bfs.
+*/
+void bfs_cmpr(const adj_cmpr_t *c,
+	      size_t start,
+	      void *dist,
+	      void *prev,
+	      int (*cmpat_vt)(const void *, const void *, const void *),
+	      void (*incr_vt)(void *));
+
 #endif
@@ -0,0 +1,473 @@
+/**
+   ch-test.c
+
+   Tests of contraction hierarchies on a small graph, on random geometric
+   graphs with Euclidean double weights, and on random sparse directed
+   graphs with random size_t weights, by comparing the distances of
+   queries to the distances computed by Dijkstra's algorithm.
+
+   The following command line arguments can be used to customize tests:
+   ch-test:
+   -  [0, # bits in size_t / 2] : n for 2^n vertices in the smallest graph
+   -  [0, # bits in size_t / 2] : n for 2^n vertices in the largest graph
+   -  [0, 1] : small graph test on/off
+   -  [0, 1] : random geometric graph test on/off
+   -  [0, 1] : random sparse directed graph test on/off
+
+   usage examples:
+   ./ch-test
+   ./ch-test 10 14
+   ./ch-test 14 14 0 1
+   ./ch-test 10 12 0 0 1
+
+   ch-test can be run with any subset of command line arguments in the
+   above-defined order. If the (i + 1)th argument is specified then the ith
+   argument must be specified for i >= 0. Default values are used for the
+   unspecified arguments, which are 0 for the first argument, 12 for the
+   second argument, and 1 for the following arguments.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99 with the only requirement that CHAR_BIT * sizeof(size_t)
+   is greater or equal to 16 and is even.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include "ch.h"
+#include "dijkstra.h"
+#include "heap.h"
+#include "graph.h"
+#include "stack.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+#define DRAND() ((double)rand() / RAND_MAX) /* [0.0, 1.0] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "ch-test \n"
+  "[0, # bits in size_t / 2] : n for 2^n vertices in smallest graph\n"
+  "[0, # bits in size_t / 2] : n for 2^n vertices in largest graph\n"
+  "[0, 1] : small graph test on/off\n"
+  "[0, 1] : random geometric graph test on/off\n"
+  "[0, 1] : random sparse directed graph test on/off\n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 12, 1, 1, 1};
+
+/* small graph test */
+const size_t C_NUM_VTS = 5;
+const size_t C_NUM_ES = 4;
+const size_t C_U[4] = {0, 0, 0, 1};
+const size_t C_V[4] = {1, 2, 3, 3};
+const size_t C_WTS_UINT[4] = {4, 3, 2, 1};
+
+/* random graph tests */
+const int C_ITER = 100;
+const double C_RAD_MULS[2] = {0.8, 1.0}; /* of connectivity radius */
+const int C_RAD_MULS_COUNT = 2;
+const double C_REL_ERR = 1e-9;
+const double C_PI = 3.14159265358979;
+const double C_DEGS[2] = {1.5, 2.0}; /* expected out-degrees */
+const int C_DEGS_COUNT = 2;
+
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+const size_t C_SIZE_MAX = (size_t)-1;
+const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
+			      ((CHAR_BIT * sizeof(size_t) + 1) / 2));
+
+void print_test_result(int res);
+
+/**
+   Run a test on a small graph with size_t weights.
+*/
+
+void add_uint(void *sum, const void *wt_a, const void *wt_b){
+  *(size_t *)sum = *(size_t *)wt_a + *(size_t *)wt_b;
+}
+
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+void run_uint_graph_test(){
+  int res = 1;
+  size_t i, j, m, wt;
+  size_t *dist = NULL, *prev = NULL;
+  graph_t g;
+  adj_lst_t a;
+  ch_t ch;
+  ch_ws_t ws;
+  dist = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  prev = malloc_perror(C_NUM_VTS, sizeof(size_t));
+  graph_base_init(&g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
+  g.num_es = C_NUM_ES;
+  g.u = malloc_perror(g.num_es, g.vt_size);
+  g.v = malloc_perror(g.num_es, g.vt_size);
+  g.wts = malloc_perror(g.num_es, g.wt_size);
+  memcpy(g.u, C_U, g.num_es * g.vt_size);
+  memcpy(g.v, C_V, g.num_es * g.vt_size);
+  memcpy(g.wts, C_WTS_UINT, g.num_es * g.wt_size);
+  printf("Run a ch test on a small graph with size_t weights\n");
+  for (i = 0; i < 2; i++){
+    adj_lst_base_init(&a, &g);
+    if (i == 0){
+      adj_lst_dir_build(&a, &g);
+    }else{
+      adj_lst_undir_build(&a, &g);
+    }
+    ch_build(&ch, &a, add_uint, cmp_uint);
+    ch_ws_init(&ws, &ch, cmp_uint);
+    for (j = 0; j < a.num_vts; j++){
+      dijkstra(&a, j, dist, prev, NULL, add_uint, cmp_uint);
+      for (m = 0; m < a.num_vts; m++){
+	wt = C_SIZE_MAX;
+	res *= ((ch_query(&ch, j, m, &wt, &ws, add_uint, cmp_uint) ==
+		 C_SIZE_MAX) == (prev[m] == C_SIZE_MAX));
+	res *= (prev[m] == C_SIZE_MAX || wt == dist[m]);
+      }
+    }
+    ch_ws_free(&ws);
+    ch_free(&ch);
+    adj_lst_free(&a);
+  }
+  printf("\tdirected and undirected graphs: ");
+  print_test_result(res);
+  graph_free(&g);
+  free(dist);
+  free(prev);
+  dist = NULL;
+  prev = NULL;
+}
+
+/**
+   Run a test on random geometric graphs with Euclidean double weights. The
+   vertices are random points in a unit square, and an undirected edge
+   connects two points within a radius, which is a multiple of
+   sqrt(log(n) / (pi n)).
+*/
+
+void add_double(void *sum, const void *wt_a, const void *wt_b){
+  *(double *)sum = *(double *)wt_a + *(double *)wt_b;
+}
+
+int cmp_double(const void *a, const void *b){
+  if (*(double *)a > *(double *)b){
+    return 1;
+  }else if (*(double *)a < *(double *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+double euclid(const double *x, const double *y, size_t u, size_t v){
+  return sqrt((x[u] - x[v]) * (x[u] - x[v]) + (y[u] - y[v]) * (y[u] - y[v]));
+}
+
+int bern_one(void *arg){
+  (void)arg;
+  return 1;
+}
+
+void adj_lst_rand_geo(adj_lst_t *a,
+		      double *x,
+		      double *y,
+		      size_t n,
+		      double rad){
+  size_t i, j;
+  double wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(double),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n; i++){
+    x[i] = DRAND();
+    y[i] = DRAND();
+  }
+  for (i = 0; i < n; i++){
+    for (j = i + 1; j < n; j++){
+      wt = euclid(x, y, i, j);
+      if (wt <= rad) adj_lst_add_undir_edge(a, i, j, &wt, bern_one, NULL);
+    }
+  }
+  graph_free(&g);
+}
+
+int same_dist(double a, double b){
+  double d = (a > b) ? a - b : b - a;
+  return d <= C_REL_ERR * ((a > b) ? a : b);
+}
+
+void run_geo_test(int pow_start, int pow_end){
+  int i, j, k;
+  int res = 1;
+  size_t n, m;
+  size_t *rand_start = NULL, *rand_target = NULL;
+  size_t *prev = NULL, *ref_prev = NULL;
+  double rad, wt;
+  double *x = NULL, *y = NULL;
+  double *dist = NULL, *ref_dist = NULL;
+  adj_lst_t a;
+  ch_t ch;
+  ch_ws_t ch_ws;
+  dijkstra_ws_t ws;
+  clock_t t_dijkstra, t_build, t_query;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  rand_target = malloc_perror(C_ITER, sizeof(size_t));
+  ref_dist = malloc_perror(C_ITER, sizeof(double));
+  ref_prev = malloc_perror(C_ITER, sizeof(size_t));
+  x = malloc_perror(pow_two(pow_end), sizeof(double));
+  y = malloc_perror(pow_two(pow_end), sizeof(double));
+  dist = malloc_perror(pow_two(pow_end), sizeof(double));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  printf("Run a ch test on random geometric graphs with Euclidean "
+	 "double weights\n");
+  fflush(stdout);
+  for (k = 0; k < C_RAD_MULS_COUNT; k++){
+    printf("\tradius: %.1f * sqrt(log(n) / (pi n))\n", C_RAD_MULS[k]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      rad = C_RAD_MULS[k] * sqrt(log((double)n + 1.0) / (C_PI * n));
+      adj_lst_rand_geo(&a, x, y, n, rad);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+	rand_target[j] = RANDOM() % n;
+      }
+      dijkstra_ws_init(&ws, n, sizeof(double), NULL, cmp_double);
+      t_dijkstra = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws_target(&a, rand_start[j], rand_target[j], dist, prev,
+			   &ws, add_double, cmp_double);
+	ref_dist[j] = dist[rand_target[j]];
+	ref_prev[j] = prev[rand_target[j]];
+      }
+      t_dijkstra = clock() - t_dijkstra;
+      dijkstra_ws_free(&ws);
+      t_build = clock();
+      ch_build(&ch, &a, add_double, cmp_double);
+      t_build = clock() - t_build;
+      ch_ws_init(&ch_ws, &ch, cmp_double);
+      t_query = clock();
+      for (j = 0; j < C_ITER; j++){
+	m = ch_query(&ch, rand_start[j], rand_target[j], &wt, &ch_ws,
+		     add_double, cmp_double);
+	res *= ((m == C_SIZE_MAX) == (ref_prev[j] == C_SIZE_MAX));
+	res *= (m == C_SIZE_MAX || same_dist(wt, ref_dist[j]));
+      }
+      t_query = clock() - t_query;
+      printf("\t\tvertices: %lu, # of directed edges: %lu, "
+	     "# of shortcuts: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es), TOLU(ch.num_scs));
+      printf("\t\t\tch_build runtime:               %.8f seconds\n"
+	     "\t\t\tdijkstra_ws_target ave runtime: %.8f seconds\n"
+	     "\t\t\tch_query ave runtime:           %.8f seconds\n",
+	     (float)t_build / CLOCKS_PER_SEC,
+	     (float)t_dijkstra / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_query / C_ITER / CLOCKS_PER_SEC);
+      printf("\t\t\tcorrectness:                    ");
+      print_test_result(res);
+      res = 1;
+      ch_ws_free(&ch_ws);
+      ch_free(&ch);
+      adj_lst_free(&a);
+    }
+  }
+  free(rand_start);
+  free(rand_target);
+  free(ref_dist);
+  free(ref_prev);
+  free(x);
+  free(y);
+  free(dist);
+  free(prev);
+  rand_start = NULL;
+  rand_target = NULL;
+  ref_dist = NULL;
+  ref_prev = NULL;
+  x = NULL;
+  y = NULL;
+  dist = NULL;
+  prev = NULL;
+}
+
+/**
+   Run a test on random sparse directed graphs with random size_t weights,
+   where each of n(n - 1) possible edges is added with the probability of
+   an expected out-degree divided by n - 1.
+*/
+
+typedef struct{
+  double p;
+} bern_arg_t;
+
+int bern(void *arg){
+  bern_arg_t *b = arg;
+  if (b->p >= 1.0) return 1;
+  if (b->p <= 0.0) return 0;
+  if (b->p > DRAND()) return 1;
+  return 0;
+}
+
+void adj_lst_rand_dir_uint(adj_lst_t *a, size_t n, double p){
+  size_t i, j, wt;
+  bern_arg_t b;
+  graph_t g;
+  b.p = p;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t),
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n; i++){
+    for (j = 0; j < n; j++){
+      if (i == j) continue;
+      wt = DRAND() * C_WEIGHT_HIGH;
+      adj_lst_add_dir_edge(a, i, j, &wt, bern, &b);
+    }
+  }
+  graph_free(&g);
+}
+
+void run_rand_dir_test(int pow_start, int pow_end){
+  int i, j, k;
+  int res = 1;
+  size_t n, m, wt;
+  size_t *rand_start = NULL, *rand_target = NULL;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *ref_dist = NULL, *ref_prev = NULL;
+  adj_lst_t a;
+  ch_t ch;
+  ch_ws_t ch_ws;
+  dijkstra_ws_t ws;
+  clock_t t_dijkstra, t_build, t_query;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  rand_target = malloc_perror(C_ITER, sizeof(size_t));
+  ref_dist = malloc_perror(C_ITER, sizeof(size_t));
+  ref_prev = malloc_perror(C_ITER, sizeof(size_t));
+  dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  printf("Run a ch test on random sparse directed graphs with random "
+	 "size_t weights in [0, %lu]\n", TOLU(C_WEIGHT_HIGH));
+  fflush(stdout);
+  for (k = 0; k < C_DEGS_COUNT; k++){
+    printf("\texpected out-degree: %.1f\n", C_DEGS[k]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      adj_lst_rand_dir_uint(&a, n, (n > 1) ? C_DEGS[k] / (n - 1) : 0.0);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+	rand_target[j] = RANDOM() % n;
+      }
+      dijkstra_ws_init(&ws, n, sizeof(size_t), NULL, cmp_uint);
+      t_dijkstra = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws_target(&a, rand_start[j], rand_target[j], dist, prev,
+			   &ws, add_uint, cmp_uint);
+	ref_dist[j] = dist[rand_target[j]];
+	ref_prev[j] = prev[rand_target[j]];
+      }
+      t_dijkstra = clock() - t_dijkstra;
+      dijkstra_ws_free(&ws);
+      t_build = clock();
+      ch_build(&ch, &a, add_uint, cmp_uint);
+      t_build = clock() - t_build;
+      ch_ws_init(&ch_ws, &ch, cmp_uint);
+      t_query = clock();
+      for (j = 0; j < C_ITER; j++){
+	m = ch_query(&ch, rand_start[j], rand_target[j], &wt, &ch_ws,
+		     add_uint, cmp_uint);
+	res *= ((m == C_SIZE_MAX) == (ref_prev[j] == C_SIZE_MAX));
+	res *= (m == C_SIZE_MAX || wt == ref_dist[j]);
+      }
+      t_query = clock() - t_query;
+      printf("\t\tvertices: %lu, # of directed edges: %lu, "
+	     "# of shortcuts: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es), TOLU(ch.num_scs));
+      printf("\t\t\tch_build runtime:               %.8f seconds\n"
+	     "\t\t\tdijkstra_ws_target ave runtime: %.8f seconds\n"
+	     "\t\t\tch_query ave runtime:           %.8f seconds\n",
+	     (float)t_build / CLOCKS_PER_SEC,
+	     (float)t_dijkstra / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_query / C_ITER / CLOCKS_PER_SEC);
+      printf("\t\t\tcorrectness:                    ");
+      print_test_result(res);
+      res = 1;
+      ch_ws_free(&ch_ws);
+      ch_free(&ch);
+      adj_lst_free(&a);
+    }
+  }
+  free(rand_start);
+  free(rand_target);
+  free(ref_dist);
+  free(ref_prev);
+  free(dist);
+  free(prev);
+  rand_start = NULL;
+  rand_target = NULL;
+  ref_dist = NULL;
+  ref_prev = NULL;
+  dist = NULL;
+  prev = NULL;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT / 2 ||
+      args[1] > C_FULL_BIT / 2 ||
+      args[1] < args[0] ||
+      args[2] > 1 ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[2]) run_uint_graph_test();
+  if (args[3]) run_geo_test(args[0], args[1]);
+  if (args[4]) run_rand_dir_test(args[0], args[1]);
+  free(args);
+  args = NULL;
+  return 0;
+}
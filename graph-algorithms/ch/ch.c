@@ -0,0 +1,636 @@
+/**
+   ch.c
+
+   Contraction hierarchies of graphs with generic non-negative weights and
+   point-to-point shortest path queries on the hierarchies.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The weight functions are as in dijkstra.
+
+   A contraction hierarchy is built by contracting the vertices one by one
+   in the order of a rank. When a vertex v is contracted, a shortcut edge
+   (u, w) with the weight of the path (u, v, w) is added for each pair of
+   edges (u, v) and (v, w) between uncontracted vertices, unless a witness
+   search finds a path from u to w that avoids v and is not heavier. The
+   hierarchy consists of the upward edges (u, w) with rank[u] < rank[w],
+   and the downward edges with rank[u] > rank[w] in reverse, across the
+   edges of the graph and the shortcuts.
+
+   The build keeps the remaining graph in an adjacency list of outgoing
+   edges and an adjacency list of incoming edges with size_t vertices. The
+   lists contain at most one edge from u to w, with the minimal weight
+   across the parallel edges and the shortcuts from u to w, and the edges
+   to contracted vertices are skipped. A witness search from u is a
+   Dijkstra's algorithm on the remaining graph without v that stops when
+   its minimal distance in the heap exceeds the maximal weight of the
+   paths (u, v, w), or when a number of vertices are settled, so that a
+   missed witness adds a shortcut that is not necessary, but does not
+   affect the distances of queries. The number is C_WIT_MAX_SETTLED in a
+   contraction, and the lower C_WIT_SIM_MAX_SETTLED in a simulated
+   contraction that counts the shortcuts for a priority.
+
+   The vertices are contracted in the order of a priority that is the
+   number of shortcuts the contraction of a vertex adds, minus its number
+   of edges to uncontracted vertices, plus the number of its contracted
+   neighbors. The priorities are updated lazily: the number of contracted
+   neighbors of each neighbor of a contracted vertex is incremented, and
+   the priority of a popped vertex is recomputed and the vertex is pushed
+   again if its priority increased. A recomputation of the priorities of
+   the neighbors after each contraction would run a simulated contraction
+   for each neighbor, which dominates the time of a build when the degrees
+   of the remaining vertices grow with the shortcuts.
+
+   A query runs a bidirectional Dijkstra's algorithm from start on the
+   upward edges and from target on the reversed downward edges in CSR
+   adjacency lists, and alternates between the searches. A vertex settled
+   by a search that was reached by the opposite search updates the
+   shortest path found, and a search stops when its minimal distance in
+   the heap is not less than the weight of the shortest path found.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ch.h"
+#include "graph.h"
+#include "heap.h"
+#include "stack.h"
+#include "utilities-mem.h"
+
+typedef struct{
+  size_t wt_size;
+  adj_lst_t out;            /* outgoing edges of the remaining graph */
+  adj_lst_t in;             /* incoming edges of the remaining graph */
+  unsigned char *is_contr;
+  size_t *num_contr_nbrs;
+  size_t *mark;             /* 1 + last contracted neighbor */
+  void *wt_bufs;            /* three weight buffers */
+  ch_search_t wit;
+  void (*add_wt)(void *, const void *, const void *);
+  int (*cmp_wt)(const void *, const void *);
+} ch_build_t;
+
+static const size_t C_NONE = (size_t)-1;
+static const size_t C_WIT_MAX_SETTLED = 128;
+static const size_t C_WIT_SIM_MAX_SETTLED = 16;
+
+/* build operations */
+static void build_init(ch_build_t *b,
+		       const adj_lst_t *a,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *));
+static void build_free(ch_build_t *b);
+static void add_arc(ch_build_t *b, size_t u, size_t w, const void *wt);
+static void decr_arc(const adj_lst_t *a,
+		     size_t u,
+		     size_t w,
+		     const void *wt,
+		     int (*cmp_wt)(const void *, const void *),
+		     int *is_found);
+static size_t contract(ch_build_t *b, size_t v, int is_sim);
+static void witness_search(ch_build_t *b,
+			   size_t u,
+			   size_t v,
+			   const void *bound,
+			   size_t max_settled);
+static long int priority(ch_build_t *b, size_t v);
+static void hierarchy_build(ch_t *ch, const ch_build_t *b);
+
+/* search operations */
+static void search_init(ch_search_t *s,
+			size_t num_vts,
+			size_t wt_size,
+			int (*cmp_wt)(const void *, const void *));
+static void search_begin(ch_search_t *s, size_t start, size_t wt_size);
+static void search_free(ch_search_t *s);
+
+/* auxiliary functions */
+static int bern_one(void *arg);
+static int cmp_long(const void *a, const void *b);
+static void *wt_ptr(const void *wts, size_t i, size_t wt_size);
+
+/**
+   Builds a contraction hierarchy of a graph given by an adjacency list.
+   The adjacency list is not modified and can be freed after the build.
+   ch          : pointer to a preallocated block of size sizeof(ch_t)
+   a           : pointer to an adjacency list with at least one vertex and
+                 non-negative weights
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void ch_build(ch_t *ch,
+	      const adj_lst_t *a,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL;
+  size_t i, j, v, x, r = 0;
+  long int pty, pty_new;
+  const stack_t *s = NULL;
+  ch_build_t b;
+  heap_t h;
+  ch->num_vts = a->num_vts;
+  ch->wt_size = a->wt_size;
+  ch->num_scs = 0;
+  ch->rank = malloc_perror(a->num_vts, sizeof(size_t));
+  build_init(&b, a, add_wt, cmp_wt);
+  heap_init(&h, sizeof(long int), sizeof(size_t), a->num_vts, 0, 0, NULL,
+	    cmp_long, NULL, NULL, NULL);
+  for (v = 0; v < a->num_vts; v++){
+    pty = priority(&b, v);
+    heap_push(&h, &pty, &v);
+  }
+  while (h.num_elts > 0){
+    heap_pop(&h, &pty, &v);
+    pty_new = priority(&b, v);
+    if (pty_new > pty){
+      heap_push(&h, &pty_new, &v);
+      continue;
+    }
+    ch->num_scs += contract(&b, v, 0);
+    b.is_contr[v] = 1;
+    ch->rank[v] = r++;
+    /* count v at the uncontracted neighbors */
+    for (i = 0; i < 2; i++){
+      s = (i == 0) ? b.out.vt_wts[v] : b.in.vt_wts[v];
+      p = s->elts;
+      for (j = 0; j < s->num_elts; j++){
+	x = *(const size_t *)p;
+	p += b.out.pair_size;
+	if (b.is_contr[x] || b.mark[x] == v + 1) continue;
+	b.mark[x] = v + 1;
+	b.num_contr_nbrs[x]++;
+      }
+    }
+  }
+  heap_free(&h);
+  hierarchy_build(ch, &b);
+  build_free(&b);
+}
+
+/**
+   Initializes a workspace for queries on a contraction hierarchy.
+   ws          : pointer to a preallocated block of size sizeof(ch_ws_t)
+   ch          : pointer to a contraction hierarchy built with ch_build
+   cmp_wt      : comparison function as specified in ch_build, and used by
+                 each query with the workspace
+*/
+void ch_ws_init(ch_ws_t *ws,
+		const ch_t *ch,
+		int (*cmp_wt)(const void *, const void *)){
+  ws->wt_size = ch->wt_size;
+  ws->wt_bufs = malloc_perror(3, ch->wt_size);
+  search_init(&ws->fwd, ch->num_vts, ch->wt_size, cmp_wt);
+  search_init(&ws->bwd, ch->num_vts, ch->wt_size, cmp_wt);
+}
+
+/**
+   Runs a query from start to target on a contraction hierarchy. Returns
+   the vertex with the highest rank on a shortest path from start to
+   target, or the maximal value of size_t if target is not reachable from
+   start. If a vertex is returned, the weight of a shortest path is copied
+   to the block pointed to by wt.
+   ch          : pointer to a contraction hierarchy built with ch_build
+   start       : start vertex
+   target      : target vertex
+   wt          : pointer to a preallocated block of size wt_size
+   ws          : pointer to a workspace initialized with ch_ws_init
+   add_wt      : addition function as specified in ch_build
+   cmp_wt      : comparison function as specified in ch_build
+*/
+size_t ch_query(const ch_t *ch,
+		size_t start,
+		size_t target,
+		void *wt,
+		ch_ws_t *ws,
+		void (*add_wt)(void *, const void *, const void *),
+		int (*cmp_wt)(const void *, const void *)){
+  int d = 0;
+  int is_done[2] = {0, 0};
+  const char *p = NULL, *p_end = NULL;
+  size_t wt_size = ch->wt_size;
+  size_t u, v, m = C_NONE;
+  void *u_wt = ws->wt_bufs;
+  void *sum_wt = wt_ptr(ws->wt_bufs, 1, wt_size);
+  void *mu = wt_ptr(ws->wt_bufs, 2, wt_size);
+  void *v_wt = NULL;
+  const adj_csr_t *c = NULL;
+  ch_search_t *s = NULL, *o = NULL;
+  search_begin(&ws->fwd, start, wt_size);
+  search_begin(&ws->bwd, target, wt_size);
+  while (!is_done[0] || !is_done[1]){
+    if (is_done[d]){
+      d = 1 - d;
+      continue;
+    }
+    c = (d == 0) ? &ch->up : &ch->down;
+    s = (d == 0) ? &ws->fwd : &ws->bwd;
+    o = (d == 0) ? &ws->bwd : &ws->fwd;
+    if (s->h.num_elts == 0){
+      is_done[d] = 1;
+      continue;
+    }
+    heap_pop(&s->h, u_wt, &u);
+    if (m != C_NONE && cmp_wt(u_wt, mu) >= 0){
+      is_done[d] = 1;
+      continue;
+    }
+    if (o->is_reached[u]){
+      add_wt(sum_wt, u_wt, wt_ptr(o->dist, u, wt_size));
+      if (m == C_NONE || cmp_wt(sum_wt, mu) < 0){
+	memcpy(mu, sum_wt, wt_size);
+	m = u;
+      }
+    }
+    /* a hierarchy stores size_t vertices */
+    p = (const char *)c->vt_wts + c->offsets[u] * c->pair_size;
+    p_end = (const char *)c->vt_wts + c->offsets[u + 1] * c->pair_size;
+    for (; p != p_end; p += c->pair_size){
+      v = *(const size_t *)p;
+      v_wt = wt_ptr(s->dist, v, wt_size);
+      add_wt(sum_wt, u_wt, p + c->wt_offset);
+      if (!s->is_reached[v]){
+	memcpy(v_wt, sum_wt, wt_size);
+	heap_push(&s->h, v_wt, &v);
+	s->is_reached[v] = 1;
+	stack_push(&s->vts, &v);
+      }else if (cmp_wt(v_wt, sum_wt) > 0){
+	/* must be in the heap */
+	memcpy(v_wt, sum_wt, wt_size);
+	heap_update(&s->h, v_wt, &v);
+      }
+    }
+    d = 1 - d;
+  }
+  if (m != C_NONE) memcpy(wt, mu, wt_size);
+  return m;
+}
+
+/**
+   Frees a workspace and leaves a block of size sizeof(ch_ws_t) pointed to
+   by the ws parameter.
+*/
+void ch_ws_free(ch_ws_t *ws){
+  free(ws->wt_bufs);
+  ws->wt_bufs = NULL;
+  search_free(&ws->fwd);
+  search_free(&ws->bwd);
+}
+
+/**
+   Frees a contraction hierarchy and leaves a block of size sizeof(ch_t)
+   pointed to by the ch parameter.
+*/
+void ch_free(ch_t *ch){
+  free(ch->rank);
+  ch->rank = NULL;
+  adj_csr_free(&ch->up);
+  adj_csr_free(&ch->down);
+}
+
+/** Helper functions */
+
+/**
+   Initializes the state of a build with the remaining graph of an
+   adjacency list without self-loops and parallel edges.
+*/
+static void build_init(ch_build_t *b,
+		       const adj_lst_t *a,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL;
+  size_t i, j, v;
+  graph_t g;
+  b->wt_size = a->wt_size;
+  graph_base_init(&g, a->num_vts, sizeof(size_t), a->wt_size,
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(&b->out, &g);
+  adj_lst_base_init(&b->in, &g);
+  graph_free(&g);
+  b->is_contr = calloc_perror(a->num_vts, 1);
+  b->num_contr_nbrs = calloc_perror(a->num_vts, sizeof(size_t));
+  b->mark = calloc_perror(a->num_vts, sizeof(size_t));
+  b->wt_bufs = malloc_perror(3, a->wt_size);
+  search_init(&b->wit, a->num_vts, a->wt_size, cmp_wt);
+  b->add_wt = add_wt;
+  b->cmp_wt = cmp_wt;
+  for (i = 0; i < a->num_vts; i++){
+    p = a->vt_wts[i]->elts;
+    for (j = 0; j < a->vt_wts[i]->num_elts; j++){
+      v = a->read_vt(p);
+      if (v != i) add_arc(b, i, v, p + a->wt_offset);
+      p += a->pair_size;
+    }
+  }
+}
+
+/**
+   Frees the state of a build.
+*/
+static void build_free(ch_build_t *b){
+  adj_lst_free(&b->out);
+  adj_lst_free(&b->in);
+  free(b->is_contr);
+  free(b->num_contr_nbrs);
+  free(b->mark);
+  free(b->wt_bufs);
+  b->is_contr = NULL;
+  b->num_contr_nbrs = NULL;
+  b->mark = NULL;
+  b->wt_bufs = NULL;
+  search_free(&b->wit);
+}
+
+/**
+   Adds an edge (u, w) with a weight to the remaining graph, or decreases
+   the weight of the edge (u, w) in the remaining graph to the weight if
+   the weight is less.
+*/
+static void add_arc(ch_build_t *b, size_t u, size_t w, const void *wt){
+  int is_found = 0;
+  decr_arc(&b->out, u, w, wt, b->cmp_wt, &is_found);
+  if (is_found){
+    decr_arc(&b->in, w, u, wt, b->cmp_wt, &is_found);
+    return;
+  }
+  adj_lst_add_dir_edge(&b->out, u, w, wt, bern_one, NULL);
+  adj_lst_add_dir_edge(&b->in, w, u, wt, bern_one, NULL);
+}
+
+/**
+   Searches the list of a vertex u in an adjacency list with size_t
+   vertices for the pair of a vertex w, and if the pair is found, sets
+   is_found to 1 and decreases its weight to a weight if the weight is
+   less.
+*/
+static void decr_arc(const adj_lst_t *a,
+		     size_t u,
+		     size_t w,
+		     const void *wt,
+		     int (*cmp_wt)(const void *, const void *),
+		     int *is_found){
+  size_t i;
+  char *p = a->vt_wts[u]->elts;
+  for (i = 0; i < a->vt_wts[u]->num_elts; i++){
+    if (*(const size_t *)p == w){
+      if (cmp_wt(p + a->wt_offset, wt) > 0){
+	memcpy(p + a->wt_offset, wt, a->wt_size);
+      }
+      *is_found = 1;
+      return;
+    }
+    p += a->pair_size;
+  }
+}
+
+/**
+   Counts the shortcuts that are added by the contraction of a vertex v,
+   and adds the shortcuts to the remaining graph if is_sim is 0. For each
+   incoming edge (u, v), a witness search from u is run with the maximal
+   weight of the paths (u, v, w) as the bound.
+*/
+static size_t contract(ch_build_t *b, size_t v, int is_sim){
+  const char *p_in = NULL, *p_out = NULL;
+  size_t i, j, u, w;
+  size_t pair_size = b->out.pair_size, wt_offset = b->out.wt_offset;
+  size_t num_in = b->in.vt_wts[v]->num_elts;
+  size_t num_out = b->out.vt_wts[v]->num_elts;
+  size_t num_scs = 0;
+  int is_bound;
+  void *sum_wt = b->wt_bufs;
+  void *bound = wt_ptr(b->wt_bufs, 1, b->wt_size);
+  const ch_search_t *s = &b->wit;
+  p_in = b->in.vt_wts[v]->elts;
+  for (i = 0; i < num_in; i++, p_in += pair_size){
+    u = *(const size_t *)p_in;
+    if (b->is_contr[u]) continue;
+    is_bound = 0;
+    p_out = b->out.vt_wts[v]->elts;
+    for (j = 0; j < num_out; j++, p_out += pair_size){
+      w = *(const size_t *)p_out;
+      if (b->is_contr[w] || w == u) continue;
+      b->add_wt(sum_wt, p_in + wt_offset, p_out + wt_offset);
+      if (!is_bound || b->cmp_wt(sum_wt, bound) > 0){
+	memcpy(bound, sum_wt, b->wt_size);
+	is_bound = 1;
+      }
+    }
+    if (!is_bound) continue;
+    witness_search(b, u, v, bound,
+		   is_sim ? C_WIT_SIM_MAX_SETTLED : C_WIT_MAX_SETTLED);
+    /* shortcuts do not change the lists of v */
+    p_out = b->out.vt_wts[v]->elts;
+    for (j = 0; j < num_out; j++, p_out += pair_size){
+      w = *(const size_t *)p_out;
+      if (b->is_contr[w] || w == u) continue;
+      b->add_wt(sum_wt, p_in + wt_offset, p_out + wt_offset);
+      if (s->is_reached[w] &&
+	  b->cmp_wt(wt_ptr(s->dist, w, b->wt_size), sum_wt) <= 0) continue;
+      num_scs++;
+      if (!is_sim) add_arc(b, u, w, sum_wt);
+    }
+  }
+  return num_scs;
+}
+
+/**
+   Runs a witness search from u on the remaining graph without v. The
+   search stops when its minimal distance in the heap exceeds bound or when
+   C_WIT_MAX_SETTLED vertices are settled. A vertex with a distance that
+   exceeds bound is not reached.
+*/
+static void witness_search(ch_build_t *b,
+			   size_t u,
+			   size_t v,
+			   const void *bound,
+			   size_t max_settled){
+  const char *p = NULL;
+  size_t i, x, y;
+  size_t wt_size = b->wt_size;
+  size_t num_settled = 0;
+  void *x_wt = wt_ptr(b->wt_bufs, 2, wt_size);
+  void *sum_wt = b->wt_bufs;
+  void *y_wt = NULL;
+  const stack_t *sx = NULL;
+  ch_search_t *s = &b->wit;
+  search_begin(s, u, wt_size);
+  while (s->h.num_elts > 0 && num_settled < max_settled){
+    heap_pop(&s->h, x_wt, &x);
+    if (b->cmp_wt(x_wt, bound) > 0) break;
+    num_settled++;
+    sx = b->out.vt_wts[x];
+    p = sx->elts;
+    for (i = 0; i < sx->num_elts; i++, p += b->out.pair_size){
+      y = *(const size_t *)p;
+      if (b->is_contr[y] || y == v) continue;
+      b->add_wt(sum_wt, x_wt, p + b->out.wt_offset);
+      if (b->cmp_wt(sum_wt, bound) > 0) continue;
+      y_wt = wt_ptr(s->dist, y, wt_size);
+      if (!s->is_reached[y]){
+	memcpy(y_wt, sum_wt, wt_size);
+	heap_push(&s->h, y_wt, &y);
+	s->is_reached[y] = 1;
+	stack_push(&s->vts, &y);
+      }else if (b->cmp_wt(y_wt, sum_wt) > 0){
+	/* must be in the heap */
+	memcpy(y_wt, sum_wt, wt_size);
+	heap_update(&s->h, y_wt, &y);
+      }
+    }
+  }
+}
+
+/**
+   Computes the priority of an uncontracted vertex in the contraction
+   order. A vertex with a lower priority is contracted earlier.
+*/
+static long int priority(ch_build_t *b, size_t v){
+  const char *p = NULL;
+  size_t i, j, num_es = 0;
+  const stack_t *s = NULL;
+  for (i = 0; i < 2; i++){
+    s = (i == 0) ? b->out.vt_wts[v] : b->in.vt_wts[v];
+    p = s->elts;
+    for (j = 0; j < s->num_elts; j++, p += b->out.pair_size){
+      if (!b->is_contr[*(const size_t *)p]) num_es++;
+    }
+  }
+  return ((long int)contract(b, v, 1) - (long int)num_es +
+	  (long int)b->num_contr_nbrs[v]);
+}
+
+/**
+   Builds the CSR adjacency lists of the upward edges and the reversed
+   downward edges of a hierarchy from the remaining graph of a build after
+   all vertices are contracted, which contains the edges of the graph and
+   the shortcuts.
+*/
+static void hierarchy_build(ch_t *ch, const ch_build_t *b){
+  const char *p = NULL;
+  size_t i, j, v;
+  size_t wt_size = b->wt_size;
+  const stack_t *s = NULL;
+  graph_t g_up, g_down;
+  graph_t *g = NULL;
+  graph_base_init(&g_up, ch->num_vts, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  graph_base_init(&g_down, ch->num_vts, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  if (b->out.num_es > 0){
+    g_up.u = malloc_perror(b->out.num_es, sizeof(size_t));
+    g_up.v = malloc_perror(b->out.num_es, sizeof(size_t));
+    g_up.wts = malloc_perror(b->out.num_es, wt_size);
+    g_down.u = malloc_perror(b->out.num_es, sizeof(size_t));
+    g_down.v = malloc_perror(b->out.num_es, sizeof(size_t));
+    g_down.wts = malloc_perror(b->out.num_es, wt_size);
+  }
+  for (i = 0; i < ch->num_vts; i++){
+    s = b->out.vt_wts[i];
+    p = s->elts;
+    for (j = 0; j < s->num_elts; j++, p += b->out.pair_size){
+      v = *(const size_t *)p;
+      if (ch->rank[i] < ch->rank[v]){
+	g = &g_up;
+	((size_t *)g->u)[g->num_es] = i;
+	((size_t *)g->v)[g->num_es] = v;
+      }else{
+	g = &g_down;
+	((size_t *)g->u)[g->num_es] = v;
+	((size_t *)g->v)[g->num_es] = i;
+      }
+      memcpy(wt_ptr(g->wts, g->num_es, wt_size), p + b->out.wt_offset,
+	     wt_size);
+      g->num_es++;
+    }
+  }
+  adj_csr_base_init(&ch->up, &g_up);
+  adj_csr_dir_build(&ch->up, &g_up);
+  adj_csr_base_init(&ch->down, &g_down);
+  adj_csr_dir_build(&ch->down, &g_down);
+  graph_free(&g_up);
+  graph_free(&g_down);
+}
+
+/**
+   Initializes a search with a heap with an index array.
+*/
+static void search_init(ch_search_t *s,
+			size_t num_vts,
+			size_t wt_size,
+			int (*cmp_wt)(const void *, const void *)){
+  s->dist = malloc_perror(num_vts, wt_size);
+  s->is_reached = calloc_perror(num_vts, 1);
+  heap_init(&s->h, wt_size, sizeof(size_t), num_vts, 0, 0, NULL,
+	    cmp_wt, NULL, NULL, NULL);
+  stack_init(&s->vts, 1, sizeof(size_t), NULL);
+}
+
+/**
+   Resets a search at the vertices reached in the previous search, and
+   pushes start with a zero distance, as in dijkstra.
+*/
+static void search_begin(ch_search_t *s, size_t start, size_t wt_size){
+  size_t i;
+  const size_t *vts = s->vts.elts;
+  for (i = 0; i < s->vts.num_elts; i++){
+    s->is_reached[vts[i]] = 0;
+  }
+  s->vts.num_elts = 0;
+  heap_reset(&s->h);
+  memset(wt_ptr(s->dist, start, wt_size), 0, wt_size);
+  heap_push(&s->h, wt_ptr(s->dist, start, wt_size), &start);
+  s->is_reached[start] = 1;
+  stack_push(&s->vts, &start);
+}
+
+/**
+   Frees a search.
+*/
+static void search_free(ch_search_t *s){
+  free(s->dist);
+  free(s->is_reached);
+  s->dist = NULL;
+  s->is_reached = NULL;
+  heap_free(&s->h);
+  stack_free(&s->vts);
+}
+
+/**
+   Adds an edge in adj_lst_add_dir_edge.
+*/
+static int bern_one(void *arg){
+  (void)arg;
+  return 1;
+}
+
+/**
+   Compares long int priorities of the contraction order.
+*/
+static int cmp_long(const void *a, const void *b){
+  if (*(const long int *)a > *(const long int *)b){
+    return 1;
+  }else if (*(const long int *)a < *(const long int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/**
+   Computes a pointer to an entry in an array of weights.
+*/
+static void *wt_ptr(const void *wts, size_t i, size_t wt_size){
+  return (void *)((char *)wts + i * wt_size);
+}
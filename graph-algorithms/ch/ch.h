@@ -0,0 +1,141 @@
+/**
+   ch.h
+
+   Struct declarations and declarations of accessible functions for
+   building a contraction hierarchy of a graph with generic non-negative
+   weights, and for running point-to-point shortest path queries on the
+   hierarchy.
+
+   Vertices are indexed from 0. Edge weights are of any basic type (e.g.
+   char, int, long, float, double), or are custom weights within a
+   contiguous block (e.g. pair of 64-bit segments to address the potential
+   overflow due to addition). The weight functions are as in dijkstra.
+
+   A contraction hierarchy is built by contracting the vertices one by one
+   in the order of a rank. When a vertex v is contracted, a shortcut edge
+   (u, w) with the weight of the path (u, v, w) is added for each pair of
+   edges (u, v) and (v, w) between uncontracted vertices, unless a witness
+   search finds a path from u to w that avoids v and is not heavier. The
+   hierarchy consists of the upward edges (u, w) with rank[u] < rank[w],
+   and the downward edges with rank[u] > rank[w] in reverse, across the
+   edges of the graph and the shortcuts. The vertices are contracted in
+   the order of a priority that is the number of shortcuts the contraction
+   of a vertex adds, minus its number of edges to uncontracted vertices,
+   plus the number of its contracted neighbors, so that the number of
+   shortcuts is small on sparse graphs such as road networks.
+
+   A query runs a bidirectional Dijkstra's algorithm from start on the
+   upward edges and from target on the reversed downward edges, and the
+   weight of a shortest path is the minimum across the vertices reached by
+   both searches of the sum of their distances. A search stops when its
+   minimal distance in the heap is not less than the minimum found. A
+   query runs with a workspace that is allocated once per thread, with the
+   heaps and distances reset in O(number of vertices reached in the
+   previous query) time.
+
+   The hierarchy is built once and queried without modification, so that
+   queries with distinct workspaces can run concurrently.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99.
+*/
+
+#ifndef CH_H
+#define CH_H
+
+#include <stddef.h>
+#include "graph.h"
+#include "heap.h"
+#include "stack.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t wt_size;
+  size_t num_scs;  /* number of shortcuts */
+  size_t *rank;    /* contraction order of each vertex */
+  adj_csr_t up;    /* (u, w) with rank[u] < rank[w] */
+  adj_csr_t down;  /* (w, u) for (u, w) with rank[u] > rank[w] */
+} ch_t;
+
+typedef struct{
+  void *dist;
+  unsigned char *is_reached;
+  heap_t h;
+  stack_t vts;     /* size_t vertices reached in the last search */
+} ch_search_t;
+
+typedef struct{
+  size_t wt_size;
+  void *wt_bufs;   /* three weight buffers */
+  ch_search_t fwd;
+  ch_search_t bwd;
+} ch_ws_t;
+
+/**
+   Builds a contraction hierarchy of a graph given by an adjacency list.
+   The adjacency list is not modified and can be freed after the build.
+   ch          : pointer to a preallocated block of size sizeof(ch_t)
+   a           : pointer to an adjacency list with at least one vertex and
+                 non-negative weights
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   cmp_wt      : comparison function which returns a negative integer value
+                 if the weight value pointed to by the first argument is
+                 less than the weight value pointed to by the second, a
+                 positive integer value if the weight value pointed to by
+                 the first argument is greater than the weight value
+                 pointed to by the second, and zero integer value if the two
+                 weight values are equal
+*/
+void ch_build(ch_t *ch,
+	      const adj_lst_t *a,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Initializes a workspace for queries on a contraction hierarchy.
+   ws          : pointer to a preallocated block of size sizeof(ch_ws_t)
+   ch          : pointer to a contraction hierarchy built with ch_build
+   cmp_wt      : comparison function as specified in ch_build, and used by
+                 each query with the workspace
+*/
+void ch_ws_init(ch_ws_t *ws,
+		const ch_t *ch,
+		int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs a query from start to target on a contraction hierarchy. Returns
+   the vertex with the highest rank on a shortest path from start to
+   target, or the maximal value of size_t if target is not reachable from
+   start. If a vertex is returned, the weight of a shortest path is copied
+   to the block pointed to by wt.
+   ch          : pointer to a contraction hierarchy built with ch_build
+   start       : start vertex
+   target      : target vertex
+   wt          : pointer to a preallocated block of size wt_size
+   ws          : pointer to a workspace initialized with ch_ws_init
+   add_wt      : addition function as specified in ch_build
+   cmp_wt      : comparison function as specified in ch_build
+*/
+size_t ch_query(const ch_t *ch,
+		size_t start,
+		size_t target,
+		void *wt,
+		ch_ws_t *ws,
+		void (*add_wt)(void *, const void *, const void *),
+		int (*cmp_wt)(const void *, const void *));
+
+/**
+   Frees a workspace and leaves a block of size sizeof(ch_ws_t) pointed to
+   by the ws parameter.
+*/
+void ch_ws_free(ch_ws_t *ws);
+
+/**
+   Frees a contraction hierarchy and leaves a block of size sizeof(ch_t)
+   pointed to by the ch parameter.
+*/
+void ch_free(ch_t *ch);
+
+#endif
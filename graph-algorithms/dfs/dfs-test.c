@@ -16,11 +16,13 @@
      [0, 1] : on/off for max edges test
      [0, 1] : on/off for no edges test
      [0, 1] : on/off for rand graph test
+     [0, 1] : on/off for compressed list test on rand graphs
 
    usage examples: 
    ./dfs-test
    ./dfs-test 10 14 10 14 10 14
    ./dfs-test 10 14 10 14 10 14 0 1 1 1
+   ./dfs-test 10 14 10 14 10 14 0 0 0 0 1
 
    dfs-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -68,13 +70,15 @@ const char *C_USAGE =
   "[0, ushort width - 1) : c\n"
   "[0, ushort width - 1) : d s.t. 2**c <= V <= 2**d for no edges test\n"
   "[0, ushort width - 1) : e\n"
-  "[0, ushort width - 1) : f s.t. 2**e <= V <= 2**f for rand graph test\n"
+  "[0, ushort width - 1) : f s.t. 2**e <= V <= 2**f for rand graph test\n";
+const char *C_USAGE_TESTS = /* each string literal within 509 characters */
   "[0, 1] : on/off for small graph tests\n"
   "[0, 1] : on/off for max edges test\n"
   "[0, 1] : on/off for no edges test\n"
-  "[0, 1] : on/off for rand graph test\n";
-const int C_ARGC_MAX = 11;
-const size_t C_ARGS_DEF[10] = {0, 6, 0, 6, 0, 14, 1, 1, 1, 1};
+  "[0, 1] : on/off for rand graph test\n"
+  "[0, 1] : on/off for compressed list test\n";
+const int C_ARGC_MAX = 12;
+const size_t C_ARGS_DEF[11] = {0, 6, 0, 6, 0, 14, 1, 1, 1, 1, 1};
 const size_t C_USHORT_BIT = CHAR_BIT * sizeof(unsigned short);
 
 /* small graph test */
@@ -125,6 +129,17 @@ const unsigned long C_ULONG_DIR_POST_B[6] = {11, 10, 9, 8, 7, 6};
 const unsigned long C_ULONG_UNDIR_PRE_B[6] = {0, 1, 2, 3, 4, 5};
 const unsigned long C_ULONG_UNDIR_POST_B[6] = {11, 10, 9, 8, 7, 6};
 
+/* SCCs of the small graphs */
+const size_t C_DIR_K_A = 4;
+const unsigned short C_USHORT_DIR_COMP_A[6] = {2, 3, 3, 3, 0, 1};
+const unsigned short C_USHORT_DIR_ORDER_A[6] = {4, 5, 0, 1, 2, 3};
+const unsigned short C_USHORT_DIR_COMP_B[6] = {0, 1, 2, 3, 4, 5};
+const unsigned short C_USHORT_UNDIR_COMP[6] = {0, 0, 0, 0, 0, 0};
+const unsigned long C_ULONG_DIR_COMP_A[6] = {2, 3, 3, 3, 0, 1};
+const unsigned long C_ULONG_DIR_ORDER_A[6] = {4, 5, 0, 1, 2, 3};
+const unsigned long C_ULONG_DIR_COMP_B[6] = {0, 1, 2, 3, 4, 5};
+const unsigned long C_ULONG_UNDIR_COMP[6] = {0, 0, 0, 0, 0, 0};
+
 /* random graph tests */
 int cmp_ushort(const void *a, const void *b);
 int cmp_uint(const void *a, const void *b);
@@ -175,6 +190,7 @@ int cmp_arr(const void *a,
 	    size_t n,
 	    int (*cmp)(const void *, const void *));
 static void *ptr(const void *block, size_t i, size_t size);
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
 void print_test_result(int res);
 
 /**  
@@ -506,20 +522,112 @@ void small_graph_helper(const graph_t *g,
 			int *res){
   void *pre = NULL, *post = NULL;
   adj_lst_t a;
+  adj_csr_t c;
   adj_lst_base_init(&a, g);
+  adj_csr_base_init(&c, g);
   build(&a, g);
+  if (build == adj_lst_dir_build){
+    adj_csr_dir_build(&c, g);
+  }else{
+    adj_csr_undir_build(&c, g);
+  }
   pre = malloc_perror(a.num_vts, a.vt_size);
   post = malloc_perror(a.num_vts, a.vt_size);
   dfs(&a, start, pre, post, cmpat, incr);
   *res *= cmp_arr(pre, ret_pre, a.vt_size, a.num_vts, cmp);
   *res *= cmp_arr(post, ret_post, a.vt_size, a.num_vts, cmp);
+  dfs_csr(&c, start, pre, post, cmpat, incr);
+  *res *= cmp_arr(pre, ret_pre, a.vt_size, a.num_vts, cmp);
+  *res *= cmp_arr(post, ret_post, a.vt_size, a.num_vts, cmp);
   adj_lst_free(&a);
+  adj_csr_free(&c);
   free(pre);
   free(post);
   pre = NULL;
   post = NULL;
 }
 
+/**
+   Run dfs_scc and dfs_topo tests on small graphs.
+*/
+
+void small_scc_helper(const graph_t *g,
+		      size_t ret_k,
+		      const void *ret_comp,
+		      const void *ret_order,
+		      int ret_topo,
+		      void (*build)(adj_lst_t *, const graph_t *),
+		      int (*cmp)(const void *, const void *),
+		      int *res){
+  void *comp = NULL, *order = NULL;
+  adj_lst_t a;
+  adj_csr_t c;
+  adj_lst_base_init(&a, g);
+  adj_csr_base_init(&c, g);
+  build(&a, g);
+  if (build == adj_lst_dir_build){
+    adj_csr_dir_build(&c, g);
+  }else{
+    adj_csr_undir_build(&c, g);
+  }
+  comp = malloc_perror(a.num_vts, a.vt_size);
+  order = malloc_perror(a.num_vts, a.vt_size);
+  *res *= (dfs_scc(&a, comp, order) == ret_k);
+  *res *= cmp_arr(comp, ret_comp, a.vt_size, a.num_vts, cmp);
+  if (ret_order != NULL){
+    *res *= cmp_arr(order, ret_order, a.vt_size, a.num_vts, cmp);
+  }
+  *res *= (dfs_scc_csr(&c, comp, NULL) == ret_k);
+  *res *= cmp_arr(comp, ret_comp, a.vt_size, a.num_vts, cmp);
+  *res *= (dfs_topo(&a, order) == ret_topo);
+  *res *= (dfs_topo_csr(&c, order) == ret_topo);
+  if (ret_order != NULL){
+    *res *= cmp_arr(order, ret_order, a.vt_size, a.num_vts, cmp);
+  }
+  adj_lst_free(&a);
+  adj_csr_free(&c);
+  free(comp);
+  free(order);
+  comp = NULL;
+  order = NULL;
+}
+
+void run_scc_small_graph_test(){
+  int res = 1;
+  graph_t g;
+  printf("Run a dfs_scc and dfs_topo test on the small graphs with ushort "
+	 "vertices --> ");
+  ushort_none_graph_a_init(&g);
+  small_scc_helper(&g, C_DIR_K_A, C_USHORT_DIR_COMP_A,
+		   C_USHORT_DIR_ORDER_A, 1, adj_lst_dir_build, cmp_ushort,
+		   &res);
+  small_scc_helper(&g, 1, C_USHORT_UNDIR_COMP, NULL, 1,
+		   adj_lst_undir_build, cmp_ushort, &res);
+  ushort_none_graph_b_init(&g);
+  small_scc_helper(&g, C_NUM_VTS_B, C_USHORT_DIR_COMP_B,
+		   C_USHORT_DIR_COMP_B, 0, adj_lst_dir_build, cmp_ushort,
+		   &res);
+  small_scc_helper(&g, 1, C_USHORT_UNDIR_COMP, NULL, 1,
+		   adj_lst_undir_build, cmp_ushort, &res);
+  print_test_result(res);
+  res = 1;
+  printf("Run a dfs_scc and dfs_topo test on the small graphs with ulong "
+	 "vertices --> ");
+  ulong_ushort_graph_a_init(&g);
+  small_scc_helper(&g, C_DIR_K_A, C_ULONG_DIR_COMP_A,
+		   C_ULONG_DIR_ORDER_A, 1, adj_lst_dir_build, cmp_ulong,
+		   &res);
+  small_scc_helper(&g, 1, C_ULONG_UNDIR_COMP, NULL, 1,
+		   adj_lst_undir_build, cmp_ulong, &res);
+  ulong_ushort_graph_b_init(&g);
+  small_scc_helper(&g, C_NUM_VTS_B, C_ULONG_DIR_COMP_B,
+		   C_ULONG_DIR_COMP_B, 0, adj_lst_dir_build, cmp_ulong,
+		   &res);
+  small_scc_helper(&g, 1, C_ULONG_UNDIR_COMP, NULL, 1,
+		   adj_lst_undir_build, cmp_ulong, &res);
+  print_test_result(res);
+}
+
 /**  
    Test dfs on large graphs.
 */
@@ -691,6 +799,198 @@ void run_random_dir_graph_test(size_t log_start, size_t log_end){
   }
 }
 
+/**
+   Returns the number of SCCs of a graph with Kosaraju's algorithm on the
+   reversed graph r, given the postvisit values of a dfs run on the graph.
+*/
+size_t ref_scc_count(const adj_lst_t *r, const void *post){
+  size_t i, j, u, v;
+  size_t n = r->num_vts;
+  size_t num_vt_wts, num_s = 0, ret = 0;
+  size_t *by_post = NULL, *s = NULL;
+  const char *p = NULL;
+  char *vis = NULL;
+  by_post = malloc_perror(2 * n, sizeof(size_t));
+  s = malloc_perror(n, sizeof(size_t));
+  vis = calloc_perror(n, 1);
+  for (i = 0; i < 2 * n; i++){
+    by_post[i] = n;
+  }
+  for (i = 0; i < n; i++){
+    by_post[r->read_vt(ptr(post, i, r->vt_size))] = i;
+  }
+  for (i = 2 * n; i-- > 0; ){
+    u = by_post[i];
+    if (u == n || vis[u]) continue;
+    ret++;
+    vis[u] = 1;
+    s[num_s++] = u;
+    while (num_s > 0){
+      u = s[--num_s];
+      p = adj_lst_vt_wts(r, u, &num_vt_wts);
+      for (j = 0; j < num_vt_wts; j++){
+	v = r->read_vt(p);
+	if (!vis[v]){
+	  vis[v] = 1;
+	  s[num_s++] = v;
+	}
+	p += r->pair_size;
+      }
+    }
+  }
+  free(by_post);
+  free(s);
+  free(vis);
+  by_post = NULL;
+  s = NULL;
+  vis = NULL;
+  return ret;
+}
+
+/**
+   Returns 1 if comp and order are consistent with an SCC numbering in a
+   topological order of the condensation with k SCCs, otherwise returns 0.
+*/
+int check_scc(const adj_lst_t *a, size_t k, const void *comp,
+	      const void *order){
+  int res = 1;
+  size_t i, j, u, cu, prev = 0;
+  size_t num_vt_wts;
+  size_t vt_size = a->vt_size;
+  const char *p = NULL;
+  char *seen = NULL;
+  seen = calloc_perror(a->num_vts, 1);
+  for (i = 0; i < a->num_vts; i++){
+    cu = a->read_vt(ptr(comp, i, vt_size));
+    res *= (cu < k);
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      res *= (cu <= a->read_vt(ptr(comp, a->read_vt(p), vt_size)));
+      p += a->pair_size;
+    }
+    u = a->read_vt(ptr(order, i, vt_size));
+    res *= (u < a->num_vts && !seen[u]);
+    if (u < a->num_vts) seen[u] = 1;
+    if (res){
+      cu = a->read_vt(ptr(comp, u, vt_size));
+      res *= (cu >= prev);
+      prev = cu;
+    }
+  }
+  free(seen);
+  seen = NULL;
+  return res;
+}
+
+/**
+   Returns 1 if order is a topological order of the vertices, otherwise
+   returns 0.
+*/
+int check_topo(const adj_lst_t *a, const void *order){
+  int res = 1;
+  size_t i, j;
+  size_t num_vt_wts;
+  size_t *pos = NULL;
+  const char *p = NULL;
+  pos = malloc_perror(a->num_vts, sizeof(size_t));
+  for (i = 0; i < a->num_vts; i++){
+    pos[a->read_vt(ptr(order, i, a->vt_size))] = i;
+  }
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      res *= (pos[i] < pos[a->read_vt(p)]);
+      p += a->pair_size;
+    }
+  }
+  free(pos);
+  pos = NULL;
+  return res;
+}
+
+/**
+   Runs dfs_scc and dfs_topo on a random graph, the reversed graph, and the
+   acyclic subgraph with the edges (u, v) s.t. u < v, given the graph g
+   with the edges of the adjacency list and the postvisit values of a dfs
+   run.
+*/
+void run_random_scc_helper(const adj_lst_t *a,
+			   const adj_csr_t *c,
+			   graph_t *g,
+			   const void *post,
+			   const char *type_string){
+  int res = 1;
+  size_t i, k = 0, k_csr = 0;
+  size_t n = a->num_vts, vt_size = a->vt_size, num_es;
+  void *comp = NULL, *order = NULL, *comp_csr = NULL, *order_csr = NULL;
+  void *gu = NULL;
+  adj_lst_t r, d;
+  clock_t t, t_csr, t_topo;
+  comp = malloc_perror(n, vt_size);
+  order = malloc_perror(n, vt_size);
+  comp_csr = malloc_perror(n, vt_size);
+  order_csr = malloc_perror(n, vt_size);
+  t = clock();
+  for (i = 0; i < C_ITER; i++){
+    k = dfs_scc(a, comp, order);
+  }
+  t = clock() - t;
+  t_csr = clock();
+  for (i = 0; i < C_ITER; i++){
+    k_csr = dfs_scc_csr(c, comp_csr, order_csr);
+  }
+  t_csr = clock() - t_csr;
+  gu = g->u;
+  g->u = g->v;
+  g->v = gu;
+  adj_lst_base_init(&r, g);
+  adj_lst_dir_build(&r, g);
+  res *= (k == ref_scc_count(&r, post));
+  res *= check_scc(a, k, comp, order);
+  res *= (k == k_csr);
+  res *= (memcmp(comp, comp_csr, n * vt_size) == 0);
+  res *= (memcmp(order, order_csr, n * vt_size) == 0);
+  g->v = g->u;
+  g->u = gu;
+  t_topo = clock();
+  for (i = 0; i < C_ITER; i++){
+    res *= (dfs_topo(a, order) == (k < n));
+  }
+  t_topo = clock() - t_topo;
+  num_es = g->num_es;
+  g->num_es = 0;
+  for (i = 0; i < num_es; i++){
+    if (g->read_vt(ptr(g->u, i, vt_size)) <
+	g->read_vt(ptr(g->v, i, vt_size))){
+      memcpy(ptr(g->u, g->num_es, vt_size), ptr(g->u, i, vt_size), vt_size);
+      memcpy(ptr(g->v, g->num_es, vt_size), ptr(g->v, i, vt_size), vt_size);
+      g->num_es++;
+    }
+  }
+  adj_lst_base_init(&d, g);
+  adj_lst_dir_build(&d, g);
+  res *= (dfs_topo(&d, order) == 0);
+  res *= check_topo(&d, order);
+  printf("\t\t\t%s scc ave runtime:     %.6f seconds\n"
+	 "\t\t\t%s scc csr ave runtime: %.6f seconds\n"
+	 "\t\t\t%s topo ave runtime:    %.6f seconds\n",
+	 type_string, (float)t / C_ITER / CLOCKS_PER_SEC,
+	 type_string, (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	 type_string, (float)t_topo / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tscc correctness:        ");
+  print_test_result(res);
+  adj_lst_free(&r);
+  adj_lst_free(&d);
+  free(comp);
+  free(order);
+  free(comp_csr);
+  free(order_csr);
+  comp = NULL;
+  order = NULL;
+  comp_csr = NULL;
+  order_csr = NULL;
+}
+
 void run_random_dir_graph_helper(size_t num_vts,
 				 size_t vt_size,
 				 const char *type_string,
@@ -702,16 +1002,29 @@ void run_random_dir_graph_helper(size_t num_vts,
 				 void (*incr)(void *),
 				 int bern(void *),
 				 bern_arg_t *b){
+  int res = 1;
   size_t i;
   size_t *start = NULL;
   void *pre = NULL, *post = NULL;
+  void *pre_csr = NULL, *post_csr = NULL;
+  void *pre_ws = NULL, *post_ws = NULL;
+  graph_t g;
   adj_lst_t a;
-  clock_t t;
+  adj_csr_t c;
+  dfs_ws_t ws;
+  clock_t t, t_csr, t_ws;
   /* no declared type after realloc; effective type is set by dfs */
   start = malloc_perror(C_ITER, sizeof(size_t));
   pre = malloc_perror(num_vts, vt_size);
   post = malloc_perror(num_vts, vt_size);
+  pre_csr = malloc_perror(num_vts, vt_size);
+  post_csr = malloc_perror(num_vts, vt_size);
+  pre_ws = malloc_perror(num_vts, vt_size);
+  post_ws = malloc_perror(num_vts, vt_size);
   adj_lst_rand_dir(&a, num_vts, vt_size, read, write, bern, b);
+  lst_graph_init(&g, &a);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
   for (i = 0; i < C_ITER; i++){
     start[i] =  RANDOM() % num_vts;
   }
@@ -720,21 +1033,210 @@ void run_random_dir_graph_helper(size_t num_vts,
     dfs(&a, start[i], pre, post, cmpat, incr);
   }
   t = clock() - t;
-  printf("\t\t\t%s ave runtime:     %.6f seconds\n",
-	 type_string, (float)t / C_ITER / CLOCKS_PER_SEC);
+  t_csr = clock();
+  for (i = 0; i < C_ITER; i++){
+    dfs_csr(&c, start[i], pre_csr, post_csr, cmpat, incr);
+  }
+  t_csr = clock() - t_csr;
+  dfs_ws_init(&ws, num_vts, vt_size);
+  t_ws = clock();
+  for (i = 0; i < C_ITER; i++){
+    dfs_ws(&a, start[i], pre_ws, post_ws, &ws, cmpat, incr);
+  }
+  t_ws = clock() - t_ws;
+  dfs_ws_free(&ws);
+  res *= (memcmp(pre, pre_csr, num_vts * vt_size) == 0);
+  res *= (memcmp(post, post_csr, num_vts * vt_size) == 0);
+  printf("\t\t\t%s ave runtime:     %.6f seconds\n"
+	 "\t\t\t%s csr ave runtime: %.6f seconds\n"
+	 "\t\t\t%s ws ave runtime:  %.6f seconds\n",
+	 type_string, (float)t / C_ITER / CLOCKS_PER_SEC,
+	 type_string, (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	 type_string, (float)t_ws / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tcsr correctness:        ");
+  print_test_result(res);
+  res = 1;
+  res *= (memcmp(pre, pre_ws, num_vts * vt_size) == 0);
+  res *= (memcmp(post, post_ws, num_vts * vt_size) == 0);
+  printf("\t\t\tws correctness:         ");
+  print_test_result(res);
+  run_random_scc_helper(&a, &c, &g, post, type_string);
   adj_lst_free(&a); /* deallocates blocks with effective vertex type */
+  adj_csr_free(&c);
+  graph_free(&g);
   free(start);
   free(pre);
   free(post);
+  free(pre_csr);
+  free(post_csr);
+  free(pre_ws);
+  free(post_ws);
   start = NULL;
   pre = NULL;
   post = NULL;
+  pre_csr = NULL;
+  post_csr = NULL;
+  pre_ws = NULL;
+  post_ws = NULL;
+}
+
+/**
+   Run a dfs_cmpr test on random directed graphs.
+*/
+
+void run_cmpr_helper(size_t num_vts,
+		     size_t vt_size,
+		     const char *type_string,
+		     size_t (*read)(const void *),
+		     void (*write)(void *, size_t),
+		     int (*cmpat)(const void *,
+				  const void *,
+				  const void *),
+		     void (*incr)(void *),
+		     int bern(void *),
+		     bern_arg_t *b);
+
+void run_cmpr_test(size_t log_start, size_t log_end){
+  size_t i, j;
+  size_t num_vts;
+  bern_arg_t b;
+  printf("Run a dfs_cmpr test on random directed graphs from %lu random "
+	 "start vertices in each graph\n",  TOLU(C_ITER));
+  for (i = 0; i < C_PROBS_COUNT; i++){
+    b.p = C_PROBS[i];
+    printf("\tP[an edge is in a graph] = %.2f\n", b.p);
+    for (j = log_start; j <= log_end; j++){
+      num_vts = pow_two_perror(j);
+      printf("\t\tvertices: %lu, E[# of directed edges]: %.1f\n",
+	     TOLU(num_vts), b.p * num_vts * (num_vts - 1));
+      run_cmpr_helper(num_vts,
+		      C_VT_SIZES[0],
+		      C_VT_TYPES[0],
+		      C_READ[0],
+		      C_WRITE[0],
+		      C_CMPAT[0],
+		      C_INCR[0],
+		      bern,
+		      &b);
+      run_cmpr_helper(num_vts,
+		      C_VT_SIZES[1],
+		      C_VT_TYPES[1],
+		      C_READ[1],
+		      C_WRITE[1],
+		      C_CMPAT[1],
+		      C_INCR[1],
+		      bern,
+		      &b);
+    }
+  }
+}
+
+void run_cmpr_helper(size_t num_vts,
+		     size_t vt_size,
+		     const char *type_string,
+		     size_t (*read)(const void *),
+		     void (*write)(void *, size_t),
+		     int (*cmpat)(const void *,
+				  const void *,
+				  const void *),
+		     void (*incr)(void *),
+		     int bern(void *),
+		     bern_arg_t *b){
+  int res = 1;
+  size_t i;
+  size_t *start = NULL;
+  void *pre = NULL, *post = NULL;
+  void *pre_cmpr = NULL, *post_cmpr = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  adj_cmpr_t cc;
+  clock_t t_csr, t_cmpr;
+  /* no declared type after realloc; effective type is set by dfs */
+  start = malloc_perror(C_ITER, sizeof(size_t));
+  pre = malloc_perror(num_vts, vt_size);
+  post = malloc_perror(num_vts, vt_size);
+  pre_cmpr = malloc_perror(num_vts, vt_size);
+  post_cmpr = malloc_perror(num_vts, vt_size);
+  /* the lists are sorted and the pre and post values are the same */
+  adj_lst_rand_dir(&a, num_vts, vt_size, read, write, bern, b);
+  lst_graph_init(&g, &a);
+  adj_csr_base_init(&c, &g);
+  adj_csr_dir_build(&c, &g);
+  adj_cmpr_base_init(&cc, &g);
+  adj_cmpr_dir_build(&cc, &g);
+  for (i = 0; i < C_ITER; i++){
+    start[i] =  RANDOM() % num_vts;
+  }
+  t_csr = 0;
+  t_cmpr = 0;
+  for (i = 0; i < C_ITER; i++){
+    t_csr -= clock();
+    dfs_csr(&c, start[i], pre, post, cmpat, incr);
+    t_csr += clock();
+    t_cmpr -= clock();
+    dfs_cmpr(&cc, start[i], pre_cmpr, post_cmpr, cmpat, incr);
+    t_cmpr += clock();
+    res *= (memcmp(pre, pre_cmpr, num_vts * vt_size) == 0);
+    res *= (memcmp(post, post_cmpr, num_vts * vt_size) == 0);
+  }
+  printf("\t\t\t%s csr bytes:        %lu\n"
+	 "\t\t\t%s cmpr bytes:       %lu\n",
+	 type_string, TOLU(c.num_es * c.pair_size),
+	 type_string, TOLU(cc.offsets[num_vts]));
+  printf("\t\t\t%s csr ave runtime:  %.6f seconds\n"
+	 "\t\t\t%s cmpr ave runtime: %.6f seconds\n",
+	 type_string, (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	 type_string, (float)t_cmpr / C_ITER / CLOCKS_PER_SEC);
+  printf("\t\t\tcmpr correctness:        ");
+  print_test_result(res);
+  adj_lst_free(&a); /* deallocates blocks with effective vertex type */
+  adj_csr_free(&c);
+  adj_cmpr_free(&cc);
+  graph_free(&g);
+  free(start);
+  free(pre);
+  free(post);
+  free(pre_cmpr);
+  free(post_cmpr);
+  start = NULL;
+  pre = NULL;
+  post = NULL;
+  pre_cmpr = NULL;
+  post_cmpr = NULL;
 }
 
 /**
    Auxiliary functions.
 */
 
+/**
+   Initializes a directed graph with the edges of an adjacency list.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL;
+  const char *p = NULL;
+  graph_base_init(g, a->num_vts, a->vt_size, 0, a->read_vt, a->write_vt);
+  g->num_es = a->num_es;
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  up = g->u;
+  vp = g->v;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
 /**
    Compares the elements of two size_t arrays.
 */
@@ -778,7 +1280,7 @@ int main(int argc, char *argv[]){
   size_t *args = NULL;
   RGENS_SEED();
   if (argc > C_ARGC_MAX){
-    printf("USAGE:\n%s", C_USAGE);
+    printf("USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
@@ -798,17 +1300,20 @@ int main(int argc, char *argv[]){
       args[6] > 1 ||
       args[7] > 1 ||
       args[8] > 1 ||
-      args[9] > 1){
-    printf("USAGE:\n%s", C_USAGE);
+      args[9] > 1 ||
+      args[10] > 1){
+    printf("USAGE:\n%s%s", C_USAGE, C_USAGE_TESTS);
     exit(EXIT_FAILURE);
   }
   if (args[6]){
     run_graph_a_test();
     run_graph_b_test();
+    run_scc_small_graph_test();
   }
   if (args[7]) run_max_edges_graph_test(args[0], args[1]);
   if (args[8]) run_no_edges_graph_test(args[2], args[3]);
   if (args[9]) run_random_dir_graph_test(args[4], args[5]);
+  if (args[10]) run_cmpr_test(args[4], args[5]);
   free(args);
   args = NULL;
   return 0;
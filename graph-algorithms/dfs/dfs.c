@@ -15,6 +15,21 @@
    The recursion in DFS is emulated on a dynamically allocated stack data
    structure to avoid an overflow of the memory stack.
 
+   If dfs is run repeatedly on graphs, dfs_ws and dfs_ws_csr run with a
+   workspace that is allocated once per thread, so that the stack and the
+   buffers of a search are not reallocated in each run. A run visits all
+   vertices in O(V + E) time.
+
+   dfs_cmpr runs on a read-only compressed adjacency list of sorted,
+   delta-encoded and variable-length encoded lists, keeping the position
+   in the list of each unfinished vertex as a small iterator on the stack.
+
+   dfs_scc and dfs_topo run Tarjan's algorithm for strongly connected
+   components on the same emulated recursion, and provide the components
+   in a topological order of the condensation of a graph, and a
+   topological order of the vertices together with cycle detection,
+   without a second pass over the edges.
+
    The implementation only uses integer and pointer operations. Given
    parameter values within the specified ranges, the implementation provides
    an error message and an exit is executed if an integer overflow is
@@ -45,9 +60,41 @@ typedef struct{
   const char *vp; /* vp is pointer to v in u's stack in an adj. list */
 } uvp_t;
 
+typedef struct{
+  size_t u;
+  adj_cmpr_iter_t it; /* position after the last decoded v in u's list */
+} uit_t;
+
+typedef struct{
+  size_t *pre; /* previsit values */
+  size_t *low; /* lowest previsit values reached through the SCC stack */
+  size_t *cid; /* SCC indices in the order of completion */
+  size_t *ts; /* stack of Tarjan's algorithm */
+  size_t num_ts;
+  size_t c; /* counter */
+  size_t k; /* number of completed SCCs */
+  size_t pos; /* position of the last written vertex in order */
+  int cyclic;
+} scc_t;
+
 static const size_t STACK_INIT_COUNT = 1;
 
-static void search(const adj_lst_t *a,
+static void dfs_view(const adj_view_t *a,
+		     size_t start,
+		     void *pre,
+		     void *post,
+		     int (*cmpat_vt)(const void *, const void *, const void *),
+		     void (*incr_vt)(void *));
+static void dfs_ws_view(const adj_view_t *a,
+			size_t start,
+			void *pre,
+			void *post,
+			dfs_ws_t *ws,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *));
+static void search(const adj_view_t *a,
 		   stack_t *s,
 		   size_t u,
 		   void *c,
@@ -56,6 +103,27 @@ static void search(const adj_lst_t *a,
 		   const void *nr,
                    int (*cmpat_vt)(const void *, const void *, const void *),
 		   void (*incr_vt)(void *));
+static size_t scc_view(const adj_view_t *a,
+		       void *comp,
+		       void *order,
+		       int *cyclic);
+static void scc_search(const adj_view_t *a,
+		       stack_t *s,
+		       size_t u,
+		       scc_t *t,
+		       void *order);
+static void cmpr_search(const adj_cmpr_t *a,
+			stack_t *s,
+			size_t u,
+			void *c,
+			void *pre,
+			void *post,
+			const void *nr,
+			void *vb,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *));
 static void *ptr(const void *block, size_t i, size_t size);
 
 int dfs_cmpat_ushort(const void *a, const void *i, const void *v){
@@ -131,39 +199,249 @@ void dfs(const adj_lst_t *a,
 	 void *post,
 	 int (*cmpat_vt)(const void *, const void *, const void *),
 	 void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dfs_view(&w, start, pre, post, cmpat_vt, incr_vt);
+}
+
+/**
+   Runs dfs on a compressed sparse row (CSR) adjacency list. Please see the
+   parameter specification in dfs.
+*/
+void dfs_csr(const adj_csr_t *c,
+	     size_t start,
+	     void *pre,
+	     void *post,
+	     int (*cmpat_vt)(const void *, const void *, const void *),
+	     void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dfs_view(&w, start, pre, post, cmpat_vt, incr_vt);
+}
+
+/**
+   Runs dfs on a compressed adjacency list, decoding the lists on the fly.
+   The stack of the emulated recursion holds the state of a list iterator
+   for each unfinished vertex instead of a pointer into its list. The lists
+   are visited in ascending order of vertices, so that the pre and post
+   values are the same as in dfs on an adjacency list with sorted lists.
+   Please see the parameter specification in dfs.
+*/
+void dfs_cmpr(const adj_cmpr_t *c,
+	      size_t start,
+	      void *pre,
+	      void *post,
+	      int (*cmpat_vt)(const void *, const void *, const void *),
+	      void (*incr_vt)(void *)){
   size_t u;
   char *p = NULL;
-  void *cnri = NULL; /* counter, not reached vertex value, index */
-  void *c = NULL, *nr = NULL, *i = NULL;
+  void *cnrib = NULL; /* counter, not reached vertex value, index, vertex */
+  void *ctr = NULL, *nr = NULL, *i = NULL, *vb = NULL;
   stack_t s;
-  /* single block for cache-efficiency; same type */
-  cnri = malloc_perror(3, a->vt_size);
-  c = cnri;
-  nr = ptr(cnri, 1, a->vt_size);
-  i = ptr(cnri, 2, a->vt_size);
+  cnrib = malloc_perror(4, c->vt_size);
+  ctr = cnrib;
+  nr = ptr(cnrib, 1, c->vt_size);
+  i = ptr(cnrib, 2, c->vt_size);
+  vb = ptr(cnrib, 3, c->vt_size);
+  stack_init(&s, STACK_INIT_COUNT, sizeof(uit_t), NULL);
+  c->write_vt(ctr, 0);
+  c->write_vt(nr, mul_sz_perror(2, c->num_vts));
+  c->write_vt(i, start);
+  for (p = pre; p != ptr(pre, c->num_vts, c->vt_size); p += c->vt_size){
+    memcpy(p, nr, c->vt_size);
+  }
+  for (u = start; u < c->num_vts; u++){
+    if (cmpat_vt(pre, i, nr) == 0){
+      cmpr_search(c, &s, u, ctr, pre, post, nr, vb, cmpat_vt, incr_vt);
+    }
+    incr_vt(i);
+  }
+  c->write_vt(i, 0);
+  for (u = 0; u < start; u++){
+    if (cmpat_vt(pre, i, nr) == 0){
+      cmpr_search(c, &s, u, ctr, pre, post, nr, vb, cmpat_vt, incr_vt);
+    }
+    incr_vt(i);
+  }
+  stack_free(&s);
+  free(cnrib);
+  cnrib = NULL;
+}
+
+/**
+   Initializes a workspace for repeated runs of dfs_ws and dfs_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(dfs_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   vt_size     : size of the integer type used to represent vertices in the
+                 graphs in the runs
+*/
+void dfs_ws_init(dfs_ws_t *ws, size_t num_vts, size_t vt_size){
+  ws->num_vts = num_vts;
+  ws->vt_size = vt_size;
+  ws->cnri = malloc_perror(3, vt_size);
+  stack_init(&ws->s, STACK_INIT_COUNT, sizeof(uvp_t), NULL);
+}
+
+/**
+   Runs dfs with a workspace. Please see the parameter specification in
+   dfs.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the vertex size of the adjacency list
+*/
+void dfs_ws(const adj_lst_t *a,
+	    size_t start,
+	    void *pre,
+	    void *post,
+	    dfs_ws_t *ws,
+	    int (*cmpat_vt)(const void *, const void *, const void *),
+	    void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dfs_ws_view(&w, start, pre, post, ws, cmpat_vt, incr_vt);
+}
+
+void dfs_ws_csr(const adj_csr_t *c,
+		size_t start,
+		void *pre,
+		void *post,
+		dfs_ws_t *ws,
+		int (*cmpat_vt)(const void *, const void *, const void *),
+		void (*incr_vt)(void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dfs_ws_view(&w, start, pre, post, ws, cmpat_vt, incr_vt);
+}
+
+/**
+   Frees a workspace and leaves a block of size sizeof(dfs_ws_t) pointed
+   to by the ws parameter.
+*/
+void dfs_ws_free(dfs_ws_t *ws){
+  stack_free(&ws->s);
+  free(ws->cnri);
+  ws->cnri = NULL;
+}
+
+/**
+   Computes the strongly connected components (SCCs) of a graph with
+   Tarjan's algorithm in a single DFS traversal and returns the number of
+   SCCs. The SCCs are numbered in a topological order of the condensation
+   of the graph, i.e. if (u, v) is an edge then comp[u] <= comp[v].
+   a           : pointer to an adjacency list with at least one and at most
+                 2**(P - 1) - 1 vertices, where P is the precision of the
+                 integer type used to represent vertices
+   comp        : NULL pointer, or a pointer to a preallocated array with the
+                 count equal to the number of vertices in the adjacency
+                 list; each element is of the integer type used to
+                 represent vertices and is set to the index of the SCC of
+                 the vertex
+   order       : NULL pointer, or a pointer to a preallocated array with the
+                 count equal to the number of vertices in the adjacency
+                 list; each element is of the integer type used to
+                 represent vertices; the array is set to a permutation of
+                 the vertices, where the vertices of an SCC are contiguous
+                 and the SCCs appear in the increasing order of indices
+*/
+size_t dfs_scc(const adj_lst_t *a, void *comp, void *order){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return scc_view(&w, comp, order, NULL);
+}
+
+/**
+   Runs dfs_scc on a compressed sparse row (CSR) adjacency list. Please see
+   the parameter specification in dfs_scc.
+*/
+size_t dfs_scc_csr(const adj_csr_t *c, void *comp, void *order){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return scc_view(&w, comp, order, NULL);
+}
+
+/**
+   Computes a topological order of the vertices of a graph in a single DFS
+   traversal. Returns 0 if the graph is acyclic and the array pointed to by
+   order is set to a topological order, i.e. if (u, v) is an edge then u
+   precedes v. Otherwise returns 1, and the array pointed to by order is
+   set as in dfs_scc. A self-loop is a cycle. Please see the parameter
+   specification in dfs_scc.
+   order       : pointer to a preallocated array with the count equal to the
+                 number of vertices in the adjacency list; each element is
+                 of the integer type used to represent vertices
+*/
+int dfs_topo(const adj_lst_t *a, void *order){
+  int cyclic;
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  scc_view(&w, NULL, order, &cyclic);
+  return cyclic;
+}
+
+/**
+   Runs dfs_topo on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in dfs_topo.
+*/
+int dfs_topo_csr(const adj_csr_t *c, void *order){
+  int cyclic;
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  scc_view(&w, NULL, order, &cyclic);
+  return cyclic;
+}
+
+/**
+   Runs dfs on a view of an adjacency list with a workspace that is used in
+   a single run.
+*/
+static void dfs_view(const adj_view_t *a,
+		     size_t start,
+		     void *pre,
+		     void *post,
+		     int (*cmpat_vt)(const void *, const void *, const void *),
+		     void (*incr_vt)(void *)){
+  dfs_ws_t ws;
+  dfs_ws_init(&ws, a->num_vts, a->vt_size);
+  dfs_ws_view(a, start, pre, post, &ws, cmpat_vt, incr_vt);
+  dfs_ws_free(&ws);
+}
+
+/**
+   Runs dfs on a view of an adjacency list with a workspace.
+*/
+static void dfs_ws_view(const adj_view_t *a,
+			size_t start,
+			void *pre,
+			void *post,
+			dfs_ws_t *ws,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *)){
+  size_t u;
+  char *p = NULL;
+  void *c = NULL, *nr = NULL, *i = NULL;
+  c = ws->cnri;
+  nr = ptr(ws->cnri, 1, a->vt_size);
+  i = ptr(ws->cnri, 2, a->vt_size);
   a->write_vt(c, 0);
   a->write_vt(nr, mul_sz_perror(2, a->num_vts));
   a->write_vt(i, start);
   for (p = pre; p != ptr(pre, a->num_vts, a->vt_size); p += a->vt_size){
     memcpy(p, nr, a->vt_size);
   }
-  stack_init(&s, STACK_INIT_COUNT, sizeof(uvp_t), NULL);
   for (u = start; u < a->num_vts; u++){
     if (cmpat_vt(pre, i, nr) == 0){
-      search(a, &s, u, c, pre, post, nr, cmpat_vt, incr_vt);
+      search(a, &ws->s, u, c, pre, post, nr, cmpat_vt, incr_vt);
     }
     incr_vt(i);
   }
   a->write_vt(i, 0);
   for (u = 0; u < start; u++){
     if (cmpat_vt(pre, i, nr) == 0){
-      search(a, &s, u, c, pre, post, nr, cmpat_vt, incr_vt);
+      search(a, &ws->s, u, c, pre, post, nr, cmpat_vt, incr_vt);
     }
     incr_vt(i);
   }
-  stack_free(&s);
-  free(cnri);
-  cnri = NULL;
 }
 
 /**
@@ -171,7 +449,7 @@ void dfs(const adj_lst_t *a,
    vertex provided by the u parameter by emulating the recursion in DFS on
    a dynamically allocated stack data structure.
 */
-static void search(const adj_lst_t *a,
+static void search(const adj_view_t *a,
 		   stack_t *s,
 		   size_t u,
 		   void *c,
@@ -180,19 +458,19 @@ static void search(const adj_lst_t *a,
 		   const void *nr,
                    int (*cmpat_vt)(const void *, const void *, const void *),
 		   void (*incr_vt)(void *)){
+  size_t num_vt_wts;
   const char *p = NULL, *p_end = NULL;
   uvp_t uvp;
   uvp.u = u;
-  uvp.vp = a->vt_wts[u]->elts;
+  uvp.vp = a->vt_wts(a->adj, u, &num_vt_wts);
   memcpy(ptr(pre, u, a->vt_size), c, a->vt_size);
   incr_vt(c);
   stack_push(s, &uvp);
   while (s->num_elts > 0){
     stack_pop(s, &uvp);
     p = uvp.vp;
-    p_end = ptr(a->vt_wts[uvp.u]->elts,
-		a->vt_wts[uvp.u]->num_elts,
-		a->pair_size);
+    p_end = a->vt_wts(a->adj, uvp.u, &num_vt_wts);
+    p_end += num_vt_wts * a->pair_size;
     while (p != p_end && cmpat_vt(pre, p, nr) != 0){
       p += a->pair_size;
     }
@@ -203,7 +481,7 @@ static void search(const adj_lst_t *a,
       uvp.vp = p;
       stack_push(s, &uvp); /* push the unfinished vertex */
       uvp.u = a->read_vt(p);
-      uvp.vp = a->vt_wts[uvp.u]->elts;
+      uvp.vp = a->vt_wts(a->adj, uvp.u, &num_vt_wts);
       memcpy(ptr(pre, uvp.u, a->vt_size), c, a->vt_size);
       incr_vt(c);
       stack_push(s, &uvp); /* then push an unexplored vertex */
@@ -211,6 +489,169 @@ static void search(const adj_lst_t *a,
   }
 }
 
+/**
+   Runs Tarjan's algorithm on a view of an adjacency list, and if cyclic is
+   not NULL, sets the value pointed to by cyclic to 1 if a cycle is found
+   and to 0 otherwise. In low, a value equal to the number of vertices n
+   indicates a not reached vertex, and n + 1 indicates a vertex in a
+   completed SCC, so that an edge is tested with a single lookup.
+*/
+static size_t scc_view(const adj_view_t *a,
+		       void *comp,
+		       void *order,
+		       int *cyclic){
+  size_t n = a->num_vts;
+  size_t u;
+  size_t *vts = NULL;
+  stack_t s;
+  scc_t t;
+  vts = malloc_perror(mul_sz_perror(4, n), sizeof(size_t));
+  t.pre = vts;
+  t.low = vts + n;
+  t.cid = vts + 2 * n;
+  t.ts = vts + 3 * n;
+  t.num_ts = 0;
+  t.c = 0;
+  t.k = 0;
+  t.pos = n;
+  t.cyclic = 0;
+  for (u = 0; u < n; u++){
+    t.low[u] = n;
+  }
+  stack_init(&s, STACK_INIT_COUNT, sizeof(uvp_t), NULL);
+  for (u = 0; u < n; u++){
+    if (t.low[u] == n) scc_search(a, &s, u, &t, order);
+  }
+  if (comp != NULL){
+    for (u = 0; u < n; u++){
+      a->write_vt(ptr(comp, u, a->vt_size), t.k - 1 - t.cid[u]);
+    }
+  }
+  if (cyclic != NULL) *cyclic = t.cyclic;
+  stack_free(&s);
+  free(vts);
+  vts = NULL;
+  return t.k;
+}
+
+/**
+   Performs Tarjan's algorithm on the part of a graph reachable from an
+   unexplored vertex provided by the u parameter by emulating the recursion
+   on a dynamically allocated stack data structure as in search. An SCC is
+   completed in a reverse topological order of the condensation, and its
+   vertices are written to order from the end of the array.
+*/
+static void scc_search(const adj_view_t *a,
+		       stack_t *s,
+		       size_t u,
+		       scc_t *t,
+		       void *order){
+  size_t n = a->num_vts;
+  size_t num_vt_wts;
+  size_t v, low_u, low_v;
+  size_t *pre = t->pre, *low = t->low, *cid = t->cid;
+  int cyclic = t->cyclic;
+  const char *p = NULL, *p_end = NULL;
+  uvp_t uvp;
+  uvp.u = u;
+  uvp.vp = a->vt_wts(a->adj, u, &num_vt_wts);
+  pre[u] = t->c;
+  low[u] = t->c;
+  t->c++;
+  t->ts[t->num_ts++] = u;
+  stack_push(s, &uvp);
+  while (s->num_elts > 0){
+    stack_pop(s, &uvp);
+    u = uvp.u;
+    p = uvp.vp;
+    p_end = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end += num_vt_wts * a->pair_size;
+    low_u = low[u];
+    for (; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      low_v = low[v];
+      if (low_v == n) break;
+      if (low_v < n){
+	/* v is on the stack of Tarjan's algorithm and reaches u */
+	if (low_v < low_u) low_u = low_v;
+	cyclic = 1;
+      }
+    }
+    low[u] = low_u;
+    if (p == p_end){
+      if (low_u == pre[u]){
+	do{
+	  v = t->ts[--t->num_ts];
+	  cid[v] = t->k;
+	  low[v] = n + 1;
+	  if (order != NULL) a->write_vt(ptr(order, --t->pos, a->vt_size), v);
+	}while (v != u);
+	t->k++;
+      }
+    }else{
+      uvp.vp = p;
+      stack_push(s, &uvp); /* push the unfinished vertex */
+      uvp.u = v;
+      uvp.vp = a->vt_wts(a->adj, v, &num_vt_wts);
+      pre[v] = t->c;
+      low[v] = t->c;
+      t->c++;
+      t->ts[t->num_ts++] = v;
+      stack_push(s, &uvp); /* then push an unexplored vertex */
+    }
+  }
+  t->cyclic = cyclic;
+}
+
+/**
+   Searches a compressed adjacency list from u with the state of the list
+   iterator of each unfinished vertex on the stack. A vertex is decoded
+   into the buffer pointed to by vb to be compared with cmpat_vt.
+*/
+static void cmpr_search(const adj_cmpr_t *a,
+			stack_t *s,
+			size_t u,
+			void *c,
+			void *pre,
+			void *post,
+			const void *nr,
+			void *vb,
+			int (*cmpat_vt)(const void *,
+					const void *,
+					const void *),
+			void (*incr_vt)(void *)){
+  size_t v;
+  int is_found;
+  uit_t uit;
+  uit.u = u;
+  adj_cmpr_iter_init(&uit.it, a, u);
+  memcpy(ptr(pre, u, a->vt_size), c, a->vt_size);
+  incr_vt(c);
+  stack_push(s, &uit);
+  while (s->num_elts > 0){
+    stack_pop(s, &uit);
+    is_found = 0;
+    while (adj_cmpr_iter_next(&uit.it, &v)){
+      a->write_vt(vb, v);
+      if (cmpat_vt(pre, vb, nr) == 0){
+	is_found = 1;
+	break;
+      }
+    }
+    if (!is_found){
+      memcpy(ptr(post, uit.u, a->vt_size), c, a->vt_size);
+      incr_vt(c);
+    }else{
+      stack_push(s, &uit); /* push the unfinished vertex */
+      uit.u = v;
+      adj_cmpr_iter_init(&uit.it, a, v);
+      memcpy(ptr(pre, v, a->vt_size), c, a->vt_size);
+      incr_vt(c);
+      stack_push(s, &uit); /* then push an unexplored vertex */
+    }
+  }
+}
+
 /**
    Computes a pointer to the ith element in the block of elements.
 */
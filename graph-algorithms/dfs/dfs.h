@@ -15,6 +15,21 @@
    The recursion in DFS is emulated on a dynamically allocated stack data
    structure to avoid an overflow of the memory stack.
 
+   If dfs is run repeatedly on graphs, dfs_ws and dfs_ws_csr run with a
+   workspace that is allocated once per thread, so that the stack and the
+   buffers of a search are not reallocated in each run. A run visits all
+   vertices in O(V + E) time.
+
+   dfs_cmpr runs on a read-only compressed adjacency list of sorted,
+   delta-encoded and variable-length encoded lists, keeping the position
+   in the list of each unfinished vertex as a small iterator on the stack.
+
+   dfs_scc and dfs_topo run Tarjan's algorithm for strongly connected
+   components on the same emulated recursion, and provide the components
+   in a topological order of the condensation of a graph, and a
+   topological order of the vertices together with cycle detection,
+   without a second pass over the edges.
+
    The implementation only uses integer and pointer operations. Given
    parameter values within the specified ranges, the implementation provides
    an error message and an exit is executed if an integer overflow is
@@ -37,6 +52,14 @@
 
 #include <stddef.h>
 #include "graph.h"
+#include "stack.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t vt_size;
+  void *cnri; /* counter, not reached vertex value, index buffers */
+  stack_t s;
+} dfs_ws_t;
 
 int dfs_cmpat_ushort(const void *a, const void *i, const void *v);
 int dfs_cmpat_uint(const void *a, const void *i, const void *v);
@@ -87,4 +110,114 @@ void dfs(const adj_lst_t *a,
 	 int (*cmpat_vt)(const void *, const void *, const void *),
 	 void (*incr_vt)(void *));
 
+/**
+   Runs dfs on a compressed sparse row (CSR) adjacency list. Please see the
+   parameter specification in dfs.
+*/
+void dfs_csr(const adj_csr_t *c,
+	     size_t start,
+	     void *pre,
+	     void *post,
+	     int (*cmpat_vt)(const void *, const void *, const void *),
+	     void (*incr_vt)(void *));
+
+/**
+   Runs dfs on a compressed adjacency list, decoding the lists on the fly.
+   The stack of the emulated recursion holds the state of a list iterator
+   for each unfinished vertex instead of a pointer into its list. The lists
+   are visited in ascending order of vertices, so that the pre and post
+   values are the same as in dfs on an adjacency list with sorted lists.
+   Please see the parameter specification in dfs.
+*/
+void dfs_cmpr(const adj_cmpr_t *c,
+	      size_t start,
+	      void *pre,
+	      void *post,
+	      int (*cmpat_vt)(const void *, const void *, const void *),
+	      void (*incr_vt)(void *));
+
+/**
+   Initializes a workspace for repeated runs of dfs_ws and dfs_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(dfs_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   vt_size     : size of the integer type used to represent vertices in the
+                 graphs in the runs
+*/
+void dfs_ws_init(dfs_ws_t *ws, size_t num_vts, size_t vt_size);
+
+/**
+   Runs dfs with a workspace. Please see the parameter specification in
+   dfs.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the vertex size of the adjacency list
+*/
+void dfs_ws(const adj_lst_t *a,
+	    size_t start,
+	    void *pre,
+	    void *post,
+	    dfs_ws_t *ws,
+	    int (*cmpat_vt)(const void *, const void *, const void *),
+	    void (*incr_vt)(void *));
+
+void dfs_ws_csr(const adj_csr_t *c,
+		size_t start,
+		void *pre,
+		void *post,
+		dfs_ws_t *ws,
+		int (*cmpat_vt)(const void *, const void *, const void *),
+		void (*incr_vt)(void *));
+
+/**
+   Frees a workspace and leaves a block of size sizeof(dfs_ws_t) pointed
+   to by the ws parameter.
+*/
+void dfs_ws_free(dfs_ws_t *ws);
+
+/**
+   Computes the strongly connected components (SCCs) of a graph with
+   Tarjan's algorithm in a single DFS traversal and returns the number of
+   SCCs. The SCCs are numbered in a topological order of the condensation
+   of the graph, i.e. if (u, v) is an edge then comp[u] <= comp[v].
+   a           : pointer to an adjacency list with at least one and at most
+                 2**(P - 1) - 1 vertices, where P is the precision of the
+                 integer type used to represent vertices
+   comp        : NULL pointer, or a pointer to a preallocated array with the
+                 count equal to the number of vertices in the adjacency
+                 list; each element is of the integer type used to
+                 represent vertices and is set to the index of the SCC of
+                 the vertex
+   order       : NULL pointer, or a pointer to a preallocated array with the
+                 count equal to the number of vertices in the adjacency
+                 list; each element is of the integer type used to
+                 represent vertices; the array is set to a permutation of
+                 the vertices, where the vertices of an SCC are contiguous
+                 and the SCCs appear in the increasing order of indices
+*/
+size_t dfs_scc(const adj_lst_t *a, void *comp, void *order);
+
+/**
+   Runs dfs_scc on a compressed sparse row (CSR) adjacency list. Please see
+   the parameter specification in dfs_scc.
+*/
+size_t dfs_scc_csr(const adj_csr_t *c, void *comp, void *order);
+
+/**
+   Computes a topological order of the vertices of a graph in a single DFS
+   traversal. Returns 0 if the graph is acyclic and the array pointed to by
+   order is set to a topological order, i.e. if (u, v) is an edge then u
+   precedes v. Otherwise returns 1, and the array pointed to by order is
+   set as in dfs_scc. A self-loop is a cycle. Please see the parameter
+   specification in dfs_scc.
+   order       : pointer to a preallocated array with the count equal to the
+                 number of vertices in the adjacency list; each element is
+                 of the integer type used to represent vertices
+*/
+int dfs_topo(const adj_lst_t *a, void *order);
+
+/**
+   Runs dfs_topo on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in dfs_topo.
+*/
+int dfs_topo_csr(const adj_csr_t *c, void *order);
+
 #endif
@@ -3,7 +3,8 @@
 
    Tests of Dijkstra's algorithm with a hash table parameter across
    i) default, division-based and multiplication-based hash tables, and ii)
-   edge weight types.
+   edge weight types, and of Dijkstra's algorithm with a radix heap and a
+   pairing heap.
 
    The following command line arguments can be used to customize tests:
    dijkstra-test:
@@ -12,11 +13,13 @@
    -  [0, 1] : small graph test on/off
    -  [0, 1] : bfs comparison test on/off
    -  [0, 1] : test on random graphs with random size_t weights on/off
+   -  [0, 1] : specialized dijkstra test on random graphs on/off
 
    usage examples: 
    ./dijkstra-test
    ./dijkstra-test 10 14
    ./dijkstra-test 14 14 0 0 1
+   ./dijkstra-test 10 12 0 0 0 1
 
    dijkstra-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -63,9 +66,10 @@ const char *C_USAGE =
   "[0, # bits in size_t / 2] : n for 2^n vertices in largest graph\n"
   "[0, 1] : small graph test on/off\n"
   "[0, 1] : bfs comparison test on/off\n"
-  "[0, 1] : random graphs with random size_t weights test on/off\n";
-const int C_ARGC_MAX = 6;
-const size_t C_ARGS_DEF[5] = {0, 10, 1, 1, 1};
+  "[0, 1] : random graphs with random size_t weights test on/off\n"
+  "[0, 1] : specialized dijkstra on random graphs test on/off\n";
+const int C_ARGC_MAX = 7;
+const size_t C_ARGS_DEF[6] = {0, 10, 1, 1, 1, 1};
 
 /* hash table load factor upper bounds */
 const size_t C_ALPHA_N_DIVCHN = 1;
@@ -83,6 +87,7 @@ const double C_WTS_DOUBLE[4] = {4.0, 3.0, 2.0, 1.0};
 
 /* bfs comparison and random uint graph tests */
 const int C_ITER = 10;
+const size_t C_NUM_BATCH_ES = 16;
 const int C_PROBS_COUNT = 7;
 const double C_PROBS[7] = {1.000000, 0.250000, 0.062500,
 			   0.015625, 0.003906, 0.000977,
@@ -94,10 +99,27 @@ const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
 
 void print_uint(const void *a);
 void print_double(const void *a);
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *));
 void print_uint_arr(const size_t *arr, size_t n);
 void print_double_arr(const double *arr, size_t n);
 void print_test_result(int res);
+void adj_lst_rand_undir_uint_wts(adj_lst_t *a,
+				 size_t n,
+				 size_t wt_l,
+				 size_t wt_h,
+				 int (*bern)(void *),
+				 void *arg);
+int is_uint_prev_tree(const adj_lst_t *a,
+		      size_t start,
+		      const size_t *dist,
+		      const size_t *prev);
+int same_reached_dist_wts(const void *dist_a,
+			  const size_t *prev_a,
+			  const void *dist_b,
+			  const size_t *prev_b,
+			  size_t n,
+			  size_t wt_size);
 
 /**
    Initialize small graphs with size_t weights.
@@ -105,20 +127,30 @@ void print_test_result(int res);
 
 void graph_uint_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(size_t));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((size_t *)g->wts + i) = C_WTS_UINT[i];
   }
 }
 
 void graph_uint_wts_no_edges_init(graph_t *g){
-  graph_base_init(g, C_NUM_VTS, sizeof(size_t));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -139,45 +171,32 @@ int cmp_uint(const void *a, const void *b){
   }
 }
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} context_divchn_t;
+/**
+   Set the parameters of hash tables used for in-heap operations.
+*/
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} context_muloa_t;
-
-void ht_divchn_init_helper(ht_divchn_t *ht,
-			   size_t key_size,
-			   size_t elt_size,
-			   void (*free_elt)(void *),
-			   void *context){
-  context_divchn_t *c = context;
-  ht_divchn_init(ht,
-		 key_size,
-		 elt_size,
-		 0,
-		 c->alpha_n,
-		 c->log_alpha_d,
-		 free_elt);
-}
-
-void ht_muloa_init_helper(ht_muloa_t *ht,
-			  size_t key_size,
-			  size_t elt_size,
-			  void (*free_elt)(void *),
-			  void *context){
-  context_muloa_t * c = context;
-  ht_muloa_init(ht,
-		key_size,
-		elt_size,
-		0,
-		c->alpha_n,
-		c->log_alpha_d,
-		NULL,
-		free_elt);
+void hht_divchn_init(heap_ht_t *hht, ht_divchn_t *ht_divchn){
+  hht->ht = ht_divchn;
+  hht->alpha_n = C_ALPHA_N_DIVCHN;
+  hht->log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  hht->init = ht_divchn_init_helper;
+  hht->align = ht_divchn_align_helper;
+  hht->insert = ht_divchn_insert_helper;
+  hht->search = ht_divchn_search_helper;
+  hht->remove = ht_divchn_remove_helper;
+  hht->free = ht_divchn_free_helper;
+}
+
+void hht_muloa_init(heap_ht_t *hht, ht_muloa_t *ht_muloa){
+  hht->ht = ht_muloa;
+  hht->alpha_n = C_ALPHA_N_MULOA;
+  hht->log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  hht->init = ht_muloa_init_helper;
+  hht->align = ht_muloa_align_helper;
+  hht->insert = ht_muloa_insert_helper;
+  hht->search = ht_muloa_search_helper;
+  hht->remove = ht_muloa_remove_helper;
+  hht->free = ht_muloa_free_helper;
 }
 
 void run_default_uint_dijkstra(const adj_lst_t *a){
@@ -204,19 +223,10 @@ void run_divchn_uint_dijkstra(const adj_lst_t *a){
   size_t *dist = NULL;
   size_t *prev = NULL;
   ht_divchn_t ht_divchn;
-  context_divchn_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(size_t));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_DIVCHN;
-  context.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht_divchn_init(&hht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     dijkstra(a, i, dist, prev, &hht, add_uint, cmp_uint);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -235,19 +245,10 @@ void run_muloa_uint_dijkstra(const adj_lst_t *a){
   size_t *dist = NULL;
   size_t *prev = NULL;
   ht_muloa_t ht_muloa;
-  context_muloa_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(size_t));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_MULOA;
-  context.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht_muloa_init(&hht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     dijkstra(a, i, dist, prev, &hht, add_uint, cmp_uint);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -260,6 +261,44 @@ void run_muloa_uint_dijkstra(const adj_lst_t *a){
   dist = NULL;
   prev = NULL;
 }
+
+void run_pair_uint_dijkstra(const adj_lst_t *a){
+  size_t i;
+  size_t *dist = NULL;
+  size_t *prev = NULL;
+  dist = malloc_perror(a->num_vts, sizeof(size_t));
+  prev = malloc_perror(a->num_vts, sizeof(size_t));
+  for (i = 0; i < a->num_vts; i++){
+    dijkstra_pair(a, i, dist, prev, add_uint, cmp_uint);
+    printf("distances and previous vertices with %lu as start \n", TOLU(i));
+    print_uint_arr(dist, a->num_vts);
+    print_uint_arr(prev, a->num_vts);
+  }
+  printf("\n");
+  free(dist);
+  free(prev);
+  dist = NULL;
+  prev = NULL;
+}
+
+void run_radix_uint_dijkstra(const adj_lst_t *a){
+  size_t i;
+  size_t *dist = NULL;
+  size_t *prev = NULL;
+  dist = malloc_perror(a->num_vts, sizeof(size_t));
+  prev = malloc_perror(a->num_vts, sizeof(size_t));
+  for (i = 0; i < a->num_vts; i++){
+    dijkstra_radix(a, i, dist, prev, add_uint, graph_read_sz);
+    printf("distances and previous vertices with %lu as start \n", TOLU(i));
+    print_uint_arr(dist, a->num_vts);
+    print_uint_arr(prev, a->num_vts);
+  }
+  printf("\n");
+  free(dist);
+  free(prev);
+  dist = NULL;
+  prev = NULL;
+}
   
 void run_uint_graph_test(){
   graph_t g;
@@ -268,24 +307,32 @@ void run_uint_graph_test(){
   printf("Running a test on a directed size_t graph with a \n"
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) radix heap \n"
+	 "v) pairing heap \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_default_uint_dijkstra(&a);
   run_divchn_uint_dijkstra(&a);
   run_muloa_uint_dijkstra(&a);
+  run_radix_uint_dijkstra(&a);
+  run_pair_uint_dijkstra(&a);
   adj_lst_free(&a);
   printf("Running a test on an undirected size_t graph with a \n"
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) radix heap \n"
+	 "v) pairing heap \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_default_uint_dijkstra(&a);
   run_divchn_uint_dijkstra(&a);
   run_muloa_uint_dijkstra(&a);
+  run_radix_uint_dijkstra(&a);
+  run_pair_uint_dijkstra(&a);
   adj_lst_free(&a);
   graph_free(&g);
   graph_uint_wts_no_edges_init(&g);
@@ -293,25 +340,33 @@ void run_uint_graph_test(){
 	 "with a \n"
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) radix heap \n"
+	 "v) pairing heap \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_default_uint_dijkstra(&a);
   run_divchn_uint_dijkstra(&a);
   run_muloa_uint_dijkstra(&a);
+  run_radix_uint_dijkstra(&a);
+  run_pair_uint_dijkstra(&a);
   adj_lst_free(&a);
   printf("Running a test on a undirected size_t graph with no edges, "
 	 "with a \n"
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) radix heap \n"
+	 "v) pairing heap \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_default_uint_dijkstra(&a);
   run_divchn_uint_dijkstra(&a);
   run_muloa_uint_dijkstra(&a);
+  run_radix_uint_dijkstra(&a);
+  run_pair_uint_dijkstra(&a);
   adj_lst_free(&a);
   graph_free(&g);
 }
@@ -322,20 +377,30 @@ void run_uint_graph_test(){
 
 void graph_double_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(double));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((double *)g->wts + i) = C_WTS_DOUBLE[i];
   }
 }
 
 void graph_double_wts_no_edges_init(graph_t *g){
-  graph_base_init(g, C_NUM_VTS, sizeof(double));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -380,19 +445,10 @@ void run_divchn_double_dijkstra(const adj_lst_t *a){
   size_t *prev = NULL;
   double *dist = NULL;
   ht_divchn_t ht_divchn;
-  context_divchn_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(double));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_DIVCHN;
-  context.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht_divchn_init(&hht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     dijkstra(a, i, dist, prev, &hht, add_double, cmp_double);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -411,19 +467,10 @@ void run_muloa_double_dijkstra(const adj_lst_t *a){
   size_t *prev = NULL;
   double *dist = NULL;
   ht_muloa_t ht_muloa;
-  context_muloa_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(double));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_MULOA;
-  context.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht_muloa_init(&hht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     dijkstra(a, i, dist, prev, &hht, add_double, cmp_double);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -445,7 +492,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_default_double_dijkstra(&a);
@@ -456,7 +503,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_default_double_dijkstra(&a);
@@ -469,7 +516,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_default_double_dijkstra(&a);
@@ -481,7 +528,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_default_double_dijkstra(&a);
@@ -546,8 +593,9 @@ void adj_lst_rand_dir_wts(adj_lst_t *a,
 					       void *)){
   size_t i, j;
   graph_t g;
-  graph_base_init(&g, n, wt_size);
-  adj_lst_init(a, &g);
+  graph_base_init(&g, n, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
   for (i = 0; i < n - 1; i++){
     for (j = i + 1; j < n; j++){
       add_dir_edge(a, i, j, wt_l, wt_h, bern, arg);
@@ -570,6 +618,21 @@ void norm_uint_arr(size_t *a, size_t norm, size_t n){
   }
 }
 
+/**
+   Compares the distances of the vertices reached by bfs, where n is the
+   special value in prev_bfs for unreached vertices.
+*/
+int same_reached_dist(const size_t *dist_bfs,
+		      const size_t *prev_bfs,
+		      const size_t *dist,
+		      size_t n){
+  size_t i;
+  for (i = 0; i < n; i++){
+    if (prev_bfs[i] != n && dist_bfs[i] != dist[i]) return 0;
+  }
+  return 1;
+}
+
 void run_bfs_dijkstra_test(int pow_start, int pow_end){
   int p, i, j;
   int res = 1;
@@ -581,33 +644,15 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
   bern_arg_t b;
   ht_divchn_t ht_divchn;
   ht_muloa_t ht_muloa;
-  context_divchn_t context_divchn;
-  context_muloa_t context_muloa;
   heap_ht_t hht_divchn, hht_muloa;
-  clock_t t_bfs, t_def, t_divchn, t_muloa;
+  clock_t t_bfs, t_def, t_divchn, t_muloa, t_radix;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
   dist_bfs = malloc_perror(pow_two(pow_end), sizeof(size_t));
   prev_bfs = malloc_perror(pow_two(pow_end), sizeof(size_t));
   dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
   prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht_divchn.ht = &ht_divchn;
-  hht_divchn.context = &context_divchn;
-  hht_divchn.init = (heap_ht_init)ht_divchn_init_helper;
-  hht_divchn.insert = (heap_ht_insert)ht_divchn_insert;
-  hht_divchn.search = (heap_ht_search)ht_divchn_search;
-  hht_divchn.remove = (heap_ht_remove)ht_divchn_remove;
-  hht_divchn.free = (heap_ht_free)ht_divchn_free;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht_muloa.ht = &ht_muloa;
-  hht_muloa.context = &context_muloa;
-  hht_muloa.init = (heap_ht_init)ht_muloa_init_helper;
-  hht_muloa.insert = (heap_ht_insert)ht_muloa_insert;
-  hht_muloa.search = (heap_ht_search)ht_muloa_search;
-  hht_muloa.remove = (heap_ht_remove)ht_muloa_remove;
-  hht_muloa.free = (heap_ht_free)ht_muloa_free;
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  hht_muloa_init(&hht_muloa, &ht_muloa);
   printf("Run a bfs and dijkstra test on random directed "
 	 "graphs with the same weight across edges\n");
   fflush(stdout);
@@ -629,7 +674,12 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
       }
       t_bfs = clock();
       for (j = 0; j < C_ITER; j++){
-	bfs(&a, rand_start[j], dist_bfs, prev_bfs);
+	bfs(&a,
+	    rand_start[j],
+	    dist_bfs,
+	    prev_bfs,
+	    bfs_cmpat_sz,
+	    bfs_incr_sz);
       }
       t_bfs = clock() - t_bfs;
       t_def = clock();
@@ -644,7 +694,7 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
       }
       t_def = clock() - t_def;
       norm_uint_arr(dist, i + 1, n);
-      res *= (memcmp(dist_bfs, dist, n * sizeof(size_t)) == 0);
+      res *= same_reached_dist(dist_bfs, prev_bfs, dist, n);
       t_divchn = clock();
       for (j = 0; j < C_ITER; j++){
 	dijkstra(&a,
@@ -657,7 +707,7 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
       }
       t_divchn = clock() - t_divchn;
       norm_uint_arr(dist, i + 1, n);
-      res *= (memcmp(dist_bfs, dist, n * sizeof(size_t)) == 0);
+      res *= same_reached_dist(dist_bfs, prev_bfs, dist, n);
       t_muloa = clock();
       for (j = 0; j < C_ITER; j++){
 	dijkstra(&a,
@@ -670,17 +720,31 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
       }
       t_muloa = clock() - t_muloa;
       norm_uint_arr(dist, i + 1, n);
-      res *= (memcmp(dist_bfs, dist, n * sizeof(size_t)) == 0);
+      res *= same_reached_dist(dist_bfs, prev_bfs, dist, n);
+      t_radix = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_radix(&a,
+		       rand_start[j],
+		       dist,
+		       prev,
+		       add_uint,
+		       graph_read_sz);
+      }
+      t_radix = clock() - t_radix;
+      norm_uint_arr(dist, i + 1, n);
+      res *= same_reached_dist(dist_bfs, prev_bfs, dist, n);
       printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	     TOLU(a.num_vts), TOLU(a.num_es));
       printf("\t\t\tbfs ave runtime:                     %.8f seconds\n"
 	     "\t\t\tdijkstra default ht ave runtime:     %.8f seconds\n"
 	     "\t\t\tdijkstra ht_divchn ave runtime:      %.8f seconds\n"
-	     "\t\t\tdijkstra ht_muloa ave runtime:       %.8f seconds\n",
+	     "\t\t\tdijkstra ht_muloa ave runtime:       %.8f seconds\n"
+	     "\t\t\tdijkstra_radix ave runtime:          %.8f seconds\n",
 	     (float)t_bfs / C_ITER / CLOCKS_PER_SEC,
 	     (float)t_def / C_ITER / CLOCKS_PER_SEC,
 	     (float)t_divchn / C_ITER / CLOCKS_PER_SEC,
-	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC);
+	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_radix / C_ITER / CLOCKS_PER_SEC);
       printf("\t\t\tcorrectness:                         ");
       print_test_result(res);
       res = 1;
@@ -701,7 +765,9 @@ void run_bfs_dijkstra_test(int pow_start, int pow_end){
 
 /**
    Runs a test on random directed graphs with random size_t weights,
-   across default, division-based and multiplication-based hash tables.
+   across default, division-based and multiplication-based hash tables,
+   a CSR adjacency list with a default hash table, and a radix heap and a
+   pairing heap with an adjacency list and a CSR adjacency list.
 */
 
 /**
@@ -731,42 +797,33 @@ void wrap_sum(size_t *num_wraps,
 void run_rand_uint_test(int pow_start, int pow_end){
   int p, i, j;
   int res = 1;
-  size_t num_wraps_def, num_wraps_divchn, num_wraps_muloa;
-  size_t sum_def, sum_divchn, sum_muloa;
-  size_t num_paths_def, num_paths_divchn, num_paths_muloa;
+  size_t num_wraps_def, num_wraps_divchn, num_wraps_muloa, num_wraps_csr;
+  size_t num_wraps_radix, num_wraps_radix_csr, num_wraps_ws;
+  size_t num_wraps_pair, num_wraps_pair_csr;
+  size_t sum_def, sum_divchn, sum_muloa, sum_csr;
+  size_t sum_radix, sum_radix_csr, sum_ws, sum_pair, sum_pair_csr;
+  size_t num_paths_def, num_paths_divchn, num_paths_muloa, num_paths_csr;
+  size_t num_paths_radix, num_paths_radix_csr, num_paths_ws;
+  size_t num_paths_pair, num_paths_pair_csr;
   size_t n;
   size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
   size_t *rand_start = NULL;
   size_t *dist = NULL, *prev = NULL;
+  graph_t g;
   adj_lst_t a;
+  adj_csr_t c;
   bern_arg_t b;
   ht_divchn_t ht_divchn;
   ht_muloa_t ht_muloa;
-  context_divchn_t context_divchn;
-  context_muloa_t context_muloa;
   heap_ht_t hht_divchn, hht_muloa;
-  clock_t t_def, t_divchn, t_muloa;
+  dijkstra_ws_t ws;
+  clock_t t_def, t_divchn, t_muloa, t_csr, t_radix, t_radix_csr, t_ws;
+  clock_t t_pair, t_pair_csr;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
   dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
   prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht_divchn.ht = &ht_divchn;
-  hht_divchn.context = &context_divchn;
-  hht_divchn.init = (heap_ht_init)ht_divchn_init_helper;
-  hht_divchn.insert = (heap_ht_insert)ht_divchn_insert;
-  hht_divchn.search = (heap_ht_search)ht_divchn_search;
-  hht_divchn.remove = (heap_ht_remove)ht_divchn_remove;
-  hht_divchn.free = (heap_ht_free)ht_divchn_free;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht_muloa.ht = &ht_muloa;
-  hht_muloa.context = &context_muloa;
-  hht_muloa.init = (heap_ht_init)ht_muloa_init_helper;
-  hht_muloa.insert = (heap_ht_insert)ht_muloa_insert;
-  hht_muloa.search = (heap_ht_search)ht_muloa_search;
-  hht_muloa.remove = (heap_ht_remove)ht_muloa_remove;
-  hht_muloa.free = (heap_ht_free)ht_muloa_free;
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  hht_muloa_init(&hht_muloa, &ht_muloa);
   printf("Run a dijkstra test on random directed graphs with random "
 	 "size_t weights in [%lu, %lu]\n", TOLU(wt_l), TOLU(wt_h));
   fflush(stdout);
@@ -783,6 +840,10 @@ void run_rand_uint_test(int pow_start, int pow_end){
 			   bern,
 			   &b,
 			   add_dir_uint_edge);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
       for (j = 0; j < C_ITER; j++){
 	rand_start[j] = RANDOM() % n;
       }
@@ -837,20 +898,150 @@ void run_rand_uint_test(int pow_start, int pow_end){
 	       a.num_vts,
 	       dist,
 	       prev);
+      t_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_csr(&c,
+		     rand_start[j],
+		     dist,
+		     prev,
+		     NULL,
+		     add_uint,
+		     cmp_uint);
+      }
+      t_csr = clock() - t_csr;
+      wrap_sum(&num_wraps_csr,
+	       &sum_csr,
+	       &num_paths_csr,
+	       a.num_vts,
+	       dist,
+	       prev);
+      t_radix = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_radix(&a,
+		       rand_start[j],
+		       dist,
+		       prev,
+		       add_uint,
+		       graph_read_sz);
+      }
+      t_radix = clock() - t_radix;
+      wrap_sum(&num_wraps_radix,
+	       &sum_radix,
+	       &num_paths_radix,
+	       a.num_vts,
+	       dist,
+	       prev);
+      t_radix_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_radix_csr(&c,
+			   rand_start[j],
+			   dist,
+			   prev,
+			   add_uint,
+			   graph_read_sz);
+      }
+      t_radix_csr = clock() - t_radix_csr;
+      wrap_sum(&num_wraps_radix_csr,
+	       &sum_radix_csr,
+	       &num_paths_radix_csr,
+	       a.num_vts,
+	       dist,
+	       prev);
+      t_ws = clock();
+      dijkstra_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws(&a,
+		    rand_start[j],
+		    dist,
+		    prev,
+		    &ws,
+		    add_uint,
+		    cmp_uint);
+      }
+      dijkstra_ws_free(&ws);
+      t_ws = clock() - t_ws;
+      wrap_sum(&num_wraps_ws,
+	       &sum_ws,
+	       &num_paths_ws,
+	       a.num_vts,
+	       dist,
+	       prev);
+      t_pair = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_pair(&a,
+		      rand_start[j],
+		      dist,
+		      prev,
+		      add_uint,
+		      cmp_uint);
+      }
+      t_pair = clock() - t_pair;
+      wrap_sum(&num_wraps_pair,
+	       &sum_pair,
+	       &num_paths_pair,
+	       a.num_vts,
+	       dist,
+	       prev);
+      t_pair_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_pair_csr(&c,
+			  rand_start[j],
+			  dist,
+			  prev,
+			  add_uint,
+			  cmp_uint);
+      }
+      t_pair_csr = clock() - t_pair_csr;
+      wrap_sum(&num_wraps_pair_csr,
+	       &sum_pair_csr,
+	       &num_paths_pair_csr,
+	       a.num_vts,
+	       dist,
+	       prev);
       res *= (num_wraps_def == num_wraps_divchn &&
-	      num_wraps_divchn == num_wraps_muloa);
+	      num_wraps_divchn == num_wraps_muloa &&
+	      num_wraps_muloa == num_wraps_csr &&
+	      num_wraps_csr == num_wraps_radix &&
+	      num_wraps_radix == num_wraps_radix_csr &&
+	      num_wraps_radix_csr == num_wraps_ws &&
+	      num_wraps_ws == num_wraps_pair &&
+	      num_wraps_pair == num_wraps_pair_csr);
       res *= (sum_def == sum_divchn &&
-	      sum_divchn == sum_muloa);
+	      sum_divchn == sum_muloa &&
+	      sum_muloa == sum_csr &&
+	      sum_csr == sum_radix &&
+	      sum_radix == sum_radix_csr &&
+	      sum_radix_csr == sum_ws &&
+	      sum_ws == sum_pair &&
+	      sum_pair == sum_pair_csr);
       res *= (num_paths_def == num_paths_divchn &&
-	      num_paths_divchn == num_paths_muloa);
+	      num_paths_divchn == num_paths_muloa &&
+	      num_paths_muloa == num_paths_csr &&
+	      num_paths_csr == num_paths_radix &&
+	      num_paths_radix == num_paths_radix_csr &&
+	      num_paths_radix_csr == num_paths_ws &&
+	      num_paths_ws == num_paths_pair &&
+	      num_paths_pair == num_paths_pair_csr);
       printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	     TOLU(a.num_vts), TOLU(a.num_es));
       printf("\t\t\tdijkstra default ht ave runtime:     %.8f seconds\n"
 	     "\t\t\tdijkstra ht_divchn ave runtime:      %.8f seconds\n"
-	     "\t\t\tdijkstra ht_muloa ave runtime:       %.8f seconds\n",
+	     "\t\t\tdijkstra ht_muloa ave runtime:       %.8f seconds\n"
+	     "\t\t\tdijkstra_csr default ht ave runtime: %.8f seconds\n"
+	     "\t\t\tdijkstra_radix ave runtime:          %.8f seconds\n"
+	     "\t\t\tdijkstra_radix_csr ave runtime:      %.8f seconds\n"
+	     "\t\t\tdijkstra_ws default ht ave runtime:  %.8f seconds\n",
 	     (float)t_def / C_ITER / CLOCKS_PER_SEC,
 	     (float)t_divchn / C_ITER / CLOCKS_PER_SEC,
-	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC);
+	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_radix / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_radix_csr / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_ws / C_ITER / CLOCKS_PER_SEC);
+      printf("\t\t\tdijkstra_pair ave runtime:           %.8f seconds\n"
+	     "\t\t\tdijkstra_pair_csr ave runtime:       %.8f seconds\n",
+	     (float)t_pair / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_pair_csr / C_ITER / CLOCKS_PER_SEC);
       printf("\t\t\tcorrectness:                         ");
       print_test_result(res);
       printf("\t\t\tlast run # paths:                    %lu\n",
@@ -865,6 +1056,7 @@ void run_rand_uint_test(int pow_start, int pow_end){
       }
       res = 1;
       adj_lst_free(&a);
+      adj_csr_free(&c);
     }
   }
   free(rand_start);
@@ -875,6 +1067,701 @@ void run_rand_uint_test(int pow_start, int pow_end){
   prev = NULL;
 }
 
+/**
+   Runs a test of point-to-point queries with dijkstra_ws_target and
+   dijkstra_bidir on random directed graphs with random size_t weights, by
+   comparing the distances to the distances computed by dijkstra_ws.
+*/
+void run_rand_p2p_test(int pow_start, int pow_end){
+  int p, i, j;
+  int res = 1;
+  size_t n, m;
+  size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
+  size_t *rand_start = NULL, *rand_target = NULL;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *dist_t = NULL, *prev_t = NULL;
+  size_t *dist_r = NULL, *next = NULL;
+  size_t *ref_dist = NULL, *ref_prev = NULL;
+  void *gu = NULL;
+  graph_t g;
+  adj_lst_t a, r;
+  adj_csr_t c, c_r;
+  bern_arg_t b;
+  dijkstra_ws_t ws, ws_r;
+  clock_t t_ws, t_target, t_bidir, t_bidir_csr;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  rand_target = malloc_perror(C_ITER, sizeof(size_t));
+  ref_dist = malloc_perror(C_ITER, sizeof(size_t));
+  ref_prev = malloc_perror(C_ITER, sizeof(size_t));
+  dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist_t = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev_t = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist_r = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  next = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  printf("Run a point-to-point dijkstra test on random directed graphs "
+	 "with random size_t weights in [%lu, %lu]\n",
+	 TOLU(wt_l), TOLU(wt_h));
+  fflush(stdout);
+  for (p = 0; p < C_PROBS_COUNT; p++){
+    b.p = C_PROBS[p];
+    printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+    for (i = pow_start; i <= pow_end; i++){
+      n = pow_two(i); /* 0 < n */
+      adj_lst_rand_dir_wts(&a,
+			   n,
+			   sizeof(size_t),
+			   wt_l,
+			   wt_h,
+			   bern,
+			   &b,
+			   add_dir_uint_edge);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      /* reverse graph */
+      gu = g.u;
+      g.u = g.v;
+      g.v = gu;
+      adj_lst_base_init(&r, &g);
+      adj_lst_dir_build(&r, &g);
+      adj_csr_base_init(&c_r, &g);
+      adj_csr_dir_build(&c_r, &g);
+      graph_free(&g);
+      for (j = 0; j < C_ITER; j++){
+	rand_start[j] = RANDOM() % n;
+	rand_target[j] = RANDOM() % n;
+      }
+      dijkstra_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+      t_ws = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws(&a,
+		    rand_start[j],
+		    dist,
+		    prev,
+		    &ws,
+		    add_uint,
+		    cmp_uint);
+	ref_dist[j] = dist[rand_target[j]];
+	ref_prev[j] = prev[rand_target[j]];
+      }
+      t_ws = clock() - t_ws;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+      t_target = clock();
+      for (j = 0; j < C_ITER; j++){
+	dijkstra_ws_target(&a,
+			   rand_start[j],
+			   rand_target[j],
+			   dist_t,
+			   prev_t,
+			   &ws,
+			   add_uint,
+			   cmp_uint);
+	res *= (prev_t[rand_target[j]] == ref_prev[j] ||
+		(prev_t[rand_target[j]] != C_SIZE_MAX &&
+		 ref_prev[j] != C_SIZE_MAX));
+	res *= (prev_t[rand_target[j]] == C_SIZE_MAX ||
+		dist_t[rand_target[j]] == ref_dist[j]);
+      }
+      t_target = clock() - t_target;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+      dijkstra_ws_init(&ws_r, r.num_vts, r.wt_size, NULL, cmp_uint);
+      t_bidir = clock();
+      for (j = 0; j < C_ITER; j++){
+	m = dijkstra_bidir(&a,
+			   &r,
+			   rand_start[j],
+			   rand_target[j],
+			   dist,
+			   prev,
+			   dist_r,
+			   next,
+			   &ws,
+			   &ws_r,
+			   add_uint,
+			   cmp_uint);
+	res *= ((m == C_SIZE_MAX) == (ref_prev[j] == C_SIZE_MAX));
+	res *= (m == C_SIZE_MAX || dist[m] + dist_r[m] == ref_dist[j]);
+      }
+      t_bidir = clock() - t_bidir;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_free(&ws_r);
+      dijkstra_ws_init(&ws, c.num_vts, c.wt_size, NULL, cmp_uint);
+      dijkstra_ws_init(&ws_r, c_r.num_vts, c_r.wt_size, NULL, cmp_uint);
+      t_bidir_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	m = dijkstra_bidir_csr(&c,
+			       &c_r,
+			       rand_start[j],
+			       rand_target[j],
+			       dist,
+			       prev,
+			       dist_r,
+			       next,
+			       &ws,
+			       &ws_r,
+			       add_uint,
+			       cmp_uint);
+	res *= ((m == C_SIZE_MAX) == (ref_prev[j] == C_SIZE_MAX));
+	res *= (m == C_SIZE_MAX || dist[m] + dist_r[m] == ref_dist[j]);
+      }
+      t_bidir_csr = clock() - t_bidir_csr;
+      dijkstra_ws_free(&ws);
+      dijkstra_ws_free(&ws_r);
+      printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	     TOLU(a.num_vts), TOLU(a.num_es));
+      printf("\t\t\tdijkstra_ws ave runtime:             %.8f seconds\n"
+	     "\t\t\tdijkstra_ws_target ave runtime:      %.8f seconds\n"
+	     "\t\t\tdijkstra_bidir ave runtime:          %.8f seconds\n"
+	     "\t\t\tdijkstra_bidir_csr ave runtime:      %.8f seconds\n",
+	     (float)t_ws / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_target / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_bidir / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_bidir_csr / C_ITER / CLOCKS_PER_SEC);
+      printf("\t\t\tcorrectness:                         ");
+      print_test_result(res);
+      res = 1;
+      adj_lst_free(&a);
+      adj_lst_free(&r);
+      adj_csr_free(&c);
+      adj_csr_free(&c_r);
+    }
+  }
+  free(rand_start);
+  free(rand_target);
+  free(ref_dist);
+  free(ref_prev);
+  free(dist);
+  free(prev);
+  free(dist_t);
+  free(prev_t);
+  free(dist_r);
+  free(next);
+  rand_start = NULL;
+  rand_target = NULL;
+  ref_dist = NULL;
+  ref_prev = NULL;
+  dist = NULL;
+  prev = NULL;
+  dist_t = NULL;
+  prev_t = NULL;
+  dist_r = NULL;
+  next = NULL;
+}
+
+/**
+   Runs a test of dijkstra_repair_dir and dijkstra_repair_undir on random
+   directed and undirected graphs with random size_t weights, by comparing
+   the repaired distances after each batch of edge insertions and weight
+   decreases to the distances computed by dijkstra_ws after the batch.
+   In a directed graph, a half of the edges of a batch are inserted, and
+   the weights of the other half are decreased in the adjacency list. In an
+   undirected graph, the edges of a batch are inserted.
+*/
+void run_rand_repair_test(int pow_start, int pow_end){
+  int k, p, i, j;
+  int res = 1;
+  size_t n, l, u, v, wt, ix;
+  size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
+  size_t num_decr;
+  size_t *dist = NULL, *prev = NULL;
+  size_t *dist_f = NULL, *prev_f = NULL;
+  char *pair = NULL;
+  stack_t *s = NULL;
+  graph_t g;
+  adj_lst_t a;
+  bern_arg_t b, b_all;
+  dijkstra_ws_t ws, ws_f;
+  clock_t t_repair, t_full;
+  const char *types[2] = {"directed", "undirected"};
+  dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  dist_f = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev_f = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  b_all.p = 1.0;
+  for (k = 0; k < 2; k++){
+    printf("Run a dijkstra_repair test on random %s graphs with random "
+	   "size_t weights in [%lu, %lu] and %lu edges in a batch\n",
+	   types[k], TOLU(wt_l), TOLU(wt_h), TOLU(C_NUM_BATCH_ES));
+    fflush(stdout);
+    for (p = 0; p < C_PROBS_COUNT; p++){
+      b.p = C_PROBS[p];
+      printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+      for (i = pow_start; i <= pow_end; i++){
+	n = pow_two(i); /* 0 < n */
+	if (k == 0){
+	  adj_lst_rand_dir_wts(&a,
+			       n,
+			       sizeof(size_t),
+			       wt_l,
+			       wt_h,
+			       bern,
+			       &b,
+			       add_dir_uint_edge);
+	}else{
+	  adj_lst_rand_undir_uint_wts(&a, n, wt_l, wt_h, bern, &b);
+	}
+	graph_base_init(&g,
+			n,
+			sizeof(size_t),
+			sizeof(size_t),
+			graph_read_sz,
+			graph_write_sz);
+	g.num_es = C_NUM_BATCH_ES;
+	g.u = malloc_perror(g.num_es, g.vt_size);
+	g.v = malloc_perror(g.num_es, g.vt_size);
+	g.wts = malloc_perror(g.num_es, g.wt_size);
+	dijkstra(&a, RANDOM() % n, dist, prev, NULL, add_uint, cmp_uint);
+	dijkstra_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+	dijkstra_ws_init(&ws_f, a.num_vts, a.wt_size, NULL, cmp_uint);
+	for (l = 0; l < n; l++){
+	  if (prev[l] == l) break; /* start */
+	}
+	num_decr = 0;
+	t_repair = 0;
+	t_full = 0;
+	for (j = 0; j < C_ITER; j++){
+	  for (ix = 0; ix < g.num_es; ix++){
+	    u = RANDOM() % n;
+	    s = a.vt_wts[u];
+	    if (k == 0 && (ix & 1) && s->num_elts > 0){
+	      /* decrease the weight of an edge in place */
+	      pair = (char *)s->elts + (RANDOM() % s->num_elts) * a.pair_size;
+	      v = *(size_t *)pair;
+	      wt = *(size_t *)(pair + a.wt_offset) / 2;
+	      *(size_t *)(pair + a.wt_offset) = wt;
+	    }else{
+	      v = RANDOM() % n;
+	      wt = wt_l + DRAND() * (wt_h - wt_l);
+	      if (k == 0){
+		adj_lst_add_dir_edge(&a, u, v, &wt, bern, &b_all);
+	      }else{
+		adj_lst_add_undir_edge(&a, u, v, &wt, bern, &b_all);
+	      }
+	    }
+	    *((size_t *)g.u + ix) = u;
+	    *((size_t *)g.v + ix) = v;
+	    *((size_t *)g.wts + ix) = wt;
+	  }
+	  t_repair -= clock();
+	  if (k == 0){
+	    num_decr += dijkstra_repair_dir(&a, &g, dist, prev, &ws,
+					    add_uint, cmp_uint);
+	  }else{
+	    num_decr += dijkstra_repair_undir(&a, &g, dist, prev, &ws,
+					      add_uint, cmp_uint);
+	  }
+	  t_repair += clock();
+	  t_full -= clock();
+	  dijkstra_ws(&a, l, dist_f, prev_f, &ws_f, add_uint, cmp_uint);
+	  t_full += clock();
+	  res *= same_reached_dist_wts(dist, prev, dist_f, prev_f, n,
+				       sizeof(size_t));
+	  res *= is_uint_prev_tree(&a, l, dist, prev);
+	}
+	dijkstra_ws_free(&ws);
+	dijkstra_ws_free(&ws_f);
+	printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	       TOLU(a.num_vts), TOLU(a.num_es));
+	printf("\t\t\tdijkstra_repair ave runtime:         %.8f seconds\n"
+	       "\t\t\tdijkstra_ws ave runtime:             %.8f seconds\n"
+	       "\t\t\tave # distance decreases:            %.1f\n",
+	       (float)t_repair / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_full / C_ITER / CLOCKS_PER_SEC,
+	       (double)num_decr / C_ITER);
+	printf("\t\t\tcorrectness:                         ");
+	print_test_result(res);
+	res = 1;
+	graph_free(&g);
+	adj_lst_free(&a);
+      }
+    }
+  }
+  free(dist);
+  free(prev);
+  free(dist_f);
+  free(prev_f);
+  dist = NULL;
+  prev = NULL;
+  dist_f = NULL;
+  prev_f = NULL;
+}
+
+/**
+   Constructs the adjacency list of a random undirected graph with random
+   size_t weights.
+*/
+void adj_lst_rand_undir_uint_wts(adj_lst_t *a,
+				 size_t n,
+				 size_t wt_l,
+				 size_t wt_h,
+				 int (*bern)(void *),
+				 void *arg){
+  size_t i, j, wt;
+  graph_t g;
+  graph_base_init(&g, n, sizeof(size_t), sizeof(size_t), graph_read_sz,
+		  graph_write_sz);
+  adj_lst_base_init(a, &g);
+  for (i = 0; i < n - 1; i++){
+    for (j = i + 1; j < n; j++){
+      wt = wt_l + DRAND() * (wt_h - wt_l);
+      adj_lst_add_undir_edge(a, i, j, &wt, bern, arg);
+    }
+  }
+  graph_free(&g);
+}
+
+/**
+   Returns 1 if each reached vertex other than start has its previous
+   vertex on an edge with a weight that is equal to the difference of
+   their distances, given size_t weights.
+*/
+int is_uint_prev_tree(const adj_lst_t *a,
+		      size_t start,
+		      const size_t *dist,
+		      const size_t *prev){
+  int res = 1;
+  size_t i, j, v;
+  const char *p = NULL;
+  char *is_valid = NULL;
+  is_valid = calloc_perror(a->num_vts, 1);
+  is_valid[start] = (prev[start] == start && dist[start] == 0);
+  for (i = 0; i < a->num_vts; i++){
+    if (prev[i] == C_SIZE_MAX) continue;
+    p = a->vt_wts[i]->elts;
+    for (j = 0; j < a->vt_wts[i]->num_elts; j++){
+      v = *(const size_t *)p;
+      if (v != start && prev[v] == i &&
+	  dist[i] + *(const size_t *)(p + a->wt_offset) == dist[v]){
+	is_valid[v] = 1;
+      }
+      p += a->pair_size;
+    }
+  }
+  for (i = 0; i < a->num_vts; i++){
+    if (prev[i] != C_SIZE_MAX && !is_valid[i]) res = 0;
+  }
+  free(is_valid);
+  is_valid = NULL;
+  return res;
+}
+
+/**
+   Runs a test of the specialized dijkstra_uint_uint, dijkstra_uint_double,
+   dijkstra_sz_ulong, and their _csr versions on random directed graphs,
+   by comparing the distances and the reached vertices to the output of
+   dijkstra with the corresponding add_wt and cmp_wt. The integer weights
+   are bounded so that the distances do not overflow.
+*/
+
+void add_ui(void *sum, const void *wt_a, const void *wt_b){
+  *(unsigned int *)sum = *(unsigned int *)wt_a + *(unsigned int *)wt_b;
+}
+
+int cmp_ui(const void *a, const void *b){
+  if (*(unsigned int *)a > *(unsigned int *)b){
+    return 1;
+  }else if (*(unsigned int *)a < *(unsigned int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+void add_ul(void *sum, const void *wt_a, const void *wt_b){
+  *(unsigned long int *)sum =
+    *(unsigned long int *)wt_a + *(unsigned long int *)wt_b;
+}
+
+int cmp_ul(const void *a, const void *b){
+  if (*(unsigned long int *)a > *(unsigned long int *)b){
+    return 1;
+  }else if (*(unsigned long int *)a < *(unsigned long int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/* new weights in [0, high] */
+
+void new_ui(void *a, size_t high){
+  *(unsigned int *)a = RANDOM() % (high + 1);
+}
+
+void new_double(void *a, size_t high){
+  *(double *)a = DRAND() * high;
+}
+
+void new_ul(void *a, size_t high){
+  *(unsigned long int *)a = RANDOM() % (high + 1);
+}
+
+/* runs a specialized dijkstra on a if a is not NULL, and on c otherwise */
+
+void spec_uint_uint(const adj_lst_t *a,
+		    const adj_csr_t *c,
+		    size_t start,
+		    void *dist,
+		    size_t *prev,
+		    const heap_ht_t *hht){
+  if (a != NULL){
+    dijkstra_uint_uint(a, start, dist, prev, hht);
+  }else{
+    dijkstra_uint_uint_csr(c, start, dist, prev, hht);
+  }
+}
+
+void spec_uint_double(const adj_lst_t *a,
+		      const adj_csr_t *c,
+		      size_t start,
+		      void *dist,
+		      size_t *prev,
+		      const heap_ht_t *hht){
+  if (a != NULL){
+    dijkstra_uint_double(a, start, dist, prev, hht);
+  }else{
+    dijkstra_uint_double_csr(c, start, dist, prev, hht);
+  }
+}
+
+void spec_sz_ulong(const adj_lst_t *a,
+		   const adj_csr_t *c,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   const heap_ht_t *hht){
+  if (a != NULL){
+    dijkstra_sz_ulong(a, start, dist, prev, hht);
+  }else{
+    dijkstra_sz_ulong_csr(c, start, dist, prev, hht);
+  }
+}
+
+typedef struct{
+  const char *name;
+  size_t vt_size;
+  size_t wt_size;
+  size_t (*read_vt)(const void *);
+  void (*write_vt)(void *, size_t);
+  size_t wt_max; /* weights in [0, wt_max / num_vts] without overflow */
+  void (*new_wt)(void *, size_t);
+  void (*add_wt)(void *, const void *, const void *);
+  int (*cmp_wt)(const void *, const void *);
+  void (*spec)(const adj_lst_t *,
+	       const adj_csr_t *,
+	       size_t,
+	       void *,
+	       size_t *,
+	       const heap_ht_t *);
+} spec_type_t;
+
+const int C_SPEC_TYPES_COUNT = 3;
+const spec_type_t C_SPEC_TYPES[3] = {
+  {"unsigned int vertices, unsigned int weights",
+   sizeof(unsigned int), sizeof(unsigned int),
+   graph_read_uint, graph_write_uint,
+   UINT_MAX, new_ui, add_ui, cmp_ui, spec_uint_uint},
+  {"unsigned int vertices, double weights",
+   sizeof(unsigned int), sizeof(double),
+   graph_read_uint, graph_write_uint,
+   RAND_MAX, new_double, add_double, cmp_double, spec_uint_double},
+  {"size_t vertices, unsigned long weights",
+   sizeof(size_t), sizeof(unsigned long int),
+   graph_read_sz, graph_write_sz,
+   ULONG_MAX, new_ul, add_ul, cmp_ul, spec_sz_ulong}};
+
+/**
+   Initializes a random directed graph with the vertex and weight types
+   of t, where each of n(n - 1) possible edges is added according to bern.
+*/
+void rand_dir_graph_init(graph_t *g,
+			 size_t n,
+			 const spec_type_t *t,
+			 int (*bern)(void *),
+			 void *arg){
+  size_t i, j;
+  size_t num_es = 0;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  graph_base_init(g, n, t->vt_size, t->wt_size, t->read_vt, t->write_vt);
+  if (n < 2) return;
+  up = g->u = malloc_perror(n * (n - 1), g->vt_size);
+  vp = g->v = malloc_perror(n * (n - 1), g->vt_size);
+  wp = g->wts = malloc_perror(n * (n - 1), g->wt_size);
+  for (i = 0; i < n; i++){
+    for (j = 0; j < n; j++){
+      if (i == j || !bern(arg)) continue;
+      g->write_vt(up, i);
+      g->write_vt(vp, j);
+      t->new_wt(wp, t->wt_max / n);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      num_es++;
+    }
+  }
+  g->num_es = num_es;
+}
+
+/**
+   Returns 1 if the same vertices are reached according to two prev
+   arrays, and the distances of the reached vertices are equal.
+*/
+int same_reached_dist_wts(const void *dist_a,
+			  const size_t *prev_a,
+			  const void *dist_b,
+			  const size_t *prev_b,
+			  size_t n,
+			  size_t wt_size){
+  size_t i;
+  for (i = 0; i < n; i++){
+    if ((prev_a[i] == C_SIZE_MAX) != (prev_b[i] == C_SIZE_MAX)) return 0;
+    if (prev_a[i] != C_SIZE_MAX &&
+	memcmp((const char *)dist_a + i * wt_size,
+	       (const char *)dist_b + i * wt_size,
+	       wt_size) != 0) return 0;
+  }
+  return 1;
+}
+
+void run_rand_spec_test(int pow_start, int pow_end){
+  int k, p, i, j;
+  int res = 1;
+  size_t n;
+  size_t *rand_start = NULL;
+  size_t *prev_gen = NULL, *prev = NULL;
+  void *dist_gen = NULL, *dist = NULL;
+  const spec_type_t *t = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  bern_arg_t b;
+  ht_divchn_t ht_divchn;
+  heap_ht_t hht_divchn;
+  clock_t t_gen, t_spec, t_spec_csr, t_spec_divchn;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  prev_gen = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  for (k = 0; k < C_SPEC_TYPES_COUNT; k++){
+    t = &C_SPEC_TYPES[k];
+    dist_gen = malloc_perror(pow_two(pow_end), t->wt_size);
+    dist = malloc_perror(pow_two(pow_end), t->wt_size);
+    printf("Run a specialized dijkstra test on random directed graphs "
+	   "with %s\n", t->name);
+    fflush(stdout);
+    for (p = 0; p < C_PROBS_COUNT; p++){
+      b.p = C_PROBS[p];
+      printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+      for (i = pow_start; i <= pow_end; i++){
+	n = pow_two(i); /* 0 < n */
+	rand_dir_graph_init(&g, n, t, bern, &b);
+	adj_lst_base_init(&a, &g);
+	adj_lst_dir_build(&a, &g);
+	adj_csr_base_init(&c, &g);
+	adj_csr_dir_build(&c, &g);
+	graph_free(&g);
+	for (j = 0; j < C_ITER; j++){
+	  rand_start[j] = RANDOM() % n;
+	}
+	t_gen = 0;
+	t_spec = 0;
+	t_spec_csr = 0;
+	t_spec_divchn = 0;
+	for (j = 0; j < C_ITER; j++){
+	  t_gen -= clock();
+	  dijkstra(&a, rand_start[j], dist_gen, prev_gen, NULL,
+		   t->add_wt, t->cmp_wt);
+	  t_gen += clock();
+	  t_spec -= clock();
+	  t->spec(&a, NULL, rand_start[j], dist, prev, NULL);
+	  t_spec += clock();
+	  res *= same_reached_dist_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	  t_spec_csr -= clock();
+	  t->spec(NULL, &c, rand_start[j], dist, prev, NULL);
+	  t_spec_csr += clock();
+	  res *= same_reached_dist_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	  t_spec_divchn -= clock();
+	  t->spec(&a, NULL, rand_start[j], dist, prev, &hht_divchn);
+	  t_spec_divchn += clock();
+	  res *= same_reached_dist_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	}
+	printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	       TOLU(a.num_vts), TOLU(a.num_es));
+	printf("\t\t\tdijkstra default ht ave runtime:     %.8f seconds\n"
+	       "\t\t\tspecialized default ht ave runtime:  %.8f seconds\n"
+	       "\t\t\tspecialized csr ave runtime:         %.8f seconds\n"
+	       "\t\t\tspecialized ht_divchn ave runtime:   %.8f seconds\n",
+	       (float)t_gen / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec_csr / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec_divchn / C_ITER / CLOCKS_PER_SEC);
+	printf("\t\t\tcorrectness:                         ");
+	print_test_result(res);
+	res = 1;
+	adj_lst_free(&a);
+	adj_csr_free(&c);
+      }
+    }
+    free(dist_gen);
+    free(dist);
+    dist_gen = NULL;
+    dist = NULL;
+  }
+  free(rand_start);
+  free(prev_gen);
+  free(prev);
+  rand_start = NULL;
+  prev_gen = NULL;
+  prev = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
 /**
    Printing functions.
 */
@@ -890,13 +1777,14 @@ void print_double(const void *a){
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t i;
+  size_t num_vt_wts;
   printf("\tvertices: \n");
   for (i = 0; i < a->num_vts; i++){
     printf("\t%lu : ", TOLU(i));
-    p_start = a->vt_wts[i]->elts;
-    p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+    p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      printf("%lu ", TOLU(*(const size_t *)p));
+      printf("%lu ", TOLU(a->read_vt(p)));
     }
     printf("\n");
   }
@@ -904,10 +1792,10 @@ void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
     printf("\tweights: \n");
     for (i = 0; i < a->num_vts; i++){
       printf("\t%lu : ", TOLU(i));
-      p_start = a->vt_wts[i]->elts;
-      p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+      p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+      p_end = p_start + num_vt_wts * a->pair_size;
       for (p = p_start; p != p_end; p += a->pair_size){
-	print_wt(p + a->offset);
+	print_wt(p + a->wt_offset);
       }
       printf("\n");
     }
@@ -960,7 +1848,8 @@ int main(int argc, char *argv[]){
       args[1] < args[0] ||
       args[2] > 1 ||
       args[3] > 1 ||
-      args[4] > 1){
+      args[4] > 1 ||
+      args[5] > 1){
     printf("USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -969,7 +1858,12 @@ int main(int argc, char *argv[]){
     run_double_graph_test();
   }
   if (args[3]) run_bfs_dijkstra_test(args[0], args[1]);
-  if (args[4]) run_rand_uint_test(args[0], args[1]);
+  if (args[4]){
+    run_rand_uint_test(args[0], args[1]);
+    run_rand_p2p_test(args[0], args[1]);
+    run_rand_repair_test(args[0], args[1]);
+  }
+  if (args[5]) run_rand_spec_test(args[0], args[1]);
   free(args);
   args = NULL;
   return 0;
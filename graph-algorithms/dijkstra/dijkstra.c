@@ -13,14 +13,59 @@
    operations, and enables the optimization of space and time resources
    associated with heap operations in Dijkstra's algorithm by choice of a
    hash table and its load factor upper bound. If NULL is passed as a hash
-   table parameter value, a default hash table is used, which contains an
-   index array with a count that is equal to the number of vertices in the
-   graph.   
+   table parameter value, the heap uses an index array with a count that
+   is equal to the number of vertices in the graph instead of a hash table.   
 
-   If E >> V, a default hash table may provide speed advantages by avoiding
+   If E >> V, an index array may provide speed advantages by avoiding
    the computation of hash values. If V is large and the graph is sparse,
    a non-default hash table may provide space advantages.
 
+   If edge weights are non-negative integers, dijkstra_radix and
+   dijkstra_radix_csr use a radix heap instead of a heap with a hash table.
+   The radix heap contains 1 + CHAR_BIT * sizeof(size_t) buckets, where the
+   ith bucket for i > 0 contains the vertices with distance keys that
+   differ from the last popped key at bit i - 1 as the highest differing
+   bit. A decrease of a key is an insertion with amortized O(1) cost, and
+   a vertex with a key that is greater than its distance is skipped when
+   popped. A pop moves the entries of the lowest non-empty bucket to lower
+   buckets, and each entry moves at most CHAR_BIT * sizeof(size_t) times.
+
+   dijkstra_pair and dijkstra_pair_csr use a pairing heap with a pool of a
+   node for each vertex instead of a heap with a hash table. A decrease of
+   a key cuts the subtree of a vertex and links it with the root in O(1)
+   time, and a pop merges the children of the root in a two-pass pairing.
+
+   If Dijkstra's algorithm is run repeatedly on a graph, e.g. for
+   point-to-point queries, dijkstra_ws and dijkstra_ws_csr run with a
+   workspace that is allocated once per thread. The heap and its hash
+   table or index array are allocated once, and the dist and prev arrays
+   are reset in O(number of vertices reached in the previous run) time
+   by keeping the reached vertices in a stack.
+
+   If a single target is queried, dijkstra_ws_target and
+   dijkstra_ws_target_csr stop when the target is settled. dijkstra_bidir
+   and dijkstra_bidir_csr run a forward search from the start vertex and a
+   backward search from the target on a reverse adjacency list, e.g. built
+   with adj_lst_dir_build on a graph with exchanged u and v edge arrays,
+   and stop when the sum of the last settled distances of the two searches
+   is not less than the weight of the shortest path found.
+
+   If edges are inserted into an adjacency list or their weights are
+   decreased after a run, dijkstra_repair_dir and dijkstra_repair_undir
+   update the dist and prev arrays of the run without a run from scratch.
+   Because the distances do not increase, the heads of the edges of a
+   batch with a decreased distance are pushed into a heap, and the repair
+   relaxes only the edges of the vertices with a decreased distance, where
+   a settled vertex is pushed again if its distance decreases.
+
+   If the vertices and weights are of one of the (unsigned int, unsigned
+   int), (unsigned int, double), and (size_t, unsigned long) type pairs,
+   dijkstra_uint_uint, dijkstra_uint_double, dijkstra_sz_ulong, and their
+   _csr versions read vertices, add and compare weights without calls
+   through function pointers, so that the compiler can inline the edge
+   relaxation, and use a heap with a structure-of-arrays layout and a
+   specialized priority comparison.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99.
 */
@@ -28,43 +73,208 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "dijkstra.h"
 #include "graph.h"
 #include "heap.h"
+#include "heap-pair.h"
 #include "stack.h"
 #include "utilities-mem.h"
 
-typedef enum{FALSE, TRUE} boolean_t;
+#define RDX_NUM_BKTS (1 + CHAR_BIT * sizeof(size_t))
 
 typedef struct{
-  size_t count;
-} context_t;
+  size_t key;
+  size_t vt;
+} rdx_elt_t;
 
 typedef struct{
-  size_t key_size;
-  size_t elt_size;
-  size_t count;
-  boolean_t *key_present;
-  void *elts;
-  void (*free_elt)(void *);
-} ht_def_t;
+  size_t last;                /* last popped key */
+  size_t num_elts;
+  size_t log_start;           /* largest power of two less than bit width */
+  stack_t bkts[RDX_NUM_BKTS];
+} rdx_heap_t;
+
+typedef struct{
+  size_t wt_size;
+  size_t *m;                  /* vertex on the shortest path found */
+  void *mu;                   /* weight of the shortest path found */
+  const void *dist_o;         /* distances of the opposite search */
+  const size_t *prev_o;       /* previous vertices of the opposite search */
+} bidir_t;
 
 static const size_t C_NREACHED = (size_t)-1; /* not reached as index */
 
-/* default hash table operations */
-static void ht_def_init(ht_def_t *ht,
-			size_t key_size,
-			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context);
-static void ht_def_insert(ht_def_t *ht, const size_t *key,const void *elt);
-static void *ht_def_search(const ht_def_t *ht, const size_t *key);
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt);
-static void ht_def_free(ht_def_t *ht);
+static void dijkstra_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  size_t *prev,
+			  const heap_ht_t *hht,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *));
+
+static void dijkstra_ws_view(const adj_view_t *a,
+			     size_t start,
+			     size_t target,
+			     void *dist,
+			     size_t *prev,
+			     dijkstra_ws_t *ws,
+			     void (*add_wt)(void *, const void *, const void *),
+			     int (*cmp_wt)(const void *, const void *));
+
+static size_t dijkstra_bidir_view(const adj_view_t *a,
+				  const adj_view_t *r,
+				  size_t start,
+				  size_t target,
+				  void *dist,
+				  size_t *prev,
+				  void *dist_r,
+				  size_t *next,
+				  dijkstra_ws_t *ws,
+				  dijkstra_ws_t *ws_r,
+				  void (*add_wt)(void *, const void *,
+						 const void *),
+				  int (*cmp_wt)(const void *, const void *));
+
+/* operations of a search with a workspace */
+static void ws_begin(const adj_view_t *a,
+		     size_t start,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws);
+static void ws_relax(const adj_view_t *a,
+		     size_t u,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws,
+		     bidir_t *bd,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *));
+static void bidir_update(bidir_t *bd,
+			 size_t v,
+			 const void *v_wt,
+			 void *buf,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *));
+
+static size_t dijkstra_repair_view(const adj_view_t *a,
+				   const graph_t *g,
+				   int is_undir,
+				   void *dist,
+				   size_t *prev,
+				   dijkstra_ws_t *ws,
+				   void (*add_wt)(void *, const void *,
+						  const void *),
+				   int (*cmp_wt)(const void *, const void *));
+static int repair_relax(size_t u,
+			size_t v,
+			const void *wt,
+			void *dist,
+			size_t *prev,
+			dijkstra_ws_t *ws,
+			void (*add_wt)(void *, const void *, const void *),
+			int (*cmp_wt)(const void *, const void *));
+
+static void dijkstra_radix_view(const adj_view_t *a,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				void (*add_wt)(void *,
+					       const void *,
+					       const void *),
+				size_t (*read_wt)(const void *));
+
+static void dijkstra_pair_view(const adj_view_t *a,
+			       size_t start,
+			       void *dist,
+			       size_t *prev,
+			       void (*add_wt)(void *,
+					      const void *,
+					      const void *),
+			       int (*cmp_wt)(const void *, const void *));
+
+/* radix heap operations */
+static void rdx_init(rdx_heap_t *h);
+static void rdx_push(rdx_heap_t *h, size_t key, size_t vt);
+static void rdx_pop(rdx_heap_t *h, rdx_elt_t *e);
+static void rdx_free(rdx_heap_t *h);
+static size_t rdx_bkt(const rdx_heap_t *h, size_t key);
 
 /* functions for computing pointers */
 static void *wt_ptr(const void *wts, size_t i, size_t wt_size);
-static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
+
+/**
+   Defines a Dijkstra's algorithm on a view of an adjacency list with
+   vertices of type vt_t and weights of type wt_t of basic type, and the
+   functions dijkstra_<name> and dijkstra_<name>_csr that run the algorithm
+   on an adjacency list and a CSR adjacency list. The weights are added
+   with the + operator and compared with the > operator, and the heap
+   compares the priorities according to pty_type that is not HEAP_PTY_GEN.
+*/
+#define DIJKSTRA_SPEC(name, vt_t, wt_t, pty_type)			\
+  static void dijkstra_##name##_view(const adj_view_t *a,		\
+				     size_t start,			\
+				     wt_t *dist,			\
+				     size_t *prev,			\
+				     const heap_ht_t *hht){		\
+    const char *p = NULL, *p_start = NULL, *p_end = NULL;		\
+    size_t pair_size = a->pair_size, wt_offset = a->wt_offset;		\
+    size_t num_vt_wts;							\
+    size_t u, v;							\
+    wt_t u_wt, sum_wt;							\
+    heap_t h;								\
+    if (hht == NULL){							\
+      heap_init(&h, sizeof(wt_t), sizeof(size_t), a->num_vts, 0, 0,	\
+		NULL, NULL, NULL, NULL, NULL);				\
+    }else{								\
+      heap_init(&h, sizeof(wt_t), sizeof(size_t), 0, hht->alpha_n,	\
+		hht->log_alpha_d, hht, NULL, NULL, NULL, NULL);		\
+    }									\
+    heap_soa(&h, pty_type);						\
+    memset(dist, 0, a->num_vts * sizeof(wt_t));				\
+    memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */	\
+    heap_push(&h, &dist[start], &start);				\
+    prev[start] = start;						\
+    while (h.num_elts > 0){						\
+      heap_pop(&h, &u_wt, &u);						\
+      p_start = a->vt_wts(a->adj, u, &num_vt_wts);			\
+      p_end = p_start + num_vt_wts * pair_size;				\
+      for (p = p_start; p != p_end; p += pair_size){			\
+	v = *(const vt_t *)p;						\
+	sum_wt = u_wt + *(const wt_t *)(p + wt_offset);			\
+	if (prev[v] == C_NREACHED){					\
+	  dist[v] = sum_wt;						\
+	  heap_push(&h, &sum_wt, &v);					\
+	  prev[v] = u;							\
+	}else if (dist[v] > sum_wt){					\
+	  dist[v] = sum_wt;						\
+	  heap_update(&h, &sum_wt, &v);					\
+	  prev[v] = u;							\
+	}								\
+      }									\
+    }									\
+    heap_free(&h);							\
+  }									\
+									\
+  void dijkstra_##name(const adj_lst_t *a,				\
+		       size_t start,					\
+		       wt_t *dist,					\
+		       size_t *prev,					\
+		       const heap_ht_t *hht){				\
+    adj_view_t w;							\
+    adj_lst_view(&w, a);						\
+    dijkstra_##name##_view(&w, start, dist, prev, hht);			\
+  }									\
+									\
+  void dijkstra_##name##_csr(const adj_csr_t *c,			\
+			     size_t start,				\
+			     wt_t *dist,				\
+			     size_t *prev,				\
+			     const heap_ht_t *hht){			\
+    adj_view_t w;							\
+    adj_csr_view(&w, c);						\
+    dijkstra_##name##_view(&w, start, dist, prev, hht);			\
+  }
 
 /**
    Computes and copies the shortest distances from start to the array
@@ -78,9 +288,9 @@ static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
                  is equal to the size of a weight in the adjacency list
    prev        : pointer to a preallocated array with a count that is equal
                  to the number of vertices in the adjacency list
-   hht         : - NULL pointer, if a default hash table is used for
-                 in-heap operations; a default hash table contains an index
-                 array with a count that is equal to the number of vertices
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
                  - a pointer to a set of parameters specifying a hash table
                  used for in-heap operations; a vertex is a hash key in 
                  the hash table
@@ -102,118 +312,838 @@ void dijkstra(const adj_lst_t *a,
 	      const heap_ht_t *hht,
 	      void (*add_wt)(void *, const void *, const void *),
 	      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dijkstra_view(&w, start, dist, prev, hht, add_wt, cmp_wt);
+}
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given a compressed sparse row (CSR) adjacency list. Please see the
+   parameter specification in dijkstra.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void dijkstra_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  size_t *prev,
+		  const heap_ht_t *hht,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dijkstra_view(&w, start, dist, prev, hht, add_wt, cmp_wt);
+}
+
+/**
+   Initializes a workspace for repeated runs of dijkstra_ws and
+   dijkstra_ws_csr.
+   ws          : pointer to a preallocated block of size
+                 sizeof(dijkstra_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   wt_size     : size of a weight in the graphs in the runs
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to num_vts is used for in-heap operations
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; the hash table is kept
+                 across runs and freed by dijkstra_ws_free
+   cmp_wt      : comparison function as specified in dijkstra, and used by
+                 each run with the workspace
+*/
+void dijkstra_ws_init(dijkstra_ws_t *ws,
+		      size_t num_vts,
+		      size_t wt_size,
+		      const heap_ht_t *hht,
+		      int (*cmp_wt)(const void *, const void *)){
+  ws->num_vts = num_vts;
+  ws->wt_size = wt_size;
+  ws->is_first = 1;
+  ws->wt_bufs = malloc_perror(3, wt_size);
+  if (hht == NULL){
+    /* the heap maps a vertex to its index with an index array */
+    heap_init(&ws->h, wt_size, sizeof(size_t), num_vts, 0, 0, NULL,
+	      cmp_wt, NULL, NULL, NULL);
+  }else{
+    heap_init(&ws->h, wt_size, sizeof(size_t), 0, hht->alpha_n,
+	      hht->log_alpha_d, hht, cmp_wt, NULL, NULL, NULL);
+  }
+  stack_init(&ws->vts, 1, sizeof(size_t), NULL);
+}
+
+/**
+   Runs dijkstra with a workspace. The dist and prev parameters point to
+   the same arrays in each run with the workspace, and only the entries of
+   the vertices reached in the previous run are reset. Between runs, the
+   caller may read but not modify the arrays. The output is the same as
+   the output of dijkstra with the same parameters. Please see the
+   parameter specification in dijkstra.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+*/
+void dijkstra_ws(const adj_lst_t *a,
+		 size_t start,
+		 void *dist,
+		 size_t *prev,
+		 dijkstra_ws_t *ws,
+		 void (*add_wt)(void *, const void *, const void *),
+		 int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dijkstra_ws_view(&w, start, C_NREACHED, dist, prev, ws, add_wt,
+		   cmp_wt);
+}
+
+void dijkstra_ws_csr(const adj_csr_t *c,
+		     size_t start,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dijkstra_ws_view(&w, start, C_NREACHED, dist, prev, ws, add_wt,
+		   cmp_wt);
+}
+
+/**
+   Runs dijkstra with a workspace and stops when the target is settled.
+   The weight of a shortest path from start to target is in the dist array
+   at target, and the path is provided by the prev array from target to
+   start. The prev array has the maximal value of size_t at target if
+   target is not reachable from start. The entries at other vertices are
+   only specified for the vertices on the path. Please see the parameter
+   specification in dijkstra_ws.
+   target      : target vertex
+*/
+void dijkstra_ws_target(const adj_lst_t *a,
+			size_t start,
+			size_t target,
+			void *dist,
+			size_t *prev,
+			dijkstra_ws_t *ws,
+			void (*add_wt)(void *, const void *, const void *),
+			int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dijkstra_ws_view(&w, start, target, dist, prev, ws, add_wt, cmp_wt);
+}
+
+void dijkstra_ws_target_csr(const adj_csr_t *c,
+			    size_t start,
+			    size_t target,
+			    void *dist,
+			    size_t *prev,
+			    dijkstra_ws_t *ws,
+			    void (*add_wt)(void *, const void *,
+					   const void *),
+			    int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dijkstra_ws_view(&w, start, target, dist, prev, ws, add_wt, cmp_wt);
+}
+
+/**
+   Runs a bidirectional Dijkstra's algorithm with two workspaces from start
+   to target. Returns a vertex on a shortest path from start to target, or
+   the maximal value of size_t if target is not reachable from start.
+   Given a returned vertex m, the weight of a shortest path is the sum of
+   the weights in the dist and dist_r arrays at m, the prev array provides
+   the path from m to start, and the next array provides the path from m to
+   target. The entries at other vertices are only specified for the
+   vertices on the path. Please see the parameter specification in
+   dijkstra_ws.
+   a           : pointer to an adjacency list with at least one vertex
+   r           : pointer to the reverse adjacency list of a, where an edge
+                 (v, u) with a weight is in r iff the edge (u, v) with the
+                 weight is in a
+   start       : start vertex
+   target      : target vertex
+   dist        : forward distances, as the dist array in dijkstra_ws
+   prev        : forward previous vertices, as the prev array in
+                 dijkstra_ws
+   dist_r      : backward distances, as the dist array in dijkstra_ws
+   next        : backward previous vertices, i.e. next vertices on the
+                 paths to target, as the prev array in dijkstra_ws
+   ws          : pointer to a workspace of the forward search
+   ws_r        : pointer to a workspace of the backward search, distinct
+                 from ws
+*/
+size_t dijkstra_bidir(const adj_lst_t *a,
+		      const adj_lst_t *r,
+		      size_t start,
+		      size_t target,
+		      void *dist,
+		      size_t *prev,
+		      void *dist_r,
+		      size_t *next,
+		      dijkstra_ws_t *ws,
+		      dijkstra_ws_t *ws_r,
+		      void (*add_wt)(void *, const void *, const void *),
+		      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w, w_r;
+  adj_lst_view(&w, a);
+  adj_lst_view(&w_r, r);
+  return dijkstra_bidir_view(&w, &w_r, start, target, dist, prev,
+			     dist_r, next, ws, ws_r, add_wt, cmp_wt);
+}
+
+size_t dijkstra_bidir_csr(const adj_csr_t *c,
+			  const adj_csr_t *r,
+			  size_t start,
+			  size_t target,
+			  void *dist,
+			  size_t *prev,
+			  void *dist_r,
+			  size_t *next,
+			  dijkstra_ws_t *ws,
+			  dijkstra_ws_t *ws_r,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w, w_r;
+  adj_csr_view(&w, c);
+  adj_csr_view(&w_r, r);
+  return dijkstra_bidir_view(&w, &w_r, start, target, dist, prev,
+			     dist_r, next, ws, ws_r, add_wt, cmp_wt);
+}
+
+/**
+   Repairs the output of a run from a start vertex after a batch of edge
+   insertions or weight decreases, by updating the distances and previous
+   vertices only in the region of the vertices with a decreased distance.
+   Returns the number of decreases of a distance in the repair, which is 0
+   if the batch does not change a shortest path distance. The output is the
+   same as the output of a run after the batch, except that a previous
+   vertex may be another vertex on a shortest path of the same weight.
+   a           : pointer to an adjacency list to which the edges of the
+                 batch were added, e.g. with adj_lst_add_dir_edge, or where
+                 the weights of the edges of the batch were decreased
+   g           : pointer to a graph with the edges of the batch and their
+                 new weights, where the weights do not exceed the weights
+                 of the edges before the batch; dijkstra_repair_dir
+                 considers an edge (u, v) directed, and
+                 dijkstra_repair_undir considers it as the edges (u, v)
+                 and (v, u), as adj_lst_add_undir_edge
+   dist        : pointer to the dist array of a run of dijkstra,
+                 dijkstra_ws, or dijkstra_repair_{dir, undir}, which
+                 explored all vertices reachable from start
+   prev        : pointer to the prev array of the run
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list; if the
+                 workspace is used by dijkstra_ws with the dist and prev
+                 arrays, the vertices reached for the first time in the
+                 repair are reset in the next run of dijkstra_ws
+   add_wt      : addition function as specified in dijkstra
+   cmp_wt      : comparison function as specified in dijkstra
+*/
+size_t dijkstra_repair_dir(const adj_lst_t *a,
+			   const graph_t *g,
+			   void *dist,
+			   size_t *prev,
+			   dijkstra_ws_t *ws,
+			   void (*add_wt)(void *, const void *, const void *),
+			   int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return dijkstra_repair_view(&w, g, 0, dist, prev, ws, add_wt, cmp_wt);
+}
+
+size_t dijkstra_repair_undir(const adj_lst_t *a,
+			     const graph_t *g,
+			     void *dist,
+			     size_t *prev,
+			     dijkstra_ws_t *ws,
+			     void (*add_wt)(void *, const void *,
+					    const void *),
+			     int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return dijkstra_repair_view(&w, g, 1, dist, prev, ws, add_wt, cmp_wt);
+}
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given an adjacency list or a CSR adjacency list with vertices and
+   weights of the types in the function name: uint for unsigned int, sz for
+   size_t, ulong for unsigned long, and double. The vt_size and wt_size of
+   the adjacency list are the sizes of the types. The weights are added
+   and compared with the + and > operators, and the output is the same as
+   the output of dijkstra and dijkstra_csr with the corresponding add_wt
+   and cmp_wt. Please see the parameter specification in dijkstra.
+*/
+DIJKSTRA_SPEC(uint_uint, unsigned int, unsigned int, HEAP_PTY_UINT)
+DIJKSTRA_SPEC(uint_double, unsigned int, double, HEAP_PTY_DOUBLE)
+DIJKSTRA_SPEC(sz_ulong, size_t, unsigned long int, HEAP_PTY_ULONG)
+
+/**
+   Resets the dist and prev arrays of a run with a workspace, and empties
+   the heap and the set of reached vertices of the workspace. The dist and
+   prev arrays are fully reset in the first run, and otherwise only at the
+   vertices reached in the previous run. Used by the runs of dijkstra_ws
+   and by other algorithms that run with a workspace, e.g. A*, before the
+   start vertex is pushed into the heap.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+   dist        : pointer to the dist array of the runs with the workspace
+   prev        : pointer to the prev array of the runs with the workspace
+*/
+void dijkstra_ws_reset(dijkstra_ws_t *ws, void *dist, size_t *prev){
+  size_t i;
+  size_t wt_size = ws->wt_size;
+  const size_t *vts = NULL;
+  if (ws->is_first){
+    memset(dist, 0, ws->num_vts * wt_size);
+    memset(prev, 0xff, ws->num_vts * sizeof(size_t)); /* C_NREACHED */
+    ws->is_first = 0;
+  }else{
+    vts = ws->vts.elts;
+    for (i = 0; i < ws->vts.num_elts; i++){
+      memset(wt_ptr(dist, vts[i], wt_size), 0, wt_size);
+      prev[vts[i]] = C_NREACHED;
+    }
+  }
+  ws->vts.num_elts = 0;
+  heap_reset(&ws->h);
+}
+
+/**
+   Frees a workspace and leaves a block of size sizeof(dijkstra_ws_t)
+   pointed to by the ws parameter.
+*/
+void dijkstra_ws_free(dijkstra_ws_t *ws){
+  heap_free(&ws->h);
+  stack_free(&ws->vts);
+  free(ws->wt_bufs);
+  ws->wt_bufs = NULL;
+}
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given an adjacency list with non-negative integer weights. A radix
+   heap is used instead of a heap with a hash table parameter. The
+   distances are required to be representable in the weight type and in
+   size_t. The prev array has the maximal value of size_t for unreached
+   vertices.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   read_wt     : returns the value of the integer weight pointed to by the
+                 argument as size_t (e.g. graph_read_uint)
+*/
+void dijkstra_radix(const adj_lst_t *a,
+		    size_t start,
+		    void *dist,
+		    size_t *prev,
+		    void (*add_wt)(void *, const void *, const void *),
+		    size_t (*read_wt)(const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dijkstra_radix_view(&w, start, dist, prev, add_wt, read_wt);
+}
+
+void dijkstra_radix_csr(const adj_csr_t *c,
+			size_t start,
+			void *dist,
+			size_t *prev,
+			void (*add_wt)(void *, const void *, const void *),
+			size_t (*read_wt)(const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dijkstra_radix_view(&w, start, dist, prev, add_wt, read_wt);
+}
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, with a pairing heap instead of a heap with a hash table parameter.
+   A decrease of a distance in the heap links a subtree with the root in
+   O(1) time, which may provide speed advantages on dense graphs where the
+   number of decreases exceeds the number of pops. The output is the same
+   as the output of dijkstra and dijkstra_csr. The prev array has the
+   maximal value of size_t for unreached vertices. Please see the
+   parameter specification in dijkstra.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void dijkstra_pair(const adj_lst_t *a,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   void (*add_wt)(void *, const void *, const void *),
+		   int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  dijkstra_pair_view(&w, start, dist, prev, add_wt, cmp_wt);
+}
+
+void dijkstra_pair_csr(const adj_csr_t *c,
+		       size_t start,
+		       void *dist,
+		       size_t *prev,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  dijkstra_pair_view(&w, start, dist, prev, add_wt, cmp_wt);
+}
+
+/**
+   Runs Dijkstra's algorithm on a view of an adjacency list with a
+   workspace that is used in a single run.
+*/
+static void dijkstra_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  size_t *prev,
+			  const heap_ht_t *hht,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *)){
+  dijkstra_ws_t ws;
+  dijkstra_ws_init(&ws, a->num_vts, a->wt_size, hht, cmp_wt);
+  dijkstra_ws_view(a, start, C_NREACHED, dist, prev, &ws, add_wt, cmp_wt);
+  dijkstra_ws_free(&ws);
+}
+
+/**
+   Runs Dijkstra's algorithm on a view of an adjacency list with a
+   workspace. A vertex is a size_t index in the heap and its hash table.
+   The dist and prev arrays are fully reset in the first run, and
+   otherwise only at the vertices reached in the previous run. The run
+   stops when target is settled, or explores all reachable vertices if
+   target is C_NREACHED.
+*/
+static void dijkstra_ws_view(const adj_view_t *a,
+			     size_t start,
+			     size_t target,
+			     void *dist,
+			     size_t *prev,
+			     dijkstra_ws_t *ws,
+			     void (*add_wt)(void *, const void *, const void *),
+			     int (*cmp_wt)(const void *, const void *)){
+  size_t u;
+  ws_begin(a, start, dist, prev, ws);
+  while (ws->h.num_elts > 0){
+    heap_pop(&ws->h, ws->wt_bufs, &u);
+    if (u == target) break;
+    ws_relax(a, u, dist, prev, ws, NULL, add_wt, cmp_wt);
+  }
+}
+
+/**
+   Runs a bidirectional Dijkstra's algorithm on views of an adjacency list
+   and its reverse. The search with the smaller heap settles a vertex in
+   each step. Because the last settled distance of a search is a lower
+   bound of the distances in its heap, the run stops when the sum of the
+   last settled distances of the searches is not less than the weight of
+   the shortest path found, or when a heap is empty. The last settled
+   distance of a search is in the first weight buffer of its workspace.
+*/
+static size_t dijkstra_bidir_view(const adj_view_t *a,
+				  const adj_view_t *r,
+				  size_t start,
+				  size_t target,
+				  void *dist,
+				  size_t *prev,
+				  void *dist_r,
+				  size_t *next,
+				  dijkstra_ws_t *ws,
+				  dijkstra_ws_t *ws_r,
+				  void (*add_wt)(void *, const void *,
+						 const void *),
+				  int (*cmp_wt)(const void *, const void *)){
+  size_t u;
+  size_t wt_size = a->wt_size;
+  void *sum_wt = wt_ptr(ws->wt_bufs, 1, wt_size);
+  size_t m = C_NREACHED;
+  const adj_view_t *w = NULL;
+  void *w_dist = NULL;
+  size_t *w_prev = NULL;
+  dijkstra_ws_t *w_ws = NULL;
+  bidir_t bd, bd_r, *w_bd = NULL;
+  bd.wt_size = wt_size;
+  bd.m = &m;
+  bd.mu = wt_ptr(ws->wt_bufs, 2, wt_size);
+  bd.dist_o = dist_r;
+  bd.prev_o = next;
+  bd_r = bd;
+  bd_r.dist_o = dist;
+  bd_r.prev_o = prev;
+  ws_begin(a, start, dist, prev, ws);
+  ws_begin(r, target, dist_r, next, ws_r);
+  memset(ws->wt_bufs, 0, wt_size);
+  memset(ws_r->wt_bufs, 0, wt_size);
+  if (start == target) return start;
+  while (ws->h.num_elts > 0 && ws_r->h.num_elts > 0){
+    if (ws->h.num_elts <= ws_r->h.num_elts){
+      w = a;
+      w_dist = dist;
+      w_prev = prev;
+      w_ws = ws;
+      w_bd = &bd;
+    }else{
+      w = r;
+      w_dist = dist_r;
+      w_prev = next;
+      w_ws = ws_r;
+      w_bd = &bd_r;
+    }
+    heap_pop(&w_ws->h, w_ws->wt_bufs, &u);
+    if (m != C_NREACHED){
+      add_wt(sum_wt, ws->wt_bufs, ws_r->wt_bufs);
+      if (cmp_wt(sum_wt, bd.mu) >= 0) break;
+    }
+    ws_relax(w, u, w_dist, w_prev, w_ws, w_bd, add_wt, cmp_wt);
+  }
+  return m;
+}
+
+/**
+   Resets the dist and prev arrays according to a workspace, and pushes
+   start into the heap of the workspace.
+*/
+static void ws_begin(const adj_view_t *a,
+		     size_t start,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws){
+  dijkstra_ws_reset(ws, dist, prev);
+  heap_push(&ws->h, wt_ptr(dist, start, a->wt_size), &start);
+  prev[start] = start;
+  stack_push(&ws->vts, &start);
+}
+
+/**
+   Relaxes the edges of a vertex u that was popped with its distance into
+   the first weight buffer of a workspace. If bd is not NULL, then the
+   shortest path found by a bidirectional search is updated at each
+   reached or improved vertex that was reached by the opposite search.
+*/
+static void ws_relax(const adj_view_t *a,
+		     size_t u,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws,
+		     bidir_t *bd,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t wt_size = a->wt_size;
-  size_t vt_size = sizeof(size_t);
-  size_t init_count = 1;
-  size_t u, v;
+  size_t num_vt_wts;
+  size_t v;
   void *u_wt = NULL, *v_wt = NULL, *sum_wt = NULL;
-  ht_def_t ht_def;
-  context_t context;
-  heap_ht_t hht_def;
-  heap_t h;
-  u_wt = malloc_perror(1, wt_size);
+  heap_t *h = &ws->h;
+  u_wt = ws->wt_bufs;
+  sum_wt = wt_ptr(ws->wt_bufs, 1, wt_size);
+  p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+  p_end = p_start + num_vt_wts * a->pair_size;
+  for (p = p_start; p != p_end; p += a->pair_size){
+    v = a->read_vt(p);
+    v_wt = wt_ptr(dist, v, wt_size);
+    add_wt(sum_wt, u_wt, p + a->wt_offset);
+    if (prev[v] == C_NREACHED){
+      memcpy(v_wt, sum_wt, wt_size);
+      heap_push(h, v_wt, &v);
+      prev[v] = u;
+      stack_push(&ws->vts, &v);
+    }else if (cmp_wt(v_wt, sum_wt) > 0){
+      /* must be in the heap */
+      memcpy(v_wt, sum_wt, wt_size);
+      heap_update(h, v_wt, &v);
+      prev[v] = u;
+    }else{
+      continue;
+    }
+    if (bd != NULL && bd->prev_o[v] != C_NREACHED){
+      bidir_update(bd, v, v_wt, sum_wt, add_wt, cmp_wt);
+    }
+  }
+}
+
+/**
+   Updates the shortest path found by a bidirectional search with the path
+   through v, given the distance of v in the search, a buffer of size
+   wt_size, and that v was reached by the opposite search.
+*/
+static void bidir_update(bidir_t *bd,
+			 size_t v,
+			 const void *v_wt,
+			 void *buf,
+			 void (*add_wt)(void *, const void *, const void *),
+			 int (*cmp_wt)(const void *, const void *)){
+  add_wt(buf, v_wt, wt_ptr(bd->dist_o, v, bd->wt_size));
+  if (*bd->m == C_NREACHED || cmp_wt(buf, bd->mu) < 0){
+    memcpy(bd->mu, buf, bd->wt_size);
+    *bd->m = v;
+  }
+}
+
+/**
+   Repairs the dist and prev arrays of a run on a view of an adjacency
+   list after a batch of edge insertions or weight decreases. The heads of
+   the edges of the batch with a decreased distance are pushed, and the
+   vertices are popped and relaxed as in a run, except that a popped
+   vertex is pushed again if its distance decreases, because it was
+   settled before the first pop of the repair.
+*/
+static size_t dijkstra_repair_view(const adj_view_t *a,
+				   const graph_t *g,
+				   int is_undir,
+				   void *dist,
+				   size_t *prev,
+				   dijkstra_ws_t *ws,
+				   void (*add_wt)(void *, const void *,
+						  const void *),
+				   int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  const void *wt = NULL;
+  size_t i, u, v;
+  size_t num_vt_wts;
+  size_t num_decr = 0;
+  heap_reset(&ws->h);
+  for (i = 0; i < g->num_es; i++){
+    u = g->read_vt((const char *)g->u + i * g->vt_size);
+    v = g->read_vt((const char *)g->v + i * g->vt_size);
+    wt = wt_ptr(g->wts, i, g->wt_size);
+    num_decr += repair_relax(u, v, wt, dist, prev, ws, add_wt, cmp_wt);
+    if (is_undir){
+      num_decr += repair_relax(v, u, wt, dist, prev, ws, add_wt, cmp_wt);
+    }
+  }
+  while (ws->h.num_elts > 0){
+    heap_pop(&ws->h, ws->wt_bufs, &u);
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
+    for (p = p_start; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      num_decr += repair_relax(u, v, p + a->wt_offset, dist, prev, ws,
+			       add_wt, cmp_wt);
+    }
+  }
+  return num_decr;
+}
+
+/**
+   Relaxes an edge (u, v) with a weight in a repair, if u is reached. If
+   the distance of v decreases, then v is pushed into the heap of a
+   workspace or its priority is updated, and 1 is returned, otherwise 0 is
+   returned. A vertex reached for the first time is pushed into the stack
+   of the workspace.
+*/
+static int repair_relax(size_t u,
+			size_t v,
+			const void *wt,
+			void *dist,
+			size_t *prev,
+			dijkstra_ws_t *ws,
+			void (*add_wt)(void *, const void *, const void *),
+			int (*cmp_wt)(const void *, const void *)){
+  size_t wt_size = ws->wt_size;
+  void *v_wt = wt_ptr(dist, v, wt_size);
+  void *sum_wt = wt_ptr(ws->wt_bufs, 1, wt_size);
+  if (prev[u] == C_NREACHED) return 0;
+  add_wt(sum_wt, wt_ptr(dist, u, wt_size), wt);
+  if (prev[v] == C_NREACHED){
+    stack_push(&ws->vts, &v);
+  }else if (cmp_wt(v_wt, sum_wt) <= 0){
+    return 0;
+  }
+  memcpy(v_wt, sum_wt, wt_size);
+  prev[v] = u;
+  if (heap_search(&ws->h, &v) == NULL){
+    heap_push(&ws->h, v_wt, &v);
+  }else{
+    heap_update(&ws->h, v_wt, &v);
+  }
+  return 1;
+}
+
+/**
+   Runs Dijkstra's algorithm with a radix heap on a view of an adjacency
+   list with non-negative integer weights. A vertex is pushed each time its
+   distance decreases, and an entry with a key greater than the distance of
+   its vertex is skipped.
+*/
+static void dijkstra_radix_view(const adj_view_t *a,
+				size_t start,
+				void *dist,
+				size_t *prev,
+				void (*add_wt)(void *,
+					       const void *,
+					       const void *),
+				size_t (*read_wt)(const void *)){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  size_t wt_size = a->wt_size;
+  size_t num_vt_wts;
+  size_t v, sum_key;
+  void *u_wt = NULL, *v_wt = NULL, *sum_wt = NULL;
+  rdx_elt_t e;
+  rdx_heap_t h;
   sum_wt = malloc_perror(1, wt_size);
   memset(dist, 0, a->num_vts * wt_size);
-  memset(prev, 0xff, a->num_vts * vt_size); /* initialize to C_NREACHED */
-  if (hht == NULL){
-    context.count = a->num_vts;
-    hht_def.ht = &ht_def;
-    hht_def.context = &context;
-    hht_def.init = (heap_ht_init)ht_def_init;
-    hht_def.insert = (heap_ht_insert)ht_def_insert;
-    hht_def.search = (heap_ht_search)ht_def_search;
-    hht_def.remove = (heap_ht_remove)ht_def_remove;
-    hht_def.free = (heap_ht_free)ht_def_free;
-    heap_init(&h, init_count, wt_size, vt_size, &hht_def, cmp_wt, NULL);
-  }else{
-    heap_init(&h, init_count, wt_size, vt_size, hht, cmp_wt, NULL);
+  memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */
+  rdx_init(&h);
+  rdx_push(&h, read_wt(wt_ptr(dist, start, wt_size)), start);
+  prev[start] = start;
+  while (h.num_elts > 0){
+    rdx_pop(&h, &e);
+    u_wt = wt_ptr(dist, e.vt, wt_size);
+    if (e.key != read_wt(u_wt)) continue; /* vertex popped with lower key */
+    p_start = a->vt_wts(a->adj, e.vt, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
+    for (p = p_start; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      v_wt = wt_ptr(dist, v, wt_size);
+      add_wt(sum_wt, u_wt, p + a->wt_offset);
+      sum_key = read_wt(sum_wt);
+      if (prev[v] == C_NREACHED || read_wt(v_wt) > sum_key){
+	memcpy(v_wt, sum_wt, wt_size);
+	rdx_push(&h, sum_key, v);
+	prev[v] = e.vt;
+      }
+    }
   }
-  heap_push(&h, wt_ptr(dist, start, wt_size), &start);
+  rdx_free(&h);
+  free(sum_wt);
+  sum_wt = NULL;
+}
+
+/**
+   Runs Dijkstra's algorithm with a pairing heap on a view of an adjacency
+   list. The heap keeps a copy of the distance of each vertex in the heap,
+   and a vertex is an index in the pool of nodes of the heap.
+*/
+static void dijkstra_pair_view(const adj_view_t *a,
+			       size_t start,
+			       void *dist,
+			       size_t *prev,
+			       void (*add_wt)(void *,
+					      const void *,
+					      const void *),
+			       int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  size_t wt_size = a->wt_size;
+  size_t num_vt_wts;
+  size_t u, v;
+  void *u_wt = NULL, *v_wt = NULL, *sum_wt = NULL;
+  heap_pair_t h;
+  u_wt = malloc_perror(2, wt_size);
+  sum_wt = wt_ptr(u_wt, 1, wt_size);
+  memset(dist, 0, a->num_vts * wt_size);
+  memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */
+  heap_pair_init(&h, wt_size, a->num_vts, cmp_wt);
+  heap_pair_push(&h, wt_ptr(dist, start, wt_size), &start);
   prev[start] = start;
   while (h.num_elts > 0){
-    heap_pop(&h, u_wt, &u);
-    p_start = a->vt_wts[u]->elts;
-    p_end = p_start + a->vt_wts[u]->num_elts * a->pair_size;
+    heap_pair_pop(&h, u_wt, &u);
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      v = *(const size_t *)p;
+      v = a->read_vt(p);
       v_wt = wt_ptr(dist, v, wt_size);
-      add_wt(sum_wt, u_wt, p + a->offset);
+      add_wt(sum_wt, u_wt, p + a->wt_offset);
       if (prev[v] == C_NREACHED){
 	memcpy(v_wt, sum_wt, wt_size);
-	heap_push(&h, v_wt, &v);
+	heap_pair_push(&h, v_wt, &v);
 	prev[v] = u;
       }else if (cmp_wt(v_wt, sum_wt) > 0){
 	/* must be in the heap */
 	memcpy(v_wt, sum_wt, wt_size);
-	heap_update(&h, v_wt, &v);
+	heap_pair_update(&h, v_wt, &v);
 	prev[v] = u;
       }
     }
   }
-  heap_free(&h);
+  heap_pair_free(&h);
   free(u_wt);
-  free(sum_wt);
   u_wt = NULL;
   sum_wt = NULL;
 }
 
 /**
-   Default hash table operations. In the main algorithm routine, the
-   elt_size block pointed to by elt in heap_push is a vertex (index).
-   Therefore, a vertex is a hash key in the hash table of the heap, as per
-   the specification of the hash table parameter of the heap.
+   Radix heap operations. A key is not less than the last popped key when
+   pushed.
 */
 
-static void ht_def_init(ht_def_t *ht,
-			size_t key_size,
-			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context){
-  context_t *c = context;
-  ht->key_size = key_size;
-  ht->elt_size = elt_size;
-  ht->count = c->count;
-  ht->key_present = calloc_perror(c->count, sizeof(boolean_t));
-  ht->elts = malloc_perror(c->count, elt_size);
-  ht->free_elt = free_elt;
+static void rdx_init(rdx_heap_t *h){
+  size_t i;
+  h->last = 0;
+  h->num_elts = 0;
+  h->log_start = 1;
+  while (h->log_start * 2 < RDX_NUM_BKTS - 1) h->log_start *= 2;
+  for (i = 0; i < RDX_NUM_BKTS; i++){
+    stack_init(&h->bkts[i], 1, sizeof(rdx_elt_t), NULL);
+  }
 }
 
-static void ht_def_insert(ht_def_t *ht, const size_t *key, const void *elt){
-  ht->key_present[*key] = TRUE;
-  memcpy(elt_ptr(ht->elts, *key, ht->elt_size),
-	 elt,
-	 ht->elt_size);
+static void rdx_push(rdx_heap_t *h, size_t key, size_t vt){
+  rdx_elt_t e;
+  e.key = key;
+  e.vt = vt;
+  stack_push(&h->bkts[rdx_bkt(h, key)], &e);
+  h->num_elts++;
 }
 
-static void *ht_def_search(const ht_def_t *ht, const size_t *key){
-  if (ht->key_present[*key]){
-    return elt_ptr(ht->elts, *key, ht->elt_size);
-  }else{
-    return NULL;
+/**
+   Pops an entry with the minimum key. If the 0th bucket is empty, the
+   minimum key of the lowest non-empty bucket becomes the last key, and
+   the entries of the bucket are moved to lower buckets.
+*/
+static void rdx_pop(rdx_heap_t *h, rdx_elt_t *e){
+  size_t i, j;
+  const rdx_elt_t *elts = NULL;
+  stack_t *s = NULL;
+  if (h->bkts[0].num_elts == 0){
+    for (i = 1; h->bkts[i].num_elts == 0; i++);
+    s = &h->bkts[i];
+    elts = s->elts;
+    h->last = elts[0].key;
+    for (j = 1; j < s->num_elts; j++){
+      if (elts[j].key < h->last) h->last = elts[j].key;
+    }
+    for (j = 0; j < s->num_elts; j++){
+      stack_push(&h->bkts[rdx_bkt(h, elts[j].key)], &elts[j]);
+    }
+    s->num_elts = 0;
   }
+  stack_pop(&h->bkts[0], e);
+  h->num_elts--;
 }
 
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt){
-  ht->key_present[*key] = FALSE;
-  memcpy(elt,
-	 elt_ptr(ht->elts, *key, ht->elt_size),
-	 ht->elt_size);
+static void rdx_free(rdx_heap_t *h){
+  size_t i;
+  for (i = 0; i < RDX_NUM_BKTS; i++){
+    stack_free(&h->bkts[i]);
+  }
 }
 
-static void ht_def_free(ht_def_t *ht){
-  size_t i;
-  if (ht->free_elt != NULL){
-    for (i = 0; i < ht->count; i++){
-      if (ht->key_present[i]){
-	ht->free_elt(elt_ptr(ht->elts, i, ht->elt_size));
-      }
+/**
+   Returns 0 if key is equal to the last popped key, and otherwise one plus
+   the index of the highest bit where key differs from the last popped key.
+*/
+static size_t rdx_bkt(const rdx_heap_t *h, size_t key){
+  size_t x = key ^ h->last;
+  size_t k = h->log_start;
+  size_t i = 0;
+  if (x == 0) return 0;
+  while (k > 0){
+    if (x >> k){
+      x >>= k;
+      i += k;
     }
+    k >>= 1;
   }
-  free(ht->key_present);
-  free(ht->elts);
-  ht->key_present = NULL;
-  ht->elts = NULL;
+  return i + 1;
 }
 
 /** Functions for computing pointers */
@@ -224,11 +1154,3 @@ static void ht_def_free(ht_def_t *ht){
 static void *wt_ptr(const void *wts, size_t i, size_t wt_size){
   return (void *)((char *)wts + i * wt_size);
 }
- 
-/**
-   Computes a pointer to an entry in the array of elements in a default hash
-   table.
-*/
-static void *elt_ptr(const void *elts, size_t i, size_t elt_size){
-  return (void *)((char *)elts + i * elt_size);
-}
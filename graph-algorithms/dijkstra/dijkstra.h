@@ -13,14 +13,49 @@
    operations, and enables the optimization of space and time resources
    associated with heap operations in Dijkstra's algorithm by choice of a
    hash table and its load factor upper bound. If NULL is passed as a hash
-   table parameter value, a default hash table is used, which contains an
-   index array with a count that is equal to the number of vertices in the
-   graph.   
+   table parameter value, the heap uses an index array with a count that
+   is equal to the number of vertices in the graph instead of a hash table.   
 
-   If E >> V, a default hash table may provide speed advantages by avoiding
+   If E >> V, an index array may provide speed advantages by avoiding
    the computation of hash values. If V is large and the graph is sparse,
    a non-default hash table may provide space advantages.
 
+   If edge weights are non-negative integers, dijkstra_radix and
+   dijkstra_radix_csr use a radix heap that requires no hash table and
+   decreases a key with an insertion in amortized O(1) time.
+
+   dijkstra_pair and dijkstra_pair_csr use a pairing heap from heap-pair.h
+   that requires no hash table and decreases a key by linking a subtree
+   with the root in O(1) time, which may provide speed advantages on dense
+   graphs with generic weights.
+
+   If Dijkstra's algorithm is run repeatedly on a graph, e.g. for
+   point-to-point queries, dijkstra_ws and dijkstra_ws_csr run with a
+   workspace that is allocated once per thread. The heap and its hash
+   table or index array are allocated once, and the dist and prev arrays
+   are reset in O(number of vertices reached in the previous run) time.
+
+   If a single target is queried, dijkstra_ws_target and
+   dijkstra_ws_target_csr stop when the target is settled. dijkstra_bidir
+   and dijkstra_bidir_csr run a forward search from the start vertex and a
+   backward search from the target on a reverse adjacency list, e.g. built
+   with adj_lst_dir_build on a graph with exchanged u and v edge arrays,
+   and stop when the sum of the last settled distances of the two searches
+   is not less than the weight of the shortest path found.
+
+   If edges are inserted into an adjacency list or their weights are
+   decreased after a run, dijkstra_repair_dir and dijkstra_repair_undir
+   update the dist and prev arrays of the run without a run from scratch,
+   by exploring only the vertices with a decreased distance.
+
+   If the vertices and weights are of one of the (unsigned int, unsigned
+   int), (unsigned int, double), and (size_t, unsigned long) type pairs,
+   dijkstra_uint_uint, dijkstra_uint_double, dijkstra_sz_ulong, and their
+   _csr versions read vertices, add and compare weights without calls
+   through function pointers, so that the compiler can inline the edge
+   relaxation, and use a heap with a structure-of-arrays layout and a
+   specialized priority comparison.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99.
 */
@@ -31,6 +66,17 @@
 #include <stddef.h>
 #include "graph.h"
 #include "heap.h"
+#include "heap-pair.h"
+#include "stack.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t wt_size;
+  int is_first; /* non-zero before the first run */
+  void *wt_bufs; /* three weight buffers */
+  heap_t h;
+  stack_t vts; /* size_t vertices reached in the last run */
+} dijkstra_ws_t;
 
 /**
    Computes and copies the shortest distances from start to the array
@@ -44,9 +90,9 @@
                  is equal to the size of a weight in the adjacency list
    prev        : pointer to a preallocated array with a count that is equal
                  to the number of vertices in the adjacency list
-   hht         : - NULL pointer, if a default hash table is used for
-                 in-heap operations; a default hash table contains an index
-                 array with a count that is equal to the number of vertices
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
                  - a pointer to a set of parameters specifying a hash table
                  used for in-heap operations; a vertex is a hash key in 
                  the hash table
@@ -68,4 +114,323 @@ void dijkstra(const adj_lst_t *a,
 	      const heap_ht_t *hht,
 	      void (*add_wt)(void *, const void *, const void *),
 	      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given a compressed sparse row (CSR) adjacency list. Please see the
+   parameter specification in dijkstra.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void dijkstra_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  size_t *prev,
+		  const heap_ht_t *hht,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Initializes a workspace for repeated runs of dijkstra_ws and
+   dijkstra_ws_csr.
+   ws          : pointer to a preallocated block of size
+                 sizeof(dijkstra_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   wt_size     : size of a weight in the graphs in the runs
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to num_vts is used for in-heap operations
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; the hash table is kept
+                 across runs and freed by dijkstra_ws_free
+   cmp_wt      : comparison function as specified in dijkstra, and used by
+                 each run with the workspace
+*/
+void dijkstra_ws_init(dijkstra_ws_t *ws,
+		      size_t num_vts,
+		      size_t wt_size,
+		      const heap_ht_t *hht,
+		      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs dijkstra with a workspace. The dist and prev parameters point to
+   the same arrays in each run with the workspace, and only the entries of
+   the vertices reached in the previous run are reset. Between runs, the
+   caller may read but not modify the arrays. The output is the same as
+   the output of dijkstra with the same parameters. Please see the
+   parameter specification in dijkstra.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+*/
+void dijkstra_ws(const adj_lst_t *a,
+		 size_t start,
+		 void *dist,
+		 size_t *prev,
+		 dijkstra_ws_t *ws,
+		 void (*add_wt)(void *, const void *, const void *),
+		 int (*cmp_wt)(const void *, const void *));
+
+void dijkstra_ws_csr(const adj_csr_t *c,
+		     size_t start,
+		     void *dist,
+		     size_t *prev,
+		     dijkstra_ws_t *ws,
+		     void (*add_wt)(void *, const void *, const void *),
+		     int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs dijkstra with a workspace and stops when the target is settled.
+   The weight of a shortest path from start to target is in the dist array
+   at target, and the path is provided by the prev array from target to
+   start. The prev array has the maximal value of size_t at target if
+   target is not reachable from start. The entries at other vertices are
+   only specified for the vertices on the path. Please see the parameter
+   specification in dijkstra_ws.
+   target      : target vertex
+*/
+void dijkstra_ws_target(const adj_lst_t *a,
+			size_t start,
+			size_t target,
+			void *dist,
+			size_t *prev,
+			dijkstra_ws_t *ws,
+			void (*add_wt)(void *, const void *, const void *),
+			int (*cmp_wt)(const void *, const void *));
+
+void dijkstra_ws_target_csr(const adj_csr_t *c,
+			    size_t start,
+			    size_t target,
+			    void *dist,
+			    size_t *prev,
+			    dijkstra_ws_t *ws,
+			    void (*add_wt)(void *, const void *,
+					   const void *),
+			    int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs a bidirectional Dijkstra's algorithm with two workspaces from start
+   to target. Returns a vertex on a shortest path from start to target, or
+   the maximal value of size_t if target is not reachable from start.
+   Given a returned vertex m, the weight of a shortest path is the sum of
+   the weights in the dist and dist_r arrays at m, the prev array provides
+   the path from m to start, and the next array provides the path from m to
+   target. The entries at other vertices are only specified for the
+   vertices on the path. Please see the parameter specification in
+   dijkstra_ws.
+   a           : pointer to an adjacency list with at least one vertex
+   r           : pointer to the reverse adjacency list of a, where an edge
+                 (v, u) with a weight is in r iff the edge (u, v) with the
+                 weight is in a
+   start       : start vertex
+   target      : target vertex
+   dist        : forward distances, as the dist array in dijkstra_ws
+   prev        : forward previous vertices, as the prev array in
+                 dijkstra_ws
+   dist_r      : backward distances, as the dist array in dijkstra_ws
+   next        : backward previous vertices, i.e. next vertices on the
+                 paths to target, as the prev array in dijkstra_ws
+   ws          : pointer to a workspace of the forward search
+   ws_r        : pointer to a workspace of the backward search, distinct
+                 from ws
+*/
+size_t dijkstra_bidir(const adj_lst_t *a,
+		      const adj_lst_t *r,
+		      size_t start,
+		      size_t target,
+		      void *dist,
+		      size_t *prev,
+		      void *dist_r,
+		      size_t *next,
+		      dijkstra_ws_t *ws,
+		      dijkstra_ws_t *ws_r,
+		      void (*add_wt)(void *, const void *, const void *),
+		      int (*cmp_wt)(const void *, const void *));
+
+size_t dijkstra_bidir_csr(const adj_csr_t *c,
+			  const adj_csr_t *r,
+			  size_t start,
+			  size_t target,
+			  void *dist,
+			  size_t *prev,
+			  void *dist_r,
+			  size_t *next,
+			  dijkstra_ws_t *ws,
+			  dijkstra_ws_t *ws_r,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Repairs the output of a run from a start vertex after a batch of edge
+   insertions or weight decreases, by updating the distances and previous
+   vertices only in the region of the vertices with a decreased distance.
+   Returns the number of decreases of a distance in the repair, which is 0
+   if the batch does not change a shortest path distance. The output is the
+   same as the output of a run after the batch, except that a previous
+   vertex may be another vertex on a shortest path of the same weight.
+   a           : pointer to an adjacency list to which the edges of the
+                 batch were added, e.g. with adj_lst_add_dir_edge, or where
+                 the weights of the edges of the batch were decreased
+   g           : pointer to a graph with the edges of the batch and their
+                 new weights, where the weights do not exceed the weights
+                 of the edges before the batch; dijkstra_repair_dir
+                 considers an edge (u, v) directed, and
+                 dijkstra_repair_undir considers it as the edges (u, v)
+                 and (v, u), as adj_lst_add_undir_edge
+   dist        : pointer to the dist array of a run of dijkstra,
+                 dijkstra_ws, or dijkstra_repair_{dir, undir}, which
+                 explored all vertices reachable from start
+   prev        : pointer to the prev array of the run
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list; if the
+                 workspace is used by dijkstra_ws with the dist and prev
+                 arrays, the vertices reached for the first time in the
+                 repair are reset in the next run of dijkstra_ws
+   add_wt      : addition function as specified in dijkstra
+   cmp_wt      : comparison function as specified in dijkstra
+*/
+size_t dijkstra_repair_dir(const adj_lst_t *a,
+			   const graph_t *g,
+			   void *dist,
+			   size_t *prev,
+			   dijkstra_ws_t *ws,
+			   void (*add_wt)(void *, const void *, const void *),
+			   int (*cmp_wt)(const void *, const void *));
+
+size_t dijkstra_repair_undir(const adj_lst_t *a,
+			     const graph_t *g,
+			     void *dist,
+			     size_t *prev,
+			     dijkstra_ws_t *ws,
+			     void (*add_wt)(void *, const void *,
+					    const void *),
+			     int (*cmp_wt)(const void *, const void *));
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given an adjacency list or a CSR adjacency list with vertices and
+   weights of the types in the function name: uint for unsigned int, sz for
+   size_t, ulong for unsigned long, and double. The vt_size and wt_size of
+   the adjacency list are the sizes of the types. The weights are added
+   and compared with the + and > operators, and the output is the same as
+   the output of dijkstra and dijkstra_csr with the corresponding add_wt
+   and cmp_wt. Please see the parameter specification in dijkstra.
+*/
+void dijkstra_uint_uint(const adj_lst_t *a,
+			size_t start,
+			unsigned int *dist,
+			size_t *prev,
+			const heap_ht_t *hht);
+
+void dijkstra_uint_uint_csr(const adj_csr_t *c,
+			    size_t start,
+			    unsigned int *dist,
+			    size_t *prev,
+			    const heap_ht_t *hht);
+
+void dijkstra_uint_double(const adj_lst_t *a,
+			  size_t start,
+			  double *dist,
+			  size_t *prev,
+			  const heap_ht_t *hht);
+
+void dijkstra_uint_double_csr(const adj_csr_t *c,
+			      size_t start,
+			      double *dist,
+			      size_t *prev,
+			      const heap_ht_t *hht);
+
+void dijkstra_sz_ulong(const adj_lst_t *a,
+		       size_t start,
+		       unsigned long int *dist,
+		       size_t *prev,
+		       const heap_ht_t *hht);
+
+void dijkstra_sz_ulong_csr(const adj_csr_t *c,
+			   size_t start,
+			   unsigned long int *dist,
+			   size_t *prev,
+			   const heap_ht_t *hht);
+
+/**
+   Resets the dist and prev arrays of a run with a workspace, and empties
+   the heap and the set of reached vertices of the workspace. The dist and
+   prev arrays are fully reset in the first run, and otherwise only at the
+   vertices reached in the previous run. Used by the runs of dijkstra_ws
+   and by other algorithms that run with a workspace, e.g. A*, before the
+   start vertex is pushed into the heap.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+   dist        : pointer to the dist array of the runs with the workspace
+   prev        : pointer to the prev array of the runs with the workspace
+*/
+void dijkstra_ws_reset(dijkstra_ws_t *ws, void *dist, size_t *prev);
+
+/**
+   Frees a workspace and leaves a block of size sizeof(dijkstra_ws_t)
+   pointed to by the ws parameter.
+*/
+void dijkstra_ws_free(dijkstra_ws_t *ws);
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, given an adjacency list with non-negative integer weights. A radix
+   heap is used instead of a heap with a hash table parameter. The
+   distances are required to be representable in the weight type and in
+   size_t. The prev array has the maximal value of size_t for unreached
+   vertices.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+   start       : start vertex for running the algorithm
+   dist        : pointer to a preallocated array where the count is equal
+                 to the number of vertices, and the size of an array entry
+                 is equal to the size of a weight in the adjacency list
+   prev        : pointer to a preallocated array with a count that is equal
+                 to the number of vertices in the adjacency list
+   add_wt      : addition function which copies the sum of the weight values
+                 pointed to by the second and third arguments to the
+                 preallocated weight block pointed to by the first argument
+   read_wt     : returns the value of the integer weight pointed to by the
+                 argument as size_t (e.g. graph_read_uint)
+*/
+void dijkstra_radix(const adj_lst_t *a,
+		    size_t start,
+		    void *dist,
+		    size_t *prev,
+		    void (*add_wt)(void *, const void *, const void *),
+		    size_t (*read_wt)(const void *));
+
+void dijkstra_radix_csr(const adj_csr_t *c,
+			size_t start,
+			void *dist,
+			size_t *prev,
+			void (*add_wt)(void *, const void *, const void *),
+			size_t (*read_wt)(const void *));
+
+/**
+   Computes and copies the shortest distances from start to the array
+   pointed to by dist, and the previous vertices to the array pointed to by
+   prev, with a pairing heap instead of a heap with a hash table parameter.
+   A decrease of a distance in the heap links a subtree with the root in
+   O(1) time, which may provide speed advantages on dense graphs where the
+   number of decreases exceeds the number of pops. The output is the same
+   as the output of dijkstra and dijkstra_csr. The prev array has the
+   maximal value of size_t for unreached vertices. Please see the
+   parameter specification in dijkstra.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void dijkstra_pair(const adj_lst_t *a,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   void (*add_wt)(void *, const void *, const void *),
+		   int (*cmp_wt)(const void *, const void *));
+
+void dijkstra_pair_csr(const adj_csr_t *c,
+		       size_t start,
+		       void *dist,
+		       size_t *prev,
+		       void (*add_wt)(void *, const void *, const void *),
+		       int (*cmp_wt)(const void *, const void *));
 #endif
@@ -2,8 +2,8 @@
    prim-test.c
 
    Tests of Prim's algorithm with a hash table parameter across
-   i) default, division-based and multiplication-based hash tables, and ii)
-   edge weight types.
+   i) default, division-based and multiplication-based hash tables, ii)
+   edge weight types, and with a pairing heap.
 
    The following command line arguments can be used to customize tests:
    prim-test:
@@ -11,11 +11,13 @@
    -  [0, # bits in size_t / 2] : n for 2^n vertices in the largest graph
    -  [0, 1] : small graph test on/off
    -  [0, 1] : test on random graphs with random size_t weights on/off
+   -  [0, 1] : specialized prim test on random graphs on/off
 
    usage examples: 
    ./prim-test
    ./prim-test 10 14
    ./prim-test 14 14 0 1
+   ./prim-test 10 12 0 0 1
 
    prim-test can be run with any subset of command line arguments in the
    above-defined order. If the (i + 1)th argument is specified then the ith
@@ -60,9 +62,10 @@ const char *C_USAGE =
   "[0, # bits in size_t / 2] : n for 2^n vertices in smallest graph \n"
   "[0, # bits in size_t / 2] : n for 2^n vertices in largest graph \n"
   "[0, 1] : small graph test on/off \n"
-  "[0, 1] : random graphs with random size_t weights test on/off \n";
-const int C_ARGC_MAX = 5;
-const size_t C_ARGS_DEF[4] = {0, 10, 1, 1};
+  "[0, 1] : random graphs with random size_t weights test on/off \n"
+  "[0, 1] : specialized prim on random graphs test on/off \n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {0, 10, 1, 1, 1};
 
 /* hash table load factor upper bounds */
 const size_t C_ALPHA_N_DIVCHN = 1;
@@ -91,6 +94,7 @@ const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
 
 void print_uint(const void *a);
 void print_double(const void *a);
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *));
 void print_uint_arr(const size_t *arr, size_t n);
 void print_double_arr(const double *arr, size_t n);
@@ -102,20 +106,30 @@ void print_test_result(int res);
 
 void graph_uint_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(size_t));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((size_t *)g->wts + i) = C_WTS_UINT[i];
   }
 }
 
 void graph_uint_wts_no_edges_init(graph_t *g){
-  graph_base_init(g, C_NUM_VTS, sizeof(size_t));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -132,45 +146,32 @@ int cmp_uint(const void *a, const void *b){
   }
 }
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} context_divchn_t;
+/**
+   Set the parameters of hash tables used for in-heap operations.
+*/
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} context_muloa_t;
-
-void ht_divchn_init_helper(ht_divchn_t *ht,
-			   size_t key_size,
-			   size_t elt_size,
-			   void (*free_elt)(void *),
-			   void *context){
-  context_divchn_t *c = context;
-  ht_divchn_init(ht,
-		 key_size,
-		 elt_size,
-		 0,
-		 c->alpha_n,
-		 c->log_alpha_d,
-		 free_elt);
-}
-
-void ht_muloa_init_helper(ht_muloa_t *ht,
-			  size_t key_size,
-			  size_t elt_size,
-			  void (*free_elt)(void *),
-			  void *context){
-  context_muloa_t * c = context;
-  ht_muloa_init(ht,
-		key_size,
-		elt_size,
-		0,
-		c->alpha_n,
-		c->log_alpha_d,
-		NULL,
-		free_elt);
+void hht_divchn_init(heap_ht_t *hht, ht_divchn_t *ht_divchn){
+  hht->ht = ht_divchn;
+  hht->alpha_n = C_ALPHA_N_DIVCHN;
+  hht->log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  hht->init = ht_divchn_init_helper;
+  hht->align = ht_divchn_align_helper;
+  hht->insert = ht_divchn_insert_helper;
+  hht->search = ht_divchn_search_helper;
+  hht->remove = ht_divchn_remove_helper;
+  hht->free = ht_divchn_free_helper;
+}
+
+void hht_muloa_init(heap_ht_t *hht, ht_muloa_t *ht_muloa){
+  hht->ht = ht_muloa;
+  hht->alpha_n = C_ALPHA_N_MULOA;
+  hht->log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  hht->init = ht_muloa_init_helper;
+  hht->align = ht_muloa_align_helper;
+  hht->insert = ht_muloa_insert_helper;
+  hht->search = ht_muloa_search_helper;
+  hht->remove = ht_muloa_remove_helper;
+  hht->free = ht_muloa_free_helper;
 }
 
 void run_def_uint_prim(const adj_lst_t *a){
@@ -197,19 +198,10 @@ void run_divchn_uint_prim(const adj_lst_t *a){
   size_t *dist = NULL;
   size_t *prev = NULL;
   ht_divchn_t ht_divchn;
-  context_divchn_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(size_t));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_DIVCHN;
-  context.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht_divchn_init(&hht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     prim(a, i, dist, prev, &hht, cmp_uint);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -228,19 +220,10 @@ void run_muloa_uint_prim(const adj_lst_t *a){
   size_t *dist = NULL;
   size_t *prev = NULL;
   ht_muloa_t ht_muloa;
-  context_muloa_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(size_t));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_MULOA;
-  context.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht_muloa_init(&hht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     prim(a, i, dist, prev, &hht, cmp_uint);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -262,7 +245,7 @@ void run_uint_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_def_uint_prim(&a);
@@ -276,7 +259,7 @@ void run_uint_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_def_uint_prim(&a);
@@ -292,20 +275,30 @@ void run_uint_graph_test(){
 
 void graph_double_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(double));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((double *)g->wts + i) = C_WTS_DOUBLE[i];
   }
 }
 
 void graph_double_wts_no_edges_init(graph_t *g){
-  graph_base_init(g, C_NUM_VTS, sizeof(double));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -346,19 +339,10 @@ void run_divchn_double_prim(const adj_lst_t *a){
   size_t *prev = NULL;
   double *dist = NULL;
   ht_divchn_t ht_divchn;
-  context_divchn_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(double));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_DIVCHN;
-  context.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht.ht = &ht_divchn;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_divchn_init_helper;
-  hht.insert = (heap_ht_insert)ht_divchn_insert;
-  hht.search = (heap_ht_search)ht_divchn_search;
-  hht.remove = (heap_ht_remove)ht_divchn_remove;
-  hht.free = (heap_ht_free)ht_divchn_free;
+  hht_divchn_init(&hht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     prim(a, i, dist, prev, &hht, cmp_double);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -377,19 +361,10 @@ void run_muloa_double_prim(const adj_lst_t *a){
   size_t *prev = NULL;
   double *dist = NULL;
   ht_muloa_t ht_muloa;
-  context_muloa_t context;
   heap_ht_t hht;
   dist = malloc_perror(a->num_vts, sizeof(double));
   prev = malloc_perror(a->num_vts, sizeof(size_t));
-  context.alpha_n = C_ALPHA_N_MULOA;
-  context.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht.ht = &ht_muloa;
-  hht.context = &context;
-  hht.init = (heap_ht_init)ht_muloa_init_helper;
-  hht.insert = (heap_ht_insert)ht_muloa_insert;
-  hht.search = (heap_ht_search)ht_muloa_search;
-  hht.remove = (heap_ht_remove)ht_muloa_remove;
-  hht.free = (heap_ht_free)ht_muloa_free;
+  hht_muloa_init(&hht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     prim(a, i, dist, prev, &hht, cmp_double);
     printf("distances and previous vertices with %lu as start \n", TOLU(i));
@@ -411,7 +386,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_def_double_prim(&a);
@@ -425,7 +400,7 @@ void run_double_graph_test(){
 	 "i) default hash table (index array) \n"
 	 "ii) ht_divchn_t hash table \n"
 	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+  adj_lst_base_init(&a, &g);
   adj_lst_undir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_def_double_prim(&a);
@@ -490,8 +465,9 @@ void adj_lst_rand_undir_wts(adj_lst_t *a,
 						   void *)){
   size_t i, j;
   graph_t g;
-  graph_base_init(&g, n, wt_size);
-  adj_lst_init(a, &g);
+  graph_base_init(&g, n, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
   for (i = 0; i < n - 1; i++){
     for (j = i + 1; j < n; j++){
       add_undir_edge(a, i, j, wt_l, wt_h, bern, arg);
@@ -502,7 +478,8 @@ void adj_lst_rand_undir_wts(adj_lst_t *a,
 
 /**
    Run a test on random undirected graphs with random size_t weights,
-   across default, division-based and multiplication-based hash tables.
+   across default, division-based and multiplication-based hash tables,
+   and a CSR adjacency list with a default hash table.
 */
 
 void sum_mst_edges(size_t *wt_mst,
@@ -524,41 +501,27 @@ void sum_mst_edges(size_t *wt_mst,
 void run_rand_uint_test(int pow_start, int pow_end){
   int p, i, j;
   int res = 1;
-  size_t wt_def, wt_divchn, wt_muloa;
-  size_t num_vts_def, num_vts_divchn, num_vts_muloa;
+  size_t wt_def, wt_divchn, wt_muloa, wt_csr, wt_ws, wt_pair, wt_pair_csr;
+  size_t num_vts_def, num_vts_divchn, num_vts_muloa, num_vts_csr, num_vts_ws;
+  size_t num_vts_pair, num_vts_pair_csr;
   size_t n;
   size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
   size_t *rand_start = NULL;
   size_t *dist = NULL, *prev = NULL;
+  graph_t g;
   adj_lst_t a;
+  adj_csr_t c;
   bern_arg_t b;
   ht_divchn_t ht_divchn;
   ht_muloa_t ht_muloa;
-  context_divchn_t context_divchn;
-  context_muloa_t context_muloa;
   heap_ht_t hht_divchn, hht_muloa;
-  clock_t t_def, t_divchn, t_muloa;
+  prim_ws_t ws;
+  clock_t t_def, t_divchn, t_muloa, t_csr, t_ws, t_pair, t_pair_csr;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
   dist = malloc_perror(pow_two(pow_end), sizeof(size_t));
   prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  hht_divchn.ht = &ht_divchn;
-  hht_divchn.context = &context_divchn;
-  hht_divchn.init = (heap_ht_init)ht_divchn_init_helper;
-  hht_divchn.insert = (heap_ht_insert)ht_divchn_insert;
-  hht_divchn.search = (heap_ht_search)ht_divchn_search;
-  hht_divchn.remove = (heap_ht_remove)ht_divchn_remove;
-  hht_divchn.free = (heap_ht_free)ht_divchn_free;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  hht_muloa.ht = &ht_muloa;
-  hht_muloa.context = &context_muloa;
-  hht_muloa.init = (heap_ht_init)ht_muloa_init_helper;
-  hht_muloa.insert = (heap_ht_insert)ht_muloa_insert;
-  hht_muloa.search = (heap_ht_search)ht_muloa_search;
-  hht_muloa.remove = (heap_ht_remove)ht_muloa_remove;
-  hht_muloa.free = (heap_ht_free)ht_muloa_free;
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  hht_muloa_init(&hht_muloa, &ht_muloa);
   printf("Run a prim test on random undirected graphs with random "
 	 "size_t weights in [%lu, %lu]\n", TOLU(wt_l), TOLU(wt_h));
   fflush(stdout);
@@ -575,6 +538,10 @@ void run_rand_uint_test(int pow_start, int pow_end){
 			     bern,
 			     &b,
 			     add_undir_uint_edge);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
       for (j = 0; j < C_ITER; j++){
 	rand_start[j] = RANDOM() % n;
       }
@@ -596,18 +563,60 @@ void run_rand_uint_test(int pow_start, int pow_end){
       }
       t_muloa = clock() - t_muloa;
       sum_mst_edges(&wt_muloa, &num_vts_muloa, a.num_vts, dist, prev);
+      t_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	prim_csr(&c, rand_start[j], dist, prev, NULL, cmp_uint);
+      }
+      t_csr = clock() - t_csr;
+      sum_mst_edges(&wt_csr, &num_vts_csr, a.num_vts, dist, prev);
+      t_ws = clock();
+      prim_ws_init(&ws, a.num_vts, a.wt_size, NULL, cmp_uint);
+      for (j = 0; j < C_ITER; j++){
+	prim_ws(&a, rand_start[j], dist, prev, &ws, cmp_uint);
+      }
+      prim_ws_free(&ws);
+      t_ws = clock() - t_ws;
+      sum_mst_edges(&wt_ws, &num_vts_ws, a.num_vts, dist, prev);
+      t_pair = clock();
+      for (j = 0; j < C_ITER; j++){
+	prim_pair(&a, rand_start[j], dist, prev, cmp_uint);
+      }
+      t_pair = clock() - t_pair;
+      sum_mst_edges(&wt_pair, &num_vts_pair, a.num_vts, dist, prev);
+      t_pair_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	prim_pair_csr(&c, rand_start[j], dist, prev, cmp_uint);
+      }
+      t_pair_csr = clock() - t_pair_csr;
+      sum_mst_edges(&wt_pair_csr, &num_vts_pair_csr, a.num_vts, dist, prev);
       res *= (wt_def == wt_divchn &&
-	      wt_divchn == wt_muloa);
+	      wt_divchn == wt_muloa &&
+	      wt_muloa == wt_csr &&
+	      wt_csr == wt_ws &&
+	      wt_ws == wt_pair &&
+	      wt_pair == wt_pair_csr);
       res *= (num_vts_def == num_vts_divchn &&
-	      num_vts_divchn == num_vts_muloa);
+	      num_vts_divchn == num_vts_muloa &&
+	      num_vts_muloa == num_vts_csr &&
+	      num_vts_csr == num_vts_ws &&
+	      num_vts_ws == num_vts_pair &&
+	      num_vts_pair == num_vts_pair_csr);
       printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	     TOLU(a.num_vts), TOLU(a.num_es));
       printf("\t\t\tprim default ht ave runtime:         %.8f seconds\n"
 	     "\t\t\tprim ht_divchn ave runtime:          %.8f seconds\n"
-	     "\t\t\tprim ht_muloa ave runtime:           %.8f seconds\n",
+	     "\t\t\tprim ht_muloa ave runtime:           %.8f seconds\n"
+	     "\t\t\tprim_csr default ht ave runtime:     %.8f seconds\n"
+	     "\t\t\tprim_ws default ht ave runtime:      %.8f seconds\n"
+	     "\t\t\tprim_pair ave runtime:               %.8f seconds\n"
+	     "\t\t\tprim_pair_csr ave runtime:           %.8f seconds\n",
 	     (float)t_def / C_ITER / CLOCKS_PER_SEC,
 	     (float)t_divchn / C_ITER / CLOCKS_PER_SEC,
-	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC);
+	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_ws / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_pair / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_pair_csr / C_ITER / CLOCKS_PER_SEC);
       printf("\t\t\tcorrectness:                         ");
       print_test_result(res);
       printf("\t\t\tlast mst # edges:                    %lu\n",
@@ -620,6 +629,7 @@ void run_rand_uint_test(int pow_start, int pow_end){
       }
       res = 1;
       adj_lst_free(&a);
+      adj_csr_free(&c);
     }
   }
   free(rand_start);
@@ -630,6 +640,309 @@ void run_rand_uint_test(int pow_start, int pow_end){
   prev = NULL;
 }
 
+/**
+   Runs a test of the specialized prim_uint_uint, prim_uint_double,
+   prim_sz_ulong, and their _csr versions on random undirected graphs, by
+   comparing the mst edge weights and the reached vertices to the output
+   of prim with the corresponding cmp_wt.
+*/
+
+int cmp_ui(const void *a, const void *b){
+  if (*(unsigned int *)a > *(unsigned int *)b){
+    return 1;
+  }else if (*(unsigned int *)a < *(unsigned int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+int cmp_ul(const void *a, const void *b){
+  if (*(unsigned long int *)a > *(unsigned long int *)b){
+    return 1;
+  }else if (*(unsigned long int *)a < *(unsigned long int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+/* new weights in [0, high] */
+
+void new_ui(void *a, size_t high){
+  *(unsigned int *)a = RANDOM() % (high + 1);
+}
+
+void new_double(void *a, size_t high){
+  *(double *)a = DRAND() * high;
+}
+
+void new_ul(void *a, size_t high){
+  *(unsigned long int *)a = RANDOM() % (high + 1);
+}
+
+/* runs a specialized prim on a if a is not NULL, and on c otherwise */
+
+void spec_uint_uint(const adj_lst_t *a,
+		    const adj_csr_t *c,
+		    size_t start,
+		    void *dist,
+		    size_t *prev,
+		    const heap_ht_t *hht){
+  if (a != NULL){
+    prim_uint_uint(a, start, dist, prev, hht);
+  }else{
+    prim_uint_uint_csr(c, start, dist, prev, hht);
+  }
+}
+
+void spec_uint_double(const adj_lst_t *a,
+		      const adj_csr_t *c,
+		      size_t start,
+		      void *dist,
+		      size_t *prev,
+		      const heap_ht_t *hht){
+  if (a != NULL){
+    prim_uint_double(a, start, dist, prev, hht);
+  }else{
+    prim_uint_double_csr(c, start, dist, prev, hht);
+  }
+}
+
+void spec_sz_ulong(const adj_lst_t *a,
+		   const adj_csr_t *c,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   const heap_ht_t *hht){
+  if (a != NULL){
+    prim_sz_ulong(a, start, dist, prev, hht);
+  }else{
+    prim_sz_ulong_csr(c, start, dist, prev, hht);
+  }
+}
+
+typedef struct{
+  const char *name;
+  size_t vt_size;
+  size_t wt_size;
+  size_t (*read_vt)(const void *);
+  void (*write_vt)(void *, size_t);
+  size_t wt_max; /* weights in [0, wt_max / num_vts] */
+  void (*new_wt)(void *, size_t);
+  int (*cmp_wt)(const void *, const void *);
+  void (*spec)(const adj_lst_t *,
+	       const adj_csr_t *,
+	       size_t,
+	       void *,
+	       size_t *,
+	       const heap_ht_t *);
+} spec_type_t;
+
+const int C_SPEC_TYPES_COUNT = 3;
+const spec_type_t C_SPEC_TYPES[3] = {
+  {"unsigned int vertices, unsigned int weights",
+   sizeof(unsigned int), sizeof(unsigned int),
+   graph_read_uint, graph_write_uint,
+   UINT_MAX, new_ui, cmp_ui, spec_uint_uint},
+  {"unsigned int vertices, double weights",
+   sizeof(unsigned int), sizeof(double),
+   graph_read_uint, graph_write_uint,
+   RAND_MAX, new_double, cmp_double, spec_uint_double},
+  {"size_t vertices, unsigned long weights",
+   sizeof(size_t), sizeof(unsigned long int),
+   graph_read_sz, graph_write_sz,
+   ULONG_MAX, new_ul, cmp_ul, spec_sz_ulong}};
+
+/**
+   Initializes a random undirected graph with the vertex and weight types
+   of t, where each of n(n - 1)/2 possible edges is added according to
+   bern.
+*/
+void rand_undir_graph_init(graph_t *g,
+			 size_t n,
+			 const spec_type_t *t,
+			 int (*bern)(void *),
+			 void *arg){
+  size_t i, j;
+  size_t num_es = 0;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  graph_base_init(g, n, t->vt_size, t->wt_size, t->read_vt, t->write_vt);
+  if (n < 2) return;
+  up = g->u = malloc_perror(n * (n - 1) / 2, g->vt_size);
+  vp = g->v = malloc_perror(n * (n - 1) / 2, g->vt_size);
+  wp = g->wts = malloc_perror(n * (n - 1) / 2, g->wt_size);
+  for (i = 0; i < n - 1; i++){
+    for (j = i + 1; j < n; j++){
+      if (!bern(arg)) continue;
+      g->write_vt(up, i);
+      g->write_vt(vp, j);
+      t->new_wt(wp, t->wt_max / n);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      num_es++;
+    }
+  }
+  g->num_es = num_es;
+}
+
+/**
+   Returns 1 if the same vertices are reached according to two prev
+   arrays, and the weights of the reached vertices are equal.
+*/
+int same_reached_wts(const void *dist_a,
+			  const size_t *prev_a,
+			  const void *dist_b,
+			  const size_t *prev_b,
+			  size_t n,
+			  size_t wt_size){
+  size_t i;
+  for (i = 0; i < n; i++){
+    if ((prev_a[i] == C_SIZE_MAX) != (prev_b[i] == C_SIZE_MAX)) return 0;
+    if (prev_a[i] != C_SIZE_MAX &&
+	memcmp((const char *)dist_a + i * wt_size,
+	       (const char *)dist_b + i * wt_size,
+	       wt_size) != 0) return 0;
+  }
+  return 1;
+}
+
+void run_rand_spec_test(int pow_start, int pow_end){
+  int k, p, i, j;
+  int res = 1;
+  size_t n;
+  size_t *rand_start = NULL;
+  size_t *prev_gen = NULL, *prev = NULL;
+  void *dist_gen = NULL, *dist = NULL;
+  const spec_type_t *t = NULL;
+  graph_t g;
+  adj_lst_t a;
+  adj_csr_t c;
+  bern_arg_t b;
+  ht_divchn_t ht_divchn;
+  heap_ht_t hht_divchn;
+  clock_t t_gen, t_spec, t_spec_csr, t_spec_divchn;
+  rand_start = malloc_perror(C_ITER, sizeof(size_t));
+  prev_gen = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  prev = malloc_perror(pow_two(pow_end), sizeof(size_t));
+  hht_divchn_init(&hht_divchn, &ht_divchn);
+  for (k = 0; k < C_SPEC_TYPES_COUNT; k++){
+    t = &C_SPEC_TYPES[k];
+    dist_gen = malloc_perror(pow_two(pow_end), t->wt_size);
+    dist = malloc_perror(pow_two(pow_end), t->wt_size);
+    printf("Run a specialized prim test on random undirected graphs "
+	   "with %s\n", t->name);
+    fflush(stdout);
+    for (p = 0; p < C_PROBS_COUNT; p++){
+      b.p = C_PROBS[p];
+      printf("\tP[an edge is in a graph] = %.4f\n", C_PROBS[p]);
+      for (i = pow_start; i <= pow_end; i++){
+	n = pow_two(i); /* 0 < n */
+	rand_undir_graph_init(&g, n, t, bern, &b);
+	adj_lst_base_init(&a, &g);
+	adj_lst_undir_build(&a, &g);
+	adj_csr_base_init(&c, &g);
+	adj_csr_undir_build(&c, &g);
+	graph_free(&g);
+	for (j = 0; j < C_ITER; j++){
+	  rand_start[j] = RANDOM() % n;
+	}
+	t_gen = 0;
+	t_spec = 0;
+	t_spec_csr = 0;
+	t_spec_divchn = 0;
+	for (j = 0; j < C_ITER; j++){
+	  t_gen -= clock();
+	  prim(&a, rand_start[j], dist_gen, prev_gen, NULL, t->cmp_wt);
+	  t_gen += clock();
+	  t_spec -= clock();
+	  t->spec(&a, NULL, rand_start[j], dist, prev, NULL);
+	  t_spec += clock();
+	  res *= same_reached_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	  t_spec_csr -= clock();
+	  t->spec(NULL, &c, rand_start[j], dist, prev, NULL);
+	  t_spec_csr += clock();
+	  res *= same_reached_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	  t_spec_divchn -= clock();
+	  t->spec(&a, NULL, rand_start[j], dist, prev, &hht_divchn);
+	  t_spec_divchn += clock();
+	  res *= same_reached_wts(dist_gen, prev_gen, dist, prev,
+				       n, t->wt_size);
+	}
+	printf("\t\tvertices: %lu, # of directed edges: %lu\n",
+	       TOLU(a.num_vts), TOLU(a.num_es));
+	printf("\t\t\tprim default ht ave runtime:         %.8f seconds\n"
+	       "\t\t\tspecialized default ht ave runtime:  %.8f seconds\n"
+	       "\t\t\tspecialized csr ave runtime:         %.8f seconds\n"
+	       "\t\t\tspecialized ht_divchn ave runtime:   %.8f seconds\n",
+	       (float)t_gen / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec_csr / C_ITER / CLOCKS_PER_SEC,
+	       (float)t_spec_divchn / C_ITER / CLOCKS_PER_SEC);
+	printf("\t\t\tcorrectness:                         ");
+	print_test_result(res);
+	res = 1;
+	adj_lst_free(&a);
+	adj_csr_free(&c);
+      }
+    }
+    free(dist_gen);
+    free(dist);
+    dist_gen = NULL;
+    dist = NULL;
+  }
+  free(rand_start);
+  free(prev_gen);
+  free(prev);
+  rand_start = NULL;
+  prev_gen = NULL;
+  prev = NULL;
+}
+
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
 /**
    Printing functions.
 */
@@ -645,13 +958,14 @@ void print_double(const void *a){
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t i;
+  size_t num_vt_wts;
   printf("\tvertices: \n");
   for (i = 0; i < a->num_vts; i++){
     printf("\t%lu : ", TOLU(i));
-    p_start = a->vt_wts[i]->elts;
-    p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+    p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      printf("%lu ", TOLU(*(const size_t *)p));
+      printf("%lu ", TOLU(a->read_vt(p)));
     }
     printf("\n");
   }
@@ -659,10 +973,10 @@ void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
     printf("\tweights: \n");
     for (i = 0; i < a->num_vts; i++){
       printf("\t%lu : ", TOLU(i));
-      p_start = a->vt_wts[i]->elts;
-      p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+      p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+      p_end = p_start + num_vt_wts * a->pair_size;
       for (p = p_start; p != p_end; p += a->pair_size){
-	print_wt(p + a->offset);
+	print_wt(p + a->wt_offset);
       }
       printf("\n");
     }
@@ -714,7 +1028,8 @@ int main(int argc, char *argv[]){
       args[1] > C_FULL_BIT / 2 ||
       args[1] < args[0] ||
       args[2] > 1 ||
-      args[3] > 1){
+      args[3] > 1 ||
+      args[4] > 1){
     printf("USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -723,6 +1038,7 @@ int main(int argc, char *argv[]){
     run_double_graph_test();
   }
   if (args[3]) run_rand_uint_test(args[0], args[1]);
+  if (args[4]) run_rand_spec_test(args[0], args[1]);
   free(args);
   args = NULL;
   return 0;
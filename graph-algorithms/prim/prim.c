@@ -15,14 +15,32 @@
    operations, and enables the optimization of space and time resources
    associated with heap operations in Prim's algorithm by choice of a
    hash table and its load factor upper bound. If NULL is passed as a hash
-   table parameter value, a default hash table is used, which contains an
-   index array with a count that is equal to the number of vertices in the
-   graph.   
+   table parameter value, the heap uses an index array with a count that
+   is equal to the number of vertices in the graph instead of a hash table.   
 
-   If E >> V, a default hash table may provide speed advantages by avoiding
+   If E >> V, an index array may provide speed advantages by avoiding
    the computation of hash values. If V is large and the graph is sparse,
    a non-default hash table may provide space advantages.
 
+   If Prim's algorithm is run repeatedly on a graph, prim_ws and
+   prim_ws_csr run with a workspace that is allocated once per thread.
+   The heap and its hash table or index array are allocated once, and the
+   dist and prev arrays are reset in O(number of vertices reached in the
+   previous run) time by keeping the reached vertices in a stack.
+
+   If the vertices and weights are of one of the (unsigned int, unsigned
+   int), (unsigned int, double), and (size_t, unsigned long) type pairs,
+   prim_uint_uint, prim_uint_double, prim_sz_ulong, and their _csr versions
+   read vertices and compare weights without calls through function
+   pointers, so that the compiler can inline the edge scan, and use a heap
+   with a structure-of-arrays layout and a specialized priority
+   comparison.
+
+   If the number of decreases of weights in the heap exceeds the number of
+   pops, e.g. on dense graphs, prim_pair and prim_pair_csr use a pairing
+   heap from heap-pair.h that requires no hash table and decreases a
+   weight by linking a subtree with the root in O(1) time.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99.
 */
@@ -33,40 +51,107 @@
 #include "prim.h"
 #include "graph.h"
 #include "heap.h"
+#include "heap-pair.h"
 #include "stack.h"
 #include "utilities-mem.h"
 
-typedef enum{FALSE, TRUE} boolean_t;
-
-typedef struct{
-  size_t count;
-} context_t;
+static const size_t C_NREACHED = (size_t)-1; /* not reached as index */
 
-typedef struct{
-  size_t key_size;
-  size_t elt_size;
-  size_t count;
-  boolean_t *key_present;
-  void *elts;
-  void (*free_elt)(void *);
-} ht_def_t;
+static void prim_view(const adj_view_t *a,
+		      size_t start,
+		      void *dist,
+		      size_t *prev,
+		      const heap_ht_t *hht,
+		      int (*cmp_wt)(const void *, const void *));
 
-static const size_t C_NREACHED = (size_t)-1; /* not reached as index */
+static void prim_ws_view(const adj_view_t *a,
+			 size_t start,
+			 void *dist,
+			 size_t *prev,
+			 prim_ws_t *ws,
+			 int (*cmp_wt)(const void *, const void *));
 
-/* default hash table operations */
-static void ht_def_init(ht_def_t *ht,
-			size_t key_size,
-			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context);
-static void ht_def_insert(ht_def_t *ht, const size_t *key,const void *elt);
-static void *ht_def_search(const ht_def_t *ht, const size_t *key);
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt);
-static void ht_def_free(ht_def_t *ht);
+static void prim_pair_view(const adj_view_t *a,
+			   size_t start,
+			   void *dist,
+			   size_t *prev,
+			   int (*cmp_wt)(const void *, const void *));
 
 /* functions for computing pointers */
 static void *wt_ptr(const void *wts, size_t i, size_t wt_size);
-static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
+
+/**
+   Defines a Prim's algorithm on a view of an adjacency list with vertices
+   of type vt_t and weights of type wt_t of basic type, and the functions
+   prim_<name> and prim_<name>_csr that run the algorithm on an adjacency
+   list and a CSR adjacency list. The weights are compared with the >
+   operator, and the heap compares the priorities according to pty_type
+   that is not HEAP_PTY_GEN.
+*/
+#define PRIM_SPEC(name, vt_t, wt_t, pty_type)				\
+  static void prim_##name##_view(const adj_view_t *a,			\
+				 size_t start,				\
+				 wt_t *dist,				\
+				 size_t *prev,				\
+				 const heap_ht_t *hht){			\
+    const char *p = NULL, *p_start = NULL, *p_end = NULL;		\
+    size_t pair_size = a->pair_size, wt_offset = a->wt_offset;		\
+    size_t num_vt_wts;							\
+    size_t u, v;							\
+    wt_t u_wt, uv_wt;							\
+    heap_t h;								\
+    if (hht == NULL){							\
+      heap_init(&h, sizeof(wt_t), sizeof(size_t), a->num_vts, 0, 0,	\
+		NULL, NULL, NULL, NULL, NULL);				\
+    }else{								\
+      heap_init(&h, sizeof(wt_t), sizeof(size_t), 0, hht->alpha_n,	\
+		hht->log_alpha_d, hht, NULL, NULL, NULL, NULL);		\
+    }									\
+    heap_soa(&h, pty_type);						\
+    memset(dist, 0, a->num_vts * sizeof(wt_t));				\
+    memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */	\
+    heap_push(&h, &dist[start], &start);				\
+    prev[start] = start;						\
+    while (h.num_elts > 0){						\
+      heap_pop(&h, &u_wt, &u);						\
+      p_start = a->vt_wts(a->adj, u, &num_vt_wts);			\
+      p_end = p_start + num_vt_wts * pair_size;				\
+      for (p = p_start; p != p_end; p += pair_size){			\
+	v = *(const vt_t *)p;						\
+	uv_wt = *(const wt_t *)(p + wt_offset);				\
+	if (prev[v] == C_NREACHED){					\
+	  dist[v] = uv_wt;						\
+	  heap_push(&h, &uv_wt, &v);					\
+	  prev[v] = u;							\
+	}else if (dist[v] > uv_wt && heap_search(&h, &v) != NULL){	\
+	  dist[v] = uv_wt;						\
+	  heap_update(&h, &uv_wt, &v);					\
+	  prev[v] = u;							\
+	}								\
+      }									\
+    }									\
+    heap_free(&h);							\
+  }									\
+									\
+  void prim_##name(const adj_lst_t *a,					\
+		   size_t start,					\
+		   wt_t *dist,						\
+		   size_t *prev,					\
+		   const heap_ht_t *hht){				\
+    adj_view_t w;							\
+    adj_lst_view(&w, a);						\
+    prim_##name##_view(&w, start, dist, prev, hht);			\
+  }									\
+									\
+  void prim_##name##_csr(const adj_csr_t *c,				\
+			 size_t start,					\
+			 wt_t *dist,					\
+			 size_t *prev,					\
+			 const heap_ht_t *hht){				\
+    adj_view_t w;							\
+    adj_csr_view(&w, c);						\
+    prim_##name##_view(&w, start, dist, prev, hht);			\
+  }
 
 /**
    Computes and copies the edge weights of an mst of the connected component
@@ -80,9 +165,9 @@ static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
                  is equal to the size of a weight in the adjacency list
    prev        : pointer to a preallocated array with a count that is equal
                  to the number of vertices in the adjacency list
-   hht         : - NULL pointer, if a default hash table is used for
-                 in-heap operations; a default hash table contains an index
-                 array with a count that is equal to the number of vertices
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
                  - a pointer to a set of parameters specifying a hash table
                  used for in-heap operations; a vertex is a hash key in 
                  the hash table
@@ -100,116 +185,273 @@ void prim(const adj_lst_t *a,
 	  size_t *prev,
 	  const heap_ht_t *hht,
 	  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  prim_view(&w, start, dist, prev, hht, cmp_wt);
+}
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, given a compressed sparse row
+   (CSR) adjacency list. Please see the parameter specification in prim.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void prim_csr(const adj_csr_t *c,
+	      size_t start,
+	      void *dist,
+	      size_t *prev,
+	      const heap_ht_t *hht,
+	      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  prim_view(&w, start, dist, prev, hht, cmp_wt);
+}
+
+/**
+   Initializes a workspace for repeated runs of prim_ws and prim_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(prim_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   wt_size     : size of a weight in the graphs in the runs
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to num_vts is used for in-heap operations
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; the hash table is kept
+                 across runs and freed by prim_ws_free
+   cmp_wt      : comparison function as specified in prim, and used by
+                 each run with the workspace
+*/
+void prim_ws_init(prim_ws_t *ws,
+		  size_t num_vts,
+		  size_t wt_size,
+		  const heap_ht_t *hht,
+		  int (*cmp_wt)(const void *, const void *)){
+  ws->num_vts = num_vts;
+  ws->wt_size = wt_size;
+  ws->is_first = 1;
+  ws->wt_buf = malloc_perror(1, wt_size);
+  if (hht == NULL){
+    /* the heap maps a vertex to its index with an index array */
+    heap_init(&ws->h, wt_size, sizeof(size_t), num_vts, 0, 0, NULL,
+	      cmp_wt, NULL, NULL, NULL);
+  }else{
+    heap_init(&ws->h, wt_size, sizeof(size_t), 0, hht->alpha_n,
+	      hht->log_alpha_d, hht, cmp_wt, NULL, NULL, NULL);
+  }
+  stack_init(&ws->vts, 1, sizeof(size_t), NULL);
+}
+
+/**
+   Runs prim with a workspace. The dist and prev parameters point to the
+   same arrays in each run with the workspace, and only the entries of the
+   vertices reached in the previous run are reset. Between runs, the
+   caller may read but not modify the arrays. The output is the same as
+   the output of prim with the same parameters. Please see the parameter
+   specification in prim.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+*/
+void prim_ws(const adj_lst_t *a,
+	     size_t start,
+	     void *dist,
+	     size_t *prev,
+	     prim_ws_t *ws,
+	     int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  prim_ws_view(&w, start, dist, prev, ws, cmp_wt);
+}
+
+void prim_ws_csr(const adj_csr_t *c,
+		 size_t start,
+		 void *dist,
+		 size_t *prev,
+		 prim_ws_t *ws,
+		 int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  prim_ws_view(&w, start, dist, prev, ws, cmp_wt);
+}
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, given an adjacency list or a
+   CSR adjacency list with vertices and weights of the types in the
+   function name: uint for unsigned int, sz for size_t, ulong for unsigned
+   long, and double. The vt_size and wt_size of the adjacency list are the
+   sizes of the types. The weights are compared with the > operator, and
+   the output is the same as the output of prim and prim_csr with the
+   corresponding cmp_wt. Please see the parameter specification in prim.
+*/
+PRIM_SPEC(uint_uint, unsigned int, unsigned int, HEAP_PTY_UINT)
+PRIM_SPEC(uint_double, unsigned int, double, HEAP_PTY_DOUBLE)
+PRIM_SPEC(sz_ulong, size_t, unsigned long int, HEAP_PTY_ULONG)
+
+/**
+   Frees a workspace and leaves a block of size sizeof(prim_ws_t) pointed
+   to by the ws parameter.
+*/
+void prim_ws_free(prim_ws_t *ws){
+  heap_free(&ws->h);
+  stack_free(&ws->vts);
+  free(ws->wt_buf);
+  ws->wt_buf = NULL;
+}
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, with a pairing heap instead of
+   a heap with a hash table parameter. A decrease of a weight in the heap
+   links a subtree with the root in O(1) time, which may provide speed
+   advantages on dense graphs where the number of decreases exceeds the
+   number of pops. The output is the same as the output of prim and
+   prim_csr. Please see the parameter specification in prim.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void prim_pair(const adj_lst_t *a,
+	       size_t start,
+	       void *dist,
+	       size_t *prev,
+	       int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  prim_pair_view(&w, start, dist, prev, cmp_wt);
+}
+
+void prim_pair_csr(const adj_csr_t *c,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  prim_pair_view(&w, start, dist, prev, cmp_wt);
+}
+
+/**
+   Runs Prim's algorithm on a view of an adjacency list with a workspace
+   that is used in a single run.
+*/
+static void prim_view(const adj_view_t *a,
+		      size_t start,
+		      void *dist,
+		      size_t *prev,
+		      const heap_ht_t *hht,
+		      int (*cmp_wt)(const void *, const void *)){
+  prim_ws_t ws;
+  prim_ws_init(&ws, a->num_vts, a->wt_size, hht, cmp_wt);
+  prim_ws_view(a, start, dist, prev, &ws, cmp_wt);
+  prim_ws_free(&ws);
+}
+
+/**
+   Runs Prim's algorithm on a view of an adjacency list with a workspace.
+   A vertex is a size_t index in the heap and its hash table. The dist and
+   prev arrays are fully reset in the first run, and otherwise only at the
+   vertices reached in the previous run.
+*/
+static void prim_ws_view(const adj_view_t *a,
+			 size_t start,
+			 void *dist,
+			 size_t *prev,
+			 prim_ws_t *ws,
+			 int (*cmp_wt)(const void *, const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   const char *uv_wt = NULL;
   size_t wt_size = a->wt_size;
-  size_t vt_size = sizeof(size_t);
-  size_t init_count = 1;
-  size_t u, v;
-  void *u_wt = NULL, *v_wt = NULL;
-  ht_def_t ht_def;
-  context_t context;
-  heap_ht_t hht_def;
-  heap_t h;
-  u_wt = malloc_perror(1, wt_size);
-  memset(dist, 0, a->num_vts * wt_size);
-  memset(prev, 0xff, a->num_vts * vt_size); /* initialize to C_NREACHED */
-  if (hht == NULL){
-    context.count = a->num_vts;
-    hht_def.ht = &ht_def;
-    hht_def.context = &context;
-    hht_def.init = (heap_ht_init)ht_def_init;
-    hht_def.insert = (heap_ht_insert)ht_def_insert;
-    hht_def.search = (heap_ht_search)ht_def_search;
-    hht_def.remove = (heap_ht_remove)ht_def_remove;
-    hht_def.free = (heap_ht_free)ht_def_free;
-    heap_init(&h, init_count, wt_size, vt_size, &hht_def, cmp_wt, NULL);
+  size_t num_vt_wts;
+  size_t i, u, v;
+  const size_t *vts = NULL;
+  void *u_wt = ws->wt_buf, *v_wt = NULL;
+  heap_t *h = &ws->h;
+  if (ws->is_first){
+    memset(dist, 0, a->num_vts * wt_size);
+    memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */
+    ws->is_first = 0;
   }else{
-    heap_init(&h, init_count, wt_size, vt_size, hht, cmp_wt, NULL);
+    vts = ws->vts.elts;
+    for (i = 0; i < ws->vts.num_elts; i++){
+      memset(wt_ptr(dist, vts[i], wt_size), 0, wt_size);
+      prev[vts[i]] = C_NREACHED;
+    }
   }
-  heap_push(&h, wt_ptr(dist, start, wt_size), &start);
+  ws->vts.num_elts = 0;
+  heap_reset(h);
+  heap_push(h, wt_ptr(dist, start, wt_size), &start);
   prev[start] = start;
-  while (h.num_elts > 0){
-    heap_pop(&h, u_wt, &u);
-    p_start = a->vt_wts[u]->elts;
-    p_end = p_start + a->vt_wts[u]->num_elts * a->pair_size;
+  stack_push(&ws->vts, &start);
+  while (h->num_elts > 0){
+    heap_pop(h, u_wt, &u);
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      v = *(const size_t *)p;
+      v = a->read_vt(p);
       v_wt = wt_ptr(dist, v, wt_size);
-      uv_wt = p + a->offset;
+      uv_wt = p + a->wt_offset;
       if (prev[v] == C_NREACHED){
 	memcpy(v_wt, uv_wt, wt_size);
-	heap_push(&h, v_wt, &v);
+	heap_push(h, v_wt, &v);
 	prev[v] = u;
+	stack_push(&ws->vts, &v);
       }else if (cmp_wt(v_wt, uv_wt) > 0 && /* hashing after && for efficiency */
-		heap_search(&h, &v) != NULL){
+		heap_search(h, &v) != NULL){
 	memcpy(v_wt, uv_wt, wt_size);
-	heap_update(&h, v_wt, &v);
+	heap_update(h, v_wt, &v);
 	prev[v] = u;
       }
     }
   }
-  heap_free(&h);
-  free(u_wt);
-  u_wt = NULL;
 }
 
 /**
-   Default hash table operations. In the main algorithm routine, the
-   elt_size block pointed to by elt in heap_push is a vertex (index).
-   Therefore, a vertex is a hash key in the hash table of the heap, as per
-   the specification of the hash table parameter of the heap.
+   Runs Prim's algorithm with a pairing heap on a view of an adjacency
+   list. A vertex is an index in the pool of nodes of the heap, and the
+   test of whether a vertex is in the heap does not hash.
 */
-
-static void ht_def_init(ht_def_t *ht,
-			size_t key_size,
-			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context){
-  context_t *c = context;
-  ht->key_size = key_size;
-  ht->elt_size = elt_size;
-  ht->count = c->count;
-  ht->key_present = calloc_perror(c->count, sizeof(boolean_t));
-  ht->elts = malloc_perror(c->count, elt_size);
-  ht->free_elt = free_elt;
-}
-
-static void ht_def_insert(ht_def_t *ht, const size_t *key, const void *elt){
-  ht->key_present[*key] = TRUE;
-  memcpy(elt_ptr(ht->elts, *key, ht->elt_size),
-	 elt,
-	 ht->elt_size);
-}
-
-static void *ht_def_search(const ht_def_t *ht, const size_t *key){
-  if (ht->key_present[*key]){
-    return elt_ptr(ht->elts, *key, ht->elt_size);
-  }else{
-    return NULL;
-  }
-}
-
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt){
-  ht->key_present[*key] = FALSE;
-  memcpy(elt,
-	 elt_ptr(ht->elts, *key, ht->elt_size),
-	 ht->elt_size);
-}
-
-static void ht_def_free(ht_def_t *ht){
-  size_t i;
-  if (ht->free_elt != NULL){
-    for (i = 0; i < ht->count; i++){
-      if (ht->key_present[i]){
-	ht->free_elt(elt_ptr(ht->elts, i, ht->elt_size));
+static void prim_pair_view(const adj_view_t *a,
+			   size_t start,
+			   void *dist,
+			   size_t *prev,
+			   int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_start = NULL, *p_end = NULL;
+  const char *uv_wt = NULL;
+  size_t wt_size = a->wt_size;
+  size_t num_vt_wts;
+  size_t u, v;
+  void *u_wt = NULL, *v_wt = NULL;
+  heap_pair_t h;
+  u_wt = malloc_perror(1, wt_size);
+  memset(dist, 0, a->num_vts * wt_size);
+  memset(prev, 0xff, a->num_vts * sizeof(size_t)); /* C_NREACHED */
+  heap_pair_init(&h, wt_size, a->num_vts, cmp_wt);
+  heap_pair_push(&h, wt_ptr(dist, start, wt_size), &start);
+  prev[start] = start;
+  while (h.num_elts > 0){
+    heap_pair_pop(&h, u_wt, &u);
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
+    for (p = p_start; p != p_end; p += a->pair_size){
+      v = a->read_vt(p);
+      v_wt = wt_ptr(dist, v, wt_size);
+      uv_wt = p + a->wt_offset;
+      if (prev[v] == C_NREACHED){
+	memcpy(v_wt, uv_wt, wt_size);
+	heap_pair_push(&h, v_wt, &v);
+	prev[v] = u;
+      }else if (cmp_wt(v_wt, uv_wt) > 0 &&
+		heap_pair_search(&h, &v) != NULL){
+	memcpy(v_wt, uv_wt, wt_size);
+	heap_pair_update(&h, v_wt, &v);
+	prev[v] = u;
       }
     }
   }
-  free(ht->key_present);
-  free(ht->elts);
-  ht->key_present = NULL;
-  ht->elts = NULL;
+  heap_pair_free(&h);
+  free(u_wt);
+  u_wt = NULL;
 }
 
 /** Functions for computing pointers */
@@ -220,11 +462,3 @@ static void ht_def_free(ht_def_t *ht){
 static void *wt_ptr(const void *wts, size_t i, size_t wt_size){
   return (void *)((char *)wts + i * wt_size);
 }
- 
-/**
-   Computes a pointer to an entry in the array of elements in a default hash
-   table.
-*/
-static void *elt_ptr(const void *elts, size_t i, size_t elt_size){
-  return (void *)((char *)elts + i * elt_size);
-}
@@ -15,14 +15,32 @@
    operations, and enables the optimization of space and time resources
    associated with heap operations in Prim's algorithm by choice of a
    hash table and its load factor upper bound. If NULL is passed as a hash
-   table parameter value, a default hash table is used, which contains an
-   index array with a count that is equal to the number of vertices in the
-   graph.   
+   table parameter value, the heap uses an index array with a count that
+   is equal to the number of vertices in the graph instead of a hash table.   
 
-   If E >> V, a default hash table may provide speed advantages by avoiding
+   If E >> V, an index array may provide speed advantages by avoiding
    the computation of hash values. If V is large and the graph is sparse,
    a non-default hash table may provide space advantages.
 
+   If Prim's algorithm is run repeatedly on a graph, prim_ws and
+   prim_ws_csr run with a workspace that is allocated once per thread.
+   The heap and its hash table or index array are allocated once, and the
+   dist and prev arrays are reset in O(number of vertices reached in the
+   previous run) time.
+
+   If the vertices and weights are of one of the (unsigned int, unsigned
+   int), (unsigned int, double), and (size_t, unsigned long) type pairs,
+   prim_uint_uint, prim_uint_double, prim_sz_ulong, and their _csr versions
+   read vertices and compare weights without calls through function
+   pointers, so that the compiler can inline the edge scan, and use a heap
+   with a structure-of-arrays layout and a specialized priority
+   comparison.
+
+   If the number of decreases of weights in the heap exceeds the number of
+   pops, e.g. on dense graphs, prim_pair and prim_pair_csr use a pairing
+   heap from heap-pair.h that requires no hash table and decreases a
+   weight by linking a subtree with the root in O(1) time.
+
    The implementation does not use stdint.h and is portable under C89/C90
    and C99.
 */
@@ -33,6 +51,17 @@
 #include <stddef.h>
 #include "graph.h"
 #include "heap.h"
+#include "heap-pair.h"
+#include "stack.h"
+
+typedef struct{
+  size_t num_vts;
+  size_t wt_size;
+  int is_first; /* non-zero before the first run */
+  void *wt_buf;
+  heap_t h;
+  stack_t vts; /* size_t vertices reached in the last run */
+} prim_ws_t;
 
 /**
    Computes and copies the edge weights of an mst of the connected component
@@ -46,9 +75,9 @@
                  is equal to the size of a weight in the adjacency list
    prev        : pointer to a preallocated array with a count that is equal
                  to the number of vertices in the adjacency list
-   hht         : - NULL pointer, if a default hash table is used for
-                 in-heap operations; a default hash table contains an index
-                 array with a count that is equal to the number of vertices
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to the number of vertices is used for in-heap
+                 operations instead of a hash table
                  - a pointer to a set of parameters specifying a hash table
                  used for in-heap operations; a vertex is a hash key in 
                  the hash table
@@ -66,4 +95,139 @@ void prim(const adj_lst_t *a,
 	  size_t *prev,
 	  const heap_ht_t *hht,
 	  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, given a compressed sparse row
+   (CSR) adjacency list. Please see the parameter specification in prim.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void prim_csr(const adj_csr_t *c,
+	      size_t start,
+	      void *dist,
+	      size_t *prev,
+	      const heap_ht_t *hht,
+	      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Initializes a workspace for repeated runs of prim_ws and prim_ws_csr.
+   ws          : pointer to a preallocated block of size sizeof(prim_ws_t)
+   num_vts     : number of vertices of the graphs in the runs
+   wt_size     : size of a weight in the graphs in the runs
+   hht         : - NULL pointer, if an index array with a count that is
+                 equal to num_vts is used for in-heap operations
+                 - a pointer to a set of parameters specifying a hash table
+                 used for in-heap operations; the hash table is kept
+                 across runs and freed by prim_ws_free
+   cmp_wt      : comparison function as specified in prim, and used by
+                 each run with the workspace
+*/
+void prim_ws_init(prim_ws_t *ws,
+		  size_t num_vts,
+		  size_t wt_size,
+		  const heap_ht_t *hht,
+		  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs prim with a workspace. The dist and prev parameters point to the
+   same arrays in each run with the workspace, and only the entries of the
+   vertices reached in the previous run are reset. Between runs, the
+   caller may read but not modify the arrays. The output is the same as
+   the output of prim with the same parameters. Please see the parameter
+   specification in prim.
+   ws          : pointer to a workspace initialized with the number of
+                 vertices and the weight size of the adjacency list
+*/
+void prim_ws(const adj_lst_t *a,
+	     size_t start,
+	     void *dist,
+	     size_t *prev,
+	     prim_ws_t *ws,
+	     int (*cmp_wt)(const void *, const void *));
+
+void prim_ws_csr(const adj_csr_t *c,
+		 size_t start,
+		 void *dist,
+		 size_t *prev,
+		 prim_ws_t *ws,
+		 int (*cmp_wt)(const void *, const void *));
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, given an adjacency list or a
+   CSR adjacency list with vertices and weights of the types in the
+   function name: uint for unsigned int, sz for size_t, ulong for unsigned
+   long, and double. The vt_size and wt_size of the adjacency list are the
+   sizes of the types. The weights are compared with the > operator, and
+   the output is the same as the output of prim and prim_csr with the
+   corresponding cmp_wt. Please see the parameter specification in prim.
+*/
+void prim_uint_uint(const adj_lst_t *a,
+		    size_t start,
+		    unsigned int *dist,
+		    size_t *prev,
+		    const heap_ht_t *hht);
+
+void prim_uint_uint_csr(const adj_csr_t *c,
+			size_t start,
+			unsigned int *dist,
+			size_t *prev,
+			const heap_ht_t *hht);
+
+void prim_uint_double(const adj_lst_t *a,
+		      size_t start,
+		      double *dist,
+		      size_t *prev,
+		      const heap_ht_t *hht);
+
+void prim_uint_double_csr(const adj_csr_t *c,
+			  size_t start,
+			  double *dist,
+			  size_t *prev,
+			  const heap_ht_t *hht);
+
+void prim_sz_ulong(const adj_lst_t *a,
+		   size_t start,
+		   unsigned long int *dist,
+		   size_t *prev,
+		   const heap_ht_t *hht);
+
+void prim_sz_ulong_csr(const adj_csr_t *c,
+		       size_t start,
+		       unsigned long int *dist,
+		       size_t *prev,
+		       const heap_ht_t *hht);
+
+/**
+   Frees a workspace and leaves a block of size sizeof(prim_ws_t) pointed
+   to by the ws parameter.
+*/
+void prim_ws_free(prim_ws_t *ws);
+
+/**
+   Computes and copies the edge weights of an mst of the connected component
+   of a start vertex to the array pointed to by dist, and the previous
+   vertices to the array pointed to by prev, with a pairing heap instead of
+   a heap with a hash table parameter. A decrease of a weight in the heap
+   links a subtree with the root in O(1) time, which may provide speed
+   advantages on dense graphs where the number of decreases exceeds the
+   number of pops. The output is the same as the output of prim and
+   prim_csr. Please see the parameter specification in prim.
+   a           : pointer to an adjacency list with at least one vertex
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+void prim_pair(const adj_lst_t *a,
+	       size_t start,
+	       void *dist,
+	       size_t *prev,
+	       int (*cmp_wt)(const void *, const void *));
+
+void prim_pair_csr(const adj_csr_t *c,
+		   size_t start,
+		   void *dist,
+		   size_t *prev,
+		   int (*cmp_wt)(const void *, const void *));
+
 #endif
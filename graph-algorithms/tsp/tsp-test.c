@@ -92,6 +92,10 @@ const double C_WTS_DOUBLE[12] = {1.0, 1.0, 1.0, 1.0, 2.0, 2.0, 2.0,
 				 2.0, 2.0, 2.0, 2.0, 2.0};
 
 /* random graph tests */
+/* spill budgets in bytes */
+const size_t C_SPILL_MIN_BUDGET = 1;
+const size_t C_SPILL_BUDGET = 65536;
+
 const int C_ITER = 3;
 const int C_PROBS_COUNT = 4;
 const int C_SPARSE_PROBS_COUNT = 2;
@@ -105,6 +109,7 @@ const size_t C_WEIGHT_HIGH = ((size_t)-1 >>
 
 void print_uint(const void *a);
 void print_double(const void *a);
+void lst_graph_init(graph_t *g, const adj_lst_t *a);
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *));
 void print_uint_arr(const size_t *arr, size_t n);
 void print_double_arr(const double *arr, size_t n);
@@ -117,20 +122,30 @@ void fprintf_stderr_exit(const char *s, int line);
 
 void graph_uint_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(size_t));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((size_t *)g->wts + i) = C_WTS_UINT[i];
   }
 }
 
 void graph_uint_single_vt_init(graph_t *g){
-  graph_base_init(g, 1, sizeof(size_t));
+  graph_base_init(g,
+		  1,
+		  sizeof(size_t),
+		  sizeof(size_t),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -151,46 +166,51 @@ int cmp_uint(const void *a, const void *b){
   }
 }
   
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-} context_divchn_t;
+/**
+   Set the parameters of hash tables used for set hashing operations.
+*/
 
-typedef struct{
-  size_t alpha_n;
-  size_t log_alpha_d;
-  size_t (*rdc_key)(const void *, size_t);
-} context_muloa_t;
-
-void ht_divchn_init_helper(ht_divchn_t *ht,
-			   size_t key_size,
-			   size_t elt_size,
-			   void (*free_elt)(void *),
-			   void *context){
-  context_divchn_t *c = context;
-  ht_divchn_init(ht,
-		 key_size,
-		 elt_size,
-		 0,
-		 c->alpha_n,
-		 c->log_alpha_d,
-		 free_elt);
-}
-
-void ht_muloa_init_helper(ht_muloa_t *ht,
-			  size_t key_size,
-			  size_t elt_size,
-			  void (*free_elt)(void *),
-			  void *context){
-  context_muloa_t * c = context;
-  ht_muloa_init(ht,
-		key_size,
-		elt_size,
-		0,
-		c->alpha_n,
-		c->log_alpha_d,
-		c->rdc_key,
-		free_elt);
+void ht_divchn_mem_hash_init(void *ht,
+			     size_t key_size,
+			     size_t elt_size,
+			     size_t min_num,
+			     size_t alpha_n,
+			     size_t log_alpha_d,
+			     int (*cmp_key)(const void *, const void *),
+			     size_t (*rdc_key)(const void *, size_t),
+			     void (*free_elt)(void *)){
+  (void)rdc_key; /* sets are hashed in sizeof(size_t)-byte increments */
+  ht_divchn_init_helper(ht,
+			key_size,
+			elt_size,
+			min_num,
+			alpha_n,
+			log_alpha_d,
+			cmp_key,
+			mem_hash,
+			free_elt);
+}
+
+void tht_divchn_init(tsp_ht_t *tht, ht_divchn_t *ht_divchn){
+  tht->ht = ht_divchn;
+  tht->alpha_n = C_ALPHA_N_DIVCHN;
+  tht->log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
+  tht->init = ht_divchn_mem_hash_init;
+  tht->insert = ht_divchn_insert_helper;
+  tht->search = ht_divchn_search_helper;
+  tht->remove = ht_divchn_remove_helper;
+  tht->free = ht_divchn_free_helper;
+}
+
+void tht_muloa_init(tsp_ht_t *tht, ht_muloa_t *ht_muloa){
+  tht->ht = ht_muloa;
+  tht->alpha_n = C_ALPHA_N_MULOA;
+  tht->log_alpha_d = C_LOG_ALPHA_D_MULOA;
+  tht->init = ht_muloa_init_helper;
+  tht->insert = ht_muloa_insert_helper;
+  tht->search = ht_muloa_search_helper;
+  tht->remove = ht_muloa_remove_helper;
+  tht->free = ht_muloa_free_helper;
 }
 
 void run_def_uint_tsp(const adj_lst_t *a){
@@ -210,17 +230,8 @@ void run_divchn_uint_tsp(const adj_lst_t *a){
   size_t dist;
   size_t i;
   ht_divchn_t ht_divchn;
-  context_divchn_t context_divchn;
   tsp_ht_t tht;
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  tht.ht = &ht_divchn;
-  tht.context = &context_divchn;
-  tht.init = (tsp_ht_init)ht_divchn_init_helper;
-  tht.insert = (tsp_ht_insert)ht_divchn_insert;
-  tht.search = (tsp_ht_search)ht_divchn_search;
-  tht.remove = (tsp_ht_remove)ht_divchn_remove;
-  tht.free = (tsp_ht_free)ht_divchn_free;
+  tht_divchn_init(&tht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     ret = tsp(a, i, &dist, &tht, add_uint, cmp_uint);
     printf("tsp ret: %d, tour length with %lu as start: ", ret, TOLU(i));
@@ -234,18 +245,8 @@ void run_muloa_uint_tsp(const adj_lst_t *a){
   size_t dist;
   size_t i;
   ht_muloa_t ht_muloa;
-  context_muloa_t context_muloa;
   tsp_ht_t tht;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  context_muloa.rdc_key = NULL;
-  tht.ht = &ht_muloa;
-  tht.context = &context_muloa;
-  tht.init = (tsp_ht_init)ht_muloa_init_helper;
-  tht.insert = (tsp_ht_insert)ht_muloa_insert;
-  tht.search = (tsp_ht_search)ht_muloa_search;
-  tht.remove = (tsp_ht_remove)ht_muloa_remove;
-  tht.free = (tsp_ht_free)ht_muloa_free;
+  tht_muloa_init(&tht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     ret = tsp(a, i, &dist, &tht, add_uint, cmp_uint);
     printf("tsp ret: %d, tour length with %lu as start: ", ret, TOLU(i));
@@ -254,6 +255,23 @@ void run_muloa_uint_tsp(const adj_lst_t *a){
   printf("\n");
 }
 
+void run_spill_uint_tsp(const adj_lst_t *a){
+  int ret = -1;
+  size_t i;
+  size_t dist;
+  for (i = 0; i < a->num_vts; i++){
+    ret = tsp_spill(a,
+		    i,
+		    &dist,
+		    C_SPILL_MIN_BUDGET,
+		    add_uint,
+		    cmp_uint);
+    printf("tsp_spill ret: %d, tour length with %lu as start: ",
+	   ret, TOLU(i));
+    print_uint_arr(&dist, 1);
+  }
+  printf("\n");
+}
 
 void run_uint_graph_test(){
   graph_t g;
@@ -262,26 +280,30 @@ void run_uint_graph_test(){
   printf("Running a test on a size_t graph with a \n"
 	 "i) default hash table \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) spill buffer of a single state \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_def_uint_tsp(&a);
   run_divchn_uint_tsp(&a);
   run_muloa_uint_tsp(&a);
+  run_spill_uint_tsp(&a);
   adj_lst_free(&a);
   graph_free(&g);
   graph_uint_single_vt_init(&g);
   printf("Running a test on a size_t graph with a single vertex, with a \n"
 	 "i) default hash table \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) spill buffer of a single state \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_uint);
   run_def_uint_tsp(&a);
   run_divchn_uint_tsp(&a);
   run_muloa_uint_tsp(&a);
+  run_spill_uint_tsp(&a);
   adj_lst_free(&a);
   graph_free(&g);
 }
@@ -292,20 +314,30 @@ void run_uint_graph_test(){
 
 void graph_double_wts_init(graph_t *g){
   size_t i;
-  graph_base_init(g, C_NUM_VTS, sizeof(double));
+  graph_base_init(g,
+		  C_NUM_VTS,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
   g->num_es = C_NUM_ES;
-  g->u = malloc_perror(g->num_es, sizeof(size_t));
-  g->v = malloc_perror(g->num_es, sizeof(size_t));
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
   g->wts = malloc_perror(g->num_es, g->wt_size);
   for (i = 0; i < g->num_es; i++){
-    g->u[i] = C_U[i];
-    g->v[i] = C_V[i];
+    *((size_t *)g->u + i) = C_U[i];
+    *((size_t *)g->v + i) = C_V[i];
     *((double *)g->wts + i) = C_WTS_DOUBLE[i];
   }
 }
 
 void graph_double_single_vt_init(graph_t *g){
-  graph_base_init(g, 1, sizeof(double));
+  graph_base_init(g,
+		  1,
+		  sizeof(size_t),
+		  sizeof(double),
+		  graph_read_sz,
+		  graph_write_sz);
 }
 
 /**
@@ -343,17 +375,8 @@ void run_divchn_double_tsp(const adj_lst_t *a){
   size_t i;
   double dist;
   ht_divchn_t ht_divchn;
-  context_divchn_t context_divchn;
   tsp_ht_t tht;
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  tht.ht = &ht_divchn;
-  tht.context = &context_divchn;
-  tht.init = (tsp_ht_init)ht_divchn_init_helper;
-  tht.insert = (tsp_ht_insert)ht_divchn_insert;
-  tht.search = (tsp_ht_search)ht_divchn_search;
-  tht.remove = (tsp_ht_remove)ht_divchn_remove;
-  tht.free = (tsp_ht_free)ht_divchn_free;
+  tht_divchn_init(&tht, &ht_divchn);
   for (i = 0; i < a->num_vts; i++){
     ret = tsp(a, i, &dist, &tht, add_double, cmp_double);
     printf("tsp ret: %d, tour length with %lu as start: ", ret, TOLU(i));
@@ -367,18 +390,8 @@ void run_muloa_double_tsp(const adj_lst_t *a){
   size_t i;
   double dist;
   ht_muloa_t ht_muloa;
-  context_muloa_t context_muloa;
   tsp_ht_t tht;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  context_muloa.rdc_key = NULL;
-  tht.ht = &ht_muloa;
-  tht.context = &context_muloa;
-  tht.init = (tsp_ht_init)ht_muloa_init_helper;
-  tht.insert = (tsp_ht_insert)ht_muloa_insert;
-  tht.search = (tsp_ht_search)ht_muloa_search;
-  tht.remove = (tsp_ht_remove)ht_muloa_remove;
-  tht.free = (tsp_ht_free)ht_muloa_free;
+  tht_muloa_init(&tht, &ht_muloa);
   for (i = 0; i < a->num_vts; i++){
     ret = tsp(a, i, &dist, &tht, add_double, cmp_double);
     printf("tsp ret: %d, tour length with %lu as start: ", ret, TOLU(i));
@@ -387,6 +400,23 @@ void run_muloa_double_tsp(const adj_lst_t *a){
   printf("\n");
 }
 
+void run_spill_double_tsp(const adj_lst_t *a){
+  int ret = -1;
+  size_t i;
+  double dist;
+  for (i = 0; i < a->num_vts; i++){
+    ret = tsp_spill(a,
+		    i,
+		    &dist,
+		    C_SPILL_MIN_BUDGET,
+		    add_double,
+		    cmp_double);
+    printf("tsp_spill ret: %d, tour length with %lu as start: ",
+	   ret, TOLU(i));
+    print_double_arr(&dist, 1);
+  }
+  printf("\n");
+}
 
 void run_double_graph_test(){
   graph_t g;
@@ -395,26 +425,30 @@ void run_double_graph_test(){
   printf("Running a test on a double graph with a \n"
 	 "i) default hash table \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) spill buffer of a single state \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_def_double_tsp(&a);
   run_divchn_double_tsp(&a);
   run_muloa_double_tsp(&a);
+  run_spill_double_tsp(&a);
   adj_lst_free(&a);
   graph_free(&g);
   graph_double_single_vt_init(&g);
   printf("Running a test on a double graph with a single vertex, with a \n"
 	 "i) default hash table \n"
 	 "ii) ht_divchn_t hash table \n"
-	 "iii) ht_muloa_t hash table \n\n");
-  adj_lst_init(&a, &g);
+	 "iii) ht_muloa_t hash table \n"
+	 "iv) spill buffer of a single state \n\n");
+  adj_lst_base_init(&a, &g);
   adj_lst_dir_build(&a, &g);
   print_adj_lst(&a, print_double);
   run_def_double_tsp(&a);
   run_divchn_double_tsp(&a);
   run_muloa_double_tsp(&a);
+  run_spill_double_tsp(&a);
   adj_lst_free(&a);
   graph_free(&g);
 }
@@ -475,8 +509,9 @@ void adj_lst_rand_dir_wts(adj_lst_t *a,
   size_t i, j;
   graph_t g;
   bern_arg_t arg_true;
-  graph_base_init(&g, n, wt_size);
-  adj_lst_init(a, &g);
+  graph_base_init(&g, n, sizeof(size_t), wt_size,
+		  graph_read_sz, graph_write_sz);
+  adj_lst_base_init(a, &g);
   arg_true.p = C_PROB_ONE;
   for (i = 0; i < n - 1; i++){
     for (j = i + 1; j < n; j++){
@@ -505,39 +540,25 @@ void adj_lst_rand_dir_wts(adj_lst_t *a,
 void run_rand_uint_test(int num_vts_start, int num_vts_end){
   int p, i, j;
   int res = 1;
-  int ret_def = -1, ret_divchn = -1, ret_muloa = -1;
+  int ret_def = -1, ret_divchn = -1, ret_muloa = -1, ret_csr = -1;
+  int ret_dense = -1, ret_dense_csr = -1, ret_spill = -1, ret_spill_csr = -1;
   size_t n;
   size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
-  size_t dist_def, dist_divchn, dist_muloa;
+  size_t dist_def, dist_divchn, dist_muloa, dist_csr;
+  size_t dist_dense, dist_dense_csr, dist_spill, dist_spill_csr;
   size_t *rand_start = NULL;
+  graph_t g;
   adj_lst_t a;
+  adj_csr_t c;
   bern_arg_t b;
   ht_divchn_t ht_divchn;
   ht_muloa_t ht_muloa;
-  context_divchn_t context_divchn;
-  context_muloa_t context_muloa;
   tsp_ht_t tht_divchn, tht_muloa;
-  clock_t t_def, t_divchn, t_muloa;
+  clock_t t_def, t_divchn, t_muloa, t_csr, t_dense, t_dense_csr;
+  clock_t t_spill, t_spill_csr;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  tht_divchn.ht = &ht_divchn;
-  tht_divchn.context = &context_divchn;
-  tht_divchn.init = (tsp_ht_init)ht_divchn_init_helper;
-  tht_divchn.insert = (tsp_ht_insert)ht_divchn_insert;
-  tht_divchn.search = (tsp_ht_search)ht_divchn_search;
-  tht_divchn.remove = (tsp_ht_remove)ht_divchn_remove;
-  tht_divchn.free = (tsp_ht_free)ht_divchn_free;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  context_muloa.rdc_key = NULL;
-  tht_muloa.ht = &ht_muloa;
-  tht_muloa.context = &context_muloa;
-  tht_muloa.init = (tsp_ht_init)ht_muloa_init_helper;
-  tht_muloa.insert = (tsp_ht_insert)ht_muloa_insert;
-  tht_muloa.search = (tsp_ht_search)ht_muloa_search;
-  tht_muloa.remove = (tsp_ht_remove)ht_muloa_remove;
-  tht_muloa.free = (tsp_ht_free)ht_muloa_free;
+  tht_divchn_init(&tht_divchn, &ht_divchn);
+  tht_muloa_init(&tht_muloa, &ht_muloa);
   printf("Run a tsp test across all hash tables on random directed graphs \n"
 	 "with random size_t non-tour weights in [%lu, %lu]\n",
 	 TOLU(wt_l), TOLU(wt_h));
@@ -555,6 +576,10 @@ void run_rand_uint_test(int num_vts_start, int num_vts_end){
 			   bern,
 			   &b,
 			   add_dir_uint_edge);
+      lst_graph_init(&g, &a);
+      adj_csr_base_init(&c, &g);
+      adj_csr_dir_build(&c, &g);
+      graph_free(&g);
       for (j = 0; j < C_ITER; j++){
 	rand_start[j] = RANDOM() % n;
       }
@@ -588,27 +613,96 @@ void run_rand_uint_test(int num_vts_start, int num_vts_end){
 		      cmp_uint);
       }
       t_muloa = clock() - t_muloa;
+      t_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_csr = tsp_csr(&c,
+			  rand_start[j],
+			  &dist_csr,
+			  NULL,
+			  add_uint,
+			  cmp_uint);
+      }
+      t_csr = clock() - t_csr;
+      t_dense = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_dense = tsp_dense(&a,
+			      rand_start[j],
+			      &dist_dense,
+			      add_uint,
+			      cmp_uint);
+      }
+      t_dense = clock() - t_dense;
+      t_dense_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_dense_csr = tsp_dense_csr(&c,
+				      rand_start[j],
+				      &dist_dense_csr,
+				      add_uint,
+				      cmp_uint);
+      }
+      t_dense_csr = clock() - t_dense_csr;
+      t_spill = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_spill = tsp_spill(&a,
+			      rand_start[j],
+			      &dist_spill,
+			      C_SPILL_BUDGET,
+			      add_uint,
+			      cmp_uint);
+      }
+      t_spill = clock() - t_spill;
+      t_spill_csr = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_spill_csr = tsp_spill_csr(&c,
+				      rand_start[j],
+				      &dist_spill_csr,
+				      C_SPILL_BUDGET,
+				      add_uint,
+				      cmp_uint);
+      }
+      t_spill_csr = clock() - t_spill_csr;
       if (n == 1){
 	res *= (dist_def == 0 && ret_def == 0);
 	res *= (dist_divchn == 0 && ret_divchn == 0);
 	res *= (dist_muloa == 0 && ret_muloa == 0);
+	res *= (dist_csr == 0 && ret_csr == 0);
+	res *= (dist_dense == 0 && ret_dense == 0);
+	res *= (dist_dense_csr == 0 && ret_dense_csr == 0);
+	res *= (dist_spill == 0 && ret_spill == 0);
+	res *= (dist_spill_csr == 0 && ret_spill_csr == 0);
       }else{
 	res *= (dist_def == n && ret_def == 0);
 	res *= (dist_divchn == n && ret_divchn == 0);
 	res *= (dist_muloa == n && ret_muloa == 0);
+	res *= (dist_csr == n && ret_csr == 0);
+	res *= (dist_dense == n && ret_dense == 0);
+	res *= (dist_dense_csr == n && ret_dense_csr == 0);
+	res *= (dist_spill == n && ret_spill == 0);
+	res *= (dist_spill_csr == n && ret_spill_csr == 0);
       }
       printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	     TOLU(a.num_vts), TOLU(a.num_es));
       printf("\t\t\ttsp default ht ave runtime:     %.8f seconds\n"
 	     "\t\t\ttsp ht_divchn ave runtime:      %.8f seconds\n"
-	     "\t\t\ttsp ht_muloa ave runtime:       %.8f seconds\n",
+	     "\t\t\ttsp ht_muloa ave runtime:       %.8f seconds\n"
+	     "\t\t\ttsp_csr default ht ave runtime: %.8f seconds\n"
+	     "\t\t\ttsp_dense ave runtime:          %.8f seconds\n"
+	     "\t\t\ttsp_dense_csr ave runtime:      %.8f seconds\n"
+	     "\t\t\ttsp_spill ave runtime:          %.8f seconds\n"
+	     "\t\t\ttsp_spill_csr ave runtime:      %.8f seconds\n",
 	     (float)t_def / C_ITER / CLOCKS_PER_SEC,
 	     (float)t_divchn / C_ITER / CLOCKS_PER_SEC,
-	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC);
+	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_csr / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_dense / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_dense_csr / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_spill / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_spill_csr / C_ITER / CLOCKS_PER_SEC);
       printf("\t\t\tcorrectness:                    ");
       print_test_result(res);
       res = 1;
       adj_lst_free(&a);
+      adj_csr_free(&c);
     }
   }
   free(rand_start);
@@ -622,14 +716,14 @@ void run_rand_uint_test(int num_vts_start, int num_vts_end){
 void run_def_rand_uint_test(int num_vts_start, int num_vts_end){
   int i, j;
   int res = 1;
-  int ret_def = -1;
+  int ret_def = -1, ret_dense = -1;
   size_t n;
   size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
-  size_t dist_def;
+  size_t dist_def, dist_dense;
   size_t *rand_start = NULL;
   adj_lst_t a;
   bern_arg_t b;
-  clock_t t_def;
+  clock_t t_def, t_dense;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
   printf("Run a tsp test with a default hash table on directed graphs \n"
 	 "with random size_t non-tour weights in [%lu, %lu]\n",
@@ -660,15 +754,30 @@ void run_def_rand_uint_test(int num_vts_start, int num_vts_end){
 		    cmp_uint);
     }
     t_def = clock() - t_def;
+    t_dense = clock();
+    for (j = 0; j < C_ITER; j++){
+      ret_dense = tsp_dense(&a,
+			    rand_start[j],
+			    &dist_dense,
+			    add_uint,
+			    cmp_uint);
+    }
+    t_dense = clock() - t_dense;
     if (n == 1){
       res *= (dist_def == 0 && ret_def == 0);
+      res *= (dist_dense == 0 && ret_dense == 0);
     }else{
       res *= (dist_def == n && ret_def == 0);
+      res *= (dist_dense == n && ret_dense == 0);
     }
     printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	   TOLU(a.num_vts), TOLU(a.num_es));
-    printf("\t\t\ttsp default ht ave runtime:     %.8f seconds\n",
-	   (float)t_def / C_ITER / CLOCKS_PER_SEC);
+    printf("\t\t\ttsp default ht ave runtime:     %.8f seconds\n"
+	   "\t\t\ttsp_dense ave runtime:          %.8f seconds\n"
+	   "\t\t\ttsp_dense table size:           %lu bytes\n",
+	   (float)t_def / C_ITER / CLOCKS_PER_SEC,
+	   (float)t_dense / C_ITER / CLOCKS_PER_SEC,
+	   TOLU(tsp_dense_size(n, sizeof(size_t))));
     printf("\t\t\tcorrectness:                    ");
     print_test_result(res);
     res = 1;
@@ -685,39 +794,20 @@ void run_def_rand_uint_test(int num_vts_start, int num_vts_end){
 void run_sparse_rand_uint_test(int num_vts_start, int num_vts_end){
   int p, i, j;
   int res = 1;
-  int ret_divchn = -1, ret_muloa = -1;
+  int ret_divchn = -1, ret_muloa = -1, ret_spill = -1;
   size_t n;
   size_t wt_l = 0, wt_h = C_WEIGHT_HIGH;
-  size_t dist_divchn, dist_muloa;
+  size_t dist_divchn, dist_muloa, dist_spill;
   size_t *rand_start = NULL;
   adj_lst_t a;
   bern_arg_t b;
   ht_divchn_t ht_divchn;
   ht_muloa_t ht_muloa;
-  context_divchn_t context_divchn;
-  context_muloa_t context_muloa;
   tsp_ht_t tht_divchn, tht_muloa;
-  clock_t t_divchn, t_muloa;
+  clock_t t_divchn, t_muloa, t_spill;
   rand_start = malloc_perror(C_ITER, sizeof(size_t));
-  context_divchn.alpha_n = C_ALPHA_N_DIVCHN;
-  context_divchn.log_alpha_d = C_LOG_ALPHA_D_DIVCHN;
-  tht_divchn.ht = &ht_divchn;
-  tht_divchn.context = &context_divchn;
-  tht_divchn.init = (tsp_ht_init)ht_divchn_init_helper;
-  tht_divchn.insert = (tsp_ht_insert)ht_divchn_insert;
-  tht_divchn.search = (tsp_ht_search)ht_divchn_search;
-  tht_divchn.remove = (tsp_ht_remove)ht_divchn_remove;
-  tht_divchn.free = (tsp_ht_free)ht_divchn_free;
-  context_muloa.alpha_n = C_ALPHA_N_MULOA;
-  context_muloa.log_alpha_d = C_LOG_ALPHA_D_MULOA;
-  context_muloa.rdc_key = NULL;
-  tht_muloa.ht = &ht_muloa;
-  tht_muloa.context = &context_muloa;
-  tht_muloa.init = (tsp_ht_init)ht_muloa_init_helper;
-  tht_muloa.insert = (tsp_ht_insert)ht_muloa_insert;
-  tht_muloa.search = (tsp_ht_search)ht_muloa_search;
-  tht_muloa.remove = (tsp_ht_remove)ht_muloa_remove;
-  tht_muloa.free = (tsp_ht_free)ht_muloa_free;
+  tht_divchn_init(&tht_divchn, &ht_divchn);
+  tht_muloa_init(&tht_muloa, &ht_muloa);
   printf("Run a tsp test on sparse random directed graphs with random "
 	 "size_t non-tour weights in [%lu, %lu]\n", TOLU(wt_l), TOLU(wt_h));
   fflush(stdout);
@@ -757,19 +847,33 @@ void run_sparse_rand_uint_test(int num_vts_start, int num_vts_end){
 			cmp_uint);
       }
       t_muloa = clock() - t_muloa;
+      t_spill = clock();
+      for (j = 0; j < C_ITER; j++){
+	ret_spill = tsp_spill(&a,
+			      rand_start[j],
+			      &dist_spill,
+			      C_SPILL_BUDGET,
+			      add_uint,
+			      cmp_uint);
+      }
+      t_spill = clock() - t_spill;
       if (n == 1){
 	res *= (dist_divchn == 0 && ret_divchn == 0);
 	res *= (dist_muloa == 0 && ret_muloa == 0);
+	res *= (dist_spill == 0 && ret_spill == 0);
       }else{
 	res *= (dist_divchn == n && ret_divchn == 0);
 	res *= (dist_muloa == n && ret_muloa == 0);
+	res *= (dist_spill == n && ret_spill == 0);
       }
       printf("\t\tvertices: %lu, # of directed edges: %lu\n",
 	     TOLU(a.num_vts), TOLU(a.num_es));
       printf("\t\t\ttsp ht_divchn ave runtime:      %.8f seconds\n"
-	     "\t\t\ttsp ht_muloa ave runtime:       %.8f seconds\n",
+	     "\t\t\ttsp ht_muloa ave runtime:       %.8f seconds\n"
+	     "\t\t\ttsp_spill ave runtime:          %.8f seconds\n",
 	     (float)t_divchn / C_ITER / CLOCKS_PER_SEC,
-	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC);
+	     (float)t_muloa / C_ITER / CLOCKS_PER_SEC,
+	     (float)t_spill / C_ITER / CLOCKS_PER_SEC);
       printf("\t\t\tcorrectness:                    ");
       print_test_result(res);
       res = 1;
@@ -780,6 +884,47 @@ void run_sparse_rand_uint_test(int num_vts_start, int num_vts_end){
   rand_start = NULL;
 }
 
+/**
+   Initializes a graph with a directed edge for each entry of an adjacency
+   list in the order of the adjacency list, for building a CSR adjacency
+   list with adj_csr_dir_build.
+*/
+void lst_graph_init(graph_t *g, const adj_lst_t *a){
+  size_t i, j;
+  size_t num_vt_wts;
+  char *up = NULL, *vp = NULL, *wp = NULL;
+  const char *p = NULL;
+  graph_base_init(g,
+		  a->num_vts,
+		  a->vt_size,
+		  a->wt_size,
+		  a->read_vt,
+		  a->write_vt);
+  for (i = 0; i < a->num_vts; i++){
+    adj_lst_vt_wts(a, i, &num_vt_wts);
+    g->num_es += num_vt_wts;
+  }
+  if (g->num_es == 0) return;
+  g->u = malloc_perror(g->num_es, g->vt_size);
+  g->v = malloc_perror(g->num_es, g->vt_size);
+  g->wts = malloc_perror(g->num_es, g->wt_size);
+  up = g->u;
+  vp = g->v;
+  wp = g->wts;
+  for (i = 0; i < a->num_vts; i++){
+    p = adj_lst_vt_wts(a, i, &num_vt_wts);
+    for (j = 0; j < num_vt_wts; j++){
+      g->write_vt(up, i);
+      memcpy(vp, p, g->vt_size);
+      memcpy(wp, p + a->wt_offset, g->wt_size);
+      up += g->vt_size;
+      vp += g->vt_size;
+      wp += g->wt_size;
+      p += a->pair_size;
+    }
+  }
+}
+
 /**
    Printing functions.
 */
@@ -795,13 +940,14 @@ void print_double(const void *a){
 void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t i;
+  size_t num_vt_wts;
   printf("\tvertices: \n");
   for (i = 0; i < a->num_vts; i++){
     printf("\t%lu : ", TOLU(i));
-    p_start = a->vt_wts[i]->elts;
-    p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+    p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      printf("%lu ", TOLU(*(const size_t *)p));
+      printf("%lu ", TOLU(a->read_vt(p)));
     }
     printf("\n");
   }
@@ -809,10 +955,10 @@ void print_adj_lst(const adj_lst_t *a, void (*print_wt)(const void *)){
     printf("\tweights: \n");
     for (i = 0; i < a->num_vts; i++){
       printf("\t%lu : ", TOLU(i));
-      p_start = a->vt_wts[i]->elts;
-      p_end = p_start + a->vt_wts[i]->num_elts * a->pair_size;
+      p_start = adj_lst_vt_wts(a, i, &num_vt_wts);
+      p_end = p_start + num_vt_wts * a->pair_size;
       for (p = p_start; p != p_end; p += a->pair_size){
-	print_wt(p + a->offset);
+	print_wt(p + a->wt_offset);
       }
       printf("\n");
     }
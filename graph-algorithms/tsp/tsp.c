@@ -25,6 +25,24 @@
    provide speed advantages by avoiding the computation of hash values. If V
    is larger and the graph is sparse, a non-default hash table may provide
    space advantages.
+
+   For small V, tsp_dense and tsp_dense_csr run the algorithm on a dense
+   table indexed by the subset of the vertices other than start and by the
+   last reached vertex, where subsets are processed in increasing order of
+   their representations as integers. The table contains no set keys and
+   no hash values, presence is a single bit per entry, and a weight
+   occupies wt_size bytes without padding. tsp_dense_size provides the
+   size of the table before it is allocated.
+
+   tsp_spill and tsp_spill_csr keep in memory only a buffer of subset states
+   of a bounded size in bytes. A layer of the states of the subsets of the
+   same size is streamed from a temporary file sorted by the subset and the
+   last reached vertex, and the next layer is generated into the buffer,
+   sorted and merged with the buffer contents when the buffer is full, and
+   spilled to sorted temporary runs that are merged into the next layer
+   file. Only the states of two consecutive layers are present at a time,
+   and a smaller memory budget leads to more runs and merges instead of an
+   allocation failure.
 */
 
 #include <stdio.h>
@@ -38,10 +56,6 @@
 
 typedef enum{FALSE, TRUE} boolean_t;
 
-typedef struct{
-  size_t num_vts;
-} context_t;
-
 typedef struct{
   size_t key_size;
   size_t elt_size;
@@ -56,8 +70,25 @@ typedef struct{
   size_t bit; /* set element with a single set bit */
 } ibit_t;
 
+typedef struct{
+  FILE *f; /* temporary file of sorted records without duplicate sets */
+  size_t num; /* number of records remaining to be read */
+  size_t level; /* number of merges that produced the run */
+} run_t;
+
+typedef struct{
+  size_t set_count;
+  size_t set_size;
+  size_t wt_size;
+  size_t rec_size; /* set_size + wt_size rounded up to C_SET_ELT_SIZE */
+  void *wt_a; /* aligned weight blocks for comparisons */
+  void *wt_b;
+  int (*cmp_wt)(const void *, const void *);
+} spill_t;
+
 static const size_t C_SET_ELT_SIZE = sizeof(size_t);
 static const size_t C_SET_ELT_BIT = CHAR_BIT * sizeof(size_t);
+static const size_t C_MERGE_FAN = 8; /* number of runs merged at a time */
 
 /* set operations based on a bit array representation */
 static void set_init(ibit_t *ibit, size_t n);
@@ -65,18 +96,64 @@ static size_t *set_member(const ibit_t *ibit, const size_t *set);
 static void set_union(const ibit_t *ibit, size_t *set);
 
 /* default hash table operations */
-static void ht_def_init(ht_def_t *ht,
+static void ht_def_init(void *ht,
 			size_t key_size,
 			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context);
-static void ht_def_insert(ht_def_t *ht, const size_t *key, const void *elt);
-static void *ht_def_search(const ht_def_t *ht, const size_t *key);
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt);
-static void ht_def_free(ht_def_t *ht);
+			size_t min_num,
+			size_t alpha_n,
+			size_t log_alpha_d,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t),
+			void (*free_elt)(void *));
+static void ht_def_insert(void *ht, const void *key, const void *elt);
+static void *ht_def_search(const void *ht, const void *key);
+static void ht_def_remove(void *ht, const void *key, void *elt);
+static void ht_def_free(void *ht);
+
+static int tsp_view(const adj_view_t *a,
+		    size_t start,
+		    void *dist,
+		    const tsp_ht_t *tht,
+		    void (*add_wt)(void *, const void *, const void *),
+		    int (*cmp_wt)(const void *, const void *));
+
+static int tsp_dense_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *));
+
+static int tsp_spill_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  size_t budget,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *));
+
+/* record and temporary file operations for tsp_spill_view */
+static int cmp_key(const spill_t *sp, const void *a, const void *b);
+static int cmp_rec_wt(const spill_t *sp, const void *a, const void *b);
+static void sort_recs(const spill_t *sp, char *recs, size_t num, void *tmp);
+static void sift_down(const spill_t *sp,
+		      char *recs,
+		      size_t i,
+		      size_t num,
+		      void *tmp);
+static size_t uniq_recs(const spill_t *sp, char *recs, size_t num);
+static void push_run(const spill_t *sp,
+		     stack_t *runs,
+		     const char *recs,
+		     size_t num);
+static size_t merge_runs(const spill_t *sp,
+			 run_t *runs,
+			 size_t num,
+			 FILE *f);
+static FILE *tmpfile_perror(void);
+static void fwrite_perror(const void *s, size_t size, FILE *f);
+static void fread_perror(void *s, size_t size, FILE *f);
 
 /* auxiliary functions */
-static void build_next(const adj_lst_t *a,
+static void build_next(const adj_view_t *a,
 		       stack_t *prev_s,
 		       stack_t *next_s,
 		       const tsp_ht_t *tht,
@@ -125,9 +202,137 @@ int tsp(const adj_lst_t *a,
 	const tsp_ht_t *tht,
 	void (*add_wt)(void *, const void *, const void *),
 	int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return tsp_view(&w, start, dist, tht, add_wt, cmp_wt);
+}
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from 
+   start to start across all vertices without revisiting, if a tour exists,
+   given a compressed sparse row (CSR) adjacency list. Returns 0 if a tour
+   exists, otherwise returns 1. Please see the parameter specification in
+   tsp.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+int tsp_csr(const adj_csr_t *c,
+	    size_t start,
+	    void *dist,
+	    const tsp_ht_t *tht,
+	    void (*add_wt)(void *, const void *, const void *),
+	    int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return tsp_view(&w, start, dist, tht, add_wt, cmp_wt);
+}
+
+/**
+   Returns the number of bytes allocated by tsp_dense and tsp_dense_csr on
+   a graph with num_vts vertices and weights of size wt_size, which is
+   (n - 1) * 2^(n - 1) * wt_size plus one bit per entry rounded up to
+   bytes, where n is the number of vertices, or 0 if the number of bytes
+   is not representable as size_t.
+*/
+size_t tsp_dense_size(size_t num_vts, size_t wt_size){
+  size_t m, num_ents, num_bytes;
+  if (num_vts < 2) return 0;
+  m = num_vts - 1;
+  if (m >= C_SET_ELT_BIT || pow_two(m) > (size_t)-1 / m) return 0;
+  num_ents = m * pow_two(m);
+  if (wt_size > 0 && num_ents > (size_t)-1 / wt_size) return 0;
+  num_bytes = num_ents * wt_size;
+  if (num_bytes > (size_t)-1 - (num_ents / CHAR_BIT + 1)) return 0;
+  return num_bytes + num_ents / CHAR_BIT + 1;
+}
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with a dense table. Returns 0 if a tour exists, otherwise returns 1. The
+   table is allocated in a single block of tsp_dense_size(n, wt_size)
+   bytes, where n is the number of vertices; if tsp_dense_size returns 0
+   or the allocation fails, the program terminates with an error message.
+   Please see the parameter specification in tsp.
+*/
+int tsp_dense(const adj_lst_t *a,
+	      size_t start,
+	      void *dist,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return tsp_dense_view(&w, start, dist, add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_dense on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_dense.
+*/
+int tsp_dense_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return tsp_dense_view(&w, start, dist, add_wt, cmp_wt);
+}
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with a bounded memory budget for subset states and temporary files for
+   the layers that do not fit in memory. Returns 0 if a tour exists,
+   otherwise returns 1. If a temporary file cannot be created, read, or
+   written, the program terminates with an error message. Please see the
+   parameter specification in tsp.
+   budget      : upper bound on the number of bytes in the buffer of subset
+                 states; a state takes k * (1 + lowest # k-sized blocks
+                 s.t. # bits >= # vertices) bytes and the size of a weight
+                 rounded up to a multiple of k, where k = sizeof(size_t);
+                 if budget is less than the size of a state, the buffer
+                 holds one state
+*/
+int tsp_spill(const adj_lst_t *a,
+	      size_t start,
+	      void *dist,
+	      size_t budget,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_lst_view(&w, a);
+  return tsp_spill_view(&w, start, dist, budget, add_wt, cmp_wt);
+}
+
+/**
+   Runs tsp_spill on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_spill.
+*/
+int tsp_spill_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  size_t budget,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *)){
+  adj_view_t w;
+  adj_csr_view(&w, c);
+  return tsp_spill_view(&w, start, dist, budget, add_wt, cmp_wt);
+}
+
+/**
+   Runs the TSP algorithm on a view of an adjacency list. A vertex is a
+   size_t value in the representation of a set.
+*/
+static int tsp_view(const adj_view_t *a,
+		    size_t start,
+		    void *dist,
+		    const tsp_ht_t *tht,
+		    void (*add_wt)(void *, const void *, const void *),
+		    int (*cmp_wt)(const void *, const void *)){
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t wt_size = a->wt_size;
   size_t set_count, set_size;
+  size_t num_vt_wts;
   size_t u, v;
   size_t i;
   size_t *prev_set = NULL;
@@ -135,7 +340,6 @@ int tsp(const adj_lst_t *a,
   boolean_t final_dist_updated = FALSE;
   stack_t prev_s, next_s;
   ht_def_t ht_def;
-  context_t context;
   tsp_ht_t tht_def;
   const tsp_ht_t *thtp = tht;
   set_count = a->num_vts / C_SET_ELT_BIT;
@@ -151,17 +355,26 @@ int tsp(const adj_lst_t *a,
   stack_init(&prev_s, 1, set_size, NULL);
   stack_push(&prev_s, prev_set);
   if (thtp == NULL){
-    context.num_vts = a->num_vts;
+    ht_def.num_vts = a->num_vts; /* sets the count of the default table */
     tht_def.ht = &ht_def;
-    tht_def.context = &context;
-    tht_def.init = (tsp_ht_init)ht_def_init;
-    tht_def.insert = (tsp_ht_insert)ht_def_insert;
-    tht_def.search = (tsp_ht_search)ht_def_search;
-    tht_def.remove = (tsp_ht_remove)ht_def_remove;
-    tht_def.free = (tsp_ht_free)ht_def_free;
+    tht_def.alpha_n = 1;
+    tht_def.log_alpha_d = 0;
+    tht_def.init = ht_def_init;
+    tht_def.insert = ht_def_insert;
+    tht_def.search = ht_def_search;
+    tht_def.remove = ht_def_remove;
+    tht_def.free = ht_def_free;
     thtp = &tht_def;
   }
-  thtp->init(thtp->ht, set_size, wt_size, NULL, thtp->context);
+  thtp->init(thtp->ht,
+	     set_size,
+	     wt_size,
+	     0,
+	     thtp->alpha_n,
+	     thtp->log_alpha_d,
+	     NULL,
+	     NULL,
+	     NULL);
   thtp->insert(thtp->ht, prev_set, dist);
   for (i = 0; i < a->num_vts - 1; i++){
     stack_init(&next_s, 1, set_size, NULL);
@@ -184,14 +397,14 @@ int tsp(const adj_lst_t *a,
   while (prev_s.num_elts > 0){
     stack_pop(&prev_s, prev_set);
     u = prev_set[0];
-    p_start = a->vt_wts[u]->elts;
-    p_end = p_start + a->vt_wts[u]->num_elts * a->pair_size;
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      v = *(const size_t *)p;
+      v = a->read_vt(p);
       if (v == start){
 	add_wt(sum_wt,
 	       thtp->search(thtp->ht, prev_set),
-	       p + a->offset);
+	       p + a->wt_offset);
 	if (!final_dist_updated){
 	  memcpy(dist, sum_wt, wt_size);
 	  final_dist_updated = TRUE;
@@ -212,11 +425,233 @@ int tsp(const adj_lst_t *a,
   return 0;
 }
 
+/**
+   Runs the TSP algorithm on a view of an adjacency list with a dense
+   table. A vertex other than start is represented by an index in
+   [0, n - 1), and the entry of a subset s and a last reached vertex with
+   index j is at s * (n - 1) + j. A subset is only extended to larger
+   subsets, and the entries of a subset are final when it is reached in
+   increasing order.
+*/
+static int tsp_dense_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_end = NULL;
+  size_t wt_size = a->wt_size;
+  size_t m, num_ents, num_bytes, num_vt_wts;
+  size_t s, t, j, k, u, v, ix;
+  unsigned char *present = NULL;
+  char *wts = NULL;
+  void *sum_wt = NULL;
+  boolean_t final_dist_updated = FALSE;
+  memset(dist, 0, wt_size);
+  if (a->num_vts == 1) return 0;
+  num_bytes = tsp_dense_size(a->num_vts, wt_size);
+  if (num_bytes == 0){
+    fprintf_stderr_exit("dense table size is not representable", __LINE__);
+  }
+  m = a->num_vts - 1;
+  num_ents = m * pow_two(m);
+  wts = malloc_perror(1, num_bytes);
+  present = (unsigned char *)wts + num_ents * wt_size;
+  memset(present, 0, num_ents / CHAR_BIT + 1);
+  sum_wt = malloc_perror(1, wt_size);
+  /* paths with a single edge from start */
+  p = a->vt_wts(a->adj, start, &num_vt_wts);
+  p_end = p + num_vt_wts * a->pair_size;
+  for (; p != p_end; p += a->pair_size){
+    v = a->read_vt(p);
+    if (v == start) continue;
+    k = (v < start) ? v : v - 1;
+    ix = pow_two(k) * m + k;
+    if (!(present[ix / CHAR_BIT] & (1U << (ix % CHAR_BIT))) ||
+	cmp_wt(elt_ptr(wts, ix, wt_size), p + a->wt_offset) > 0){
+      memcpy(elt_ptr(wts, ix, wt_size), p + a->wt_offset, wt_size);
+      present[ix / CHAR_BIT] |= 1U << (ix % CHAR_BIT);
+    }
+  }
+  for (s = 1; s < pow_two(m); s++){
+    for (j = 0; j < m; j++){
+      ix = s * m + j;
+      if (!(present[ix / CHAR_BIT] & (1U << (ix % CHAR_BIT)))) continue;
+      u = (j < start) ? j : j + 1;
+      p = a->vt_wts(a->adj, u, &num_vt_wts);
+      p_end = p + num_vt_wts * a->pair_size;
+      for (; p != p_end; p += a->pair_size){
+	v = a->read_vt(p);
+	if (v == start){
+	  if (s != pow_two(m) - 1) continue;
+	  add_wt(sum_wt, elt_ptr(wts, ix, wt_size), p + a->wt_offset);
+	  if (!final_dist_updated || cmp_wt(dist, sum_wt) > 0){
+	    memcpy(dist, sum_wt, wt_size);
+	    final_dist_updated = TRUE;
+	  }
+	  continue;
+	}
+	k = (v < start) ? v : v - 1;
+	if (s & pow_two(k)) continue;
+	t = (s | pow_two(k)) * m + k;
+	add_wt(sum_wt, elt_ptr(wts, ix, wt_size), p + a->wt_offset);
+	if (!(present[t / CHAR_BIT] & (1U << (t % CHAR_BIT))) ||
+	    cmp_wt(elt_ptr(wts, t, wt_size), sum_wt) > 0){
+	  memcpy(elt_ptr(wts, t, wt_size), sum_wt, wt_size);
+	  present[t / CHAR_BIT] |= 1U << (t % CHAR_BIT);
+	}
+      }
+    }
+  }
+  free(wts);
+  free(sum_wt);
+  wts = NULL;
+  present = NULL;
+  sum_wt = NULL;
+  if (!final_dist_updated) return 1;
+  return 0;
+}
+
+/**
+   Runs the TSP algorithm on a view of an adjacency list with a bounded
+   buffer of states. A state is a record with a set as in tsp_view followed
+   by a weight, and a layer is a temporary file of records, sorted by
+   cmp_key and without duplicate sets.
+*/
+static int tsp_spill_view(const adj_view_t *a,
+			  size_t start,
+			  void *dist,
+			  size_t budget,
+			  void (*add_wt)(void *, const void *, const void *),
+			  int (*cmp_wt)(const void *, const void *)){
+  const char *p = NULL, *p_end = NULL;
+  size_t wt_size = a->wt_size;
+  size_t set_count, num_vt_wts, num_layer, num_buf = 0, cap;
+  size_t u, v;
+  size_t i, j;
+  size_t *rec = NULL, *next = NULL;
+  char *buf = NULL;
+  void *prev_wt = NULL, *sum_wt = NULL;
+  boolean_t final_dist_updated = FALSE;
+  FILE *layer = NULL;
+  stack_t runs;
+  spill_t sp;
+  ibit_t ibit;
+  set_count = a->num_vts / C_SET_ELT_BIT;
+  if (a->num_vts % C_SET_ELT_BIT){
+    set_count++;
+  }
+  set_count++; /* + last reached vertex representation */
+  sp.set_count = set_count;
+  sp.set_size = set_count * C_SET_ELT_SIZE;
+  sp.wt_size = wt_size;
+  sp.rec_size = add_sz_perror(sp.set_size,
+			      mul_sz_perror(wt_size / C_SET_ELT_SIZE +
+					    (wt_size % C_SET_ELT_SIZE > 0),
+					    C_SET_ELT_SIZE));
+  sp.wt_a = malloc_perror(1, wt_size);
+  sp.wt_b = malloc_perror(1, wt_size);
+  sp.cmp_wt = cmp_wt;
+  cap = budget / sp.rec_size;
+  if (cap == 0) cap = 1;
+  buf = malloc_perror(cap, sp.rec_size);
+  rec = calloc_perror(1, sp.rec_size);
+  next = malloc_perror(1, sp.rec_size);
+  prev_wt = malloc_perror(1, wt_size);
+  sum_wt = malloc_perror(1, wt_size);
+  memset(dist, 0, wt_size);
+  rec[0] = start;
+  memcpy((char *)rec + sp.set_size, dist, wt_size);
+  layer = tmpfile_perror();
+  fwrite_perror(rec, sp.rec_size, layer);
+  num_layer = 1;
+  stack_init(&runs, 1, sizeof(run_t), NULL);
+  for (i = 0; i < a->num_vts - 1 && num_layer > 0; i++){
+    rewind(layer);
+    for (j = 0; j < num_layer; j++){
+      fread_perror(rec, sp.rec_size, layer);
+      memcpy(prev_wt, (char *)rec + sp.set_size, wt_size);
+      u = rec[0];
+      p = a->vt_wts(a->adj, u, &num_vt_wts);
+      p_end = p + num_vt_wts * a->pair_size;
+      for (; p != p_end; p += a->pair_size){
+	v = a->read_vt(p);
+	set_init(&ibit, v);
+	if (set_member(&ibit, &rec[1]) != NULL) continue;
+	memcpy(next, rec, sp.set_size);
+	next[0] = v;
+	set_init(&ibit, u);
+	set_union(&ibit, &next[1]);
+	add_wt(sum_wt, prev_wt, p + a->wt_offset);
+	memcpy((char *)next + sp.set_size, sum_wt, wt_size);
+	memcpy(elt_ptr(buf, num_buf, sp.rec_size), next, sp.rec_size);
+	num_buf++;
+	if (num_buf == cap){
+	  /* spill if merging duplicates frees less than half of the buffer */
+	  sort_recs(&sp, buf, num_buf, next);
+	  num_buf = uniq_recs(&sp, buf, num_buf);
+	  if (num_buf >= cap - cap / 2){
+	    push_run(&sp, &runs, buf, num_buf);
+	    num_buf = 0;
+	  }
+	}
+      }
+    }
+    fclose(layer);
+    layer = tmpfile_perror();
+    if (runs.num_elts == 0){
+      sort_recs(&sp, buf, num_buf, next);
+      num_layer = uniq_recs(&sp, buf, num_buf);
+      fwrite_perror(buf, num_layer * sp.rec_size, layer);
+    }else{
+      if (num_buf > 0) push_run(&sp, &runs, buf, num_buf);
+      num_layer = merge_runs(&sp, runs.elts, runs.num_elts, layer);
+      runs.num_elts = 0;
+    }
+    num_buf = 0;
+  }
+  /* compute the return to start */
+  if (num_layer > 0) rewind(layer);
+  for (j = 0; j < num_layer; j++){
+    fread_perror(rec, sp.rec_size, layer);
+    memcpy(prev_wt, (char *)rec + sp.set_size, wt_size);
+    p = a->vt_wts(a->adj, rec[0], &num_vt_wts);
+    p_end = p + num_vt_wts * a->pair_size;
+    for (; p != p_end; p += a->pair_size){
+      if (a->read_vt(p) != start) continue;
+      add_wt(sum_wt, prev_wt, p + a->wt_offset);
+      if (!final_dist_updated || cmp_wt(dist, sum_wt) > 0){
+	memcpy(dist, sum_wt, wt_size);
+	final_dist_updated = TRUE;
+      }
+    }
+  }
+  fclose(layer);
+  stack_free(&runs);
+  free(sp.wt_a);
+  free(sp.wt_b);
+  free(buf);
+  free(rec);
+  free(next);
+  free(prev_wt);
+  free(sum_wt);
+  layer = NULL;
+  sp.wt_a = NULL;
+  sp.wt_b = NULL;
+  buf = NULL;
+  rec = NULL;
+  next = NULL;
+  prev_wt = NULL;
+  sum_wt = NULL;
+  if (num_layer == 0) return 1;
+  if (!final_dist_updated && a->num_vts > 1) return 1;
+  return 0;
+}
+
 /**
    Builds reachable sets from previous sets and updates a hash table
    mapping a set to a distance. 
  */
-static void build_next(const adj_lst_t *a,
+static void build_next(const adj_view_t *a,
 		       stack_t *prev_s,
 		       stack_t *next_s,
 		       const tsp_ht_t *tht,
@@ -225,6 +660,7 @@ static void build_next(const adj_lst_t *a,
   const char *p = NULL, *p_start = NULL, *p_end = NULL;
   size_t wt_size = a->wt_size;
   size_t set_size = prev_s->elt_size;
+  size_t num_vt_wts;
   size_t u, v;
   size_t *prev_set = NULL, *next_set = NULL;
   void *prev_wt = NULL, *next_wt = NULL, *sum_wt = NULL;
@@ -237,10 +673,10 @@ static void build_next(const adj_lst_t *a,
     stack_pop(prev_s, prev_set);
     tht->remove(tht->ht, prev_set, prev_wt);
     u = prev_set[0];
-    p_start = a->vt_wts[u]->elts;
-    p_end = p_start + a->vt_wts[u]->num_elts * a->pair_size;
+    p_start = a->vt_wts(a->adj, u, &num_vt_wts);
+    p_end = p_start + num_vt_wts * a->pair_size;
     for (p = p_start; p != p_end; p += a->pair_size){
-      v = *(const size_t *)p;
+      v = a->read_vt(p);
       set_init(&ibit, v);
       if (set_member(&ibit, &prev_set[1]) == NULL){
 	memcpy(next_set, prev_set, set_size);
@@ -249,7 +685,7 @@ static void build_next(const adj_lst_t *a,
 	set_union(&ibit, &next_set[1]);
 	add_wt(sum_wt,
 	       prev_wt,
-	       p + a->offset);
+	       p + a->wt_offset);
 	next_wt = tht->search(tht->ht, next_set);
 	if (next_wt == NULL){
 	  tht->insert(tht->ht, next_set, sum_wt);
@@ -270,6 +706,230 @@ static void build_next(const adj_lst_t *a,
   sum_wt = NULL;
 }
 
+/**
+   Record operations for tsp_spill_view. A record of a state is a set
+   followed by a weight at an offset of set_size bytes. Records are ordered
+   by the set blocks, from the last block to the block of the last reached
+   vertex.
+*/
+
+static int cmp_key(const spill_t *sp, const void *a, const void *b){
+  const size_t *s = a, *t = b;
+  size_t i;
+  for (i = sp->set_count; i-- > 0; ){
+    if (s[i] != t[i]) return (s[i] < t[i]) ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+   Compares the weights of two records; the weights are copied to aligned
+   blocks, because the offset of a weight is a multiple of sizeof(size_t).
+*/
+static int cmp_rec_wt(const spill_t *sp, const void *a, const void *b){
+  memcpy(sp->wt_a, (const char *)a + sp->set_size, sp->wt_size);
+  memcpy(sp->wt_b, (const char *)b + sp->set_size, sp->wt_size);
+  return sp->cmp_wt(sp->wt_a, sp->wt_b);
+}
+
+/**
+   Sorts num records in recs by cmp_key with heapsort in place, where tmp
+   is a block of the size of a record.
+*/
+static void sort_recs(const spill_t *sp, char *recs, size_t num, void *tmp){
+  size_t i;
+  if (num < 2) return;
+  for (i = num / 2; i-- > 0; ){
+    sift_down(sp, recs, i, num, tmp);
+  }
+  for (i = num - 1; i > 0; i--){
+    memcpy(tmp, recs, sp->rec_size);
+    memcpy(recs, elt_ptr(recs, i, sp->rec_size), sp->rec_size);
+    memcpy(elt_ptr(recs, i, sp->rec_size), tmp, sp->rec_size);
+    sift_down(sp, recs, 0, i, tmp);
+  }
+}
+
+static void sift_down(const spill_t *sp,
+		      char *recs,
+		      size_t i,
+		      size_t num,
+		      void *tmp){
+  size_t c;
+  size_t rec_size = sp->rec_size;
+  while ((c = 2 * i + 1) < num){
+    if (c + 1 < num &&
+	cmp_key(sp,
+		elt_ptr(recs, c, rec_size),
+		elt_ptr(recs, c + 1, rec_size)) < 0){
+      c++;
+    }
+    if (cmp_key(sp,
+		elt_ptr(recs, i, rec_size),
+		elt_ptr(recs, c, rec_size)) >= 0){
+      break;
+    }
+    memcpy(tmp, elt_ptr(recs, i, rec_size), rec_size);
+    memcpy(elt_ptr(recs, i, rec_size), elt_ptr(recs, c, rec_size), rec_size);
+    memcpy(elt_ptr(recs, c, rec_size), tmp, rec_size);
+    i = c;
+  }
+}
+
+/**
+   Merges the records with equal sets in num sorted records, keeping the
+   lowest weight, and returns the number of the remaining records.
+*/
+static size_t uniq_recs(const spill_t *sp, char *recs, size_t num){
+  size_t i, k = 0;
+  size_t rec_size = sp->rec_size;
+  if (num == 0) return 0;
+  for (i = 1; i < num; i++){
+    if (cmp_key(sp,
+		elt_ptr(recs, k, rec_size),
+		elt_ptr(recs, i, rec_size)) != 0){
+      k++;
+      if (k != i){
+	memcpy(elt_ptr(recs, k, rec_size),
+	       elt_ptr(recs, i, rec_size),
+	       rec_size);
+      }
+    }else if (cmp_rec_wt(sp,
+			 elt_ptr(recs, k, rec_size),
+			 elt_ptr(recs, i, rec_size)) > 0){
+      memcpy(elt_ptr(recs, k, rec_size),
+	     elt_ptr(recs, i, rec_size),
+	     rec_size);
+    }
+  }
+  return k + 1;
+}
+
+/**
+   Writes num sorted records without duplicate sets to a new run on the
+   stack of runs. If the top C_MERGE_FAN runs were merged the same number
+   of times, they are merged into a single run, which bounds the number of
+   open runs by C_MERGE_FAN - 1 per merge count.
+*/
+static void push_run(const spill_t *sp,
+		     stack_t *runs,
+		     const char *recs,
+		     size_t num){
+  run_t r;
+  run_t *top = NULL;
+  size_t i;
+  r.f = tmpfile_perror();
+  r.num = num;
+  r.level = 0;
+  fwrite_perror(recs, num * sp->rec_size, r.f);
+  stack_push(runs, &r);
+  while (runs->num_elts >= C_MERGE_FAN){
+    top = elt_ptr(runs->elts, runs->num_elts - C_MERGE_FAN, sizeof(run_t));
+    for (i = 1; i < C_MERGE_FAN; i++){
+      if (top[i].level != top[0].level) return;
+    }
+    r.f = tmpfile_perror();
+    r.level = top[0].level + 1;
+    r.num = merge_runs(sp, top, C_MERGE_FAN, r.f);
+    runs->num_elts -= C_MERGE_FAN;
+    stack_push(runs, &r);
+  }
+}
+
+/**
+   Merges num sorted runs without duplicate sets into the file f, keeping
+   the lowest weight for each set, closes the runs, and returns the number
+   of records written to f.
+*/
+static size_t merge_runs(const spill_t *sp,
+			 run_t *runs,
+			 size_t num,
+			 FILE *f){
+  size_t i, min;
+  size_t ret = 0;
+  size_t rec_size = sp->rec_size;
+  boolean_t pend_present = FALSE;
+  char *heads = NULL;
+  void *pend = NULL;
+  heads = malloc_perror(num, rec_size);
+  pend = malloc_perror(1, rec_size);
+  for (i = 0; i < num; i++){
+    rewind(runs[i].f);
+    if (runs[i].num > 0){
+      fread_perror(elt_ptr(heads, i, rec_size), rec_size, runs[i].f);
+    }
+  }
+  while (TRUE){
+    min = num;
+    for (i = 0; i < num; i++){
+      if (runs[i].num > 0 &&
+	  (min == num ||
+	   cmp_key(sp,
+		   elt_ptr(heads, i, rec_size),
+		   elt_ptr(heads, min, rec_size)) < 0)){
+	min = i;
+      }
+    }
+    if (min == num) break;
+    if (pend_present && cmp_key(sp, pend, elt_ptr(heads, min, rec_size)) == 0){
+      if (cmp_rec_wt(sp, pend, elt_ptr(heads, min, rec_size)) > 0){
+	memcpy(pend, elt_ptr(heads, min, rec_size), rec_size);
+      }
+    }else{
+      if (pend_present){
+	fwrite_perror(pend, rec_size, f);
+	ret++;
+      }
+      memcpy(pend, elt_ptr(heads, min, rec_size), rec_size);
+      pend_present = TRUE;
+    }
+    runs[min].num--;
+    if (runs[min].num > 0){
+      fread_perror(elt_ptr(heads, min, rec_size), rec_size, runs[min].f);
+    }
+  }
+  if (pend_present){
+    fwrite_perror(pend, rec_size, f);
+    ret++;
+  }
+  for (i = 0; i < num; i++){
+    fclose(runs[i].f);
+    runs[i].f = NULL;
+  }
+  free(heads);
+  free(pend);
+  heads = NULL;
+  pend = NULL;
+  return ret;
+}
+
+/**
+   Temporary file operations.
+*/
+
+static FILE *tmpfile_perror(void){
+  FILE *f = tmpfile();
+  if (f == NULL){
+    perror("tsp temporary file creation failed");
+    exit(EXIT_FAILURE);
+  }
+  return f;
+}
+
+static void fwrite_perror(const void *s, size_t size, FILE *f){
+  if (size > 0 && fwrite(s, 1, size, f) != size){
+    perror("tsp temporary file write failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void fread_perror(void *s, size_t size, FILE *f){
+  if (size > 0 && fread(s, 1, size, f) != size){
+    perror("tsp temporary file read failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
 /**
    Set operations based on a bit array representation.
 */
@@ -296,64 +956,80 @@ static void set_union(const ibit_t *ibit, size_t *set){
    Default hash table operations.
 */
 
-static void ht_def_init(ht_def_t *ht,
+static void ht_def_init(void *ht,
 			size_t key_size,
 			size_t elt_size,
-			void (*free_elt)(void *),
-			void *context){
-  context_t *c = context;
-  if (c->num_vts >= C_SET_ELT_BIT){
+			size_t min_num,
+			size_t alpha_n,
+			size_t log_alpha_d,
+			int (*cmp_key)(const void *, const void *),
+			size_t (*rdc_key)(const void *, size_t),
+			void (*free_elt)(void *)){
+  ht_def_t *htd = ht; /* num_vts is set before initialization */
+  if (htd->num_vts >= C_SET_ELT_BIT){
     fprintf_stderr_exit("default hash table allocation failed", __LINE__);
   }
-  ht->key_size = key_size;
-  ht->elt_size = elt_size;
-  ht->num_vts = c->num_vts;
-  ht->key_present = calloc_perror(mul_sz_perror(c->num_vts,
-						pow_two(c->num_vts)),
-				  sizeof(boolean_t));
-  ht->elts = malloc_perror(mul_sz_perror(c->num_vts, pow_two(c->num_vts)),
-			   elt_size);
-  ht->free_elt = free_elt;
-}
-
-static void ht_def_insert(ht_def_t *ht, const size_t *key, const void *elt){
-  size_t ix = key[0] + ht->num_vts * key[1];
-  ht->key_present[ix] = TRUE;
-  memcpy(elt_ptr(ht->elts, ix, ht->elt_size),
+  htd->key_size = key_size;
+  htd->elt_size = elt_size;
+  htd->key_present = calloc_perror(mul_sz_perror(htd->num_vts,
+						 pow_two(htd->num_vts)),
+				   sizeof(boolean_t));
+  htd->elts = malloc_perror(mul_sz_perror(htd->num_vts,
+					  pow_two(htd->num_vts)),
+			    elt_size);
+  htd->free_elt = free_elt;
+  (void)min_num;
+  (void)alpha_n;
+  (void)log_alpha_d;
+  (void)cmp_key;
+  (void)rdc_key;
+}
+
+static void ht_def_insert(void *ht, const void *key, const void *elt){
+  ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  htd->key_present[ix] = TRUE;
+  memcpy(elt_ptr(htd->elts, ix, htd->elt_size),
 	 elt,
-	 ht->elt_size);
+	 htd->elt_size);
 }
 
-static void *ht_def_search(const ht_def_t *ht, const size_t *key){
-  size_t ix = key[0] + ht->num_vts * key[1];
-  if (ht->key_present[ix]){
-    return elt_ptr(ht->elts, ix, ht->elt_size);
+static void *ht_def_search(const void *ht, const void *key){
+  const ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  if (htd->key_present[ix]){
+    return elt_ptr(htd->elts, ix, htd->elt_size);
   }else{
     return NULL;
   }
 }
 
-static void ht_def_remove(ht_def_t *ht, const size_t *key, void *elt){
-  size_t ix = key[0] + ht->num_vts * key[1];
-  ht->key_present[ix] = FALSE;
+static void ht_def_remove(void *ht, const void *key, void *elt){
+  ht_def_t *htd = ht;
+  const size_t *k = key;
+  size_t ix = k[0] + htd->num_vts * k[1];
+  htd->key_present[ix] = FALSE;
   memcpy(elt,
-	 elt_ptr(ht->elts, ix, ht->elt_size),
-	 ht->elt_size);
+	 elt_ptr(htd->elts, ix, htd->elt_size),
+	 htd->elt_size);
 }
 
-static void ht_def_free(ht_def_t *ht){
+static void ht_def_free(void *ht){
   size_t i;
-  if (ht->free_elt != NULL){
-    for (i = 0; i < ht->num_vts * pow_two(ht->num_vts); i++){
-      if (ht->key_present[i]){
-	ht->free_elt(elt_ptr(ht->elts, i, ht->elt_size));
+  ht_def_t *htd = ht;
+  if (htd->free_elt != NULL){
+    for (i = 0; i < htd->num_vts * pow_two(htd->num_vts); i++){
+      if (htd->key_present[i]){
+	htd->free_elt(elt_ptr(htd->elts, i, htd->elt_size));
       }
     }
   }
-  free(ht->key_present);
-  free(ht->elts);
-  ht->key_present = NULL;
-  ht->elts = NULL;
+  free(htd->key_present);
+  free(htd->elts);
+  htd->key_present = NULL;
+  htd->elts = NULL;
 }
 
 /**
@@ -26,6 +26,24 @@
    provide speed advantages by avoiding the computation of hash values. If V
    is larger and the graph is sparse, a non-default hash table may provide
    space advantages.
+
+   For small V, tsp_dense and tsp_dense_csr run the algorithm on a dense
+   table indexed by the subset of the vertices other than start and by the
+   last reached vertex, where subsets are processed in increasing order of
+   their representations as integers. The table contains no set keys and
+   no hash values, presence is a single bit per entry, and a weight
+   occupies wt_size bytes without padding. tsp_dense_size provides the
+   size of the table before it is allocated.
+
+   tsp_spill and tsp_spill_csr keep in memory only a buffer of subset states
+   of a bounded size in bytes. A layer of the states of the subsets of the
+   same size is streamed from a temporary file sorted by the subset and the
+   last reached vertex, and the next layer is generated into the buffer,
+   sorted and merged with the buffer contents when the buffer is full, and
+   spilled to sorted temporary runs that are merged into the next layer
+   file. Only the states of two consecutive layers are present at a time,
+   and a smaller memory budget leads to more runs and merges instead of an
+   allocation failure.
 */
 
 #ifndef TSP_H  
@@ -34,24 +52,25 @@
 #include <stddef.h>
 #include "graph.h"
 
-typedef void (*tsp_ht_init)(void *,
-			    size_t,
-			    size_t,
-			    void (*)(void *), /* free_elt */
-			    void *); /* pointer to context */
-typedef void (*tsp_ht_insert)(void *, const void *, const void *);
-typedef void *(*tsp_ht_search)(const void *, const void *);
-typedef void (*tsp_ht_remove)(void *, const void *, void *);
-typedef void (*tsp_ht_free)(void *);
-
 typedef struct{
-  void *ht; /* points to a block of hash table struct size */
-  void *context; /* points to initialization context */
-  tsp_ht_init init;
-  tsp_ht_insert insert;
-  tsp_ht_search search;
-  tsp_ht_remove remove;
-  tsp_ht_free free;
+  void *ht; /* points to a preallocated hash table struct */
+  size_t alpha_n; /* load factor upper bound used by tsp to initialize */
+  size_t log_alpha_d; /* the hash table */
+
+  /* pointers to hash table op helpers, pre-defined in each hash table */
+  void (*init)(void *,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       size_t,
+	       int (*)(const void *, const void *),
+	       size_t (*)(const void *, size_t),
+	       void (*)(void *));
+  void (*insert)(void *, const void *, const void *);
+  void *(*search)(const void *, const void *);
+  void (*remove)(void *, const void *, void *);
+  void (*free)(void *);
 } tsp_ht_t;
 
 /**
@@ -91,4 +110,87 @@ int tsp(const adj_lst_t *a,
 	const tsp_ht_t *tht,
 	void (*add_wt)(void *, const void *, const void *),
 	int (*cmp_wt)(const void *, const void *));
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from 
+   start to start across all vertices without revisiting, if a tour exists,
+   given a compressed sparse row (CSR) adjacency list. Returns 0 if a tour
+   exists, otherwise returns 1. Please see the parameter specification in
+   tsp.
+   c           : pointer to a CSR adjacency list with at least one vertex
+*/
+int tsp_csr(const adj_csr_t *c,
+	    size_t start,
+	    void *dist,
+	    const tsp_ht_t *tht,
+	    void (*add_wt)(void *, const void *, const void *),
+	    int (*cmp_wt)(const void *, const void *));
+
+/**
+   Returns the number of bytes allocated by tsp_dense and tsp_dense_csr on
+   a graph with num_vts vertices and weights of size wt_size, which is
+   (n - 1) * 2^(n - 1) * wt_size plus one bit per entry rounded up to
+   bytes, where n is the number of vertices, or 0 if the number of bytes
+   is not representable as size_t.
+*/
+size_t tsp_dense_size(size_t num_vts, size_t wt_size);
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with a dense table. Returns 0 if a tour exists, otherwise returns 1. The
+   table is allocated in a single block of tsp_dense_size(n, wt_size)
+   bytes, where n is the number of vertices; if tsp_dense_size returns 0
+   or the allocation fails, the program terminates with an error message.
+   Please see the parameter specification in tsp.
+*/
+int tsp_dense(const adj_lst_t *a,
+	      size_t start,
+	      void *dist,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs tsp_dense on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_dense.
+*/
+int tsp_dense_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *));
+
+/**
+   Copies to the block pointed to by dist the shortest tour length from
+   start to start across all vertices without revisiting, if a tour exists,
+   with a bounded memory budget for subset states and temporary files for
+   the layers that do not fit in memory. Returns 0 if a tour exists,
+   otherwise returns 1. If a temporary file cannot be created, read, or
+   written, the program terminates with an error message. Please see the
+   parameter specification in tsp.
+   budget      : upper bound on the number of bytes in the buffer of subset
+                 states; a state takes k * (1 + lowest # k-sized blocks
+                 s.t. # bits >= # vertices) bytes and the size of a weight
+                 rounded up to a multiple of k, where k = sizeof(size_t);
+                 if budget is less than the size of a state, the buffer
+                 holds one state
+*/
+int tsp_spill(const adj_lst_t *a,
+	      size_t start,
+	      void *dist,
+	      size_t budget,
+	      void (*add_wt)(void *, const void *, const void *),
+	      int (*cmp_wt)(const void *, const void *));
+
+/**
+   Runs tsp_spill on a compressed sparse row (CSR) adjacency list. Please
+   see the parameter specification in tsp_spill.
+*/
+int tsp_spill_csr(const adj_csr_t *c,
+		  size_t start,
+		  void *dist,
+		  size_t budget,
+		  void (*add_wt)(void *, const void *, const void *),
+		  int (*cmp_wt)(const void *, const void *));
+
 #endif
@@ -2,7 +2,8 @@
    mergesort-pthread-test.c
 
    Optimization and correctness tests of a generic merge sort algorithm with
-   parallel sorting and parallel merging.
+   parallel sorting and parallel merging, with a thread for each recursive
+   call and with a reusable thread pool.
 
    The following command line arguments can be used to customize tests:
    mergesort-pthread-test
@@ -16,12 +17,16 @@
       [0, 1] : int performance test on/off
       [0, 1] : double corner test on/off
       [0, 1] : double performance test on/off
+      [0, 1] : radix sort test on/off
+      [0, 1] : corank on/off
 
    usage examples: 
    ./mergesort-pthread-test
    ./mergesort-pthread-test 17 17
    ./mergesort-pthread-test 20 20 15 20 15 20
    ./mergesort-pthread-test 20 20 15 20 15 20 0 1 0 1
+   ./mergesort-pthread-test 20 20 15 15 15 15 0 0 0 0 1
+   ./mergesort-pthread-test 20 20 15 15 15 15 0 0 0 0 0 1
 
    mergesort-pthread-test can be run with any subset of command line
    arguments in the above-defined order. If the (i + 1)th argument is
@@ -44,6 +49,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include "mergesort-pthread.h"
+#include "pool-pthread.h"
 #include "utilities-mem.h"
 #include "utilities-mod.h"
 
@@ -71,9 +77,11 @@ const char *C_USAGE =
   "[0, 1] : int corner test on/off \n"
   "[0, 1] : int performance test on/off \n"
   "[0, 1] : double corner test on/off \n"
-  "[0, 1] : double performance test on/off \n";
-const int C_ARGC_MAX = 11;
-const size_t C_ARGS_DEF[10] = {15, 15, 10, 15, 10, 15, 1, 1, 1, 1};
+  "[0, 1] : double performance test on/off \n"
+  "[0, 1] : radix sort test on/off \n"
+  "[0, 1] : corank on/off \n";
+const int C_ARGC_MAX = 13;
+const size_t C_ARGS_DEF[12] = {15, 15, 10, 15, 10, 15, 1, 1, 1, 1, 1, 1};
 const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
 
 /* corner cases */
@@ -88,6 +96,24 @@ const double C_HALF_PROB = 0.5;
 /* performance tests */
 const size_t C_TRIALS = 5;
 
+/* pool tests */
+const size_t C_POOL_NUM_THREADS = 4;
+
+/* radix sort tests */
+const size_t C_RADIX_THREADS_LOG_MAX = 2;
+const size_t C_BYTE_MASK = 255;
+const size_t C_BYTE_BIT = 8;
+
+/* co-ranking merge tests */
+const size_t C_CORANK_THREADS_MAX = 9;
+const size_t C_CORANK_THREADS_LOG_MAX = 3;
+const size_t C_CORANK_MOD = 4; /* mod of keys with ties */
+
+typedef struct{
+  size_t key;
+  size_t id;
+} rec_t;
+
 double timer();
 void print_uint_elts(const size_t *a, size_t count);
 void print_test_result(int res);
@@ -102,6 +128,26 @@ int cmp_int(const void *a, const void *b){
   }
 }
 
+int cmp_uint(const void *a, const void *b){
+  if (*(size_t *)a > *(size_t *)b){
+    return 1;
+  }else if  (*(size_t *)a < *(size_t *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
+int cmp_unsigned(const void *a, const void *b){
+  if (*(unsigned int *)a > *(unsigned int *)b){
+    return 1;
+  }else if  (*(unsigned int *)a < *(unsigned int *)b){
+    return -1;
+  }else{
+    return 0;
+  }
+}
+
 int cmp_double(const void *a, const void *b){
   if (*(double *)a > *(double *)b){
     return 1;
@@ -117,12 +163,15 @@ int cmp_double(const void *a, const void *b){
 */
 void run_int_corner_test(){
   int res = 1;
-  int *arr_a = NULL, *arr_b = NULL;
+  int *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
   size_t count, sb, mb;
   size_t i, j;
   size_t elt_size =  sizeof(int);
+  pool_t pool;
   arr_a =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
   arr_b =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
+  arr_c =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
+  pool_init(&pool, C_POOL_NUM_THREADS);
   printf("Test mergesort_pthread on corner cases on random "
 	 "integer arrays\n");
   for (count = 1; count <= C_CORNER_COUNT_MAX; count++){
@@ -133,10 +182,13 @@ void run_int_corner_test(){
 	    arr_a[j] = (DRAND() < C_HALF_PROB ? -1 : 1) * RANDOM();
 	  }
 	  memcpy(arr_b, arr_a, count * elt_size);
+	  memcpy(arr_c, arr_a, count * elt_size);
 	  mergesort_pthread(arr_a, count, elt_size, sb, mb, cmp_int);
+	  mergesort_pthread_pool(&pool, arr_c, count, elt_size, sb, mb,
+				 cmp_int);
 	  qsort(arr_b, count, elt_size, cmp_int);
 	  for (j = 0; j < count; j++){
-	    res *= (arr_a[j] == arr_b[j]);
+	    res *= (arr_a[j] == arr_b[j] && arr_c[j] == arr_b[j]);
 	  }
 	}
       }
@@ -144,10 +196,13 @@ void run_int_corner_test(){
   }
   printf("\tcorrectness:       ");
   print_test_result(res);
+  pool_free(&pool);
   free(arr_a);
   free(arr_b);
+  free(arr_c);
   arr_a = NULL;
   arr_b = NULL;
+  arr_c = NULL;
 }
 
 /**
@@ -161,14 +216,17 @@ void run_int_opt_test(int pow_count_start,
 		      int pow_mbase_start,
 		      int pow_mbase_end){
   int res = 1;
-  int *arr_a = NULL, *arr_b = NULL;
+  int *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
   int ci, si, mi;
   size_t count, sbase, mbase;
   size_t i, j;
   size_t elt_size = sizeof(int);
-  double tot_m, tot_q, t_m, t_q;
+  double tot_m, tot_p, tot_q, t_m, t_p, t_q;
+  pool_t pool;
   arr_a =  malloc_perror(pow_two(pow_count_end), elt_size);
   arr_b =  malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_c =  malloc_perror(pow_two(pow_count_end), elt_size);
+  pool_init(&pool, C_POOL_NUM_THREADS);
   printf("Test mergesort_pthread performance on random integer arrays\n");
   for (ci = pow_count_start; ci <= pow_count_end; ci++){
     count = pow_two(ci); /* > 0 */
@@ -181,26 +239,35 @@ void run_int_opt_test(int pow_count_start,
 	mbase = pow_two(mi);
 	printf("\t\t\tmerge base count: %lu\n", TOLU(mbase));
 	tot_m = 0.0;
+	tot_p = 0.0;
 	tot_q = 0.0;
 	for(i = 0; i < C_TRIALS; i++){
 	  for (j = 0; j < count; j++){
 	    arr_a[j] = (DRAND() < C_HALF_PROB ? -1 : 1) * RANDOM();
 	  }
 	  memcpy(arr_b, arr_a, count * elt_size);
+	  memcpy(arr_c, arr_a, count * elt_size);
 	  t_m = timer();
 	  mergesort_pthread(arr_a, count, elt_size, sbase, mbase, cmp_int);
 	  t_m = timer() - t_m;
+	  t_p = timer();
+	  mergesort_pthread_pool(&pool, arr_c, count, elt_size, sbase, mbase,
+				 cmp_int);
+	  t_p = timer() - t_p;
 	  t_q = timer();
 	  qsort(arr_b, count, elt_size, cmp_int);
 	  t_q = timer() - t_q;
 	  tot_m += t_m;
+	  tot_p += t_p;
 	  tot_q += t_q;
 	  for (j = 0; j < count; j++){
-	    res *= (arr_a[j] == arr_b[j]);
+	    res *= (arr_a[j] == arr_b[j] && arr_c[j] == arr_b[j]);
 	  }
 	}
 	printf("\t\t\tave pthread mergesort: %.6f seconds\n",
 	       tot_m / C_TRIALS);
+	printf("\t\t\tave pool mergesort:    %.6f seconds\n",
+	       tot_p / C_TRIALS);
 	printf("\t\t\tave qsort:             %.6f seconds\n",
 	       tot_q / C_TRIALS);
 	printf("\t\t\tcorrectness:           ");
@@ -208,10 +275,13 @@ void run_int_opt_test(int pow_count_start,
       }
     }
   }
+  pool_free(&pool);
   free(arr_a);
   free(arr_b);
+  free(arr_c);
   arr_a = NULL;
   arr_b = NULL;
+  arr_c = NULL;
 }
 
 /**
@@ -222,9 +292,12 @@ void run_double_corner_test(){
   size_t count, sb, mb;
   size_t i, j;
   size_t elt_size =  sizeof(double);
-  double *arr_a = NULL, *arr_b = NULL;
+  double *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
+  pool_t pool;
   arr_a =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
   arr_b =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
+  arr_c =  malloc_perror(C_CORNER_COUNT_MAX, elt_size);
+  pool_init(&pool, C_POOL_NUM_THREADS);
   printf("Test mergesort_pthread on corner cases on random "
 	 "double arrays\n");
   for (count = 1; count <= C_CORNER_COUNT_MAX; count++){
@@ -235,10 +308,13 @@ void run_double_corner_test(){
 	    arr_a[j] = (DRAND() < C_HALF_PROB ? -1 : 1) * DRAND();
 	  }
 	  memcpy(arr_b, arr_a, count * elt_size);
+	  memcpy(arr_c, arr_a, count * elt_size);
 	  mergesort_pthread(arr_a, count, elt_size, sb, mb, cmp_double);
+	  mergesort_pthread_pool(&pool, arr_c, count, elt_size, sb, mb,
+				 cmp_double);
 	  qsort(arr_b, count, elt_size, cmp_double);
 	  for (j = 0; j < count; j++){
-	    res *= (arr_a[j] == arr_b[j]);
+	    res *= (arr_a[j] == arr_b[j] && arr_c[j] == arr_b[j]);
 	  }
 	}
       }
@@ -246,10 +322,13 @@ void run_double_corner_test(){
   }
   printf("\tcorrectness:       ");
   print_test_result(res);
+  pool_free(&pool);
   free(arr_a);
   free(arr_b);
+  free(arr_c);
   arr_a = NULL;
   arr_b = NULL;
+  arr_c = NULL;
 }
 
 /**
@@ -267,10 +346,13 @@ void run_double_opt_test(int pow_count_start,
   size_t count, sbase, mbase;
   size_t i, j;
   size_t elt_size = sizeof(double);
-  double *arr_a = NULL, *arr_b = NULL;
-  double tot_m, tot_q, t_m, t_q;
+  double *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
+  double tot_m, tot_p, tot_q, t_m, t_p, t_q;
+  pool_t pool;
   arr_a =  malloc_perror(pow_two(pow_count_end), elt_size);
   arr_b =  malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_c =  malloc_perror(pow_two(pow_count_end), elt_size);
+  pool_init(&pool, C_POOL_NUM_THREADS);
   printf("Test mergesort_pthread performance on random double arrays\n");
   for (ci = pow_count_start; ci <= pow_count_end; ci++){
     count = pow_two(ci); /* > 0 */
@@ -283,26 +365,35 @@ void run_double_opt_test(int pow_count_start,
 	mbase = pow_two(mi);
 	printf("\t\t\tmerge base count: %lu\n", TOLU(mbase));
 	tot_m = 0.0;
+	tot_p = 0.0;
 	tot_q = 0.0;
 	for(i = 0; i < C_TRIALS; i++){
 	  for (j = 0; j < count; j++){
 	    arr_a[j] = (DRAND() < C_HALF_PROB ? -1 : 1) * DRAND();
 	  }
 	  memcpy(arr_b, arr_a, count * elt_size);
+	  memcpy(arr_c, arr_a, count * elt_size);
 	  t_m = timer();
 	  mergesort_pthread(arr_a, count, elt_size, sbase, mbase, cmp_double);
 	  t_m = timer() - t_m;
+	  t_p = timer();
+	  mergesort_pthread_pool(&pool, arr_c, count, elt_size, sbase, mbase,
+				 cmp_double);
+	  t_p = timer() - t_p;
 	  t_q = timer();
 	  qsort(arr_b, count, elt_size, cmp_double);
 	  t_q = timer() - t_q;
 	  tot_m += t_m;
+	  tot_p += t_p;
 	  tot_q += t_q;
 	  for (j = 0; j < count; j++){
-	    res *= (arr_a[j] == arr_b[j]);
+	    res *= (arr_a[j] == arr_b[j] && arr_c[j] == arr_b[j]);
 	  }
 	}
 	printf("\t\t\tave pthread mergesort: %.6f seconds\n",
 	       tot_m / C_TRIALS);
+	printf("\t\t\tave pool mergesort:    %.6f seconds\n",
+	       tot_p / C_TRIALS);
 	printf("\t\t\tave qsort:             %.6f seconds\n",
 	       tot_q / C_TRIALS);
 	printf("\t\t\tcorrectness:           ");
@@ -310,10 +401,275 @@ void run_double_opt_test(int pow_count_start,
       }
     }
   }
+  pool_free(&pool);
+  free(arr_a);
+  free(arr_b);
+  free(arr_c);
+  arr_a = NULL;
+  arr_b = NULL;
+  arr_c = NULL;
+}
+
+/**
+   Fill an array with random keys for radix sort tests.
+*/
+
+void fill_uint(void *elts, size_t i){
+  size_t j;
+  size_t k = 0;
+  for (j = 0; j < sizeof(size_t); j++){
+    k = (k << C_BYTE_BIT) | (RANDOM() & C_BYTE_MASK);
+  }
+  *((size_t *)elts + i) = k;
+}
+
+void fill_uint_low(void *elts, size_t i){
+  *((size_t *)elts + i) = RANDOM() & C_BYTE_MASK;
+}
+
+void fill_unsigned(void *elts, size_t i){
+  size_t j;
+  unsigned int k = 0;
+  for (j = 0; j < sizeof(unsigned int); j++){
+    k = (k << C_BYTE_BIT) | (RANDOM() & C_BYTE_MASK);
+  }
+  *((unsigned int *)elts + i) = k;
+}
+
+void fill_double(void *elts, size_t i){
+  *((double *)elts + i) =
+    (DRAND() < C_HALF_PROB ? -1 : 1) * DRAND() * RANDOM();
+}
+
+void fill_rec(void *elts, size_t i){
+  rec_t *r = (rec_t *)elts + i;
+  fill_uint(&r->key, 0);
+  r->id = i;
+}
+
+/**
+   Runs corner case and performance tests of mergesort_pthread_radix with
+   one key type across thread counts, in comparison to qsort and
+   mergesort_pthread with the smallest sort and merge base case bounds.
+*/
+void run_radix_type_test(int pow_count_start,
+			 int pow_count_end,
+			 int pow_sbase,
+			 int pow_mbase,
+			 size_t elt_size,
+			 size_t key_size,
+			 int key_type,
+			 void (*fill)(void *, size_t),
+			 int (*cmp)(const void *, const void *),
+			 const char *type_string){
+  int res = 1;
+  int ci;
+  int is_key = (key_size == sizeof(size_t) ||
+		key_type == MERGESORT_PTHREAD_KEY_DOUBLE);
+  size_t count, num_threads, sbase, mbase;
+  size_t i, j, k;
+  char *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
+  double t_m, t_q, t_r;
+  arr_a = malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_b = malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_c = malloc_perror(pow_two(pow_count_end), elt_size);
+  printf("Test mergesort_pthread_radix and mergesort_pthread_key on %s "
+	 "keys\n", type_string);
+  for (count = 1; count <= C_CORNER_COUNT_MAX; count++){
+    for (k = 0; k <= C_RADIX_THREADS_LOG_MAX; k++){
+      for (i = 0; i < C_CORNER_TRIALS; i++){
+	for (j = 0; j < count; j++){
+	  fill(arr_a, j);
+	}
+	memcpy(arr_b, arr_a, count * elt_size);
+	mergesort_pthread_radix(arr_a, count, elt_size, key_size, key_type,
+				pow_two(k));
+	qsort(arr_b, count, elt_size, cmp);
+	for (j = 0; j < count; j++){
+	  res *= (cmp(arr_a + j * elt_size, arr_b + j * elt_size) == 0);
+	}
+      }
+    }
+  }
+  if (is_key){
+    for (count = 1; count <= C_CORNER_COUNT_MAX; count++){
+      for (sbase = C_CORNER_SBASE_START; sbase <= count; sbase++){
+	for (mbase = C_CORNER_MBASE_START; mbase <= count + 1; mbase++){
+	  for (j = 0; j < count; j++){
+	    fill(arr_a, j);
+	  }
+	  memcpy(arr_b, arr_a, count * elt_size);
+	  mergesort_pthread_key(arr_a, count, elt_size, sbase, mbase,
+				key_type);
+	  qsort(arr_b, count, elt_size, cmp);
+	  for (j = 0; j < count; j++){
+	    res *= (cmp(arr_a + j * elt_size, arr_b + j * elt_size) == 0);
+	  }
+	}
+      }
+    }
+  }
+  printf("\tcorner cases correctness: ");
+  print_test_result(res);
+  for (ci = pow_count_start; ci <= pow_count_end; ci++){
+    count = pow_two(ci); /* > 0 */
+    printf("\tarray count: %lu\n", TOLU(count));
+    for (j = 0; j < count; j++){
+      fill(arr_a, j);
+    }
+    memcpy(arr_b, arr_a, count * elt_size);
+    memcpy(arr_c, arr_a, count * elt_size);
+    t_q = timer();
+    qsort(arr_b, count, elt_size, cmp);
+    t_q = timer() - t_q;
+    t_m = timer();
+    mergesort_pthread(arr_c, count, elt_size,
+		      pow_two(pow_sbase), pow_two(pow_mbase), cmp);
+    t_m = timer() - t_m;
+    printf("\t\tqsort:                   %.6f seconds\n", t_q);
+    printf("\t\tpthread mergesort:       %.6f seconds\n", t_m);
+    if (is_key){
+      memcpy(arr_c, arr_a, count * elt_size);
+      t_m = timer();
+      mergesort_pthread_key(arr_c, count, elt_size,
+			    pow_two(pow_sbase), pow_two(pow_mbase), key_type);
+      t_m = timer() - t_m;
+      for (j = 0; j < count; j++){
+	res *= (cmp(arr_c + j * elt_size, arr_b + j * elt_size) == 0);
+      }
+      printf("\t\tpthread mergesort, key:  %.6f seconds\n", t_m);
+    }
+    for (k = 0; k <= C_RADIX_THREADS_LOG_MAX; k++){
+      num_threads = pow_two(k);
+      memcpy(arr_c, arr_a, count * elt_size);
+      t_r = timer();
+      mergesort_pthread_radix(arr_c, count, elt_size, key_size, key_type,
+			      num_threads);
+      t_r = timer() - t_r;
+      for (j = 0; j < count; j++){
+	res *= (cmp(arr_c + j * elt_size, arr_b + j * elt_size) == 0);
+      }
+      printf("\t\tradix sort, %lu threads:  %.6f seconds\n",
+	     TOLU(num_threads), t_r);
+    }
+    printf("\t\tcorrectness:             ");
+    print_test_result(res);
+  }
+  free(arr_a);
+  free(arr_b);
+  free(arr_c);
+  arr_a = NULL;
+  arr_b = NULL;
+  arr_c = NULL;
+}
+
+void run_radix_test(int pow_count_start,
+		    int pow_count_end,
+		    int pow_sbase,
+		    int pow_mbase){
+  run_radix_type_test(pow_count_start, pow_count_end, pow_sbase, pow_mbase,
+		      sizeof(size_t), sizeof(size_t),
+		      MERGESORT_PTHREAD_KEY_UINT, fill_uint, cmp_uint,
+		      "size_t");
+  run_radix_type_test(pow_count_start, pow_count_end, pow_sbase, pow_mbase,
+		      sizeof(size_t), sizeof(size_t),
+		      MERGESORT_PTHREAD_KEY_UINT, fill_uint_low, cmp_uint,
+		      "size_t in [0, 255]");
+  run_radix_type_test(pow_count_start, pow_count_end, pow_sbase, pow_mbase,
+		      sizeof(double), sizeof(double),
+		      MERGESORT_PTHREAD_KEY_DOUBLE, fill_double, cmp_double,
+		      "double");
+  run_radix_type_test(pow_count_start, pow_count_end, pow_sbase, pow_mbase,
+		      sizeof(unsigned int), sizeof(unsigned int),
+		      MERGESORT_PTHREAD_KEY_UINT, fill_unsigned, cmp_unsigned,
+		      "unsigned int");
+  run_radix_type_test(pow_count_start, pow_count_end, pow_sbase, pow_mbase,
+		      sizeof(rec_t), sizeof(size_t),
+		      MERGESORT_PTHREAD_KEY_UINT, fill_rec, cmp_uint,
+		      "size_t record");
+}
+
+/**
+   Runs a test of mergesort_pthread_corank on random integer arrays with
+   and without ties, across numbers of threads that are and are not
+   powers of two, and compares its performance with mergesort_pthread
+   and qsort.
+*/
+void run_corank_test(int pow_count_start,
+		     int pow_count_end,
+		     int pow_sbase,
+		     int pow_mbase){
+  int res = 1;
+  int ci;
+  int *arr_a = NULL, *arr_b = NULL, *arr_c = NULL;
+  size_t count, num_threads;
+  size_t i, j, k;
+  size_t elt_size = sizeof(int);
+  double t_c, t_m, t_q;
+  arr_a = malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_b = malloc_perror(pow_two(pow_count_end), elt_size);
+  arr_c = malloc_perror(pow_two(pow_count_end), elt_size);
+  printf("Test mergesort_pthread_corank on random integer arrays\n");
+  for (count = 1; count <= C_CORNER_COUNT_MAX; count++){
+    for (num_threads = 1; num_threads <= C_CORANK_THREADS_MAX; num_threads++){
+      for (i = 0; i < C_CORNER_TRIALS; i++){
+	for (j = 0; j < count; j++){
+	  arr_a[j] = (i % 2) ? (int)(RANDOM() % C_CORANK_MOD) : RANDOM();
+	}
+	memcpy(arr_b, arr_a, count * elt_size);
+	mergesort_pthread_corank(arr_a, count, elt_size, num_threads,
+				 cmp_int);
+	qsort(arr_b, count, elt_size, cmp_int);
+	for (j = 0; j < count; j++){
+	  res *= (arr_a[j] == arr_b[j]);
+	}
+      }
+    }
+  }
+  printf("\tcorner cases correctness: ");
+  print_test_result(res);
+  for (ci = pow_count_start; ci <= pow_count_end; ci++){
+    count = pow_two(ci); /* > 0 */
+    printf("\tarray count: %lu\n", TOLU(count));
+    for (j = 0; j < count; j++){
+      arr_a[j] = (DRAND() < C_HALF_PROB ? -1 : 1) * RANDOM();
+    }
+    memcpy(arr_b, arr_a, count * elt_size);
+    memcpy(arr_c, arr_a, count * elt_size);
+    t_q = timer();
+    qsort(arr_b, count, elt_size, cmp_int);
+    t_q = timer() - t_q;
+    t_m = timer();
+    mergesort_pthread(arr_c, count, elt_size,
+		      pow_two(pow_sbase), pow_two(pow_mbase), cmp_int);
+    t_m = timer() - t_m;
+    for (j = 0; j < count; j++){
+      res *= (arr_c[j] == arr_b[j]);
+    }
+    printf("\t\tqsort:                   %.6f seconds\n", t_q);
+    printf("\t\tpthread mergesort:       %.6f seconds\n", t_m);
+    for (k = 0; k <= C_CORANK_THREADS_LOG_MAX; k++){
+      num_threads = pow_two(k);
+      memcpy(arr_c, arr_a, count * elt_size);
+      t_c = timer();
+      mergesort_pthread_corank(arr_c, count, elt_size, num_threads,
+			       cmp_int);
+      t_c = timer() - t_c;
+      for (j = 0; j < count; j++){
+	res *= (arr_c[j] == arr_b[j]);
+      }
+      printf("\t\tco-ranking, %lu threads:  %.6f seconds\n",
+	     TOLU(num_threads), t_c);
+    }
+    printf("\t\tcorrectness:             ");
+    print_test_result(res);
+  }
   free(arr_a);
   free(arr_b);
+  free(arr_c);
   arr_a = NULL;
   arr_b = NULL;
+  arr_c = NULL;
 }
 
 /**
@@ -372,7 +728,9 @@ int main(int argc, char *argv[]){
       args[6] > 1 ||
       args[7] > 1 ||
       args[8] > 1 ||
-      args[9] > 1){
+      args[9] > 1 ||
+      args[10] > 1 ||
+      args[11] > 1){
     printf("USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -390,6 +748,8 @@ int main(int argc, char *argv[]){
 				   args[3],
 				   args[4],
 				   args[5]);
+  if (args[10]) run_radix_test(args[0], args[1], args[2], args[4]);
+  if (args[11]) run_corank_test(args[0], args[1], args[2], args[4]);
   free(args);
   args = NULL;
   return 0;
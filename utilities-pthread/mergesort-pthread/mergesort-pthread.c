@@ -33,6 +33,7 @@
 #include <string.h>
 #include <pthread.h>
 #include "mergesort-pthread.h"
+#include "pool-pthread.h"
 #include "utilities-alg.h"
 #include "utilities-mem.h"
 #include "utilities-pthread.h"
@@ -43,8 +44,11 @@ typedef struct{
   size_t mbase_count; /* >1, count of merge base case bound */
   size_t elt_size;
   size_t num_onthread_rec;
+  int is_cat; /* non-zero if the sorted result is placed in cat_elts */
   void *cat_elts; /* pointer to concatenation buffer for merging */
   void *elts; /* pointer to an input array */
+  pool_t *pool; /* NULL if a thread is created for each recursive call */
+  int key_type; /* C_KEY_CMP or key type of inlined comparisons */
   int (*cmp)(const void *, const void *);
 } mergesort_arg_t;
 
@@ -55,14 +59,91 @@ typedef struct{
   size_t num_onthread_rec;
   void *cat_seg_elts; /* pointer to concatenation buffer segment */
   void *elts; /* pointer to an input array */
+  pool_t *pool; /* NULL if a thread is created for each recursive call */
+  int key_type; /* C_KEY_CMP or key type of inlined comparisons */
   int (*cmp)(const void *, const void *);
 } merge_arg_t;
 
+typedef struct{
+  size_t count;
+  size_t elt_size;
+  size_t key_size;
+  size_t num_threads;
+  int key_type;
+  int is_sz; /* non-zero if elements are keys of size sizeof(size_t) */
+  int is_le; /* non-zero if the lowest byte of an integer is first */
+  int is_skip; /* non-zero if a pass does not move elements */
+  size_t *cnts; /* C_RADIX counts or offsets of each thread */
+  void *elts;
+  void *buf;
+  barrier_t barrier;
+} radix_t;
+
+typedef struct{
+  size_t id;
+  radix_t *r;
+} radix_arg_t;
+
+typedef struct{
+  size_t count;
+  size_t elt_size;
+  size_t num_threads;
+  void *elts;
+  void *cat_elts;
+  int (*cmp)(const void *, const void *);
+  barrier_t barrier;
+} corank_t;
+
+typedef struct{
+  size_t id;
+  corank_t *c;
+} corank_arg_t;
+
 const size_t C_SIZE_MAX = (size_t)-1; /* cannot be reached as array index */
 
+static const size_t C_INS_COUNT = 8; /* insertion sort run bound */
+static const int C_KEY_CMP = -1; /* comparisons call cmp */
+
+static const size_t C_RADIX = 256; /* 8-bit digits */
+static const size_t C_RADIX_BIT = 8;
+static const size_t C_RADIX_MASK = 255;
+static const size_t C_SZ_HIGH_BIT = ((size_t)-1 >> 1) + 1;
+
 static void *mergesort_thread(void *arg);
 static void *merge_thread(void *arg);
 static void merge(merge_arg_t *ma);
+static void base_sort(const mergesort_arg_t *msa);
+static void ins_sort(int key_type,
+		     char *elts,
+		     size_t count,
+		     size_t elt_size,
+		     void *tmp,
+		     int (*cmp)(const void *, const void *));
+static void merge_runs(int key_type,
+		       const char *a,
+		       const char *a_end,
+		       const char *b,
+		       const char *b_end,
+		       char *c,
+		       size_t elt_size,
+		       int (*cmp)(const void *, const void *));
+static void copy_elt(void *dst, const void *src, size_t elt_size);
+static void *corank_thread(void *arg);
+static size_t corank(size_t k,
+		     const char *a,
+		     size_t a_count,
+		     const char *b,
+		     size_t b_count,
+		     size_t elt_size,
+		     int (*cmp)(const void *, const void *));
+static size_t block_beg(const corank_t *c, size_t i);
+static void *radix_thread(void *arg);
+static void radix_offsets(radix_t *r);
+static size_t radix_digit(const radix_t *r, const void *elt, size_t d);
+static void dbl_to_ord(void *a, size_t n);
+static void ord_to_dbl(void *a, size_t n);
+static int cmp_sz(const void *a, const void *b);
+static int cmp_dbl(const void *a, const void *b);
 static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
 
 /**
@@ -75,7 +156,7 @@ static void *elt_ptr(const void *elts, size_t i, size_t elt_size);
    elt_size    : size of each element in the array in bytes
    sbase_count : > 0 base case upper bound for parallel sorting; if the count
                  of an unsorted subarray is less or equal to sbase_count,
-                 then the subarray is sorted with serial sort routine (qsort)
+                 then the subarray is sorted with a serial base case sort
    mbase_count : > 1 base case upper bound for parallel merging; if the sum
                  of the counts of two sorted subarrays is less or equal to
                  mbase_count, then the two subarrays are merged with a serial
@@ -101,13 +182,218 @@ void mergesort_pthread(void *elts,
   msa.mbase_count = mbase_count;
   msa.elt_size = elt_size;
   msa.num_onthread_rec = 0;
+  msa.is_cat = 0;
   msa.elts = elts;
   msa.cat_elts = malloc_perror(count, elt_size);
+  msa.key_type = C_KEY_CMP;
   msa.cmp = cmp;
+  msa.pool = NULL;
   mergesort_thread(&msa);
   free(msa.cat_elts);
 }
   
+/**
+   Sorts a given array as in mergesort_pthread, with recursive calls
+   submitted as tasks to a thread pool instead of the creation of a thread
+   for each recursive call. The first recursive call at each level is
+   submitted, and the second is run by the calling thread, which runs
+   queued tasks while it waits for the first. The pool is reused across
+   calls, e.g. when many medium-sized arrays are sorted back to back.
+   pool        : pointer to an initialized pool that is not freed during
+                 the call
+   Please see the specification of the remaining parameters in
+   mergesort_pthread.
+*/
+void mergesort_pthread_pool(pool_t *pool,
+			    void *elts,
+			    size_t count,
+			    size_t elt_size,
+			    size_t sbase_count,
+			    size_t mbase_count,
+			    int (*cmp)(const void *, const void *)){
+  mergesort_arg_t msa;
+  if (count < 1) return;
+  msa.p = 0;
+  msa.r = count - 1;
+  msa.sbase_count = sbase_count;
+  msa.mbase_count = mbase_count;
+  msa.elt_size = elt_size;
+  msa.num_onthread_rec = 0;
+  msa.is_cat = 0;
+  msa.elts = elts;
+  msa.cat_elts = malloc_perror(count, elt_size);
+  msa.key_type = C_KEY_CMP;
+  msa.cmp = cmp;
+  msa.pool = pool;
+  mergesort_thread(&msa);
+  free(msa.cat_elts);
+}
+  
+/**
+   Sorts a given array as in mergesort_pthread in ascending order of the
+   keys at the beginning of its elements, without a comparison function.
+   The comparisons of keys are inlined into the loops of the serial base
+   case sort and the serial merge routine.
+   elts        : pointer to the array to sort
+   count       : > 0, < 2^{CHAR_BIT * sizeof(size_t) - 1} count of elements
+                 in the array
+   elt_size    : size of each element in the array in bytes, which is a
+                 multiple of the size of the key
+   sbase_count : > 0 base case upper bound for parallel sorting
+   mbase_count : > 1 base case upper bound for parallel merging
+   key_type    : MERGESORT_PTHREAD_KEY_UINT for size_t keys, or
+                 MERGESORT_PTHREAD_KEY_DOUBLE for double keys that are
+                 not NaN
+*/
+void mergesort_pthread_key(void *elts,
+			   size_t count,
+			   size_t elt_size,
+			   size_t sbase_count,
+			   size_t mbase_count,
+			   int key_type){
+  mergesort_arg_t msa;
+  if (count < 1) return;
+  msa.p = 0;
+  msa.r = count - 1;
+  msa.sbase_count = sbase_count;
+  msa.mbase_count = mbase_count;
+  msa.elt_size = elt_size;
+  msa.num_onthread_rec = 0;
+  msa.is_cat = 0;
+  msa.elts = elts;
+  msa.cat_elts = malloc_perror(count, elt_size);
+  msa.key_type = key_type;
+  msa.cmp = (key_type == MERGESORT_PTHREAD_KEY_UINT) ? cmp_sz : cmp_dbl;
+  msa.pool = NULL;
+  mergesort_thread(&msa);
+  free(msa.cat_elts);
+}
+  
+/**
+   Sorts a given array pointed to by elts in ascending order according to
+   cmp with a fixed number of threads. Each thread sorts a block of
+   elements with the serial base case sort, and the sorted blocks are
+   merged pairwise in rounds with barriers between the rounds. In each
+   round, the output of each merge is divided into equal chunks that are
+   aligned with the blocks of the threads, and the input ranges of a chunk
+   are found by a binary search for the co-rank of each chunk end along
+   the merge path, so that all threads merge the same count of elements
+   in each round, including the last round with a single merge.
+   elts        : pointer to the array to sort
+   count       : > 0 count of elements in the array
+   elt_size    : size of each element in the array in bytes
+   num_threads : > 0 number of threads including the calling thread
+   cmp         : comparison function as in mergesort_pthread
+*/
+void mergesort_pthread_corank(void *elts,
+			      size_t count,
+			      size_t elt_size,
+			      size_t num_threads,
+			      int (*cmp)(const void *, const void *)){
+  size_t i;
+  corank_t c;
+  corank_arg_t *args = NULL;
+  pthread_t *ids = NULL;
+  if (count < 1) return;
+  if (num_threads > count) num_threads = count;
+  c.count = count;
+  c.elt_size = elt_size;
+  c.num_threads = num_threads;
+  c.elts = elts;
+  c.cat_elts = malloc_perror(count, elt_size);
+  c.cmp = cmp;
+  barrier_init_perror(&c.barrier, num_threads);
+  args = malloc_perror(num_threads, sizeof(corank_arg_t));
+  ids = malloc_perror(num_threads, sizeof(pthread_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].c = &c;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&ids[i], corank_thread, &args[i]);
+  }
+  corank_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  free(c.cat_elts);
+  free(args);
+  free(ids);
+  c.cat_elts = NULL;
+  args = NULL;
+  ids = NULL;
+}
+  
+/**
+   Sorts a given array pointed to by elts in ascending order of the keys
+   at the beginning of its elements with a parallel least significant
+   digit (LSD) radix sort with 8-bit digits, without a comparison
+   function. The keys are unsigned integers of any unsigned integer type,
+   or doubles in the IEEE 754 format, whose bit patterns are mapped to
+   unsigned integers of the same order. Each of num_threads threads counts
+   the digits of a block of elements, and moves the elements of its block
+   to the offsets that are computed from the counts in each pass. A pass is
+   skipped if all keys have the same digit. If elt_size and key_size are
+   equal to sizeof(size_t), the keys are processed as size_t values,
+   otherwise the digits are read as bytes.
+   elts        : pointer to the array to sort
+   count       : > 0 count of elements in the array
+   elt_size    : size of each element in the array in bytes
+   key_size    : size of the key at the beginning of each element in bytes,
+                 which is sizeof(double) if key_type is
+                 MERGESORT_PTHREAD_KEY_DOUBLE
+   key_type    : MERGESORT_PTHREAD_KEY_UINT or MERGESORT_PTHREAD_KEY_DOUBLE
+   num_threads : > 0 number of threads including the calling thread
+*/
+void mergesort_pthread_radix(void *elts,
+			     size_t count,
+			     size_t elt_size,
+			     size_t key_size,
+			     int key_type,
+			     size_t num_threads){
+  size_t i;
+  unsigned int one = 1;
+  radix_t r;
+  radix_arg_t *args = NULL;
+  pthread_t *ids = NULL;
+  if (count < 1) return;
+  if (num_threads > count) num_threads = count;
+  r.count = count;
+  r.elt_size = elt_size;
+  r.key_size = key_size;
+  r.num_threads = num_threads;
+  r.key_type = key_type;
+  r.is_sz = (elt_size == sizeof(size_t) && key_size == sizeof(size_t));
+  r.is_le = (*(unsigned char *)&one == 1);
+  r.is_skip = 0;
+  r.cnts = malloc_perror(mul_sz_perror(num_threads, C_RADIX),
+			 sizeof(size_t));
+  r.elts = elts;
+  r.buf = malloc_perror(count, elt_size);
+  barrier_init_perror(&r.barrier, num_threads);
+  args = malloc_perror(num_threads, sizeof(radix_arg_t));
+  ids = malloc_perror(num_threads, sizeof(pthread_t));
+  for (i = 0; i < num_threads; i++){
+    args[i].id = i;
+    args[i].r = &r;
+  }
+  for (i = 1; i < num_threads; i++){
+    thread_create_perror(&ids[i], radix_thread, &args[i]);
+  }
+  radix_thread(&args[0]);
+  for (i = 1; i < num_threads; i++){
+    thread_join_perror(ids[i], NULL);
+  }
+  free(r.cnts);
+  free(r.buf);
+  free(args);
+  free(ids);
+  r.cnts = NULL;
+  r.buf = NULL;
+  args = NULL;
+  ids = NULL;
+}
+  
 /**
    Enters a mergesort thread that spawns mergesort threads recursively.
    The total number of threads is reduced and an additional speedup is
@@ -120,14 +406,12 @@ static void *mergesort_thread(void *arg){
   mergesort_arg_t child_msas[2];
   pthread_t child_ids[2];
   merge_arg_t ma;
+  pool_group_t group;
   if (msa->r - msa->p + 1 <= msa->sbase_count){
-    qsort(elt_ptr(msa->elts, msa->p, msa->elt_size),
-	  msa->r - msa->p + 1,
-	  msa->elt_size,
-	  msa->cmp);
+    base_sort(msa);
   }else{
     
-    /* sort recursion */
+    /* sort recursion into the array that is not the target of the merge */
     q = (msa->p + msa->r) / 2; /* rounds down */
     child_msas[0].p = msa->p;
     child_msas[0].r = q;
@@ -135,30 +419,44 @@ static void *mergesort_thread(void *arg){
     child_msas[0].mbase_count = msa->mbase_count;
     child_msas[0].elt_size = msa->elt_size;
     child_msas[0].num_onthread_rec = 0;
+    child_msas[0].is_cat = !msa->is_cat;
     child_msas[0].cat_elts = msa->cat_elts;
     child_msas[0].elts = msa->elts;
+    child_msas[0].key_type = msa->key_type;
     child_msas[0].cmp = msa->cmp;
+    child_msas[0].pool = msa->pool;
     child_msas[1].p = q + 1;
     child_msas[1].r = msa->r;
     child_msas[1].sbase_count = msa->sbase_count;
     child_msas[1].mbase_count = msa->mbase_count;
     child_msas[1].elt_size = msa->elt_size;
+    child_msas[1].is_cat = !msa->is_cat;
     child_msas[1].cat_elts = msa->cat_elts;
     child_msas[1].elts = msa->elts;
+    child_msas[1].key_type = msa->key_type;
     child_msas[1].cmp = msa->cmp;
-    thread_create_perror(&child_ids[0], mergesort_thread, &child_msas[0]);
-    if (msa->num_onthread_rec < MERGESORT_PTHREAD_MAX_ONTHREAD_REC){
+    child_msas[1].pool = msa->pool;
+    if (msa->pool != NULL){
+      pool_group_init(&group);
+      pool_submit(msa->pool, mergesort_thread, &child_msas[0], &group);
+      child_msas[1].num_onthread_rec = 0;
+      mergesort_thread(&child_msas[1]);
+      pool_wait(msa->pool, &group);
+    }else if (msa->num_onthread_rec < MERGESORT_PTHREAD_MAX_ONTHREAD_REC){
+      thread_create_perror(&child_ids[0], mergesort_thread, &child_msas[0]);
       /* keep putting mergesort_thread calls on the current thread stack */
       child_msas[1].num_onthread_rec = msa->num_onthread_rec + 1;
       mergesort_thread(&child_msas[1]);
+      thread_join_perror(child_ids[0], NULL);
     }else{
+      thread_create_perror(&child_ids[0], mergesort_thread, &child_msas[0]);
       child_msas[1].num_onthread_rec = 0;
       thread_create_perror(&child_ids[1], mergesort_thread, &child_msas[1]);
       thread_join_perror(child_ids[1], NULL);
+      thread_join_perror(child_ids[0], NULL);
     }
-    thread_join_perror(child_ids[0], NULL);
 
-    /* merge recursion */
+    /* merge recursion into the target, without copying back */
     ma.ap = msa->p;
     ma.ar = q;
     ma.bp = q + 1;
@@ -167,14 +465,17 @@ static void *mergesort_thread(void *arg){
     ma.mbase_count = msa->mbase_count;
     ma.elt_size = msa->elt_size;
     ma.num_onthread_rec = msa->num_onthread_rec;
-    ma.cat_seg_elts = elt_ptr(msa->cat_elts, msa->p, msa->elt_size);
-    ma.elts = msa->elts;
+    if (msa->is_cat){
+      ma.cat_seg_elts = elt_ptr(msa->cat_elts, msa->p, msa->elt_size);
+      ma.elts = msa->elts;
+    }else{
+      ma.cat_seg_elts = elt_ptr(msa->elts, msa->p, msa->elt_size);
+      ma.elts = msa->cat_elts;
+    }
+    ma.key_type = msa->key_type;
     ma.cmp = msa->cmp;
+    ma.pool = msa->pool;
     merge_thread(&ma);
-    /* copy the merged result into the input array */
-    memcpy(elt_ptr(msa->elts, msa->p, msa->elt_size),
-	   elt_ptr(ma.cat_seg_elts, 0, msa->elt_size),
-	   (msa->r - msa->p + 1) * msa->elt_size);
   }
   return NULL;
 }
@@ -187,6 +488,7 @@ static void *merge_thread(void *arg){
   merge_arg_t *ma = arg;
   merge_arg_t child_mas[2];
   pthread_t child_ids[2];
+  pool_group_t group;
   if ((ma->ap == C_SIZE_MAX && ma->ar == C_SIZE_MAX) ||
       (ma->bp == C_SIZE_MAX && ma->br == C_SIZE_MAX) ||
       (ma->ar - ma->ap) + (ma->br - ma->bp) + 2 <= ma->mbase_count){
@@ -263,26 +565,37 @@ static void *merge_thread(void *arg){
   child_mas[0].num_onthread_rec = ma->num_onthread_rec;
   child_mas[0].cat_seg_elts = ma->cat_seg_elts;
   child_mas[0].elts = ma->elts;
+  child_mas[0].key_type = ma->key_type;
   child_mas[0].cmp = ma->cmp;
+  child_mas[0].pool = ma->pool;
   child_mas[1].mbase_count = ma->mbase_count;
   child_mas[1].elt_size = ma->elt_size;
   child_mas[1].num_onthread_rec = ma->num_onthread_rec;
   child_mas[1].cat_seg_elts = ma->cat_seg_elts;
   child_mas[1].elts = ma->elts;
+  child_mas[1].key_type = ma->key_type;
   child_mas[1].cmp = ma->cmp;
+  child_mas[1].pool = ma->pool;
 
   /* recursion */
-  thread_create_perror(&child_ids[0], merge_thread, &child_mas[0]);
-  if (ma->num_onthread_rec < MERGESORT_PTHREAD_MAX_ONTHREAD_REC){
+  if (ma->pool != NULL){
+    pool_group_init(&group);
+    pool_submit(ma->pool, merge_thread, &child_mas[0], &group);
+    merge_thread(&child_mas[1]);
+    pool_wait(ma->pool, &group);
+  }else if (ma->num_onthread_rec < MERGESORT_PTHREAD_MAX_ONTHREAD_REC){
     /* keep putting merge_thread calls on the current thread stack */
+    thread_create_perror(&child_ids[0], merge_thread, &child_mas[0]);
     child_mas[1].num_onthread_rec = ma->num_onthread_rec + 1;
     merge_thread(&child_mas[1]);
+    thread_join_perror(child_ids[0], NULL);
   }else{
+    thread_create_perror(&child_ids[0], merge_thread, &child_mas[0]);
     child_mas[1].num_onthread_rec = 0;
     thread_create_perror(&child_ids[1], merge_thread, &child_mas[1]);
     thread_join_perror(child_ids[1], NULL);
+    thread_join_perror(child_ids[0], NULL);
   }
-  thread_join_perror(child_ids[0], NULL);
   return NULL;
 }
 
@@ -291,7 +604,6 @@ static void *merge_thread(void *arg){
    of parallel merge.
 */
 static void merge(merge_arg_t *ma){
-  size_t first_ix, second_ix, cat_ix;
   size_t elt_size = ma->elt_size;
   if (ma->ap == C_SIZE_MAX && ma->ar == C_SIZE_MAX){
     /* a is empty */
@@ -305,37 +617,447 @@ static void merge(merge_arg_t *ma){
 	   (ma->ar - ma->ap + 1) * elt_size);
   }else{
     /* a and b are each not empty */
-    first_ix = ma->ap;
-    second_ix = ma->bp;
-    cat_ix = ma->cs;
-    while(first_ix <= ma->ar && second_ix <= ma->br){
-      if (ma->cmp(elt_ptr(ma->elts, first_ix, elt_size),
-		  elt_ptr(ma->elts, second_ix, elt_size)) < 0){
-	memcpy(elt_ptr(ma->cat_seg_elts, cat_ix, elt_size),
-	       elt_ptr(ma->elts, first_ix, elt_size),
-	       elt_size);
-	cat_ix++;
-	first_ix++;
-      }else{
-	memcpy(elt_ptr(ma->cat_seg_elts, cat_ix, elt_size),
-	       elt_ptr(ma->elts, second_ix, elt_size),
-	       elt_size);
-	cat_ix++;
-	second_ix++;
+    merge_runs(ma->key_type,
+	       elt_ptr(ma->elts, ma->ap, elt_size),
+	       elt_ptr(ma->elts, ma->ar + 1, elt_size),
+	       elt_ptr(ma->elts, ma->bp, elt_size),
+	       elt_ptr(ma->elts, ma->br + 1, elt_size),
+	       elt_ptr(ma->cat_seg_elts, ma->cs, elt_size),
+	       elt_size,
+	       ma->cmp);
+  }
+}
+
+/**
+   Sorts a subarray with at most sbase_count elements as the base case of
+   parallel sorting, and places the result in the input array or in the
+   concatenation buffer according to is_cat. Runs of C_INS_COUNT elements
+   are sorted with insertion sort, and the runs are merged bottom-up
+   between the two arrays, so that the result is copied at most once. The
+   segment of the concatenation buffer is free during the base case and
+   provides the temporary element of insertion sort.
+*/
+static void base_sort(const mergesort_arg_t *msa){
+  size_t beg, mid, end, w;
+  size_t count = msa->r - msa->p + 1;
+  size_t elt_size = msa->elt_size;
+  char *a = elt_ptr(msa->elts, msa->p, elt_size);
+  char *b = elt_ptr(msa->cat_elts, msa->p, elt_size);
+  char *src = a, *dst = b, *t = NULL;
+  for (beg = 0; beg < count; beg += C_INS_COUNT){
+    end = (count - beg < C_INS_COUNT) ? count : beg + C_INS_COUNT;
+    ins_sort(msa->key_type,
+	     src + beg * elt_size,
+	     end - beg,
+	     elt_size,
+	     b,
+	     msa->cmp);
+  }
+  for (w = C_INS_COUNT; w < count; w *= 2){
+    for (beg = 0; beg < count; beg += 2 * w){
+      mid = (count - beg < w) ? count : beg + w;
+      end = (count - mid < w) ? count : mid + w;
+      merge_runs(msa->key_type,
+		 src + beg * elt_size,
+		 src + mid * elt_size,
+		 src + mid * elt_size,
+		 src + end * elt_size,
+		 dst + beg * elt_size,
+		 elt_size,
+		 msa->cmp);
+    }
+    t = src;
+    src = dst;
+    dst = t;
+  }
+  t = msa->is_cat ? b : a;
+  if (src != t) memcpy(t, src, count * elt_size);
+}
+
+/**
+   Comparisons of the serial routines, where LT_SZ and LT_DBL compare the
+   keys at the beginning of elements without a call.
+*/
+#define LT_CMP(a, b) (cmp((a), (b)) < 0)
+#define LT_SZ(a, b) (*(const size_t *)(a) < *(const size_t *)(b))
+#define LT_DBL(a, b) (*(const double *)(a) < *(const double *)(b))
+
+/**
+   Defines an insertion sort of a run of elements according to a
+   comparison macro, where the elements after the insertion position are
+   moved as a block.
+*/
+#define INS_SORT_DEF(name, lt)						\
+  static void name(char *elts,						\
+		   size_t count,					\
+		   size_t elt_size,					\
+		   void *tmp,						\
+		   int (*cmp)(const void *, const void *)){		\
+    size_t i, j;							\
+    (void)cmp; /* not used by inlined comparisons */			\
+    for (i = 1; i < count; i++){					\
+      if (!lt(elts + i * elt_size, elts + (i - 1) * elt_size)) continue; \
+      copy_elt(tmp, elts + i * elt_size, elt_size);			\
+      j = i - 1;							\
+      while (j > 0 && lt(tmp, elts + (j - 1) * elt_size)) j--;		\
+      memmove(elts + (j + 1) * elt_size,				\
+	      elts + j * elt_size,					\
+	      (i - j) * elt_size);					\
+      copy_elt(elts + j * elt_size, tmp, elt_size);			\
+    }									\
+  }
+
+/**
+   Defines a merge of the sorted runs [a, a_end) and [b, b_end) into c
+   according to a comparison macro. The runs are copied as blocks if they
+   are already in order.
+*/
+#define MERGE_RUNS_DEF(name, lt)					\
+  static void name(const char *a,					\
+		   const char *a_end,					\
+		   const char *b,					\
+		   const char *b_end,					\
+		   char *c,						\
+		   size_t elt_size,					\
+		   int (*cmp)(const void *, const void *)){		\
+    (void)cmp; /* not used by inlined comparisons */			\
+    if (a == a_end || b == b_end || !lt(b, a_end - elt_size)){		\
+      memcpy(c, a, a_end - a);						\
+      memcpy(c + (a_end - a), b, b_end - b);				\
+      return;								\
+    }									\
+    while (a != a_end && b != b_end){					\
+      if (lt(b, a)){							\
+	copy_elt(c, b, elt_size);					\
+	b += elt_size;							\
+      }else{								\
+	copy_elt(c, a, elt_size);					\
+	a += elt_size;							\
+      }									\
+      c += elt_size;							\
+    }									\
+    if (a != a_end){							\
+      memcpy(c, a, a_end - a);						\
+    }else{								\
+      memcpy(c, b, b_end - b);						\
+    }									\
+  }
+
+INS_SORT_DEF(ins_sort_cmp, LT_CMP)
+INS_SORT_DEF(ins_sort_sz, LT_SZ)
+INS_SORT_DEF(ins_sort_dbl, LT_DBL)
+MERGE_RUNS_DEF(merge_runs_cmp, LT_CMP)
+MERGE_RUNS_DEF(merge_runs_sz, LT_SZ)
+MERGE_RUNS_DEF(merge_runs_dbl, LT_DBL)
+
+/**
+   Sort a run of elements with insertion sort, and merge two sorted runs,
+   with the comparisons of key_type.
+*/
+
+static void ins_sort(int key_type,
+		     char *elts,
+		     size_t count,
+		     size_t elt_size,
+		     void *tmp,
+		     int (*cmp)(const void *, const void *)){
+  if (key_type == MERGESORT_PTHREAD_KEY_UINT){
+    ins_sort_sz(elts, count, elt_size, tmp, cmp);
+  }else if (key_type == MERGESORT_PTHREAD_KEY_DOUBLE){
+    ins_sort_dbl(elts, count, elt_size, tmp, cmp);
+  }else{
+    ins_sort_cmp(elts, count, elt_size, tmp, cmp);
+  }
+}
+
+static void merge_runs(int key_type,
+		       const char *a,
+		       const char *a_end,
+		       const char *b,
+		       const char *b_end,
+		       char *c,
+		       size_t elt_size,
+		       int (*cmp)(const void *, const void *)){
+  if (key_type == MERGESORT_PTHREAD_KEY_UINT){
+    merge_runs_sz(a, a_end, b, b_end, c, elt_size, cmp);
+  }else if (key_type == MERGESORT_PTHREAD_KEY_DOUBLE){
+    merge_runs_dbl(a, a_end, b, b_end, c, elt_size, cmp);
+  }else{
+    merge_runs_cmp(a, a_end, b, b_end, c, elt_size, cmp);
+  }
+}
+
+/**
+   Copies an element, with constant size copies for the common element
+   sizes of sizeof(size_t), sizeof(int), and 2 * sizeof(size_t), which are
+   compiled to moves without a call.
+*/
+static void copy_elt(void *dst, const void *src, size_t elt_size){
+  if (elt_size == sizeof(size_t)){
+    memcpy(dst, src, sizeof(size_t));
+  }else if (elt_size == sizeof(int)){
+    memcpy(dst, src, sizeof(int));
+  }else if (elt_size == 2 * sizeof(size_t)){
+    memcpy(dst, src, 2 * sizeof(size_t));
+  }else{
+    memcpy(dst, src, elt_size);
+  }
+}
+
+/**
+   Enters a co-ranking thread that sorts the block of the thread, and
+   merges the chunk of the output of a merge that is aligned with the
+   block in each round. The runs of a round are placed in src, and the
+   merged runs are placed in dst. A chunk without a second run is copied.
+*/
+static void *corank_thread(void *arg){
+  corank_arg_t *ca = arg;
+  corank_t *c = ca->c;
+  size_t s, j, a_beg, b_beg, b_end, k_beg, k_end, i_beg, i_end;
+  size_t elt_size = c->elt_size;
+  size_t beg = block_beg(c, ca->id);
+  size_t end = block_beg(c, ca->id + 1);
+  char *src = c->elts, *dst = c->cat_elts, *t = NULL;
+  mergesort_arg_t msa;
+  msa.p = beg;
+  msa.r = end - 1;
+  msa.elt_size = elt_size;
+  msa.is_cat = 0;
+  msa.cat_elts = c->cat_elts;
+  msa.elts = c->elts;
+  msa.key_type = C_KEY_CMP;
+  msa.cmp = c->cmp;
+  base_sort(&msa);
+  barrier_wait_perror(&c->barrier);
+  for (s = 1; s < c->num_threads; s *= 2){
+    /* the merge of the runs [a_beg, b_beg) and [b_beg, b_end) */
+    j = ca->id - ca->id % (2 * s);
+    a_beg = block_beg(c, j);
+    b_beg = block_beg(c, (j + s < c->num_threads) ? j + s : c->num_threads);
+    b_end = block_beg(c, (j + 2 * s < c->num_threads) ?
+		      j + 2 * s : c->num_threads);
+    k_beg = beg - a_beg;
+    k_end = end - a_beg;
+    i_beg = corank(k_beg,
+		   src + a_beg * elt_size, b_beg - a_beg,
+		   src + b_beg * elt_size, b_end - b_beg,
+		   elt_size, c->cmp);
+    i_end = corank(k_end,
+		   src + a_beg * elt_size, b_beg - a_beg,
+		   src + b_beg * elt_size, b_end - b_beg,
+		   elt_size, c->cmp);
+    merge_runs(C_KEY_CMP,
+	       src + (a_beg + i_beg) * elt_size,
+	       src + (a_beg + i_end) * elt_size,
+	       src + (b_beg + k_beg - i_beg) * elt_size,
+	       src + (b_beg + k_end - i_end) * elt_size,
+	       dst + beg * elt_size,
+	       elt_size,
+	       c->cmp);
+    barrier_wait_perror(&c->barrier);
+    t = src;
+    src = dst;
+    dst = t;
+  }
+  if (src != c->elts){
+    memcpy((char *)c->elts + beg * elt_size,
+	   src + beg * elt_size,
+	   (end - beg) * elt_size);
+  }
+  return NULL;
+}
+
+/**
+   Returns the co-rank i of k in the merge of the sorted arrays a and b,
+   s.t. the first k elements of the merge are the first i elements of a
+   and the first k - i elements of b. An element of a precedes an equal
+   element of b, as in merge_runs.
+*/
+static size_t corank(size_t k,
+		     const char *a,
+		     size_t a_count,
+		     const char *b,
+		     size_t b_count,
+		     size_t elt_size,
+		     int (*cmp)(const void *, const void *)){
+  size_t i;
+  size_t lo = (k > b_count) ? k - b_count : 0;
+  size_t hi = (k < a_count) ? k : a_count;
+  while (lo < hi){
+    i = lo + (hi - lo) / 2;
+    if (cmp(a + i * elt_size, b + (k - i - 1) * elt_size) <= 0){
+      lo = i + 1; /* a[i] is among the first k elements */
+    }else{
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+/**
+   Returns the index of the first element of the block of the thread at
+   index i, or count if i is equal to num_threads.
+*/
+static size_t block_beg(const corank_t *c, size_t i){
+  if (i == c->num_threads) return c->count;
+  return c->count / c->num_threads * i;
+}
+
+/**
+   Enters a radix sort thread that sorts in passes over the digits from
+   the least significant digit, with barriers between the counts, the
+   offsets, and the moves of elements. Each thread owns a block of
+   elements in the source array of a pass.
+*/
+static void *radix_thread(void *arg){
+  radix_arg_t *ra = arg;
+  radix_t *r = ra->r;
+  size_t i, d, ix;
+  size_t beg = r->count / r->num_threads * ra->id;
+  size_t end = (ra->id + 1 == r->num_threads) ?
+    r->count : r->count / r->num_threads * (ra->id + 1);
+  size_t elt_size = r->elt_size;
+  size_t shift;
+  size_t *cnts = r->cnts + ra->id * C_RADIX;
+  char *src = r->elts, *dst = r->buf, *t = NULL;
+  const size_t *sz_src = NULL;
+  size_t *sz_dst = NULL;
+  if (r->is_sz && r->key_type == MERGESORT_PTHREAD_KEY_DOUBLE){
+    dbl_to_ord((size_t *)r->elts + beg, end - beg);
+  }
+  for (d = 0; d < r->key_size; d++){
+    memset(cnts, 0, C_RADIX * sizeof(size_t));
+    shift = d * C_RADIX_BIT;
+    sz_src = (const size_t *)src;
+    if (r->is_sz){
+      for (i = beg; i < end; i++){
+	cnts[(sz_src[i] >> shift) & C_RADIX_MASK]++;
+      }
+    }else{
+      for (i = beg; i < end; i++){
+	cnts[radix_digit(r, src + i * elt_size, d)]++;
       }
     }
-    if (second_ix == ma->br + 1){
-      memcpy(elt_ptr(ma->cat_seg_elts, cat_ix, elt_size),
-	     elt_ptr(ma->elts, first_ix, elt_size),
-	     (ma->ar - first_ix + 1) * elt_size);
+    barrier_wait_perror(&r->barrier);
+    if (ra->id == 0) radix_offsets(r);
+    barrier_wait_perror(&r->barrier);
+    if (r->is_skip) continue;
+    if (r->is_sz){
+      sz_dst = (size_t *)dst;
+      for (i = beg; i < end; i++){
+	sz_dst[cnts[(sz_src[i] >> shift) & C_RADIX_MASK]++] = sz_src[i];
+      }
     }else{
-      memcpy(elt_ptr(ma->cat_seg_elts, cat_ix, elt_size),
-	     elt_ptr(ma->elts, second_ix, elt_size),
-	     (ma->br - second_ix + 1) * elt_size);
+      for (i = beg; i < end; i++){
+	ix = cnts[radix_digit(r, src + i * elt_size, d)]++;
+	memcpy(dst + ix * elt_size, src + i * elt_size, elt_size);
+      }
+    }
+    barrier_wait_perror(&r->barrier);
+    t = src;
+    src = dst;
+    dst = t;
+  }
+  if (src != r->elts){
+    memcpy((char *)r->elts + beg * elt_size,
+	   src + beg * elt_size,
+	   (end - beg) * elt_size);
+  }
+  if (r->is_sz && r->key_type == MERGESORT_PTHREAD_KEY_DOUBLE){
+    ord_to_dbl((size_t *)r->elts + beg, end - beg);
+  }
+  return NULL;
+}
+
+/**
+   Converts the digit counts of the threads to the offsets of the first
+   elements of the blocks of the threads in the destination array, in the
+   order of digits and then threads, and sets is_skip if all elements have
+   the same digit.
+*/
+static void radix_offsets(radix_t *r){
+  size_t b, t, c, tot, off = 0;
+  r->is_skip = 0;
+  for (b = 0; b < C_RADIX; b++){
+    tot = 0;
+    for (t = 0; t < r->num_threads; t++){
+      c = r->cnts[t * C_RADIX + b];
+      r->cnts[t * C_RADIX + b] = off;
+      off += c;
+      tot += c;
     }
+    if (tot == r->count) r->is_skip = 1;
   }
 }
 
+/**
+   Returns the dth least significant 8-bit digit of the key of an element,
+   where the key bytes are read in the byte order of integers. The digits
+   of a double key are mapped so that the order of the digits is the order
+   of the doubles: the bits of a negative double are inverted, and the
+   sign bit of a non-negative double is set.
+*/
+static size_t radix_digit(const radix_t *r, const void *elt, size_t d){
+  const unsigned char *k = elt;
+  size_t hi = r->is_le ? r->key_size - 1 : 0;
+  size_t ret = k[r->is_le ? d : r->key_size - 1 - d];
+  if (r->key_type == MERGESORT_PTHREAD_KEY_DOUBLE){
+    if (k[hi] & 0x80){
+      ret = ~ret & C_RADIX_MASK;
+    }else if (d + 1 == r->key_size){
+      ret ^= 0x80;
+    }
+  }
+  return ret;
+}
+
+/**
+   Map the bit patterns of doubles in an array of size_t blocks to and
+   from unsigned integers of the same order, if sizeof(double) is equal
+   to sizeof(size_t). A double is not read through a size_t lvalue; its
+   bit pattern is copied to a size_t value, and a mapped pattern is
+   stored back as a double, so that the array is accessed by the user
+   with the effective type double after the sort.
+*/
+
+static void dbl_to_ord(void *a, size_t n){
+  size_t i, u;
+  char *p = a;
+  for (i = 0; i < n; i++){
+    memcpy(&u, p, sizeof(size_t));
+    u = (u & C_SZ_HIGH_BIT) ? ~u : u ^ C_SZ_HIGH_BIT;
+    memcpy(p, &u, sizeof(size_t));
+    p += sizeof(size_t);
+  }
+}
+
+static void ord_to_dbl(void *a, size_t n){
+  size_t i, u;
+  double d;
+  double *p = a;
+  for (i = 0; i < n; i++){
+    memcpy(&u, &p[i], sizeof(size_t));
+    u = (u & C_SZ_HIGH_BIT) ? u ^ C_SZ_HIGH_BIT : ~u;
+    memcpy(&d, &u, sizeof(size_t));
+    p[i] = d;
+  }
+}
+
+/**
+   Compare the keys at the beginning of elements for the parallel merge
+   of mergesort_pthread_key.
+*/
+
+static int cmp_sz(const void *a, const void *b){
+  return (*(const size_t *)a > *(const size_t *)b) -
+    (*(const size_t *)a < *(const size_t *)b);
+}
+
+static int cmp_dbl(const void *a, const void *b){
+  return (*(const double *)a > *(const double *)b) -
+    (*(const double *)a < *(const double *)b);
+}
+
 /**
    Computes a pointer to an element in an element array.
 */
@@ -24,12 +24,23 @@
    parameters resulted in a speedup of approximately 2.6X in comparison
    to serial qsort (stdlib.h) on arrays of 10M random integer or double
    elements.
+
+   mergesort_pthread_pool submits the recursive calls as tasks to a
+   reusable work-stealing thread pool instead of creating a thread for
+   each recursive call, which removes the overhead of thread creation and
+   joining when many medium-sized arrays are sorted back to back.
+
+   mergesort_pthread_radix provides a parallel radix sort mode for keys
+   that are unsigned integers or doubles, where the digits of keys are
+   extracted with type-specialized code instead of comparisons through a
+   function pointer.
 */
 
 #ifndef MERGESORT_PTHREAD_H  
 #define MERGESORT_PTHREAD_H
 
 #include <stddef.h>
+#include "pool-pthread.h"
 
 /**
    Sorts a given array pointed to by elts in ascending order according to
@@ -41,7 +52,7 @@
    elt_size    : size of each element in the array in bytes
    sbase_count : > 0 base case upper bound for parallel sorting; if the count
                  of an unsorted subarray is less or equal to sbase_count,
-                 then the subarray is sorted with serial sort routine (qsort)
+                 then the subarray is sorted with a serial base case sort
    mbase_count : > 1 base case upper bound for parallel merging; if the sum
                  of the counts of two sorted subarrays is less or equal to
                  mbase_count, then the two subarrays are merged with a serial
@@ -60,12 +71,111 @@ void mergesort_pthread(void *elts,
 		       size_t mbase_count,
 		       int (*cmp)(const void *, const void *));
 
+/**
+   Sorts a given array as in mergesort_pthread, with recursive calls
+   submitted as tasks to a thread pool instead of the creation of a thread
+   for each recursive call. The first recursive call at each level is
+   submitted, and the second is run by the calling thread, which runs
+   queued tasks while it waits for the first. The pool is reused across
+   calls, e.g. when many medium-sized arrays are sorted back to back.
+   pool        : pointer to an initialized pool that is not freed during
+                 the call
+   Please see the specification of the remaining parameters in
+   mergesort_pthread.
+*/
+void mergesort_pthread_pool(pool_t *pool,
+			    void *elts,
+			    size_t count,
+			    size_t elt_size,
+			    size_t sbase_count,
+			    size_t mbase_count,
+			    int (*cmp)(const void *, const void *));
+
+/**
+   Sorts a given array pointed to by elts in ascending order according to
+   cmp with a fixed number of threads. Each thread sorts a block of
+   elements with the serial base case sort, and the sorted blocks are
+   merged pairwise in rounds with barriers between the rounds. In each
+   round, the output of each merge is divided into equal chunks that are
+   aligned with the blocks of the threads, and the input ranges of a chunk
+   are found by a binary search for the co-rank of each chunk end along
+   the merge path, so that all threads merge the same count of elements
+   in each round, including the last round with a single merge.
+   elts        : pointer to the array to sort
+   count       : > 0 count of elements in the array
+   elt_size    : size of each element in the array in bytes
+   num_threads : > 0 number of threads including the calling thread
+   cmp         : comparison function as in mergesort_pthread
+*/
+void mergesort_pthread_corank(void *elts,
+			      size_t count,
+			      size_t elt_size,
+			      size_t num_threads,
+			      int (*cmp)(const void *, const void *));
+
+/**
+   Key types of mergesort_pthread_key and mergesort_pthread_radix.
+*/
+#define MERGESORT_PTHREAD_KEY_UINT (0)
+#define MERGESORT_PTHREAD_KEY_DOUBLE (1)
+
+/**
+   Sorts a given array as in mergesort_pthread in ascending order of the
+   keys at the beginning of its elements, without a comparison function.
+   The comparisons of keys are inlined into the loops of the serial base
+   case sort and the serial merge routine.
+   elts        : pointer to the array to sort
+   count       : > 0, < 2^{CHAR_BIT * sizeof(size_t) - 1} count of elements
+                 in the array
+   elt_size    : size of each element in the array in bytes, which is a
+                 multiple of the size of the key
+   sbase_count : > 0 base case upper bound for parallel sorting
+   mbase_count : > 1 base case upper bound for parallel merging
+   key_type    : MERGESORT_PTHREAD_KEY_UINT for size_t keys, or
+                 MERGESORT_PTHREAD_KEY_DOUBLE for double keys that are
+                 not NaN
+*/
+void mergesort_pthread_key(void *elts,
+			   size_t count,
+			   size_t elt_size,
+			   size_t sbase_count,
+			   size_t mbase_count,
+			   int key_type);
+
+/**
+   Sorts a given array pointed to by elts in ascending order of the keys
+   at the beginning of its elements with a parallel least significant
+   digit (LSD) radix sort with 8-bit digits, without a comparison
+   function. The keys are unsigned integers of any unsigned integer type,
+   or doubles in the IEEE 754 format, whose bit patterns are mapped to
+   unsigned integers of the same order. Each of num_threads threads counts
+   the digits of a block of elements, and moves the elements of its block
+   to the offsets that are computed from the counts in each pass. A pass is
+   skipped if all keys have the same digit. If elt_size and key_size are
+   equal to sizeof(size_t), the keys are processed as size_t values,
+   otherwise the digits are read as bytes.
+   elts        : pointer to the array to sort
+   count       : > 0 count of elements in the array
+   elt_size    : size of each element in the array in bytes
+   key_size    : size of the key at the beginning of each element in bytes,
+                 which is sizeof(double) if key_type is
+                 MERGESORT_PTHREAD_KEY_DOUBLE
+   key_type    : MERGESORT_PTHREAD_KEY_UINT or MERGESORT_PTHREAD_KEY_DOUBLE
+   num_threads : > 0 number of threads including the calling thread
+*/
+void mergesort_pthread_radix(void *elts,
+			     size_t count,
+			     size_t elt_size,
+			     size_t key_size,
+			     int key_type,
+			     size_t num_threads);
+
 /**
    A constant upper bound for the number of recursive calls of thread entry
    functions placed on the stack of a thread. Reduces the total number of
    threads and provides an additional speedup if greater than 0. If equal to
    0, then each recursive call results in the creation of a new thread. The
-   macro is used as size_t.
+   macro is used as size_t, and is not used by mergesort_pthread_pool.
 */
 #define MERGESORT_PTHREAD_MAX_ONTHREAD_REC (20)
 
@@ -0,0 +1,256 @@
+/**
+   pool-pthread-test.c
+
+   Tests of a reusable work-stealing thread pool with nested fork-join
+   tasks, and of the overhead of the pool in comparison to the creation
+   of a thread for each task.
+
+   The following command line arguments can be used to customize tests:
+   pool-pthread-test
+      [0, # bits in size_t - 1) : a
+      [0, # bits in size_t - 1) : b s.t. 2^a <= count <= 2^b
+      [0, 6] : k for 2^k worker threads in the largest pool
+      [0, 1] : fork-join sum test on/off
+      [0, 1] : overhead test on/off
+
+   usage examples:
+   ./pool-pthread-test
+   ./pool-pthread-test 20 20
+   ./pool-pthread-test 10 20 3 1 0
+
+   pool-pthread-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 with the requirement that the pthreads API is available.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/time.h>
+#include "pool-pthread.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+#include "utilities-pthread.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "pool-pthread-test \n"
+  "[0, # bits in size_t - 1) : a \n"
+  "[0, # bits in size_t - 1) : b s.t. 2^a <= count <= 2^b \n"
+  "[0, 6] : k for 2^k worker threads in the largest pool \n"
+  "[0, 1] : fork-join sum test on/off \n"
+  "[0, 1] : overhead test on/off \n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {10, 20, 2, 1, 1};
+const size_t C_THREADS_LOG_MAX = 6;
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* fork-join sum test */
+const size_t C_SUM_BASE_COUNT = 1024;
+const size_t C_SUM_TRIALS = 5;
+
+/* overhead test */
+const size_t C_OVER_NUM_TASKS = 1000;
+
+typedef struct{
+  size_t p, r; /* [p, r) range */
+  size_t sum;
+  const size_t *elts;
+  pool_t *pool;
+} sum_arg_t;
+
+double timer();
+void print_test_result(int res);
+
+/**
+   Sums a range of elements by submitting the lower half of the range as a
+   task and summing the upper half in the calling thread.
+*/
+void *sum_task(void *arg){
+  size_t i, q;
+  sum_arg_t *sa = arg;
+  sum_arg_t children[2];
+  pool_group_t group;
+  sa->sum = 0;
+  if (sa->r - sa->p <= C_SUM_BASE_COUNT){
+    for (i = sa->p; i < sa->r; i++){
+      sa->sum += sa->elts[i];
+    }
+    return NULL;
+  }
+  q = sa->p + (sa->r - sa->p) / 2;
+  children[0] = *sa;
+  children[0].r = q;
+  children[1] = *sa;
+  children[1].p = q;
+  pool_group_init(&group);
+  pool_submit(sa->pool, sum_task, &children[0], &group);
+  sum_task(&children[1]);
+  pool_wait(sa->pool, &group);
+  sa->sum = children[0].sum + children[1].sum;
+  return NULL;
+}
+
+/**
+   Runs a test of nested fork-join sums across pools with 2^k worker
+   threads and array counts.
+*/
+void run_sum_test(int pow_count_start, int pow_count_end, size_t log_threads){
+  int res = 1;
+  int ci;
+  size_t i, j, k, count, num_threads;
+  size_t sum;
+  size_t *elts = NULL;
+  double t;
+  pool_t pool;
+  sum_arg_t sa;
+  elts = malloc_perror(pow_two(pow_count_end), sizeof(size_t));
+  printf("Test nested fork-join sums on a pool\n");
+  for (k = 0; k <= log_threads; k++){
+    num_threads = pow_two(k);
+    pool_init(&pool, num_threads);
+    printf("\t# worker threads: %lu\n", TOLU(num_threads));
+    for (ci = pow_count_start; ci <= pow_count_end; ci++){
+      count = pow_two(ci);
+      t = 0.0;
+      for (i = 0; i < C_SUM_TRIALS; i++){
+	sum = 0;
+	for (j = 0; j < count; j++){
+	  elts[j] = RANDOM();
+	  sum += elts[j];
+	}
+	sa.p = 0;
+	sa.r = count;
+	sa.elts = elts;
+	sa.pool = &pool;
+	t -= timer();
+	sum_task(&sa);
+	t += timer();
+	res *= (sa.sum == sum);
+      }
+      printf("\t\tcount: %lu, ave runtime: %.6f seconds\n",
+	     TOLU(count), t / C_SUM_TRIALS);
+    }
+    pool_free(&pool);
+  }
+  printf("\tcorrectness: ");
+  print_test_result(res);
+  free(elts);
+  elts = NULL;
+}
+
+/**
+   Runs a test comparing the submission of empty tasks to a pool with the
+   creation and joining of a thread for each task.
+*/
+
+void *empty_task(void *arg){
+  size_t *a = arg;
+  (*a)++;
+  return NULL;
+}
+
+void run_overhead_test(size_t log_threads){
+  int res = 1;
+  size_t i, k, num_threads;
+  size_t *counts = NULL;
+  double t;
+  pthread_t id;
+  pool_t pool;
+  pool_group_t group;
+  counts = calloc_perror(C_OVER_NUM_TASKS, sizeof(size_t));
+  printf("Test the overhead of %lu tasks\n", TOLU(C_OVER_NUM_TASKS));
+  t = timer();
+  for (i = 0; i < C_OVER_NUM_TASKS; i++){
+    thread_create_perror(&id, empty_task, &counts[i]);
+    thread_join_perror(id, NULL);
+  }
+  t = timer() - t;
+  printf("\tthread create and join:            %.6f seconds\n", t);
+  for (k = 0; k <= log_threads; k++){
+    num_threads = pow_two(k);
+    pool_init(&pool, num_threads);
+    pool_group_init(&group);
+    t = timer();
+    for (i = 0; i < C_OVER_NUM_TASKS; i++){
+      pool_submit(&pool, empty_task, &counts[i], &group);
+      pool_wait(&pool, &group);
+    }
+    t = timer() - t;
+    pool_free(&pool);
+    printf("\tpool submit and wait, %2lu threads: %.6f seconds\n",
+	   TOLU(num_threads), t);
+  }
+  for (i = 0; i < C_OVER_NUM_TASKS; i++){
+    res *= (counts[i] == log_threads + 2);
+  }
+  printf("\tcorrectness: ");
+  print_test_result(res);
+  free(counts);
+  counts = NULL;
+}
+
+/**
+   Times execution.
+*/
+double timer(){
+  struct timeval tm;
+  gettimeofday(&tm, NULL);
+  return tm.tv_sec + tm.tv_usec / (double)1000000;
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > C_FULL_BIT - 2 ||
+      args[0] > args[1] ||
+      args[2] > C_THREADS_LOG_MAX ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[3]) run_sum_test(args[0], args[1], args[2]);
+  if (args[4]) run_overhead_test(args[2]);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,343 @@
+/**
+   pool-pthread.c
+
+   Implementation of a reusable work-stealing thread pool for fork-join
+   parallelism.
+
+   A pool is initialized with a number of worker threads that sleep on a
+   condition variable when there are no queued tasks, and are joined when
+   the pool is freed. Creating and joining threads is thereby paid once
+   per pool and not once per task, e.g. when many medium-sized arrays are
+   sorted back to back.
+
+   Each worker thread has a deque of tasks protected by a mutex. A task
+   submitted by a worker is pushed to the bottom of the deque of the worker,
+   and a worker pops tasks from the bottom of its deque, so that the most
+   recently forked and typically smallest subproblem is run by the thread
+   that forked it, with warm caches. A worker with an empty deque steals
+   from the top of the deques of other workers, where the oldest and
+   typically largest subproblems are found. Tasks submitted by threads
+   outside the pool are pushed to an additional deque that is shared by
+   such threads, and from which all workers steal.
+
+   The count of queued tasks, the counts of pending tasks of groups, and
+   the count of idle threads are updated with the __atomic builtins of GCC
+   and Clang, and a submit, pop, or completion of a task only locks the
+   mutex of a deque. The count of queued tasks is incremented before a
+   task is pushed and decremented after a task is popped, so that it is
+   not lower than the number of tasks in the deques. The mutex of the pool
+   is only locked by a thread that goes to sleep on the condition variable
+   and by a thread that wakes up sleeping threads. A sleeping thread
+   increments the count of idle threads before it checks the counts under
+   the mutex, and a waking thread updates a count before it reads the count
+   of idle threads, both with sequentially consistent operations, so that
+   either the sleeping thread observes the update or the waking thread
+   observes the idle thread and broadcasts under the mutex.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirements that the pthreads API and the __atomic
+   builtins of GCC and Clang are available.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "pool-pthread.h"
+#include "utilities-mem.h"
+#include "utilities-pthread.h"
+
+/* the counts are size_t members of the structs of pool-pthread.h */
+#if !defined(__GNUC__)
+#error "pool-pthread requires GCC/Clang __atomic builtins"
+#endif
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define LOAD_SEQ_CST(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ADD_SEQ_CST(p, v) __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define SUB_SEQ_CST(p, v) __atomic_sub_fetch((p), (v), __ATOMIC_SEQ_CST)
+
+static const size_t C_DEQUE_INIT_COUNT = 64;
+
+static void *worker_thread(void *arg);
+static int take(pool_t *pool, size_t id, pool_task_t *task);
+static void run(pool_t *pool, const pool_task_t *task);
+static int pop_bottom(pool_t *pool, pool_deque_t *dq, pool_task_t *task);
+static int pop_top(pool_t *pool, pool_deque_t *dq, pool_task_t *task);
+static void grow(pool_deque_t *dq);
+static void sleep_while_empty(pool_t *pool, const pool_group_t *group);
+static void wake(pool_t *pool);
+static size_t self_id(const pool_t *pool);
+
+/**
+   Initializes a pool and starts its worker threads.
+   pool        : pointer to a preallocated block of size sizeof(pool_t)
+   num_threads : > 0 number of worker threads
+*/
+void pool_init(pool_t *pool, size_t num_threads){
+  size_t i;
+  int err;
+  pool->num_threads = num_threads;
+  pool->num_queued = 0;
+  pool->num_idle = 0;
+  pool->is_stop = 0;
+  pool->workers = malloc_perror(num_threads, sizeof(pool_worker_t));
+  pool->threads = malloc_perror(num_threads, sizeof(pthread_t));
+  pool->deques = malloc_perror(add_sz_perror(num_threads, 1),
+			       sizeof(pool_deque_t));
+  for (i = 0; i <= num_threads; i++){
+    pool->deques[i].beg = 0;
+    pool->deques[i].num_tasks = 0;
+    pool->deques[i].count = C_DEQUE_INIT_COUNT;
+    pool->deques[i].tasks = malloc_perror(C_DEQUE_INIT_COUNT,
+					  sizeof(pool_task_t));
+    mutex_init_perror(&pool->deques[i].mutex);
+  }
+  err = pthread_key_create(&pool->key, NULL);
+  if (err != 0){
+    perror("pthread_key_create failed");
+    exit(EXIT_FAILURE);
+  }
+  mutex_init_perror(&pool->mutex);
+  cond_init_perror(&pool->cond);
+  for (i = 0; i < num_threads; i++){
+    pool->workers[i].pool = pool;
+    pool->workers[i].id = i;
+    thread_create_perror(&pool->threads[i], worker_thread,
+			 &pool->workers[i]);
+  }
+}
+
+/**
+   Initializes a group of tasks with no pending tasks. A group can be
+   reused after a return of pool_wait on the group.
+   group       : pointer to a preallocated block of size
+                 sizeof(pool_group_t)
+*/
+void pool_group_init(pool_group_t *group){
+  group->num_pending = 0;
+}
+
+/**
+   Submits a task to a pool. The task is pushed to the deque of the calling
+   worker thread, or to the shared deque if the caller is not a worker
+   thread of the pool.
+   pool        : pointer to an initialized pool
+   fn          : pointer to a task function
+   arg         : argument of fn, which is valid until the task is completed
+   group       : pointer to an initialized group of the task
+*/
+void pool_submit(pool_t *pool,
+		 void *(*fn)(void *),
+		 void *arg,
+		 pool_group_t *group){
+  pool_deque_t *dq = &pool->deques[self_id(pool)];
+  pool_task_t *task = NULL;
+  ADD_SEQ_CST(&group->num_pending, 1);
+  ADD_SEQ_CST(&pool->num_queued, 1);
+  mutex_lock_perror(&dq->mutex);
+  if (dq->num_tasks == dq->count) grow(dq);
+  task = &dq->tasks[(dq->beg + dq->num_tasks) % dq->count];
+  task->fn = fn;
+  task->arg = arg;
+  task->group = group;
+  dq->num_tasks++;
+  mutex_unlock_perror(&dq->mutex);
+  wake(pool);
+}
+
+/**
+   Returns after all tasks of a group are completed. The calling thread
+   runs queued tasks of the pool while the group is pending.
+   pool        : pointer to an initialized pool
+   group       : pointer to a group of tasks
+*/
+void pool_wait(pool_t *pool, pool_group_t *group){
+  size_t id = self_id(pool);
+  pool_task_t task;
+  /* acquire the results of the completed tasks of the group */
+  while (LOAD_ACQUIRE(&group->num_pending) > 0){
+    if (take(pool, id, &task)){
+      run(pool, &task);
+    }else{
+      sleep_while_empty(pool, group);
+    }
+  }
+}
+
+/**
+   Completes the queued tasks, joins the worker threads, and frees the
+   memory allocated by a pool. Tasks are not submitted concurrently with
+   a call to pool_free.
+   pool        : pointer to an initialized pool
+*/
+void pool_free(pool_t *pool){
+  int err;
+  size_t i;
+  mutex_lock_perror(&pool->mutex);
+  pool->is_stop = 1;
+  cond_broadcast_perror(&pool->cond);
+  mutex_unlock_perror(&pool->mutex);
+  for (i = 0; i < pool->num_threads; i++){
+    thread_join_perror(pool->threads[i], NULL);
+  }
+  for (i = 0; i <= pool->num_threads; i++){
+    mutex_destroy_perror(&pool->deques[i].mutex);
+    free(pool->deques[i].tasks);
+    pool->deques[i].tasks = NULL;
+  }
+  mutex_destroy_perror(&pool->mutex);
+  cond_destroy_perror(&pool->cond);
+  err = pthread_key_delete(pool->key);
+  if (err != 0){
+    perror("pthread_key_delete failed");
+    exit(EXIT_FAILURE);
+  }
+  free(pool->workers);
+  free(pool->threads);
+  free(pool->deques);
+  pool->workers = NULL;
+  pool->threads = NULL;
+  pool->deques = NULL;
+}
+
+/**
+   Enters a worker thread that runs tasks until the pool is stopped and
+   there are no queued tasks.
+*/
+static void *worker_thread(void *arg){
+  pool_worker_t *w = arg;
+  pool_t *pool = w->pool;
+  pool_task_t task;
+  int err = pthread_setspecific(pool->key, w);
+  if (err != 0){
+    perror("pthread_setspecific failed");
+    exit(EXIT_FAILURE);
+  }
+  while (1){
+    if (take(pool, w->id, &task)){
+      run(pool, &task);
+      continue;
+    }
+    sleep_while_empty(pool, NULL);
+    mutex_lock_perror(&pool->mutex);
+    if (LOAD_SEQ_CST(&pool->num_queued) == 0 && pool->is_stop){
+      mutex_unlock_perror(&pool->mutex);
+      break;
+    }
+    mutex_unlock_perror(&pool->mutex);
+  }
+  return NULL;
+}
+
+/**
+   Takes a task from the bottom of the deque at index id, or steals a task
+   from the top of another deque, starting at the next index. Returns 1 if
+   a task was taken, otherwise returns 0.
+*/
+static int take(pool_t *pool, size_t id, pool_task_t *task){
+  size_t i, v;
+  size_t num_deques = pool->num_threads + 1;
+  if (pop_bottom(pool, &pool->deques[id], task)) return 1;
+  v = id;
+  for (i = 1; i < num_deques; i++){
+    v = (v + 1 == num_deques) ? 0 : v + 1;
+    if (pop_top(pool, &pool->deques[v], task)) return 1;
+  }
+  return 0;
+}
+
+/**
+   Runs a task and completes it in its group. Threads waiting on a group
+   are woken up when the group has no pending tasks.
+*/
+static void run(pool_t *pool, const pool_task_t *task){
+  task->fn(task->arg);
+  if (SUB_SEQ_CST(&task->group->num_pending, 1) == 0) wake(pool);
+}
+
+/**
+   Pop a task from the bottom and the top of a deque. Return 1 if a task
+   was popped, otherwise return 0.
+*/
+
+static int pop_bottom(pool_t *pool, pool_deque_t *dq, pool_task_t *task){
+  mutex_lock_perror(&dq->mutex);
+  if (dq->num_tasks == 0){
+    mutex_unlock_perror(&dq->mutex);
+    return 0;
+  }
+  dq->num_tasks--;
+  *task = dq->tasks[(dq->beg + dq->num_tasks) % dq->count];
+  mutex_unlock_perror(&dq->mutex);
+  SUB_SEQ_CST(&pool->num_queued, 1);
+  return 1;
+}
+
+static int pop_top(pool_t *pool, pool_deque_t *dq, pool_task_t *task){
+  mutex_lock_perror(&dq->mutex);
+  if (dq->num_tasks == 0){
+    mutex_unlock_perror(&dq->mutex);
+    return 0;
+  }
+  *task = dq->tasks[dq->beg];
+  dq->beg = (dq->beg + 1 == dq->count) ? 0 : dq->beg + 1;
+  dq->num_tasks--;
+  mutex_unlock_perror(&dq->mutex);
+  SUB_SEQ_CST(&pool->num_queued, 1);
+  return 1;
+}
+
+/**
+   Sleeps on the condition variable of a pool while there are no queued
+   tasks, the pool is not stopped, and, if group is not NULL, the group
+   has pending tasks.
+*/
+static void sleep_while_empty(pool_t *pool, const pool_group_t *group){
+  mutex_lock_perror(&pool->mutex);
+  ADD_SEQ_CST(&pool->num_idle, 1);
+  while (LOAD_SEQ_CST(&pool->num_queued) == 0 && !pool->is_stop &&
+	 (group == NULL || LOAD_SEQ_CST(&group->num_pending) > 0)){
+    cond_wait_perror(&pool->cond, &pool->mutex);
+  }
+  SUB_SEQ_CST(&pool->num_idle, 1);
+  mutex_unlock_perror(&pool->mutex);
+}
+
+/**
+   Wakes up the sleeping threads of a pool after a count was updated with a
+   sequentially consistent operation.
+*/
+static void wake(pool_t *pool){
+  if (LOAD_SEQ_CST(&pool->num_idle) > 0){
+    mutex_lock_perror(&pool->mutex);
+    cond_broadcast_perror(&pool->cond);
+    mutex_unlock_perror(&pool->mutex);
+  }
+}
+
+/**
+   Doubles the count of task blocks of a full deque, which is locked by
+   the caller, and moves the tasks to the beginning of the new buffer.
+*/
+static void grow(pool_deque_t *dq){
+  size_t i;
+  pool_task_t *tasks = NULL;
+  tasks = malloc_perror(mul_sz_perror(dq->count, 2), sizeof(pool_task_t));
+  for (i = 0; i < dq->num_tasks; i++){
+    tasks[i] = dq->tasks[(dq->beg + i) % dq->count];
+  }
+  free(dq->tasks);
+  dq->tasks = tasks;
+  dq->beg = 0;
+  dq->count *= 2;
+}
+
+/**
+   Returns the index of the deque of the calling thread, which is the
+   index of the shared deque if the caller is not a worker of the pool.
+*/
+static size_t self_id(const pool_t *pool){
+  const pool_worker_t *w = pthread_getspecific(pool->key);
+  if (w == NULL) return pool->num_threads;
+  return w->id;
+}
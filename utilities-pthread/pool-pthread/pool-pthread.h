@@ -0,0 +1,125 @@
+/**
+   pool-pthread.h
+
+   Declarations of accessible functions of a reusable work-stealing thread
+   pool for fork-join parallelism.
+
+   A pool is initialized with a number of worker threads that sleep on a
+   condition variable when there are no queued tasks, and are joined when
+   the pool is freed. Creating and joining threads is thereby paid once
+   per pool and not once per task, e.g. when many medium-sized arrays are
+   sorted back to back.
+
+   Each worker thread has a deque of tasks protected by a mutex. A task
+   submitted by a worker is pushed to the bottom of the deque of the worker,
+   and a worker pops tasks from the bottom of its deque, so that the most
+   recently forked and typically smallest subproblem is run by the thread
+   that forked it, with warm caches. A worker with an empty deque steals
+   from the top of the deques of other workers, where the oldest and
+   typically largest subproblems are found. Tasks submitted by threads
+   outside the pool are pushed to an additional deque that is shared by
+   such threads, and from which all workers steal.
+
+   A task belongs to a group, and pool_wait returns when all tasks of a
+   group are completed. A thread in pool_wait runs queued tasks while the
+   group is pending, so that nested fork-join calls by worker threads do
+   not deadlock, and the thread that calls pool_wait from outside the pool
+   participates in the computation.
+
+   A task function has the signature of a pthread start routine, so that
+   thread entry functions that are used with thread_create_perror are
+   submitted without wrappers. The return value of a task is ignored.
+
+   The implementation does not use stdint.h and is portable under C89/C90
+   and C99 with the requirements that the pthreads API and the __atomic
+   builtins of GCC and Clang are available.
+*/
+
+#ifndef POOL_PTHREAD_H
+#define POOL_PTHREAD_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+typedef struct{
+  size_t num_pending; /* accessed with __atomic builtins */
+} pool_group_t;
+
+typedef struct{
+  void *(*fn)(void *);
+  void *arg;
+  pool_group_t *group;
+} pool_task_t;
+
+typedef struct{
+  size_t beg;
+  size_t num_tasks;
+  size_t count; /* count of task blocks */
+  pool_task_t *tasks; /* circular buffer */
+  pthread_mutex_t mutex; /* the result of referring to a copy is undefined */
+} pool_deque_t;
+
+typedef struct{
+  void *pool;
+  size_t id; /* index of the deque of a worker thread */
+} pool_worker_t;
+
+typedef struct{
+  size_t num_threads;
+  size_t num_queued; /* accessed with __atomic builtins */
+  size_t num_idle; /* accessed with __atomic builtins */
+  int is_stop; /* accessed under the mutex */
+  pool_worker_t *workers;
+  pthread_t *threads;
+  pool_deque_t *deques; /* num_threads + 1 deques */
+  pthread_key_t key;
+  pthread_mutex_t mutex; /* the result of referring to a copy is undefined */
+  pthread_cond_t cond; /* the result of referring to a copy is undefined */
+} pool_t; /* the result of referring to a copy of an instance is undefined */
+
+/**
+   Initializes a pool and starts its worker threads.
+   pool        : pointer to a preallocated block of size sizeof(pool_t)
+   num_threads : > 0 number of worker threads
+*/
+void pool_init(pool_t *pool, size_t num_threads);
+
+/**
+   Initializes a group of tasks with no pending tasks. A group can be
+   reused after a return of pool_wait on the group.
+   group       : pointer to a preallocated block of size
+                 sizeof(pool_group_t)
+*/
+void pool_group_init(pool_group_t *group);
+
+/**
+   Submits a task to a pool. The task is pushed to the deque of the calling
+   worker thread, or to the shared deque if the caller is not a worker
+   thread of the pool.
+   pool        : pointer to an initialized pool
+   fn          : pointer to a task function
+   arg         : argument of fn, which is valid until the task is completed
+   group       : pointer to an initialized group of the task
+*/
+void pool_submit(pool_t *pool,
+		 void *(*fn)(void *),
+		 void *arg,
+		 pool_group_t *group);
+
+/**
+   Returns after all tasks of a group are completed. The calling thread
+   runs queued tasks of the pool while the group is pending.
+   pool        : pointer to an initialized pool
+   group       : pointer to a group of tasks
+*/
+void pool_wait(pool_t *pool, pool_group_t *group);
+
+/**
+   Completes the queued tasks, joins the worker threads, and frees the
+   memory allocated by a pool. Tasks are not submitted concurrently with
+   a call to pool_free.
+   pool        : pointer to an initialized pool
+*/
+void pool_free(pool_t *pool);
+
+#endif
@@ -2,15 +2,17 @@
    utilities-pthread.c
 
    Utility functions for concurrency, including
-   1) pthread functions with wrapped error checking, and
+   1) pthread functions with wrapped error checking,
    2) an implementation of semaphore operations based on 1),
    adopted from The Little Book of Semaphores by Allen B. Downey
-   (Version 2.2.1) with modifications.
+   (Version 2.2.1) with modifications, and
+   3) an implementation of a reusable barrier based on 1).
 */
 
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <pthread.h>
 #include "utilities-pthread.h"
 
@@ -38,8 +40,9 @@ void thread_join_perror(pthread_t thread, void **retval){
 }
 
 /**
-   Initialize with default attributes, lock, and unlock a mutex with
-   error checking.
+   Initialize with default attributes, lock, try to lock, unlock, and
+   destroy a mutex with error checking. mutex_trylock_perror returns 1 if
+   the mutex was locked by the call, and 0 if the mutex was already locked.
 */
 
 void mutex_init_perror(pthread_mutex_t *mutex){
@@ -58,6 +61,16 @@ void mutex_lock_perror(pthread_mutex_t *mutex){
   }
 }
 
+int mutex_trylock_perror(pthread_mutex_t *mutex){
+  int err = pthread_mutex_trylock(mutex);
+  if (err == EBUSY) return 0;
+  if (err != 0){
+    perror("pthread_mutex_trylock failed");
+    exit(EXIT_FAILURE);
+  }
+  return 1;
+}
+
 void mutex_unlock_perror(pthread_mutex_t *mutex){
   int err = pthread_mutex_unlock(mutex);
   if (err != 0){
@@ -66,9 +79,18 @@ void mutex_unlock_perror(pthread_mutex_t *mutex){
   }
 }
 
+void mutex_destroy_perror(pthread_mutex_t *mutex){
+  int err = pthread_mutex_destroy(mutex);
+  if (err != 0){
+    perror("pthread_mutex_destroy failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
 /**
    Initialize a condition variable with default attributes and
-   error checking. Wait on and signal a condition with error checking.
+   error checking. Wait on and signal a condition, and destroy a condition
+   variable with error checking.
 */
 
 void cond_init_perror(pthread_cond_t *cond){
@@ -103,6 +125,14 @@ void cond_broadcast_perror(pthread_cond_t *cond){
   }
 }
 
+void cond_destroy_perror(pthread_cond_t *cond){
+  int err = pthread_cond_destroy(cond);
+  if (err != 0){
+    perror("pthread_cond_destroy failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
 /**
    Initialize, wait on, and signal a semaphore with error checking
    provided by mutex and condition variable operations.
@@ -137,3 +167,36 @@ void sema_signal_perror(sema_t *sema){
   }
   mutex_unlock_perror(&sema->mutex);
 }
+
+/**
+   Initialize and wait on a reusable barrier for count > 0 threads
+   with error checking provided by mutex and condition variable operations.
+   A wait returns after count threads called wait in the current phase of
+   the barrier, and the barrier is then in the next phase.
+*/
+
+void barrier_init_perror(barrier_t *barrier, int count){
+  barrier->count = count;
+  barrier->num_waiting = 0;
+  barrier->phase = 0;
+  mutex_init_perror(&barrier->mutex);
+  cond_init_perror(&barrier->cond);
+}
+
+void barrier_wait_perror(barrier_t *barrier){
+  unsigned int phase;
+  mutex_lock_perror(&barrier->mutex);
+  phase = barrier->phase;
+  barrier->num_waiting++;
+  if (barrier->num_waiting == barrier->count){
+    barrier->num_waiting = 0;
+    barrier->phase++; /* wraps around */
+    cond_broadcast_perror(&barrier->cond);
+  }else{
+    while (phase == barrier->phase){
+      /* accounting due to spurious wakeups */
+      cond_wait_perror(&barrier->cond, &barrier->mutex);
+    }
+  }
+  mutex_unlock_perror(&barrier->mutex);
+}
@@ -2,10 +2,11 @@
    utilities-pthread.h
 
    Declarations of accessible utility functions for concurrency, including
-   1) pthread functions with wrapped error checking, and
+   1) pthread functions with wrapped error checking,
    2) an implementation of semaphore operations based on 1),
    adopted from The Little Book of Semaphores by Allen B. Downey
-   (Version 2.2.1) with modifications.
+   (Version 2.2.1) with modifications, and
+   3) an implementation of a reusable barrier based on 1).
 */
 
 #ifndef UTILITIES_PTHREAD_H
@@ -20,6 +21,14 @@ typedef struct{
   pthread_cond_t cond; /* the result of referring to a copy is undefined */
 } sema_t; /* the result of referring to a copy of an instance is undefined */
 
+typedef struct{
+  int count;
+  int num_waiting;
+  unsigned int phase;
+  pthread_mutex_t mutex; /* the result of referring to a copy is undefined */
+  pthread_cond_t cond; /* the result of referring to a copy is undefined */
+} barrier_t; /* the result of referring to a copy of an instance is undefined */
+
 
 /**
    Create a thread with default attributes and error checking. Join a thread
@@ -32,19 +41,25 @@ void thread_create_perror(pthread_t *thread,
 void thread_join_perror(pthread_t thread, void **retval);
 
 /**
-   Initialize with default attributes, lock, and unlock a mutex with
-   error checking.
+   Initialize with default attributes, lock, try to lock, unlock, and
+   destroy a mutex with error checking. mutex_trylock_perror returns 1 if
+   the mutex was locked by the call, and 0 if the mutex was already locked.
 */
 
 void mutex_init_perror(pthread_mutex_t *mutex);
 
 void mutex_lock_perror(pthread_mutex_t *mutex);
 
+int mutex_trylock_perror(pthread_mutex_t *mutex);
+
 void mutex_unlock_perror(pthread_mutex_t *mutex);
 
+void mutex_destroy_perror(pthread_mutex_t *mutex);
+
 /**
    Initialize a condition variable with default attributes and
-   error checking. Wait on and signal a condition with error checking.
+   error checking. Wait on and signal a condition, and destroy a condition
+   variable with error checking.
 */
 
 void cond_init_perror(pthread_cond_t *cond);
@@ -55,6 +70,8 @@ void cond_signal_perror(pthread_cond_t *cond);
 
 void cond_broadcast_perror(pthread_cond_t *cond);
 
+void cond_destroy_perror(pthread_cond_t *cond);
+
 /**
    Initialize, wait on, and signal a semaphore with error checking
    provided by mutex and condition variable operations.
@@ -66,4 +83,15 @@ void sema_wait_perror(sema_t *sema);
 
 void sema_signal_perror(sema_t *sema);
 
+/**
+   Initialize and wait on a reusable barrier for count > 0 threads
+   with error checking provided by mutex and condition variable operations.
+   A wait returns after count threads called wait in the current phase of
+   the barrier, and the barrier is then in the next phase.
+*/
+
+void barrier_init_perror(barrier_t *barrier, int count);
+
+void barrier_wait_perror(barrier_t *barrier);
+
 #endif
@@ -0,0 +1,317 @@
+/**
+   utilities-bench-test.c
+
+   Tests of benchmark utilities.
+
+   The following command line arguments can be used to customize tests:
+   utilities-bench-test
+      [0, # bits in size_t - 1) : n for 2^n samples in the summary test
+      [0, 1] : summary test on/off
+      [0, 1] : timer test on/off
+      [0, 1] : output test on/off
+      [0, 1] : hardware counter test on/off
+
+   usage examples:
+   ./utilities-bench-test
+   ./utilities-bench-test 20
+   ./utilities-bench-test 10 0 1 1 1
+
+   utilities-bench-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 with the requirement that the POSIX clock_gettime function is
+   available. The hardware counter test succeeds if counters are not
+   available on a system.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "utilities-bench.h"
+#include "utilities-mem.h"
+#include "utilities-mod.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "utilities-bench-test \n"
+  "[0, # bits in size_t - 1) : n for 2^n samples in the summary test \n"
+  "[0, 1] : summary test on/off \n"
+  "[0, 1] : timer test on/off \n"
+  "[0, 1] : output test on/off \n"
+  "[0, 1] : hardware counter test on/off \n";
+const int C_ARGC_MAX = 6;
+const size_t C_ARGS_DEF[5] = {16, 1, 1, 1, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* timer test */
+const size_t C_SPIN_COUNT = 50000000;
+
+/* output test */
+const char *C_CSV_OUT[1] = {
+  "name,size,threads,ops,samples,wall_min_s,wall_median_s,wall_p99_s,"
+  "cpu_median_s,ops_per_sec,cycles_per_op,instructions_per_op,"
+  "l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op,"
+  "dtlb_misses_per_op,ipc\n"
+  "\"a,\"\"b\"\"\",8,2,100,4,0.250000000,0.500000000,1.000000000,"
+  "1.000000000,200.0,2.0000,1.0000,0.0500,0.0250,0.0100,,0.5000\n"
+  "none,0,1,0,0,0.000000000,0.000000000,0.000000000,0.000000000,0.0,"
+  ",,,,,,\n"};
+const char *C_JSON_OUT[2] = {
+  "[\n"
+  "  {\"name\": \"a,\\\"b\\\"\", \"size\": 8, \"threads\": 2, \"ops\": 100, "
+  "\"samples\": 4, \"wall_min_s\": 0.250000000, "
+  "\"wall_median_s\": 0.500000000, \"wall_p99_s\": 1.000000000, "
+  "\"cpu_median_s\": 1.000000000, \"ops_per_sec\": 200.0, "
+  "\"cycles_per_op\": 2.0000, \"instructions_per_op\": 1.0000, "
+  "\"l1d_misses_per_op\": 0.0500, \"llc_misses_per_op\": 0.0250, "
+  "\"branch_misses_per_op\": 0.0100, \"dtlb_misses_per_op\": null, "
+  "\"ipc\": 0.5000},\n",
+  "  {\"name\": \"none\", \"size\": 0, \"threads\": 1, \"ops\": 0, "
+  "\"samples\": 0, \"wall_min_s\": 0.000000000, "
+  "\"wall_median_s\": 0.000000000, \"wall_p99_s\": 0.000000000, "
+  "\"cpu_median_s\": 0.000000000, \"ops_per_sec\": 0.0, "
+  "\"cycles_per_op\": null, \"instructions_per_op\": null, "
+  "\"l1d_misses_per_op\": null, \"llc_misses_per_op\": null, "
+  "\"branch_misses_per_op\": null, \"dtlb_misses_per_op\": null, "
+  "\"ipc\": null}\n"
+  "]\n"};
+
+void print_test_result(int res);
+
+/**
+   Runs a test of the summary of samples that are a random permutation of
+   1, 2, ..., n, where the nearest-rank median is ceil(n / 2) and the
+   nearest-rank 99th percentile is ceil(99n / 100), across n in
+   [1, 2^log_count] and n = 2^log_count, with the CPU time of a sample
+   equal to twice its wall-clock runtime.
+*/
+int summary_correct(size_t n, size_t *perm, bench_t *b){
+  size_t i, j, k;
+  size_t p99_rank;
+  bench_stats_t s;
+  for (i = 0; i < n; i++){
+    perm[i] = i + 1;
+  }
+  for (i = n; i > 1; i--){
+    j = RANDOM() % i;
+    k = perm[i - 1];
+    perm[i - 1] = perm[j];
+    perm[j] = k;
+  }
+  bench_reset(b);
+  for (i = 0; i < n; i++){
+    bench_add(b, (double)perm[i], 2.0 * perm[i]);
+  }
+  bench_stats(b, &s);
+  p99_rank = (n / 100) * 99 + ((n % 100) * 99 + 99) / 100;
+  return (s.wall_min == 1.0 &&
+	  s.wall_med == (double)((n + 1) / 2) &&
+	  s.wall_p99 == (double)p99_rank &&
+	  s.cpu_med == 2.0 * ((n + 1) / 2) &&
+	  s.ops_per_sec == b->num_ops / (double)((n + 1) / 2) &&
+	  b->wall[0] == (double)perm[0]);
+}
+
+void run_summary_test(size_t log_count){
+  int res = 1;
+  size_t n, count = pow_two(log_count);
+  size_t *perm = NULL;
+  bench_t b;
+  bench_stats_t s;
+  perm = malloc_perror(count, sizeof(size_t));
+  bench_init(&b, "summary", count, 1, 1000, count);
+  printf("Test the summary of benchmark samples\n");
+  bench_stats(&b, &s);
+  res *= (s.wall_min == 0.0 && s.wall_med == 0.0 && s.wall_p99 == 0.0 &&
+	  s.cpu_med == 0.0 && s.ops_per_sec == 0.0);
+  for (n = 1; n <= count && n <= 1000; n++){
+    res *= summary_correct(n, perm, &b);
+  }
+  res *= summary_correct(count, perm, &b);
+  printf("\t# samples up to %lu: ", TOLU(count));
+  print_test_result(res);
+  bench_free(&b);
+  free(perm);
+  perm = NULL;
+}
+
+/**
+   Runs a test of the wall-clock and thread CPU timers on a busy loop.
+*/
+void run_timer_test(){
+  int res = 1;
+  size_t i;
+  volatile size_t sum = 0;
+  double wall, cpu;
+  printf("Test the wall-clock and thread CPU timers\n");
+  wall = bench_wall_time();
+  cpu = bench_thread_time();
+  for (i = 0; i < C_SPIN_COUNT; i++){
+    sum += i;
+  }
+  cpu = bench_thread_time() - cpu;
+  wall = bench_wall_time() - wall;
+  printf("\tbusy loop wall: %.6f seconds, cpu: %.6f seconds\n", wall, cpu);
+  res *= (wall > 0.0 && cpu > 0.0 && sum > 0);
+  printf("\tpositive elapsed times: ");
+  print_test_result(res);
+}
+
+/**
+   Runs a test of the CSV and JSON outputs of benchmark summaries,
+   including a name that requires quoting, counter values with a counter
+   that was not measured in a sample, and a benchmark without samples.
+*/
+void add_sample(bench_t *b, double wall, int is_dtlb){
+  size_t i;
+  double ctrs[BENCH_CTR_COUNT];
+  const double ctrs_per_wall[BENCH_CTR_COUNT] = {400.0, 200.0, 10.0,
+						 5.0, 2.0, 1.0};
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    ctrs[i] = wall * ctrs_per_wall[i];
+  }
+  if (!is_dtlb) ctrs[BENCH_CTR_DTLB_MISSES] = -1.0;
+  bench_add_ctrs(b, wall, 2.0 * wall, ctrs);
+}
+
+int out_correct(bench_format_t format,
+		const char **expected_parts,
+		size_t num_parts){
+  int res = 1;
+  size_t i, len = 0;
+  char *buf = NULL, *expected = NULL;
+  FILE *file = NULL;
+  bench_t b, e;
+  bench_out_t out;
+  file = tmpfile();
+  if (file == NULL){
+    perror("tmpfile failed");
+    exit(EXIT_FAILURE);
+  }
+  for (i = 0; i < num_parts; i++){
+    len += strlen(expected_parts[i]);
+  }
+  buf = calloc_perror(len + 2, 1);
+  expected = calloc_perror(len + 1, 1);
+  for (i = 0; i < num_parts; i++){
+    strcat(expected, expected_parts[i]);
+  }
+  bench_init(&b, "a,\"b\"", 8, 2, 100, 4);
+  bench_init(&e, "none", 0, 1, 0, 1);
+  add_sample(&b, 1.0, 1);
+  add_sample(&b, 0.25, 1);
+  add_sample(&b, 0.5, 0);
+  add_sample(&b, 0.75, 1);
+  bench_out_init(&out, file, format);
+  bench_out_write(&out, &b);
+  bench_out_write(&out, &e);
+  bench_out_free(&out);
+  rewind(file);
+  res *= (fread(buf, 1, len + 1, file) == len);
+  res *= (strcmp(buf, expected) == 0);
+  fclose(file);
+  bench_free(&b);
+  bench_free(&e);
+  free(buf);
+  free(expected);
+  buf = NULL;
+  expected = NULL;
+  return res;
+}
+
+void run_out_test(){
+  printf("Test the output of benchmark summaries\n");
+  printf("\tcsv:  ");
+  print_test_result(out_correct(BENCH_CSV, C_CSV_OUT, 1));
+  printf("\tjson: ");
+  print_test_result(out_correct(BENCH_JSON, C_JSON_OUT, 2));
+}
+
+/**
+   Runs a test of the hardware performance counters on a busy loop. A
+   counter that is not available has the value -1.0, and the count of
+   instructions is at least the count of iterations if it is available.
+*/
+void run_ctrs_test(){
+  int res = 1;
+  size_t i, num_ctrs;
+  volatile size_t sum = 0;
+  double vals[BENCH_CTR_COUNT];
+  bench_ctrs_t c;
+  printf("Test the hardware performance counters\n");
+  num_ctrs = bench_ctrs_init(&c);
+  printf("\t# available counters: %lu of %lu\n",
+	 TOLU(num_ctrs), TOLU(BENCH_CTR_COUNT));
+  bench_ctrs_start(&c);
+  for (i = 0; i < C_SPIN_COUNT; i++){
+    sum += i;
+  }
+  bench_ctrs_stop(&c, vals);
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    res *= (vals[i] >= 0.0 || vals[i] == -1.0);
+    num_ctrs -= (vals[i] >= 0.0 && num_ctrs > 0);
+  }
+  res *= (num_ctrs == 0 && sum > 0);
+  if (vals[BENCH_CTR_INSTRUCTIONS] >= 0.0){
+    printf("\tbusy loop instructions: %.0f, cycles: %.0f\n",
+	   vals[BENCH_CTR_INSTRUCTIONS], vals[BENCH_CTR_CYCLES]);
+    res *= (vals[BENCH_CTR_INSTRUCTIONS] >= C_SPIN_COUNT);
+  }
+  bench_ctrs_free(&c);
+  printf("\tcounter values: ");
+  print_test_result(res);
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > 1 ||
+      args[2] > 1 ||
+      args[3] > 1 ||
+      args[4] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[1]) run_summary_test(args[0]);
+  if (args[2]) run_timer_test();
+  if (args[3]) run_out_test();
+  if (args[4]) run_ctrs_test();
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -0,0 +1,517 @@
+/**
+   utilities-bench.c
+
+   Implementation of functions for timing repeated runs of a workload,
+   summarizing the runtimes, and writing the summaries in CSV or JSON
+   format.
+
+   The summary is computed on sorted copies of the samples, so that
+   samples can be added in any order and a benchmark can be summarized
+   more than once. A percentile p of n samples is the sample at the rank
+   ceil(p * n / 100) in the sorted order, which is computed without an
+   overflow for any n.
+
+   The hardware performance counters are opened as independent events
+   with perf_event_open on Linux, so that an unavailable counter does not
+   prevent the measurement of the other counters, and with the inherit
+   flag, so that the events of the threads created by a benchmarked
+   thread are included. Each counter reports the times during which it was
+   enabled and running, and its value is scaled by their ratio if the
+   kernel multiplexed the counters on fewer hardware counters. On other
+   systems, no counter is available.
+
+   The implementation of timers requires the POSIX clock_gettime function
+   with the CLOCK_MONOTONIC, CLOCK_THREAD_CPUTIME_ID, and
+   CLOCK_PROCESS_CPUTIME_ID clocks. The implementation does not use
+   stdint.h and is otherwise portable under C89/C90 and C99.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "utilities-bench.h"
+#include "utilities-mem.h"
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+static const char *C_CSV_HEADER =
+  "name,size,threads,ops,samples,wall_min_s,wall_median_s,wall_p99_s,"
+  "cpu_median_s,ops_per_sec,cycles_per_op,instructions_per_op,"
+  "l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op,"
+  "dtlb_misses_per_op,ipc\n";
+static const char *C_CTR_NAMES[BENCH_CTR_COUNT] = {"cycles_per_op",
+						   "instructions_per_op",
+						   "l1d_misses_per_op",
+						   "llc_misses_per_op",
+						   "branch_misses_per_op",
+						   "dtlb_misses_per_op"};
+
+#ifdef __linux__
+#define HW_CACHE_MISS(id, op) \
+  ((id) | ((op) << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+static const unsigned int C_CTR_TYPES[BENCH_CTR_COUNT] =
+  {PERF_TYPE_HARDWARE,
+   PERF_TYPE_HARDWARE,
+   PERF_TYPE_HW_CACHE,
+   PERF_TYPE_HARDWARE,
+   PERF_TYPE_HARDWARE,
+   PERF_TYPE_HW_CACHE};
+static const unsigned long C_CTR_CONFIGS[BENCH_CTR_COUNT] =
+  {PERF_COUNT_HW_CPU_CYCLES,
+   PERF_COUNT_HW_INSTRUCTIONS,
+   HW_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ),
+   PERF_COUNT_HW_CACHE_MISSES,
+   PERF_COUNT_HW_BRANCH_MISSES,
+   HW_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ)};
+#endif
+
+static double clock_time(clockid_t id, const char *msg);
+static double percentile(const double *sorted, size_t n, size_t pct);
+static void gather(const bench_t *b, size_t ix, double *vals);
+static double median_per_op(const double *vals,
+			    size_t n,
+			    const double *divs,
+			    double num_ops,
+			    double *buf);
+static int cmp_double(const void *a, const void *b);
+static void write_name(FILE *file, bench_format_t format, const char *name);
+static void write_ctr(FILE *file, bench_format_t format, double val);
+
+/**
+   Returns the time in seconds according to a monotonic wall clock. Only
+   the difference of two returned values is meaningful.
+*/
+double bench_wall_time(void){
+  return clock_time(CLOCK_MONOTONIC, "clock_gettime monotonic failed");
+}
+
+/**
+   Returns the CPU time in seconds consumed by the calling thread. Only
+   the difference of two values returned in the same thread is
+   meaningful.
+*/
+double bench_thread_time(void){
+  return clock_time(CLOCK_THREAD_CPUTIME_ID,
+		    "clock_gettime thread cputime failed");
+}
+
+/**
+   Returns the CPU time in seconds consumed by all threads of the process.
+   Only the difference of two returned values is meaningful.
+*/
+double bench_process_time(void){
+  return clock_time(CLOCK_PROCESS_CPUTIME_ID,
+		    "clock_gettime process cputime failed");
+}
+
+/**
+   Opens the hardware performance counters for the calling thread and the
+   threads that it creates afterwards. Returns the number of available
+   counters, which is 0 if no counter is available. The counters are
+   disabled until bench_ctrs_start is called.
+   c           : pointer to a preallocated block of size
+                 sizeof(bench_ctrs_t)
+*/
+size_t bench_ctrs_init(bench_ctrs_t *c){
+  size_t i, num_ctrs = 0;
+#ifdef __linux__
+  struct perf_event_attr attr;
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = C_CTR_TYPES[i];
+    attr.config = C_CTR_CONFIGS[i];
+    attr.read_format = (PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    c->fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (c->fds[i] < 0){
+      c->fds[i] = -1;
+    }else{
+      num_ctrs++;
+    }
+  }
+#else
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    c->fds[i] = -1;
+  }
+#endif
+  return num_ctrs;
+}
+
+/**
+   Resets and enables the available counters.
+*/
+void bench_ctrs_start(const bench_ctrs_t *c){
+#ifdef __linux__
+  size_t i;
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    if (c->fds[i] < 0) continue;
+    ioctl(c->fds[i], PERF_EVENT_IOC_RESET, 0);
+    ioctl(c->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+#else
+  (void)c;
+#endif
+}
+
+/**
+   Disables the available counters and copies their values, scaled if the
+   counters were multiplexed on the hardware, to the array of
+   BENCH_CTR_COUNT doubles pointed to by vals in the order of bench_ctr_t.
+   The value of a counter that is not available is -1.0.
+*/
+void bench_ctrs_stop(const bench_ctrs_t *c, double *vals){
+  size_t i;
+#ifdef __linux__
+  __u64 buf[3]; /* value, time enabled, time running */
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    if (c->fds[i] >= 0) ioctl(c->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+  }
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    vals[i] = -1.0;
+    if (c->fds[i] < 0 ||
+	read(c->fds[i], buf, sizeof(buf)) != (long)sizeof(buf) ||
+	buf[2] == 0){
+      continue;
+    }
+    vals[i] = (double)buf[0];
+    if (buf[2] < buf[1]) vals[i] *= (double)buf[1] / (double)buf[2];
+  }
+#else
+  (void)c;
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    vals[i] = -1.0;
+  }
+#endif
+}
+
+/**
+   Closes the counters and leaves a block of size sizeof(bench_ctrs_t)
+   pointed to by the c parameter.
+*/
+void bench_ctrs_free(bench_ctrs_t *c){
+  size_t i;
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+#ifdef __linux__
+    if (c->fds[i] >= 0) close(c->fds[i]);
+#endif
+    c->fds[i] = -1;
+  }
+}
+
+/**
+   Initializes a benchmark.
+   b           : pointer to a preallocated block of size sizeof(bench_t)
+   name        : pointer to a null-terminated name of a workload, which is
+                 valid until the benchmark is freed
+   size        : size parameter of the workload, e.g. a count of elements
+   num_threads : > 0 number of threads running the workload
+   num_ops     : number of operations in a run of the workload
+   count       : > 0 maximal number of samples
+*/
+void bench_init(bench_t *b,
+		const char *name,
+		size_t size,
+		size_t num_threads,
+		size_t num_ops,
+		size_t count){
+  b->name = name;
+  b->size = size;
+  b->num_threads = num_threads;
+  b->num_ops = num_ops;
+  b->num_samples = 0;
+  b->count = count;
+  b->wall = malloc_perror(count, sizeof(double));
+  b->cpu = malloc_perror(count, sizeof(double));
+  b->ctrs = malloc_perror(mul_sz_perror(count, BENCH_CTR_COUNT),
+			  sizeof(double));
+}
+
+/**
+   Adds a sample of a run to a benchmark with less than count samples.
+   b           : pointer to an initialized bench_t struct
+   wall        : wall-clock runtime of the run in seconds
+   cpu         : CPU time of the run in seconds, summed across threads
+*/
+void bench_add(bench_t *b, double wall, double cpu){
+  bench_add_ctrs(b, wall, cpu, NULL);
+}
+
+/**
+   Adds a sample of a run with the values of counters to a benchmark with
+   less than count samples. ctrs points to BENCH_CTR_COUNT values in the
+   order of bench_ctr_t, as copied by bench_ctrs_stop, where a negative
+   value indicates that a counter was not measured, or is NULL if no
+   counter was measured. Please see the parameter specification in
+   bench_add.
+*/
+void bench_add_ctrs(bench_t *b, double wall, double cpu, const double *ctrs){
+  size_t i;
+  double *p = b->ctrs + b->num_samples * BENCH_CTR_COUNT;
+  b->wall[b->num_samples] = wall;
+  b->cpu[b->num_samples] = cpu;
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    p[i] = (ctrs == NULL) ? -1.0 : ctrs[i];
+  }
+  b->num_samples++;
+}
+
+/**
+   Computes the summary of the samples of a benchmark. The samples are
+   not modified. All values in the summary are 0.0 if there are no
+   samples.
+   b           : pointer to an initialized bench_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(bench_stats_t)
+*/
+void bench_stats(const bench_t *b, bench_stats_t *s){
+  size_t i, n = b->num_samples;
+  double *sorted = NULL, *vals = NULL, *divs = NULL;
+  memset(s, 0, sizeof(bench_stats_t));
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    s->ctrs_per_op[i] = -1.0;
+  }
+  s->ipc = -1.0;
+  if (n == 0) return;
+  sorted = malloc_perror(n, sizeof(double));
+  memcpy(sorted, b->wall, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), cmp_double);
+  s->wall_min = sorted[0];
+  s->wall_med = percentile(sorted, n, 50);
+  s->wall_p99 = percentile(sorted, n, 99);
+  memcpy(sorted, b->cpu, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), cmp_double);
+  s->cpu_med = percentile(sorted, n, 50);
+  if (s->wall_med > 0.0) s->ops_per_sec = b->num_ops / s->wall_med;
+  vals = malloc_perror(n, sizeof(double));
+  divs = malloc_perror(n, sizeof(double));
+  for (i = 0; i < n; i++){
+    divs[i] = b->ctrs[i * BENCH_CTR_COUNT + BENCH_CTR_CYCLES];
+  }
+  for (i = 0; i < BENCH_CTR_COUNT; i++){
+    gather(b, i, vals);
+    s->ctrs_per_op[i] = median_per_op(vals, n, NULL, b->num_ops, sorted);
+    if (i == BENCH_CTR_INSTRUCTIONS){
+      s->ipc = median_per_op(vals, n, divs, 1.0, sorted);
+    }
+  }
+  free(sorted);
+  free(vals);
+  free(divs);
+  sorted = NULL;
+  vals = NULL;
+  divs = NULL;
+}
+
+/**
+   Deletes the samples of a benchmark, which can then be reused with the
+   same name and parameters.
+*/
+void bench_reset(bench_t *b){
+  b->num_samples = 0;
+}
+
+/**
+   Frees a benchmark and leaves a block of size sizeof(bench_t) pointed to
+   by the b parameter.
+*/
+void bench_free(bench_t *b){
+  free(b->wall);
+  free(b->cpu);
+  free(b->ctrs);
+  b->wall = NULL;
+  b->cpu = NULL;
+  b->ctrs = NULL;
+}
+
+/**
+   Initializes an output of benchmark summaries and writes the CSV header
+   or the opening bracket of a JSON array to a file.
+   out         : pointer to a preallocated block of size
+                 sizeof(bench_out_t)
+   file        : pointer to a file open for writing
+   format      : BENCH_CSV or BENCH_JSON
+*/
+void bench_out_init(bench_out_t *out, FILE *file, bench_format_t format){
+  out->file = file;
+  out->format = format;
+  out->num_rows = 0;
+  if (format == BENCH_CSV){
+    fputs(C_CSV_HEADER, file);
+  }else{
+    fputs("[", file);
+  }
+}
+
+/**
+   Writes the summary of a benchmark as a CSV row or as an object of a
+   JSON array, with the name and parameters of the benchmark. A name with
+   a comma or a double quote is quoted in CSV.
+*/
+void bench_out_write(bench_out_t *out, const bench_t *b){
+  size_t i;
+  bench_stats_t s;
+  bench_stats(b, &s);
+  if (out->format == BENCH_CSV){
+    write_name(out->file, out->format, b->name);
+    fprintf(out->file, ",%lu,%lu,%lu,%lu,%.9f,%.9f,%.9f,%.9f,%.1f",
+	    TOLU(b->size), TOLU(b->num_threads), TOLU(b->num_ops),
+	    TOLU(b->num_samples), s.wall_min, s.wall_med, s.wall_p99,
+	    s.cpu_med, s.ops_per_sec);
+    for (i = 0; i < BENCH_CTR_COUNT; i++){
+      fputc(',', out->file);
+      write_ctr(out->file, out->format, s.ctrs_per_op[i]);
+    }
+    fputc(',', out->file);
+    write_ctr(out->file, out->format, s.ipc);
+    fputc('\n', out->file);
+  }else{
+    fputs((out->num_rows == 0) ? "\n  {\"name\": " : ",\n  {\"name\": ",
+	  out->file);
+    write_name(out->file, out->format, b->name);
+    fprintf(out->file,
+	    ", \"size\": %lu, \"threads\": %lu, \"ops\": %lu, "
+	    "\"samples\": %lu, \"wall_min_s\": %.9f, "
+	    "\"wall_median_s\": %.9f, \"wall_p99_s\": %.9f, "
+	    "\"cpu_median_s\": %.9f, \"ops_per_sec\": %.1f",
+	    TOLU(b->size), TOLU(b->num_threads), TOLU(b->num_ops),
+	    TOLU(b->num_samples), s.wall_min, s.wall_med, s.wall_p99,
+	    s.cpu_med, s.ops_per_sec);
+    for (i = 0; i < BENCH_CTR_COUNT; i++){
+      fprintf(out->file, ", \"%s\": ", C_CTR_NAMES[i]);
+      write_ctr(out->file, out->format, s.ctrs_per_op[i]);
+    }
+    fputs(", \"ipc\": ", out->file);
+    write_ctr(out->file, out->format, s.ipc);
+    fputc('}', out->file);
+  }
+  out->num_rows++;
+}
+
+/**
+   Completes an output of benchmark summaries by writing the closing
+   bracket of a JSON array, and flushes the file. The file is not closed.
+*/
+void bench_out_free(bench_out_t *out){
+  if (out->format == BENCH_JSON){
+    fputs((out->num_rows == 0) ? "]\n" : "\n]\n", out->file);
+  }
+  fflush(out->file);
+  out->file = NULL;
+}
+
+/**
+   Returns the time of a clock in seconds, or provides an error message
+   and executes an exit if the clock is not available.
+*/
+static double clock_time(clockid_t id, const char *msg){
+  struct timespec ts;
+  if (clock_gettime(id, &ts) != 0){
+    perror(msg);
+    exit(EXIT_FAILURE);
+  }
+  return ts.tv_sec + ts.tv_nsec / (double)1000000000;
+}
+
+/**
+   Returns the sample at the rank ceil(pct * n / 100) of n > 0 sorted
+   samples, where pct is in [1, 100].
+*/
+static double percentile(const double *sorted, size_t n, size_t pct){
+  size_t rank = (n / 100) * pct + ((n % 100) * pct + 99) / 100;
+  return sorted[rank - 1];
+}
+
+/**
+   Copies the values of the counter at index ix across the samples of a
+   benchmark to vals.
+*/
+static void gather(const bench_t *b, size_t ix, double *vals){
+  size_t i;
+  for (i = 0; i < b->num_samples; i++){
+    vals[i] = b->ctrs[i * BENCH_CTR_COUNT + ix];
+  }
+}
+
+/**
+   Returns the median of vals[i] / divs[i] / num_ops across n > 0 samples,
+   where divs is NULL if each divisor is 1.0, or returns -1.0 if a value
+   or a divisor is negative, or a divisor or num_ops is 0.0. buf points to
+   a block of n doubles.
+*/
+static double median_per_op(const double *vals,
+			    size_t n,
+			    const double *divs,
+			    double num_ops,
+			    double *buf){
+  size_t i;
+  double div;
+  if (num_ops == 0.0) return -1.0;
+  for (i = 0; i < n; i++){
+    div = (divs == NULL) ? 1.0 : divs[i];
+    if (vals[i] < 0.0 || div <= 0.0) return -1.0;
+    buf[i] = vals[i] / div / num_ops;
+  }
+  qsort(buf, n, sizeof(double), cmp_double);
+  return percentile(buf, n, 50);
+}
+
+static int cmp_double(const void *a, const void *b){
+  if (*(const double *)a > *(const double *)b) return 1;
+  if (*(const double *)a < *(const double *)b) return -1;
+  return 0;
+}
+
+/**
+   Writes a name as a JSON string, or as a CSV field that is quoted if it
+   contains a comma, a double quote, or a newline.
+*/
+static void write_name(FILE *file, bench_format_t format, const char *name){
+  const char *c = NULL;
+  if (format == BENCH_CSV && strpbrk(name, ",\"\n") == NULL){
+    fputs(name, file);
+    return;
+  }
+  fputc('"', file);
+  for (c = name; *c != '\0'; c++){
+    if (*c == '"'){
+      fputs((format == BENCH_CSV) ? "\"\"" : "\\\"", file);
+    }else if (format == BENCH_JSON && *c == '\\'){
+      fputs("\\\\", file);
+    }else if (format == BENCH_JSON && *c == '\n'){
+      fputs("\\n", file);
+    }else{
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+/**
+   Writes a per-operation counter value, or an empty CSV field or a JSON
+   null if the value is negative.
+*/
+static void write_ctr(FILE *file, bench_format_t format, double val){
+  if (val >= 0.0){
+    fprintf(file, "%.4f", val);
+  }else if (format == BENCH_JSON){
+    fputs("null", file);
+  }
+}
@@ -0,0 +1,221 @@
+/**
+   utilities-bench.h
+
+   Declarations of accessible functions for timing repeated runs of a
+   workload, summarizing the runtimes, and writing the summaries in CSV or
+   JSON format.
+
+   A benchmark is a named workload with a size parameter, a number of
+   threads, and a number of operations per run. Each run adds a sample
+   with a wall-clock runtime and a CPU time. The CPU time of a run is the
+   sum of the CPU times of the threads that ran the workload, measured by
+   each thread with bench_thread_time, or the CPU time of the process
+   measured with bench_process_time if the threads are created within a
+   measured call, so that the ratio of the CPU time and the wall-clock
+   runtime of a multithreaded run indicates the number of threads that
+   were running at a time. The summary of a benchmark consists of the
+   minimum, median, and 99th percentile of the wall-clock runtimes, the
+   median of the CPU times, and the number of operations per second at the
+   median wall-clock runtime. A percentile is computed with the
+   nearest-rank method.
+
+   Optionally, a sample also records the values of hardware performance
+   counters, i.e. cycles, instructions, L1 data cache read misses,
+   last-level cache misses, branch misses, and data TLB read misses,
+   measured with perf_event_open around a run. The summary then provides
+   the median value of each counter per operation, and the median number
+   of instructions per cycle. The counters count user-space events of the
+   calling thread and of the threads that it creates after the counters
+   are opened, where the events of a created thread are included after
+   the thread exits. If a counter is not available, e.g. if perf_event_open
+   is restricted by the system or is not supported by a virtual machine,
+   or if the implementation is compiled on a system other than Linux, the
+   counter is not measured and its per-operation values are omitted from
+   the output.
+
+   The implementation of timers requires the POSIX clock_gettime function
+   with the CLOCK_MONOTONIC, CLOCK_THREAD_CPUTIME_ID, and
+   CLOCK_PROCESS_CPUTIME_ID clocks. The implementation does not use
+   stdint.h and is otherwise portable under C89/C90 and C99.
+*/
+
+#ifndef UTILITIES_BENCH_H
+#define UTILITIES_BENCH_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+typedef enum{BENCH_CSV, BENCH_JSON} bench_format_t;
+
+typedef enum{BENCH_CTR_CYCLES,
+	     BENCH_CTR_INSTRUCTIONS,
+	     BENCH_CTR_L1D_MISSES,
+	     BENCH_CTR_LLC_MISSES,
+	     BENCH_CTR_BRANCH_MISSES,
+	     BENCH_CTR_DTLB_MISSES,
+	     BENCH_CTR_COUNT} bench_ctr_t;
+
+typedef struct{
+  int fds[BENCH_CTR_COUNT]; /* -1 if a counter is not available */
+} bench_ctrs_t;
+
+typedef struct{
+  const char *name;   /* name of a workload, not copied */
+  size_t size;        /* size parameter of a workload */
+  size_t num_threads;
+  size_t num_ops;     /* operations per run */
+  size_t num_samples;
+  size_t count;       /* upper bound of num_samples */
+  double *wall;       /* wall-clock runtimes in seconds */
+  double *cpu;        /* summed thread CPU times in seconds */
+  double *ctrs;       /* BENCH_CTR_COUNT counter values per sample,
+			 negative if a counter was not measured */
+} bench_t;
+
+typedef struct{
+  double wall_min;
+  double wall_med;
+  double wall_p99;
+  double cpu_med;
+  double ops_per_sec; /* num_ops / wall_med, 0.0 if wall_med is 0.0 */
+  double ctrs_per_op[BENCH_CTR_COUNT]; /* negative if not measured in
+					  each sample or num_ops is 0 */
+  double ipc;         /* negative if not measured in each sample */
+} bench_stats_t;
+
+typedef struct{
+  FILE *file;
+  bench_format_t format;
+  size_t num_rows;
+} bench_out_t;
+
+/**
+   Returns the time in seconds according to a monotonic wall clock. Only
+   the difference of two returned values is meaningful.
+*/
+double bench_wall_time(void);
+
+/**
+   Returns the CPU time in seconds consumed by the calling thread. Only
+   the difference of two values returned in the same thread is
+   meaningful.
+*/
+double bench_thread_time(void);
+
+/**
+   Returns the CPU time in seconds consumed by all threads of the process.
+   Only the difference of two returned values is meaningful.
+*/
+double bench_process_time(void);
+
+/**
+   Opens the hardware performance counters for the calling thread and the
+   threads that it creates afterwards. Returns the number of available
+   counters, which is 0 if no counter is available. The counters are
+   disabled until bench_ctrs_start is called.
+   c           : pointer to a preallocated block of size
+                 sizeof(bench_ctrs_t)
+*/
+size_t bench_ctrs_init(bench_ctrs_t *c);
+
+/**
+   Resets and enables the available counters.
+*/
+void bench_ctrs_start(const bench_ctrs_t *c);
+
+/**
+   Disables the available counters and copies their values, scaled if the
+   counters were multiplexed on the hardware, to the array of
+   BENCH_CTR_COUNT doubles pointed to by vals in the order of bench_ctr_t.
+   The value of a counter that is not available is -1.0.
+*/
+void bench_ctrs_stop(const bench_ctrs_t *c, double *vals);
+
+/**
+   Closes the counters and leaves a block of size sizeof(bench_ctrs_t)
+   pointed to by the c parameter.
+*/
+void bench_ctrs_free(bench_ctrs_t *c);
+
+/**
+   Initializes a benchmark.
+   b           : pointer to a preallocated block of size sizeof(bench_t)
+   name        : pointer to a null-terminated name of a workload, which is
+                 valid until the benchmark is freed
+   size        : size parameter of the workload, e.g. a count of elements
+   num_threads : > 0 number of threads running the workload
+   num_ops     : number of operations in a run of the workload
+   count       : > 0 maximal number of samples
+*/
+void bench_init(bench_t *b,
+		const char *name,
+		size_t size,
+		size_t num_threads,
+		size_t num_ops,
+		size_t count);
+
+/**
+   Adds a sample of a run to a benchmark with less than count samples.
+   b           : pointer to an initialized bench_t struct
+   wall        : wall-clock runtime of the run in seconds
+   cpu         : CPU time of the run in seconds, summed across threads
+*/
+void bench_add(bench_t *b, double wall, double cpu);
+
+/**
+   Adds a sample of a run with the values of counters to a benchmark with
+   less than count samples. ctrs points to BENCH_CTR_COUNT values in the
+   order of bench_ctr_t, as copied by bench_ctrs_stop, where a negative
+   value indicates that a counter was not measured, or is NULL if no
+   counter was measured. Please see the parameter specification in
+   bench_add.
+*/
+void bench_add_ctrs(bench_t *b, double wall, double cpu, const double *ctrs);
+
+/**
+   Computes the summary of the samples of a benchmark. The samples are
+   not modified. All values in the summary are 0.0 if there are no
+   samples.
+   b           : pointer to an initialized bench_t struct
+   s           : pointer to a preallocated block of size
+                 sizeof(bench_stats_t)
+*/
+void bench_stats(const bench_t *b, bench_stats_t *s);
+
+/**
+   Deletes the samples of a benchmark, which can then be reused with the
+   same name and parameters.
+*/
+void bench_reset(bench_t *b);
+
+/**
+   Frees a benchmark and leaves a block of size sizeof(bench_t) pointed to
+   by the b parameter.
+*/
+void bench_free(bench_t *b);
+
+/**
+   Initializes an output of benchmark summaries and writes the CSV header
+   or the opening bracket of a JSON array to a file.
+   out         : pointer to a preallocated block of size
+                 sizeof(bench_out_t)
+   file        : pointer to a file open for writing
+   format      : BENCH_CSV or BENCH_JSON
+*/
+void bench_out_init(bench_out_t *out, FILE *file, bench_format_t format);
+
+/**
+   Writes the summary of a benchmark as a CSV row or as an object of a
+   JSON array, with the name and parameters of the benchmark. A name with
+   a comma or a double quote is quoted in CSV. A per-operation counter
+   value that was not measured is an empty CSV field or a JSON null.
+*/
+void bench_out_write(bench_out_t *out, const bench_t *b);
+
+/**
+   Completes an output of benchmark summaries by writing the closing
+   bracket of a JSON array, and flushes the file. The file is not closed.
+*/
+void bench_out_free(bench_out_t *out);
+
+#endif
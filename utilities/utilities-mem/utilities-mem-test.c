@@ -0,0 +1,155 @@
+/**
+   utilities-mem-test.c
+
+   Tests of utility functions for memory management.
+
+   The following command line arguments can be used to customize tests:
+   utilities-mem-test
+      [0, # bits in size_t - 1) : a
+      [0, # bits in size_t - 1) : b s.t. 2^a <= # bytes <= 2^b in tests
+      [0, 1] : large allocation test on/off
+
+   usage examples: 
+   ./utilities-mem-test
+   ./utilities-mem-test 10 28
+   ./utilities-mem-test 20 24 1
+
+   utilities-mem-test can be run with any subset of command line arguments
+   in the above-defined order. If the (i + 1)th argument is specified then
+   the ith argument must be specified for i >= 0. Default values are used
+   for the unspecified arguments according to the C_ARGS_DEF array.
+
+   The implementation of tests does not use stdint.h and is portable under
+   C89/C90 and C99.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "utilities-mem.h"
+
+/**
+   Generate random numbers in a portable way for test purposes only; rand()
+   in the Linux C Library uses the same generator as random(), which may not
+   be the case on older rand() implementations, and on current
+   implementations on different systems.
+*/
+#define RGENS_SEED() do{srand(time(NULL));}while (0)
+#define RANDOM() (rand()) /* [0, RAND_MAX] */
+
+#define TOLU(i) ((unsigned long int)(i)) /* printing size_t under C89/C90 */
+
+/* input handling */
+const char *C_USAGE =
+  "utilities-mem-test \n"
+  "[0, # bits in size_t - 1) : a \n"
+  "[0, # bits in size_t - 1) : b s.t. 2^a <= # bytes <= 2^b in tests \n"
+  "[0, 1] : large allocation test on/off \n";
+const int C_ARGC_MAX = 4;
+const size_t C_ARGS_DEF[3] = {0, 26, 1};
+const size_t C_FULL_BIT = CHAR_BIT * sizeof(size_t);
+
+/* large allocation tests */
+const size_t C_ACCESS_COUNT = 4194304; /* random accesses per block */
+const int C_POLICIES_COUNT = 5;
+const int C_POLICIES[5] = {0,
+			   MEM_LARGE_THP,
+			   MEM_LARGE_HUGETLB,
+			   MEM_LARGE_INTERLEAVE,
+			   MEM_LARGE_THP | MEM_LARGE_HUGETLB |
+			   MEM_LARGE_INTERLEAVE};
+const char *C_POLICY_NAMES[5] = {"malloc      ",
+				 "thp         ",
+				 "hugetlb     ",
+				 "interleave  ",
+				 "all flags   "};
+
+void print_test_result(int res);
+
+/**
+   Runs a test of calloc_large_perror, realloc_large_perror, and
+   free_large across policies. Each block is tested for alignment, zero
+   initialization and the preservation of its contents after growing, and
+   the runtime of random single-byte updates across the block is printed,
+   which is dominated by TLB misses on large blocks without huge pages.
+*/
+void run_large_test(size_t log_start, size_t log_end){
+  int res = 1;
+  int k;
+  size_t i, j, n;
+  size_t sum;
+  unsigned char *p = NULL;
+  clock_t t;
+  printf("Test calloc_large_perror, realloc_large_perror, and free_large "
+	 "across policies with the threshold of 0 bytes\n");
+  for (k = 0; k < C_POLICIES_COUNT; k++){
+    mem_large_policy(C_POLICIES[k], 0);
+    printf("\t%s\n", C_POLICY_NAMES[k]);
+    for (i = log_start; i <= log_end; i++){
+      n = (size_t)1 << i;
+      p = calloc_large_perror(n, 1);
+      res *= (((size_t)p & (MEM_LARGE_ALIGN - 1)) == 0);
+      for (j = 0; j < n; j++){
+	res *= (p[j] == 0);
+	p[j] = (unsigned char)j;
+      }
+      p = realloc_large_perror(p, 2, n); /* grow */
+      res *= (((size_t)p & (MEM_LARGE_ALIGN - 1)) == 0);
+      for (j = 0; j < n; j++){
+	res *= (p[j] == (unsigned char)j);
+      }
+      memset(p + n, 0, n);
+      sum = 0;
+      t = clock();
+      for (j = 0; j < C_ACCESS_COUNT; j++){
+	sum += ++p[(RANDOM() * (size_t)RAND_MAX + RANDOM()) & (2 * n - 1)];
+      }
+      t = clock() - t;
+      free_large(p);
+      p = NULL;
+      if (i == log_end || i % 4 == 0){
+	printf("\t\t2^%lu bytes, random updates: %.6f seconds (%lu)\n",
+	       TOLU(i + 1), (float)t / CLOCKS_PER_SEC, TOLU(sum & 1));
+      }
+    }
+  }
+  mem_large_policy(0, MEM_LARGE_HUGE_PAGE);
+  printf("\tcorrectness across all policies --> ");
+  print_test_result(res);
+}
+
+void print_test_result(int res){
+  if (res){
+    printf("SUCCESS\n");
+  }else{
+    printf("FAILURE\n");
+  }
+}
+
+int main(int argc, char *argv[]){
+  int i;
+  size_t *args = NULL;
+  RGENS_SEED();
+  if (argc > C_ARGC_MAX){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  args = malloc_perror(C_ARGC_MAX - 1, sizeof(size_t));
+  memcpy(args, C_ARGS_DEF, (C_ARGC_MAX - 1) * sizeof(size_t));
+  for (i = 1; i < argc; i++){
+    args[i - 1] = atoi(argv[i]);
+  }
+  if (args[0] > C_FULL_BIT - 2 ||
+      args[1] > C_FULL_BIT - 2 ||
+      args[1] < args[0] ||
+      args[2] > 1){
+    printf("USAGE:\n%s", C_USAGE);
+    exit(EXIT_FAILURE);
+  }
+  if (args[2]) run_large_test(args[0], args[1]);
+  free(args);
+  args = NULL;
+  return 0;
+}
@@ -2,14 +2,53 @@
    utilities-mem.c
 
    Utility functions for memory management.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99. The policies of large allocations are available on
+   Linux, and large blocks are allocated with malloc on other systems.
 */
 
+#if defined(__linux__)
+#define _DEFAULT_SOURCE /* mmap flags, madvise, and syscall under C89/C90 */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "utilities-mem.h"
 
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(MAP_ANONYMOUS)
+#define MEM_LARGE_MMAP
+#endif
+#endif
+
 static const size_t C_SIZE_MAX = (size_t)-1;
 
+/* header of a large block within MEM_LARGE_ALIGN bytes before the block */
+typedef struct{
+  void *base; /* beginning of malloc'ed or mapped memory */
+  size_t len; /* length of mapped memory, 0 if malloc'ed */
+  size_t cap; /* number of bytes available from the beginning of block */
+} large_hdr_t;
+
+static int large_flags = 0;
+static size_t large_threshold = MEM_LARGE_HUGE_PAGE;
+
+static large_hdr_t *hdr(void *ptr);
+static void *malloc_aligned(size_t n);
+#ifdef MEM_LARGE_MMAP
+static void *map_large(size_t n);
+#ifdef SYS_mbind
+static const int C_MPOL_INTERLEAVE = 3; /* MPOL_INTERLEAVE in numaif.h */
+static void interleave(void *base, size_t len);
+#endif
+#endif
+
 /**
    size_t addition and multiplication with wrapped overflow checking.
 */
@@ -78,3 +117,178 @@ void *calloc_perror(size_t num, size_t size){
   }
   return ptr;
 }
+
+/**
+   Sets the policy for blocks of at least threshold bytes to a bitwise or
+   of MEM_LARGE_ flags, or to 0 for malloc only. The default policy is 0
+   and the default threshold is MEM_LARGE_HUGE_PAGE.
+*/
+void mem_large_policy(int flags, size_t threshold){
+  large_flags = flags;
+  large_threshold = threshold;
+}
+
+/**
+   Malloc, calloc, realloc, and free of large blocks with wrapped error
+   checking, including integer overflow checking. A block that is grown by
+   realloc_large_perror is not moved if it has sufficient capacity, which
+   is rounded up to the size of a page in a mapped block.
+*/
+
+void *malloc_large_perror(size_t num, size_t size){
+  size_t n;
+  if (num > C_SIZE_MAX / size){
+    perror("malloc_large integer overflow");
+    exit(EXIT_FAILURE);
+  }
+  n = num * size;
+#ifdef MEM_LARGE_MMAP
+  if (large_flags != 0 && n >= large_threshold) return map_large(n);
+#endif
+  return malloc_aligned(n);
+}
+
+void *calloc_large_perror(size_t num, size_t size){
+  void *ptr = NULL;
+  if (num > C_SIZE_MAX / size){
+    perror("calloc_large integer overflow");
+    exit(EXIT_FAILURE);
+  }
+  ptr = malloc_large_perror(num, size);
+  /* mapped pages are zero-filled and are not touched */
+  if (hdr(ptr)->len == 0) memset(ptr, 0, num * size);
+  return ptr;
+}
+
+void *realloc_large_perror(void *ptr, size_t num, size_t size){
+  void *new_ptr = NULL;
+  if (num > C_SIZE_MAX / size){
+    perror("realloc_large integer overflow");
+    exit(EXIT_FAILURE);
+  }
+  if (ptr == NULL) return malloc_large_perror(num, size);
+  if (num * size <= hdr(ptr)->cap) return ptr;
+  new_ptr = malloc_large_perror(num, size);
+  memcpy(new_ptr, ptr, hdr(ptr)->cap);
+  free_large(ptr);
+  return new_ptr;
+}
+
+void free_large(void *ptr){
+  large_hdr_t *h = NULL;
+  if (ptr == NULL) return;
+  h = hdr(ptr);
+#ifdef MEM_LARGE_MMAP
+  if (h->len > 0){
+    munmap(h->base, h->len);
+    return;
+  }
+#endif
+  free(h->base);
+}
+
+/** Helper functions */
+
+/**
+   Returns a pointer to the header of a large block.
+*/
+static large_hdr_t *hdr(void *ptr){
+  return (large_hdr_t *)((char *)ptr - MEM_LARGE_ALIGN);
+}
+
+/**
+   Allocates a block of n bytes aligned at MEM_LARGE_ALIGN with malloc.
+*/
+static void *malloc_aligned(size_t n){
+  size_t rem;
+  char *base = NULL, *ptr = NULL;
+  if (n > C_SIZE_MAX - 2 * MEM_LARGE_ALIGN){
+    perror("malloc_large integer overflow");
+    exit(EXIT_FAILURE);
+  }
+  base = malloc(n + 2 * MEM_LARGE_ALIGN);
+  if (base == NULL){
+    perror("malloc_large failed");
+    exit(EXIT_FAILURE);
+  }
+  ptr = base + MEM_LARGE_ALIGN;
+  rem = (size_t)ptr & (MEM_LARGE_ALIGN - 1);
+  if (rem > 0) ptr += MEM_LARGE_ALIGN - rem;
+  hdr(ptr)->base = base;
+  hdr(ptr)->len = 0;
+  hdr(ptr)->cap = base + n + 2 * MEM_LARGE_ALIGN - ptr;
+  return ptr;
+}
+
+#ifdef MEM_LARGE_MMAP
+
+/**
+   Maps a block of n bytes according to the policy. The length of the
+   mapping is a multiple of the huge page size if a huge page flag is set,
+   and a THP mapping is aligned at the huge page size by unmapping the
+   unaligned head and tail of a longer mapping.
+*/
+static void *map_large(size_t n){
+  size_t pg, len, head;
+  char *base = MAP_FAILED;
+  int is_huge = large_flags & (MEM_LARGE_THP | MEM_LARGE_HUGETLB);
+  pg = is_huge ? MEM_LARGE_HUGE_PAGE : (size_t)sysconf(_SC_PAGESIZE);
+  if (n > C_SIZE_MAX - MEM_LARGE_ALIGN - 2 * pg){
+    perror("malloc_large integer overflow");
+    exit(EXIT_FAILURE);
+  }
+  len = (n + MEM_LARGE_ALIGN + pg - 1) / pg * pg;
+#ifdef MAP_HUGETLB
+  if (large_flags & MEM_LARGE_HUGETLB){
+    base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if (base == MAP_FAILED && (large_flags & MEM_LARGE_THP)){
+    base = mmap(NULL, len + pg, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base != MAP_FAILED){
+      head = (pg - ((size_t)base & (pg - 1))) & (pg - 1);
+      if (head > 0) munmap(base, head);
+      if (pg - head > 0) munmap(base + head + len, pg - head);
+      base += head;
+#ifdef MADV_HUGEPAGE
+      madvise(base, len, MADV_HUGEPAGE);
+#endif
+    }
+  }
+  if (base == MAP_FAILED){
+    base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (base == MAP_FAILED){
+    perror("malloc_large mmap failed");
+    exit(EXIT_FAILURE);
+  }
+#ifdef SYS_mbind
+  if (large_flags & MEM_LARGE_INTERLEAVE){
+    interleave(base, len);
+  }
+#endif
+  hdr(base + MEM_LARGE_ALIGN)->base = base;
+  hdr(base + MEM_LARGE_ALIGN)->len = len;
+  hdr(base + MEM_LARGE_ALIGN)->cap = len - MEM_LARGE_ALIGN;
+  return base + MEM_LARGE_ALIGN;
+}
+
+#ifdef SYS_mbind
+
+/**
+   Sets the NUMA policy of a mapping to interleave across all nodes. The
+   node mask is intersected with the allowed nodes by the system, and the
+   mapping keeps the default policy if the call fails.
+*/
+static void interleave(void *base, size_t len){
+  unsigned long mask = (unsigned long)-1;
+  syscall(SYS_mbind, base, len, C_MPOL_INTERLEAVE, &mask,
+	  (unsigned long)(CHAR_BIT * sizeof(unsigned long)), 0U);
+}
+
+#endif
+
+#endif
@@ -2,6 +2,10 @@
    utilities-mem.h
 
    Declarations of accessible utility functions for memory management.
+
+   The implementation does not use stdint.h and is portable under
+   C89/C90 and C99. The policies of large allocations are available on
+   Linux, and large blocks are allocated with malloc on other systems.
 */
 
 #ifndef UTILITIES_MEM_H
@@ -30,4 +34,59 @@ void *realloc_perror(void *ptr, size_t num, size_t size);
 
 void *calloc_perror(size_t num, size_t size);
 
+/**
+   Allocation of large blocks with an optional policy, for the large
+   arrays of data structures, such as the slot array of a hash table, the
+   block of pairs of a heap, and the blocks of a CSR adjacency list. Each
+   block is aligned at MEM_LARGE_ALIGN bytes, the size of a cache line on
+   current systems, and is only reallocated with realloc_large_perror and
+   freed with free_large.
+
+   A block of at least the threshold size is mapped directly from the
+   operating system with mmap on Linux if a policy flag is set, and
+   otherwise all blocks are allocated with malloc. The pages of a mapped
+   block are not touched by the allocation functions, including
+   calloc_large_perror, so that under the default first-touch NUMA policy
+   each page is placed on the node of the thread that first writes it,
+   e.g. by initializing a block in parallel across threads.
+   MEM_LARGE_THP        : transparent huge pages, requested with madvise
+                          for a block aligned at MEM_LARGE_HUGE_PAGE bytes
+   MEM_LARGE_HUGETLB    : explicit huge pages with MAP_HUGETLB from the
+                          preallocated huge page pool, falling back to the
+                          other flags if the pool is exhausted
+   MEM_LARGE_INTERLEAVE : pages interleaved across the NUMA nodes with
+                          mbind, for blocks accessed uniformly by threads
+                          on all nodes
+   The policy is a hint; a flag that is not supported by a system is
+   ignored. The policy is set before any thread allocates large blocks.
+*/
+
+#define MEM_LARGE_ALIGN 64
+#define MEM_LARGE_HUGE_PAGE 2097152
+#define MEM_LARGE_THP 1
+#define MEM_LARGE_HUGETLB 2
+#define MEM_LARGE_INTERLEAVE 4
+
+/**
+   Sets the policy for blocks of at least threshold bytes to a bitwise or
+   of MEM_LARGE_ flags, or to 0 for malloc only. The default policy is 0
+   and the default threshold is MEM_LARGE_HUGE_PAGE.
+*/
+void mem_large_policy(int flags, size_t threshold);
+
+/**
+   Malloc, calloc, realloc, and free of large blocks with wrapped error
+   checking, including integer overflow checking. A block that is grown by
+   realloc_large_perror is not moved if it has sufficient capacity, which
+   is rounded up to the size of a page in a mapped block.
+*/
+
+void *malloc_large_perror(size_t num, size_t size);
+
+void *calloc_large_perror(size_t num, size_t size);
+
+void *realloc_large_perror(void *ptr, size_t num, size_t size);
+
+void free_large(void *ptr);
+
 #endif
@@ -12,13 +12,15 @@
       [0, 1] : pow_mod, mul_mod, mul_mod_pow_two, and sum_mod tests on/off
       [0, 1] : mem_mod test on/off
       [0, 1] : fast_mem_mod test on/off
-      [0, 1] : mul_ext, represent_uint, and pow_two tests on/off
+      [0, 1] : mul_ext, mod_rcp, represent_uint, pow_two tests on/off
+      [0, 1] : mem_hash test on/off
 
    usage examples: 
    ./utilities-mod-test 20
    ./utilities-mod-test 20 11 0 15
    ./utilities-mod-test 20 11 25 25 0 1 1 0
    ./utilities-mod-test 20 11 30 30 0 0 1 0
+   ./utilities-mod-test 20 11 25 25 0 0 0 0 1
 
    utilities-mod-test can be run with any subset of command line arguments in
    the above-defined order. If the (i + 1)th argument is specified then the
@@ -60,9 +62,10 @@ const char *C_USAGE =
   "[0, 1] : pow_mod, mul_mod, mul_mod_pow_two, and sum_mod tests on/off \n"
   "[0, 1] : mem_mod test on/off \n"
   "[0, 1] : fast_mem_mod test on/off \n"
-  "[0, 1] : mul_ext, represent_uint, and pow_two tests on/off \n";
-const int C_ARGC_MAX = 9;
-const size_t C_ARGS_DEF[8] = {15, 10, 10, 15, 1, 1, 1, 1};
+  "[0, 1] : mul_ext, mod_rcp, represent_uint, pow_two tests on/off \n"
+  "[0, 1] : mem_hash test on/off \n";
+const int C_ARGC_MAX = 10;
+const size_t C_ARGS_DEF[9] = {15, 10, 10, 15, 1, 1, 1, 1, 1};
 
 /* tests */
 const unsigned char C_UCHAR_MAX = (unsigned char)-1;
@@ -418,6 +421,134 @@ void run_fast_mem_mod_test(int pow_trials,
   block = NULL;
 }
 
+/**
+   Tests mem_hash.
+*/
+void run_mem_hash_test(int pow_trials,
+		       int pow_size_start,
+		       int pow_size_end){
+  int res = 1;
+  int j;
+  unsigned char *block = NULL;
+  size_t i, k, trials;
+  size_t size, h;
+  clock_t t_h, t_m;
+  trials = pow_two(pow_trials);
+  printf("Run mem_hash on blocks that differ in one byte --> ");
+  fflush(stdout);
+  block = calloc_perror(1, trials);
+  for (i = 0; i < trials; i++){
+    size = i + 1;
+    for (k = 0; k < size; k++){
+      block[k] = DRAND() * C_UCHAR_MAX;
+    }
+    h = mem_hash(block, size);
+    res *= (h == mem_hash(block, size));
+    k = DRAND() * (size - 1);
+    block[k] ^= (unsigned char)(1 + DRAND() * (C_UCHAR_MAX - 1));
+    res *= (h != mem_hash(block, size));
+  }
+  print_test_result(res);
+  free(block);
+  block = NULL;
+  printf("Run mem_hash and fast_mem_mod on large memory blocks\n");
+  block = malloc_perror(1, add_sz_perror(pow_two(pow_size_end), 1));
+  for (k = 0; k < pow_two(pow_size_end) + 1; k++){
+    block[k] = DRAND() * C_UCHAR_MAX;
+  }
+  for (j = pow_size_start; j <= pow_size_end; j++){
+    size = pow_two(j) + 1;
+    t_h = clock();
+    h = mem_hash(block, size);
+    t_h = clock() - t_h;
+    t_m = clock();
+    h += fast_mem_mod(block, size, C_SIZE_MAX);
+    t_m = clock() - t_m;
+    printf("\tblock size:           %lu bytes \n", TOLU(size));
+    printf("\tmem_hash runtime:     %.8f seconds \n",
+	   (float)t_h / CLOCKS_PER_SEC);
+    printf("\tfast_mem_mod runtime: %.8f seconds \n",
+	   (float)t_m / CLOCKS_PER_SEC);
+  }
+  free(block);
+  block = NULL;
+}
+
+/**
+   Tests mod_rcp.
+*/
+int mod_rcp_test_divisor(size_t n, size_t trials){
+  int res = 1;
+  size_t i;
+  size_t a, mul, shift;
+  size_t edges[5];
+  mod_rcp_init(n, &mul, &shift);
+  edges[0] = 0;
+  edges[1] = n - 1;
+  edges[2] = n;
+  edges[3] = C_SIZE_MAX - 1;
+  edges[4] = C_SIZE_MAX;
+  for (i = 0; i < 5; i++){
+    res *= (mod_rcp(edges[i], n, mul, shift) == edges[i] % n);
+  }
+  for (i = 0; i < trials; i++){
+    a = DRAND() * C_SIZE_MAX;
+    res *= (mod_rcp(a, n, mul, shift) == a % n);
+  }
+  return res;
+}
+
+void run_mod_rcp_test(int pow_trials){
+  int res = 1;
+  size_t i, k, trials;
+  size_t n, mul, shift, sum;
+  clock_t t;
+  trials = pow_two(pow_trials);
+  printf("Run mod_rcp random test\n");
+  for (k = 0; k < C_FULL_BIT; k++){
+    res *= mod_rcp_test_divisor(pow_two(k), C_BASE_MAX);
+    if (k > 1) res *= mod_rcp_test_divisor(pow_two(k) - 1, C_BASE_MAX);
+    if (k > 0) res *= mod_rcp_test_divisor(pow_two(k) + 1, C_BASE_MAX);
+  }
+  res *= mod_rcp_test_divisor(C_SIZE_MAX, C_BASE_MAX);
+  printf("\tn = 2^k - 1, 2^k, 2^k + 1 --> ");
+  print_test_result(res);
+  res = 1;
+  for (i = 0; i < C_BASE_MAX; i++){
+    n = 1 + DRAND() * (pow_two(C_HALF_BIT) - 2);
+    res *= mod_rcp_test_divisor(n, trials / C_BASE_MAX);
+  }
+  printf("\t0 < n <= 2^%lu - 1 --> ", TOLU(C_HALF_BIT));
+  print_test_result(res);
+  res = 1;
+  for (i = 0; i < C_BASE_MAX; i++){
+    n = 1 + DRAND() * (C_SIZE_MAX - 1);
+    res *= mod_rcp_test_divisor(n, trials / C_BASE_MAX);
+  }
+  printf("\t0 < n <= 2^%lu - 1 --> ", TOLU(C_FULL_BIT));
+  print_test_result(res);
+  n = 1 + DRAND() * (C_SIZE_MAX - 1);
+  n |= 1;
+  mod_rcp_init(n, &mul, &shift);
+  sum = 0;
+  t = clock();
+  for (i = 0; i < trials; i++){
+    sum += mod_rcp(i * (C_SIZE_MAX / 3), n, mul, shift);
+  }
+  t = clock() - t;
+  printf("\t%lu mod_rcp calls:     %.8f seconds \n",
+	 TOLU(trials), (float)t / CLOCKS_PER_SEC);
+  t = clock();
+  for (i = 0; i < trials; i++){
+    sum -= (i * (C_SIZE_MAX / 3)) % n;
+  }
+  t = clock() - t;
+  printf("\t%lu %% calls:           %.8f seconds \n",
+	 TOLU(trials), (float)t / CLOCKS_PER_SEC);
+  printf("\tsame sums --> ");
+  print_test_result(sum == 0);
+}
+
 /**
    Tests mul_ext.
 */
@@ -555,7 +686,8 @@ int main(int argc, char *argv[]){
       args[4] > 1 ||
       args[5] > 1 ||
       args[6] > 1 ||
-      args[7] > 1){
+      args[7] > 1 ||
+      args[8] > 1){
     printf("USAGE:\n%s", C_USAGE);
     exit(EXIT_FAILURE);
   }
@@ -569,9 +701,11 @@ int main(int argc, char *argv[]){
   if (args[6]) run_fast_mem_mod_test(args[1], args[2], args[3]);
   if (args[7]){
     run_mul_ext_test(args[0]);
+    run_mod_rcp_test(args[0]);
     run_represent_uint_test(args[0]);
     run_pow_two_test();
   }
+  if (args[8]) run_mem_hash_test(args[1], args[2], args[3]);
   free(args);
   args = NULL;
   return 0;
@@ -8,6 +8,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include "utilities-mod.h"
 
@@ -17,6 +18,15 @@ static const size_t C_HALF_BIT = CHAR_BIT * sizeof(size_t) / 2;
 static const size_t C_LOW_MASK = ((size_t)-1 >>
 				  (CHAR_BIT * sizeof(size_t) / 2));
 
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 uint_dbl_t; /* high word in mod_rcp */
+#endif
+
+/* low bits of 2^64 / golden ratio, odd for any even width >= 16 */
+static const size_t C_HASH_MUL = ((((((size_t)0x9e37u << 8 << 8) |
+				      0x79b9u) << 8 << 8) |
+				    0x7f4au) << 8 << 8) | 0x7c15u;
+
 /**
    Computes overflow-safe mod n of the kth power in O(logk) time,
    based on the binary representation of k and inductively applying the
@@ -176,6 +186,92 @@ size_t fast_mem_mod(const void *s, size_t size, size_t n){
   return ret;
 }
 
+/**
+   Computes a hash value of a memory block in sizeof(size_t)-byte
+   increments, with an xor, a multiplication by an odd constant mod
+   2^{CHAR_BIT * sizeof(size_t)}, and a xorshift per increment, without
+   modular reduction. The remaining bytes are zero-padded into a last
+   increment. Each step is a bijection of the hash value, so that two
+   blocks of the same size that differ in one increment have different
+   hash values. The function can be used as rdc_key of a hash table, where
+   the hash value is reduced to a slot index by the hash table. The
+   multiplication uses the intended wrapping around of unsigned integers,
+   which is defined.
+*/
+size_t mem_hash(const void *s, size_t size){
+  const unsigned char *ptr = s;
+  const unsigned char *end = ptr + (size - size % sizeof(size_t));
+  size_t val;
+  size_t ret = size;
+  for (; ptr != end; ptr += sizeof(size_t)){
+    memcpy(&val, ptr, sizeof(size_t));
+    ret = (ret ^ val) * C_HASH_MUL;
+    ret ^= ret >> C_HALF_BIT;
+  }
+  if (size % sizeof(size_t)){
+    val = 0;
+    memcpy(&val, ptr, size % sizeof(size_t));
+    ret = (ret ^ val) * C_HASH_MUL;
+    ret ^= ret >> C_HALF_BIT;
+  }
+  ret *= C_HASH_MUL;
+  ret ^= ret >> C_HALF_BIT;
+  return ret;
+}
+
+/**
+   Computes the reciprocal multiplier and the shift of a divisor n > 0,
+   s.t. mod_rcp computes a mod n with a multiplication and shifts instead
+   of a division. The multiplier is 0 if n is a power of two. Otherwise,
+   given l s.t. 2^{l - 1} < n < 2^l, the multiplier is
+   floor((2^l - n) * 2^{CHAR_BIT * sizeof(size_t)} / n) + 1, computed with
+   a long division in CHAR_BIT * sizeof(size_t) steps once per divisor,
+   and the shift is l - 1.
+*/
+void mod_rcp_init(size_t n, size_t *mul, size_t *shift){
+  size_t i, l = 0;
+  size_t rem, q = 0, carry;
+  while (l < C_FULL_BIT && (n - 1) >> l) l++; /* 2^{l - 1} < n <= 2^l */
+  if ((n & (n - 1)) == 0){
+    *mul = 0;
+    *shift = l;
+    return;
+  }
+  rem = (l == C_FULL_BIT) ? 0 - n : pow_two(l) - n; /* < n */
+  for (i = 0; i < C_FULL_BIT; i++){
+    carry = rem >> (C_FULL_BIT - 1);
+    rem <<= 1;
+    q <<= 1;
+    if (carry || rem >= n){
+      rem -= n; /* intended wrapping around if carry */
+      q |= 1;
+    }
+  }
+  *mul = q + 1;
+  *shift = l - 1;
+}
+
+/**
+   Computes a mod n given the multiplier and the shift of n from
+   mod_rcp_init, with the round-up method of Granlund and Montgomery: the
+   quotient is the high word of a * mul, corrected by the added half of
+   the difference to a, and shifted. The quotient is exact for all a.
+*/
+size_t mod_rcp(size_t a, size_t n, size_t mul, size_t shift){
+  size_t h, l;
+  if (mul == 0) return a & (n - 1);
+#ifdef __SIZEOF_INT128__
+  if (2 * sizeof(size_t) == sizeof(uint_dbl_t)){
+    h = (uint_dbl_t)a * mul >> C_FULL_BIT;
+  }else{
+    mul_ext(a, mul, &h, &l);
+  }
+#else
+  mul_ext(a, mul, &h, &l);
+#endif
+  return a - ((h + ((a - h) >> 1)) >> shift) * n;
+}
+
 /**
    Multiplies two numbers in an overflow-safe manner and copies the high and
    low bits of the product into the preallocated blocks pointed to by h
@@ -46,6 +46,35 @@ size_t mem_mod(const void *s, size_t size, size_t n);
 */
 size_t fast_mem_mod(const void *s, size_t size, size_t n);
 
+/**
+   Computes a hash value of a memory block in sizeof(size_t)-byte
+   increments, with an xor, a multiplication by an odd constant mod
+   2^{CHAR_BIT * sizeof(size_t)}, and a xorshift per increment, without
+   modular reduction. The remaining bytes are zero-padded into a last
+   increment. Each step is a bijection of the hash value, so that two
+   blocks of the same size that differ in one increment have different
+   hash values. The function can be used as rdc_key of a hash table, where
+   the hash value is reduced to a slot index by the hash table.
+*/
+size_t mem_hash(const void *s, size_t size);
+
+/**
+   Computes the reciprocal multiplier and the shift of a divisor n > 0,
+   s.t. mod_rcp computes a mod n with a multiplication and shifts instead
+   of a division. The multiplier is 0 if n is a power of two. The
+   computation is a long division in CHAR_BIT * sizeof(size_t) steps, done
+   once per divisor.
+*/
+void mod_rcp_init(size_t n, size_t *mul, size_t *shift);
+
+/**
+   Computes a mod n given the multiplier and the shift of n from
+   mod_rcp_init, with the round-up method of Granlund and Montgomery: the
+   quotient is the high word of a * mul, corrected by the added half of
+   the difference to a, and shifted.
+*/
+size_t mod_rcp(size_t a, size_t n, size_t mul, size_t shift);
+
 /**
    Multiplies two numbers in an overflow-safe manner and copies the high and
    low bits of the product into the preallocated blocks pointed to by h
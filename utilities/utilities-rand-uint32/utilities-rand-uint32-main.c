@@ -230,6 +230,76 @@ void run_primality_test(){
   print_test_result(res_comp == 0);
 }
 
+/**
+   Tests miller_rabin_uint32 against trial division, on strong pseudoprimes
+   to the smallest prime bases, and tests next_prime_uint32 and
+   next_primes_uint32 on known primes.
+*/
+void run_deterministic_primality_test(){
+  int res = 1;
+  uint32_t sieve_count = 1048576;
+  uint32_t trials = 100000;
+  char *is_comp = NULL;
+  uint32_t *ns = NULL, *ps = NULL;
+  uint32_t spsp[4] = {2047U, //base 2
+		      1373653U, //bases 2, 3
+		      25326001U, //bases 2, 3, 5
+		      3215031751U}; //bases 2, 3, 5, 7
+  uint32_t next[6][2] = {{0U, 2U},
+			 {65536U, 65537U},
+			 {1073741824U, 1073741827U}, //2^30
+			 {2147483648U, 2147483659U}, //2^31
+			 {4294967291U, 4294967291U},
+			 {4294967292U, 0U}};
+  clock_t t;
+  printf("Run a deterministic miller_rabin_uint32 test and a "
+	 "next_prime_uint32 test\n");
+  is_comp = calloc_perror(sieve_count, 1);
+  is_comp[0] = 1;
+  is_comp[1] = 1;
+  for (uint32_t i = 2; i * i < sieve_count; i++){
+    if (is_comp[i]) continue;
+    for (uint32_t j = i * i; j < sieve_count; j += i){
+      is_comp[j] = 1;
+    }
+  }
+  for (uint32_t i = 0; i < sieve_count; i++){
+    res *= (miller_rabin_uint32(i) == !is_comp[i]);
+  }
+  for (int i = 0; i < 4; i++){
+    res *= !miller_rabin_uint32(spsp[i]);
+  }
+  for (int i = 0; i < 6; i++){
+    res *= (next_prime_uint32(next[i][0]) == next[i][1]);
+  }
+  ns = malloc_perror(trials, sizeof(uint32_t));
+  ps = malloc_perror(trials, sizeof(uint32_t));
+  for (uint32_t i = 0; i < trials; i++){
+    ns[i] = random_uint32() >> 1;
+  }
+  t = clock();
+  next_primes_uint32(ns, ps, trials);
+  t = clock() - t;
+  for (uint32_t i = 0; i < trials; i++){
+    res *= (ps[i] >= ns[i] && miller_rabin_uint32(ps[i]));
+    if (i < 100){
+      for (uint32_t n = ns[i]; n < ps[i]; n++){
+	res *= !miller_rabin_uint32(n);
+      }
+    }
+  }
+  printf("\tnext_primes_uint32 on %u numbers in [0, 2^31): %.8f seconds\n",
+	 trials, (float)t / CLOCKS_PER_SEC);
+  printf("\tcorrectness:                       ");
+  print_test_result(res);
+  free(is_comp);
+  free(ns);
+  free(ps);
+  is_comp = NULL;
+  ns = NULL;
+  ps = NULL;
+}
+
 /**
    Tests miller_rabin_uint32 on finding a prime within a range.
 */
@@ -307,6 +377,7 @@ int main(){
   run_random_range_uint32_test();
   run_random_uint32_test();
   run_primality_test();
+  run_deterministic_primality_test();
   run_prime_scan_test();
   return 0;
 }
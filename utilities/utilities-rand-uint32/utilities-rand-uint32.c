@@ -9,8 +9,11 @@
    uniformity, where N is the number of generated number candidates. N is
    less or equal to 2 in expectation.
 
-   Primality testing is performed in a randomized approach according to
-   Miller and Rabin.
+   Primality testing is performed in a deterministic approach according to
+   Miller and Rabin, with trial division by primes up to 13 followed by the
+   test with the bases 2, 7, and 61, which have no common strong
+   pseudoprime below 2^32 (Jaeschke). Modular multiplication in the test is
+   performed with the reduction according to Montgomery.
 
    The implementation is based on a generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1, as set by 
@@ -23,21 +26,34 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "utilities-rand-uint32.h"
-#include "utilities-mod.h"
 
 static const uint32_t FULL_BIT_COUNT = 8 * sizeof(uint32_t);
 static const uint32_t HIGH_MASK = 2147483648U; //2^31
 static const uint32_t RAND_MAX_UINT32_TEST = 2147483647U;
 static const uint32_t RAND_MAX_UINT32 = RAND_MAX; //associate with a type
-static const int COMPOSITE_TRIALS = 50;
+static const uint32_t UINT32_MAX_VAL = 4294967295U;
+static const int SMALL_PRIME_COUNT = 6;
+static const uint32_t SMALL_PRIMES[6] = {2, 3, 5, 7, 11, 13};
+static const uint32_t SMALL_PRIME_SQ_BOUND = 17 * 17;
+static const int WITNESS_BASE_COUNT = 3;
+static const uint32_t WITNESS_BASES[3] = {2, 7, 61}; //n < 4759123141
+
+typedef struct{
+  uint32_t n;
+  uint32_t ninv; //-n^-1 mod 2^32
+  uint32_t r1; //R mod n, Montgomery representation of 1
+  uint32_t r2; //R^2 mod n
+  uint32_t nm1; //Montgomery representation of n - 1
+} mont_uint32_t;
 
 //number generation
 static uint32_t random_mod_pow_two(uint32_t k);
 static uint32_t random_gen_range(uint32_t n);
 
 //primality testing
-static int composite(uint32_t n, int trials);
-static int witness(uint32_t a, uint32_t n);
+static void mont_init(mont_uint32_t *m, uint32_t n);
+static uint32_t mont_mul(const mont_uint32_t *m, uint32_t a, uint32_t b);
+static int witness(const mont_uint32_t *m, uint32_t a);
 static void represent_uint32(uint32_t n, uint32_t *k, uint32_t *u);
 
 //auxiliary functions
@@ -118,56 +134,108 @@ static uint32_t random_gen_range(uint32_t n){
 /* Primality testing */
 
 /**
-   Runs a randomized primality test. Returns 1 if n is prime and 0
+   Runs a deterministic primality test. Returns 1 if n is prime and 0
    otherwise.
 */
 int miller_rabin_uint32(uint32_t n){
-  int ret;
-  if (n == 2){
-    ret = 1;
-  }else if (n == 1 || !(n & 1) || composite(n, COMPOSITE_TRIALS)){
-    ret = 0;
-  }else{
-    ret = 1;
+  mont_uint32_t m;
+  if (n < 2) return 0;
+  for (int i = 0; i < SMALL_PRIME_COUNT; i++){
+    if (n == SMALL_PRIMES[i]) return 1;
+    if (n % SMALL_PRIMES[i] == 0) return 0;
   }
-  return ret;
+  if (n < SMALL_PRIME_SQ_BOUND) return 1;
+  mont_init(&m, n);
+  for (int i = 0; i < WITNESS_BASE_COUNT; i++){
+    if (witness(&m, WITNESS_BASES[i])) return 0;
+  }
+  return 1;
 }
 
 /**
-   Runs a randomized composite test on n across random_range_uint32-generated
-   bases in the number of trials that equals to the value of the trials
-   parameter. Returns 1 if a witness is detected and 0 otherwise.
+   Returns the smallest prime that is greater or equal to n, or 0 if the
+   prime is not representable as uint32_t.
 */
-static int composite(uint32_t n, int trials){
-  uint32_t a;
-  uint32_t upper = n - 2;
-  for (int i = 0; i < trials; i++){
-    a = 2 + random_range_uint32(upper); //[2, n - 1] 
-    if (witness(a, n)) return 1;
+uint32_t next_prime_uint32(uint32_t n){
+  if (n <= 2) return 2;
+  if (!(n & 1)){
+    if (n == UINT32_MAX_VAL) return 0;
+    n++;
+  }
+  while (!miller_rabin_uint32(n)){
+    if (n > UINT32_MAX_VAL - 2) return 0;
+    n += 2;
   }
-  return 0;
+  return n;
 }
 
 /**
-   Determines if n is composite and a is its witness, otherwise n is likely 
-   a prime. n must be odd and greater or equal to 3.
+   Sets ps[i] to next_prime_uint32(ns[i]) for each i in [0, count).
 */
-static int witness(uint32_t a, uint32_t n){
-  uint32_t t, u, x[2];
-  represent_uint32(n - 1, &t, &u);
-  x[0] = pow_mod(a, u, n);
-  x[1] = pow_mod(x[0], 2, n); //t > 0
-  for (uint32_t i = 0; i < t; i++){
-    if (x[1] == 1 && !(x[0] == 1 || x[0] == n - 1)){
-      return 1; //nontrivial root => composite
-    }
-    if (i < t - 1){
-      x[0] = x[1];
-      x[1] = pow_mod(x[0], 2, n);
-    }
+void next_primes_uint32(const uint32_t *ns, uint32_t *ps, size_t count){
+  for (size_t i = 0; i < count; i++){
+    ps[i] = next_prime_uint32(ns[i]);
+  }
+}
+
+/**
+   Initializes the Montgomery representation modulo an odd n > 1 with
+   R = 2^32. The inverse of n mod 2^32 is computed by Newton's iteration,
+   which doubles the number of correct low bits in each step starting from
+   3 bits.
+*/
+static void mont_init(mont_uint32_t *m, uint32_t n){
+  uint32_t x = n;
+  for (int i = 0; i < 4; i++){
+    x *= 2 - n * x;
+  }
+  m->n = n;
+  m->ninv = 0 - x;
+  m->r1 = (uint32_t)(((uint64_t)1 << FULL_BIT_COUNT) % n);
+  m->r2 = (uint32_t)((uint64_t)m->r1 * m->r1 % n);
+  m->nm1 = n - m->r1;
+}
+
+/**
+   Computes a * b * R^-1 mod n, where a, b < n, with the reduction
+   according to Montgomery. The sum of the high words does not overflow
+   uint64_t.
+*/
+static uint32_t mont_mul(const mont_uint32_t *m, uint32_t a, uint32_t b){
+  uint64_t p = (uint64_t)a * b;
+  uint32_t l = (uint32_t)p;
+  uint64_t t = ((p >> FULL_BIT_COUNT) +
+		((uint64_t)(l * m->ninv) * m->n >> FULL_BIT_COUNT) +
+		(l != 0)); //l + low word of the product is 0 mod 2^32
+  if (t >= m->n) t -= m->n;
+  return (uint32_t)t;
+}
+
+/**
+   Determines if n is composite and a is its witness, otherwise n is a
+   strong probable prime to the base a. n must be odd and greater or equal
+   to 3. The test is run in the Montgomery representation, where 1 and
+   n - 1 are represented by r1 and nm1.
+*/
+static int witness(const mont_uint32_t *m, uint32_t a){
+  uint32_t t, u, x, b;
+  a %= m->n;
+  if (a == 0) return 0;
+  represent_uint32(m->n - 1, &t, &u);
+  b = mont_mul(m, a, m->r2);
+  x = m->r1;
+  while (u){
+    if (u & 1) x = mont_mul(m, x, b);
+    b = mont_mul(m, b, b);
+    u >>= 1;
+  }
+  if (x == m->r1 || x == m->nm1) return 0;
+  for (uint32_t i = 1; i < t; i++){
+    x = mont_mul(m, x, x);
+    if (x == m->nm1) return 0;
+    if (x == m->r1) return 1; //nontrivial root => composite
   }
-  if (x[1] != 1) return 1; //composite based on Fermat's little theorem
-  return 0;
+  return 1;
 }
 
 /**
@@ -9,8 +9,11 @@
    uniformity, where N is the number of generated number candidates. N is
    less or equal to 2 in expectation.
 
-   Primality testing is performed in a randomized approach according to
-   Miller and Rabin.
+   Primality testing is performed in a deterministic approach according to
+   Miller and Rabin, with trial division by primes up to 13 followed by the
+   test with the bases 2, 7, and 61, which have no common strong
+   pseudoprime below 2^32 (Jaeschke). Modular multiplication in the test is
+   performed with the reduction according to Montgomery.
 
    The implementation is based on a generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1, as set by 
@@ -22,6 +25,7 @@
 #ifndef UTILITIES_RAND_UINT32_H  
 #define UTILITIES_RAND_UINT32_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <time.h>
 
@@ -36,11 +40,22 @@ uint32_t random_range_uint32(uint32_t n);
 uint32_t random_uint32();
 
 /**
-   Runs a randomized primality test. Returns 1 if n is prime and 0
+   Runs a deterministic primality test. Returns 1 if n is prime and 0
    otherwise.
 */
 int miller_rabin_uint32(uint32_t n);
 
+/**
+   Returns the smallest prime that is greater or equal to n, or 0 if the
+   prime is not representable as uint32_t.
+*/
+uint32_t next_prime_uint32(uint32_t n);
+
+/**
+   Sets ps[i] to next_prime_uint32(ns[i]) for each i in [0, count).
+*/
+void next_primes_uint32(const uint32_t *ns, uint32_t *ps, size_t count);
+
 /**
    Macro for setting the random number generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1. By default, the
@@ -178,6 +178,91 @@ void run_random_uint64_test(){
   masks = NULL;
 }
 
+/**
+   Tests random_fill_uint64 and random_fill_uint32 on the reference
+   output of xoshiro256** in each lane, on the independence of lanes and
+   streams, and on the runtime in comparison to random_uint64.
+*/
+void run_random_fill_test(){
+  int res = 1;
+  uint64_t count = 10000000;
+  uint64_t ref[4] = {11520U, 0U, 1509978240U, 1215971899390074240U};
+  uint64_t s[4] = {1, 2, 3, 4}; //reference state
+  uint64_t *buf = NULL, *counts = NULL;
+  uint32_t *buf32 = NULL;
+  size_t n;
+  clock_t t, t_fill, t_fill32;
+  xoshiro_uint64_t x, y;
+  buf = malloc_perror(count, sizeof(uint64_t));
+  buf32 = malloc_perror(count, sizeof(uint32_t));
+  counts = calloc_perror(FULL_BIT_COUNT, sizeof(uint64_t));
+  printf("Run random_fill_uint64 and random_fill_uint32 test, "
+	 "# values = %lu\n", count);
+  for (int i = 0; i < 4; i++){
+    for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+      x.s[i][l] = s[i];
+    }
+  }
+  random_fill_uint64(&x, buf, 4 * XOSHIRO_UINT64_LANES);
+  for (int i = 0; i < 4; i++){
+    for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+      res *= (buf[i * XOSHIRO_UINT64_LANES + l] == ref[i]);
+    }
+  }
+  for (int i = 0; i < 4; i++){
+    for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+      x.s[i][l] = s[i];
+    }
+  }
+  random_fill_uint32(&x, buf32, 8 * XOSHIRO_UINT64_LANES - 1);
+  for (int i = 0; i < 8 * XOSHIRO_UINT64_LANES - 1; i++){
+    n = i / 2;
+    res *= (buf32[i] == (uint32_t)(ref[n / XOSHIRO_UINT64_LANES] >>
+				   ((i & 1) * HALF_BIT_COUNT)));
+  }
+  xoshiro_uint64_init(&x, 1, 0);
+  xoshiro_uint64_init(&y, 1, 1);
+  for (int i = 0; i < 4; i++){
+    for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+      if (l > 0) res *= (x.s[i][l] != x.s[i][l - 1]);
+      res *= (x.s[i][l] != y.s[i][l]);
+    }
+  }
+  xoshiro_uint64_init(&x, time(0), 0);
+  t = clock();
+  for (uint64_t i = 0; i < count; i++){
+    buf[i] = random_uint64();
+  }
+  t = clock() - t;
+  t_fill = clock();
+  random_fill_uint64(&x, buf, count);
+  t_fill = clock() - t_fill;
+  t_fill32 = clock();
+  random_fill_uint32(&x, buf32, count);
+  t_fill32 = clock() - t_fill32;
+  for (uint64_t i = 0; i < count; i++){
+    for (uint64_t j = 0; j < FULL_BIT_COUNT; j++){
+      if (buf[i] & ((uint64_t)1 << j)) counts[j]++;
+    }
+  }
+  printf("\t\trandom_uint64:             %.8f seconds\n"
+	 "\t\trandom_fill_uint64:        %.8f seconds\n"
+	 "\t\trandom_fill_uint32:        %.8f seconds\n",
+	 (float)t / CLOCKS_PER_SEC,
+	 (float)t_fill / CLOCKS_PER_SEC,
+	 (float)t_fill32 / CLOCKS_PER_SEC);
+  printf("\t\tP[bit is set]:");
+  print_bit_probs(counts, count);
+  printf("\tcorrectness:                       ");
+  print_test_result(res);
+  free(buf);
+  free(buf32);
+  free(counts);
+  buf = NULL;
+  buf32 = NULL;
+  counts = NULL;
+}
+
 /**
    Tests the correctness of miller_rabin_uint64 on prime and composite
    numbers.
@@ -253,6 +338,81 @@ void run_primality_test(){
   print_test_result(res_comp == 0);
 }
 
+/**
+   Tests miller_rabin_uint64 against trial division, on strong pseudoprimes
+   to the smallest prime bases, and tests next_prime_uint64 and
+   next_primes_uint64 on known primes.
+*/
+void run_deterministic_primality_test(){
+  int res = 1;
+  uint64_t sieve_count = 1048576;
+  uint64_t trials = 100000;
+  char *is_comp = NULL;
+  uint64_t *ns = NULL, *ps = NULL;
+  uint64_t spsp[6] = {2047U, //base 2
+		      3215031751U, //bases 2, 3, 5, 7
+		      2152302898747U, //bases 2 to 11
+		      3474749660383U, //bases 2 to 13
+		      341550071728321U, //bases 2 to 17
+		      3825123056546413051U}; //bases 2 to 23
+  uint64_t next[8][2] = {{0U, 2U},
+			 {2147483648U, 2147483659U}, //2^31
+			 {4294967296U, 4294967311U}, //2^32
+			 {1099511627776U, 1099511627791U}, //2^40
+			 {2305843009213693951U, 2305843009213693951U}, //2^61-1
+			 {9223372036854775808U, 9223372036854775837U}, //2^63
+			 {18446744073709551557U, 18446744073709551557U},
+			 {18446744073709551558U, 0U}};
+  clock_t t;
+  printf("Run a deterministic miller_rabin_uint64 test and a "
+	 "next_prime_uint64 test\n");
+  is_comp = calloc_perror(sieve_count, 1);
+  is_comp[0] = 1;
+  is_comp[1] = 1;
+  for (uint64_t i = 2; i * i < sieve_count; i++){
+    if (is_comp[i]) continue;
+    for (uint64_t j = i * i; j < sieve_count; j += i){
+      is_comp[j] = 1;
+    }
+  }
+  for (uint64_t i = 0; i < sieve_count; i++){
+    res *= (miller_rabin_uint64(i) == !is_comp[i]);
+  }
+  for (int i = 0; i < 6; i++){
+    res *= !miller_rabin_uint64(spsp[i]);
+  }
+  res *= !miller_rabin_uint64(4294967291U * 4294967279U);
+  for (int i = 0; i < 8; i++){
+    res *= (next_prime_uint64(next[i][0]) == next[i][1]);
+  }
+  ns = malloc_perror(trials, sizeof(uint64_t));
+  ps = malloc_perror(trials, sizeof(uint64_t));
+  for (uint64_t i = 0; i < trials; i++){
+    ns[i] = random_uint64() >> 1;
+  }
+  t = clock();
+  next_primes_uint64(ns, ps, trials);
+  t = clock() - t;
+  for (uint64_t i = 0; i < trials; i++){
+    res *= (ps[i] >= ns[i] && miller_rabin_uint64(ps[i]));
+    if (i < 100){
+      for (uint64_t n = ns[i]; n < ps[i]; n++){
+	res *= !miller_rabin_uint64(n);
+      }
+    }
+  }
+  printf("\tnext_primes_uint64 on %lu numbers in [0, 2^63): %.8f seconds\n",
+	 trials, (float)t / CLOCKS_PER_SEC);
+  printf("\tcorrectness:                       ");
+  print_test_result(res);
+  free(is_comp);
+  free(ns);
+  free(ps);
+  is_comp = NULL;
+  ns = NULL;
+  ps = NULL;
+}
+
 /**
    Tests miller_rabin_uint64 on finding a prime within a range.
 */
@@ -329,7 +489,9 @@ int main(){
   UTILITIES_RAND_UINT64_SEED();
   run_random_range_uint64_test();
   run_random_uint64_test();
+  run_random_fill_test();
   run_primality_test();
+  run_deterministic_primality_test();
   run_prime_scan_test();
   return 0;
 }
@@ -9,8 +9,21 @@
    uniformity, where N is the number of generated number candidates. N is
    less or equal to 2 in expectation.
 
-   Primality testing is performed in a randomized approach according to
-   Miller and Rabin.
+   Primality testing is performed in a deterministic approach according to
+   Miller and Rabin, with trial division by primes up to 37 followed by the
+   test with a fixed set of seven bases that has no strong pseudoprimes
+   below 2^64 (Jaeschke, Sinclair). Modular multiplication in the test is
+   performed with the reduction according to Montgomery and a 128-bit
+   product, which is provided by unsigned __int128 if available.
+
+   The bulk generation of numbers into a buffer is based on the xoshiro256**
+   generator by Blackman and Vigna, which is seeded with a splitmix64
+   sequence and does not depend on UTILITIES_RAND_UINT64_RANDOM(). A
+   generator state holds XOSHIRO_UINT64_LANES independent xoshiro256**
+   states that are stored as a structure of arrays and are advanced in a
+   loop over lanes that the compiler can vectorize. The lanes are 2^128
+   steps apart, and the streams of a seed are 2^192 steps apart, so that
+   each thread can generate numbers with its own stream without locking.
 
    The implementation is based on a generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1, as set by 
@@ -22,8 +35,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include "utilities-rand-uint64.h"
-#include "utilities-mod.h"
 
 static const uint64_t FULL_BIT_COUNT = 8 * sizeof(uint64_t);
 static const uint64_t HALF_BIT_COUNT = 4 * sizeof(uint64_t);
@@ -31,15 +44,59 @@ static const uint64_t HIGH_MASK = 13835058055282163712U; //2^62 + 2^63;
 static const uint64_t MID_MASK = 4611686016279904256U; //2^62 - 2^31;
 static const uint64_t RAND_MAX_UINT64_TEST = 2147483647U;
 static const uint64_t RAND_MAX_UINT64 = RAND_MAX; //associate with a type
-static const int COMPOSITE_TRIALS = 50;
+#ifndef __SIZEOF_INT128__
+static const uint64_t LOW_MASK = 4294967295U; //2^32 - 1
+#endif
+static const uint64_t UINT64_MAX_VAL = 0xffffffffffffffffU;
+static const int SMALL_PRIME_COUNT = 12;
+static const uint64_t SMALL_PRIMES[12] = {2, 3, 5, 7, 11, 13,
+					  17, 19, 23, 29, 31, 37};
+static const uint64_t SMALL_PRIME_SQ_BOUND = 41 * 41;
+static const int WITNESS_BASE_COUNT = 7;
+static const uint64_t WITNESS_BASES[7] = {2, 325, 9375, 28178, 450775,
+					  9780504, 1795265022}; //n < 2^64
+static const uint64_t SPLITMIX_INCR = 0x9e3779b97f4a7c15U;
+static const uint64_t SPLITMIX_MUL_A = 0xbf58476d1ce4e5b9U;
+static const uint64_t SPLITMIX_MUL_B = 0x94d049bb133111ebU;
+static const uint64_t XOSHIRO_JUMP[4] = {0x180ec6d33cfd0abaU,
+					 0xd5a61266f0c9392cU,
+					 0xa9582618e03fc9aaU,
+					 0x39abdc4529b1661cU}; //2^128 steps
+//2^192 steps
+static const uint64_t XOSHIRO_LONG_JUMP[4] = {0x76e15d3efefdcbbfU,
+					      0xc5004e441c522fb3U,
+					      0x77710069854ee241U,
+					      0x39109bb02acbe635U};
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+typedef struct{
+  uint64_t n;
+  uint64_t ninv; //-n^-1 mod 2^64
+  uint64_t r1; //R mod n, Montgomery representation of 1
+  uint64_t r2; //R^2 mod n
+  uint64_t nm1; //Montgomery representation of n - 1
+} mont_uint64_t;
 
 //number generation
 static uint64_t random_mod_pow_two(uint64_t k);
 static uint32_t random_gen_range(uint32_t n); //faster with uint32_t
 
+//bulk generation
+static uint64_t splitmix64(uint64_t *x);
+static uint64_t rotl(uint64_t a, int k);
+static void xoshiro_step(uint64_t *s);
+static void xoshiro_jump(uint64_t *s, const uint64_t *jump);
+static void xoshiro_fill(xoshiro_uint64_t *x, uint64_t *buf, size_t count);
+
 //primality testing
-static int composite(uint64_t n, int trials);
-static int witness(uint64_t a, uint64_t n);
+static void mont_init(mont_uint64_t *m, uint64_t n);
+static uint64_t mont_mul(const mont_uint64_t *m, uint64_t a, uint64_t b);
+static void mul_wide(uint64_t a, uint64_t b, uint64_t *h, uint64_t *l);
+static uint64_t add_mod(uint64_t a, uint64_t b, uint64_t n);
+static int witness(const mont_uint64_t *m, uint64_t a);
 static void represent_uint64(uint64_t n, uint64_t *k, uint64_t *u);
 
 //auxiliary functions
@@ -132,59 +189,283 @@ static uint32_t random_gen_range(uint32_t n){
   return ret;
 }
 
+/* Bulk generation */
+
+/**
+   Initializes a xoshiro256** generator state with a seed and a stream
+   index. Generator states that are initialized with the same seed and
+   different stream indices produce non-overlapping sequences of length
+   2^192. The runtime is linear in the stream index.
+*/
+void xoshiro_uint64_init(xoshiro_uint64_t *x, uint64_t seed, uint64_t stream){
+  uint64_t s[4];
+  for (int i = 0; i < 4; i++){
+    s[i] = splitmix64(&seed);
+  }
+  for (uint64_t i = 0; i < stream; i++){
+    xoshiro_jump(s, XOSHIRO_LONG_JUMP);
+  }
+  for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+    for (int i = 0; i < 4; i++){
+      x->s[i][l] = s[i];
+    }
+    xoshiro_jump(s, XOSHIRO_JUMP);
+  }
+}
+
+/**
+   Fills a buffer with count generator-uniform uint64_t values. Values at
+   indices i * XOSHIRO_UINT64_LANES + l are produced by lane l. If count
+   is not a multiple of XOSHIRO_UINT64_LANES, the remaining values of the
+   last block are discarded.
+*/
+void random_fill_uint64(xoshiro_uint64_t *x, uint64_t *buf, size_t count){
+  size_t rem = count % XOSHIRO_UINT64_LANES;
+  uint64_t block[XOSHIRO_UINT64_LANES];
+  xoshiro_fill(x, buf, count - rem);
+  if (rem){
+    xoshiro_fill(x, block, XOSHIRO_UINT64_LANES);
+    for (size_t i = 0; i < rem; i++){
+      buf[count - rem + i] = block[i];
+    }
+  }
+}
+
+/**
+   Fills a buffer with count generator-uniform uint32_t values. Each
+   generated uint64_t value provides two uint32_t values, the low half
+   followed by the high half.
+*/
+void random_fill_uint32(xoshiro_uint64_t *x, uint32_t *buf, size_t count){
+  size_t j = 0;
+  uint64_t block[XOSHIRO_UINT64_LANES * 16];
+  while (j < count){
+    random_fill_uint64(x, block, XOSHIRO_UINT64_LANES * 16);
+    for (size_t i = 0; i < XOSHIRO_UINT64_LANES * 16 && j < count; i++){
+      buf[j++] = (uint32_t)block[i];
+      if (j < count) buf[j++] = (uint32_t)(block[i] >> HALF_BIT_COUNT);
+    }
+  }
+}
+
+/**
+   Returns the next value of a splitmix64 sequence with the state x.
+*/
+static uint64_t splitmix64(uint64_t *x){
+  uint64_t z = (*x += SPLITMIX_INCR);
+  z = (z ^ (z >> 30)) * SPLITMIX_MUL_A;
+  z = (z ^ (z >> 27)) * SPLITMIX_MUL_B;
+  return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t a, int k){
+  return (a << k) | (a >> (FULL_BIT_COUNT - k));
+}
+
+/**
+   Advances a single xoshiro256** state by one step.
+*/
+static void xoshiro_step(uint64_t *s){
+  uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+}
+
+/**
+   Advances a single xoshiro256** state by the number of steps that is
+   encoded by a jump polynomial.
+*/
+static void xoshiro_jump(uint64_t *s, const uint64_t *jump){
+  uint64_t t[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 4; i++){
+    for (int b = 0; b < (int)FULL_BIT_COUNT; b++){
+      if (jump[i] & ((uint64_t)1 << b)){
+	t[0] ^= s[0];
+	t[1] ^= s[1];
+	t[2] ^= s[2];
+	t[3] ^= s[3];
+      }
+      xoshiro_step(s);
+    }
+  }
+  for (int i = 0; i < 4; i++){
+    s[i] = t[i];
+  }
+}
+
+/**
+   Fills a buffer with count values, where count is a multiple of
+   XOSHIRO_UINT64_LANES. The lanes are copied to local arrays, so that the
+   inner loop over lanes is vectorized without aliasing with buf.
+*/
+static void xoshiro_fill(xoshiro_uint64_t *x, uint64_t *buf, size_t count){
+  uint64_t s0[XOSHIRO_UINT64_LANES], s1[XOSHIRO_UINT64_LANES];
+  uint64_t s2[XOSHIRO_UINT64_LANES], s3[XOSHIRO_UINT64_LANES];
+  uint64_t t[XOSHIRO_UINT64_LANES];
+  memcpy(s0, x->s[0], sizeof(s0));
+  memcpy(s1, x->s[1], sizeof(s1));
+  memcpy(s2, x->s[2], sizeof(s2));
+  memcpy(s3, x->s[3], sizeof(s3));
+  for (size_t i = 0; i < count; i += XOSHIRO_UINT64_LANES){
+    for (int l = 0; l < XOSHIRO_UINT64_LANES; l++){
+      buf[i + l] = rotl(s1[l] * 5, 7) * 9;
+      t[l] = s1[l] << 17;
+      s2[l] ^= s0[l];
+      s3[l] ^= s1[l];
+      s1[l] ^= s2[l];
+      s0[l] ^= s3[l];
+      s2[l] ^= t[l];
+      s3[l] = rotl(s3[l], 45);
+    }
+  }
+  memcpy(x->s[0], s0, sizeof(s0));
+  memcpy(x->s[1], s1, sizeof(s1));
+  memcpy(x->s[2], s2, sizeof(s2));
+  memcpy(x->s[3], s3, sizeof(s3));
+}
+
 /* Primality testing */
 
 /**
-   Runs a randomized primality test. Returns 1 if n is prime and 0
+   Runs a deterministic primality test. Returns 1 if n is prime and 0
    otherwise.
 */
 int miller_rabin_uint64(uint64_t n){
-  int ret;
-  if (n == 2){
-    ret = 1;
-  }else if (n == 1 || !(n & 1) || composite(n, COMPOSITE_TRIALS)){
-    ret = 0;
-  }else{
-    ret = 1;
+  mont_uint64_t m;
+  if (n < 2) return 0;
+  for (int i = 0; i < SMALL_PRIME_COUNT; i++){
+    if (n == SMALL_PRIMES[i]) return 1;
+    if (n % SMALL_PRIMES[i] == 0) return 0;
   }
-  return ret;
+  if (n < SMALL_PRIME_SQ_BOUND) return 1;
+  mont_init(&m, n);
+  for (int i = 0; i < WITNESS_BASE_COUNT; i++){
+    if (witness(&m, WITNESS_BASES[i])) return 0;
+  }
+  return 1;
 }
 
 /**
-   Runs a randomized composite test on n across random_range_uint64-generated
-   bases in the number of trials that equals to the value of the trials
-   parameter. Returns 1 if a witness is detected and 0 otherwise.
+   Returns the smallest prime that is greater or equal to n, or 0 if the
+   prime is not representable as uint64_t.
 */
-static int composite(uint64_t n, int trials){
-  uint64_t a;
-  uint64_t upper = n - 2;
-  for (int i = 0; i < trials; i++){
-    a = 2 + random_range_uint64(upper); //[2, n - 1] 
-    if (witness(a, n)) return 1;
+uint64_t next_prime_uint64(uint64_t n){
+  if (n <= 2) return 2;
+  if (!(n & 1)){
+    if (n == UINT64_MAX_VAL) return 0;
+    n++;
+  }
+  while (!miller_rabin_uint64(n)){
+    if (n > UINT64_MAX_VAL - 2) return 0;
+    n += 2;
   }
-  return 0;
+  return n;
 }
 
 /**
-   Determines if n is composite and a is its witness, otherwise n is likely 
-   a prime. n must be odd and greater or equal to 3.
+   Sets ps[i] to next_prime_uint64(ns[i]) for each i in [0, count).
 */
-static int witness(uint64_t a, uint64_t n){
-  uint64_t t, u, x[2];
-  represent_uint64(n - 1, &t, &u);
-  x[0] = pow_mod(a, u, n);
-  x[1] = pow_mod(x[0], 2, n); //t > 0
-  for (uint64_t i = 0; i < t; i++){
-    if (x[1] == 1 && !(x[0] == 1 || x[0] == n - 1)){
-      return 1; //nontrivial root => composite
-    }
-    if (i < t - 1){
-      x[0] = x[1];
-      x[1] = pow_mod(x[0], 2, n);
-    }
+void next_primes_uint64(const uint64_t *ns, uint64_t *ps, size_t count){
+  for (size_t i = 0; i < count; i++){
+    ps[i] = next_prime_uint64(ns[i]);
+  }
+}
+
+/**
+   Initializes the Montgomery representation modulo an odd n > 1 with
+   R = 2^64. The inverse of n mod 2^64 is computed by Newton's iteration,
+   which doubles the number of correct low bits in each step starting from
+   3 bits, and R^2 mod n is computed by doubling R mod n 64 times.
+*/
+static void mont_init(mont_uint64_t *m, uint64_t n){
+  uint64_t x = n;
+  for (int i = 0; i < 5; i++){
+    x *= 2 - n * x;
+  }
+  m->n = n;
+  m->ninv = 0 - x;
+  m->r1 = (0 - n) % n;
+  m->r2 = m->r1;
+  for (uint64_t i = 0; i < FULL_BIT_COUNT; i++){
+    m->r2 = add_mod(m->r2, m->r2, n);
+  }
+  m->nm1 = n - m->r1;
+}
+
+/**
+   Computes a * b * R^-1 mod n, where a, b < n, with the reduction
+   according to Montgomery.
+*/
+static uint64_t mont_mul(const mont_uint64_t *m, uint64_t a, uint64_t b){
+  uint64_t h, l, mh, ml, t;
+  int ov;
+  mul_wide(a, b, &h, &l);
+  mul_wide(l * m->ninv, m->n, &mh, &ml);
+  t = h + mh;
+  ov = (t < h);
+  t += (l != 0); //l + ml is 0 mod 2^64 and carries if l != 0
+  ov |= (t == 0 && l != 0);
+  if (ov || t >= m->n) t -= m->n;
+  return t;
+}
+
+/**
+   Computes the 128-bit product of a and b.
+*/
+static void mul_wide(uint64_t a, uint64_t b, uint64_t *h, uint64_t *l){
+#ifdef __SIZEOF_INT128__
+  uint128_t t = (uint128_t)a * b;
+  *h = (uint64_t)(t >> FULL_BIT_COUNT);
+  *l = (uint64_t)t;
+#else
+  uint64_t al = a & LOW_MASK, ah = a >> HALF_BIT_COUNT;
+  uint64_t bl = b & LOW_MASK, bh = b >> HALF_BIT_COUNT;
+  uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+  uint64_t mid = (ll >> HALF_BIT_COUNT) + (lh & LOW_MASK) + (hl & LOW_MASK);
+  *l = (mid << HALF_BIT_COUNT) | (ll & LOW_MASK);
+  *h = hh + (lh >> HALF_BIT_COUNT) + (hl >> HALF_BIT_COUNT) +
+    (mid >> HALF_BIT_COUNT);
+#endif
+}
+
+/**
+   Computes (a + b) mod n, where a, b < n.
+*/
+static uint64_t add_mod(uint64_t a, uint64_t b, uint64_t n){
+  uint64_t s = a + b;
+  if (s < a || s >= n) s -= n;
+  return s;
+}
+
+/**
+   Determines if n is composite and a is its witness, otherwise n is a
+   strong probable prime to the base a. n must be odd and greater or equal
+   to 3. The test is run in the Montgomery representation, where 1 and
+   n - 1 are represented by r1 and nm1.
+*/
+static int witness(const mont_uint64_t *m, uint64_t a){
+  uint64_t t, u, x, b;
+  a %= m->n;
+  if (a == 0) return 0;
+  represent_uint64(m->n - 1, &t, &u);
+  b = mont_mul(m, a, m->r2);
+  x = m->r1;
+  while (u){
+    if (u & 1) x = mont_mul(m, x, b);
+    b = mont_mul(m, b, b);
+    u >>= 1;
+  }
+  if (x == m->r1 || x == m->nm1) return 0;
+  for (uint64_t i = 1; i < t; i++){
+    x = mont_mul(m, x, x);
+    if (x == m->nm1) return 0;
+    if (x == m->r1) return 1; //nontrivial root => composite
   }
-  if (x[1] != 1) return 1; //composite based on Fermat's little theorem
-  return 0;
+  return 1;
 }
 
 /**
@@ -9,8 +9,21 @@
    uniformity, where N is the number of generated number candidates. N is
    less or equal to 2 in expectation.
 
-   Primality testing is performed in a randomized approach according to
-   Miller and Rabin.
+   Primality testing is performed in a deterministic approach according to
+   Miller and Rabin, with trial division by primes up to 37 followed by the
+   test with a fixed set of seven bases that has no strong pseudoprimes
+   below 2^64 (Jaeschke, Sinclair). Modular multiplication in the test is
+   performed with the reduction according to Montgomery and a 128-bit
+   product, which is provided by unsigned __int128 if available.
+
+   The bulk generation of numbers into a buffer is based on the xoshiro256**
+   generator by Blackman and Vigna, which is seeded with a splitmix64
+   sequence and does not depend on UTILITIES_RAND_UINT64_RANDOM(). A
+   generator state holds XOSHIRO_UINT64_LANES independent xoshiro256**
+   states that are stored as a structure of arrays and are advanced in a
+   loop over lanes that the compiler can vectorize. The lanes are 2^128
+   steps apart, and the streams of a seed are 2^192 steps apart, so that
+   each thread can generate numbers with its own stream without locking.
 
    The implementation is based on a generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1, as set by 
@@ -22,9 +35,16 @@
 #ifndef UTILITIES_RAND_UINT64_H  
 #define UTILITIES_RAND_UINT64_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <time.h>
 
+#define XOSHIRO_UINT64_LANES 4
+
+typedef struct{
+  uint64_t s[4][XOSHIRO_UINT64_LANES]; /* s[i][l] is word i of lane l */
+} xoshiro_uint64_t;
+
 /**
    Returns a generator-uniform uint64_t in [0 , n).
 */
@@ -36,11 +56,45 @@ uint64_t random_range_uint64(uint64_t n);
 uint64_t random_uint64();
 
 /**
-   Runs a randomized primality test. Returns 1 if n is prime and 0
+   Initializes a xoshiro256** generator state with a seed and a stream
+   index. Generator states that are initialized with the same seed and
+   different stream indices produce non-overlapping sequences of length
+   2^192. The runtime is linear in the stream index.
+*/
+void xoshiro_uint64_init(xoshiro_uint64_t *x, uint64_t seed, uint64_t stream);
+
+/**
+   Fills a buffer with count generator-uniform uint64_t values. Values at
+   indices i * XOSHIRO_UINT64_LANES + l are produced by lane l. If count
+   is not a multiple of XOSHIRO_UINT64_LANES, the remaining values of the
+   last block are discarded.
+*/
+void random_fill_uint64(xoshiro_uint64_t *x, uint64_t *buf, size_t count);
+
+/**
+   Fills a buffer with count generator-uniform uint32_t values. Each
+   generated uint64_t value provides two uint32_t values, the low half
+   followed by the high half.
+*/
+void random_fill_uint32(xoshiro_uint64_t *x, uint32_t *buf, size_t count);
+
+/**
+   Runs a deterministic primality test. Returns 1 if n is prime and 0
    otherwise.
 */
 int miller_rabin_uint64(uint64_t n);
 
+/**
+   Returns the smallest prime that is greater or equal to n, or 0 if the
+   prime is not representable as uint64_t.
+*/
+uint64_t next_prime_uint64(uint64_t n);
+
+/**
+   Sets ps[i] to next_prime_uint64(ns[i]) for each i in [0, count).
+*/
+void next_primes_uint64(const uint64_t *ns, uint64_t *ps, size_t count);
+
 /**
    Macro for setting the random number generator that returns a number
    from 0 to RAND_MAX, where RAND_MAX is 2^31 - 1. By default, the